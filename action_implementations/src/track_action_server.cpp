@@ -24,6 +24,8 @@
 #include "anafi_uav_interfaces/msg/move_by_command.hpp"
 #include "anafi_uav_interfaces/action/move_to_ned.hpp"
 
+#include "anafi_uav_interfaces/async_service_client.hpp"
+
 using namespace std::chrono_literals;
 
 class TrackActionServer : public rclcpp::Node
@@ -48,8 +50,8 @@ public:
 
     // Assuming the velocity controller will be used throughout this thesis
     // Future improvement to allow for using the MPC
-    enable_velocity_control_client_ = this->create_client<std_srvs::srv::SetBool>(
-      "/velocity_controller/service/enable_controller", rmw_qos_profile_services_default, service_callback_group_); 
+    enable_velocity_control_client_ = std::make_shared<AsyncServiceClient<std_srvs::srv::SetBool>>(
+      this, "/velocity_controller/service/enable_controller", service_callback_group_); 
 
     using namespace std::placeholders;
     this->action_server_ = rclcpp_action::create_server<MoveToNED>(
@@ -85,7 +87,7 @@ private:
   rclcpp::Subscription<geometry_msgs::msg::QuaternionStamped>::ConstSharedPtr attitude_sub_;
 
   // Services
-  rclcpp::Client<std_srvs::srv::SetBool>::SharedPtr enable_velocity_control_client_;
+  AsyncServiceClient<std_srvs::srv::SetBool>::SharedPtr enable_velocity_control_client_;
 
   // Actions
   rclcpp_action::Server<MoveToNED>::SharedPtr action_server_;
@@ -238,31 +240,29 @@ private:
   }
 
 
-  bool set_velocity_controller_state_(bool controller_state, const std::string& error_str="")
+  /**
+   * @brief Requests the velocity controller to be enabled or disabled. Returns immediately, as
+   * this is called from both the executor and the thread executing the goal. The response is
+   * handled in the service callback group, and @p error_str is logged if the request fails
+   */
+  void set_velocity_controller_state_(bool controller_state, const std::string& error_str="")
   {
-    // Somehow the checks always fails, even though the service is called correctly
-    // Any ideas why? Can it be due to different callback-groups?
-    // Must be changed in the future!
-
-    (void) error_str;
-    enable_velocity_control_client_->wait_for_service(2s);
     auto request = std::make_shared<std_srvs::srv::SetBool::Request>();
     request->data = controller_state;
-    auto result = enable_velocity_control_client_->async_send_request(request);
-    // std::future_status status = result.wait_for(2s); // This is blocking
-    // (void) status;
-    return result.get()->success;
-    
-    // if(status == std::future_status::ready)//rclcpp::spin_until_future_complete(this->get_node_base_interface(), result) == rclcpp::FutureReturnCode::SUCCESS)
-    // {
-    //   if(result.get()->success)
-    //   {
-    //     return true;
-    //   }
-    // }
-    // RCLCPP_ERROR(this->get_logger(), error_str);
-    // return false;
-    // return true;
+
+    AsyncCallOptions options;
+    options.timeout_s = 1.0;
+    options.max_retries = 2;
+
+    enable_velocity_control_client_->call(request,
+      [this, error_str](std_srvs::srv::SetBool::Response::SharedPtr response)
+      {
+        if(! response || ! response->success)
+        {
+          RCLCPP_ERROR(this->get_logger(), error_str.empty() ? "Failed to set the state of the velocity controller" : error_str);
+        }
+      },
+      options);
   }
 
 
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+
+using namespace std::chrono_literals;
+
+
+struct AsyncCallOptions
+{
+  double timeout_s{ 2.0 };  // [s] Deadline of each attempt, including the time waiting for the service
+  int max_retries{ 0 };     // Attempts after the first attempt has timed out
+};
+
+
+/**
+ * @brief Latency and failure counters of the calls to a single service
+ */
+class ServiceCallStatistics
+{
+public:
+  void record_call() { num_calls_++; }
+  void record_retry() { num_retries_++; }
+  void record_timeout() { num_timeouts_++; }
+  void record_late_response() { num_late_responses_++; }
+
+  void record_response(double latency_s)
+  {
+    num_responses_++;
+    total_latency_s_ += latency_s;
+    max_latency_s_ = std::max(max_latency_s_, latency_s);
+  }
+
+  int get_num_calls() const { return num_calls_; }
+  int get_num_responses() const { return num_responses_; }
+  int get_num_retries() const { return num_retries_; }
+  int get_num_timeouts() const { return num_timeouts_; }
+  int get_num_late_responses() const { return num_late_responses_; }
+  double get_mean_latency_s() const { return (num_responses_ > 0) ? total_latency_s_ / num_responses_ : 0.0; }
+  double get_max_latency_s() const { return max_latency_s_; }
+
+  std::string to_string() const
+  {
+    std::stringstream ss;
+    ss << num_responses_ << "/" << num_calls_ << " calls answered ("
+      << num_retries_ << " retries, "
+      << num_timeouts_ << " timeouts, "
+      << num_late_responses_ << " late responses). "
+      << "Latency mean: " << get_mean_latency_s() << " s, max: " << max_latency_s_ << " s";
+    return ss.str();
+  }
+
+private:
+  int num_calls_{ 0 };
+  int num_responses_{ 0 };
+  int num_retries_{ 0 };
+  int num_timeouts_{ 0 };
+  int num_late_responses_{ 0 };
+  double total_latency_s_{ 0.0 };
+  double max_latency_s_{ 0.0 };
+};
+
+
+/**
+ * @brief Service client which never blocks the calling thread. The response is handed to a
+ * continuation, which is run by the executor in the callback group of the client. Each attempt has
+ * a deadline, after which the request is resent up to a bounded number of times. If all attempts
+ * time out, the continuation receives a nullptr
+ *
+ * The deadlines are checked by a timer in the same callback group as the client, such that the
+ * continuations are never run concurrently with each other when the group is mutually exclusive.
+ * The timer only exists while calls are pending, such that an idle client does not wake the node.
+ * It is created for the first pending call instead of reset, as a reset from a thread outside the
+ * executor does not wake the executor on Foxy
+ *
+ * @warning Responses to an attempt which has timed out are dropped, as Foxy does not support
+ * removing pending requests from the client
+ */
+template<typename ServiceT>
+class AsyncServiceClient
+{
+public:
+  using SharedPtr = std::shared_ptr<AsyncServiceClient<ServiceT>>;
+  using Request = typename ServiceT::Request;
+  using Response = typename ServiceT::Response;
+  using ResponseCallback = std::function<void(typename Response::SharedPtr)>;
+
+  /**
+   * @param node  Either an rclcpp::Node or an rclcpp_lifecycle::LifecycleNode
+   * @param group Callback group for the responses and the deadlines. The default callback group
+   *              of the node is used if nullptr
+   */
+  template<typename NodeT>
+  AsyncServiceClient(
+    NodeT* node,
+    const std::string& service_name,
+    rclcpp::CallbackGroup::SharedPtr group=nullptr,
+    std::chrono::milliseconds deadline_check_period=50ms)
+  : logger_(node->get_logger())
+  , service_name_(service_name)
+  {
+    client_ = node->template create_client<ServiceT>(service_name, rmw_qos_profile_services_default, group);
+    create_deadline_timer_ = [this, node, group, deadline_check_period]()
+    {
+      return node->create_wall_timer(deadline_check_period, [this](){ check_deadlines_(); }, group);
+    };
+  }
+
+
+  /**
+   * @brief Sends @p request, and calls @p on_response with the response, or with nullptr if
+   * all attempts failed. Returns immediately
+   */
+  void call(
+    typename Request::SharedPtr request,
+    const ResponseCallback& on_response=nullptr,
+    const AsyncCallOptions& options=AsyncCallOptions())
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    uint64_t call_id = next_call_id_++;
+    PendingCall& pending_call = pending_calls_[call_id];
+    pending_call.request = request;
+    pending_call.on_response = on_response;
+    pending_call.options = options;
+    pending_call.start = std::chrono::steady_clock::now();
+
+    statistics_.record_call();
+    start_attempt_(call_id, pending_call);
+
+    if(! deadline_timer_)
+    {
+      deadline_timer_ = create_deadline_timer_();
+    }
+  }
+
+
+  bool is_ready() const { return client_->service_is_ready(); }
+  const std::string& get_service_name() const { return service_name_; }
+  rclcpp::ClientBase::SharedPtr get_client() const { return client_; }
+
+  ServiceCallStatistics get_statistics() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+  }
+
+private:
+  struct PendingCall
+  {
+    typename Request::SharedPtr request;
+    ResponseCallback on_response;
+    AsyncCallOptions options;
+
+    int attempt{ 0 };
+    bool is_sent{ false };
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point attempt_deadline;
+  };
+
+  rclcpp::Logger logger_;
+  std::string service_name_;
+
+  typename rclcpp::Client<ServiceT>::SharedPtr client_;
+  std::function<rclcpp::TimerBase::SharedPtr()> create_deadline_timer_;
+  rclcpp::TimerBase::SharedPtr deadline_timer_;  // Only while calls are pending
+
+  mutable std::mutex mutex_;
+  uint64_t next_call_id_{ 0 };
+  std::map<uint64_t, PendingCall> pending_calls_;
+  ServiceCallStatistics statistics_;
+
+
+  void start_attempt_(uint64_t call_id, PendingCall& pending_call)
+  {
+    pending_call.is_sent = false;
+    pending_call.attempt_deadline = std::chrono::steady_clock::now()
+      + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(pending_call.options.timeout_s));
+    try_send_(call_id, pending_call);
+  }
+
+
+  /**
+   * @brief Sends the request if the service is available. Otherwise the request is sent by a
+   * later deadline check, as long as the attempt has not timed out
+   */
+  void try_send_(uint64_t call_id, PendingCall& pending_call)
+  {
+    if(! client_->service_is_ready())
+    {
+      return;
+    }
+
+    int attempt = pending_call.attempt;
+    client_->async_send_request(pending_call.request,
+      [this, call_id, attempt](typename rclcpp::Client<ServiceT>::SharedFuture future)
+      {
+        response_cb_(call_id, attempt, future.get());
+      });
+    pending_call.is_sent = true;
+  }
+
+
+  void response_cb_(uint64_t call_id, int attempt, typename Response::SharedPtr response)
+  {
+    ResponseCallback on_response;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      typename std::map<uint64_t, PendingCall>::iterator it = pending_calls_.find(call_id);
+      if(it == pending_calls_.end() || it->second.attempt != attempt)
+      {
+        statistics_.record_late_response();
+        return;
+      }
+
+      std::chrono::duration<double> latency = std::chrono::steady_clock::now() - it->second.start;
+      statistics_.record_response(latency.count());
+      on_response = it->second.on_response;
+      pending_calls_.erase(it);
+      stop_deadline_timer_if_idle_();
+    }
+
+    if(on_response)
+    {
+      on_response(response);
+    }
+  }
+
+
+  /**
+   * @brief Destroys the deadline timer when no call is pending. Requires the mutex to be held. The
+   * executor keeps the timer alive while its callback is running
+   */
+  void stop_deadline_timer_if_idle_()
+  {
+    if(pending_calls_.empty() && deadline_timer_)
+    {
+      deadline_timer_->cancel();
+      deadline_timer_.reset();
+    }
+  }
+
+
+  void check_deadlines_()
+  {
+    std::vector<ResponseCallback> failed_calls;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+      for(typename std::map<uint64_t, PendingCall>::iterator it = pending_calls_.begin(); it != pending_calls_.end();)
+      {
+        PendingCall& pending_call = it->second;
+        if(now < pending_call.attempt_deadline)
+        {
+          if(! pending_call.is_sent)
+          {
+            try_send_(it->first, pending_call);
+          }
+          ++it;
+          continue;
+        }
+
+        if(pending_call.attempt < pending_call.options.max_retries)
+        {
+          pending_call.attempt++;
+          statistics_.record_retry();
+          RCLCPP_WARN(logger_, "Call to " + service_name_ + " timed out. Retrying ("
+            + std::to_string(pending_call.attempt) + "/" + std::to_string(pending_call.options.max_retries) + ")");
+          start_attempt_(it->first, pending_call);
+          ++it;
+          continue;
+        }
+
+        statistics_.record_timeout();
+        RCLCPP_ERROR(logger_, "Call to " + service_name_ + " failed: " + statistics_.to_string());
+        failed_calls.push_back(pending_call.on_response);
+        it = pending_calls_.erase(it);
+      }
+      stop_deadline_timer_if_idle_();
+    }
+
+    for(const ResponseCallback& on_response : failed_calls)
+    {
+      if(on_response)
+      {
+        on_response(nullptr);
+      }
+    }
+  }
+
+}; // AsyncServiceClient
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include "rclcpp/rclcpp.hpp"
+#include "std_srvs/srv/set_bool.hpp"
+
+#include "anafi_uav_interfaces/async_service_client.hpp"
+
+using SetBool = std_srvs::srv::SetBool;
+
+
+TEST(ServiceCallStatistics, LatencyIsTakenOverTheAnsweredCalls)
+{
+  ServiceCallStatistics statistics;
+  EXPECT_DOUBLE_EQ(statistics.get_mean_latency_s(), 0.0);
+
+  statistics.record_call();
+  statistics.record_response(0.2);
+  statistics.record_call();
+  statistics.record_response(0.4);
+  statistics.record_call();
+  statistics.record_retry();
+  statistics.record_timeout();
+
+  EXPECT_EQ(statistics.get_num_calls(), 3);
+  EXPECT_EQ(statistics.get_num_responses(), 2);
+  EXPECT_EQ(statistics.get_num_retries(), 1);
+  EXPECT_EQ(statistics.get_num_timeouts(), 1);
+  EXPECT_NEAR(statistics.get_mean_latency_s(), 0.3, 1e-9);
+  EXPECT_DOUBLE_EQ(statistics.get_max_latency_s(), 0.4);
+}
+
+
+/**
+ * @brief The client is spun by the test thread, while the server is spun by its own thread
+ * such that a slow server does not block the deadline checks
+ */
+class AsyncServiceClientTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase() { rclcpp::init(0, nullptr); }
+  static void TearDownTestCase() { rclcpp::shutdown(); }
+
+  void SetUp() override
+  {
+    client_node_ = std::make_shared<rclcpp::Node>("async_service_client_test_client");
+    server_node_ = std::make_shared<rclcpp::Node>("async_service_client_test_server");
+    client_executor_.add_node(client_node_);
+    server_executor_.add_node(server_node_);
+  }
+
+  void TearDown() override
+  {
+    server_executor_.cancel();
+    if(server_thread_.joinable())
+    {
+      server_thread_.join();
+    }
+  }
+
+  /**
+   * @brief Starts a server answering with the requested value after @p delay
+   */
+  void start_server_(const std::string& service_name, std::chrono::milliseconds delay)
+  {
+    service_ = server_node_->create_service<SetBool>(service_name,
+      [delay](const std::shared_ptr<SetBool::Request> request, std::shared_ptr<SetBool::Response> response)
+      {
+        std::this_thread::sleep_for(delay);
+        response->success = request->data;
+      });
+    server_thread_ = std::thread([this](){ server_executor_.spin(); });
+  }
+
+  bool spin_until_(const std::function<bool()>& is_done, double timeout_s)
+  {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout_s);
+    while(! is_done())
+    {
+      if(std::chrono::steady_clock::now() >= deadline)
+      {
+        return false;
+      }
+      client_executor_.spin_some();
+      std::this_thread::sleep_for(1ms);
+    }
+    return true;
+  }
+
+  static SetBool::Request::SharedPtr make_request_(bool data)
+  {
+    SetBool::Request::SharedPtr request = std::make_shared<SetBool::Request>();
+    request->data = data;
+    return request;
+  }
+
+  rclcpp::Node::SharedPtr client_node_;
+  rclcpp::Node::SharedPtr server_node_;
+  rclcpp::executors::SingleThreadedExecutor client_executor_;
+  rclcpp::executors::SingleThreadedExecutor server_executor_;
+  rclcpp::Service<SetBool>::SharedPtr service_;
+  std::thread server_thread_;
+};
+
+
+TEST_F(AsyncServiceClientTest, ResponseIsPassedToTheContinuation)
+{
+  start_server_("async_service_client_test/answered", 0ms);
+  AsyncServiceClient<SetBool> client(client_node_.get(), "async_service_client_test/answered");
+
+  // The request is held back until the server has been discovered
+  bool is_answered = false;
+  SetBool::Response::SharedPtr response;
+  client.call(make_request_(true), [&](SetBool::Response::SharedPtr r){ is_answered = true; response = r; }, { 10.0, 0 });
+
+  ASSERT_TRUE(spin_until_([&](){ return is_answered; }, 20.0));
+  ASSERT_NE(response, nullptr);
+  EXPECT_TRUE(response->success);
+
+  ServiceCallStatistics statistics = client.get_statistics();
+  EXPECT_EQ(statistics.get_num_calls(), 1);
+  EXPECT_EQ(statistics.get_num_responses(), 1);
+  EXPECT_EQ(statistics.get_num_timeouts(), 0);
+}
+
+
+TEST_F(AsyncServiceClientTest, MissingServiceFailsAfterTheRetries)
+{
+  AsyncServiceClient<SetBool> client(client_node_.get(), "async_service_client_test/missing");
+
+  bool is_answered = false;
+  SetBool::Response::SharedPtr response = std::make_shared<SetBool::Response>();
+  const auto start = std::chrono::steady_clock::now();
+  client.call(make_request_(true), [&](SetBool::Response::SharedPtr r){ is_answered = true; response = r; }, { 0.1, 2 });
+
+  ASSERT_TRUE(spin_until_([&](){ return is_answered; }, 5.0));
+  const double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  EXPECT_EQ(response, nullptr);
+  EXPECT_GE(elapsed_s, 0.3);
+
+  ServiceCallStatistics statistics = client.get_statistics();
+  EXPECT_EQ(statistics.get_num_retries(), 2);
+  EXPECT_EQ(statistics.get_num_timeouts(), 1);
+  EXPECT_EQ(statistics.get_num_responses(), 0);
+}
+
+
+TEST_F(AsyncServiceClientTest, SlowResponseIsDroppedAfterTheDeadline)
+{
+  start_server_("async_service_client_test/slow", 500ms);
+  AsyncServiceClient<SetBool> client(client_node_.get(), "async_service_client_test/slow");
+  ASSERT_TRUE(spin_until_([&](){ return client.is_ready(); }, 20.0));
+
+  int num_continuations = 0;
+  SetBool::Response::SharedPtr response = std::make_shared<SetBool::Response>();
+  client.call(make_request_(true), [&](SetBool::Response::SharedPtr r){ num_continuations++; response = r; }, { 0.1, 0 });
+
+  ASSERT_TRUE(spin_until_([&](){ return num_continuations > 0; }, 5.0));
+  EXPECT_EQ(response, nullptr);
+
+  // The continuation is not run again when the response finally arrives
+  ASSERT_TRUE(spin_until_([&](){ return client.get_statistics().get_num_late_responses() > 0; }, 5.0));
+  EXPECT_EQ(num_continuations, 1);
+  EXPECT_EQ(client.get_statistics().get_num_responses(), 0);
+}
@@ -0,0 +1,366 @@
+#!/usr/bin/python3
+"""
+Runs many simulated missions in parallel and aggregates the results.
+
+Every instance runs sim_launch.py in its own ROS_DOMAIN_ID, such that the instances cannot see
+each other. An observer in the same domain injects person detections, battery drops and
+emergencies at randomised (seeded) times, and reports the outcome of the mission:
+
+  makespan        Simulated time from the first plan until the mission controller reports completion
+  num_replans     From /mission_controller/replan_statistics
+  planner_time    Wall time spent in the planner, from /mission_controller/replan_statistics
+
+Example:
+  source /opt/ros/foxy/setup.bash && source ~/colcon_ws/install/setup.bash
+  ./batch_runner.py run --seeds 200 --jobs 8 --output results.csv
+
+Each instance runs about fifteen processes. Most of them are idle, while the simulator and the
+planner use about one core each, thus the default number of parallel instances is half the cores
+"""
+import argparse
+import csv
+import json
+import math
+import os
+import queue
+import random
+import signal
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor, as_completed
+
+# Domain IDs above 101 may collide with the ephemeral ports on Linux
+MAX_DOMAIN_ID = 101
+
+RESULT_FIELDS = [
+  'seed', 'domain_id', 'mission_params_file', 'outcome', 'success', 'makespan', 'num_replans',
+  'planner_time', 'num_detections', 'num_battery_drops', 'num_emergencies', 'wall_time'
+]
+
+
+# Injections
+
+def create_injection_schedule(seed, locations, args):
+  """
+  Returns a list of (time_s, kind, data) sorted on time, relative to the start of the first plan.
+  Each detection is repeated a few times, as the person tracker requires several hits to confirm
+  """
+  rng = random.Random(seed)
+  schedule = []
+
+  for _ in range(rng.randint(0, args.max_detections)):
+    t = rng.uniform(args.min_injection_time, args.max_injection_time)
+    north, east = locations[rng.choice(sorted(locations))]
+    north += rng.gauss(0.0, 1.0)
+    east += rng.gauss(0.0, 1.0)
+    severity = rng.randint(0, 2)
+    for hit in range(args.detection_hits):
+      schedule.append((t + hit * args.detection_period, 'detection', (north, east, severity)))
+
+  if rng.random() < args.battery_drop_probability:
+    t = rng.uniform(args.min_injection_time, args.max_injection_time)
+    schedule.append((t, 'battery_drop', rng.uniform(args.min_battery_drop, args.max_battery_drop)))
+
+  if rng.random() < args.emergency_probability:
+    t = rng.uniform(args.min_injection_time, args.max_injection_time)
+    schedule.append((t, 'emergency', None))
+
+  schedule.sort(key=lambda injection: injection[0])
+  return schedule
+
+
+def load_search_locations(mission_params_file):
+  """
+  Returns the north-east positions of the locations to search, where the people are placed
+  """
+  import yaml
+  with open(mission_params_file, 'r') as f:
+    params = yaml.safe_load(f)
+  params = next(iter(params.values()))['ros__parameters']
+
+  pos_ne = params['locations']['pos_ne']
+  names = params.get('mission_goals', {}).get('locations_to_search') or list(pos_ne)
+  return {name: tuple(pos_ne[name]) for name in names}
+
+
+# Observer, running inside the domain of a single instance
+
+def observe(args):
+  import rclpy
+  from rclpy.node import Node
+  from rclpy.parameter import Parameter
+  from rclpy.qos import QoSProfile, ReliabilityPolicy
+  from std_msgs.msg import String, Float64, Empty
+  from anafi_uav_interfaces.msg import DetectedPerson, ReplanStatistics
+
+  schedule = create_injection_schedule(args.seed, load_search_locations(args.mission_params_file), args)
+
+  rclpy.init()
+  node = Node('batch_observer', parameter_overrides=[Parameter('use_sim_time', Parameter.Type.BOOL, True)])
+
+  state = {'status': None, 'replan_statistics': None}
+
+  def planning_status_cb(msg):
+    if msg.data in ('Mission completed', 'Mission failed'):
+      state['status'] = msg.data
+
+  def replan_statistics_cb(msg):
+    state['replan_statistics'] = msg
+
+  reliable = QoSProfile(depth=10, reliability=ReliabilityPolicy.RELIABLE)
+  node.create_subscription(String, '/mission_controller/planning_status', planning_status_cb, reliable)
+  node.create_subscription(ReplanStatistics, '/mission_controller/replan_statistics', replan_statistics_cb, reliable)
+  detected_person_pub = node.create_publisher(DetectedPerson, 'estimate/detected_person', reliable)
+  battery_drop_pub = node.create_publisher(Float64, '/anafi_sim/battery_drop', reliable)
+  emergency_pub = node.create_publisher(Empty, 'estimate/emergency', reliable)
+
+  def now_s():
+    return node.get_clock().now().nanoseconds * 1e-9
+
+  wall_deadline = time.monotonic() + args.wall_timeout
+  mission_start_s = None
+  outcome = 'timeout'
+  injections = {'detection': 0, 'battery_drop': 0, 'emergency': 0}
+
+  while rclpy.ok() and time.monotonic() < wall_deadline:
+    rclpy.spin_once(node, timeout_sec=0.05)
+
+    # The mission starts with the first plan
+    if mission_start_s is None:
+      if state['replan_statistics'] is not None and now_s() > 0:
+        mission_start_s = now_s()
+      continue
+
+    mission_time_s = now_s() - mission_start_s
+    while schedule and schedule[0][0] <= mission_time_s:
+      _, kind, data = schedule.pop(0)
+      injections[kind] += 1
+      if kind == 'detection':
+        north, east, severity = data
+        msg = DetectedPerson()
+        msg.header.stamp = node.get_clock().now().to_msg()
+        msg.id = 0
+        msg.severity = severity
+        msg.position.x = north
+        msg.position.y = east
+        detected_person_pub.publish(msg)
+      elif kind == 'battery_drop':
+        battery_drop_pub.publish(Float64(data=data))
+      elif kind == 'emergency':
+        emergency_pub.publish(Empty())
+
+    if state['status'] is not None:
+      outcome = 'completed' if state['status'] == 'Mission completed' else 'failed'
+      break
+    if mission_time_s > args.timeout:
+      break
+
+  replan_statistics = state['replan_statistics']
+  result = {
+    'outcome': outcome,
+    'success': outcome == 'completed',
+    'makespan': (now_s() - mission_start_s) if mission_start_s is not None else None,
+    'num_replans': replan_statistics.num_replans if replan_statistics else 0,
+    'planner_time': replan_statistics.total_planner_duration if replan_statistics else 0.0,
+    'num_detections': injections['detection'] // max(1, args.detection_hits),
+    'num_battery_drops': injections['battery_drop'],
+    'num_emergencies': injections['emergency'],
+  }
+
+  node.destroy_node()
+  rclpy.shutdown()
+  print(json.dumps(result))
+
+
+# Runner
+
+def stop_process_group(process, timeout_s=10.0):
+  """
+  Stops the launch and all nodes started by it, as they share the process group
+  """
+  if process.poll() is not None:
+    return
+  for sig in (signal.SIGINT, signal.SIGTERM, signal.SIGKILL):
+    try:
+      os.killpg(process.pid, sig)
+    except ProcessLookupError:
+      return
+    try:
+      process.wait(timeout=timeout_s)
+      return
+    except subprocess.TimeoutExpired:
+      pass
+
+
+def observer_arguments(args, seed, mission_params_file):
+  forwarded = [
+    'timeout', 'wall_timeout', 'max_detections', 'detection_hits', 'detection_period',
+    'battery_drop_probability', 'min_battery_drop', 'max_battery_drop', 'emergency_probability',
+    'min_injection_time', 'max_injection_time'
+  ]
+  observer_args = [sys.executable, os.path.abspath(__file__), 'observe',
+                   '--seed', str(seed), '--mission-params-file', mission_params_file]
+  for name in forwarded:
+    observer_args += ['--' + name.replace('_', '-'), str(getattr(args, name))]
+  return observer_args
+
+
+def run_instance(seed, mission_params_file, domain_ids, args):
+  domain_id = domain_ids.get()
+  wall_start = time.monotonic()
+  result = {'outcome': 'crashed', 'success': False, 'makespan': None, 'num_replans': 0, 'planner_time': 0.0,
+            'num_detections': 0, 'num_battery_drops': 0, 'num_emergencies': 0}
+  try:
+    env = dict(os.environ, ROS_DOMAIN_ID=str(domain_id), ROS_LOCALHOST_ONLY='1')
+    log_path = os.path.join(args.log_dir, 'seed_%d.log' % seed)
+    with open(log_path, 'w') as log:
+      launch = subprocess.Popen(
+        ['ros2', 'launch', 'automated_planning', 'sim_launch.py',
+         'real_time_factor:=%f' % args.real_time_factor, 'mission_params_file:=' + mission_params_file],
+        env=env, stdout=log, stderr=subprocess.STDOUT, start_new_session=True)
+      try:
+        observer = subprocess.run(
+          observer_arguments(args, seed, mission_params_file), env=env, stdout=subprocess.PIPE,
+          stderr=log, universal_newlines=True, timeout=args.wall_timeout + 30.0)
+        lines = observer.stdout.strip().splitlines()
+        if lines:
+          result.update(json.loads(lines[-1]))
+      except (subprocess.TimeoutExpired, ValueError):
+        pass
+      finally:
+        stop_process_group(launch)
+  finally:
+    domain_ids.put(domain_id)
+
+  result.update({'seed': seed, 'domain_id': domain_id, 'mission_params_file': mission_params_file,
+                 'wall_time': time.monotonic() - wall_start})
+  return result
+
+
+def percentile(values, p):
+  if not values:
+    return float('nan')
+  # Nearest rank
+  values = sorted(values)
+  index = min(len(values) - 1, max(0, int(math.ceil(p / 100.0 * len(values))) - 1))
+  return values[index]
+
+
+def mean(values):
+  return sum(values) / len(values) if values else float('nan')
+
+
+def summarize(results):
+  successful = [r for r in results if r['success']]
+  makespans = [r['makespan'] for r in successful if r['makespan'] is not None]
+  outcomes = {}
+  for r in results:
+    outcomes[r['outcome']] = outcomes.get(r['outcome'], 0) + 1
+
+  lines = [
+    'Missions:      %d (%s)' % (len(results), ', '.join('%s: %d' % item for item in sorted(outcomes.items()))),
+    'Success rate:  %.1f %%' % (100.0 * len(successful) / max(1, len(results))),
+    'Makespan:      mean %.1f s, p50 %.1f s, p95 %.1f s, max %.1f s' % (
+      mean(makespans), percentile(makespans, 50), percentile(makespans, 95), max(makespans, default=float('nan'))),
+    'Replans:       mean %.2f, max %d' % (
+      mean([r['num_replans'] for r in results]), max((r['num_replans'] for r in results), default=0)),
+    'Planner time:  mean %.2f s per mission, p95 %.2f s' % (
+      mean([r['planner_time'] for r in results]), percentile([r['planner_time'] for r in results], 95)),
+    'Wall time:     mean %.1f s per mission' % mean([r['wall_time'] for r in results]),
+  ]
+  return '\n'.join(lines)
+
+
+def run(args):
+  if args.jobs < 1 or args.first_domain_id + args.jobs - 1 > MAX_DOMAIN_ID:
+    sys.exit('The domain IDs %d to %d must be within [0, %d]' % (
+      args.first_domain_id, args.first_domain_id + args.jobs - 1, MAX_DOMAIN_ID))
+
+  if not args.mission_params_file:
+    from ament_index_python.packages import get_package_share_directory
+    args.mission_params_file = [os.path.join(
+      get_package_share_directory('automated_planning'), 'config', 'mission_parameters.yaml')]
+  mission_params_files = [os.path.abspath(f) for f in args.mission_params_file]
+  os.makedirs(args.log_dir, exist_ok=True)
+
+  # Each running instance holds a domain ID, and returns it when finished
+  domain_ids = queue.Queue()
+  for domain_id in range(args.first_domain_id, args.first_domain_id + args.jobs):
+    domain_ids.put(domain_id)
+
+  seeds = range(args.first_seed, args.first_seed + args.seeds)
+  results = []
+  with ThreadPoolExecutor(max_workers=args.jobs) as executor:
+    futures = [
+      executor.submit(run_instance, seed, mission_params_files[i % len(mission_params_files)], domain_ids, args)
+      for i, seed in enumerate(seeds)
+    ]
+    try:
+      for future in as_completed(futures):
+        result = future.result()
+        results.append(result)
+        print('[%d/%d] seed %d: %s, makespan %s, %d replans' % (
+          len(results), len(futures), result['seed'], result['outcome'],
+          '%.1f s' % result['makespan'] if result['makespan'] is not None else '-', result['num_replans']),
+          flush=True)
+    except KeyboardInterrupt:
+      for future in futures:
+        future.cancel()
+      raise
+
+  results.sort(key=lambda r: r['seed'])
+  if args.output:
+    with open(args.output, 'w', newline='') as f:
+      writer = csv.DictWriter(f, fieldnames=RESULT_FIELDS, extrasaction='ignore')
+      writer.writeheader()
+      writer.writerows(results)
+
+  print(summarize(results))
+
+
+def add_scenario_arguments(parser):
+  parser.add_argument('--timeout', type=float, default=1800.0, help='[s] Simulated time before a mission is aborted')
+  parser.add_argument('--wall-timeout', type=float, default=600.0, help='[s] Wall time before a mission is aborted')
+  parser.add_argument('--max-detections', type=int, default=2, help='Maximum number of people detected per mission')
+  parser.add_argument('--detection-hits', type=int, default=5, help='Detections published per person')
+  parser.add_argument('--detection-period', type=float, default=0.2, help='[s] Simulated time between the detections of a person')
+  parser.add_argument('--battery-drop-probability', type=float, default=0.3)
+  parser.add_argument('--min-battery-drop', type=float, default=10.0, help='[%%]')
+  parser.add_argument('--max-battery-drop', type=float, default=40.0, help='[%%]')
+  parser.add_argument('--emergency-probability', type=float, default=0.1)
+  parser.add_argument('--min-injection-time', type=float, default=10.0, help='[s] Simulated time after the first plan')
+  parser.add_argument('--max-injection-time', type=float, default=300.0, help='[s] Simulated time after the first plan')
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+  subparsers = parser.add_subparsers(dest='command')
+  subparsers.required = True
+
+  run_parser = subparsers.add_parser('run', help='Run a batch of missions')
+  run_parser.add_argument('--seeds', type=int, default=100, help='Number of missions')
+  run_parser.add_argument('--first-seed', type=int, default=0)
+  run_parser.add_argument('--jobs', type=int, default=max(1, (os.cpu_count() or 1) // 2), help='Missions run in parallel')
+  run_parser.add_argument('--first-domain-id', type=int, default=1)
+  run_parser.add_argument('--real-time-factor', type=float, default=20.0)
+  run_parser.add_argument('--mission-params-file', action='append',
+                          help='Mission parameters, cycled over the seeds. Can be given several times')
+  run_parser.add_argument('--log-dir', default='batch_logs')
+  run_parser.add_argument('--output', default='batch_results.csv')
+  add_scenario_arguments(run_parser)
+
+  observe_parser = subparsers.add_parser('observe', help='Inject events into and observe a single running mission')
+  observe_parser.add_argument('--seed', type=int, required=True)
+  observe_parser.add_argument('--mission-params-file', required=True)
+  add_scenario_arguments(observe_parser)
+
+  args = parser.parse_args()
+  if args.command == 'run':
+    run(args)
+  else:
+    observe(args)
+
+
+if __name__ == '__main__':
+  main()
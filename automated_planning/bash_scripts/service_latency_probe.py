@@ -0,0 +1,79 @@
+#!/usr/bin/python3
+"""
+Measures the response latency of /mission_controller/finished_action while a mission is running.
+
+The probe requests an unknown action, which the mission controller reports as an error and
+otherwise ignores. The response only acknowledges that the request is queued, so the latency is
+that of the service group, and not of the step which applies the request. Run it during planning load, for example while the batch runner injects
+detections, to compare the latency between versions of the controller:
+
+  ./service_latency_probe.py --rate 5 --duration 120
+"""
+import argparse
+import time
+
+import rclpy
+from rclpy.node import Node
+from anafi_uav_interfaces.srv import SetFinishedAction
+
+
+def percentile(values, p):
+  values = sorted(values)
+  return values[min(len(values) - 1, int(p / 100.0 * len(values)))]
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+  parser.add_argument('--rate', type=float, default=5.0, help='[Hz] Requests per second')
+  parser.add_argument('--duration', type=float, default=60.0, help='[s] Wall time to measure')
+  parser.add_argument('--timeout', type=float, default=10.0, help='[s] Requests without a response are counted as lost')
+  args = parser.parse_args()
+
+  rclpy.init()
+  node = Node('service_latency_probe')
+  client = node.create_client(SetFinishedAction, '/mission_controller/finished_action')
+  if not client.wait_for_service(timeout_sec=10.0):
+    node.get_logger().error('/mission_controller/finished_action is not available')
+    return
+
+  request = SetFinishedAction.Request()
+  request.finished_action_name.data = 'latency_probe'
+
+  pending = {}      # future -> send time
+  latencies = []
+  num_lost = 0
+  period = 1.0 / args.rate
+  next_send = time.monotonic()
+  end = next_send + args.duration
+
+  while rclpy.ok() and (time.monotonic() < end or pending):
+    now = time.monotonic()
+    if now >= next_send and now < end:
+      pending[client.call_async(request)] = now
+      next_send += period
+
+    rclpy.spin_once(node, timeout_sec=0.001)
+
+    now = time.monotonic()
+    for future, send_time in list(pending.items()):
+      if future.done():
+        latencies.append(now - send_time)
+        del pending[future]
+      elif now - send_time > args.timeout:
+        num_lost += 1
+        del pending[future]
+
+  if latencies:
+    print('Requests: %d, lost: %d' % (len(latencies) + num_lost, num_lost))
+    print('Latency [ms]: mean %.1f, p50 %.1f, p95 %.1f, p99 %.1f, max %.1f' % (
+      1e3 * sum(latencies) / len(latencies), 1e3 * percentile(latencies, 50), 1e3 * percentile(latencies, 95),
+      1e3 * percentile(latencies, 99), 1e3 * max(latencies)))
+  else:
+    print('No responses received (%d lost)' % num_lost)
+
+  node.destroy_node()
+  rclpy.shutdown()
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <chrono>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
+#include "rclcpp_lifecycle/lifecycle_publisher.hpp"
+#include "rclcpp_lifecycle/node_interfaces/lifecycle_node_interface.hpp"
+
+#include "anafi_uav_interfaces/msg/activation_latency.hpp"
+#include "anafi_uav_interfaces/msg/startup_timeline.hpp"
+
+#include "automated_planning/action_readiness.hpp"
+#include "automated_planning/startup_timeline.hpp"
+#include "automated_planning/startup_timeline_conversion.hpp"
+
+using namespace std::chrono_literals;
+
+
+/**
+ * @brief Shared by the action nodes, such that the connections to services and action servers
+ * are established when the node is configured, and such that the activation latency is
+ * published for every action type on /action_activation_latency
+ *
+ * The startup of the node is published on /startup/timeline once the connections are first
+ * ready. Until then, the connections are checked every startup_check_period instead of every
+ * check_period, such that the node is ready soon after its servers are. A node without
+ * connections is not checked after its startup, such that it does not wake while inactive
+ *
+ * Usage:
+ *  - Register the clients in the constructor of the node
+ *  - Call start() from on_configure()
+ *  - Create an ActivationScope at the start of on_activate(), and return through succeeded()
+ */
+class ActionActivationMonitor
+{
+public:
+  /**
+   * @brief Records a single activation, from construction until destruction
+   */
+  class ActivationScope
+  {
+  public:
+    explicit ActivationScope(ActionActivationMonitor& monitor)
+    : monitor_(monitor)
+    , start_(std::chrono::steady_clock::now())
+    , success_(false)
+    {}
+
+    ~ActivationScope()
+    {
+      std::chrono::duration<double> latency = std::chrono::steady_clock::now() - start_;
+      monitor_.record_activation_(latency.count(), success_);
+    }
+
+    /**
+     * @brief Marks the activation as successful if @p result is SUCCESS, and returns @p result
+     */
+    rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn succeeded(
+      rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn result)
+    {
+      success_ = (result == rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn::SUCCESS);
+      return result;
+    }
+
+  private:
+    ActionActivationMonitor& monitor_;
+    std::chrono::steady_clock::time_point start_;
+    bool success_;
+  };
+
+
+  /**
+   * @param activation_timeout_s [s] Upper limit on the time on_activate waits for a connection
+   * which has not been seen ready since the node was configured
+   */
+  ActionActivationMonitor(
+    rclcpp_lifecycle::LifecycleNode* node,
+    std::chrono::milliseconds check_period=1000ms,
+    double activation_timeout_s=0.25,
+    std::chrono::milliseconds startup_check_period=50ms)
+  : node_(node)
+  , check_period_(check_period)
+  , startup_check_period_(startup_check_period)
+  , activation_timeout_s_(activation_timeout_s)
+  , startup_timeline_(node->get_fully_qualified_name())
+  , is_started_up_(false)
+  {
+    latency_pub_ = node_->create_publisher<anafi_uav_interfaces::msg::ActivationLatency>(
+      "/action_activation_latency", rclcpp::QoS(10).reliable());
+    startup_timeline_pub_ = node_->create_publisher<anafi_uav_interfaces::msg::StartupTimeline>(
+      "/startup/timeline", rclcpp::QoS(1).reliable().transient_local());
+    startup_timeline_.mark("constructed");
+  }
+
+
+  void add_service(const rclcpp::ClientBase::SharedPtr& client)
+  {
+    readiness_.add_connection(client->get_service_name(), [client](){ return client->service_is_ready(); });
+  }
+
+
+  void add_action_server(const std::string& name, const rclcpp_action::ClientBase::SharedPtr& client)
+  {
+    readiness_.add_connection(name, [client](){ return client->action_server_is_ready(); });
+  }
+
+
+  /**
+   * @brief Starts the periodic readiness checks. Must be called when the node is configured,
+   * after the parameter action_name is set
+   */
+  void start()
+  {
+    action_name_ = node_->get_parameter("action_name").as_string();
+    latency_pub_->on_activate();
+    startup_timeline_pub_->on_activate();
+    if(! is_started_up_)
+    {
+      startup_timeline_.begin("connections");
+    }
+
+    check_timer_cb_();
+    if(! is_started_up_)
+    {
+      check_timer_ = rclcpp::create_timer(node_, node_->get_clock(), rclcpp::Duration(startup_check_period_), std::bind(&ActionActivationMonitor::check_timer_cb_, this));
+    }
+  }
+
+
+  /**
+   * @brief Returns true if the connection @p name is ready, waiting at most the activation timeout
+   */
+  bool wait_until_ready(const std::string& name)
+  {
+    bool is_ready = readiness_.wait_until_ready(name, activation_timeout_s_);
+    if(! is_ready)
+    {
+      RCLCPP_ERROR(node_->get_logger(), "Connection " + name + " not ready");
+    }
+    return is_ready;
+  }
+
+
+  bool wait_until_ready(const rclcpp::ClientBase::SharedPtr& client)
+  {
+    return wait_until_ready(client->get_service_name());
+  }
+
+
+  /**
+   * @brief Publishes the startup timeline, after the phases of the node itself are added to it.
+   * Ignored before the node is configured, as the timeline is published when its connections are
+   * first ready
+   */
+  void publish_startup_timeline()
+  {
+    if(startup_timeline_pub_->is_activated())
+    {
+      startup_timeline_pub_->publish(to_startup_timeline_msg(startup_timeline_));
+    }
+  }
+
+
+  const ConnectionReadinessCache& get_readiness() const { return readiness_; }
+  const ActivationLatencySummary& get_latency_summary() const { return latency_.get_summary(); }
+  StartupTimeline& get_startup_timeline() { return startup_timeline_; }
+
+private:
+  rclcpp_lifecycle::LifecycleNode* node_;
+  std::string action_name_;
+
+  std::chrono::milliseconds check_period_;
+  std::chrono::milliseconds startup_check_period_;
+  double activation_timeout_s_;
+
+  StartupTimeline startup_timeline_;
+  bool is_started_up_;            // The connections have been ready
+
+  ConnectionReadinessCache readiness_;
+  ActivationLatencyStatistics latency_;
+
+  rclcpp_lifecycle::LifecyclePublisher<anafi_uav_interfaces::msg::ActivationLatency>::SharedPtr latency_pub_;
+  rclcpp_lifecycle::LifecyclePublisher<anafi_uav_interfaces::msg::StartupTimeline>::SharedPtr startup_timeline_pub_;
+  rclcpp::TimerBase::SharedPtr check_timer_;
+
+
+  void check_timer_cb_()
+  {
+    bool was_all_ready = readiness_.is_all_ready();
+    bool is_all_ready = readiness_.update(node_->get_clock()->now().seconds());
+    if(was_all_ready && ! is_all_ready)
+    {
+      for(const std::string& name : readiness_.get_unready_connections())
+      {
+        RCLCPP_WARN(node_->get_logger(), "Connection " + name + " lost");
+      }
+    }
+
+    if(is_all_ready && ! is_started_up_)
+    {
+      is_started_up_ = true;
+      startup_timeline_.end("connections");
+      startup_timeline_.mark("ready");
+      publish_startup_timeline();
+
+      // The timer is destroyed after this callback returns, as the executor holds it while running it
+      check_timer_ = nullptr;
+      if(readiness_.get_num_connections() > 0)
+      {
+        check_timer_ = rclcpp::create_timer(node_, node_->get_clock(), rclcpp::Duration(check_period_), std::bind(&ActionActivationMonitor::check_timer_cb_, this));
+      }
+    }
+  }
+
+
+  void record_activation_(double latency_s, bool success)
+  {
+    latency_.add_sample(latency_s, success);
+    const ActivationLatencySummary& summary = latency_.get_summary();
+
+    anafi_uav_interfaces::msg::ActivationLatency latency_msg;
+    latency_msg.header.stamp = node_->get_clock()->now();
+    latency_msg.action_name = action_name_;
+    latency_msg.success = success;
+    latency_msg.latency = latency_s;
+    latency_msg.num_activations = summary.num_activations;
+    latency_msg.num_failed_activations = summary.num_failed_activations;
+    latency_msg.mean_latency = summary.mean_s;
+    latency_msg.p50_latency = summary.p50_s;
+    latency_msg.p95_latency = summary.p95_s;
+    latency_msg.max_latency = summary.max_s;
+    latency_msg.unready_connections = readiness_.get_unready_connections();
+    latency_pub_->publish(latency_msg);
+
+    RCLCPP_DEBUG(node_->get_logger(), "Activation of %s took %f s", action_name_.c_str(), latency_s);
+  }
+
+}; // ActionActivationMonitor
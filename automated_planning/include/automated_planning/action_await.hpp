@@ -0,0 +1,69 @@
+#pragma once
+
+#include <limits>
+
+
+/**
+ * Awaitables for the activation state of the action nodes. do_work() resumes an activation at
+ * every tick, and the activation awaits telemetry conditions, timeouts and repeated commands with
+ * these instead of function-static counters. The awaitables are members of the activation, such
+ * that each activation starts from a fresh state and several nodes may share a process
+ *
+ * The waited time is accumulated from the tick intervals, such that it is independent of the
+ * tick rate
+ */
+
+enum class AwaitStatus { WAITING, READY, TIMED_OUT };
+
+
+/**
+ * @brief Awaits a condition, such as a state of the drone, for at most a timeout
+ */
+class ConditionAwaiter
+{
+public:
+  explicit ConditionAwaiter(double timeout_s=std::numeric_limits<double>::infinity());
+
+  /**
+   * @brief READY if @p condition holds, otherwise waits @p dt_s more and times out when the total
+   * waited time reaches the timeout. Keeps reporting TIMED_OUT until reset
+   */
+  AwaitStatus await(bool condition, double dt_s);
+
+  void reset();
+
+  double get_waited_s() const { return waited_s_; }
+
+private:
+  double timeout_s_;
+  double waited_s_;
+
+}; // ConditionAwaiter
+
+
+/**
+ * @brief Awaits a repeating period, such as between retries of a command
+ */
+class PeriodAwaiter
+{
+public:
+  explicit PeriodAwaiter(double period_s);
+
+  /**
+   * @brief True once for every period elapsed after waiting @p dt_s more
+   */
+  bool await(double dt_s);
+
+  void reset();
+
+  /**
+   * @brief Number of elapsed periods since construction or reset
+   */
+  int get_num_periods() const { return num_periods_; }
+
+private:
+  double period_s_;
+  double waited_s_;
+  int num_periods_;
+
+}; // PeriodAwaiter
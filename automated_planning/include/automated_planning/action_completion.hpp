@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+enum class CompletedAction : uint8_t { SEARCH = 0, COMMUNICATE, MARK, RESCUE };
+enum class SearchDetection : uint8_t { NONE = 0, PERSON, HELIPAD };
+
+
+/**
+ * @brief An action which achieves a mission goal, reported by the action node when it finishes.
+ * The objects are given by their IDs, such that no strings are built or parsed per event
+ */
+struct ActionCompletion
+{
+  CompletedAction action{ CompletedAction::SEARCH };
+  int location_idx{ -1 };           // Index into locations.names
+  int person_id{ -1 };              // ID of the person p<id>. Negative for a search
+  SearchDetection detection{ SearchDetection::NONE };
+};
+
+
+/**
+ * @brief Index of @p location in @p location_names, or -1 if unknown
+ */
+int get_location_idx(const std::vector<std::string>& location_names, const std::string& location);
+
+/**
+ * @brief ID of a person named after its track, such as 3 for p3, or -1 for any name other than
+ * p followed by the decimal ID
+ */
+int get_person_id(const std::string& person);
+
+/**
+ * @brief The completion reported through the SetFinishedAction service, which names the action,
+ * the location and the person. Returns std::nullopt for unknown actions and locations
+ */
+std::optional<ActionCompletion> to_action_completion(
+  const std::string& action_name,
+  const std::string& location,
+  const std::string& person,
+  const std::vector<std::string>& location_names);
+
+/**
+ * @brief True if @p goal is achieved by @p completion, such as (not_marked p3 loc) by marking
+ * person 3 at loc. The goal is compared in place, and its person must be named exactly p<id>
+ */
+bool is_completed_goal(
+  const ActionCompletion& completion,
+  const std::string& goal,
+  const std::vector<std::string>& location_names);
+
+/**
+ * @brief Removes the goals achieved by any of @p completions in a single pass over @p goals, and
+ * returns the number of removed goals. Completions without a matching goal are ignored, such
+ * that repeated events are harmless
+ */
+size_t remove_completed_goals(
+  const std::vector<ActionCompletion>& completions,
+  const std::vector<std::string>& location_names,
+  std::vector<std::string>& goals);
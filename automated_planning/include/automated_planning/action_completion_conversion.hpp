@@ -0,0 +1,44 @@
+#pragma once
+
+#include "builtin_interfaces/msg/time.hpp"
+
+#include "anafi_uav_interfaces/msg/action_completion.hpp"
+
+#include "automated_planning/action_completion.hpp"
+
+
+/**
+ * @brief The event published by the action nodes on /mission_controller/action_completions
+ */
+inline anafi_uav_interfaces::msg::ActionCompletion to_action_completion_msg(
+  const ActionCompletion& completion, 
+  const builtin_interfaces::msg::Time& stamp)
+{
+  anafi_uav_interfaces::msg::ActionCompletion completion_msg;
+  completion_msg.stamp = stamp;
+  completion_msg.action = static_cast<uint8_t>(completion.action);
+  completion_msg.location_idx = completion.location_idx;
+  completion_msg.person_id = completion.person_id;
+  completion_msg.detection = static_cast<uint8_t>(completion.detection);
+  return completion_msg;
+}
+
+
+/**
+ * @brief The completion received by the mission controller. Unknown actions are returned as a
+ * completion without location, which matches no goal
+ */
+inline ActionCompletion to_action_completion(const anafi_uav_interfaces::msg::ActionCompletion& completion_msg)
+{
+  ActionCompletion completion;
+  if(completion_msg.action > anafi_uav_interfaces::msg::ActionCompletion::RESCUE)
+  {
+    return completion;
+  }
+  completion.action = static_cast<CompletedAction>(completion_msg.action);
+  completion.location_idx = completion_msg.location_idx;
+  completion.person_id = completion_msg.person_id;
+  completion.detection = (completion_msg.detection <= anafi_uav_interfaces::msg::ActionCompletion::DETECTION_HELIPAD) 
+    ? static_cast<SearchDetection>(completion_msg.detection) : SearchDetection::NONE;
+  return completion;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
+#include "rclcpp_lifecycle/lifecycle_publisher.hpp"
+
+#include "anafi_uav_interfaces/msg/action_completion.hpp"
+
+#include "automated_planning/action_completion.hpp"
+#include "automated_planning/action_completion_conversion.hpp"
+
+
+/**
+ * @brief Shared by the action nodes which achieve mission goals, such that the completion is
+ * reported to the mission controller on /mission_controller/action_completions. The event is
+ * published without waiting for the controller, and the transient-local durability delivers it
+ * once the controller is discovered. The event is stamped with the node clock, such that a
+ * restarted controller can drop the events from before its checkpoint
+ *
+ * Usage:
+ *  - Construct in the constructor of the node, after declaring its parameters
+ *  - Call start() from on_configure()
+ */
+class ActionCompletionPublisher
+{
+public:
+  explicit ActionCompletionPublisher(rclcpp_lifecycle::LifecycleNode* node)
+  : node_(node)
+  {
+    const std::string locations_param = "locations.names";
+    if(! node_->has_parameter(locations_param))
+    {
+      node_->declare_parameter(locations_param, std::vector<std::string>());
+    }
+    location_names_ = node_->get_parameter(locations_param).as_string_array();
+
+    completion_pub_ = node_->create_publisher<anafi_uav_interfaces::msg::ActionCompletion>(
+      "/mission_controller/action_completions", rclcpp::QoS(10).reliable().transient_local());
+  }
+
+
+  void start()
+  {
+    completion_pub_->on_activate();
+  }
+
+
+  /**
+   * @brief Reports that @p action is completed at @p location for @p person, named as in the
+   * arguments of the action. Returns false if the location is unknown
+   */
+  bool publish(
+    CompletedAction action, 
+    const std::string& location, 
+    const std::string& person="", 
+    SearchDetection detection=SearchDetection::NONE)
+  {
+    ActionCompletion completion;
+    completion.action = action;
+    completion.location_idx = get_location_idx(location_names_, location);
+    completion.person_id = (action == CompletedAction::SEARCH) ? -1 : get_person_id(person);
+    completion.detection = detection;
+    if(completion.location_idx < 0)
+    {
+      RCLCPP_ERROR(node_->get_logger(), "Unable to report the completed action: Unknown location " + location);
+      return false;
+    }
+
+    completion_pub_->publish(to_action_completion_msg(completion, node_->get_clock()->now()));
+    return true;
+  }
+
+private:
+  rclcpp_lifecycle::LifecycleNode* node_;
+  std::vector<std::string> location_names_;
+
+  rclcpp_lifecycle::LifecyclePublisher<anafi_uav_interfaces::msg::ActionCompletion>::SharedPtr completion_pub_;
+
+}; // ActionCompletionPublisher
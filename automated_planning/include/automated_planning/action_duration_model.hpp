@@ -0,0 +1,147 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief Linear model of the duration of an action type, on the form
+ *    duration = overhead + seconds_per_meter * distance
+ *
+ * The parameters are estimated using recursive least squares with exponential forgetting,
+ * such that the model follows slow changes in the drone's behaviour (wind, battery, GNC tuning)
+ * while still being initialized by a prior from the config file. Actions without a natural
+ * distance (land, takeoff, drop_marker...) use a distance of 0, and thus only estimate the overhead
+ */
+struct LinearDurationModel
+{
+  double overhead_s{ 0.0 };
+  double seconds_per_meter{ 0.0 };
+
+  // Covariance of the parameters [overhead, seconds_per_meter]
+  double p_00{ 100.0 };
+  double p_01{ 0.0 };
+  double p_11{ 1.0 };
+
+  int num_observations{ 0 };
+};
+
+
+class ActionDurationModel
+{
+public:
+  /**
+   * @param move_velocity         [m/s] Velocity used as prior for the move-action
+   * @param track_velocity        [m/s] Velocity used as prior for the search-action
+   * @param search_distance       [m]   Prior length of the search pattern
+   * @param forgetting_factor     Forgetting factor in (0, 1]. Lower values adapt faster
+   */
+  ActionDurationModel(
+    double move_velocity,
+    double track_velocity,
+    double search_distance,
+    double forgetting_factor=0.95
+  );
+
+
+  /**
+   * @brief Sets the length of the search pattern. The search pattern is generated by the
+   * waypoints_generator, and the length is reported by the search action node after it has
+   * acquired the waypoints
+   */
+  void set_search_distance(double search_distance);
+  double get_search_distance() const { return search_distance_; }
+
+
+  /**
+   * @brief Predicts the duration of an action of the type @p action_type
+   *
+   * @param action_type Name of the PDDL-action, for example "move" or "search"
+   * @param distance    [m] Distance travelled during the action. Ignored for search,
+   *                    as the search distance is given by the search pattern
+   */
+  double predict(const std::string& action_type, double distance=0.0) const;
+  double predict_move(double distance) const { return predict("move", distance); }
+  double predict_search() const { return predict("search", search_distance_); }
+
+
+  /**
+   * @brief Adds an observed execution of an action, and recalibrates the model for
+   * the action type. Observations which are obviously invalid are rejected
+   *
+   * @return True if the observation was used
+   */
+  bool add_observation(const std::string& action_type, double distance, double duration_s);
+
+
+  /**
+   * @brief Returns the number of observations for an action type, or 0 if none
+   */
+  int get_num_observations(const std::string& action_type) const;
+
+
+  /**
+   * @brief Human-readable summary of the current models
+   */
+  std::string to_string() const;
+
+private:
+  double search_distance_;
+  double forgetting_factor_;
+
+  // Duration used for actions which are not modelled by the PDDL-file
+  const double default_duration_s_{ 1.0 };
+
+  std::map<std::string, LinearDurationModel> models_;
+
+  const LinearDurationModel* find_model_(const std::string& action_type) const;
+};
+
+
+/**
+ * @brief Tracks the predicted and the actual makespan of the plans executed during a mission
+ */
+class MakespanTracker
+{
+public:
+  /**
+   * @brief Registers the start of a plan with a predicted makespan @p predicted_s at time @p start_time_s
+   */
+  void start_plan(double predicted_s, double start_time_s);
+
+  /**
+   * @brief Registers that the current plan is finished (or cancelled) at @p end_time_s
+   *
+   * @param completed False if the plan was interrupted by a replan. Interrupted plans are
+   * not included in the error statistics, as the prediction was never meant to hold
+   *
+   * @return Signed error (actual - predicted) of the plan in seconds. 0 if no plan was running
+   */
+  double end_plan(double end_time_s, bool completed=true);
+
+  bool is_plan_running() const { return plan_running_; }
+
+  /**
+   * @brief Predicted time until the current plan finishes, or 0 if no plan is running
+   */
+  double get_predicted_remaining_s(double time_s) const;
+
+  double get_mission_predicted_s() const { return mission_predicted_s_; }
+  double get_mission_actual_s() const { return mission_actual_s_; }
+  int get_num_completed_plans() const { return num_completed_plans_; }
+
+  /**
+   * @brief Relative makespan error of the mission, (actual - predicted) / predicted
+   */
+  double get_mission_relative_error() const;
+
+private:
+  bool plan_running_{ false };
+  double plan_predicted_s_{ 0.0 };
+  double plan_start_time_s_{ 0.0 };
+
+  double mission_predicted_s_{ 0.0 };
+  double mission_actual_s_{ 0.0 };
+  int num_completed_plans_{ 0 };
+};
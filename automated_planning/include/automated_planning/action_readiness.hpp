@@ -0,0 +1,105 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <functional>
+
+
+/**
+ * @brief Cache of the readiness of the services and action servers an action node depends on.
+ * The connections are checked periodically while the node is idle, such that the activation
+ * only has to look up the cached state instead of waiting for the servers
+ *
+ * The checks must be non-blocking, for example rclcpp::ClientBase::service_is_ready() or
+ * rclcpp_action::ClientBase::action_server_is_ready()
+ */
+class ConnectionReadinessCache
+{
+public:
+  using ReadinessCheck = std::function<bool()>;
+
+  /**
+   * @brief Registers the connection @p name, which is ready when @p check returns true
+   */
+  void add_connection(const std::string& name, const ReadinessCheck& check);
+
+  /**
+   * @brief Runs all checks and updates the cached state. Returns true if all connections are ready
+   */
+  bool update(double time_s);
+
+  /**
+   * @brief Runs the check for the connection @p name and updates the cached state
+   */
+  bool update(const std::string& name, double time_s);
+
+  /**
+   * @brief Polls the check for @p name until it is ready or @p timeout_s has passed. Returns
+   * immediately if the cached state is ready, such that the timeout is only paid when the server
+   * has not been seen since the node was configured
+   */
+  bool wait_until_ready(const std::string& name, double timeout_s);
+
+  bool is_ready(const std::string& name) const;
+  bool is_all_ready() const;
+  size_t get_num_connections() const { return connections_.size(); }
+
+  /**
+   * @brief Returns the names of the connections which were not ready at the last update
+   */
+  std::vector<std::string> get_unready_connections() const;
+
+  /**
+   * @brief Returns the time the connection @p name was last seen ready, or a negative value if never
+   */
+  double get_last_ready_s(const std::string& name) const;
+
+private:
+  struct Connection
+  {
+    ReadinessCheck check;
+    bool is_ready{ false };
+    double last_ready_s{ -1.0 };
+  };
+
+  std::map<std::string, Connection> connections_;
+};
+
+
+/**
+ * @brief Summary of the activation latencies of an action node over a sliding window
+ */
+struct ActivationLatencySummary
+{
+  int num_activations{ 0 };
+  int num_failed_activations{ 0 };
+  double last_s{ 0.0 };
+  double mean_s{ 0.0 };
+  double p50_s{ 0.0 };
+  double p95_s{ 0.0 };
+  double max_s{ 0.0 };
+};
+
+
+/**
+ * @brief Records the time spent in on_activate, from the request by the executor until the
+ * action node reports that it has started
+ */
+class ActivationLatencyStatistics
+{
+public:
+  explicit ActivationLatencyStatistics(size_t window_size=100)
+  : window_size_(window_size)
+  {}
+
+  void add_sample(double latency_s, bool success);
+
+  const ActivationLatencySummary& get_summary() const { return summary_; }
+
+private:
+  size_t window_size_;
+  std::deque<double> latencies_s_;
+  ActivationLatencySummary summary_;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <deque>
+#include <cstddef>
+
+
+/**
+ * @brief Summary of the ticks of an action node, for the latest activation and the reaction
+ * latencies over a sliding window
+ */
+struct ActionTickSummary
+{
+  int num_activations{ 0 };
+
+  // Latest activation
+  int num_ticks{ 0 };
+  int num_event_ticks{ 0 };         // Ticks woken by telemetry instead of the timer
+  int num_events{ 0 };
+  double active_duration_s{ 0.0 };
+  double active_cpu_usage{ 0.0 };   // [%] Of a single core, for the whole process
+  double idle_cpu_usage{ 0.0 };     // [%] Between the previous activation and the latest
+
+  // Time from a telemetry event until a tick handles it
+  double mean_reaction_s{ 0.0 };
+  double p50_reaction_s{ 0.0 };
+  double p95_reaction_s{ 0.0 };
+  double max_reaction_s{ 0.0 };
+};
+
+
+/**
+ * @brief Records the ticks of an action node while it is active and the CPU time of the process
+ * while it is active and idle, such that a fixed tick period can be compared to ticks woken by
+ * telemetry
+ *
+ * An event is handled by the first tick after it. Events arriving before that tick are assumed
+ * to be handled by the same tick, such that only the oldest waiting event gives a latency
+ */
+class ActionTickStatistics
+{
+public:
+  explicit ActionTickStatistics(size_t window_size=200)
+  : window_size_(window_size)
+  , is_active_(false)
+  , has_pending_event_(false)
+  , pending_event_s_(0.0)
+  , activation_start_s_(0.0)
+  , activation_start_cpu_s_(0.0)
+  , idle_start_s_(-1.0)
+  , idle_start_cpu_s_(0.0)
+  {}
+
+  /**
+   * @param cpu_time_s [s] CPU time of the process, for example from get_process_cpu_time_s()
+   */
+  void begin_activation(double time_s, double cpu_time_s);
+  void end_activation(double time_s, double cpu_time_s);
+
+  /**
+   * @brief Telemetry which may change the outcome of the next tick. Ignored while inactive
+   */
+  void add_event(double time_s);
+  void add_tick(double time_s, bool is_event_tick);
+
+  bool is_active() const { return is_active_; }
+  const ActionTickSummary& get_summary() const { return summary_; }
+
+  /**
+   * @brief [s] CPU time used by all threads of this process
+   */
+  static double get_process_cpu_time_s();
+
+private:
+  size_t window_size_;
+  std::deque<double> reaction_latencies_s_;
+  ActionTickSummary summary_;
+
+  bool is_active_;
+  bool has_pending_event_;
+  double pending_event_s_;
+
+  double activation_start_s_;
+  double activation_start_cpu_s_;
+  double idle_start_s_;               // Negative before the first activation ended
+  double idle_start_cpu_s_;
+
+  void update_reaction_summary_();
+};
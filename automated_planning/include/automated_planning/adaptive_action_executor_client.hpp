@@ -0,0 +1,215 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp_lifecycle/lifecycle_publisher.hpp"
+#include "rclcpp_lifecycle/node_interfaces/lifecycle_node_interface.hpp"
+
+#include "plansys2_executor/ActionExecutorClient.hpp"
+
+#include "anafi_uav_interfaces/msg/action_tick_statistics.hpp"
+
+#include "automated_planning/action_tick_statistics.hpp"
+
+using namespace std::chrono_literals;
+using LifecycleNodeInterface = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface;
+
+
+/**
+ * @brief Base of the action nodes, which calls do_work() at tick.active_rate while the node is
+ * active instead of at a fixed period, and immediately when the node is woken by telemetry. The
+ * node does not tick while inactive
+ *
+ * The ticks and the CPU usage are published on /action_tick_statistics after every activation.
+ * Setting tick.adaptive to false ticks at the fixed period given to the constructor, as a plain
+ * ActionExecutorClient, for comparison
+ *
+ * Usage:
+ *  - Call wake_() from the callbacks of the telemetry do_work() reacts to
+ *  - Call the lifecycle-events of this class instead of those of ActionExecutorClient
+ *  - Measure durations in do_work() with get_tick_interval_s_() instead of counting ticks
+ *
+ * The ticks and the tick intervals follow the node clock, which is simulated with use_sim_time,
+ * while the rate of the event ticks and the statistics are measured in wall time
+ */
+class AdaptiveActionExecutorClient : public plansys2::ActionExecutorClient
+{
+public:
+  /**
+   * @param fixed_period Period of do_work() if tick.adaptive is false
+   * @param is_polled False for nodes which only act in callbacks, such that do_work() is only
+   * called when woken
+   */
+  AdaptiveActionExecutorClient(const std::string& node_name, std::chrono::nanoseconds fixed_period, bool is_polled=true)
+  : plansys2::ActionExecutorClient(node_name, fixed_period)
+  , fixed_period_(fixed_period)
+  , is_polled_(is_polled)
+  , last_tick_time_(std::chrono::steady_clock::now())
+  , tick_interval_s_(0.0)
+  {
+    std::string tick_prefix = "tick.";
+    this->declare_parameter(tick_prefix + "adaptive", true);
+    this->declare_parameter(tick_prefix + "active_rate", 20.0);
+    this->declare_parameter(tick_prefix + "max_event_rate", 50.0);
+
+    is_adaptive_ = this->get_parameter(tick_prefix + "adaptive").as_bool();
+    active_period_ = to_period_(this->get_parameter(tick_prefix + "active_rate").as_double());
+    min_event_period_ = to_period_(this->get_parameter(tick_prefix + "max_event_rate").as_double());
+
+    tick_statistics_pub_ = this->create_publisher<anafi_uav_interfaces::msg::ActionTickStatistics>(
+      "/action_tick_statistics", rclcpp::QoS(10).reliable());
+  }
+
+  // Lifecycle-events
+  LifecycleNodeInterface::CallbackReturn on_configure(const rclcpp_lifecycle::State & previous_state)
+  {
+    tick_statistics_pub_->on_activate();
+    return ActionExecutorClient::on_configure(previous_state);
+  }
+
+  LifecycleNodeInterface::CallbackReturn on_activate(const rclcpp_lifecycle::State & previous_state)
+  {
+    LifecycleNodeInterface::CallbackReturn result = ActionExecutorClient::on_activate(previous_state);
+    if(result != LifecycleNodeInterface::CallbackReturn::SUCCESS)
+    {
+      return result;
+    }
+
+    last_tick_time_ = std::chrono::steady_clock::now();
+    last_tick_node_time_ = this->get_clock()->now();
+    tick_interval_s_ = 0.0;
+    tick_statistics_.begin_activation(get_time_s_(), ActionTickStatistics::get_process_cpu_time_s());
+
+    // Replaces the timer created by ActionExecutorClient, which is destroyed on deactivation
+    if(! is_adaptive_)
+    {
+      timer_ = rclcpp::create_timer(this, this->get_clock(), rclcpp::Duration(fixed_period_), [this](){ tick_(false); });
+    }
+    else if(is_polled_)
+    {
+      timer_ = rclcpp::create_timer(this, this->get_clock(), rclcpp::Duration(active_period_), [this](){ tick_(false); });
+    }
+    else
+    {
+      timer_ = nullptr;
+    }
+    return result;
+  }
+
+  LifecycleNodeInterface::CallbackReturn on_deactivate(const rclcpp_lifecycle::State & previous_state)
+  {
+    if(tick_statistics_.is_active())
+    {
+      tick_statistics_.end_activation(get_time_s_(), ActionTickStatistics::get_process_cpu_time_s());
+      publish_tick_statistics_();
+    }
+    return ActionExecutorClient::on_deactivate(previous_state);
+  }
+
+  const ActionTickSummary& get_tick_summary() const { return tick_statistics_.get_summary(); }
+
+protected:
+  /**
+   * @brief Calls do_work() now if the node is active, unless it ticked less than
+   * 1 / tick.max_event_rate ago. The next periodic tick then handles the telemetry instead
+   */
+  void wake_()
+  {
+    if(! tick_statistics_.is_active())
+    {
+      return;
+    }
+    tick_statistics_.add_event(get_time_s_());
+    if(! is_adaptive_ || std::chrono::steady_clock::now() - last_tick_time_ < min_event_period_)
+    {
+      return;
+    }
+
+    tick_(true);
+
+    // The periodic tick is postponed, as the telemetry was just handled. do_work() may have
+    // finished the action, which destroys the timer
+    if(timer_)
+    {
+      timer_->reset();
+    }
+  }
+
+  /**
+   * @brief [s] Node time since the previous tick, or since the activation for the first tick. 
+   * Durations measured by counting ticks depend on the tick rate
+   */
+  double get_tick_interval_s_() const { return tick_interval_s_; }
+
+private:
+  std::chrono::nanoseconds fixed_period_;
+  std::chrono::nanoseconds active_period_;
+  std::chrono::nanoseconds min_event_period_;
+  bool is_adaptive_;
+  bool is_polled_;
+
+  std::chrono::steady_clock::time_point last_tick_time_;
+  rclcpp::Time last_tick_node_time_;
+  double tick_interval_s_;
+  ActionTickStatistics tick_statistics_;
+
+  rclcpp_lifecycle::LifecyclePublisher<anafi_uav_interfaces::msg::ActionTickStatistics>::SharedPtr tick_statistics_pub_;
+
+
+  void tick_(bool is_event_tick)
+  {
+    last_tick_time_ = std::chrono::steady_clock::now();
+    const rclcpp::Time node_time = this->get_clock()->now();
+    tick_interval_s_ = (node_time - last_tick_node_time_).seconds();
+    last_tick_node_time_ = node_time;
+    tick_statistics_.add_tick(get_time_s_(), is_event_tick);
+
+    do_work();
+  }
+
+
+  void publish_tick_statistics_()
+  {
+    const ActionTickSummary& summary = tick_statistics_.get_summary();
+
+    anafi_uav_interfaces::msg::ActionTickStatistics statistics_msg;
+    statistics_msg.header.stamp = this->get_clock()->now();
+    statistics_msg.action_name = this->get_parameter("action_name").as_string();
+    statistics_msg.adaptive = is_adaptive_;
+    statistics_msg.num_activations = summary.num_activations;
+    statistics_msg.active_duration = summary.active_duration_s;
+    statistics_msg.num_ticks = summary.num_ticks;
+    statistics_msg.num_event_ticks = summary.num_event_ticks;
+    statistics_msg.num_events = summary.num_events;
+    statistics_msg.active_cpu_usage = summary.active_cpu_usage;
+    statistics_msg.idle_cpu_usage = summary.idle_cpu_usage;
+    statistics_msg.mean_reaction_latency = summary.mean_reaction_s;
+    statistics_msg.p50_reaction_latency = summary.p50_reaction_s;
+    statistics_msg.p95_reaction_latency = summary.p95_reaction_s;
+    statistics_msg.max_reaction_latency = summary.max_reaction_s;
+    tick_statistics_pub_->publish(statistics_msg);
+
+    RCLCPP_DEBUG(this->get_logger(), "%d ticks in %f s, using %f %% CPU", summary.num_ticks, summary.active_duration_s, summary.active_cpu_usage);
+  }
+
+
+  static double get_time_s_()
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+
+  /**
+   * @brief The period of @p rate_hz, with non-positive rates treated as 1 mHz
+   */
+  static std::chrono::nanoseconds to_period_(double rate_hz)
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(1.0 / std::max(rate_hz, 1e-3)));
+  }
+
+}; // AdaptiveActionExecutorClient
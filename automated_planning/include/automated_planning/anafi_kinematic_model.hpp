@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+
+#include <Eigen/Dense>
+
+
+enum class AnafiFlyingState { LANDED, MOTOR_RAMPING, TAKINGOFF, HOVERING, FLYING, LANDING, EMERGENCY };
+
+
+struct AnafiKinematicParameters
+{
+  double max_horizontal_speed{ 3.0 };   // [m/s]
+  double max_vertical_speed{ 1.0 };     // [m/s]
+  double max_yaw_rate{ 1.0 };           // [rad/s]
+  double position_gain{ 1.0 };          // [1/s] Proportional gain from position error to desired velocity
+  double velocity_time_constant{ 0.5 }; // [s] First order response of the velocity
+
+  double motor_ramping_duration{ 1.0 }; // [s]
+  double takeoff_altitude{ 1.0 };       // [m]
+  double takeoff_speed{ 0.5 };          // [m/s]
+  double landing_speed{ 0.5 };          // [m/s]
+
+  double hover_position_tolerance{ 0.1 };  // [m] The drone reports hovering when the target is reached within this distance
+  double hover_speed_tolerance{ 0.1 };     // [m/s] and the speed is below this value
+
+  double initial_battery{ 100.0 };              // [%]
+  double battery_usage_hovering{ 0.05 };        // [%/s]
+  double battery_usage_per_speed{ 0.004 };      // [%/m] Added to the hovering usage while moving
+  double battery_forced_landing{ 0.0 };         // [%] The drone lands on its own at this battery level
+};
+
+
+/**
+ * @brief Point-mass model of the Anafi, replicating the flying states and the movement commands
+ * of the Olympe bridge closely enough to run missions without the drone or the Parrot simulator
+ *
+ * The position is in NED relative to the takeoff position. The attitude is only described by the
+ * yaw, as the roll and pitch are not used by the planning
+ */
+class AnafiKinematicModel
+{
+public:
+  explicit AnafiKinematicModel(const AnafiKinematicParameters& params=AnafiKinematicParameters());
+
+  /**
+   * @brief Propagates the model @p dt seconds
+   */
+  void step(double dt);
+
+  // Commands. Ignored in states where the Anafi would ignore them
+  void takeoff();
+  void land();
+
+  /**
+   * @brief Relative movement in the body frame. A zero-move makes the drone hover at the current position
+   */
+  void move_by(double dx, double dy, double dz, double dyaw);
+
+  /**
+   * @brief Movement to a position in NED
+   */
+  void move_to(const Eigen::Vector3d& position_ned);
+
+  /**
+   * @brief Removes @p percentage from the battery, emulating a sudden drop of the charge
+   */
+  void drain_battery(double percentage);
+
+  const Eigen::Vector3d& get_position_ned() const { return position_ned_; }
+  const Eigen::Vector3d& get_velocity_ned() const { return velocity_ned_; }
+  Eigen::Vector3d get_velocity_body() const;
+  double get_yaw() const { return yaw_; }
+  double get_battery() const { return battery_; }
+  AnafiFlyingState get_flying_state() const { return flying_state_; }
+
+  /**
+   * @brief Returns the flying state with the names used by the Olympe bridge, for example "FS_HOVERING"
+   */
+  std::string get_flying_state_string() const;
+
+private:
+  AnafiKinematicParameters params_;
+
+  AnafiFlyingState flying_state_;
+  double state_duration_s_;
+
+  Eigen::Vector3d position_ned_;
+  Eigen::Vector3d velocity_ned_;
+  double yaw_;
+  double battery_;
+
+  Eigen::Vector3d target_position_ned_;
+  double target_yaw_;
+
+  bool is_airborne_() const;
+
+  /**
+   * @brief Velocity towards the target, limited by the horizontal and vertical speed limits
+   */
+  Eigen::Vector3d get_desired_velocity_ned_(const Eigen::Vector3d& target_position_ned) const;
+
+  void set_flying_state_(AnafiFlyingState flying_state);
+};
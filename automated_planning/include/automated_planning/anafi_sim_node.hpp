@@ -0,0 +1,207 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <stdexcept>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/publisher.hpp"
+#include "rclcpp/subscription.hpp"
+#include "rclcpp/qos.hpp"
+
+#include "std_msgs/msg/string.hpp"
+#include "std_msgs/msg/empty.hpp"
+#include "std_msgs/msg/float64.hpp"
+#include "std_srvs/srv/set_bool.hpp"
+#include "geometry_msgs/msg/point_stamped.hpp"
+#include "geometry_msgs/msg/quaternion_stamped.hpp"
+#include "geometry_msgs/msg/twist_stamped.hpp"
+#include "geometry_msgs/msg/pose_with_covariance_stamped.hpp"
+#include "sensor_msgs/msg/nav_sat_fix.hpp"
+#include "rosgraph_msgs/msg/clock.hpp"
+
+#include "anafi_uav_interfaces/msg/move_by_command.hpp"
+#include "anafi_uav_interfaces/msg/move_to_command.hpp"
+#include "anafi_uav_interfaces/msg/float32_stamped.hpp"
+
+#include "automated_planning/anafi_kinematic_model.hpp"
+
+using namespace std::chrono_literals;
+
+
+/**
+ * @brief Stand-in for the Olympe bridge, the velocity controller and the helipad detection,
+ * such that full missions can be run without the drone or the Parrot simulator
+ *
+ * The node drives /clock, running the simulated time at anafi_sim.real_time_factor times the
+ * wall time. All other nodes must therefore be started with use_sim_time, while this node must not
+ */
+class AnafiSimNode : public rclcpp::Node
+{
+public:
+  AnafiSimNode()
+  : rclcpp::Node("anafi_sim_node")
+  , time_since_publish_s_(0.0)
+  , is_velocity_controller_enabled_(false)
+  {
+    // Parameters
+    std::string sim_prefix = "anafi_sim.";
+    AnafiKinematicParameters defaults;
+    this->declare_parameter(sim_prefix + "real_time_factor", 1.0);
+    this->declare_parameter(sim_prefix + "step_size", 0.02);
+    this->declare_parameter(sim_prefix + "publish_rate", 30.0);
+    this->declare_parameter(sim_prefix + "origin", std::vector<double>({ 63.4305, 10.3951 }));
+    this->declare_parameter(sim_prefix + "helipad_detection_radius", 5.0);
+    this->declare_parameter(sim_prefix + "battery_resolution", 1.0);
+    this->declare_parameter(sim_prefix + "max_horizontal_speed", defaults.max_horizontal_speed);
+    this->declare_parameter(sim_prefix + "max_vertical_speed", defaults.max_vertical_speed);
+    this->declare_parameter(sim_prefix + "initial_battery", defaults.initial_battery);
+    this->declare_parameter(sim_prefix + "battery_usage_hovering", defaults.battery_usage_hovering);
+    this->declare_parameter(sim_prefix + "battery_usage_per_speed", defaults.battery_usage_per_speed);
+
+    AnafiKinematicParameters params;
+    params.max_horizontal_speed = this->get_parameter(sim_prefix + "max_horizontal_speed").as_double();
+    params.max_vertical_speed = this->get_parameter(sim_prefix + "max_vertical_speed").as_double();
+    params.initial_battery = this->get_parameter(sim_prefix + "initial_battery").as_double();
+    params.battery_usage_hovering = this->get_parameter(sim_prefix + "battery_usage_hovering").as_double();
+    params.battery_usage_per_speed = this->get_parameter(sim_prefix + "battery_usage_per_speed").as_double();
+    model_ = std::make_unique<AnafiKinematicModel>(params);
+
+    double real_time_factor = this->get_parameter(sim_prefix + "real_time_factor").as_double();
+    step_size_s_ = this->get_parameter(sim_prefix + "step_size").as_double();
+    double publish_rate = this->get_parameter(sim_prefix + "publish_rate").as_double();
+    if(real_time_factor <= 0 || step_size_s_ <= 0 || publish_rate <= 0)
+    {
+      throw std::invalid_argument("anafi_sim.real_time_factor, step_size and publish_rate must be positive");
+    }
+    publish_period_s_ = 1.0 / publish_rate;
+
+    std::vector<double> origin = this->get_parameter(sim_prefix + "origin").as_double_array();
+    if(origin.size() != 2)
+    {
+      throw std::invalid_argument("anafi_sim.origin must be [latitude, longitude]");
+    }
+    origin_latitude_deg_ = origin[0];
+    origin_longitude_deg_ = origin[1];
+    helipad_detection_radius_ = this->get_parameter(sim_prefix + "helipad_detection_radius").as_double();
+    battery_resolution_ = this->get_parameter(sim_prefix + "battery_resolution").as_double();
+
+    // The simulated time starts at the wall time, such that stamps are never zero
+    sim_time_ = rclcpp::Time(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count(), RCL_ROS_TIME);
+
+    // Publishers
+    clock_pub_ = this->create_publisher<rosgraph_msgs::msg::Clock>("/clock", rclcpp::QoS(10).reliable());
+    state_pub_ = this->create_publisher<std_msgs::msg::String>("/anafi/state", rclcpp::QoS(1).reliable());
+    ned_pos_pub_ = this->create_publisher<geometry_msgs::msg::PointStamped>("/anafi/ned_pos_from_gnss", rclcpp::QoS(1).reliable());
+    gnss_pub_ = this->create_publisher<sensor_msgs::msg::NavSatFix>("/anafi/gnss_location", rclcpp::QoS(1).reliable());
+    attitude_pub_ = this->create_publisher<geometry_msgs::msg::QuaternionStamped>("/anafi/attitude", rclcpp::QoS(1).reliable());
+    polled_vel_pub_ = this->create_publisher<geometry_msgs::msg::TwistStamped>("/anafi/polled_body_velocities", rclcpp::QoS(1).reliable());
+    battery_pub_ = this->create_publisher<std_msgs::msg::Float64>("/anafi/battery", rclcpp::QoS(1).reliable());
+    ekf_pub_ = this->create_publisher<geometry_msgs::msg::PoseWithCovarianceStamped>("/estimate/ekf", rclcpp::QoS(1).reliable());
+    apriltags_detected_pub_ = this->create_publisher<anafi_uav_interfaces::msg::Float32Stamped>(
+      "/estimate/aprilTags/num_tags_detected", rclcpp::QoS(1).reliable());
+
+    // Subscribers
+    using namespace std::placeholders;
+    cmd_takeoff_sub_ = this->create_subscription<std_msgs::msg::Empty>(
+      "/anafi/cmd_takeoff", rclcpp::QoS(1).reliable(), std::bind(&AnafiSimNode::cmd_takeoff_cb_, this, _1));
+    cmd_land_sub_ = this->create_subscription<std_msgs::msg::Empty>(
+      "/anafi/cmd_land", rclcpp::QoS(1).reliable(), std::bind(&AnafiSimNode::cmd_land_cb_, this, _1));
+    cmd_moveby_sub_ = this->create_subscription<anafi_uav_interfaces::msg::MoveByCommand>(
+      "/anafi/cmd_moveby", rclcpp::QoS(1).reliable(), std::bind(&AnafiSimNode::cmd_moveby_cb_, this, _1));
+    cmd_moveto_sub_ = this->create_subscription<anafi_uav_interfaces::msg::MoveToCommand>(
+      "/anafi/cmd_moveto", rclcpp::QoS(1).reliable(), std::bind(&AnafiSimNode::cmd_moveto_cb_, this, _1));
+    desired_ned_position_sub_ = this->create_subscription<geometry_msgs::msg::PointStamped>(
+      "/guidance/desired_ned_position", rclcpp::QoS(1).reliable(), std::bind(&AnafiSimNode::desired_ned_position_cb_, this, _1));
+    battery_drop_sub_ = this->create_subscription<std_msgs::msg::Float64>(
+      "/anafi_sim/battery_drop", rclcpp::QoS(1).reliable(), std::bind(&AnafiSimNode::battery_drop_cb_, this, _1));
+
+    // Services
+    enable_velocity_control_srv_ = this->create_service<std_srvs::srv::SetBool>(
+      "/velocity_controller/service/enable_controller", std::bind(&AnafiSimNode::enable_velocity_control_srv_cb_, this, _1, _2));
+
+    // Timers
+    step_timer_ = this->create_wall_timer(
+      std::chrono::duration<double>(step_size_s_ / real_time_factor), std::bind(&AnafiSimNode::step_timer_cb_, this));
+
+    RCLCPP_INFO(this->get_logger(), "Simulating the Anafi at %.1f times real time", real_time_factor);
+  }
+
+private:
+  std::unique_ptr<AnafiKinematicModel> model_;
+
+  // State
+  rclcpp::Time sim_time_;
+  double step_size_s_;
+  double publish_period_s_;
+  double time_since_publish_s_;
+  bool is_velocity_controller_enabled_;
+  std::string last_flying_state_;
+
+  double origin_latitude_deg_;
+  double origin_longitude_deg_;
+  double helipad_detection_radius_;
+  double battery_resolution_;
+
+  // Publishers
+  rclcpp::Publisher<rosgraph_msgs::msg::Clock>::SharedPtr clock_pub_;
+  rclcpp::Publisher<std_msgs::msg::String>::SharedPtr state_pub_;
+  rclcpp::Publisher<geometry_msgs::msg::PointStamped>::SharedPtr ned_pos_pub_;
+  rclcpp::Publisher<sensor_msgs::msg::NavSatFix>::SharedPtr gnss_pub_;
+  rclcpp::Publisher<geometry_msgs::msg::QuaternionStamped>::SharedPtr attitude_pub_;
+  rclcpp::Publisher<geometry_msgs::msg::TwistStamped>::SharedPtr polled_vel_pub_;
+  rclcpp::Publisher<std_msgs::msg::Float64>::SharedPtr battery_pub_;
+  rclcpp::Publisher<geometry_msgs::msg::PoseWithCovarianceStamped>::SharedPtr ekf_pub_;
+  rclcpp::Publisher<anafi_uav_interfaces::msg::Float32Stamped>::SharedPtr apriltags_detected_pub_;
+
+  // Subscribers
+  rclcpp::Subscription<std_msgs::msg::Empty>::ConstSharedPtr cmd_takeoff_sub_;
+  rclcpp::Subscription<std_msgs::msg::Empty>::ConstSharedPtr cmd_land_sub_;
+  rclcpp::Subscription<anafi_uav_interfaces::msg::MoveByCommand>::ConstSharedPtr cmd_moveby_sub_;
+  rclcpp::Subscription<anafi_uav_interfaces::msg::MoveToCommand>::ConstSharedPtr cmd_moveto_sub_;
+  rclcpp::Subscription<geometry_msgs::msg::PointStamped>::ConstSharedPtr desired_ned_position_sub_;
+  rclcpp::Subscription<std_msgs::msg::Float64>::ConstSharedPtr battery_drop_sub_;
+
+  // Services
+  rclcpp::Service<std_srvs::srv::SetBool>::SharedPtr enable_velocity_control_srv_;
+
+  // Timers
+  rclcpp::TimerBase::SharedPtr step_timer_;
+
+
+  /**
+   * @brief Advances the simulated time by one step, publishes /clock and publishes the
+   * measurements at the publish rate in simulated time
+   */
+  void step_timer_cb_();
+
+  void publish_measurements_();
+
+  /**
+   * @brief Flat-earth conversion between NED relative to the origin and geodetic coordinates.
+   * Sufficient for the distances of a mission
+   */
+  void ned_to_geodetic_(double north, double east, double& latitude_deg, double& longitude_deg) const;
+  void geodetic_to_ned_(double latitude_deg, double longitude_deg, double& north, double& east) const;
+
+
+  // Callbacks
+  void cmd_takeoff_cb_(std_msgs::msg::Empty::ConstSharedPtr);
+  void cmd_land_cb_(std_msgs::msg::Empty::ConstSharedPtr);
+  void cmd_moveby_cb_(anafi_uav_interfaces::msg::MoveByCommand::ConstSharedPtr moveby_msg);
+  void cmd_moveto_cb_(anafi_uav_interfaces::msg::MoveToCommand::ConstSharedPtr moveto_msg);
+  void desired_ned_position_cb_(geometry_msgs::msg::PointStamped::ConstSharedPtr desired_position_msg);
+
+  /**
+   * @brief Injected battery drops in percent, used for testing the battery replanning
+   */
+  void battery_drop_cb_(std_msgs::msg::Float64::ConstSharedPtr battery_drop_msg);
+
+  void enable_velocity_control_srv_cb_(
+    const std::shared_ptr<std_srvs::srv::SetBool::Request> request,
+    std::shared_ptr<std_srvs::srv::SetBool::Response> response);
+
+}; // AnafiSimNode
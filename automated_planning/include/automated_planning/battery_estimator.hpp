@@ -0,0 +1,93 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+
+/**
+ * @brief Estimate of the discharge rate [%/s] while executing a single action type
+ */
+struct DischargeRateEstimate
+{
+  double rate{ 0.0 };
+  double variance{ 1e-3 };
+  int num_observations{ 0 };
+};
+
+
+/**
+ * @brief Online estimator of the battery discharge rate for each action type
+ *
+ * The battery charge reported by the Anafi is quantized to whole percentages, such that the
+ * rate cannot be estimated from consecutive samples. Instead, the samples are grouped into
+ * segments where the same action type is executed. When a segment is closed, the average
+ * discharge rate over the segment is used as an observation in a scalar recursive least
+ * squares estimator with exponential forgetting
+ */
+class BatteryDischargeEstimator
+{
+public:
+  /**
+   * @param default_rate          [%/s] Prior discharge rate for action types without a specific prior
+   * @param forgetting_factor     Forgetting factor in (0, 1]. Lower values adapt faster
+   * @param min_segment_duration  [s] Segments shorter than this are discarded, due to the quantization
+   * @param max_segment_duration  [s] Segments are closed after this duration, even if the action continues
+   */
+  BatteryDischargeEstimator(
+    double default_rate,
+    double forgetting_factor=0.98,
+    double min_segment_duration=10.0,
+    double max_segment_duration=30.0
+  );
+
+
+  /**
+   * @brief Sets the prior discharge rate for the action type @p action_type
+   */
+  void set_prior(const std::string& action_type, double rate);
+
+
+  /**
+   * @brief Adds a battery sample while executing @p action_type. An empty action type
+   * indicates that no action is executing, and the sample is only used to restart the segment
+   *
+   * @return True if a segment was closed and used for updating the estimate
+   */
+  bool add_sample(double time_s, double battery_charge, const std::string& action_type);
+
+
+  /**
+   * @brief Estimated discharge rate [%/s] for @p action_type. If @p conservative is set,
+   * two standard deviations are added to the estimate
+   */
+  double get_rate(const std::string& action_type, bool conservative=false) const;
+
+  int get_num_observations(const std::string& action_type) const;
+
+
+  /**
+   * @brief Human-readable summary of the current estimates
+   */
+  std::string to_string() const;
+
+private:
+  double default_rate_;
+  double forgetting_factor_;
+  double min_segment_duration_;
+  double max_segment_duration_;
+
+  // Variance of a single observation. The quantization of 1 % over a segment of
+  // min_segment_duration_ dominates the noise
+  double observation_variance_;
+
+  std::map<std::string, DischargeRateEstimate> estimates_;
+
+  // Current segment
+  bool segment_active_{ false };
+  std::string segment_action_type_;
+  double segment_start_time_s_{ 0.0 };
+  double segment_start_charge_{ 0.0 };
+
+  void start_segment_(double time_s, double battery_charge, const std::string& action_type);
+  bool close_segment_(double time_s, double battery_charge);
+};
@@ -0,0 +1,643 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "automated_planning/execution_feedback_aggregator.hpp"
+#include "automated_planning/numeric_program.hpp"
+#include "automated_planning/pddl_domain.hpp"
+
+
+/**
+ * @brief A PDDL-domain compiled into state-transition code for fast validation and simulation of
+ * plans, without the planner or the PlanSys2 experts
+ *
+ * Each plan item is grounded once, and its conditions and effects are compiled into bitset masks
+ * over the ground predicates and postfix programs over the ground functions. The start and end
+ * events of a compiled plan are ordered once, such that validating the plan from an initial state
+ * only consists of mask operations and evaluation of the numeric programs. The schemas are compiled
+ * from the parsed domain, and thereby follow both sar.pddl and sar_testing.pddl
+ *
+ * Only the facts and functions used by the compiled plans and goals are indexed, which keeps the
+ * state small even for large maps. The capacities are fixed at compile time. States must be made
+ * after the plans and goals they are used with are compiled, as facts indexed later are otherwise
+ * missing from the state
+ *
+ * @tparam MaxFacts       Maximum number of ground predicates used by the compiled plans
+ * @tparam MaxFunctions   Maximum number of ground functions used by the compiled plans
+ */
+template<size_t MaxFacts, size_t MaxFunctions>
+class CompiledDomainModel
+{
+public:
+  using FactSet = std::bitset<MaxFacts>;
+  using FunctionSet = std::bitset<MaxFunctions>;
+
+  struct State
+  {
+    FactSet facts;
+    FunctionSet is_defined;
+    std::array<double, MaxFunctions> values{};
+    size_t num_facts{ 0 };              // Indexed facts and functions when the state was made
+    size_t num_functions{ 0 };
+  };
+
+  enum class Failure : uint8_t
+  {
+    NONE,
+    START_CONDITION,
+    OVER_ALL_CONDITION,
+    END_CONDITION,
+    DURATION,
+    UNDEFINED_FUNCTION,
+    STALE_STATE                         // The state was made before the plan was compiled
+  };
+
+  struct ValidationResult
+  {
+    bool is_valid{ true };
+    Failure failure{ Failure::NONE };
+    size_t item_idx{ 0 };               // Plan item which failed
+    double time_s{ 0.0 };               // [s] Time of the failing event
+    double makespan_s{ 0.0 };           // [s]
+    State final_state;                  // After the last event, or where the failure was found
+  };
+
+  struct CompiledPlan
+  {
+    struct Event
+    {
+      double time_s;
+      uint32_t item_idx;
+      bool is_end;
+    };
+
+    std::vector<size_t> actions;        // Ground action of each plan item
+    std::vector<double> durations_s;    // Planned duration of each plan item
+    std::vector<Event> events;          // Ordered by time, with ends before starts at the same time
+    double makespan_s{ 0.0 };
+  };
+
+  struct CompiledGoal
+  {
+    FactSet positive;
+    FactSet negative;
+    std::vector<PddlCondition> comparisons;
+    std::vector<std::pair<NumericProgram, NumericProgram>> programs;
+  };
+
+  explicit CompiledDomainModel(std::shared_ptr<const PddlDomain> domain)
+  : domain_(domain)
+  {}
+
+  /**
+   * @brief Grounds and compiles the plan items. Throws std::runtime_error if an action is not in
+   * the domain, or the capacities are exceeded
+   */
+  CompiledPlan compile_plan(const std::vector<PlannedAction>& plan)
+  {
+    CompiledPlan compiled_plan;
+    for(size_t i = 0; i < plan.size(); i++)
+    {
+      compiled_plan.actions.push_back(get_ground_action_(plan[i].action));
+      compiled_plan.durations_s.push_back(plan[i].duration_s);
+      compiled_plan.events.push_back({ plan[i].start_s, static_cast<uint32_t>(i), false });
+      compiled_plan.events.push_back({ plan[i].start_s + plan[i].duration_s, static_cast<uint32_t>(i), true });
+      compiled_plan.makespan_s = std::max(compiled_plan.makespan_s, plan[i].start_s + plan[i].duration_s);
+    }
+    std::stable_sort(compiled_plan.events.begin(), compiled_plan.events.end(),
+      [](const typename CompiledPlan::Event& a, const typename CompiledPlan::Event& b)
+      {
+        return (a.time_s < b.time_s) || (a.time_s == b.time_s && a.is_end && ! b.is_end);
+      });
+    return compiled_plan;
+  }
+
+  /**
+   * @brief Compiles a conjunctive goal, as given by PddlProblem::goals
+   */
+  CompiledGoal compile_goal(const std::vector<PddlCondition>& goals)
+  {
+    CompiledGoal compiled_goal;
+    for(const PddlCondition& goal : goals)
+    {
+      if(goal.type == PddlCondition::Type::PREDICATE)
+      {
+        compiled_goal.positive.set(get_fact_(goal.predicate));
+      }
+      else if(goal.type == PddlCondition::Type::NEGATED_PREDICATE)
+      {
+        compiled_goal.negative.set(get_fact_(goal.predicate));
+      }
+      else
+      {
+        compiled_goal.comparisons.push_back(goal);
+        compiled_goal.programs.emplace_back(compile_program_(goal.lhs), compile_program_(goal.rhs));
+      }
+    }
+    return compiled_goal;
+  }
+
+  /**
+   * @brief The state with the given true predicates and function values, for example from
+   * PddlProblem. Predicates and functions which are not used by the compiled plans are ignored
+   */
+  State make_state(const std::vector<PddlAtom>& predicates, const std::vector<std::pair<PddlAtom, double>>& functions) const
+  {
+    State state;
+    state.num_facts = fact_names_.size();
+    state.num_functions = function_names_.size();
+    for(const PddlAtom& predicate : predicates)
+    {
+      typename std::unordered_map<std::string, size_t>::const_iterator it = fact_indices_.find(predicate.to_string());
+      if(it != fact_indices_.end())
+      {
+        state.facts.set(it->second);
+      }
+    }
+    for(const std::pair<PddlAtom, double>& function : functions)
+    {
+      typename std::unordered_map<std::string, size_t>::const_iterator it = function_indices_.find(function.first.to_string());
+      if(it != function_indices_.end())
+      {
+        state.is_defined.set(it->second);
+        state.values[it->second] = function.second;
+      }
+    }
+    return state;
+  }
+
+  /**
+   * @brief Validates the plan from @p initial_state, with the start and end events applied in
+   * time order. The start, over all and end conditions are checked as in VAL, except that the
+   * over all-conditions are checked at the start and end events only
+   *
+   * @param duration_tolerance_s  [s] Maximum difference between the planned duration and the
+   *                              duration given by the domain. Not checked if negative
+   */
+  ValidationResult validate(const CompiledPlan& plan, const State& initial_state, double duration_tolerance_s=-1.0) const
+  {
+    ValidationResult result;
+    result.makespan_s = plan.makespan_s;
+    result.final_state = initial_state;
+    State& state = result.final_state;
+    if(initial_state.num_facts < fact_names_.size() || initial_state.num_functions < function_names_.size())
+    {
+      fail_(result, Failure::STALE_STATE, 0, 0.0);
+      return result;
+    }
+
+    std::array<uint32_t, MAX_ACTIVE_ACTIONS> active_items;
+    size_t num_active = 0;
+    for(const typename CompiledPlan::Event& event : plan.events)
+    {
+      const GroundAction& action = ground_actions_[plan.actions[event.item_idx]];
+      const double duration_s = plan.durations_s[event.item_idx];
+
+      if(! event.is_end)
+      {
+        if(duration_tolerance_s >= 0)
+        {
+          double expected_duration_s;
+          if(! evaluate_(action.duration, state, 0.0, expected_duration_s))
+          {
+            fail_(result, Failure::UNDEFINED_FUNCTION, event.item_idx, event.time_s);
+            return result;
+          }
+          if(std::abs(expected_duration_s - duration_s) > duration_tolerance_s)
+          {
+            fail_(result, Failure::DURATION, event.item_idx, event.time_s);
+            return result;
+          }
+        }
+        Failure failure = check_snap_(action.start, state, duration_s, Failure::START_CONDITION);
+        if(failure == Failure::NONE && ! apply_snap_(action.start, state, duration_s))
+        {
+          failure = Failure::UNDEFINED_FUNCTION;
+        }
+        if(failure != Failure::NONE)
+        {
+          fail_(result, failure, event.item_idx, event.time_s);
+          return result;
+        }
+        if(num_active == MAX_ACTIVE_ACTIONS)
+        {
+          throw std::runtime_error("More than " + std::to_string(MAX_ACTIVE_ACTIONS) + " concurrent actions in the plan");
+        }
+        active_items[num_active++] = event.item_idx;
+      }
+      else
+      {
+        for(size_t i = 0; i < num_active; i++)
+        {
+          if(active_items[i] == event.item_idx)
+          {
+            active_items[i] = active_items[--num_active];
+            break;
+          }
+        }
+        Failure failure = check_snap_(action.end, state, duration_s, Failure::END_CONDITION);
+        if(failure == Failure::NONE && ! apply_snap_(action.end, state, duration_s))
+        {
+          failure = Failure::UNDEFINED_FUNCTION;
+        }
+        if(failure != Failure::NONE)
+        {
+          fail_(result, failure, event.item_idx, event.time_s);
+          return result;
+        }
+      }
+
+      for(size_t i = 0; i < num_active; i++)
+      {
+        const GroundAction& active_action = ground_actions_[plan.actions[active_items[i]]];
+        Failure failure = check_snap_(active_action.over_all, state, plan.durations_s[active_items[i]], Failure::OVER_ALL_CONDITION);
+        if(failure != Failure::NONE)
+        {
+          fail_(result, failure, active_items[i], event.time_s);
+          return result;
+        }
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief Applies the effects of the plan without checking any conditions. Functions which are
+   * undefined, or changed from an undefined value, remain undefined
+   */
+  State simulate(const CompiledPlan& plan, const State& initial_state) const
+  {
+    State state = initial_state;
+    for(const typename CompiledPlan::Event& event : plan.events)
+    {
+      const GroundAction& action = ground_actions_[plan.actions[event.item_idx]];
+      apply_snap_(event.is_end ? action.end : action.start, state, plan.durations_s[event.item_idx]);
+    }
+    return state;
+  }
+
+  bool is_satisfied(const CompiledGoal& goal, const State& state) const
+  {
+    if((goal.positive & ~state.facts).any() || (goal.negative & state.facts).any())
+    {
+      return false;
+    }
+    for(size_t i = 0; i < goal.comparisons.size(); i++)
+    {
+      if(! compare_(goal.comparisons[i].comparator, goal.programs[i].first, goal.programs[i].second, state, 0.0))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Explains why the plan is invalid, naming the first condition which does not hold
+   */
+  std::string describe(const ValidationResult& result, const CompiledPlan& plan) const
+  {
+    if(result.is_valid)
+    {
+      return "Valid plan with makespan " + std::to_string(result.makespan_s) + " s";
+    }
+    if(result.failure == Failure::STALE_STATE)
+    {
+      return "The state was made before the plan was compiled";
+    }
+
+    const GroundAction& action = ground_actions_[plan.actions[result.item_idx]];
+    const State& state = result.final_state;
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "Plan item " << result.item_idx << " " << action.action << " at " << result.time_s << " s: ";
+
+    const Snap* snap = nullptr;
+    switch(result.failure)
+    {
+      case Failure::START_CONDITION:
+        ss << "at start ";
+        snap = &action.start;
+        break;
+      case Failure::OVER_ALL_CONDITION:
+        ss << "over all ";
+        snap = &action.over_all;
+        break;
+      case Failure::END_CONDITION:
+        ss << "at end ";
+        snap = &action.end;
+        break;
+      case Failure::DURATION:
+        ss << "the planned duration " << plan.durations_s[result.item_idx] << " s differs from the domain";
+        return ss.str();
+      default:
+        ss << "undefined function in a condition or effect";
+        return ss.str();
+    }
+
+    for(size_t i = 0; i < fact_names_.size(); i++)
+    {
+      if(snap->positive[i] && ! state.facts[i])
+      {
+        ss << fact_names_[i] << " does not hold";
+        return ss.str();
+      }
+      if(snap->negative[i] && state.facts[i])
+      {
+        ss << "(not " << fact_names_[i] << ") does not hold";
+        return ss.str();
+      }
+    }
+    for(const Comparison& comparison : snap->comparisons)
+    {
+      if(! compare_(comparison.comparator, comparison.lhs, comparison.rhs, state, plan.durations_s[result.item_idx]))
+      {
+        ss << comparison.description << " does not hold";
+        return ss.str();
+      }
+    }
+    ss << "condition does not hold";
+    return ss.str();
+  }
+
+  const std::string& get_action(size_t ground_action) const { return ground_actions_[ground_action].action; }
+  size_t get_num_ground_actions() const { return ground_actions_.size(); }
+  size_t get_num_facts() const { return fact_names_.size(); }
+  size_t get_num_functions() const { return function_names_.size(); }
+
+  /**
+   * @brief The value of the function @p function, on the form (name args), or std::nullopt if it
+   * is undefined or not used by the compiled plans
+   */
+  std::optional<double> get_function(const State& state, const std::string& function) const
+  {
+    typename std::unordered_map<std::string, size_t>::const_iterator it = function_indices_.find(function);
+    if(it == function_indices_.end() || ! state.is_defined[it->second])
+    {
+      return std::nullopt;
+    }
+    return state.values[it->second];
+  }
+
+  bool holds(const State& state, const std::string& predicate) const
+  {
+    typename std::unordered_map<std::string, size_t>::const_iterator it = fact_indices_.find(predicate);
+    return it != fact_indices_.end() && state.facts[it->second];
+  }
+
+private:
+  static constexpr size_t MAX_ACTIVE_ACTIONS = 32;
+  static constexpr size_t MAX_NUMERIC_EFFECTS = 8;
+
+  struct Comparison
+  {
+    Comparator comparator;
+    NumericProgram lhs;
+    NumericProgram rhs;
+    std::string description;
+  };
+
+  struct NumericEffect
+  {
+    PddlEffect::Type type;
+    uint32_t slot;
+    NumericProgram value;
+  };
+
+  // Conditions and effects at one point of the action. The over all-part has no effects
+  struct Snap
+  {
+    FactSet positive;
+    FactSet negative;
+    std::vector<Comparison> comparisons;
+    FactSet add;
+    FactSet del;
+    std::vector<NumericEffect> numeric_effects;
+  };
+
+  struct GroundAction
+  {
+    std::string action;
+    NumericProgram duration;
+    Snap start;
+    Snap over_all;
+    Snap end;
+  };
+
+  std::shared_ptr<const PddlDomain> domain_;
+
+  std::vector<GroundAction> ground_actions_;
+  std::unordered_map<std::string, size_t> ground_action_indices_;
+
+  std::vector<std::string> fact_names_;
+  std::unordered_map<std::string, size_t> fact_indices_;
+  std::vector<std::string> function_names_;
+  std::unordered_map<std::string, size_t> function_indices_;
+
+  size_t get_fact_(const PddlAtom& predicate)
+  {
+    const std::string key = predicate.to_string();
+    typename std::unordered_map<std::string, size_t>::const_iterator it = fact_indices_.find(key);
+    if(it != fact_indices_.end())
+    {
+      return it->second;
+    }
+    if(fact_names_.size() == MaxFacts)
+    {
+      throw std::runtime_error("More than " + std::to_string(MaxFacts) + " facts used by the compiled plans");
+    }
+    fact_indices_.emplace(key, fact_names_.size());
+    fact_names_.push_back(key);
+    return fact_names_.size() - 1;
+  }
+
+  size_t get_function_(const PddlAtom& function)
+  {
+    const std::string key = function.to_string();
+    typename std::unordered_map<std::string, size_t>::const_iterator it = function_indices_.find(key);
+    if(it != function_indices_.end())
+    {
+      return it->second;
+    }
+    if(function_names_.size() == MaxFunctions)
+    {
+      throw std::runtime_error("More than " + std::to_string(MaxFunctions) + " functions used by the compiled plans");
+    }
+    function_indices_.emplace(key, function_names_.size());
+    function_names_.push_back(key);
+    return function_names_.size() - 1;
+  }
+
+  size_t get_ground_action_(const std::string& action_str)
+  {
+    typename std::unordered_map<std::string, size_t>::const_iterator it = ground_action_indices_.find(action_str);
+    if(it != ground_action_indices_.end())
+    {
+      return it->second;
+    }
+
+    std::optional<DurativeAction> action = domain_->ground(action_str);
+    if(! action)
+    {
+      throw std::runtime_error("The action " + action_str + " is not in the domain " + domain_->get_name());
+    }
+
+    GroundAction ground_action;
+    ground_action.action = action->to_string();
+    ground_action.duration = compile_program_(action->duration);
+    compile_conditions_(action->at_start_conditions, ground_action.start);
+    compile_conditions_(action->over_all_conditions, ground_action.over_all);
+    compile_conditions_(action->at_end_conditions, ground_action.end);
+    compile_effects_(action->at_start_effects, ground_action.start);
+    compile_effects_(action->at_end_effects, ground_action.end);
+
+    ground_actions_.push_back(std::move(ground_action));
+    ground_action_indices_.emplace(action_str, ground_actions_.size() - 1);
+    return ground_actions_.size() - 1;
+  }
+
+  void compile_conditions_(const std::vector<PddlCondition>& conditions, Snap& snap)
+  {
+    for(const PddlCondition& condition : conditions)
+    {
+      if(condition.type == PddlCondition::Type::PREDICATE)
+      {
+        snap.positive.set(get_fact_(condition.predicate));
+      }
+      else if(condition.type == PddlCondition::Type::NEGATED_PREDICATE)
+      {
+        snap.negative.set(get_fact_(condition.predicate));
+      }
+      else
+      {
+        snap.comparisons.push_back({ condition.comparator, compile_program_(condition.lhs), compile_program_(condition.rhs), condition.to_string() });
+      }
+    }
+  }
+
+  void compile_effects_(const std::vector<PddlEffect>& effects, Snap& snap)
+  {
+    for(const PddlEffect& effect : effects)
+    {
+      if(effect.type == PddlEffect::Type::ADD)
+      {
+        snap.add.set(get_fact_(effect.atom));
+      }
+      else if(effect.type == PddlEffect::Type::DELETE)
+      {
+        snap.del.set(get_fact_(effect.atom));
+      }
+      else
+      {
+        if(snap.numeric_effects.size() == MAX_NUMERIC_EFFECTS)
+        {
+          throw std::runtime_error("More than " + std::to_string(MAX_NUMERIC_EFFECTS) + " numeric effects at one point of an action");
+        }
+        snap.numeric_effects.push_back({ effect.type, static_cast<uint32_t>(get_function_(effect.atom)), compile_program_(effect.value) });
+      }
+    }
+  }
+
+  NumericProgram compile_program_(const NumericExpression& expression)
+  {
+    return NumericProgram::compile(expression, [this](const PddlAtom& function)
+    {
+      return NumericProgram::Instruction{ NumericProgram::OpCode::PUSH_FUNCTION, static_cast<uint32_t>(get_function_(function)), 0.0 };
+    });
+  }
+
+  bool evaluate_(const NumericProgram& program, const State& state, double duration_s, double& result) const
+  {
+    return program.evaluate(state.values, state.is_defined, duration_s, result);
+  }
+
+  bool compare_(Comparator comparator, const NumericProgram& lhs_program, const NumericProgram& rhs_program, const State& state, double duration_s) const
+  {
+    double lhs;
+    double rhs;
+    return evaluate_(lhs_program, state, duration_s, lhs) && evaluate_(rhs_program, state, duration_s, rhs)
+      && compare(comparator, lhs, rhs);
+  }
+
+  Failure check_snap_(const Snap& snap, const State& state, double duration_s, Failure failure) const
+  {
+    if((snap.positive & ~state.facts).any() || (snap.negative & state.facts).any())
+    {
+      return failure;
+    }
+    for(const Comparison& comparison : snap.comparisons)
+    {
+      if(! compare_(comparison.comparator, comparison.lhs, comparison.rhs, state, duration_s))
+      {
+        return failure;
+      }
+    }
+    return Failure::NONE;
+  }
+
+  /**
+   * @brief Applies the effects, with the numeric effects evaluated in the state before the snap.
+   * Returns false if a numeric effect is undefined
+   */
+  bool apply_snap_(const Snap& snap, State& state, double duration_s) const
+  {
+    std::array<double, MAX_NUMERIC_EFFECTS> values;
+    std::array<bool, MAX_NUMERIC_EFFECTS> is_defined;
+    bool is_all_defined = true;
+    for(size_t i = 0; i < snap.numeric_effects.size(); i++)
+    {
+      const NumericEffect& effect = snap.numeric_effects[i];
+      double value = 0.0;
+      is_defined[i] = evaluate_(effect.value, state, duration_s, value)
+        && (effect.type == PddlEffect::Type::ASSIGN || state.is_defined[effect.slot]);
+      if(effect.type == PddlEffect::Type::INCREASE)
+      {
+        value = state.values[effect.slot] + value;
+      }
+      else if(effect.type == PddlEffect::Type::DECREASE)
+      {
+        value = state.values[effect.slot] - value;
+      }
+      values[i] = value;
+      is_all_defined = is_all_defined && is_defined[i];
+    }
+
+    // Delete before add, such that an action may both delete and add a fact
+    state.facts = (state.facts & ~snap.del) | snap.add;
+    for(size_t i = 0; i < snap.numeric_effects.size(); i++)
+    {
+      const uint32_t slot = snap.numeric_effects[i].slot;
+      state.values[slot] = values[i];
+      state.is_defined.set(slot, is_defined[i]);
+    }
+    return is_all_defined;
+  }
+
+  void fail_(ValidationResult& result, Failure failure, size_t item_idx, double time_s) const
+  {
+    result.is_valid = false;
+    result.failure = failure;
+    result.item_idx = item_idx;
+    result.time_s = time_s;
+  }
+};
+
+
+/**
+ * @brief Capacities sized for the scenarios in pddl/problems, with one drone, a dozen locations
+ * and a few persons. A plan searching all locations uses around 150 facts and 40 functions
+ */
+using SarDomainModel = CompiledDomainModel<512, 128>;
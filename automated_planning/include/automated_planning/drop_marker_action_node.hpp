@@ -6,6 +6,7 @@
 #include <math.h>
 #include <map>
 #include <stdint.h>
+#include <regex>
 
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp/publisher.hpp"
@@ -25,12 +26,16 @@
 #include "geometry_msgs/msg/twist_stamped.hpp"
 #include "builtin_interfaces/msg/time.hpp"
 
-#include "anafi_uav_interfaces/msg/detected_person.hpp"
+#include "anafi_uav_interfaces/msg/person_track_array.hpp"
 #include "anafi_uav_interfaces/srv/set_equipment_numbers.hpp"
-#include "anafi_uav_interfaces/srv/set_finished_action.hpp"
+#include "anafi_uav_interfaces/async_service_client.hpp"
 
 #include "plansys2_executor/ActionExecutorClient.hpp"
 
+#include "automated_planning/action_activation_monitor.hpp"
+#include "automated_planning/action_completion_publisher.hpp"
+#include "automated_planning/adaptive_action_executor_client.hpp"
+
 using namespace std::chrono_literals;
 using LifecycleNodeInterface = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface;
 
@@ -38,11 +43,11 @@ using LifecycleNodeInterface = rclcpp_lifecycle::node_interfaces::LifecycleNodeI
 enum class Severity{ MINOR, MODERATE, HIGH };
 
 
-class DropMarkerActionNode : public plansys2::ActionExecutorClient
+class DropMarkerActionNode : public AdaptiveActionExecutorClient
 {
 public:
   DropMarkerActionNode() 
-  : plansys2::ActionExecutorClient("drop_marker_action_node", 500ms)
+  : AdaptiveActionExecutorClient("drop_marker_action_node", 500ms)
   {
     /**
      * Declare parameters
@@ -63,14 +68,21 @@ public:
       "/anafi/state", rclcpp::QoS(1).best_effort(), std::bind(&DropMarkerActionNode::anafi_state_cb_, this, _1));   
     ned_pos_sub_ = this->create_subscription<geometry_msgs::msg::PointStamped>(
       "/anafi/ned_pos_from_gnss", rclcpp::QoS(1).best_effort(), std::bind(&DropMarkerActionNode::ned_pos_cb_, this, _1));   
-    detected_person_sub_ = this->create_subscription<anafi_uav_interfaces::msg::DetectedPerson>(
-      "estimate/detected_person", rclcpp::QoS(1).best_effort(), std::bind(&DropMarkerActionNode::detected_person_cb_, this, _1));
+    person_tracks_sub_ = this->create_subscription<anafi_uav_interfaces::msg::PersonTrackArray>(
+      "estimate/person_tracks", rclcpp::QoS(1).reliable().transient_local(), std::bind(&DropMarkerActionNode::person_tracks_cb_, this, _1));
   
-    set_num_markers_client_ = this->create_client<anafi_uav_interfaces::srv::SetEquipmentNumbers>("/mission_controller/num_markers");
-    set_finished_action_client_ = this->create_client<anafi_uav_interfaces::srv::SetFinishedAction>("/mission_controller/finished_action");
+    set_num_markers_client_ = std::make_shared<AsyncServiceClient<anafi_uav_interfaces::srv::SetEquipmentNumbers>>(
+      this, "/mission_controller/num_markers");
+
+    // Connections are checked from configuration, such that the activation does not wait for them
+    activation_monitor_ = std::make_unique<ActionActivationMonitor>(this);
+    activation_monitor_->add_service(set_num_markers_client_->get_client());
+
+    completion_pub_ = std::make_unique<ActionCompletionPublisher>(this);
   }
 
   // Lifecycle-events
+  LifecycleNodeInterface::CallbackReturn on_configure(const rclcpp_lifecycle::State &);
   LifecycleNodeInterface::CallbackReturn on_activate(const rclcpp_lifecycle::State &);
 
 private:
@@ -80,6 +92,7 @@ private:
   std::string anafi_state_;
 
   std::tuple<geometry_msgs::msg::Point, Severity> detected_person_;
+  std::map<int, std::tuple<geometry_msgs::msg::Point, Severity>> person_tracks_; // <Idx, <estimated position, severity>>
   std::vector<geometry_msgs::msg::Point> previously_helped_people_;
   geometry_msgs::msg::PointStamped position_ned_;
 
@@ -90,11 +103,13 @@ private:
   // Subscribers
   rclcpp::Subscription<std_msgs::msg::String>::ConstSharedPtr anafi_state_sub_;
   rclcpp::Subscription<geometry_msgs::msg::PointStamped>::ConstSharedPtr ned_pos_sub_;
-  rclcpp::Subscription<anafi_uav_interfaces::msg::DetectedPerson>::ConstSharedPtr detected_person_sub_;
+  rclcpp::Subscription<anafi_uav_interfaces::msg::PersonTrackArray>::ConstSharedPtr person_tracks_sub_;
 
   // Services
-  rclcpp::Client<anafi_uav_interfaces::srv::SetEquipmentNumbers>::SharedPtr set_num_markers_client_;
-  rclcpp::Client<anafi_uav_interfaces::srv::SetFinishedAction>::SharedPtr set_finished_action_client_;
+  AsyncServiceClient<anafi_uav_interfaces::srv::SetEquipmentNumbers>::SharedPtr set_num_markers_client_;
+
+  std::unique_ptr<ActionActivationMonitor> activation_monitor_;
+  std::unique_ptr<ActionCompletionPublisher> completion_pub_;
 
 
   // Private functions
@@ -120,6 +135,12 @@ private:
    */
   bool check_drop_preconditions();
 
+
+  /**
+   * @brief Sets @p detected_person_ to the tracked person given by the action arguments
+   */
+  bool set_detected_person_from_arguments_();
+
   /**
    * @brief Drops a marker on the desired position, if possible and update the 
    * mission-controller about the number of markers remaining
@@ -128,18 +149,18 @@ private:
   void update_controller_of_marker_status_();
 
   /**
-   * @brief Notifies the 
+   * @brief Notifies the mission controller that the drop is completed, through an action completion event
    * 
    * @todo This is slightly duplicate of update_controller_of_lifevest_status_()
    * These functions could be merged into a single action, which might increase readability.
    * For whomever comes after, here is some future work hehe
    */
-  bool set_drop_action_finished_(const std::string& argument="");
+  void set_drop_action_finished_();
 
 
   // Callbacks
   void anafi_state_cb_(std_msgs::msg::String::ConstSharedPtr state_msg);
   void ned_pos_cb_(geometry_msgs::msg::PointStamped::ConstSharedPtr ned_pos_msg);
-  void detected_person_cb_(anafi_uav_interfaces::msg::DetectedPerson::ConstSharedPtr detected_person_msg);
+  void person_tracks_cb_(anafi_uav_interfaces::msg::PersonTrackArray::ConstSharedPtr person_tracks_msg);
 
 }; // DropMarkerActionNode
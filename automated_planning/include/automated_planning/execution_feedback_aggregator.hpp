@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief Status of an action, with the same values as plansys2_msgs::msg::ActionExecutionInfo
+ */
+enum class ActionStatus : uint8_t
+{
+  NOT_EXECUTED = 0,
+  EXECUTING = 1,
+  FAILED = 2,
+  SUCCEEDED = 3,
+  CANCELLED = 4
+};
+
+
+/**
+ * @brief One action in a plan, as given by plansys2_msgs::msg::PlanItem
+ */
+struct PlannedAction
+{
+  std::string action;         // (action arg_0 arg_1 ...)
+  double start_s;             // [s] Relative to the start of the plan
+  double duration_s;          // [s]
+};
+
+
+/**
+ * @brief One entry of the executor feedback, as given by plansys2_msgs::msg::ActionExecutionInfo
+ */
+struct ActionFeedbackSample
+{
+  std::string action_full_name;             // Unique for each action in the plan
+  std::string action_type;
+  std::vector<std::string> arguments;
+  ActionStatus status;
+  double start_time_s;                      // [s] Absolute. Only valid once the action has started
+  double status_time_s;                     // [s] Absolute
+  double completion;                        // [0, 1]
+};
+
+
+/**
+ * @brief Planned versus actual timing of one action in the current plan
+ */
+struct ActionTiming
+{
+  std::string action;
+  std::string action_type;
+  ActionStatus status{ ActionStatus::NOT_EXECUTED };
+  double completion{ 0.0 };
+
+  double planned_start_s{ 0.0 };      // [s] Relative to the start of the plan
+  double planned_duration_s{ 0.0 };   // [s]
+  double actual_start_s{ -1.0 };      // [s] Relative to the start of the plan. Negative if not started
+  double actual_duration_s{ 0.0 };    // [s] Time executed so far, or the final duration once finished
+  bool is_finished{ false };
+};
+
+
+/**
+ * @brief Statistics of all executions of one action type during the mission. The errors are
+ * computed over the latest executions only, such that they follow changes in the conditions
+ */
+struct ActionTypeStatistics
+{
+  std::string action_type;
+  size_t num_succeeded{ 0 };
+  size_t num_failed{ 0 };               // Failed or cancelled
+  double total_actual_s{ 0.0 };         // [s] Time spent executing the action type, including failures
+  double total_planned_s{ 0.0 };        // [s] Planned duration of the finished executions
+
+  double mean_duration_error_s{ 0.0 };  // [s] actual - planned duration, over the window
+  double p95_duration_error_s{ 0.0 };   // [s]
+  double mean_start_delay_s{ 0.0 };     // [s] actual - planned start, over the window
+};
+
+
+/**
+ * @brief Aggregates the executor feedback of the current plan into the timing of each action,
+ * and into rolling statistics for each action type
+ *
+ * The feedback only identifies the actions by their name and arguments, and an action may occur
+ * several times in a plan. Each action in the feedback is therefore assigned to the first
+ * unassigned plan item of the same action once it is first seen, and keeps that plan item for
+ * the rest of the plan
+ */
+class ExecutionFeedbackAggregator
+{
+public:
+  /**
+   * @param window_size Number of executions per action type used for the error statistics
+   */
+  explicit ExecutionFeedbackAggregator(size_t window_size=20);
+
+  /**
+   * @brief Starts tracking a new plan, started at @p start_time_s. Unfinished actions of the
+   * previous plan are counted as cancelled
+   */
+  void start_plan(const std::vector<PlannedAction>& plan, double start_time_s);
+
+  /**
+   * @brief Updates the timing from a sample of the executor feedback at @p time_s
+   */
+  void update(const std::vector<ActionFeedbackSample>& samples, double time_s);
+
+  bool is_plan_started() const { return is_plan_started_; }
+  double get_plan_elapsed_s(double time_s) const;
+
+  /**
+   * @brief Timing of the actions in the current plan, sorted by the planned start
+   */
+  const std::vector<ActionTiming>& get_actions() const { return actions_; }
+
+  /**
+   * @brief Statistics of each action type seen so far, sorted by the type
+   */
+  std::vector<ActionTypeStatistics> get_statistics() const;
+
+  /**
+   * @brief Human-readable summary of the current plan and the statistics
+   */
+  std::string to_string() const;
+
+private:
+  // Rolling window and accumulated totals for one action type
+  struct TypeHistory
+  {
+    size_t num_succeeded{ 0 };
+    size_t num_failed{ 0 };
+    double total_actual_s{ 0.0 };
+    double total_planned_s{ 0.0 };
+    std::deque<double> duration_errors_s;
+    std::deque<double> start_delays_s;
+  };
+
+  size_t window_size_;
+
+  bool is_plan_started_;
+  double plan_start_time_s_;
+  std::vector<ActionTiming> actions_;
+  std::map<std::string, size_t> assigned_actions_;  // action_full_name to index in actions_
+
+  std::map<std::string, TypeHistory> histories_;
+
+  void finish_action_(ActionTiming& timing);
+  void push_to_window_(std::deque<double>& window, double value) const;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "automated_planning/pddl_domain.hpp"
+
+
+enum class GoalStatus { OPEN, SATISFIED, UNREACHABLE };
+
+
+struct GoalAnalysisStatistics
+{
+  size_t num_analyses{ 0 };
+  size_t num_satisfied{ 0 };
+  size_t num_unreachable{ 0 };
+  size_t num_ground_actions{ 0 };         // Of the last analysis
+  size_t num_reachable_actions{ 0 };
+  double duration_s{ 0.0 };               // [s] Of the last analysis
+
+  std::string to_string() const;
+};
+
+
+/**
+ * @brief Decides the goals which need no planner call, either because the initial state already
+ * satisfies them, or because no plan can reach them
+ *
+ * The planner fails on a goal which already holds, and searches its entire space before failing on
+ * an unreachable goal. The satisfied goal is found by evaluating the conjunctive goal in the initial
+ * state. The unreachable goal is found by a relaxed reachability analysis over the ground actions,
+ * where the deletes are ignored and each function is only bounded by the interval of the values it
+ * can take. An action is reachable if its conditions can hold given the reachable facts and
+ * intervals, and an increase or decrease by a reachable action makes the function unbounded in that
+ * direction. The analysis is an over-approximation, such that a goal found unreachable has no plan,
+ * for example a rescue without any lifevests and without a reachable location to resupply at, while
+ * a goal which is not found unreachable may still have no plan
+ */
+class GoalAnalysis
+{
+public:
+  explicit GoalAnalysis(std::shared_ptr<const PddlDomain> domain);
+
+  /**
+   * @brief Whether the initial state of the problem satisfies its goal
+   */
+  static bool is_satisfied(const PddlProblem& problem);
+
+  /**
+   * @param unreachable_goals  [out] The goal conditions which cannot hold, if UNREACHABLE
+   */
+  GoalStatus analyze(const PddlProblem& problem, std::vector<PddlCondition>& unreachable_goals);
+
+  const GoalAnalysisStatistics& get_statistics() const { return statistics_; }
+
+private:
+  std::shared_ptr<const PddlDomain> domain_;
+  GoalAnalysisStatistics statistics_;
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+/**
+ * @brief A grounded PDDL atom, for example (drone_at d0 h0) or the function (num_markers d0)
+ */
+struct PddlAtom
+{
+  std::string name;
+  std::vector<std::string> arguments;
+
+  /**
+   * @brief Parses "(name arg0 arg1 ...)". Case and whitespace are normalized
+   */
+  static std::optional<PddlAtom> parse(const std::string& str);
+
+  /**
+   * @brief The normalized string "(name arg0 arg1 ...)", used as key
+   */
+  std::string to_string() const;
+};
+
+
+/**
+ * @brief Local copy of the instances, predicates, functions and goal in the PlanSys2 problem
+ * expert, indexed such that lookups do not require any calls to the problem expert
+ *
+ * The mirror is kept consistent by applying the writes of the controller as they are made, and
+ * by replacing the entire state whenever the problem expert publishes its knowledge. The latter
+ * also covers the effects applied by the executor
+ */
+class KnowledgeMirror
+{
+public:
+  KnowledgeMirror();
+
+  // Writes mirrored from the controller
+  void add_instance(const std::string& name, const std::string& type);
+  void add_predicate(const std::string& predicate);
+  void remove_predicate(const std::string& predicate);
+
+  /**
+   * @brief Sets a function from "(= (name args) value)" or "(name args) value"
+   */
+  void set_function(const std::string& function);
+  void set_goal(const std::string& goal);
+  void clear_goal();
+  void clear();
+
+  /**
+   * @brief Replaces the entire state with the knowledge published by the problem expert
+   */
+  void synchronize(
+    const std::vector<std::string>& instances,
+    const std::vector<std::string>& predicates,
+    const std::vector<std::string>& functions,
+    const std::string& goal);
+
+  // Queries. Each query replaces a call to the problem expert
+  bool has_predicate(const std::string& name, const std::vector<std::string>& arguments) const;
+  bool has_predicate(const std::string& predicate) const;
+  std::vector<PddlAtom> get_predicates(const std::string& name) const;
+  std::optional<double> get_function(const std::string& name, const std::vector<std::string>& arguments) const;
+  const std::string& get_goal() const;
+
+  // Snapshots of the entire state, sorted such that they do not depend on the hashing
+  std::vector<std::pair<std::string, std::string>> get_instances() const;
+  std::vector<PddlAtom> get_all_predicates() const;
+  std::vector<std::pair<PddlAtom, double>> get_all_functions() const;
+
+  /**
+   * @brief Human readable dump of the mirrored problem, for logging
+   */
+  std::string to_string() const;
+
+  /**
+   * @brief Counts a query which still had to be made to the problem expert
+   */
+  void record_remote_query() { num_remote_queries_++; }
+
+  size_t get_num_local_queries() const { return num_local_queries_; }
+  size_t get_num_remote_queries() const { return num_remote_queries_; }
+  size_t get_num_synchronizations() const { return num_synchronizations_; }
+
+  /**
+   * @brief Incremented by every change of the mirrored state, such that users can skip work
+   * when nothing has changed
+   */
+  size_t get_version() const { return version_; }
+  std::string get_statistics_string() const;
+
+private:
+  std::map<std::string, std::string> instances_;                              // Name to type
+  std::unordered_set<std::string> predicates_;                                // Normalized strings
+  std::unordered_map<std::string, std::unordered_set<std::string>> predicates_by_name_;
+  std::unordered_map<std::string, double> functions_;                         // Normalized atom to value
+  std::string goal_;
+
+  // The queries are counted from const functions
+  mutable size_t num_local_queries_;
+  size_t num_remote_queries_;
+  size_t num_synchronizations_;
+  size_t version_;
+};
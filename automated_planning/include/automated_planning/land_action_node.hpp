@@ -28,9 +28,13 @@
 
 #include "anafi_uav_interfaces/msg/float32_stamped.hpp"
 #include "anafi_uav_interfaces/msg/point_with_covariance_stamped.hpp"
+#include "anafi_uav_interfaces/async_service_client.hpp"
 
 #include "plansys2_executor/ActionExecutorClient.hpp"
 
+#include "automated_planning/action_activation_monitor.hpp"
+#include "automated_planning/adaptive_action_executor_client.hpp"
+
 using namespace std::chrono_literals;
 using LifecycleNodeInterface = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface;
 
@@ -39,11 +43,11 @@ enum class HelipadState{ GO, NO_GO };
 enum LandingState{ INIT, HOVER_DIRECTLY_ABOVE, LAND };
 
 
-class LandActionNode : public plansys2::ActionExecutorClient
+class LandActionNode : public AdaptiveActionExecutorClient
 {
 public:
   LandActionNode() 
-  : plansys2::ActionExecutorClient("land_action_node", 250ms)
+  : AdaptiveActionExecutorClient("land_action_node", 250ms)
   , battery_percentage_(-1)
   , is_gnc_activated_(false)
   , helipad_detected_(false)
@@ -90,11 +94,16 @@ public:
     // Services
     // Assuming the velocity controller will be used throughout this thesis
     // Future improvement to allow for using the MPC
-    enable_velocity_control_client_ = this->create_client<std_srvs::srv::SetBool>(
-      "/velocity_controller/service/enable_controller");//, rmw_qos_profile_services_default, service_callback_group_); 
+    enable_velocity_control_client_ = std::make_shared<AsyncServiceClient<std_srvs::srv::SetBool>>(
+      this, "/velocity_controller/service/enable_controller");
+
+    // Connections are checked from configuration, such that the activation does not wait for them
+    activation_monitor_ = std::make_unique<ActionActivationMonitor>(this);
+    activation_monitor_->add_service(enable_velocity_control_client_->get_client());
   }
 
   // Lifecycle-events
+  LifecycleNodeInterface::CallbackReturn on_configure(const rclcpp_lifecycle::State &);
   LifecycleNodeInterface::CallbackReturn on_activate(const rclcpp_lifecycle::State &);
   LifecycleNodeInterface::CallbackReturn on_deactivate(const rclcpp_lifecycle::State &);
 
@@ -140,7 +149,9 @@ private:
 
 
   // Services
-  rclcpp::Client<std_srvs::srv::SetBool>::SharedPtr enable_velocity_control_client_;
+  AsyncServiceClient<std_srvs::srv::SetBool>::SharedPtr enable_velocity_control_client_;
+
+  std::unique_ptr<ActionActivationMonitor> activation_monitor_;
 
 
   // Private functions
@@ -148,7 +159,8 @@ private:
    * @brief Overload of function in ActionExecutorClient. This function does the 
    * majority of the work when the node is activated. 
    * 
-   * The function is called at the same frequency as the node, and is responsible for
+   * The function is called at tick.active_rate, and when the EKF-estimate or the state of the drone
+   * changes. It is responsible for
    *    - Check if the drone has not taken off
    *      - If it has taken too long, call takeoff again
    *      - If a maximum number of takeoff tries are reached, fail the task
@@ -203,10 +215,9 @@ private:
    *  true  ->  Activates the GNC
    *  false ->  Disables the GNC
    * 
-   * @warning Will not wait on the response!
-   * @warning Sets the boolean @a is_gnc_activated_ to @p enable_controller
-   * This should be changed to use the response from GNC (when waiting on response
-   * works (AKA when someone competent takes over this monstrousity))
+   * @warning Will not wait on the response! The boolean @a is_gnc_activated_ is set to 
+   * @p enable_controller immediately, and reverted if the GNC does not confirm the request.
+   * The land-command is therefore not sent while the GNC may still be active
    */
   void set_controller_state_(bool enable_controller, const std::string& log_str);
 
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "automated_planning/execution_feedback_aggregator.hpp"
+
+
+struct DetectedPersonCheckpoint
+{
+  int id;
+  double x;                   // [m] NED
+  double y;
+  double z;
+  int severity;
+  bool is_helped;
+};
+
+
+/**
+ * @brief The mission state of the controller, which is lost when the controller restarts: the
+ * remaining mission goals, the detected people, the equipment, the controller state, the last
+ * plan, and the knowledge written to the problem expert
+ *
+ * The checkpoint does not depend on ROS, such that the controller converts its own types
+ */
+struct MissionCheckpoint
+{
+  double wall_time_s{ 0.0 };          // [s] Since the epoch, when the checkpoint was written
+  double node_time_s{ 0.0 };          // [s] Of the clock of the controller, simulated with use_sim_time
+  uint64_t mission_hash{ 0 };         // Of the mission it belongs to, see get_hash()
+  int controller_state{ 0 };
+  int num_markers{ 0 };
+  int num_lifevests{ 0 };
+
+  std::string landed_goal;
+  std::string preferred_landing_goal;
+  std::vector<std::string> possible_landing_goals;
+  std::vector<std::string> search_goals;
+  std::vector<std::string> communicate_location_goals;
+  std::vector<std::string> mark_location_goals;
+  std::vector<std::string> rescue_location_goals;
+
+  std::vector<DetectedPersonCheckpoint> detected_people;
+  std::vector<PlannedAction> plan;
+
+  std::vector<std::pair<std::string, std::string>> instances;     // Name and type
+  std::vector<std::string> predicates;
+  std::vector<std::pair<std::string, double>> functions;
+
+  /**
+   * @brief Compact binary encoding: a magic number and a version, the fields with the strings and
+   * vectors prefixed by their sizes, and a checksum of everything before it
+   */
+  std::string serialize() const;
+
+  /**
+   * @brief [s] Wall time since the checkpoint was written
+   */
+  double get_age_s() const;
+
+  /**
+   * @return std::nullopt if the data is truncated, corrupt or of another version
+   */
+  static std::optional<MissionCheckpoint> deserialize(const std::string& data);
+
+  /**
+   * @brief 64-bit FNV-1a hash of @p data. The controller hashes its namespace, the domain and the
+   * mission parameters into mission_hash, and only resumes from a checkpoint of the same mission
+   */
+  static uint64_t get_hash(const std::string& data);
+};
+
+
+/**
+ * @brief The file a checkpoint is kept in. A checkpoint is written to a temporary file which then
+ * replaces the checkpoint file, such that a crash while writing leaves the previous checkpoint
+ */
+class MissionCheckpointFile
+{
+public:
+  explicit MissionCheckpointFile(const std::string& path);
+
+  /**
+   * @brief Writes the checkpoint stamped with the current wall time, unless it is equal to the
+   * last checkpoint written, which makes calling this on every step cheap. The node time is
+   * set by the caller, and is not compared either
+   *
+   * @return false if the file could not be written
+   */
+  bool write(const MissionCheckpoint& checkpoint);
+
+  /**
+   * @return std::nullopt if there is no valid checkpoint
+   */
+  std::optional<MissionCheckpoint> read() const;
+
+  /**
+   * @brief Removes the checkpoint, such that the next start begins a new mission
+   */
+  void remove();
+
+  const std::string& get_path() const { return path_; }
+  size_t get_num_writes() const { return num_writes_; }
+
+private:
+  std::string path_;
+  std::string last_data_;           // Serialized with the times zeroed
+  size_t num_writes_;
+};
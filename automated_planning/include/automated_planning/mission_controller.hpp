@@ -8,9 +8,16 @@
 #include <tuple>
 #include <string>
 #include <optional>
+#include <limits>
+#include <chrono>
+#include <ctime>
 #include <Eigen/Geometry>
 #include <stdint.h>
 #include <sstream>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <future>
 
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp/service.hpp"
@@ -18,6 +25,8 @@
 #include "rclcpp/subscription.hpp"
 #include "rclcpp_action/rclcpp_action.hpp"
 #include "rclcpp/qos.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialized_message.hpp"
 
 #include <plansys2_pddl_parser/Utils.h>
 #include "plansys2_domain_expert/DomainExpertClient.hpp"
@@ -29,6 +38,7 @@
 #include "plansys2_msgs/msg/plan.hpp"
 #include "plansys2_msgs/msg/tree.hpp"
 #include "plansys2_msgs/msg/node.hpp"
+#include "plansys2_msgs/msg/knowledge.hpp"
 
 #include "std_msgs/msg/int8.hpp"
 #include "std_msgs/msg/string.hpp"
@@ -41,14 +51,74 @@
 #include "sensor_msgs/msg/nav_sat_fix.hpp"
 
 #include "anafi_uav_interfaces/msg/stamped_string.hpp"
-#include "anafi_uav_interfaces/msg/detected_person.hpp"
+#include "anafi_uav_interfaces/msg/person_track.hpp"
+#include "anafi_uav_interfaces/msg/person_track_array.hpp"
+#include "anafi_uav_interfaces/msg/replan_statistics.hpp"
+#include "anafi_uav_interfaces/msg/execution_feedback.hpp"
+#include "anafi_uav_interfaces/msg/startup_timeline.hpp"
+#include "anafi_uav_interfaces/msg/action_completion.hpp"
 #include "anafi_uav_interfaces/srv/set_equipment_numbers.hpp"
 #include "anafi_uav_interfaces/srv/set_finished_action.hpp"
 
+#include "automated_planning/action_completion.hpp"
+#include "automated_planning/action_completion_conversion.hpp"
+#include "automated_planning/action_duration_model.hpp"
+#include "automated_planning/battery_estimator.hpp"
+#include "automated_planning/replan_scheduler.hpp"
+#include "automated_planning/telemetry_log.hpp"
+#include "automated_planning/knowledge_mirror.hpp"
+#include "automated_planning/execution_feedback_aggregator.hpp"
+#include "automated_planning/pddl_domain.hpp"
+#include "automated_planning/plan_validity_monitor.hpp"
+#include "automated_planning/plan_conversion.hpp"
+#include "automated_planning/native_planner.hpp"
+#include "automated_planning/relevance_analysis.hpp"
+#include "automated_planning/speculative_planner.hpp"
+#include "automated_planning/goal_analysis.hpp"
+#include "automated_planning/mission_checkpoint.hpp"
+#include "automated_planning/startup_timeline.hpp"
+#include "automated_planning/startup_timeline_conversion.hpp"
+
 
 enum class Severity{ MINOR, MODERATE, HIGH };
 enum class ControllerState { INIT, SEARCH, RESCUE, EMERGENCY, AREA_UNAVAILABLE, IDLE };
 
+/**
+ * @brief Channels in the telemetry log of the mission controller. Only append new channels, as
+ * the values are stored in the logs
+ */
+enum class MissionControllerChannel : uint32_t
+{
+  PRECONDITIONS_CHECK = 1,  // Markers without payload
+  STEP,
+  ANAFI_STATE,              // Topics
+  BATTERY,
+  GNSS,
+  ATTITUDE,
+  POLLED_VELOCITY,
+  NED_POSITION,
+  PERSON_TRACKS,
+  EMERGENCY,
+  SEARCH_DISTANCE,
+  NUM_MARKERS,              // Service requests
+  NUM_LIFEVESTS,
+  FINISHED_ACTION,
+  KNOWLEDGE,                // Knowledge published by the problem expert
+  ACTION_COMPLETION         // Completions published by the action nodes
+};
+
+
+/**
+ * @brief The knowledge given by the parameters alone, which is pushed to the problem expert while
+ * the controller waits for the telemetry
+ */
+struct StaticKnowledge
+{
+  std::vector<std::pair<std::string, std::string>> instances;     // Name and type
+  std::vector<std::string> predicates;
+  std::vector<std::string> functions;
+};
+
 
 struct MissionGoals
 {
@@ -71,9 +141,15 @@ public:
   , controller_state_(ControllerState::INIT)
   , battery_charge_(-1) // Set to -1 to indicate that it is not updated
   , previous_plan_str_("")
-  , is_emergency_(false)
   , is_low_battery_(false)
-  , is_person_detected_(false)
+  , battery_charge_at_battery_replan_(std::numeric_limits<double>::infinity())
+  , last_planner_duration_s_(0.0)
+  , total_planner_duration_s_(0.0)
+  , is_mission_completed_reported_(false)
+  , is_first_plan_reported_(false)
+  , last_execution_feedback_time_s_(-std::numeric_limits<double>::infinity())
+  , is_plan_violation_reported_(false)
+  , last_plan_violation_replan_time_s_(-std::numeric_limits<double>::infinity())
   {
     // Load parameters from config file
     declare_parameters_();
@@ -82,34 +158,100 @@ public:
     // Create publishers
     plan_pub_ = this->create_publisher<plansys2_msgs::msg::Plan>("/mission_controller/plansys2_plan", 1);
     planning_status_pub_ = this->create_publisher<std_msgs::msg::String>("/mission_controller/planning_status", 1);
+    makespan_error_pub_ = this->create_publisher<std_msgs::msg::Float64>("/mission_controller/makespan_error", 1);
+    predicted_final_battery_pub_ = this->create_publisher<std_msgs::msg::Float64>("/mission_controller/predicted_final_battery", 1);
+    replan_statistics_pub_ = this->create_publisher<anafi_uav_interfaces::msg::ReplanStatistics>("/mission_controller/replan_statistics", 1);
+    execution_feedback_pub_ = this->create_publisher<anafi_uav_interfaces::msg::ExecutionFeedback>("/mission_controller/execution_feedback", 1);
+    startup_timeline_pub_ = this->create_publisher<anafi_uav_interfaces::msg::StartupTimeline>("/startup/timeline", rclcpp::QoS(1).reliable().transient_local());
     // planning_status_pub_ = this->create_publisher<anafi_uav_interfaces::msg::StampedString>("/mission_controller/planning_status", 1);
 
+    // Callback groups. The telemetry and the services only queue their inputs, which are applied
+    // at the start of each step. All controller state is thereby only accessed from the planning
+    // group, and the services are answered while the planner is running
+    telemetry_callback_group_ = this->create_callback_group(rclcpp::CallbackGroupType::Reentrant);
+    service_callback_group_ = this->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+    planning_callback_group_ = this->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+
+    rclcpp::SubscriptionOptions telemetry_options;
+    telemetry_options.callback_group = telemetry_callback_group_;
+
     // Create subscribers
-    using namespace std::placeholders;
     anafi_state_sub_ = this->create_subscription<std_msgs::msg::String>(
-      "/anafi/state", 10, std::bind(&MissionControllerNode::anafi_state_cb_, this, _1));   
+      "/anafi/state", 10, 
+      [this](std_msgs::msg::String::SharedPtr msg) { defer_input_(MissionControllerChannel::ANAFI_STATE, *msg, [this, msg]() { anafi_state_cb_(msg); }); }, 
+      telemetry_options);   
     battery_charge_sub_ = this->create_subscription<std_msgs::msg::Float64>(
-      "/anafi/battery", rclcpp::QoS(1).best_effort(), std::bind(&MissionControllerNode::battery_charge_cb_, this, _1)); 
+      "/anafi/battery", rclcpp::QoS(1).best_effort(), 
+      [this](std_msgs::msg::Float64::ConstSharedPtr msg) { defer_input_(MissionControllerChannel::BATTERY, *msg, [this, msg]() { battery_charge_cb_(msg); }); }, 
+      telemetry_options); 
     gnss_data_sub_ = this->create_subscription<sensor_msgs::msg::NavSatFix>(
-      "/anafi/gnss_location", rclcpp::QoS(1).best_effort(), std::bind(&MissionControllerNode::gnss_data_cb_, this, _1));
+      "/anafi/gnss_location", rclcpp::QoS(1).best_effort(), 
+      [this](sensor_msgs::msg::NavSatFix::ConstSharedPtr msg) { defer_input_(MissionControllerChannel::GNSS, *msg, [this, msg]() { gnss_data_cb_(msg); }); }, 
+      telemetry_options);
     attitude_sub_ = this->create_subscription<geometry_msgs::msg::QuaternionStamped>(
-      "/anafi/attitude", rclcpp::QoS(1).best_effort(), std::bind(&MissionControllerNode::attitude_cb_, this, _1));   
+      "/anafi/attitude", rclcpp::QoS(1).best_effort(), 
+      [this](geometry_msgs::msg::QuaternionStamped::ConstSharedPtr msg) { defer_input_(MissionControllerChannel::ATTITUDE, *msg, [this, msg]() { attitude_cb_(msg); }); }, 
+      telemetry_options);   
     polled_vel_sub_ = this->create_subscription<geometry_msgs::msg::TwistStamped>(
-      "/anafi/polled_body_velocities", rclcpp::QoS(1).best_effort(), std::bind(&MissionControllerNode::polled_vel_cb_, this, _1));  
+      "/anafi/polled_body_velocities", rclcpp::QoS(1).best_effort(), 
+      [this](geometry_msgs::msg::TwistStamped::ConstSharedPtr msg) { defer_input_(MissionControllerChannel::POLLED_VELOCITY, *msg, [this, msg]() { polled_vel_cb_(msg); }); }, 
+      telemetry_options);  
     ned_pos_sub_ = this->create_subscription<geometry_msgs::msg::PointStamped>(
-      "/anafi/ned_pos_from_gnss", rclcpp::QoS(1).best_effort(), std::bind(&MissionControllerNode::ned_pos_cb_, this, _1));   
-    detected_person_sub_ = this->create_subscription<anafi_uav_interfaces::msg::DetectedPerson>(
-      "estimate/person_detected", rclcpp::QoS(1).best_effort(), std::bind(&MissionControllerNode::detected_person_cb_, this, _1));
+      "/anafi/ned_pos_from_gnss", rclcpp::QoS(1).best_effort(), 
+      [this](geometry_msgs::msg::PointStamped::ConstSharedPtr msg) { defer_input_(MissionControllerChannel::NED_POSITION, *msg, [this, msg]() { ned_pos_cb_(msg); }); }, 
+      telemetry_options);   
+    person_tracks_sub_ = this->create_subscription<anafi_uav_interfaces::msg::PersonTrackArray>(
+      "estimate/person_tracks", rclcpp::QoS(1).reliable().transient_local(), 
+      [this](anafi_uav_interfaces::msg::PersonTrackArray::ConstSharedPtr msg) { defer_input_(MissionControllerChannel::PERSON_TRACKS, *msg, [this, msg]() { person_tracks_cb_(msg); }); }, 
+      telemetry_options);
     emergency_occured_sub_ = this->create_subscription<std_msgs::msg::Empty>(
-      "estimate/emergency", rclcpp::QoS(1).best_effort(), std::bind(&MissionControllerNode::emergency_occured_cb_, this, _1));
-
-    // Create services
-    set_num_markers_srv_ = this->create_service<anafi_uav_interfaces::srv::SetEquipmentNumbers>(
-      "/mission_controller/num_markers", std::bind(&MissionControllerNode::set_num_markers_srv_cb_, this, _1, _2)); 
-    set_num_lifevests_srv_ = this->create_service<anafi_uav_interfaces::srv::SetEquipmentNumbers>(
-      "/mission_controller/num_lifevests", std::bind(&MissionControllerNode::set_num_lifevests_srv_cb_, this, _1, _2)); 
-    set_finished_action_srv_ = this->create_service<anafi_uav_interfaces::srv::SetFinishedAction>(
-      "/mission_controller/finished_action", std::bind(&MissionControllerNode::set_finished_action_srv_cb_, this, _1, _2)); \
+      "estimate/emergency", rclcpp::QoS(1).best_effort(), 
+      [this](std_msgs::msg::Empty::ConstSharedPtr msg) { defer_input_(MissionControllerChannel::EMERGENCY, *msg, [this, msg]() { emergency_occured_cb_(msg); }); }, 
+      telemetry_options);
+    search_distance_sub_ = this->create_subscription<std_msgs::msg::Float64>(
+      "/search_action/search_distance", rclcpp::QoS(1).reliable().transient_local(), 
+      [this](std_msgs::msg::Float64::ConstSharedPtr msg) { defer_input_(MissionControllerChannel::SEARCH_DISTANCE, *msg, [this, msg]() { search_distance_cb_(msg); }); }, 
+      telemetry_options);
+    knowledge_sub_ = this->create_subscription<plansys2_msgs::msg::Knowledge>(
+      "problem_expert/knowledge", rclcpp::QoS(100).reliable(), 
+      [this](plansys2_msgs::msg::Knowledge::ConstSharedPtr msg) { defer_input_(MissionControllerChannel::KNOWLEDGE, *msg, [this, msg]() { knowledge_cb_(msg); }); }, 
+      telemetry_options);
+    action_completion_sub_ = this->create_subscription<anafi_uav_interfaces::msg::ActionCompletion>(
+      "/mission_controller/action_completions", rclcpp::QoS(10).reliable().transient_local(), 
+      [this](anafi_uav_interfaces::msg::ActionCompletion::ConstSharedPtr msg) { defer_input_(MissionControllerChannel::ACTION_COMPLETION, *msg, [this, msg]() { action_completion_cb_(msg); }); }, 
+      telemetry_options);
+
+    // Create services. The requests are applied at the next step, and the responses only 
+    // acknowledge that the request is queued, as Foxy cannot defer a response until the step. A 
+    // request which fails when applied is logged. The finished action service is kept for 
+    // external callers, as the action nodes publish their completions
+    using SetEquipmentNumbers = anafi_uav_interfaces::srv::SetEquipmentNumbers;
+    using SetFinishedAction = anafi_uav_interfaces::srv::SetFinishedAction;
+    set_num_markers_srv_ = this->create_service<SetEquipmentNumbers>(
+      "/mission_controller/num_markers", 
+      [this](const std::shared_ptr<SetEquipmentNumbers::Request> request, std::shared_ptr<SetEquipmentNumbers::Response> response)
+      {
+        defer_input_(MissionControllerChannel::NUM_MARKERS, *request, [this, request]() { set_num_markers_srv_cb_(request, std::make_shared<SetEquipmentNumbers::Response>()); });
+        response->success = true;
+      }, 
+      rmw_qos_profile_services_default, service_callback_group_); 
+    set_num_lifevests_srv_ = this->create_service<SetEquipmentNumbers>(
+      "/mission_controller/num_lifevests", 
+      [this](const std::shared_ptr<SetEquipmentNumbers::Request> request, std::shared_ptr<SetEquipmentNumbers::Response> response)
+      {
+        defer_input_(MissionControllerChannel::NUM_LIFEVESTS, *request, [this, request]() { set_num_lifevests_srv_cb_(request, std::make_shared<SetEquipmentNumbers::Response>()); });
+        response->success = true;
+      }, 
+      rmw_qos_profile_services_default, service_callback_group_); 
+    set_finished_action_srv_ = this->create_service<SetFinishedAction>(
+      "/mission_controller/finished_action", 
+      [this](const std::shared_ptr<SetFinishedAction::Request> request, std::shared_ptr<SetFinishedAction::Response>)
+      {
+        defer_input_(MissionControllerChannel::FINISHED_ACTION, *request, [this, request]() { set_finished_action_srv_cb_(request, std::make_shared<SetFinishedAction::Response>()); });
+      }, 
+      rmw_qos_profile_services_default, service_callback_group_);
+
+    init_telemetry_log_();
   }
 
 
@@ -125,7 +267,17 @@ public:
    */
   void step();
 
+  /**
+   * @brief Starts stepping the controller at 10 Hz in the planning callback group. The node must
+   * be spun by a multi-threaded executor, such that the telemetry and the services are handled
+   * while planning
+   */
+  void start();
+
 private:
+  // Feeds recorded telemetry into the callbacks and the step
+  friend class MissionControllerReplay;
+
   // System state 
   ControllerState controller_state_;
 
@@ -145,9 +297,79 @@ private:
   // Data for replanning
   std::string previous_plan_str_; 
 
-  bool is_emergency_;
+  // Duration model used for the PDDL-functions, and recalibrated from the executor feedback
+  std::shared_ptr<ActionDurationModel> duration_model_;
+  MakespanTracker makespan_tracker_;
+  std::set<std::string> observed_actions_;                    // Actions in the current plan already used for calibration
+  std::map<std::string, double> pushed_duration_functions_;   // Last value pushed to plansys2 for each function
+
   bool is_low_battery_;
-  bool is_person_detected_;
+
+  // Collects the triggers for replanning (emergency, detected people, battery)
+  ReplanScheduler replan_scheduler_;
+
+  // Discharge rates estimated from the battery-stream, and used for predicting whether the 
+  // remaining plan can be completed before the critical battery limit
+  std::shared_ptr<BatteryDischargeEstimator> battery_estimator_;
+  std::string executing_action_type_;         // Empty if no action is executing
+  plansys2_msgs::msg::Plan current_plan_;
+  double battery_charge_at_battery_replan_;
+
+  // Wall time spent in the planner, as the simulated time may run faster than the planner
+  double last_planner_duration_s_;
+  double total_planner_duration_s_;
+  bool is_mission_completed_reported_;
+  bool is_first_plan_reported_;
+
+  // Executor feedback is sampled at a low rate, and shared by everything using it during a step
+  ExecutionFeedbackAggregator execution_feedback_aggregator_;
+  double execution_feedback_period_s_;
+  double last_execution_feedback_time_s_;
+
+  // Watches the remaining plan against the knowledge and the telemetry. Empty if the domain could
+  // not be parsed
+  std::unique_ptr<PlanValidityMonitor> plan_validity_monitor_;
+  double plan_monitor_position_margin_m_;
+  double plan_monitor_min_replan_interval_s_;
+  bool is_plan_violation_reported_;
+
+  // Plans in the process of the controller instead of through the PlanSys2 planner, and relaxes the
+  // goals with soft goals. Empty if neither is enabled, or if the domain could not be parsed
+  std::unique_ptr<NativePlanner> native_planner_;
+  bool is_native_backend_;
+  bool is_planner_fallback_enabled_;
+
+  // Reduces the problem to the objects relevant for the goal before planning. Empty if disabled,
+  // or if the domain could not be parsed
+  std::unique_ptr<RelevanceAnalysis> relevance_analysis_;
+  double last_plan_violation_replan_time_s_;
+
+  // Plans for the likely next events in the background while a plan is executed. Empty if
+  // disabled, or if the domain could not be parsed
+  std::unique_ptr<SpeculativePlanner> speculative_planner_;
+  std::string speculation_state_key_;       // Controller state, location and knowledge version of the last projection
+
+  // Checks the goals against the mirrored knowledge before planning. The analysis of unreachable
+  // goals is empty if the domain could not be parsed
+  bool is_goal_check_enabled_;
+  std::unique_ptr<GoalAnalysis> goal_analysis_;
+  bool is_idle_goals_satisfied_{ false }; // The last replan found no remaining goal to plan for
+
+  // Inputs received by the telemetry and service callback groups, waiting to be applied by the
+  // planning group
+  std::mutex pending_inputs_mutex_;
+  std::deque<std::function<void()>> pending_inputs_;
+
+  // Every input of the controller and every step, for replaying the mission. Empty if not recording
+  std::unique_ptr<TelemetryLogWriter> telemetry_log_;
+
+  // The mission state written on every change, such that a restarted controller resumes the
+  // mission. Empty if disabled
+  std::unique_ptr<MissionCheckpointFile> checkpoint_file_;
+  uint64_t mission_hash_{ 0 };
+
+  // From the start of the process until the first plan is sent to the executor
+  StartupTimeline startup_timeline_{ this->get_fully_qualified_name() };
 
   const std::vector<std::string> possible_anafi_states_ = 
     { "FS_LANDED", "FS_MOTOR_RAMPING", "FS_TAKINGOFF", "FS_HOVERING", "FS_FLYING", "FS_LANDING", "FS_EMERGENCY" };
@@ -156,6 +378,9 @@ private:
 
   // Mission variables
   MissionGoals mission_goals_;
+  std::vector<std::string> location_names_;                 // Indexed by ActionCompletion::location_idx
+  std::vector<ActionCompletion> pending_action_completions_; // Applied to the goals at the next step
+  double min_action_completion_time_s_{ 0.0 };              // [s] Node time of the restored checkpoint
 
   std::map<int, std::tuple<geometry_msgs::msg::Point, Severity, bool>> detected_people_; // Each person given an ID
   std::vector<std::string> unavailable_locations_{ };  // Assumed empty at start 
@@ -166,9 +391,17 @@ private:
   std::shared_ptr<plansys2::ProblemExpertClient> problem_expert_;
   std::shared_ptr<plansys2::ExecutorClient> executor_client_;
 
+  // Indexed copy of the problem expert, such that the controller does not query it over the wire
+  KnowledgeMirror knowledge_mirror_;
+
   // Publishers
   rclcpp::Publisher<plansys2_msgs::msg::Plan>::SharedPtr plan_pub_;
   rclcpp::Publisher<std_msgs::msg::String>::SharedPtr planning_status_pub_;
+  rclcpp::Publisher<std_msgs::msg::Float64>::SharedPtr makespan_error_pub_;
+  rclcpp::Publisher<std_msgs::msg::Float64>::SharedPtr predicted_final_battery_pub_;
+  rclcpp::Publisher<anafi_uav_interfaces::msg::ReplanStatistics>::SharedPtr replan_statistics_pub_;
+  rclcpp::Publisher<anafi_uav_interfaces::msg::ExecutionFeedback>::SharedPtr execution_feedback_pub_;
+  rclcpp::Publisher<anafi_uav_interfaces::msg::StartupTimeline>::SharedPtr startup_timeline_pub_;
   // rclcpp::Publisher<anafi_uav_interfaces::msg::StampedString>::SharedPtr planning_status_pub_;
 
   // Subscribers
@@ -179,13 +412,22 @@ private:
   rclcpp::Subscription<geometry_msgs::msg::PointStamped>::ConstSharedPtr ned_pos_sub_;
   rclcpp::Subscription<geometry_msgs::msg::QuaternionStamped>::ConstSharedPtr attitude_sub_;
   rclcpp::Subscription<geometry_msgs::msg::TwistStamped>::ConstSharedPtr polled_vel_sub_;
-  rclcpp::Subscription<anafi_uav_interfaces::msg::DetectedPerson>::ConstSharedPtr detected_person_sub_;
+  rclcpp::Subscription<anafi_uav_interfaces::msg::PersonTrackArray>::ConstSharedPtr person_tracks_sub_;
+  rclcpp::Subscription<std_msgs::msg::Float64>::ConstSharedPtr search_distance_sub_;
+  rclcpp::Subscription<plansys2_msgs::msg::Knowledge>::ConstSharedPtr knowledge_sub_;
+  rclcpp::Subscription<anafi_uav_interfaces::msg::ActionCompletion>::ConstSharedPtr action_completion_sub_;
 
   // Services
   rclcpp::Service<anafi_uav_interfaces::srv::SetEquipmentNumbers>::SharedPtr set_num_markers_srv_;
   rclcpp::Service<anafi_uav_interfaces::srv::SetEquipmentNumbers>::SharedPtr set_num_lifevests_srv_;
   rclcpp::Service<anafi_uav_interfaces::srv::SetFinishedAction>::SharedPtr set_finished_action_srv_;
 
+  // Callback groups and timers
+  rclcpp::CallbackGroup::SharedPtr telemetry_callback_group_;
+  rclcpp::CallbackGroup::SharedPtr service_callback_group_;
+  rclcpp::CallbackGroup::SharedPtr planning_callback_group_;
+  rclcpp::TimerBase::SharedPtr step_timer_;
+
 
   // Private functions
   /**
@@ -195,8 +437,117 @@ private:
    *  - ned position properly initialized (to roughly 0s). The Olympe bridge can 
    *    produce ned-positions of several 1000s if initialized too early 
    *       
+   * The preconditions are evaluated whenever an input arrives, instead of at a fixed rate
+   *       
+   * @param is_resuming The mission is resumed from a checkpoint. The drone is then anywhere in the
+   *                    mission area
+   */
+  void check_controller_preconditions_(bool is_resuming=false); 
+
+  /**
+   * @brief A single evaluation of the preconditions, logging the unsatisfied ones at most once per second
+   */
+  bool are_controller_preconditions_satisfied_(bool is_resuming=false);
+
+  /**
+   * @brief The part of init() after the preconditions are satisfied
+   * 
+   * @param checkpoint                The mission is resumed from the checkpoint instead of 
+   *                                  started, if given
+   * @param pushed_static_knowledge   The static knowledge already in the problem expert, if any
+   */
+  void init_planning_(
+    const std::optional<MissionCheckpoint>& checkpoint=std::nullopt, 
+    const std::optional<StaticKnowledge>& pushed_static_knowledge=std::nullopt);
+
+  /**
+   * @brief Creates the clients of the domain expert, problem expert, planner and executor
+   */
+  void init_plansys2_clients_();
+
+  /**
+   * @brief Publishes the startup timeline on /startup/timeline, for the startup profiler
+   */
+  void publish_startup_timeline_();
+
+  /**
+   * @brief Opens the checkpoint file if checkpoint.enabled is set
+   * 
+   * @return The checkpoint of an interrupted mission, unless it is older than checkpoint.max_age
+   * or of another mission
+   */
+  std::optional<MissionCheckpoint> init_checkpoint_();
+
+  /**
+   * @brief Hash of the name and namespace of the controller, the domain of the domain expert and
+   * the parameters describing the mission: drone, locations, mission_init and mission_goals
+   */
+  uint64_t get_mission_hash_();
+
+  /**
+   * @brief Loads the knowledge of the checkpoint into the problem expert, and restores the mission
+   * state. The controller then replans for the goals of the restored state at the next step
+   */
+  void restore_checkpoint_(const MissionCheckpoint& checkpoint);
+
+  /**
+   * @brief Writes the mission state to the checkpoint file if it has changed. The checkpoint of
+   * a completed mission is not written, such that the next start begins a new mission
+   */
+  void write_checkpoint_();
+
+  /**
+   * @brief Opens the telemetry log if telemetry.record is set
+   */
+  void init_telemetry_log_();
+
+  /**
+   * @brief Appends a serialized input to the telemetry log, stamped with the node clock. Only
+   * called with pending_inputs_mutex_ held, such that the log has the order the inputs are applied
+   */
+  template<typename MsgT>
+  void record_telemetry_(MissionControllerChannel channel, const MsgT& msg)
+  {
+    if(! telemetry_log_)
+    {
+      return;
+    }
+    rclcpp::Serialization<MsgT> serialization;
+    rclcpp::SerializedMessage serialized_msg;
+    serialization.serialize_message(&msg, &serialized_msg);
+    const rcl_serialized_message_t& rcl_serialized_msg = serialized_msg.get_rcl_serialized_message();
+    telemetry_log_->append(
+      this->get_clock()->now().nanoseconds(), static_cast<uint32_t>(channel), 
+      rcl_serialized_msg.buffer, rcl_serialized_msg.buffer_length);
+  }
+
+  void record_telemetry_(MissionControllerChannel channel);
+
+  /**
+   * @brief Queues an input from the telemetry or service callback groups, and records @p msg
+   * when it is received
    */
-  void check_controller_preconditions_(); 
+  template<typename MsgT>
+  void defer_input_(MissionControllerChannel channel, const MsgT& msg, std::function<void()> input)
+  {
+    std::lock_guard<std::mutex> lock(pending_inputs_mutex_);
+    record_telemetry_(channel, msg);
+    pending_inputs_.push_back(std::move(input));
+  }
+
+  /**
+   * @brief Queues an input without recording it, as when replaying
+   */
+  void defer_input_(std::function<void()> input);
+
+  /**
+   * @brief Applies the queued inputs in the order received. Only called from the planning group.
+   * The inputs are taken together with recording @p channel, the step or precondition check 
+   * they are applied before
+   */
+  void apply_pending_inputs_(MissionControllerChannel channel);
+
+  void step_timer_cb_();
 
 
   /**
@@ -216,8 +567,24 @@ private:
 
   /**
    * @brief Initializes the world knowledge 
+   * 
+   * @param pushed_static_knowledge   The static knowledge already in the problem expert, which is
+   *                                  then only mirrored. Otherwise all knowledge is pushed
    */
-  void init_knowledge_();
+  void init_knowledge_(const std::optional<StaticKnowledge>& pushed_static_knowledge=std::nullopt);
+
+  /**
+   * @brief The instances, predicates and functions given by the parameters
+   */
+  StaticKnowledge get_static_knowledge_();
+
+  /**
+   * @brief Clears the problem expert and pushes the static knowledge to it. Only uses the problem
+   * expert client, such that it runs concurrently with the precondition check during init()
+   * 
+   * @return false if the problem expert rejected any of the knowledge
+   */
+  bool push_static_knowledge_(const StaticKnowledge& knowledge);
 
 
   /**
@@ -225,9 +592,102 @@ private:
    *  - current battery percentage
    *  - number of markers available
    *  - number of lifevests available
+   *  - estimated battery usage for move and track
    */
   bool update_plansys2_functions_();
 
+  /**
+   * @brief The values of the functions updated by update_plansys2_functions_(), except for the
+   * durations
+   */
+  std::vector<std::pair<PddlAtom, double>> get_drone_functions_();
+
+
+  /**
+   * @brief Updates the PDDL-functions for the predicted durations of move and search, using
+   * the duration model. Only functions with a changed value are pushed, to limit the number 
+   * of calls to the problem expert
+   */
+  bool update_plansys2_duration_functions_();
+
+
+  /**
+   * @brief Fetches the executor feedback if the sampling period has passed since the last sample
+   */
+  std::optional<plansys2_msgs::action::ExecutePlan::Feedback> sample_execution_feedback_();
+
+
+  /**
+   * @brief Recalibrates the duration model using the actions which have succeeded in the 
+   * current plan. The duration is measured from the timestamps in the executor feedback
+   */
+  void update_duration_model_(const plansys2_msgs::action::ExecutePlan::Feedback& feedback);
+
+
+  /**
+   * @brief Predicts the battery remaining when the current plan is finished, or when it reaches
+   * a recharge, using the estimated discharge rates. Requires a replan if the prediction is below
+   * the critical battery limit, such that the replan occurs before an emergency is forced
+   */
+  void check_remaining_plan_battery_(const plansys2_msgs::action::ExecutePlan::Feedback& feedback);
+
+
+  /**
+   * @brief Removes the goals achieved by the completions received since the previous step, with
+   * a single pass over each goal list
+   */
+  void apply_action_completions_();
+
+
+  /**
+   * @brief Updates the planned versus actual timing of the actions in the current plan, and
+   * publishes it
+   */
+  void update_execution_feedback_(const plansys2_msgs::action::ExecutePlan::Feedback& feedback);
+
+
+  /**
+   * @brief Parses the domain from the domain expert, and creates the plan validity monitor, the
+   * native planner and the relevance analysis
+   */
+  void init_plan_validity_monitor_();
+
+
+  /**
+   * @brief Plans for the problem with the configured planner. The problem reduced by the relevance
+   * analysis is tried first, and the full problem if the reduced problem has no plan
+   *
+   * @return std::nullopt if no plan was found
+   */
+  std::optional<plansys2_msgs::msg::Plan> compute_plan_(const std::string& domain, const std::string& problem);
+
+
+  /**
+   * @brief Plans with the native planner
+   *
+   * @return std::nullopt if no plan was found, or if the problem does not match the domain
+   */
+  std::optional<plansys2_msgs::msg::Plan> plan_natively_(const PddlProblem& problem);
+
+
+  /**
+   * @brief Checks the remaining plan against the knowledge mirror and the latest telemetry.
+   * Requires an immediate replan if a condition of the plan is violated
+   */
+  void check_plan_validity_();
+
+
+  /**
+   * @brief Distance between two locations in the NE-plane, using the positions from the config file
+   */
+  double get_distance_(const std::string& loc_from, const std::string& loc_to);
+
+
+  /**
+   * @brief Predicted makespan of @p plan, as the end time of the last action
+   */
+  double get_plan_makespan_(const plansys2_msgs::msg::Plan& plan);
+
 
   /**
    * @brief Updates all plansys2::Goal using the goal-strings included in @p goals
@@ -274,6 +734,13 @@ private:
   size_t get_num_remaining_mission_goals_();
 
 
+  /**
+   * @brief Removes the remaining mission goals which the current knowledge already achieves, such
+   * as (not_marked p1 loc) when (marked p1 loc) holds. Returns the number of removed goals
+   */
+  size_t remove_satisfied_mission_goals_();
+
+
   /**
    * @brief Checks whether one of the final states are achieved. This includes whether the landing
    * state matches the desired landing state, and whether the location matches the desired location 
@@ -315,15 +782,49 @@ private:
   );
 
 
+  /**
+   * @brief Relaxes the mission goals in a single search of the native planner, where the constant
+   * subgoals are hard goals and the relaxable subgoals are soft goals. The utility of a soft goal
+   * is given by its predicate, and for a person by the severity
+   * 
+   * @param constant_subgoals   [in]  Vector of subgoals which cannot be relaxed
+   * @param relaxable_subgoals  [in]  Vector of the initial subgoals which are allowed to be relaxed
+   * @param valid_subgoals      [out] Vector of the subgoals achieved by the plan
+   * @param valid_plan          [out] Plan achieving the constant and the valid subgoals
+   * @return false if the native planner is unavailable, or found no plan for the constant subgoals
+   */
+  bool relax_mission_goals_with_soft_goals_(
+    const std::vector<std::string>& constant_subgoals,
+    const std::vector<std::string>& relaxable_subgoals, 
+    std::vector<std::string>& valid_subgoals,
+    std::optional<plansys2_msgs::msg::Plan>& valid_plan
+  );
+  double get_soft_goal_utility_(const PddlAtom& goal);
+
+
+  /**
+   * @brief Projects the problems which the next replan is likely to solve, and hands them to the
+   * speculative planner. The events are a person detected at the current location with each
+   * severity, an emergency, and the next location of the plan becoming unavailable. The problems
+   * are only projected again when the controller state, the location or the knowledge has changed
+   */
+  void speculate_next_events_();
+
+
   /**
    * @brief Checks if the entire plan is completed 
    */
   bool check_plan_completed_();  
 
   /**
-   * @brief Checks whether the current goals  
+   * @brief Checks the goals against the mirrored knowledge, such that goals which already hold in
+   * the current state, or which no plan can reach, do not cost a planner call
+   * 
+   * @param goals               [in]  The goals as given to update_plansys2_goals_()
+   * @param unreachable_goals   [out] The goals which no plan can achieve, if UNREACHABLE
+   * @return OPEN if the goals must be planned for, or could not be checked
    */
-  bool check_current_goals_satisfied_(const ControllerState& state);
+  GoalStatus check_current_goals_(const std::vector<std::string>& goals, std::vector<std::string>& unreachable_goals);
 
 
   /**
@@ -347,6 +848,13 @@ private:
   std::vector<int> get_people_within_radius_of_(const geometry_msgs::msg::Point& point, double radius);
 
 
+  /**
+   * @brief Adds a newly confirmed person with ID @p idx to the planning problem, together with
+   * the goals required by the @p severity. Triggers a replan to rescue-state
+   */
+  void add_detected_person_(int idx, const geometry_msgs::msg::Point& position, Severity severity);
+
+
   /**
    * @brief Output data to either terminal or via publishers.
    * 
@@ -355,6 +863,7 @@ private:
    *  log_plan_():          Logs the new plan
    *  log_action_error_():  Logs error during execution of an action
    *  log_relaxed_goals_(): Logs the results from relaxing the goals
+   *  log_makespan_():      Logs the predicted and actual makespan of a completed plan
    * 
    * Print-functions output information using std::cout to the terminal. Warning: spam
    * 
@@ -368,11 +877,23 @@ private:
     const std::vector<std::string>& relaxable_goals, 
     const std::vector<std::string>& valid_goals
   );
+  void log_makespan_(double makespan_error_s);
 
-  void print_action_feedback_();
+  /**
+   * @brief Writes to the problem expert, mirrored in the local knowledge base
+   */
+  bool add_instance_(const std::string& name, const std::string& type);
+  bool add_predicate_(const std::string& predicate_str);
+  bool remove_predicate_(const std::string& predicate_str);
+  bool add_function_(const std::string& function_str);
+  bool set_goal_(const std::string& goal_str);
+  void clear_goal_();
+  void clear_knowledge_();
 
   void publish_plan_status_str_(const std::string& str);
   void publish_plansys2_plan_(const std::optional<plansys2_msgs::msg::Plan>& plan);
+  void publish_replan_statistics_(double hover_time_lost_s);
+  void publish_execution_feedback_();
 
 
   // Callbacks
@@ -382,8 +903,11 @@ private:
   void attitude_cb_(geometry_msgs::msg::QuaternionStamped::ConstSharedPtr attitude_msg);
   void polled_vel_cb_(geometry_msgs::msg::TwistStamped::ConstSharedPtr vel_msg);
   void battery_charge_cb_(std_msgs::msg::Float64::ConstSharedPtr battery_msg);
-  void detected_person_cb_(anafi_uav_interfaces::msg::DetectedPerson::ConstSharedPtr detected_person_msg);
+  void person_tracks_cb_(anafi_uav_interfaces::msg::PersonTrackArray::ConstSharedPtr person_tracks_msg);
   void emergency_occured_cb_(std_msgs::msg::Empty::ConstSharedPtr emergency_msg);
+  void search_distance_cb_(std_msgs::msg::Float64::ConstSharedPtr search_distance_msg);
+  void knowledge_cb_(plansys2_msgs::msg::Knowledge::ConstSharedPtr knowledge_msg);
+  void action_completion_cb_(anafi_uav_interfaces::msg::ActionCompletion::ConstSharedPtr completion_msg);
 
   void set_num_markers_srv_cb_(
     const std::shared_ptr<anafi_uav_interfaces::srv::SetEquipmentNumbers::Request> request,
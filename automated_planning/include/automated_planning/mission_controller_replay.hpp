@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialized_message.hpp"
+
+#include "automated_planning/mission_controller.hpp"
+#include "automated_planning/telemetry_log.hpp"
+
+
+/**
+ * @brief Feeds a telemetry log recorded by the mission controller back into a controller
+ *
+ * The records are dispatched in the recorded order with the node clock set to the recorded
+ * stamps. The inputs are queued as when they were received, and applied at the next recorded
+ * step or precondition check, as by the recorded controller. The topic and service inputs thereby
+ * reach the controller in the same order and at the same steps, independent of the middleware
+ *
+ * The replay is not deterministic: PlanSys2 is queried live, and must be running with the same
+ * domain and mission parameters, and its plans and timing may differ from the recorded run. The
+ * speculative planner is disabled, as its background thread would race with the steps
+ */
+class MissionControllerReplay
+{
+public:
+  MissionControllerReplay(std::shared_ptr<MissionControllerNode> node, const std::string& log_path)
+  : node_(node)
+  , reader_(log_path)
+  , is_initialized_(false)
+  , num_records_(0)
+  {
+    // The replayed controller must not record the replay
+    node_->telemetry_log_.reset();
+    node_->set_parameter(rclcpp::Parameter("planner.speculation.enabled", false));
+
+    rcl_clock_t* clock_handle = node_->get_clock()->get_clock_handle();
+    if(rcl_enable_ros_time_override(clock_handle) != RCL_RET_OK)
+    {
+      throw std::runtime_error("Could not override the clock of the mission controller");
+    }
+  }
+
+  /**
+   * @brief Replays the entire log. With @p real_time the records are dispatched at the recorded
+   * pace, otherwise as fast as possible
+   */
+  void run(bool real_time);
+
+  /**
+   * @brief Summary of the wall time spent in step(), and the number of replayed records
+   */
+  std::string get_summary() const;
+
+private:
+  std::shared_ptr<MissionControllerNode> node_;
+  TelemetryLogReader reader_;
+
+  bool is_initialized_;
+  size_t num_records_;
+  std::vector<double> step_durations_s_;
+
+  void dispatch_(const TelemetryRecord& record);
+
+  /**
+   * @brief Queues the input of @p record for the next step, as the recorded controller did
+   */
+  template<typename MsgT, typename CallbackT>
+  void defer_(const TelemetryRecord& record, CallbackT callback)
+  {
+    std::shared_ptr<MsgT> msg = deserialize_<MsgT>(record);
+    node_->defer_input_([this, msg, callback]() { ((*node_).*callback)(msg); });
+  }
+
+  template<typename MsgT>
+  std::shared_ptr<MsgT> deserialize_(const TelemetryRecord& record)
+  {
+    rclcpp::SerializedMessage serialized_msg(record.size);
+    rcl_serialized_message_t& rcl_serialized_msg = serialized_msg.get_rcl_serialized_message();
+    std::memcpy(rcl_serialized_msg.buffer, record.data, record.size);
+    rcl_serialized_msg.buffer_length = record.size;
+
+    std::shared_ptr<MsgT> msg = std::make_shared<MsgT>();
+    rclcpp::Serialization<MsgT> serialization;
+    serialization.deserialize_message(&serialized_msg, msg.get());
+    return msg;
+  }
+};
@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <optional>
 #include <algorithm>
 #include <math.h>
 #include <string>
@@ -29,6 +30,10 @@
 
 #include "plansys2_executor/ActionExecutorClient.hpp"
 
+#include "automated_planning/action_activation_monitor.hpp"
+#include "automated_planning/action_await.hpp"
+#include "automated_planning/adaptive_action_executor_client.hpp"
+
 #include "anafi_uav_interfaces/msg/move_by_command.hpp"
 #include "anafi_uav_interfaces/msg/move_to_command.hpp"
 #include "anafi_uav_interfaces/msg/ekf_output.hpp"
@@ -36,14 +41,30 @@
 using namespace std::chrono_literals;
 using LifecycleNodeInterface = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface;
 
-enum class MoveState{ HOVER, MOVE };
+enum class MoveState{ PRECONDITIONS, HOVER, MOVE };
+
+
+/**
+ * @brief State of one activation of the move-action, created on activation and destroyed on
+ * deactivation. Resumed by do_work()
+ */
+struct MoveActivation
+{
+  MoveState state{ MoveState::PRECONDITIONS };
+
+  // Preconditions may not be satisfied immediately, due to race-conditions during activation
+  ConditionAwaiter preconditions{ 1.25 };
+
+  // The drone must hover for some time before a new move-command is transmitted, such that the
+  // commands are not sent too frequently
+  PeriodAwaiter move_command{ 2.5 };
+};
 
-class MoveActionNode : public plansys2::ActionExecutorClient
+class MoveActionNode : public AdaptiveActionExecutorClient
 {
 public:
   MoveActionNode() 
-  : plansys2::ActionExecutorClient("move_node", 250ms)
-  , move_state_(MoveState::HOVER)
+  : AdaptiveActionExecutorClient("move_node", 250ms)
   , start_distance_(1)          // Initialize as non-zero to prevent div by 0
   {
     /**
@@ -88,16 +109,19 @@ public:
       "/anafi/ned_pos_from_gnss", rclcpp::QoS(1).best_effort(), std::bind(&MoveActionNode::ned_pos_cb_, this, _1));    
     polled_vel_sub_ = this->create_subscription<geometry_msgs::msg::TwistStamped>(
       "/anafi/polled_body_velocities", rclcpp::QoS(1).best_effort(), std::bind(&MoveActionNode::polled_vel_cb_, this, _1));   
+
+    activation_monitor_ = std::make_unique<ActionActivationMonitor>(this);
   }
 
   // Lifecycle-events
+  LifecycleNodeInterface::CallbackReturn on_configure(const rclcpp_lifecycle::State &);
   LifecycleNodeInterface::CallbackReturn on_activate(const rclcpp_lifecycle::State &);
   LifecycleNodeInterface::CallbackReturn on_deactivate(const rclcpp_lifecycle::State &);
 
 
 private:
   // State 
-  MoveState move_state_;
+  std::optional<MoveActivation> activation_;
 
   double start_distance_;
   double radius_of_acceptance_;
@@ -127,6 +151,8 @@ private:
   rclcpp::Subscription<geometry_msgs::msg::QuaternionStamped>::ConstSharedPtr attitude_sub_;
   rclcpp::Subscription<geometry_msgs::msg::TwistStamped>::ConstSharedPtr polled_vel_sub_;
 
+  std::unique_ptr<ActionActivationMonitor> activation_monitor_;
+
 
   // Private functions
   /**
@@ -139,7 +165,8 @@ private:
    * @brief Overload of function in ActionExecutorClient. This function does the 
    * majority of the work when the node is activated. 
    * 
-   * The function is called at the same frequency as the node, and is responsible for
+   * The function is called at tick.active_rate, and when the position or the state of the drone
+   * changes. It resumes activation_, and is responsible for
    *    - Checks whether the drone is moving
    *      - if yes: 
    *        - Check distance to goal and successfully terminate if reached 
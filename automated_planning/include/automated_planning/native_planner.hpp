@@ -0,0 +1,262 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "automated_planning/execution_feedback_aggregator.hpp"
+#include "automated_planning/numeric_program.hpp"
+#include "automated_planning/pddl_domain.hpp"
+
+
+struct NativePlannerStatistics
+{
+  bool is_grounding_reused{ false };
+  size_t num_ground_actions{ 0 };
+  size_t num_reachable_actions{ 0 };      // Reachable from the initial state when delete effects are ignored
+  size_t num_facts{ 0 };
+  std::optional<size_t> initial_heuristic;   // Empty if the goal is unreachable when delete effects are ignored
+  size_t num_expanded{ 0 };
+  size_t num_generated{ 0 };
+  bool is_solved_by_hill_climbing{ false };
+  size_t num_soft_goals{ 0 };
+  size_t num_reachable_soft_goals{ 0 };   // Reachable from the initial state when delete effects are ignored
+  size_t num_achieved_soft_goals{ 0 };
+  double achieved_utility{ 0.0 };
+  double grounding_duration_s{ 0.0 };
+  double search_duration_s{ 0.0 };
+
+  std::string to_string() const;
+};
+
+
+/**
+ * @brief Goal which is achieved by the plan if possible, such as searching an area or marking a
+ * person. The plan maximizes the sum of the utilities of the achieved soft goals
+ */
+struct SoftGoal
+{
+  PddlAtom predicate;
+  double utility;
+};
+
+
+/**
+ * @brief Forward-search planner for the subset of PDDL parsed by PddlDomain, which runs in the
+ * process of the caller instead of through the PlanSys2 planner node and an external planner
+ *
+ * The durative actions are compressed, such that each action is applied as its start and end
+ * events back to back. The over all and at end-conditions are checked after the start effects.
+ * The plan is sequential, with each action starting 1 ms after the previous has ended, as POPF
+ * separates dependent actions. This is sufficient for the SAR-domains, where the not_* predicates
+ * prevent the single drone from executing actions concurrently, but not for domains which require
+ * concurrent actions
+ *
+ * The search is enforced hill-climbing with the FF-heuristic: the length of a relaxed plan which
+ * ignores the delete effects and the numeric conditions. If hill-climbing gets stuck, the search
+ * falls back to greedy best-first search. The numeric conditions and effects, such as the battery
+ * charge, are applied exactly to the states of the search
+ *
+ * The grounding only depends on the objects and the static predicates, which are never changed by
+ * the actions. It is kept between the calls, and reused as long as these have not changed. The
+ * functions, such as the durations estimated online, are only compiled into the ground actions
+ *
+ * With soft goals, the soft goals which are unreachable when delete effects are ignored are dropped
+ * exactly. Hill-climbing then pursues the hard goals with the remaining soft goals, and drops the
+ * soft goal with the lowest utility whenever it gets stuck. The oversubscribed problem is thereby
+ * solved in one call with one grounding, and usually in a single search
+ */
+class NativePlanner
+{
+public:
+  /**
+   * @param max_expansions  The search is stopped after expanding this many states
+   * @param timeout_s       [s] The search is stopped after this duration
+   */
+  explicit NativePlanner(std::shared_ptr<const PddlDomain> domain, size_t max_expansions=200000, double timeout_s=10.0);
+
+  /**
+   * @brief Plans from the initial state to the goal of the problem. Throws std::runtime_error if
+   * the problem uses objects, predicates or functions which do not match the domain
+   *
+   * @return std::nullopt if no plan was found within the limits
+   */
+  std::optional<std::vector<PlannedAction>> solve(const PddlProblem& problem);
+
+  /**
+   * @brief Plans from the initial state to the goal of the problem, which is hard, achieving the
+   * soft goals with the highest total utility found within the limits
+   *
+   * @return std::nullopt if no plan to the hard goals was found within the limits
+   */
+  std::optional<std::vector<PlannedAction>> solve(const PddlProblem& problem, const std::vector<SoftGoal>& soft_goals);
+
+  /**
+   * @brief Whether each of the soft goals of the last solve is achieved by the plan
+   */
+  const std::vector<bool>& get_achieved_soft_goals() const { return achieved_soft_goals_; }
+
+  const NativePlannerStatistics& get_statistics() const { return statistics_; }
+
+private:
+  static constexpr uint32_t UNREACHED = UINT32_MAX;
+
+  struct Comparison
+  {
+    Comparator comparator;
+    NumericProgram lhs;
+    NumericProgram rhs;
+  };
+
+  struct NumericEffect
+  {
+    PddlEffect::Type type;
+    uint32_t slot;
+    NumericProgram value;
+  };
+
+  struct GroundAction
+  {
+    DurativeAction action;
+
+    std::vector<uint32_t> start_positive;
+    std::vector<uint32_t> start_negative;
+    std::vector<uint32_t> later_positive;           // Over all and at end, after the start effects
+    std::vector<uint32_t> later_negative;
+    std::vector<uint32_t> start_add;
+    std::vector<uint32_t> start_delete;
+    std::vector<uint32_t> end_add;
+    std::vector<uint32_t> end_delete;
+
+    std::vector<uint32_t> relaxed_preconditions;
+    std::vector<uint32_t> relaxed_effects;
+
+    // Compiled for each problem, since they depend on the values of the static functions
+    bool is_defined{ true };
+    NumericProgram duration;
+    std::vector<Comparison> start_comparisons;
+    std::vector<Comparison> later_comparisons;
+    std::vector<NumericEffect> start_effects;
+    std::vector<NumericEffect> end_effects;
+  };
+
+  // Facts as a bitset, and the functions changed by the actions, NaN if undefined
+  struct SearchNode
+  {
+    std::vector<uint64_t> facts;
+    std::vector<double> values;
+    size_t parent;
+    uint32_t action;
+    double duration_s;
+    double time_s;                  // [s] End of the sequential plan to the node
+  };
+
+  // The values are ignored by the hill-climbing, where the first state reached breadth-first with
+  // some facts has used the least resources
+  struct NodeHash
+  {
+    const std::vector<SearchNode>* nodes;
+    bool is_values_ignored;
+    size_t operator()(size_t idx) const;
+  };
+
+  struct NodeEqual
+  {
+    const std::vector<SearchNode>* nodes;
+    bool is_values_ignored;
+    bool operator()(size_t a, size_t b) const;
+  };
+
+  using VisitedSet = std::unordered_set<size_t, NodeHash, NodeEqual>;
+
+  std::shared_ptr<const PddlDomain> domain_;
+  size_t max_expansions_;
+  double timeout_s_;
+  std::unordered_set<std::string> fluent_names_;      // Predicates and functions changed by the actions
+
+  // Grounding, reused while the key is unchanged
+  std::string grounding_key_;
+  std::vector<GroundAction> ground_actions_;
+  std::unordered_map<std::string, uint32_t> fact_indices_;
+  std::unordered_map<std::string, uint32_t> function_slots_;
+  std::vector<std::vector<uint32_t>> precondition_of_;
+  std::vector<uint32_t> actions_without_preconditions_;
+
+  // Goal of the current problem
+  std::vector<uint32_t> goal_positive_;
+  std::vector<uint32_t> goal_negative_;
+  std::vector<Comparison> goal_comparisons_;
+  std::vector<uint32_t> soft_goal_facts_;
+  std::vector<double> soft_goal_utilities_;
+  std::vector<bool> achieved_soft_goals_;
+
+  // Buffers of the heuristic
+  std::vector<uint32_t> fact_layers_;
+  std::vector<uint32_t> fact_supporters_;
+  std::vector<uint32_t> fact_queue_;
+  std::vector<uint32_t> remaining_preconditions_;
+  std::vector<bool> is_in_relaxed_plan_;
+
+  NativePlannerStatistics statistics_;
+  std::chrono::steady_clock::time_point search_start_time_;
+
+  void ground_(const PddlProblem& problem);
+
+  /**
+   * @brief Compiles the numeric parts of the ground actions and the goals with the static functions
+   * of the problem. Returns false if the goal uses an undefined function
+   */
+  bool compile_problem_(const PddlProblem& problem, const std::vector<SoftGoal>& soft_goals);
+  uint32_t get_fact_(const PddlAtom& predicate);
+
+  bool is_goal_(const SearchNode& node) const;
+
+  /**
+   * @brief Breadth-first search from the current state until a state with a lower heuristic is
+   * found, repeated from that state until the goal is reached
+   *
+   * @return The goal node, or std::nullopt if a plateau could not be left
+   */
+  std::optional<size_t> enforced_hill_climbing_(std::vector<SearchNode>& nodes, uint32_t initial_heuristic);
+
+  /**
+   * @return The goal node, or std::nullopt if no plan was found within the limits
+   */
+  std::optional<size_t> greedy_best_first_search_(std::vector<SearchNode>& nodes, uint32_t initial_heuristic);
+
+  /**
+   * @brief Enforced hill-climbing to the hard goals and the soft goals which are reachable when
+   * delete effects are ignored. Whenever it gets stuck, the pursued soft goal with the lowest
+   * utility is dropped, and hill-climbing restarts from the initial state with the grounding and
+   * the states already generated. Falls back to best-first search for the hard goals only
+   *
+   * @return The goal node, or std::nullopt if no plan was found within the limits
+   */
+  std::optional<size_t> enforced_hill_climbing_with_soft_goals_(std::vector<SearchNode>& nodes);
+
+  /**
+   * @brief Adds the successors of the node which are not in @p visited to @p nodes, and calls
+   * @p on_successor for each of them. Stops when @p on_successor returns false
+   */
+  void expand_(size_t node_idx, std::vector<SearchNode>& nodes, VisitedSet& visited, const std::function<bool(size_t)>& on_successor);
+
+  bool is_limit_reached_() const;
+  std::vector<PlannedAction> extract_plan_(const std::vector<SearchNode>& nodes, size_t node_idx) const;
+
+  /**
+   * @brief Applies the action to the state of the node, if it is applicable
+   */
+  bool apply_(const GroundAction& action, const SearchNode& node, SearchNode& successor) const;
+
+  /**
+   * @brief The FF-heuristic, or UNREACHED if the goal cannot be reached in the relaxed problem
+   */
+  uint32_t compute_heuristic_(const std::vector<uint64_t>& facts);
+};
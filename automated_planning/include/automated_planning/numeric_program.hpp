@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "automated_planning/pddl_domain.hpp"
+
+
+/**
+ * @brief Numeric expression compiled to a postfix program over function slots, such that it can be
+ * evaluated without any lookups of the functions by name
+ */
+struct NumericProgram
+{
+  enum class OpCode : uint8_t { PUSH_NUMBER, PUSH_FUNCTION, PUSH_DURATION, ADD, SUBTRACT, MULTIPLY, DIVIDE };
+
+  struct Instruction
+  {
+    OpCode op;
+    uint32_t slot;              // PUSH_FUNCTION
+    double value;               // PUSH_NUMBER
+  };
+
+  static constexpr size_t MAX_STACK_SIZE = 16;
+
+  std::vector<Instruction> instructions;
+
+  /**
+   * @brief Compiles the expression, with the operations on constants folded. Throws
+   * std::runtime_error if the expression is nested too deeply
+   *
+   * @param resolve_function  Instruction which loads a ground function: PUSH_FUNCTION with the
+   *                          slot of the function, or PUSH_NUMBER if the function is constant
+   */
+  static NumericProgram compile(
+    const NumericExpression& expression,
+    const std::function<Instruction(const PddlAtom&)>& resolve_function);
+
+  bool is_constant() const { return instructions.size() == 1 && instructions[0].op == OpCode::PUSH_NUMBER; }
+
+  /**
+   * @brief Runs the program. Returns false if a function is undefined
+   *
+   * @param values      Value of each function slot
+   * @param is_defined  Whether each function slot is defined
+   */
+  template<typename Values, typename IsDefined>
+  bool evaluate(const Values& values, const IsDefined& is_defined, double duration_s, double& result) const
+  {
+    std::array<double, MAX_STACK_SIZE> stack;
+    size_t size = 0;
+    for(const Instruction& instruction : instructions)
+    {
+      switch(instruction.op)
+      {
+        case OpCode::PUSH_NUMBER:
+          stack[size++] = instruction.value;
+          break;
+        case OpCode::PUSH_FUNCTION:
+          if(! is_defined[instruction.slot])
+          {
+            return false;
+          }
+          stack[size++] = values[instruction.slot];
+          break;
+        case OpCode::PUSH_DURATION:
+          stack[size++] = duration_s;
+          break;
+        case OpCode::ADD:
+          size--;
+          stack[size - 1] += stack[size];
+          break;
+        case OpCode::SUBTRACT:
+          size--;
+          stack[size - 1] -= stack[size];
+          break;
+        case OpCode::MULTIPLY:
+          size--;
+          stack[size - 1] *= stack[size];
+          break;
+        case OpCode::DIVIDE:
+          size--;
+          stack[size - 1] /= stack[size];
+          break;
+      }
+    }
+    result = stack[0];
+    return true;
+  }
+};
+
+
+/**
+ * @brief Compares two values as a numeric PDDL-condition
+ */
+inline bool compare(Comparator comparator, double lhs, double rhs)
+{
+  switch(comparator)
+  {
+    case Comparator::LESS:
+      return lhs < rhs;
+    case Comparator::LESS_OR_EQUAL:
+      return lhs <= rhs;
+    case Comparator::EQUAL:
+      return std::abs(lhs - rhs) < 1e-9;
+    case Comparator::GREATER_OR_EQUAL:
+      return lhs >= rhs;
+    case Comparator::GREATER:
+      return lhs > rhs;
+  }
+  return false;
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "automated_planning/knowledge_mirror.hpp"
+
+
+struct PddlProblem;
+
+/**
+ * @brief Numeric expression over PDDL-functions, for example
+ *    (* (move_battery_usage ?d) (move_duration ?loc_from ?loc_to))
+ */
+struct NumericExpression
+{
+  enum class Type { NUMBER, FUNCTION, DURATION, ADD, SUBTRACT, MULTIPLY, DIVIDE };
+
+  Type type{ Type::NUMBER };
+  double value{ 0.0 };                        // NUMBER
+  PddlAtom function;                          // FUNCTION
+  std::vector<NumericExpression> operands;    // ADD, SUBTRACT, MULTIPLY, DIVIDE
+
+  /**
+   * @brief Evaluates the expression
+   *
+   * @param function_value  Value of a grounded function, or std::nullopt if it is not defined
+   * @param duration        [s] Value of ?duration
+   * @return std::nullopt if any of the functions is undefined
+   */
+  std::optional<double> evaluate(
+    const std::function<std::optional<double>(const PddlAtom&)>& function_value,
+    double duration=0.0) const;
+
+  /**
+   * @brief Appends the functions used by the expression to @p functions
+   */
+  void collect_functions(std::vector<PddlAtom>& functions) const;
+
+  std::string to_string() const;
+};
+
+
+enum class Comparator { LESS, LESS_OR_EQUAL, EQUAL, GREATER_OR_EQUAL, GREATER };
+
+
+struct PddlCondition
+{
+  enum class Type { PREDICATE, NEGATED_PREDICATE, COMPARISON };
+
+  Type type{ Type::PREDICATE };
+  PddlAtom predicate;                 // PREDICATE, NEGATED_PREDICATE
+  Comparator comparator{ Comparator::EQUAL };
+  NumericExpression lhs;              // COMPARISON
+  NumericExpression rhs;
+
+  std::string to_string() const;
+};
+
+
+struct PddlEffect
+{
+  enum class Type { ADD, DELETE, INCREASE, DECREASE, ASSIGN };
+
+  Type type{ Type::ADD };
+  PddlAtom atom;                      // Predicate for ADD and DELETE, otherwise the function
+  NumericExpression value;            // INCREASE, DECREASE, ASSIGN
+
+  std::string to_string() const;
+};
+
+
+/**
+ * @brief A durative action, either lifted as in the domain with the parameters as arguments,
+ * or grounded for a plan item
+ */
+struct DurativeAction
+{
+  std::string name;
+  std::vector<std::string> parameters;        // Lifted: "?d". Grounded: the objects
+  std::vector<std::string> parameter_types;
+  NumericExpression duration;
+
+  std::vector<PddlCondition> at_start_conditions;
+  std::vector<PddlCondition> over_all_conditions;
+  std::vector<PddlCondition> at_end_conditions;
+  std::vector<PddlEffect> at_start_effects;
+  std::vector<PddlEffect> at_end_effects;
+
+  /**
+   * @brief The action on the form used by the plan items, (name arg_0 arg_1 ...)
+   */
+  std::string to_string() const;
+};
+
+
+/**
+ * @brief The durative actions of a PDDL-domain, parsed from the domain string such that the
+ * plans can be analysed without calls to the domain expert
+ *
+ * Supports the subset used by the SAR-domains: conjunctions of (negated) predicates and numeric
+ * comparisons as conditions, and add, delete, increase, decrease and assign as effects
+ */
+class PddlDomain
+{
+public:
+  /**
+   * @brief Parses the domain. Throws std::runtime_error if the domain is malformed or uses
+   * unsupported constructs
+   */
+  static PddlDomain parse(const std::string& domain_str);
+
+  const std::string& get_name() const { return name_; }
+  const std::vector<DurativeAction>& get_actions() const { return actions_; }
+  const DurativeAction* find_action(const std::string& name) const;
+
+  /**
+   * @brief Grounds the action of a plan item, on the form (name arg_0 arg_1 ...)
+   *
+   * @return std::nullopt if the action is unknown or has the wrong number of arguments
+   */
+  std::optional<DurativeAction> ground(const std::string& action) const;
+
+  /**
+   * @brief Whether any action changes the predicate or function @p name. Static predicates,
+   * like path and can_land, are only changed by the mission controller
+   */
+  bool is_modified_by_actions(const std::string& name) const;
+
+  /**
+   * @brief Whether an object of type @p type can be used as a parameter of type @p parameter_type,
+   * following the type hierarchy of the domain
+   */
+  bool is_of_type(const std::string& type, const std::string& parameter_type) const;
+
+  /**
+   * @brief Calls @p on_action with every grounding of the actions over the objects of the
+   * problem, except those where a static condition does not hold in the initial state
+   */
+  void ground_actions(const PddlProblem& problem, const std::function<void(DurativeAction&&)>& on_action) const;
+
+private:
+  std::string name_;
+  std::map<std::string, std::string> supertypes_;
+  std::vector<DurativeAction> actions_;
+};
+
+
+/**
+ * @brief A PDDL-problem, as written by the problem expert or stored in pddl/problems
+ *
+ * The goal is a conjunction of the supported conditions
+ */
+struct PddlProblem
+{
+  std::string name;
+  std::string domain_name;
+  std::vector<std::pair<std::string, std::string>> objects;     // Name and type
+  std::vector<PddlAtom> predicates;
+  std::vector<std::pair<PddlAtom, double>> functions;
+  std::vector<PddlCondition> goals;
+
+  /**
+   * @brief Parses the problem. Throws std::runtime_error if the problem is malformed or uses
+   * unsupported constructs
+   */
+  static PddlProblem parse(const std::string& problem_str);
+
+  /**
+   * @brief The problem as PDDL, which can be given to the PlanSys2 planner
+   */
+  std::string to_string() const;
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "Eigen/Dense"
+
+
+/**
+ * @brief Parameters for the person tracker. The default values are based on an expected
+ * detection error of roughly 0.5 meters, and people drifting slowly at sea
+ */
+struct PersonTrackerParameters
+{
+  double measurement_std{ 0.5 };            // [m] Standard deviation of a single detection in north and east
+  double acceleration_std{ 0.05 };          // [m/s^2] Process noise of the constant velocity model
+  double initial_velocity_std{ 0.5 };       // [m/s] Initial uncertainty of the velocity
+  double gate_threshold{ 9.21 };            // Chi-squared gate on the Mahalanobis distance (99 %, 2 DOF)
+  double max_association_distance{ 2.5 };   // [m] Hard limit on the distance between a detection and a track
+  int confirmation_hits{ 3 };               // Number of associated detections before a track is confirmed
+  double tentative_timeout{ 2.0 };          // [s] Tentative tracks without detections for this long are removed
+  double max_coast_time{ 20.0 };            // [s] Tracks are predicted at most this long after their latest detection
+  uint32_t first_id{ 1 };                   // ID of the first track. The IDs of later tracks count up from it
+};
+
+
+/**
+ * @brief Constant velocity Kalman filter of a single person in the NE-plane. The altitude is
+ * not filtered, as people are assumed at the sea surface
+ */
+struct PersonTrack
+{
+  uint32_t id{ 0 };
+  uint8_t severity{ 0 };
+
+  Eigen::Vector4d x{ Eigen::Vector4d::Zero() };    // [north, east, v_north, v_east]
+  Eigen::Matrix4d P{ Eigen::Matrix4d::Identity() };
+  double down{ 0.0 };
+
+  int num_detections{ 0 };
+  bool confirmed{ false };
+
+  double last_detection_s{ 0.0 };   // Time of the last associated detection
+  double state_time_s{ 0.0 };       // Time the state is valid for
+};
+
+
+/**
+ * @brief Fuses raw person detections into tracks with stable IDs
+ *
+ * Each detection is associated with the closest track (in Mahalanobis distance) inside the
+ * gate, or starts a new tentative track. The tracks are indexed in a spatial hash with cells
+ * of size max_association_distance, by the position of their latest update. A track may have
+ * drifted from its cell since then, so the cells searched around a detection are widened by a
+ * bound on the drift of the tracks: the speed plus three standard deviations of the predicted
+ * position. Detections in bursts search the 3x3 neighbouring cells. A track is predicted at most
+ * max_coast_time after its latest detection, and is then assumed to stay where it is, such that
+ * the drift is bounded even though confirmed tracks are never removed. The association cost is
+ * therefore independent of the number of tracks. If fewer, the occupied cells are searched
+ * instead. Confirmed tracks are kept, as a person found is still in need of help after the drone
+ * has left the area
+ *
+ * The hard limit max_association_distance applies to the distance from the predicted position,
+ * widened by three times the growth of its standard deviation since the latest update
+ */
+class PersonTracker
+{
+public:
+  explicit PersonTracker(const PersonTrackerParameters& params=PersonTrackerParameters());
+
+
+  /**
+   * @brief Associates a detection at NED-position @p position_ned with a track, or creates a new
+   * track if no track is inside the gate
+   *
+   * @return ID of the track the detection was associated with
+   */
+  uint32_t add_detection(double time_s, const Eigen::Vector3d& position_ned, uint8_t severity);
+
+
+  /**
+   * @brief Removes tentative tracks without a detection the last tentative_timeout seconds
+   *
+   * @return Number of removed tracks
+   */
+  size_t remove_stale_tracks(double time_s);
+
+
+  /**
+   * @brief Returns the confirmed tracks sorted by ID, with the state predicted to @p time_s
+   */
+  std::vector<PersonTrack> get_confirmed_tracks(double time_s) const;
+
+  size_t get_num_tracks() const { return tracks_.size(); }
+
+private:
+  PersonTrackerParameters params_;
+  uint32_t next_id_;
+
+  std::unordered_map<uint32_t, PersonTrack> tracks_;
+
+  // Spatial hash of the tracks, indexed by the cell of the latest state
+  std::unordered_map<int64_t, std::vector<uint32_t>> cells_;
+  double cell_size_;
+
+  // Conservative bounds over all tracks, tightened by remove_stale_tracks()
+  double max_drift_speed_{ 0.0 };     // [m/s] Speed plus three standard deviations of the velocity
+  double min_state_time_s_{ std::numeric_limits<double>::infinity() };
+
+  int64_t get_cell_key_(int64_t north_idx, int64_t east_idx) const;
+  int64_t get_cell_key_(const Eigen::Vector4d& x) const;
+  void insert_in_cell_(uint32_t id, int64_t cell_key);
+  void remove_from_cell_(uint32_t id, int64_t cell_key);
+
+  /**
+   * @brief Extends the drift bounds with the latest state of @p track
+   */
+  void update_drift_bounds_(const PersonTrack& track);
+
+  /**
+   * @brief [m] Upper bound on the distance any track may have drifted from its cell at @p time_s,
+   * including three standard deviations of the growth of its position uncertainty
+   */
+  double get_max_drift_(double time_s) const;
+
+  /**
+   * @brief [m] Upper bound on the growth of the standard deviation of the position of @p track
+   * when predicted @p dt seconds ahead
+   */
+  double get_position_std_growth_(const PersonTrack& track, double dt) const;
+
+  /**
+   * @brief [s] Duration @p track is predicted when predicted to @p time_s, at most until
+   * max_coast_time after its latest detection
+   */
+  double get_coast_duration_(const PersonTrack& track, double time_s) const;
+
+  /**
+   * @brief Predicts the state of @p track to @p time_s. Detections older than the state are
+   * treated as simultaneous with the state
+   */
+  void predict_(PersonTrack& track, double time_s) const;
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <chrono>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/publisher.hpp"
+#include "rclcpp/subscription.hpp"
+#include "rclcpp/qos.hpp"
+
+#include "anafi_uav_interfaces/msg/detected_person.hpp"
+#include "anafi_uav_interfaces/msg/person_track.hpp"
+#include "anafi_uav_interfaces/msg/person_track_array.hpp"
+
+#include "automated_planning/person_tracker.hpp"
+
+using namespace std::chrono_literals;
+
+
+/**
+ * @brief Single tracking stage for the people detected by the perception. All downstream nodes
+ * (mission controller and action nodes) consume the confirmed tracks published by this node,
+ * instead of the raw detections, such that the IDs and positions are consistent between the nodes
+ */
+class PersonTrackerNode : public rclcpp::Node
+{
+public:
+  PersonTrackerNode()
+  : rclcpp::Node("person_tracker_node")
+  , tracks_changed_(false)
+  {
+    // Parameters
+    std::string tracker_prefix = "person_tracker.";
+    PersonTrackerParameters defaults;
+    this->declare_parameter(tracker_prefix + "publish_rate", 2.0);
+    this->declare_parameter(tracker_prefix + "measurement_std", defaults.measurement_std);
+    this->declare_parameter(tracker_prefix + "acceleration_std", defaults.acceleration_std);
+    this->declare_parameter(tracker_prefix + "gate_threshold", defaults.gate_threshold);
+    this->declare_parameter(tracker_prefix + "max_association_distance", defaults.max_association_distance);
+    this->declare_parameter(tracker_prefix + "confirmation_hits", defaults.confirmation_hits);
+    this->declare_parameter(tracker_prefix + "tentative_timeout", defaults.tentative_timeout);
+    this->declare_parameter(tracker_prefix + "max_coast_time", defaults.max_coast_time);
+    this->declare_parameter(tracker_prefix + "first_id", 0);
+
+    PersonTrackerParameters params;
+    params.measurement_std = this->get_parameter(tracker_prefix + "measurement_std").as_double();
+    params.acceleration_std = this->get_parameter(tracker_prefix + "acceleration_std").as_double();
+    params.gate_threshold = this->get_parameter(tracker_prefix + "gate_threshold").as_double();
+    params.max_association_distance = this->get_parameter(tracker_prefix + "max_association_distance").as_double();
+    params.confirmation_hits = this->get_parameter(tracker_prefix + "confirmation_hits").as_int();
+    params.tentative_timeout = this->get_parameter(tracker_prefix + "tentative_timeout").as_double();
+    params.max_coast_time = this->get_parameter(tracker_prefix + "max_coast_time").as_double();
+    params.first_id = static_cast<uint32_t>(this->get_parameter(tracker_prefix + "first_id").as_int());
+    if(params.first_id == 0)
+    {
+      // A restarted tracker must not give the IDs of the people found before the restart to 
+      // others, as a restarted controller restores them from its checkpoint. Each start gets a 
+      // range of 10000 IDs from the wall time, which repeats after 27 hours
+      const int64_t wall_time_s = static_cast<int64_t>(std::chrono::duration<double>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+      params.first_id = static_cast<uint32_t>((wall_time_s % 100000) * 10000 + 1);
+    }
+    tracker_ = std::make_unique<PersonTracker>(params);
+
+    double publish_rate = this->get_parameter(tracker_prefix + "publish_rate").as_double();
+    if(publish_rate <= 0)
+    {
+      throw std::invalid_argument("person_tracker.publish_rate must be positive");
+    }
+
+    // Publishers. Latched, such that nodes started late receive the people found
+    person_tracks_pub_ = this->create_publisher<anafi_uav_interfaces::msg::PersonTrackArray>(
+      "estimate/person_tracks", rclcpp::QoS(1).reliable().transient_local());
+
+    // Subscribers. Perception may publish several detections in a burst
+    using namespace std::placeholders;
+    detected_person_sub_ = this->create_subscription<anafi_uav_interfaces::msg::DetectedPerson>(
+      "estimate/detected_person", rclcpp::QoS(10).best_effort(), std::bind(&PersonTrackerNode::detected_person_cb_, this, _1));
+
+    // Timers
+    publish_timer_ = rclcpp::create_timer(this, this->get_clock(), 
+      rclcpp::Duration::from_seconds(1.0 / publish_rate), std::bind(&PersonTrackerNode::publish_timer_cb_, this));
+  }
+
+private:
+  std::unique_ptr<PersonTracker> tracker_;
+  bool tracks_changed_;
+
+  // Publishers
+  rclcpp::Publisher<anafi_uav_interfaces::msg::PersonTrackArray>::SharedPtr person_tracks_pub_;
+
+  // Subscribers
+  rclcpp::Subscription<anafi_uav_interfaces::msg::DetectedPerson>::ConstSharedPtr detected_person_sub_;
+
+  // Timers
+  rclcpp::TimerBase::SharedPtr publish_timer_;
+
+
+  // Callbacks
+  void detected_person_cb_(anafi_uav_interfaces::msg::DetectedPerson::ConstSharedPtr detected_person_msg);
+
+  /**
+   * @brief Publishes the confirmed tracks if any track has changed since the last publish.
+   * Limits the rate of the track list independent of the rate of the perception
+   */
+  void publish_timer_cb_();
+
+}; // PersonTrackerNode
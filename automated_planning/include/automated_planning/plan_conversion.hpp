@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+#include "plansys2_msgs/msg/plan.hpp"
+
+#include "automated_planning/execution_feedback_aggregator.hpp"
+
+
+/**
+ * @brief The plan items on the form used by the plan analysis, which does not depend on ROS
+ */
+inline std::vector<PlannedAction> to_planned_actions(const plansys2_msgs::msg::Plan& plan)
+{
+  std::vector<PlannedAction> planned_actions;
+  planned_actions.reserve(plan.items.size());
+  for(const plansys2_msgs::msg::PlanItem& plan_item : plan.items)
+  {
+    planned_actions.push_back({ plan_item.action, plan_item.time, plan_item.duration });
+  }
+  return planned_actions;
+}
+
+
+/**
+ * @brief The plan message executed by PlanSys2, from a plan which was not found by the PlanSys2
+ * planner
+ */
+inline plansys2_msgs::msg::Plan to_plan_msg(const std::vector<PlannedAction>& planned_actions)
+{
+  plansys2_msgs::msg::Plan plan;
+  plan.items.reserve(planned_actions.size());
+  for(const PlannedAction& planned_action : planned_actions)
+  {
+    plansys2_msgs::msg::PlanItem plan_item;
+    plan_item.time = planned_action.start_s;
+    plan_item.action = planned_action.action;
+    plan_item.duration = planned_action.duration_s;
+    plan.items.push_back(plan_item);
+  }
+  return plan;
+}
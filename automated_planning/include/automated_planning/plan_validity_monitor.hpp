@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "automated_planning/execution_feedback_aggregator.hpp"
+#include "automated_planning/knowledge_mirror.hpp"
+#include "automated_planning/pddl_domain.hpp"
+
+
+/**
+ * @brief A condition of the remaining plan which does not hold
+ */
+struct PlanViolation
+{
+  size_t action_idx;          // Index in the monitored plan
+  std::string action;         // (action arg_0 arg_1 ...)
+  std::string condition;
+  bool is_telemetry;          // Caused by telemetry contradicting the problem, rather than the knowledge itself
+
+  std::string to_string() const;
+};
+
+
+/**
+ * @brief Watches the conditions of the remaining plan, such that a plan which can no longer
+ * succeed is detected before one of its actions fails
+ *
+ * The conditions and effects of each plan item are compiled from the domain when the plan is
+ * started. The remaining plan is projected from the mirrored knowledge, where telemetry may
+ * override functions (the battery charge) and retract predicates (a drone which has drifted away
+ * from its location). Executing actions must keep their over all-conditions, and the actions
+ * which have not started must have their conditions satisfied in the state reached by the
+ * actions before them. The actions are projected sequentially in the order of the planned start
+ *
+ * The projection is only recomputed when the knowledge, the telemetry or the plan progress has
+ * changed. The progress is sampled at a lower rate than the knowledge is updated, so a violation
+ * which may be explained by an action that has just started or finished is only reported if it
+ * remains after the next progress update
+ *
+ * Violations of the knowledge found by the first check of a plan are not reported, but kept as the
+ * baseline of the plan. The plan was made from the same knowledge, so these are caused by the
+ * sequential approximation of concurrent actions, and a replan would not remove them. Violations
+ * caused by the telemetry are never part of the baseline, as the planner did not see the telemetry
+ */
+class PlanValidityMonitor
+{
+public:
+  explicit PlanValidityMonitor(std::shared_ptr<const PddlDomain> domain);
+
+  /**
+   * @brief Compiles the watched conditions of a new plan, with the actions as tracked by the
+   * ExecutionFeedbackAggregator
+   */
+  void start_plan(const std::vector<ActionTiming>& actions);
+  void stop_plan();
+  bool is_plan_started() const { return is_plan_started_; }
+
+  /**
+   * @brief Updates the status of the actions. Must be the same action list as the plan was
+   * started with
+   */
+  void update_progress(const std::vector<ActionTiming>& actions);
+
+  /**
+   * @brief Replaces the value of the function @p function, on the form (name args), with telemetry
+   */
+  void set_function_override(const std::string& function, double value);
+
+  /**
+   * @brief Predicates which may be true in the problem, but are contradicted by the telemetry
+   */
+  void set_retracted_predicates(const std::vector<std::string>& predicates);
+
+  /**
+   * @brief Checks the remaining plan against the knowledge
+   *
+   * @return The violations which are reported. Empty if the remaining plan is valid
+   */
+  const std::vector<PlanViolation>& check(const KnowledgeMirror& knowledge);
+
+  /**
+   * @brief Plan items which could not be grounded in the domain, and are therefore not monitored
+   */
+  const std::vector<std::string>& get_unmonitored_actions() const { return unmonitored_actions_; }
+
+  /**
+   * @brief Violations of the knowledge which were present when the plan was started, and are
+   * never reported
+   */
+  const std::vector<PlanViolation>& get_baseline_violations() const { return baseline_violations_; }
+
+  std::string get_statistics_string() const;
+
+private:
+  struct MonitoredAction
+  {
+    std::optional<DurativeAction> action;   // Empty if the plan item could not be grounded
+    std::string action_str;
+    double planned_duration_s;
+    ActionStatus status;
+    double completion;
+  };
+
+  // Predicates and functions changed by the projected actions, on top of the knowledge
+  struct ProjectedState
+  {
+    std::unordered_map<std::string, bool> predicates;
+    std::unordered_map<std::string, double> functions;
+  };
+
+  enum class ConditionResult { SATISFIED, VIOLATED, RETRACTED, UNKNOWN };
+
+  std::shared_ptr<const PddlDomain> domain_;
+
+  bool is_plan_started_;
+  std::vector<MonitoredAction> actions_;
+  std::vector<std::string> unmonitored_actions_;
+
+  std::map<std::string, double> function_overrides_;
+  std::set<std::string> retracted_predicates_;
+
+  // Change detection
+  bool is_dirty_;
+  size_t knowledge_version_;
+  size_t progress_version_;
+
+  std::vector<PlanViolation> violations_;
+  std::map<std::string, size_t> suspected_violations_;    // Key to the progress version when first seen
+  bool is_baseline_set_;
+  std::vector<PlanViolation> baseline_violations_;
+  std::set<std::string> baseline_keys_;
+
+  size_t num_checks_;
+  size_t num_projections_;
+
+  void project_(const KnowledgeMirror& knowledge);
+
+  bool holds_(const ProjectedState& state, const KnowledgeMirror& knowledge, const PddlAtom& predicate) const;
+  std::optional<double> get_function_(const ProjectedState& state, const KnowledgeMirror& knowledge, const PddlAtom& function) const;
+
+  ConditionResult evaluate_(const ProjectedState& state, const KnowledgeMirror& knowledge, const PddlCondition& condition, double duration_s) const;
+
+  /**
+   * @brief Applies @p effects, with the increases and decreases scaled by @p remaining_fraction.
+   * Used for the part of an executing action which the telemetry does not yet include
+   */
+  void apply_(ProjectedState& state, const KnowledgeMirror& knowledge, const std::vector<PddlEffect>& effects, double duration_s, double remaining_fraction) const;
+
+  /**
+   * @brief Whether the violation may be caused by the progress lagging behind the knowledge
+   */
+  bool is_suspected_lag_(size_t action_idx, const PddlCondition& condition, bool is_start_condition) const;
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "automated_planning/pddl_domain.hpp"
+
+
+struct RelevanceStatistics
+{
+  size_t num_objects{ 0 };
+  size_t num_relevant_objects{ 0 };
+  size_t num_predicates{ 0 };
+  size_t num_relevant_predicates{ 0 };
+  size_t num_functions{ 0 };
+  size_t num_relevant_functions{ 0 };
+  size_t num_ground_actions{ 0 };
+  size_t num_relevant_actions{ 0 };
+  size_t num_route_anchors{ 0 };
+  size_t num_off_route_objects{ 0 };      // Relevant, but not close to a route between the anchors
+  double duration_s{ 0.0 };
+
+  std::string to_string() const;
+};
+
+
+/**
+ * @brief Reduces a problem to the objects and facts which can matter for its goal, such that the
+ * planner grounds and searches a smaller problem
+ *
+ * The analysis is in two steps:
+ *  1. Backward relevance over the ground actions. The goal is relevant, and an action is relevant
+ *     if it achieves a relevant fact, or changes a relevant function in the direction required by
+ *     a comparison. The conditions of the relevant actions are relevant. The objects, facts and
+ *     functions not used by any relevant action or the goal are removed. This step only removes
+ *     actions which cannot contribute to the goal. Facts which every action deleting them adds
+ *     back at its end, like not_tracking, are never achieved by a sequential plan
+ *  2. Route pruning. Actions such as move, which take an object from ?from to ?to along a static
+ *     relation such as path, make the locations a graph. The locations where the other relevant
+ *     actions require a static fact, such as can_land, and the locations of the goal and the
+ *     initial state are anchors. Only the locations on a shortest route between two anchors are
+ *     kept. This step is a heuristic, as the route may be blocked or too long for the battery, and
+ *     a planner should retry with the full problem if the reduced one has no plan
+ *
+ * The objects keep their names, such that a plan for the reduced problem is executed as is on
+ * the full problem
+ */
+class RelevanceAnalysis
+{
+public:
+  /**
+   * @param is_route_pruning_enabled  Whether the second, heuristic step is used
+   */
+  explicit RelevanceAnalysis(std::shared_ptr<const PddlDomain> domain, bool is_route_pruning_enabled=true);
+
+  /**
+   * @brief The problem with only the relevant objects, facts and functions. The goal is unchanged
+   */
+  PddlProblem reduce(const PddlProblem& problem);
+
+  const RelevanceStatistics& get_statistics() const { return statistics_; }
+
+private:
+  // Bits of the direction a fluent function must change in to satisfy a relevant comparison
+  static constexpr int INCREASE = 1;
+  static constexpr int DECREASE = 2;
+
+  /**
+   * @brief Lifted action which moves an object along a static relation, such as move, which
+   * deletes (drone_at ?d ?loc_from) and adds (drone_at ?d ?loc_to) given (path ?loc_from ?loc_to)
+   */
+  struct Transition
+  {
+    std::string action_name;
+    size_t from_parameter;
+    size_t to_parameter;
+    std::string position_predicate;     // drone_at
+    size_t position_argument;           // Index of the location in the position predicate
+  };
+
+  std::shared_ptr<const PddlDomain> domain_;
+  bool is_route_pruning_enabled_;
+  std::unordered_set<std::string> fluent_names_;
+  std::vector<Transition> transitions_;
+  RelevanceStatistics statistics_;
+
+  /**
+   * @brief The objects of the graphs of the transitions, which are close to a route between two
+   * anchors. Only the relevant actions are given
+   *
+   * @param graph_objects  All objects of the graphs
+   */
+  std::unordered_set<std::string> find_route_objects_(
+    const PddlProblem& problem,
+    const std::vector<const DurativeAction*>& relevant_actions,
+    const std::unordered_map<std::string, double>& static_values,
+    std::unordered_set<std::string>& graph_objects);
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+
+
+/**
+ * @brief Events which may trigger a replan, ordered by priority. CURRENT_GOALS replans for the
+ * goals of the current state (for example when the battery is predicted insufficient), and has
+ * the priority of a normal search-replan. PLAN_INVALID also replans for the current goals, but
+ * the remaining plan is known to fail and the replan is not delayed
+ */
+enum class ReplanTrigger { NONE = 0, CURRENT_GOALS = 1, PLAN_INVALID = 2, RESCUE = 3, EMERGENCY = 4 };
+
+
+struct ReplanSchedulerParameters
+{
+  double coalescing_window_s{ 1.5 };      // [s] Triggers are collected until no trigger is received for this long
+  double max_coalescing_delay_s{ 4.0 };   // [s] Upper limit on the delay caused by the coalescing
+  double max_deferral_s{ 60.0 };          // [s] Deferrable triggers are admitted if the current plan lasts longer than this
+};
+
+
+/**
+ * @brief Collects the triggers for replanning, such that a burst of triggers results in a single
+ * replan for the trigger with the highest priority
+ *
+ * Emergencies and invalid plans are released immediately. Other triggers are coalesced until the coalescing window
+ * has passed without new triggers. Deferrable triggers (for example people with minor severity)
+ * are held back until the current plan finishes, unless the remaining plan is long enough to
+ * justify the cost of replanning
+ */
+class ReplanScheduler
+{
+public:
+  explicit ReplanScheduler(const ReplanSchedulerParameters& params=ReplanSchedulerParameters())
+  : params_(params)
+  {}
+
+
+  /**
+   * @brief Requests a replan due to @p trigger at time @p time_s
+   */
+  void request(ReplanTrigger trigger, double time_s, bool deferrable=false);
+
+
+  /**
+   * @brief Returns the trigger to replan for now, or NONE. The returned trigger is removed
+   *
+   * @param plan_running      False at a natural plan boundary, where deferred triggers are released
+   * @param remaining_plan_s  [s] Predicted time until the current plan finishes
+   * @param min_trigger       Triggers with lower priority are kept pending
+   */
+  ReplanTrigger poll(double time_s, bool plan_running, double remaining_plan_s, ReplanTrigger min_trigger=ReplanTrigger::NONE);
+
+
+  /**
+   * @brief Records a completed replan, where the drone was hovering for @p hover_time_lost_s
+   */
+  void record_replan(double hover_time_lost_s);
+
+  bool has_pending() const { return pending_trigger_ != ReplanTrigger::NONE || deferred_trigger_ != ReplanTrigger::NONE; }
+
+  int get_num_requests() const { return num_requests_; }
+  int get_num_replans() const { return num_replans_; }
+  int get_num_coalesced() const { return num_coalesced_; }
+  int get_num_deferred() const { return num_deferred_; }
+  double get_hover_time_lost_s() const { return hover_time_lost_s_; }
+  double get_mean_replan_duration_s() const { return (num_replans_ > 0) ? hover_time_lost_s_ / num_replans_ : 0.0; }
+
+  std::string to_string() const;
+
+private:
+  ReplanSchedulerParameters params_;
+
+  ReplanTrigger pending_trigger_{ ReplanTrigger::NONE };
+  bool is_immediate_pending_{ false };      // An emergency or an invalid plan is among the pending triggers
+  int num_pending_requests_{ 0 };
+  double first_request_s_{ 0.0 };
+  double last_request_s_{ 0.0 };
+
+  ReplanTrigger deferred_trigger_{ ReplanTrigger::NONE };
+
+  // Statistics
+  int num_requests_{ 0 };
+  int num_replans_{ 0 };
+  int num_coalesced_{ 0 };
+  int num_deferred_{ 0 };
+  double hover_time_lost_s_{ 0.0 };
+};
@@ -31,24 +31,28 @@
 
 #include "plansys2_executor/ActionExecutorClient.hpp"
 
-#include "anafi_uav_interfaces/msg/detected_person.hpp"
+#include "automated_planning/action_activation_monitor.hpp"
+#include "automated_planning/adaptive_action_executor_client.hpp"
+#include "automated_planning/action_completion_publisher.hpp"
+
+#include "anafi_uav_interfaces/msg/person_track_array.hpp"
 #include "anafi_uav_interfaces/msg/move_by_command.hpp"
 #include "anafi_uav_interfaces/msg/move_to_command.hpp"
 #include "anafi_uav_interfaces/msg/ekf_output.hpp"
 #include "anafi_uav_interfaces/msg/float32_stamped.hpp"
-#include "anafi_uav_interfaces/srv/set_finished_action.hpp"
 #include "anafi_uav_interfaces/srv/get_search_positions.hpp"
 #include "anafi_uav_interfaces/action/move_to_ned.hpp"
+#include "anafi_uav_interfaces/async_service_client.hpp"
 
 using namespace std::chrono_literals;
 using LifecycleNodeInterface = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface;
 
 
-class SearchActionNode : public plansys2::ActionExecutorClient
+class SearchActionNode : public AdaptiveActionExecutorClient
 {
 public:
   SearchActionNode() 
-  : plansys2::ActionExecutorClient("search_node", 250ms)
+  : AdaptiveActionExecutorClient("search_node", 250ms, false)
   , action_running_(false)
   , search_point_idx_(0)
   {
@@ -71,28 +75,39 @@ public:
 
     // Subscribers
     using namespace std::placeholders;
-    detected_person_sub_ = this->create_subscription<anafi_uav_interfaces::msg::DetectedPerson>(
-      "estimate/detected_person", rclcpp::QoS(1).best_effort(), std::bind(&SearchActionNode::detected_person_cb_, this, _1));
+    person_tracks_sub_ = this->create_subscription<anafi_uav_interfaces::msg::PersonTrackArray>(
+      "estimate/person_tracks", rclcpp::QoS(1).reliable().transient_local(), std::bind(&SearchActionNode::person_tracks_cb_, this, _1));
     apriltags_detected_sub_ = this->create_subscription<anafi_uav_interfaces::msg::Float32Stamped>(
       "/estimate/aprilTags/num_tags_detected", rclcpp::QoS(1).best_effort(), std::bind(&SearchActionNode::apriltags_detected_cb_, this, _1));  
 
+    // Publishers
+    search_distance_pub_ = this->create_publisher<std_msgs::msg::Float64>(
+      "/search_action/search_distance", rclcpp::QoS(1).reliable().transient_local());
+
     // Services
-    search_positions_client_ = this->create_client<anafi_uav_interfaces::srv::GetSearchPositions>(
-      "/waypoint_generator/generate_search_waypoints", rmw_qos_profile_services_default, service_callback_group_);  
-    finished_action_client_ = this->create_client<anafi_uav_interfaces::srv::SetFinishedAction>(
-      "/mission_controller/finished_action",  rmw_qos_profile_services_default, service_callback_group_);
+    search_positions_client_ = std::make_shared<AsyncServiceClient<anafi_uav_interfaces::srv::GetSearchPositions>>(
+      this, "/waypoint_generator/generate_search_waypoints", service_callback_group_);
 
     // Actions
     move_action_client_ = rclcpp_action::create_client<anafi_uav_interfaces::action::MoveToNED>(
       this, "/action_servers/track", action_callback_group_);
+
+    // Connections are checked from configuration, such that the activation does not wait for them
+    activation_monitor_ = std::make_unique<ActionActivationMonitor>(this);
+    activation_monitor_->add_action_server("/action_servers/track", move_action_client_);
+
+    completion_pub_ = std::make_unique<ActionCompletionPublisher>(this);
   }
 
   /**
-   * @brief Initializes the node with respect to locations and search positions
+   * @brief Initializes the node with respect to locations, and requests the search positions. 
+   * Returns without waiting for the waypoint generator, such that the node is configured while
+   * the generator starts
    */
   void init();
 
   // Lifecycle-events
+  LifecycleNodeInterface::CallbackReturn on_configure(const rclcpp_lifecycle::State &);
   LifecycleNodeInterface::CallbackReturn on_activate(const rclcpp_lifecycle::State &);
   LifecycleNodeInterface::CallbackReturn on_deactivate(const rclcpp_lifecycle::State &);
 
@@ -113,19 +128,21 @@ private:
   std::map<std::string, geometry_msgs::msg::Point> ned_locations_;
 
   // Storing location and time of last detection
-  std::map<std::string, std::tuple<rclcpp::Time, std::string>> detections_;  
+  std::map<std::string, std::tuple<rclcpp::Time, SearchDetection>> detections_;  
 
   // Callback-group
   rclcpp::CallbackGroup::SharedPtr service_callback_group_;
   rclcpp::CallbackGroup::SharedPtr action_callback_group_;
 
   // Subscribers
-  rclcpp::Subscription<anafi_uav_interfaces::msg::DetectedPerson>::ConstSharedPtr detected_person_sub_;
+  rclcpp::Subscription<anafi_uav_interfaces::msg::PersonTrackArray>::ConstSharedPtr person_tracks_sub_;
   rclcpp::Subscription<anafi_uav_interfaces::msg::Float32Stamped>::ConstSharedPtr apriltags_detected_sub_;
 
+  // Publishers
+  rclcpp_lifecycle::LifecyclePublisher<std_msgs::msg::Float64>::SharedPtr search_distance_pub_;
+
   // Services
-  rclcpp::Client<anafi_uav_interfaces::srv::GetSearchPositions>::SharedPtr search_positions_client_;
-  rclcpp::Client<anafi_uav_interfaces::srv::SetFinishedAction>::SharedPtr finished_action_client_;
+  AsyncServiceClient<anafi_uav_interfaces::srv::GetSearchPositions>::SharedPtr search_positions_client_;
 
   // Actions
   using MoveGoalHandle = rclcpp_action::ClientGoalHandle<anafi_uav_interfaces::action::MoveToNED>;
@@ -136,6 +153,9 @@ private:
   MoveGoalHandle::SharedPtr move_goal_handle_;
   anafi_uav_interfaces::action::MoveToNED::Goal move_goal_;
 
+  std::unique_ptr<ActionActivationMonitor> activation_monitor_;
+  std::unique_ptr<ActionCompletionPublisher> completion_pub_;
+
 
   // Private functions
   /**
@@ -153,7 +173,8 @@ private:
 
 
   /**
-   * @brief Checks whether the preconditions are satisfied for searching an area 
+   * @brief Checks whether the preconditions are satisfied for searching an area. The move 
+   * action server is looked up in the readiness cache, such that the check is bounded in time
    */
   bool check_search_preconditions_();
 
@@ -166,20 +187,34 @@ private:
 
 
   /**
-   * @brief Gets a set of coordinates (NED) centered around the @p search_center_point_  
+   * @brief Requests a set of coordinates (NED) centered around the @p search_center_point_. The
+   * length of the search pattern is published when the response arrives
+   */
+  void request_search_positions_();
+
+
+  /**
+   * @brief Stores the search positions in @p search_points_
+   */
+  bool set_search_positions_(const anafi_uav_interfaces::srv::GetSearchPositions::Response& response);
+
+
+  /**
+   * @brief Total length of the search pattern in @p search_points_. Used by the mission 
+   * controller for predicting the duration of the search action 
    */
-  bool get_search_positions_();
+  double get_search_distance_();
 
 
   /**
-   * @brief Uses the service function for informing the mission controller that an action is 
-   * marked as completed by the search action node 
+   * @brief Informs the mission controller that the location is searched, and what was detected
+   * there. Returns immediately, as the event is published
    */
-  bool set_search_action_finished_(const std::string& argument="");
+  void set_search_action_finished_(SearchDetection detection=SearchDetection::NONE);
 
 
   // Callbacks
-  void detected_person_cb_(anafi_uav_interfaces::msg::DetectedPerson::ConstSharedPtr detected_person_msg);
+  void person_tracks_cb_(anafi_uav_interfaces::msg::PersonTrackArray::ConstSharedPtr person_tracks_msg);
   void apriltags_detected_cb_(anafi_uav_interfaces::msg::Float32Stamped::ConstSharedPtr detection_msg);
 
 }; // SearchActionNode
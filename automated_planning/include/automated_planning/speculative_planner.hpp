@@ -0,0 +1,145 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "automated_planning/execution_feedback_aggregator.hpp"
+#include "automated_planning/native_planner.hpp"
+#include "automated_planning/pddl_domain.hpp"
+#include "automated_planning/relevance_analysis.hpp"
+
+
+struct SpeculationStatistics
+{
+  size_t num_speculations{ 0 };           // Plans computed in the background
+  size_t num_failed_speculations{ 0 };    // Events for which no plan was found
+  size_t num_invalidated{ 0 };            // Plans dropped as the projected state changed before the event
+  size_t num_lookups{ 0 };
+  size_t num_hits{ 0 };
+  double speculation_duration_s{ 0.0 };   // [s] Background planning time
+  double saved_duration_s{ 0.0 };         // [s] Planning time of the adopted plans, less the lookups
+
+  std::string to_string() const;
+};
+
+
+/**
+ * @brief A likely next event, such as a detected person or an emergency, given by the planning
+ * problem which the controller is expected to plan for once the event has happened
+ */
+struct SpeculativeEvent
+{
+  std::string label;
+  PddlProblem problem;
+};
+
+
+/**
+ * @brief Precomputes plans for likely next events on a background thread while the current plan
+ * is executed, such that a replan for one of the events can adopt a plan without waiting for the
+ * planner
+ *
+ * The events are planned with a native planner, and a relevance analysis if enabled, owned by the
+ * background thread. The plans are kept in a small cache, keyed by the objects, predicates and
+ * goal of the projected problem. The function values, such as the battery charge, are left out of
+ * the key, as they change continuously
+ *
+ * A cached plan is adopted for a problem if the objects and goals are equal, where a single new
+ * object of a type may have another name, as the ID of a detected person is only known once it
+ * is detected. The plan is renamed, and validated from the initial state of the problem with the
+ * compiled domain model, such that a stale plan is never adopted
+ */
+class SpeculativePlanner
+{
+public:
+  /**
+   * @param capacity              Maximum number of cached plans
+   * @param max_expansions        Limits of the native planner for each event
+   * @param timeout_s             [s]
+   * @param is_relevance_enabled  Whether the problems are reduced by the relevance analysis first
+   */
+  SpeculativePlanner(
+    std::shared_ptr<const PddlDomain> domain,
+    size_t capacity=6,
+    size_t max_expansions=50000,
+    double timeout_s=2.0,
+    bool is_relevance_enabled=true);
+  ~SpeculativePlanner();
+
+  SpeculativePlanner(const SpeculativePlanner&) = delete;
+  SpeculativePlanner& operator=(const SpeculativePlanner&) = delete;
+
+  /**
+   * @brief Replaces the events to speculate on. Cached plans of events which are no longer
+   * projected are invalidated, and the new events are queued for the background thread. Events
+   * which are already cached or queued are not planned again
+   */
+  void speculate(const std::vector<SpeculativeEvent>& events);
+
+  /**
+   * @brief A cached plan which is valid for the problem and reaches its goal
+   *
+   * @param label  [out] The event of the adopted plan
+   * @return std::nullopt if no cached plan matches
+   */
+  std::optional<std::vector<PlannedAction>> lookup(const PddlProblem& problem, std::string& label);
+
+  /**
+   * @brief Drops the cache and the queued events, for example when the mission goals change
+   */
+  void clear();
+
+  SpeculationStatistics get_statistics() const;
+
+private:
+  struct Entry
+  {
+    std::string label;
+    std::string key;
+    PddlProblem problem;
+    std::vector<PlannedAction> plan;
+    double planning_duration_s;
+  };
+
+  std::shared_ptr<const PddlDomain> domain_;
+  size_t capacity_;
+
+  // Only used by the background thread
+  NativePlanner planner_;
+  std::unique_ptr<RelevanceAnalysis> relevance_analysis_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable condition_;
+  bool is_stopped_;
+  std::deque<SpeculativeEvent> pending_events_;
+  std::vector<std::string> pending_keys_;
+  std::vector<std::string> projected_keys_;         // Of the latest events, including the pending ones
+  std::string planning_key_;                        // Of the event being planned
+  std::vector<std::string> failed_keys_;            // Not planned again while projected
+  std::vector<Entry> entries_;                      // Most recent first
+  SpeculationStatistics statistics_;
+  std::thread worker_;
+
+  void run_worker_();
+
+  /**
+   * @brief Plans for the problem, with the reduced problem first if the relevance analysis is enabled
+   */
+  std::optional<std::vector<PlannedAction>> plan_(const PddlProblem& problem);
+
+  /**
+   * @brief The names of the objects of @p entry_problem in @p problem, or std::nullopt if the
+   * objects or the goals differ by more than a single renamed object of each type
+   */
+  static std::optional<std::map<std::string, std::string>> match_(const PddlProblem& entry_problem, const PddlProblem& problem);
+
+  static std::string get_key_(const PddlProblem& problem);
+};
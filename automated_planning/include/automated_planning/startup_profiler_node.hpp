@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/subscription.hpp"
+#include "rclcpp/qos.hpp"
+
+#include "anafi_uav_interfaces/msg/startup_timeline.hpp"
+
+#include "automated_planning/startup_timeline.hpp"
+#include "automated_planning/startup_timeline_conversion.hpp"
+
+using namespace std::chrono_literals;
+
+
+/**
+ * @brief Collects the startup timelines published by the nodes on /startup/timeline, and the time
+ * each node of the launch file is discovered in the graph. The nodes which do not publish a
+ * timeline, such as PlanSys2 and the waypoint generator, are thereby only shown by their discovery
+ *
+ * The profile is logged once it has not changed for startup_profiler.settle_time, such that the
+ * report is not repeated for every node
+ */
+class StartupProfilerNode : public rclcpp::Node
+{
+public:
+  StartupProfilerNode()
+  : rclcpp::Node("startup_profiler_node")
+  , is_changed_(false)
+  , last_change_time_(std::chrono::steady_clock::now())
+  , is_stopping_(false)
+  {
+    std::string profiler_prefix = "startup_profiler.";
+    this->declare_parameter(profiler_prefix + "expected_nodes", std::vector<std::string>());
+    this->declare_parameter(profiler_prefix + "settle_time", 2.0);
+    this->declare_parameter(profiler_prefix + "trace_file", std::string());
+
+    std::vector<std::string> expected_nodes = this->get_parameter(profiler_prefix + "expected_nodes").as_string_array();
+    expected_nodes_ = std::set<std::string>(expected_nodes.begin(), expected_nodes.end());
+    settle_time_s_ = this->get_parameter(profiler_prefix + "settle_time").as_double();
+    trace_file_ = this->get_parameter(profiler_prefix + "trace_file").as_string();
+
+    // Each node keeps its latest timeline, which is received independent of the startup order
+    timeline_sub_ = this->create_subscription<anafi_uav_interfaces::msg::StartupTimeline>(
+      "/startup/timeline", rclcpp::QoS(32).reliable().transient_local(),
+      std::bind(&StartupProfilerNode::timeline_cb_, this, std::placeholders::_1));
+
+    report_timer_ = this->create_wall_timer(100ms, std::bind(&StartupProfilerNode::report_timer_cb_, this));
+    graph_thread_ = std::thread(&StartupProfilerNode::watch_graph_, this);
+  }
+
+  ~StartupProfilerNode()
+  {
+    is_stopping_ = true;
+    if(graph_thread_.joinable())
+    {
+      graph_thread_.join();
+    }
+  }
+
+private:
+  std::set<std::string> expected_nodes_;
+  double settle_time_s_;
+  std::string trace_file_;
+
+  std::mutex mutex_;
+  StartupProfile profile_;
+  std::map<std::string, double> discovery_times_s_;   // [s] Wall time, by fully qualified name
+  bool is_changed_;
+  std::chrono::steady_clock::time_point last_change_time_;
+
+  std::atomic<bool> is_stopping_;
+  std::thread graph_thread_;
+
+  rclcpp::Subscription<anafi_uav_interfaces::msg::StartupTimeline>::SharedPtr timeline_sub_;
+  rclcpp::TimerBase::SharedPtr report_timer_;
+
+  void timeline_cb_(anafi_uav_interfaces::msg::StartupTimeline::ConstSharedPtr timeline_msg);
+
+  /**
+   * @brief Waits for changes to the graph instead of polling it, such that the discovery time is
+   * accurate
+   */
+  void watch_graph_();
+
+  void report_timer_cb_();
+
+  /**
+   * @brief Logs the profile, and writes it as a trace if startup_profiler.trace_file is set
+   */
+  void report_();
+};
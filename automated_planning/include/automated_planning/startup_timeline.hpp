@@ -0,0 +1,103 @@
+#pragma once
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+struct StartupPhase
+{
+  std::string name;
+  double start_s;             // [s] Wall time since the epoch
+  double end_s;               // [s] Negative while the phase is running. Equal to start_s for an event
+};
+
+
+/**
+ * @brief The phases of the startup of a single node, timed in wall time such that the timelines of
+ * the nodes in different processes can be aligned by the startup profiler
+ */
+class StartupTimeline
+{
+public:
+  /**
+   * @brief Starts with the phase "process", from the start of the process until now, which covers
+   * the loading of the shared libraries and rclcpp::init(). Left out if the process start is unknown
+   */
+  explicit StartupTimeline(const std::string& node_name);
+
+  void begin(const std::string& name);
+
+  /**
+   * @brief Ends the latest running phase @p name. Ignored if there is no such phase
+   */
+  void end(const std::string& name);
+
+  /**
+   * @brief Adds an event without duration, for example that the node is ready
+   */
+  void mark(const std::string& name);
+
+  /**
+   * @brief Adds a phase timed elsewhere, for example by another thread
+   */
+  void add(const std::string& name, double start_s, double end_s);
+
+  const std::string& get_node_name() const { return node_name_; }
+  const std::vector<StartupPhase>& get_phases() const { return phases_; }
+
+  /**
+   * @brief [s] Wall time since the epoch
+   */
+  static double get_wall_time_s();
+
+  /**
+   * @brief [s] Wall time since the epoch at which this process was started, from /proc
+   */
+  static std::optional<double> get_process_start_time_s();
+
+private:
+  std::string node_name_;
+  std::vector<StartupPhase> phases_;
+};
+
+
+/**
+ * @brief The startup timelines of all nodes of the stack, as collected by the startup profiler
+ */
+class StartupProfile
+{
+public:
+  /**
+   * @brief Replaces the timeline of the node, as the nodes republish their entire timeline
+   */
+  void update(const std::string& node_name, const std::vector<StartupPhase>& phases);
+
+  /**
+   * @brief Adds the event @p name to the node unless it already has it, for the nodes which do not
+   * publish a timeline themselves and are only seen in the graph
+   */
+  void mark(const std::string& node_name, const std::string& name, double time_s);
+
+  bool has_node(const std::string& node_name) const { return timelines_.count(node_name) > 0; }
+  size_t get_num_nodes() const { return timelines_.size(); }
+
+  /**
+   * @brief A table with a line per phase, grouped by node in the order the nodes started. The times
+   * are relative to the earliest start of any node, with a bar showing each phase on a common axis
+   */
+  std::string to_string() const;
+
+  /**
+   * @brief The Chrome trace event format, viewable in chrome://tracing or Perfetto, with a row per node
+   */
+  std::string to_chrome_trace() const;
+
+private:
+  std::map<std::string, std::vector<StartupPhase>> timelines_;
+
+  double get_origin_s_() const;
+  double get_end_s_() const;
+  std::vector<std::string> get_nodes_by_start_() const;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "anafi_uav_interfaces/msg/startup_timeline.hpp"
+
+#include "automated_planning/startup_timeline.hpp"
+
+
+/**
+ * @brief The message published by every node on /startup/timeline
+ */
+inline anafi_uav_interfaces::msg::StartupTimeline to_startup_timeline_msg(const StartupTimeline& timeline)
+{
+  anafi_uav_interfaces::msg::StartupTimeline timeline_msg;
+  timeline_msg.node_name = timeline.get_node_name();
+  for(const StartupPhase& phase : timeline.get_phases())
+  {
+    timeline_msg.phase_names.push_back(phase.name);
+    timeline_msg.start_times.push_back(phase.start_s);
+    timeline_msg.end_times.push_back(phase.end_s);
+  }
+  return timeline_msg;
+}
+
+
+/**
+ * @brief The phases of a timeline received by the startup profiler. Malformed phases are dropped
+ */
+inline std::vector<StartupPhase> to_startup_phases(const anafi_uav_interfaces::msg::StartupTimeline& timeline_msg)
+{
+  std::vector<StartupPhase> phases;
+  const size_t num_phases = std::min(timeline_msg.phase_names.size(), std::min(timeline_msg.start_times.size(), timeline_msg.end_times.size()));
+  for(size_t phase_idx = 0; phase_idx < num_phases; phase_idx++)
+  {
+    phases.push_back(StartupPhase{ timeline_msg.phase_names[phase_idx], timeline_msg.start_times[phase_idx], timeline_msg.end_times[phase_idx] });
+  }
+  return phases;
+}
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <optional>
 #include <algorithm>
 #include <math.h>
 #include <stdint.h>
@@ -21,15 +22,31 @@
 
 #include "plansys2_executor/ActionExecutorClient.hpp"
 
+#include "automated_planning/action_activation_monitor.hpp"
+#include "automated_planning/action_await.hpp"
+#include "automated_planning/adaptive_action_executor_client.hpp"
+
 using namespace std::chrono_literals;
 using LifecycleNodeInterface = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface;
 
 
-class TakeoffActionNode : public plansys2::ActionExecutorClient
+/**
+ * @brief State of one activation of the takeoff-action, created on activation and destroyed on
+ * deactivation. Resumed by do_work()
+ */
+struct TakeoffActivation
+{
+  // The takeoff is ordered again if the drone is not hovering within a period
+  PeriodAwaiter takeoff_retry{ 2.5 };
+  const int max_takeoffs_ordered{ 3 };
+};
+
+
+class TakeoffActionNode : public AdaptiveActionExecutorClient
 {
 public:
   TakeoffActionNode() 
-  : plansys2::ActionExecutorClient("takeoff_node", 250ms)
+  : AdaptiveActionExecutorClient("takeoff_node", 250ms)
   , battery_percentage_(-1)
   {
     // May have some problems with QoS when interfacing with ROS1
@@ -49,15 +66,19 @@ public:
     // Future improvement to allow for enabling the MPC
     enable_velocity_control_client_ = this->create_client<std_srvs::srv::SetBool>(
       "/velocity_controller/service/enable_controller"); 
+
+    activation_monitor_ = std::make_unique<ActionActivationMonitor>(this);
   }
 
   // Lifecycle-events
+  LifecycleNodeInterface::CallbackReturn on_configure(const rclcpp_lifecycle::State &);
   LifecycleNodeInterface::CallbackReturn on_activate(const rclcpp_lifecycle::State &);
   LifecycleNodeInterface::CallbackReturn on_deactivate(const rclcpp_lifecycle::State &);
 
 
 private:
   // State
+  std::optional<TakeoffActivation> activation_;
   std::string anafi_state_;
   double battery_percentage_;
 
@@ -74,13 +95,16 @@ private:
   // Services
   rclcpp::Client<std_srvs::srv::SetBool>::SharedPtr enable_velocity_control_client_;
 
+  std::unique_ptr<ActionActivationMonitor> activation_monitor_;
+
 
   // Private functions
   /**
    * @brief Overload of function in ActionExecutorClient. This function does the 
    * majority of the work when the node is activated. 
    * 
-   * The function is called at the same frequency as the node, and is responsible for
+   * The function is called at tick.active_rate, and when the state of the drone changes. It is
+   * responsible for
    *    - Check if the drone has not taken off
    *      - If it has taken too long, call takeoff again
    *      - If a maximum number of takeoff tries are reached, fail the task
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+/**
+ * @brief A record in a telemetry log. The data points into the memory-mapped file, and is only
+ * valid as long as the reader is alive
+ */
+struct TelemetryRecord
+{
+  int64_t stamp_ns;
+  uint32_t channel;
+  const uint8_t* data;
+  uint32_t size;
+};
+
+
+/**
+ * @brief Append-only, timestamped binary log written through a memory-mapped file
+ *
+ * Each record is a 16-byte header (stamp, channel, size) followed by the payload, padded to
+ * 8 bytes. The file grows by doubling the mapping, and is truncated to the used size when closed.
+ * Channel 0 is reserved, such that the reader stops at the zero-filled tail of a file which was
+ * not closed properly, for example after a crash
+ */
+class TelemetryLogWriter
+{
+public:
+  explicit TelemetryLogWriter(const std::string& path, size_t initial_capacity=16 * 1024 * 1024);
+  ~TelemetryLogWriter();
+
+  TelemetryLogWriter(const TelemetryLogWriter&) = delete;
+  TelemetryLogWriter& operator=(const TelemetryLogWriter&) = delete;
+
+  /**
+   * @brief Appends a record. @p channel must be nonzero
+   */
+  void append(int64_t stamp_ns, uint32_t channel, const void* data, size_t size);
+
+  /**
+   * @brief Flushes the written records to the file, without unmapping it
+   */
+  void flush();
+
+  void close();
+
+  const std::string& get_path() const { return path_; }
+  size_t get_size() const { return size_; }
+  size_t get_num_records() const { return num_records_; }
+
+private:
+  std::string path_;
+  int fd_;
+  uint8_t* map_;
+  size_t capacity_;
+  size_t size_;
+  size_t num_records_;
+
+  void map_file_(size_t capacity);
+  void unmap_file_();
+};
+
+
+/**
+ * @brief Sequential reader of a log written by TelemetryLogWriter
+ */
+class TelemetryLogReader
+{
+public:
+  explicit TelemetryLogReader(const std::string& path);
+  ~TelemetryLogReader();
+
+  TelemetryLogReader(const TelemetryLogReader&) = delete;
+  TelemetryLogReader& operator=(const TelemetryLogReader&) = delete;
+
+  /**
+   * @brief Reads the next record. Returns false at the end of the log
+   */
+  bool next(TelemetryRecord& record);
+
+  void rewind();
+
+private:
+  int fd_;
+  const uint8_t* map_;
+  size_t size_;
+  size_t offset_;
+};
@@ -28,22 +28,25 @@
 #include "geometry_msgs/msg/twist_stamped.hpp"
 #include "builtin_interfaces/msg/time.hpp"
 
-#include "anafi_uav_interfaces/msg/detected_person.hpp"
+#include "anafi_uav_interfaces/msg/person_track_array.hpp"
 #include "anafi_uav_interfaces/msg/float32_stamped.hpp"
 #include "anafi_uav_interfaces/srv/set_equipment_numbers.hpp"
 #include "anafi_uav_interfaces/action/move_to_ned.hpp"
 
 #include "plansys2_executor/ActionExecutorClient.hpp"
 
+#include "automated_planning/action_activation_monitor.hpp"
+#include "automated_planning/adaptive_action_executor_client.hpp"
+
 using namespace std::chrono_literals;
 using LifecycleNodeInterface = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface;
 
 
-class TrackActionNode : public plansys2::ActionExecutorClient
+class TrackActionNode : public AdaptiveActionExecutorClient
 {
 public:
   TrackActionNode() 
-  : plansys2::ActionExecutorClient("track_node", 250ms)
+  : AdaptiveActionExecutorClient("track_node", 250ms, false)
   , radius_of_acceptance_(0.2)
   {
     this->declare_parameter("track.radius_of_acceptance"); // Fail if not found in config
@@ -53,16 +56,21 @@ public:
     using namespace std::placeholders;
     ned_pos_sub_ = this->create_subscription<geometry_msgs::msg::PointStamped>(
       "/anafi/ned_pos_from_gnss", rclcpp::QoS(1).best_effort(), std::bind(&TrackActionNode::ned_pos_cb_, this, _1));    
-    detected_person_sub_ = this->create_subscription<anafi_uav_interfaces::msg::DetectedPerson>(
-      "estimate/detected_person", rclcpp::QoS(1).best_effort(), std::bind(&TrackActionNode::detected_person_cb_, this, _1));
+    person_tracks_sub_ = this->create_subscription<anafi_uav_interfaces::msg::PersonTrackArray>(
+      "estimate/person_tracks", rclcpp::QoS(1).reliable().transient_local(), std::bind(&TrackActionNode::person_tracks_cb_, this, _1));
     apriltags_detected_sub_ = this->create_subscription<anafi_uav_interfaces::msg::Float32Stamped>(
       "/estimate/aprilTags/num_tags_detected", rclcpp::QoS(1).best_effort(), std::bind(&TrackActionNode::apriltags_detected_cb_, this, _1));  
 
     // Actions
     move_action_client_ = rclcpp_action::create_client<anafi_uav_interfaces::action::MoveToNED>(this, "/action_servers/track");
+
+    // Connections are checked from configuration, such that the activation does not wait for them
+    activation_monitor_ = std::make_unique<ActionActivationMonitor>(this);
+    activation_monitor_->add_action_server("/action_servers/track", move_action_client_);
   }
 
   // Lifecycle-events
+  LifecycleNodeInterface::CallbackReturn on_configure(const rclcpp_lifecycle::State &);
   LifecycleNodeInterface::CallbackReturn on_activate(const rclcpp_lifecycle::State &);
   LifecycleNodeInterface::CallbackReturn on_deactivate(const rclcpp_lifecycle::State &);
 
@@ -78,7 +86,7 @@ private:
 
   // Subscribers
   rclcpp::Subscription<geometry_msgs::msg::PointStamped>::ConstSharedPtr ned_pos_sub_;
-  rclcpp::Subscription<anafi_uav_interfaces::msg::DetectedPerson>::ConstSharedPtr detected_person_sub_;
+  rclcpp::Subscription<anafi_uav_interfaces::msg::PersonTrackArray>::ConstSharedPtr person_tracks_sub_;
   rclcpp::Subscription<anafi_uav_interfaces::msg::Float32Stamped>::ConstSharedPtr apriltags_detected_sub_;
 
   // Actions
@@ -90,6 +98,8 @@ private:
   MoveGoalHandle::SharedPtr move_goal_handle_;
   anafi_uav_interfaces::action::MoveToNED::Goal move_goal_;
 
+  std::unique_ptr<ActionActivationMonitor> activation_monitor_;
+
 
   // Private functions
   /**
@@ -101,7 +111,7 @@ private:
 
   // Callbacks
   void ned_pos_cb_(geometry_msgs::msg::PointStamped::ConstSharedPtr ned_pos_msg);
-  void detected_person_cb_(anafi_uav_interfaces::msg::DetectedPerson::ConstSharedPtr detected_person_msg);
+  void person_tracks_cb_(anafi_uav_interfaces::msg::PersonTrackArray::ConstSharedPtr person_tracks_msg);
   void apriltags_detected_cb_(anafi_uav_interfaces::msg::Float32Stamped::ConstSharedPtr detected_apriltags_msg);
 
 }; // TrackActionNode
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
+#include "plansys2_core/PlanSolverBase.hpp"
+#include "plansys2_msgs/msg/plan.hpp"
+
+#include "automated_planning/warm_planner_pool.hpp"
+
+
+/**
+ * @brief PlanSys2 planner plugin which plans with a pool of warm sar_planner_worker processes,
+ * instead of writing the domain and the problem to files and starting a planner process for each
+ * call like the POPF plugin
+ *
+ * The problems are passed to the workers over sockets, and the workers keep the parsed domain and
+ * the grounding between the calls. If the workers find no plan, the problem can be given to a
+ * fallback planner command such as POPF, which is started for the call with the domain and the
+ * problem in tmpfs
+ *
+ * Parameters, prefixed by the name of the plugin:
+ *    worker_executable   Path of sar_planner_worker. Empty for the one installed with this package
+ *    num_workers         Workers kept running
+ *    max_expansions      Limits of the native planner of the workers
+ *    timeout             [s]
+ *    relevance_pruning   Whether the workers plan for the problem reduced to the relevant objects first
+ *    fallback_command    Run through the shell if the workers find no plan, with {domain} and
+ *                        {problem} replaced by the paths. Empty to disable
+ *    fallback_timeout    [s] The fallback command is killed after this duration, such that the
+ *                        planner service is not blocked by a planner which does not terminate
+ */
+class WarmPlanSolver : public plansys2::PlanSolverBase
+{
+public:
+  WarmPlanSolver();
+  ~WarmPlanSolver();
+
+  void configure(rclcpp_lifecycle::LifecycleNode::SharedPtr& node, const std::string& plugin_name) override;
+
+  std::optional<plansys2_msgs::msg::Plan> getPlan(
+    const std::string& domain,
+    const std::string& problem,
+    const std::string& node_namespace = "") override;
+
+private:
+  rclcpp::Logger logger_;
+  std::unique_ptr<WarmPlannerPool> pool_;
+  std::string fallback_command_;
+  double fallback_timeout_s_{ 30.0 };
+
+  /**
+   * @brief Plans with the fallback command, as the POPF plugin does
+   */
+  std::optional<plansys2_msgs::msg::Plan> get_fallback_plan_(const std::string& domain, const std::string& problem);
+};
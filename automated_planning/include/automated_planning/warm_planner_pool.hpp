@@ -0,0 +1,150 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "automated_planning/execution_feedback_aggregator.hpp"
+
+
+struct WarmPlannerPoolStatistics
+{
+  size_t num_calls{ 0 };
+  size_t num_plans{ 0 };
+  size_t num_spawned_workers{ 0 };
+  size_t num_failed_workers{ 0 };       // Killed after a crash, a protocol error or a timeout
+  size_t num_domain_transfers{ 0 };     // Calls where the worker had to parse the domain
+  double call_duration_s{ 0.0 };        // [s] From the call until the plan was received
+  double worker_duration_s{ 0.0 };      // [s] Parsing and planning in the workers
+
+  /**
+   * @brief [s] Mean time of a call which is spent outside of the worker, in the transfer of the
+   * problem and the plan and waiting for a worker
+   */
+  double get_overhead_per_call_s() const;
+
+  std::string to_string() const;
+};
+
+
+/**
+ * @brief Pool of long-lived planner processes, which are reused across the calls instead of
+ * starting a planner process for each problem
+ *
+ * Each worker runs @p worker_command, normally sar_planner_worker, connected to the pool by a Unix
+ * socket as its standard input and output. The domain and the problem are sent through the socket
+ * as text, such that nothing is written to disk. A worker keeps the parsed domain and its planner
+ * between the calls, and the domain is only sent when its hash differs from the last one sent to
+ * the worker. The grounding cache of the planner is thereby kept warm as well
+ *
+ * A worker which crashes, breaks the protocol or exceeds the timeout is killed, and a new worker
+ * is started on the next call. The calls are thread-safe, and are distributed over the workers
+ *
+ * The messages in both directions are a header line followed by a payload of the given size:
+ *    DOMAIN <size>\n<domain>
+ *    PROBLEM <size>\n<problem>
+ *    PLAN <size> <worker_duration_s>\n<start_s> <duration_s> <action>\n...
+ *    NONE <size> <worker_duration_s>\n<reason>
+ */
+class WarmPlannerPool
+{
+public:
+  /**
+   * @param worker_command  Executable and arguments of the workers
+   * @param timeout_s       [s] A call is aborted, and the worker killed, after this duration
+   */
+  WarmPlannerPool(const std::vector<std::string>& worker_command, size_t num_workers=2, double timeout_s=30.0);
+  ~WarmPlannerPool();
+
+  WarmPlannerPool(const WarmPlannerPool&) = delete;
+  WarmPlannerPool& operator=(const WarmPlannerPool&) = delete;
+
+  /**
+   * @brief Starts the workers which are not running, such that the first call does not wait for
+   * the process start-up. Returns false if a worker could not be started
+   */
+  bool start();
+
+  /**
+   * @brief Plans for the problem with an idle worker, waiting for one if all are busy
+   *
+   * @param message  [out] The reason if no plan was found
+   * @return std::nullopt if the worker found no plan, or failed
+   */
+  std::optional<std::vector<PlannedAction>> plan(const std::string& domain, const std::string& problem, std::string& message);
+
+  WarmPlannerPoolStatistics get_statistics() const;
+
+private:
+  struct Worker
+  {
+    pid_t pid{ -1 };
+    int socket{ -1 };
+    bool is_busy{ false };
+    std::optional<size_t> domain_hash;      // Of the domain last sent to the worker
+  };
+
+  std::vector<std::string> worker_command_;
+  double timeout_s_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable condition_;
+  std::vector<Worker> workers_;
+  WarmPlannerPoolStatistics statistics_;
+
+  /**
+   * @brief Starts the process of the worker. Must be called with the mutex locked
+   */
+  bool spawn_(Worker& worker);
+
+  /**
+   * @brief Kills the process of the worker, which is started again on its next call
+   */
+  static void terminate_(Worker& worker);
+
+  /**
+   * @brief Sends the domain if needed and the problem, and receives the response. Called without
+   * the mutex, with the worker marked as busy
+   *
+   * @param is_domain_sent  [out]
+   * @param worker_duration_s  [out] [s] Time spent in the worker, as reported by the worker
+   * @return false if the worker failed, and must be terminated
+   */
+  bool call_(
+    Worker& worker,
+    size_t domain_hash,
+    const std::string& domain,
+    const std::string& problem,
+    std::optional<std::vector<PlannedAction>>& plan,
+    std::string& message,
+    bool& is_domain_sent,
+    double& worker_duration_s) const;
+};
+
+
+/**
+ * @brief Writes the whole buffer to the file descriptor, retrying on partial writes. Returns false
+ * if the other end is closed
+ */
+bool write_all(int fd, const std::string& data);
+
+
+/**
+ * @brief Reads exactly @p size bytes, or a line if @p size is zero. Waits at most until the
+ * deadline if it is given
+ *
+ * @param deadline_s  [s] On the steady clock, or negative to wait without a deadline
+ * @return false on end of file, error or timeout
+ */
+bool read_message_part(int fd, size_t size, std::string& data, double deadline_s=-1.0);
+
+
+/**
+ * @brief [s] The current time of the steady clock, as used by the deadlines
+ */
+double get_steady_time_s();
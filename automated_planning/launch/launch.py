@@ -1,15 +1,44 @@
 #!/usr/bin/python3
 import os
+import tempfile
+
+import yaml
 
 from ament_index_python.packages import get_package_share_directory
 
 from launch import LaunchDescription
-from launch.actions import DeclareLaunchArgument, IncludeLaunchDescription, SetEnvironmentVariable
+from launch.actions import DeclareLaunchArgument, IncludeLaunchDescription, OpaqueFunction, SetEnvironmentVariable
 from launch.launch_description_sources import PythonLaunchDescriptionSource
 from launch.substitutions import LaunchConfiguration
 from launch_ros.actions import Node
 
 
+def include_plansys2(context, directory, model_file, namespace):
+  # The monolithic bringup of Foxy has no use_sim_time argument. It is added to the parameters of
+  # the selected planner for every PlanSys2 node, such that the executor follows the simulation
+  plan_solver = LaunchConfiguration('plan_solver').perform(context)
+  use_sim_time = LaunchConfiguration('use_sim_time').perform(context).lower() in ['true', '1']
+  with open(os.path.join(directory, 'config', 'plansys2_' + plan_solver + '_params.yaml'), 'r') as f:
+    params = yaml.safe_load(f) or {}
+  for node_name in ['domain_expert', 'problem_expert', 'planner', 'executor']:
+    params.setdefault(node_name, {}).setdefault('ros__parameters', {})['use_sim_time'] = use_sim_time
+
+  with tempfile.NamedTemporaryFile('w', prefix='plansys2_' + plan_solver + '_', suffix='.yaml', delete=False) as f:
+    yaml.safe_dump(params, f)
+
+  return [IncludeLaunchDescription(
+    PythonLaunchDescriptionSource(os.path.join(
+      get_package_share_directory('plansys2_bringup'),
+      'launch',
+      'plansys2_bringup_launch_monolithic.py')),
+    launch_arguments={
+      'model_file': model_file,
+      'namespace': namespace,
+      'params_file': f.name
+    }.items()
+  )]
+
+
 def generate_launch_description():
   # Get the launch directory
   package_name = "automated_planning"
@@ -24,19 +53,23 @@ def generate_launch_description():
     default_value='',
     description='Namespace')
 
+  declare_plan_solver_cmd = DeclareLaunchArgument(
+    'plan_solver',
+    default_value='popf',
+    description='Planner of PlanSys2: popf, or warm for the pool of native planner workers')
+
+  use_sim_time = LaunchConfiguration('use_sim_time')
+  declare_use_sim_time_cmd = DeclareLaunchArgument(
+    'use_sim_time',
+    default_value='false',
+    description='Use the /clock published by the simulator')
+
   stdout_linebuf_envvar = SetEnvironmentVariable(
     'RCUTILS_CONSOLE_STDOUT_LINE_BUFFERED', '1')
 
-  plansys2_cmd = IncludeLaunchDescription(
-    PythonLaunchDescriptionSource(os.path.join(
-      get_package_share_directory('plansys2_bringup'),
-      'launch',
-      'plansys2_bringup_launch_monolithic.py')),
-    launch_arguments={
-      'model_file': directory + "/pddl/" + pddl_file,
-      'namespace': namespace
-    }.items()
-  )
+  plansys2_cmd = OpaqueFunction(
+    function=include_plansys2,
+    args=[directory, directory + "/pddl/" + pddl_file, namespace])
 
   config_file = os.path.join(
       get_package_share_directory(package_name),
@@ -49,6 +82,15 @@ def generate_launch_description():
       'mission_parameters.yaml'
     )
 
+  # Started first, such that it sees every other node appear
+  startup_profiler_cmd = Node(
+    package=package_name,
+    executable='startup_profiler_node',
+    name='startup_profiler_node',
+    namespace=namespace,
+    output='screen',
+    parameters=[config_file, {'use_sim_time': use_sim_time}])
+
   # Specify the actions
   move_cmd = Node(
     package=package_name,
@@ -56,7 +98,7 @@ def generate_launch_description():
     name='move_action_node',
     namespace=namespace,
     output='screen',
-    parameters=[config_file, mission_params_file])
+    parameters=[config_file, mission_params_file, {'use_sim_time': use_sim_time}])
 
   land_cmd = Node(
     package=package_name,
@@ -64,7 +106,7 @@ def generate_launch_description():
     name='land_action_node',
     namespace=namespace,
     output='screen',
-    parameters=[config_file, mission_params_file])
+    parameters=[config_file, mission_params_file, {'use_sim_time': use_sim_time}])
 
   takeoff_cmd = Node(
     package=package_name,
@@ -72,7 +114,7 @@ def generate_launch_description():
     name='takeoff_action_node',
     namespace=namespace,
     output='screen',
-    parameters=[config_file, mission_params_file])   
+    parameters=[config_file, mission_params_file, {'use_sim_time': use_sim_time}])   
   
   drop_lifevest_cmd = Node(
     package=package_name,
@@ -80,7 +122,7 @@ def generate_launch_description():
     name='drop_lifevest_action_node',
     namespace=namespace,
     output='screen',
-    parameters=[config_file, mission_params_file])   
+    parameters=[config_file, mission_params_file, {'use_sim_time': use_sim_time}])   
   
   drop_marker_cmd = Node(
     package=package_name,
@@ -88,7 +130,7 @@ def generate_launch_description():
     name='drop_marker_action_node',
     namespace=namespace,
     output='screen',
-    parameters=[config_file, mission_params_file])   
+    parameters=[config_file, mission_params_file, {'use_sim_time': use_sim_time}])   
   
   communicate_cmd = Node(
     package=package_name,
@@ -96,7 +138,7 @@ def generate_launch_description():
     name='communicate_action_node',
     namespace=namespace,
     output='screen',
-    parameters=[config_file, mission_params_file])   
+    parameters=[config_file, mission_params_file, {'use_sim_time': use_sim_time}])   
   
   search_cmd = Node(
     package=package_name,
@@ -104,7 +146,7 @@ def generate_launch_description():
     name='search_action_node',
     namespace=namespace,
     output='screen',
-    parameters=[config_file, mission_params_file])   
+    parameters=[config_file, mission_params_file, {'use_sim_time': use_sim_time}])   
   
   track_cmd = Node(
     package=package_name,
@@ -112,7 +154,7 @@ def generate_launch_description():
     name='track_action_node',
     namespace=namespace,
     output='screen',
-    parameters=[config_file, mission_params_file])   
+    parameters=[config_file, mission_params_file, {'use_sim_time': use_sim_time}])   
   
   recharge_cmd = Node(
     package=package_name,
@@ -120,7 +162,7 @@ def generate_launch_description():
     name='recharge_action_node',
     namespace=namespace,
     output='screen',
-    parameters=[config_file, mission_params_file])   
+    parameters=[config_file, mission_params_file, {'use_sim_time': use_sim_time}])   
   
   resupply_cmd = Node(
     package=package_name,
@@ -128,7 +170,16 @@ def generate_launch_description():
     name='resupply_action_node',
     namespace=namespace,
     output='screen',
-    parameters=[config_file, mission_params_file])   
+    parameters=[config_file, mission_params_file, {'use_sim_time': use_sim_time}])   
+  
+
+  person_tracker_cmd = Node(
+    package=package_name,
+    executable='person_tracker_node',
+    name='person_tracker_node',
+    namespace=namespace,
+    output='screen',
+    parameters=[config_file, {'use_sim_time': use_sim_time}])   
   
 
   get_search_positions = Node(
@@ -137,7 +188,7 @@ def generate_launch_description():
     name='search_waypoints_node',
     namespace=namespace,
     output='screen',
-    parameters=[config_file])   
+    parameters=[config_file, {'use_sim_time': use_sim_time}])   
   
 
   track_action_server = Node(
@@ -146,7 +197,7 @@ def generate_launch_description():
     name='track_action_server',
     namespace=namespace,
     output='screen',
-    parameters=[config_file])   
+    parameters=[config_file, {'use_sim_time': use_sim_time}])   
   
   move_action_server = Node(
     package="action_implementations",
@@ -154,15 +205,18 @@ def generate_launch_description():
     name='move_action_server',
     namespace=namespace,
     output='screen',
-    parameters=[config_file])   
+    parameters=[config_file, {'use_sim_time': use_sim_time}])   
 
   ld = LaunchDescription()
 
   # Set environment variables
   ld.add_action(stdout_linebuf_envvar)
   ld.add_action(declare_namespace_cmd)
+  ld.add_action(declare_plan_solver_cmd)
+  ld.add_action(declare_use_sim_time_cmd)
 
   # Declare launch options
+  ld.add_action(startup_profiler_cmd)
   ld.add_action(plansys2_cmd)
 
   ld.add_action(move_cmd)
@@ -176,6 +230,8 @@ def generate_launch_description():
   ld.add_action(recharge_cmd)
   ld.add_action(resupply_cmd)
 
+  ld.add_action(person_tracker_cmd)
+
   ld.add_action(get_search_positions)
 
   ld.add_action(track_action_server)
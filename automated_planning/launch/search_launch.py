@@ -24,6 +24,12 @@ def generate_launch_description():
     default_value='',
     description='Namespace')
 
+  plan_solver = LaunchConfiguration('plan_solver')
+  declare_plan_solver_cmd = DeclareLaunchArgument(
+    'plan_solver',
+    default_value='popf',
+    description='Planner of PlanSys2: popf, or warm for the pool of native planner workers')
+
   stdout_linebuf_envvar = SetEnvironmentVariable(
     'RCUTILS_CONSOLE_STDOUT_LINE_BUFFERED', '1')
   
@@ -40,7 +46,8 @@ def generate_launch_description():
       'plansys2_bringup_launch_monolithic.py')),
     launch_arguments={
       'model_file': directory + "/pddl/" + pddl_file,
-      'namespace': namespace
+      'namespace': namespace,
+      'params_file': [os.path.join(directory, 'config', 'plansys2_'), plan_solver, '_params.yaml']
     }.items()
   )
 
@@ -195,6 +202,7 @@ def generate_launch_description():
   # ld.add_action(stdout_loggin_buff_envvar)
   ld.add_action(stdout_linebuf_envvar)
   ld.add_action(declare_namespace_cmd)
+  ld.add_action(declare_plan_solver_cmd)
 
   # Declare launch options
   ld.add_action(plansys2_cmd)
@@ -0,0 +1,81 @@
+#!/usr/bin/python3
+import os
+
+from ament_index_python.packages import get_package_share_directory
+
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument, IncludeLaunchDescription
+from launch.launch_description_sources import PythonLaunchDescriptionSource
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import Node
+
+
+def generate_launch_description():
+  # Runs a full mission against the kinematic stand-in for the Anafi, instead of the drone or
+  # the Parrot simulator. All nodes except the simulator follow the /clock of the simulator
+  package_name = "automated_planning"
+  directory = get_package_share_directory(package_name)
+  namespace = LaunchConfiguration('namespace')
+  real_time_factor = LaunchConfiguration('real_time_factor')
+  plan_solver = LaunchConfiguration('plan_solver')
+  mission_params_file = LaunchConfiguration('mission_params_file')
+
+  declare_namespace_cmd = DeclareLaunchArgument(
+    'namespace',
+    default_value='',
+    description='Namespace')
+
+  declare_plan_solver_cmd = DeclareLaunchArgument(
+    'plan_solver',
+    default_value='popf',
+    description='Planner of PlanSys2: popf, or warm for the pool of native planner workers')
+
+  declare_real_time_factor_cmd = DeclareLaunchArgument(
+    'real_time_factor',
+    default_value='20.0',
+    description='Simulated seconds per wall-clock second')
+
+  config_file = os.path.join(directory, 'config', 'config.yaml')
+
+  declare_mission_params_file_cmd = DeclareLaunchArgument(
+    'mission_params_file',
+    default_value=os.path.join(directory, 'config', 'mission_parameters.yaml'),
+    description='Locations and goals of the mission')
+
+  planning_cmd = IncludeLaunchDescription(
+    PythonLaunchDescriptionSource(os.path.join(directory, 'launch', 'launch.py')),
+    launch_arguments={
+      'namespace': namespace,
+      'use_sim_time': 'true',
+      'plan_solver': plan_solver
+    }.items()
+  )
+
+  anafi_sim_cmd = Node(
+    package=package_name,
+    executable='anafi_sim_node',
+    name='anafi_sim_node',
+    namespace=namespace,
+    output='screen',
+    parameters=[config_file, {'use_sim_time': False, 'anafi_sim.real_time_factor': real_time_factor}])
+
+  mission_controller_cmd = Node(
+    package=package_name,
+    executable='mission_controller_node',
+    name='mission_controller_node',
+    namespace=namespace,
+    output='screen',
+    parameters=[mission_params_file, config_file, {'use_sim_time': True}])
+
+  ld = LaunchDescription()
+
+  ld.add_action(declare_namespace_cmd)
+  ld.add_action(declare_real_time_factor_cmd)
+  ld.add_action(declare_plan_solver_cmd)
+  ld.add_action(declare_mission_params_file_cmd)
+
+  ld.add_action(anafi_sim_cmd)
+  ld.add_action(planning_cmd)
+  ld.add_action(mission_controller_cmd)
+
+  return ld
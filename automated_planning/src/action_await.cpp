@@ -0,0 +1,58 @@
+#include "automated_planning/action_await.hpp"
+
+
+ConditionAwaiter::ConditionAwaiter(double timeout_s)
+: timeout_s_(timeout_s)
+, waited_s_(0.0)
+{ }
+
+
+AwaitStatus ConditionAwaiter::await(bool condition, double dt_s)
+{
+  if(waited_s_ >= timeout_s_)
+  {
+    return AwaitStatus::TIMED_OUT;
+  }
+  if(condition)
+  {
+    return AwaitStatus::READY;
+  }
+
+  waited_s_ += dt_s;
+  return (waited_s_ >= timeout_s_) ? AwaitStatus::TIMED_OUT : AwaitStatus::WAITING;
+}
+
+
+void ConditionAwaiter::reset()
+{
+  waited_s_ = 0.0;
+}
+
+
+PeriodAwaiter::PeriodAwaiter(double period_s)
+: period_s_(period_s)
+, waited_s_(0.0)
+, num_periods_(0)
+{ }
+
+
+bool PeriodAwaiter::await(double dt_s)
+{
+  waited_s_ += dt_s;
+  if(waited_s_ < period_s_)
+  {
+    return false;
+  }
+
+  // A long tick counts as a single period, such that a late command is not repeated at once
+  waited_s_ = 0.0;
+  num_periods_++;
+  return true;
+}
+
+
+void PeriodAwaiter::reset()
+{
+  waited_s_ = 0.0;
+  num_periods_ = 0;
+}
@@ -0,0 +1,186 @@
+#include "automated_planning/action_completion.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+
+namespace
+{
+  const char* get_goal_predicate(CompletedAction action)
+  {
+    switch(action)
+    {
+      case CompletedAction::SEARCH:
+        return "searched";
+      case CompletedAction::COMMUNICATE:
+        return "not_communicated";
+      case CompletedAction::MARK:
+        return "not_marked";
+      case CompletedAction::RESCUE:
+        return "not_rescued";
+    }
+    return "";
+  }
+
+
+  /**
+   * @brief Advances @p pos past @p literal if @p str continues with it
+   */
+  bool consume(const std::string& str, size_t& pos, const char* literal, size_t literal_length)
+  {
+    if(pos > str.size() || str.compare(pos, literal_length, literal, literal_length) != 0)
+    {
+      return false;
+    }
+    pos += literal_length;
+    return true;
+  }
+
+
+  /**
+   * @brief The ID of the name p<id> in [begin, end), as written by std::to_string. Returns -1 for
+   * any other name, such that p1_2, p01 and person12 are not taken for another person
+   */
+  int parse_person_id(const std::string& str, size_t begin, size_t end)
+  {
+    if(end > str.size() || begin >= end || str[begin] != 'p')
+    {
+      return -1;
+    }
+    const size_t num_digits = end - begin - 1;
+    const bool has_leading_zero = (num_digits > 1 && str[begin + 1] == '0');
+    if(num_digits == 0 || num_digits > static_cast<size_t>(std::numeric_limits<int>::digits10) || has_leading_zero)
+    {
+      return -1;
+    }
+    int id = 0;
+    for(size_t idx = begin + 1; idx < end; idx++)
+    {
+      if(str[idx] < '0' || str[idx] > '9')
+      {
+        return -1;
+      }
+      id = id * 10 + (str[idx] - '0');
+    }
+    return id;
+  }
+}
+
+
+int get_location_idx(const std::vector<std::string>& location_names, const std::string& location)
+{
+  std::vector<std::string>::const_iterator it = std::find(location_names.begin(), location_names.end(), location);
+  return (it != location_names.end()) ? static_cast<int>(it - location_names.begin()) : -1;
+}
+
+
+int get_person_id(const std::string& person)
+{
+  return parse_person_id(person, 0, person.size());
+}
+
+
+std::optional<ActionCompletion> to_action_completion(
+  const std::string& action_name,
+  const std::string& location,
+  const std::string& person,
+  const std::vector<std::string>& location_names)
+{
+  ActionCompletion completion;
+  if(action_name == "search")
+  {
+    completion.action = CompletedAction::SEARCH;
+  }
+  else if(action_name == "communicate")
+  {
+    completion.action = CompletedAction::COMMUNICATE;
+  }
+  else if(action_name == "mark")
+  {
+    completion.action = CompletedAction::MARK;
+  }
+  else if(action_name == "rescue")
+  {
+    completion.action = CompletedAction::RESCUE;
+  }
+  else
+  {
+    return std::nullopt;
+  }
+
+  completion.location_idx = get_location_idx(location_names, location);
+  if(completion.location_idx < 0)
+  {
+    return std::nullopt;
+  }
+  if(completion.action == CompletedAction::SEARCH)
+  {
+    if(person == "person")
+    {
+      completion.detection = SearchDetection::PERSON;
+    }
+    else if(person == "helipad")
+    {
+      completion.detection = SearchDetection::HELIPAD;
+    }
+  }
+  else
+  {
+    completion.person_id = get_person_id(person);
+  }
+  return completion;
+}
+
+
+bool is_completed_goal(
+  const ActionCompletion& completion,
+  const std::string& goal,
+  const std::vector<std::string>& location_names)
+{
+  if(completion.location_idx < 0 || static_cast<size_t>(completion.location_idx) >= location_names.size())
+  {
+    return false;
+  }
+  const std::string& location = location_names[completion.location_idx];
+  const char* predicate = get_goal_predicate(completion.action);
+
+  // (searched <location>) or (<predicate> <person> <location>)
+  size_t pos = 0;
+  if(! consume(goal, pos, "(", 1) || ! consume(goal, pos, predicate, std::strlen(predicate)) || ! consume(goal, pos, " ", 1))
+  {
+    return false;
+  }
+  if(completion.action != CompletedAction::SEARCH)
+  {
+    // A completion without a person ID must not match the goals whose person has no ID either
+    if(completion.person_id < 0)
+    {
+      return false;
+    }
+    size_t person_end = goal.find(' ', pos);
+    if(person_end == std::string::npos || parse_person_id(goal, pos, person_end) != completion.person_id)
+    {
+      return false;
+    }
+    pos = person_end + 1;
+  }
+  return consume(goal, pos, location.c_str(), location.size()) && consume(goal, pos, ")", 1) && pos == goal.size();
+}
+
+
+size_t remove_completed_goals(
+  const std::vector<ActionCompletion>& completions,
+  const std::vector<std::string>& location_names,
+  std::vector<std::string>& goals)
+{
+  std::vector<std::string>::iterator removed_begin = std::remove_if(goals.begin(), goals.end(),
+    [&completions, &location_names](const std::string& goal)
+    {
+      return std::any_of(completions.begin(), completions.end(),
+        [&goal, &location_names](const ActionCompletion& completion){ return is_completed_goal(completion, goal, location_names); });
+    });
+  size_t num_removed = goals.end() - removed_begin;
+  goals.erase(removed_begin, goals.end());
+  return num_removed;
+}
@@ -0,0 +1,210 @@
+#include "automated_planning/action_duration_model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+
+ActionDurationModel::ActionDurationModel(
+  double move_velocity,
+  double track_velocity,
+  double search_distance,
+  double forgetting_factor
+)
+: search_distance_(search_distance)
+, forgetting_factor_(std::clamp(forgetting_factor, 0.5, 1.0))
+{
+  // Priors are taken from the constant durations previously hardcoded in the PDDL-file,
+  // and from the velocity limits in the config file for the actions covering a distance
+  auto fixed_prior = [](double duration_s)
+  {
+    LinearDurationModel model;
+    model.overhead_s = duration_s;
+    model.p_11 = 0.0; // No distance, thus no need to estimate the slope
+    return model;
+  };
+  auto distance_prior = [](double velocity)
+  {
+    LinearDurationModel model;
+    model.overhead_s = 0.0;
+    model.seconds_per_meter = (velocity > 0) ? 1.0 / velocity : 0.0;
+    model.p_00 = 25.0;
+    model.p_11 = std::pow(0.5 * model.seconds_per_meter, 2);
+    return model;
+  };
+
+  models_["move"] = distance_prior(move_velocity);
+  models_["search"] = distance_prior(track_velocity);
+  models_["land"] = fixed_prior(10.0);
+  models_["takeoff"] = fixed_prior(5.0);
+  models_["track"] = fixed_prior(20.0);
+  models_["drop_marker"] = fixed_prior(2.0);
+  models_["drop_lifevest"] = fixed_prior(2.0);
+  models_["communicate"] = fixed_prior(1.0);
+}
+
+
+void ActionDurationModel::set_search_distance(double search_distance)
+{
+  if(search_distance > 0 && std::isfinite(search_distance))
+  {
+    search_distance_ = search_distance;
+  }
+}
+
+
+double ActionDurationModel::predict(const std::string& action_type, double distance) const
+{
+  const LinearDurationModel* model = find_model_(action_type);
+  if(model == nullptr)
+  {
+    return default_duration_s_;
+  }
+
+  if(action_type.compare("search") == 0)
+  {
+    distance = search_distance_;
+  }
+
+  // The planner requires strictly positive durations
+  const double min_duration_s = 0.1;
+  return std::max(min_duration_s, model->overhead_s + model->seconds_per_meter * distance);
+}
+
+
+bool ActionDurationModel::add_observation(const std::string& action_type, double distance, double duration_s)
+{
+  std::map<std::string, LinearDurationModel>::iterator it = models_.find(action_type);
+  if(it == models_.end() || ! std::isfinite(duration_s) || ! std::isfinite(distance))
+  {
+    return false;
+  }
+
+  // Reject observations which cannot be correct. Actions finishing instantly are
+  // typically actions which were already satisfied (for example moving to the current location)
+  // and would pull the estimate towards 0
+  const double min_duration_s = 0.1;
+  const double max_outlier_factor = 10.0;
+  double predicted_s = predict(action_type, distance);
+  if(duration_s < min_duration_s || duration_s > max_outlier_factor * predicted_s + 60.0)
+  {
+    return false;
+  }
+
+  LinearDurationModel& model = it->second;
+  const double x_0 = 1.0;
+  const double x_1 = distance;
+  const double lambda = forgetting_factor_;
+
+  // Recursive least squares with forgetting factor:
+  //   k = P x / (lambda + x' P x)
+  //   theta = theta + k (y - x' theta)
+  //   P = (P - k x' P) / lambda
+  double px_0 = model.p_00 * x_0 + model.p_01 * x_1;
+  double px_1 = model.p_01 * x_0 + model.p_11 * x_1;
+  double denominator = lambda + x_0 * px_0 + x_1 * px_1;
+
+  double k_0 = px_0 / denominator;
+  double k_1 = px_1 / denominator;
+
+  double residual = duration_s - (model.overhead_s * x_0 + model.seconds_per_meter * x_1);
+  model.overhead_s += k_0 * residual;
+  model.seconds_per_meter += k_1 * residual;
+
+  double p_00 = (model.p_00 - k_0 * px_0) / lambda;
+  double p_01 = (model.p_01 - k_0 * px_1) / lambda;
+  double p_11 = (model.p_11 - k_1 * px_1) / lambda;
+
+  // Prevent the covariance from blowing up when the same distance is observed repeatedly
+  const double max_covariance = 1e4;
+  model.p_00 = std::min(p_00, max_covariance);
+  model.p_01 = p_01;
+  model.p_11 = std::min(p_11, max_covariance);
+
+  // The slope can never be negative
+  model.seconds_per_meter = std::max(0.0, model.seconds_per_meter);
+
+  model.num_observations++;
+  return true;
+}
+
+
+int ActionDurationModel::get_num_observations(const std::string& action_type) const
+{
+  const LinearDurationModel* model = find_model_(action_type);
+  return (model == nullptr) ? 0 : model->num_observations;
+}
+
+
+std::string ActionDurationModel::to_string() const
+{
+  std::stringstream ss;
+  ss << "Duration models: [action] [overhead s] [s/m] [observations]\n";
+  for(const auto& [action_type, model] : models_)
+  {
+    ss << action_type << "\t" << model.overhead_s << "\t" << model.seconds_per_meter << "\t" << model.num_observations << "\n";
+  }
+  ss << "Search distance: " << search_distance_ << " m\n";
+  return ss.str();
+}
+
+
+const LinearDurationModel* ActionDurationModel::find_model_(const std::string& action_type) const
+{
+  std::map<std::string, LinearDurationModel>::const_iterator it = models_.find(action_type);
+  if(it == models_.end())
+  {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+
+void MakespanTracker::start_plan(double predicted_s, double start_time_s)
+{
+  plan_running_ = true;
+  plan_predicted_s_ = predicted_s;
+  plan_start_time_s_ = start_time_s;
+}
+
+
+double MakespanTracker::end_plan(double end_time_s, bool completed)
+{
+  if(! plan_running_)
+  {
+    return 0.0;
+  }
+  plan_running_ = false;
+
+  double actual_s = end_time_s - plan_start_time_s_;
+  if(! completed)
+  {
+    return 0.0;
+  }
+
+  mission_predicted_s_ += plan_predicted_s_;
+  mission_actual_s_ += actual_s;
+  num_completed_plans_++;
+
+  return actual_s - plan_predicted_s_;
+}
+
+
+double MakespanTracker::get_predicted_remaining_s(double time_s) const
+{
+  if(! plan_running_)
+  {
+    return 0.0;
+  }
+  return std::max(0.0, plan_start_time_s_ + plan_predicted_s_ - time_s);
+}
+
+
+double MakespanTracker::get_mission_relative_error() const
+{
+  if(mission_predicted_s_ <= 0)
+  {
+    return 0.0;
+  }
+  return (mission_actual_s_ - mission_predicted_s_) / mission_predicted_s_;
+}
@@ -0,0 +1,141 @@
+#include "automated_planning/action_readiness.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <thread>
+
+
+void ConnectionReadinessCache::add_connection(const std::string& name, const ReadinessCheck& check)
+{
+  Connection connection;
+  connection.check = check;
+  connections_[name] = connection;
+}
+
+
+bool ConnectionReadinessCache::update(double time_s)
+{
+  bool is_all_ready = true;
+  for(auto& it : connections_)
+  {
+    is_all_ready = update(it.first, time_s) && is_all_ready;
+  }
+  return is_all_ready;
+}
+
+
+bool ConnectionReadinessCache::update(const std::string& name, double time_s)
+{
+  std::map<std::string, Connection>::iterator it = connections_.find(name);
+  if(it == connections_.end())
+  {
+    return false;
+  }
+
+  Connection& connection = it->second;
+  connection.is_ready = connection.check();
+  if(connection.is_ready)
+  {
+    connection.last_ready_s = time_s;
+  }
+  return connection.is_ready;
+}
+
+
+bool ConnectionReadinessCache::wait_until_ready(const std::string& name, double timeout_s)
+{
+  std::map<std::string, Connection>::iterator it = connections_.find(name);
+  if(it == connections_.end())
+  {
+    return false;
+  }
+
+  Connection& connection = it->second;
+  if(connection.is_ready)
+  {
+    return true;
+  }
+
+  // Polling, as the checks are non-blocking and the graph is updated by the middleware
+  const std::chrono::milliseconds poll_period(10);
+  const auto start = std::chrono::steady_clock::now();
+  const auto deadline = start + std::chrono::duration<double>(std::max(0.0, timeout_s));
+  while(! (connection.is_ready = connection.check()))
+  {
+    if(std::chrono::steady_clock::now() >= deadline)
+    {
+      return false;
+    }
+    std::this_thread::sleep_for(poll_period);
+  }
+  return true;
+}
+
+
+bool ConnectionReadinessCache::is_ready(const std::string& name) const
+{
+  std::map<std::string, Connection>::const_iterator it = connections_.find(name);
+  return it != connections_.end() && it->second.is_ready;
+}
+
+
+bool ConnectionReadinessCache::is_all_ready() const
+{
+  return std::all_of(connections_.begin(), connections_.end(),
+    [](const std::pair<const std::string, Connection>& it){ return it.second.is_ready; });
+}
+
+
+std::vector<std::string> ConnectionReadinessCache::get_unready_connections() const
+{
+  std::vector<std::string> unready_connections;
+  for(const auto& it : connections_)
+  {
+    if(! it.second.is_ready)
+    {
+      unready_connections.push_back(it.first);
+    }
+  }
+  return unready_connections;
+}
+
+
+double ConnectionReadinessCache::get_last_ready_s(const std::string& name) const
+{
+  std::map<std::string, Connection>::const_iterator it = connections_.find(name);
+  return (it != connections_.end()) ? it->second.last_ready_s : -1.0;
+}
+
+
+void ActivationLatencyStatistics::add_sample(double latency_s, bool success)
+{
+  summary_.num_activations++;
+  if(! success)
+  {
+    summary_.num_failed_activations++;
+  }
+
+  latencies_s_.push_back(latency_s);
+  while(latencies_s_.size() > window_size_)
+  {
+    latencies_s_.pop_front();
+  }
+
+  std::vector<double> sorted_latencies_s(latencies_s_.begin(), latencies_s_.end());
+  std::sort(sorted_latencies_s.begin(), sorted_latencies_s.end());
+
+  // Nearest-rank percentiles
+  auto percentile = [&sorted_latencies_s](double p)
+  {
+    size_t rank = static_cast<size_t>(std::ceil(p * sorted_latencies_s.size()));
+    return sorted_latencies_s[std::max<size_t>(rank, 1) - 1];
+  };
+
+  summary_.last_s = latency_s;
+  summary_.mean_s = std::accumulate(sorted_latencies_s.begin(), sorted_latencies_s.end(), 0.0) / sorted_latencies_s.size();
+  summary_.p50_s = percentile(0.5);
+  summary_.p95_s = percentile(0.95);
+  summary_.max_s = sorted_latencies_s.back();
+}
@@ -0,0 +1,126 @@
+#include "automated_planning/action_tick_statistics.hpp"
+
+#include <time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+
+namespace
+{
+  /**
+   * @brief [%] CPU time relative to the wall time, or zero for an empty interval
+   */
+  double get_cpu_usage(double cpu_time_s, double duration_s)
+  {
+    return (duration_s > 0.0) ? 100.0 * cpu_time_s / duration_s : 0.0;
+  }
+}
+
+
+void ActionTickStatistics::begin_activation(double time_s, double cpu_time_s)
+{
+  if(idle_start_s_ >= 0.0)
+  {
+    summary_.idle_cpu_usage = get_cpu_usage(cpu_time_s - idle_start_cpu_s_, time_s - idle_start_s_);
+  }
+
+  is_active_ = true;
+  has_pending_event_ = false;
+  activation_start_s_ = time_s;
+  activation_start_cpu_s_ = cpu_time_s;
+
+  summary_.num_activations++;
+  summary_.num_ticks = 0;
+  summary_.num_event_ticks = 0;
+  summary_.num_events = 0;
+  summary_.active_duration_s = 0.0;
+  summary_.active_cpu_usage = 0.0;
+}
+
+
+void ActionTickStatistics::end_activation(double time_s, double cpu_time_s)
+{
+  if(! is_active_)
+  {
+    return;
+  }
+  is_active_ = false;
+  summary_.active_duration_s = time_s - activation_start_s_;
+  summary_.active_cpu_usage = get_cpu_usage(cpu_time_s - activation_start_cpu_s_, summary_.active_duration_s);
+
+  idle_start_s_ = time_s;
+  idle_start_cpu_s_ = cpu_time_s;
+}
+
+
+void ActionTickStatistics::add_event(double time_s)
+{
+  if(! is_active_)
+  {
+    return;
+  }
+  summary_.num_events++;
+  if(! has_pending_event_)
+  {
+    has_pending_event_ = true;
+    pending_event_s_ = time_s;
+  }
+}
+
+
+void ActionTickStatistics::add_tick(double time_s, bool is_event_tick)
+{
+  if(! is_active_)
+  {
+    return;
+  }
+  summary_.num_ticks++;
+  if(is_event_tick)
+  {
+    summary_.num_event_ticks++;
+  }
+
+  if(has_pending_event_)
+  {
+    has_pending_event_ = false;
+    reaction_latencies_s_.push_back(std::max(0.0, time_s - pending_event_s_));
+    while(reaction_latencies_s_.size() > window_size_)
+    {
+      reaction_latencies_s_.pop_front();
+    }
+    update_reaction_summary_();
+  }
+}
+
+
+double ActionTickStatistics::get_process_cpu_time_s()
+{
+  struct timespec cpu_time;
+  if(::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_time) != 0)
+  {
+    return 0.0;
+  }
+  return cpu_time.tv_sec + 1e-9 * cpu_time.tv_nsec;
+}
+
+
+void ActionTickStatistics::update_reaction_summary_()
+{
+  std::vector<double> sorted_latencies_s(reaction_latencies_s_.begin(), reaction_latencies_s_.end());
+  std::sort(sorted_latencies_s.begin(), sorted_latencies_s.end());
+
+  // Nearest-rank percentiles
+  auto percentile = [&sorted_latencies_s](double p)
+  {
+    size_t rank = static_cast<size_t>(std::ceil(p * sorted_latencies_s.size()));
+    return sorted_latencies_s[std::max<size_t>(rank, 1) - 1];
+  };
+
+  summary_.mean_reaction_s = std::accumulate(sorted_latencies_s.begin(), sorted_latencies_s.end(), 0.0) / sorted_latencies_s.size();
+  summary_.p50_reaction_s = percentile(0.5);
+  summary_.p95_reaction_s = percentile(0.95);
+  summary_.max_reaction_s = sorted_latencies_s.back();
+}
@@ -0,0 +1,205 @@
+#include "automated_planning/anafi_kinematic_model.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+AnafiKinematicModel::AnafiKinematicModel(const AnafiKinematicParameters& params)
+: params_(params)
+, flying_state_(AnafiFlyingState::LANDED)
+, state_duration_s_(0.0)
+, position_ned_(Eigen::Vector3d::Zero())
+, velocity_ned_(Eigen::Vector3d::Zero())
+, yaw_(0.0)
+, battery_(params.initial_battery)
+, target_position_ned_(Eigen::Vector3d::Zero())
+, target_yaw_(0.0)
+{}
+
+
+void AnafiKinematicModel::step(double dt)
+{
+  if(dt <= 0)
+  {
+    return;
+  }
+  state_duration_s_ += dt;
+
+  Eigen::Vector3d desired_velocity_ned = Eigen::Vector3d::Zero();
+  switch(flying_state_)
+  {
+    case AnafiFlyingState::LANDED:
+    case AnafiFlyingState::EMERGENCY:
+    {
+      velocity_ned_.setZero();
+      return;
+    }
+    case AnafiFlyingState::MOTOR_RAMPING:
+    {
+      if(state_duration_s_ >= params_.motor_ramping_duration)
+      {
+        set_flying_state_(AnafiFlyingState::TAKINGOFF);
+      }
+      break;
+    }
+    case AnafiFlyingState::TAKINGOFF:
+    {
+      desired_velocity_ned.z() = -params_.takeoff_speed;
+      if(-position_ned_.z() >= params_.takeoff_altitude)
+      {
+        target_position_ned_ = position_ned_;
+        target_yaw_ = yaw_;
+        set_flying_state_(AnafiFlyingState::HOVERING);
+      }
+      break;
+    }
+    case AnafiFlyingState::HOVERING:
+    case AnafiFlyingState::FLYING:
+    {
+      desired_velocity_ned = get_desired_velocity_ned_(target_position_ned_);
+
+      bool is_target_reached = (target_position_ned_ - position_ned_).norm() <= params_.hover_position_tolerance
+        && velocity_ned_.norm() <= params_.hover_speed_tolerance
+        && std::abs(std::remainder(target_yaw_ - yaw_, 2 * M_PI)) <= 0.05;
+      set_flying_state_(is_target_reached ? AnafiFlyingState::HOVERING : AnafiFlyingState::FLYING);
+      break;
+    }
+    case AnafiFlyingState::LANDING:
+    {
+      desired_velocity_ned.z() = params_.landing_speed;
+      break;
+    }
+  }
+
+  // First order response towards the desired velocity
+  double alpha = std::min(1.0, dt / std::max(params_.velocity_time_constant, 1e-6));
+  velocity_ned_ += alpha * (desired_velocity_ned - velocity_ned_);
+  position_ned_ += velocity_ned_ * dt;
+
+  double yaw_error = std::remainder(target_yaw_ - yaw_, 2 * M_PI);
+  double max_yaw_change = params_.max_yaw_rate * dt;
+  yaw_ = std::remainder(yaw_ + std::clamp(yaw_error, -max_yaw_change, max_yaw_change), 2 * M_PI);
+
+  // The ground is at zero altitude
+  if(position_ned_.z() >= 0 && is_airborne_() && flying_state_ != AnafiFlyingState::TAKINGOFF)
+  {
+    position_ned_.z() = 0;
+    velocity_ned_.setZero();
+    set_flying_state_(AnafiFlyingState::LANDED);
+  }
+
+  if(is_airborne_())
+  {
+    double horizontal_speed = velocity_ned_.head<2>().norm();
+    battery_ -= (params_.battery_usage_hovering + params_.battery_usage_per_speed * horizontal_speed) * dt;
+    battery_ = std::max(0.0, battery_);
+
+    if(battery_ <= params_.battery_forced_landing && flying_state_ != AnafiFlyingState::LANDING)
+    {
+      set_flying_state_(AnafiFlyingState::LANDING);
+    }
+  }
+}
+
+
+void AnafiKinematicModel::takeoff()
+{
+  if(flying_state_ == AnafiFlyingState::LANDED && battery_ > params_.battery_forced_landing)
+  {
+    set_flying_state_(AnafiFlyingState::MOTOR_RAMPING);
+  }
+}
+
+
+void AnafiKinematicModel::land()
+{
+  if(is_airborne_())
+  {
+    set_flying_state_(AnafiFlyingState::LANDING);
+  }
+}
+
+
+void AnafiKinematicModel::move_by(double dx, double dy, double dz, double dyaw)
+{
+  if(flying_state_ != AnafiFlyingState::HOVERING && flying_state_ != AnafiFlyingState::FLYING)
+  {
+    return;
+  }
+
+  Eigen::Vector3d displacement_body(dx, dy, dz);
+  target_position_ned_ = position_ned_ + Eigen::AngleAxisd(yaw_, Eigen::Vector3d::UnitZ()) * displacement_body;
+  target_yaw_ = std::remainder(yaw_ + dyaw, 2 * M_PI);
+}
+
+
+void AnafiKinematicModel::move_to(const Eigen::Vector3d& position_ned)
+{
+  if(flying_state_ != AnafiFlyingState::HOVERING && flying_state_ != AnafiFlyingState::FLYING)
+  {
+    return;
+  }
+  target_position_ned_ = position_ned;
+}
+
+
+void AnafiKinematicModel::drain_battery(double percentage)
+{
+  battery_ = std::max(0.0, battery_ - std::max(0.0, percentage));
+}
+
+
+Eigen::Vector3d AnafiKinematicModel::get_velocity_body() const
+{
+  return Eigen::AngleAxisd(-yaw_, Eigen::Vector3d::UnitZ()) * velocity_ned_;
+}
+
+
+std::string AnafiKinematicModel::get_flying_state_string() const
+{
+  switch(flying_state_)
+  {
+    case AnafiFlyingState::LANDED:        return "FS_LANDED";
+    case AnafiFlyingState::MOTOR_RAMPING: return "FS_MOTOR_RAMPING";
+    case AnafiFlyingState::TAKINGOFF:     return "FS_TAKINGOFF";
+    case AnafiFlyingState::HOVERING:      return "FS_HOVERING";
+    case AnafiFlyingState::FLYING:        return "FS_FLYING";
+    case AnafiFlyingState::LANDING:       return "FS_LANDING";
+    case AnafiFlyingState::EMERGENCY:     return "FS_EMERGENCY";
+  }
+  return "FS_EMERGENCY";
+}
+
+
+bool AnafiKinematicModel::is_airborne_() const
+{
+  return flying_state_ == AnafiFlyingState::TAKINGOFF
+    || flying_state_ == AnafiFlyingState::HOVERING
+    || flying_state_ == AnafiFlyingState::FLYING
+    || flying_state_ == AnafiFlyingState::LANDING;
+}
+
+
+Eigen::Vector3d AnafiKinematicModel::get_desired_velocity_ned_(const Eigen::Vector3d& target_position_ned) const
+{
+  Eigen::Vector3d desired_velocity_ned = params_.position_gain * (target_position_ned - position_ned_);
+
+  double horizontal_speed = desired_velocity_ned.head<2>().norm();
+  if(horizontal_speed > params_.max_horizontal_speed)
+  {
+    desired_velocity_ned.head<2>() *= params_.max_horizontal_speed / horizontal_speed;
+  }
+  desired_velocity_ned.z() = std::clamp(desired_velocity_ned.z(), -params_.max_vertical_speed, params_.max_vertical_speed);
+
+  return desired_velocity_ned;
+}
+
+
+void AnafiKinematicModel::set_flying_state_(AnafiFlyingState flying_state)
+{
+  if(flying_state != flying_state_)
+  {
+    flying_state_ = flying_state;
+    state_duration_s_ = 0.0;
+  }
+}
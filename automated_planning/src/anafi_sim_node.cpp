@@ -0,0 +1,183 @@
+#include "automated_planning/anafi_sim_node.hpp"
+
+#include <cmath>
+
+
+namespace
+{
+  constexpr double EARTH_RADIUS_M = 6371000.0;
+  constexpr double DEG_TO_RAD = M_PI / 180.0;
+}
+
+
+void AnafiSimNode::step_timer_cb_()
+{
+  model_->step(step_size_s_);
+  sim_time_ += rclcpp::Duration::from_seconds(step_size_s_);
+
+  rosgraph_msgs::msg::Clock clock_msg;
+  clock_msg.clock = sim_time_;
+  clock_pub_->publish(clock_msg);
+
+  // State changes are published immediately, as the action nodes react on them
+  std::string flying_state = model_->get_flying_state_string();
+  bool is_state_changed = (flying_state != last_flying_state_);
+  last_flying_state_ = flying_state;
+
+  time_since_publish_s_ += step_size_s_;
+  if(time_since_publish_s_ >= publish_period_s_ || is_state_changed)
+  {
+    time_since_publish_s_ = 0.0;
+    publish_measurements_();
+  }
+}
+
+
+void AnafiSimNode::publish_measurements_()
+{
+  const Eigen::Vector3d& position_ned = model_->get_position_ned();
+  Eigen::Vector3d velocity_body = model_->get_velocity_body();
+
+  std_msgs::msg::String state_msg;
+  state_msg.data = last_flying_state_;
+  state_pub_->publish(state_msg);
+
+  geometry_msgs::msg::PointStamped ned_pos_msg;
+  ned_pos_msg.header.stamp = sim_time_;
+  ned_pos_msg.header.frame_id = "ned";
+  ned_pos_msg.point.x = position_ned.x();
+  ned_pos_msg.point.y = position_ned.y();
+  ned_pos_msg.point.z = position_ned.z();
+  ned_pos_pub_->publish(ned_pos_msg);
+
+  sensor_msgs::msg::NavSatFix gnss_msg;
+  gnss_msg.header.stamp = sim_time_;
+  ned_to_geodetic_(position_ned.x(), position_ned.y(), gnss_msg.latitude, gnss_msg.longitude);
+  gnss_msg.altitude = -position_ned.z();
+  gnss_pub_->publish(gnss_msg);
+
+  Eigen::Quaterniond attitude(Eigen::AngleAxisd(model_->get_yaw(), Eigen::Vector3d::UnitZ()));
+  geometry_msgs::msg::QuaternionStamped attitude_msg;
+  attitude_msg.header.stamp = sim_time_;
+  attitude_msg.quaternion.w = attitude.w();
+  attitude_msg.quaternion.x = attitude.x();
+  attitude_msg.quaternion.y = attitude.y();
+  attitude_msg.quaternion.z = attitude.z();
+  attitude_pub_->publish(attitude_msg);
+
+  geometry_msgs::msg::TwistStamped polled_vel_msg;
+  polled_vel_msg.header.stamp = sim_time_;
+  polled_vel_msg.twist.linear.x = velocity_body.x();
+  polled_vel_msg.twist.linear.y = velocity_body.y();
+  polled_vel_msg.twist.linear.z = velocity_body.z();
+  polled_vel_pub_->publish(polled_vel_msg);
+
+  // The Anafi reports the battery in whole percentages
+  std_msgs::msg::Float64 battery_msg;
+  battery_msg.data = (battery_resolution_ > 0)
+    ? battery_resolution_ * std::floor(model_->get_battery() / battery_resolution_)
+    : model_->get_battery();
+  battery_pub_->publish(battery_msg);
+
+  // The helipad is at the origin. The EKF estimates the position relative to the helipad
+  // while the helipad is detected
+  bool is_helipad_detected = position_ned.head<2>().norm() <= helipad_detection_radius_;
+
+  anafi_uav_interfaces::msg::Float32Stamped apriltags_detected_msg;
+  apriltags_detected_msg.header.stamp = sim_time_;
+  apriltags_detected_msg.data = is_helipad_detected ? 1.0 : 0.0;
+  apriltags_detected_pub_->publish(apriltags_detected_msg);
+
+  if(is_helipad_detected)
+  {
+    geometry_msgs::msg::PoseWithCovarianceStamped ekf_msg;
+    ekf_msg.header.stamp = sim_time_;
+    ekf_msg.header.frame_id = "helipad";
+    ekf_msg.pose.pose.position = ned_pos_msg.point;
+    ekf_msg.pose.pose.orientation = attitude_msg.quaternion;
+    ekf_pub_->publish(ekf_msg);
+  }
+}
+
+
+void AnafiSimNode::ned_to_geodetic_(double north, double east, double& latitude_deg, double& longitude_deg) const
+{
+  latitude_deg = origin_latitude_deg_ + north / EARTH_RADIUS_M / DEG_TO_RAD;
+  longitude_deg = origin_longitude_deg_ + east / (EARTH_RADIUS_M * std::cos(origin_latitude_deg_ * DEG_TO_RAD)) / DEG_TO_RAD;
+}
+
+
+void AnafiSimNode::geodetic_to_ned_(double latitude_deg, double longitude_deg, double& north, double& east) const
+{
+  north = (latitude_deg - origin_latitude_deg_) * DEG_TO_RAD * EARTH_RADIUS_M;
+  east = (longitude_deg - origin_longitude_deg_) * DEG_TO_RAD * EARTH_RADIUS_M * std::cos(origin_latitude_deg_ * DEG_TO_RAD);
+}
+
+
+void AnafiSimNode::cmd_takeoff_cb_(std_msgs::msg::Empty::ConstSharedPtr)
+{
+  RCLCPP_INFO(this->get_logger(), "Takeoff");
+  model_->takeoff();
+}
+
+
+void AnafiSimNode::cmd_land_cb_(std_msgs::msg::Empty::ConstSharedPtr)
+{
+  RCLCPP_INFO(this->get_logger(), "Land");
+  model_->land();
+}
+
+
+void AnafiSimNode::cmd_moveby_cb_(anafi_uav_interfaces::msg::MoveByCommand::ConstSharedPtr moveby_msg)
+{
+  model_->move_by(moveby_msg->dx, moveby_msg->dy, moveby_msg->dz, moveby_msg->dyaw);
+}
+
+
+void AnafiSimNode::cmd_moveto_cb_(anafi_uav_interfaces::msg::MoveToCommand::ConstSharedPtr moveto_msg)
+{
+  // The altitude is relative to the takeoff position
+  double north, east;
+  geodetic_to_ned_(moveto_msg->latitude, moveto_msg->longitude, north, east);
+  model_->move_to(Eigen::Vector3d(north, east, -moveto_msg->altitude));
+}
+
+
+void AnafiSimNode::desired_ned_position_cb_(geometry_msgs::msg::PointStamped::ConstSharedPtr desired_position_msg)
+{
+  // The desired position is also published for logging, and is only followed when the
+  // velocity controller is enabled
+  if(! is_velocity_controller_enabled_)
+  {
+    return;
+  }
+  const geometry_msgs::msg::Point& point = desired_position_msg->point;
+  model_->move_to(Eigen::Vector3d(point.x, point.y, point.z));
+}
+
+
+void AnafiSimNode::battery_drop_cb_(std_msgs::msg::Float64::ConstSharedPtr battery_drop_msg)
+{
+  RCLCPP_INFO(this->get_logger(), "Battery drop of %.1f %%", battery_drop_msg->data);
+  model_->drain_battery(battery_drop_msg->data);
+}
+
+
+void AnafiSimNode::enable_velocity_control_srv_cb_(
+  const std::shared_ptr<std_srvs::srv::SetBool::Request> request,
+  std::shared_ptr<std_srvs::srv::SetBool::Response> response)
+{
+  is_velocity_controller_enabled_ = request->data;
+  response->success = true;
+  response->message = is_velocity_controller_enabled_ ? "Velocity controller enabled" : "Velocity controller disabled";
+}
+
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  rclcpp::spin(std::make_shared<AnafiSimNode>());
+  rclcpp::shutdown();
+
+  return 0;
+}
@@ -0,0 +1,140 @@
+#include "automated_planning/battery_estimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+
+BatteryDischargeEstimator::BatteryDischargeEstimator(
+  double default_rate,
+  double forgetting_factor,
+  double min_segment_duration,
+  double max_segment_duration
+)
+: default_rate_(std::max(0.0, default_rate))
+, forgetting_factor_(std::clamp(forgetting_factor, 0.5, 1.0))
+, min_segment_duration_(std::max(1.0, min_segment_duration))
+, max_segment_duration_(std::max(min_segment_duration_, max_segment_duration))
+{
+  observation_variance_ = std::pow(1.0 / min_segment_duration_, 2);
+}
+
+
+void BatteryDischargeEstimator::set_prior(const std::string& action_type, double rate)
+{
+  DischargeRateEstimate estimate;
+  estimate.rate = std::max(0.0, rate);
+  // Allow the prior to be off by 50 %
+  estimate.variance = std::pow(0.5 * estimate.rate, 2) + 1e-6;
+  estimates_[action_type] = estimate;
+}
+
+
+bool BatteryDischargeEstimator::add_sample(double time_s, double battery_charge, const std::string& action_type)
+{
+  if(! std::isfinite(battery_charge) || battery_charge < 0)
+  {
+    return false;
+  }
+
+  if(! segment_active_)
+  {
+    start_segment_(time_s, battery_charge, action_type);
+    return false;
+  }
+
+  // Recharging or a new battery. The segment cannot be used
+  if(battery_charge > segment_start_charge_)
+  {
+    start_segment_(time_s, battery_charge, action_type);
+    return false;
+  }
+
+  double segment_duration = time_s - segment_start_time_s_;
+  bool action_changed = (action_type.compare(segment_action_type_) != 0);
+  if(! action_changed && segment_duration < max_segment_duration_)
+  {
+    return false;
+  }
+
+  bool updated = close_segment_(time_s, battery_charge);
+  start_segment_(time_s, battery_charge, action_type);
+  return updated;
+}
+
+
+double BatteryDischargeEstimator::get_rate(const std::string& action_type, bool conservative) const
+{
+  std::map<std::string, DischargeRateEstimate>::const_iterator it = estimates_.find(action_type);
+  if(it == estimates_.end())
+  {
+    return default_rate_;
+  }
+
+  const DischargeRateEstimate& estimate = it->second;
+  if(conservative)
+  {
+    return estimate.rate + 2.0 * std::sqrt(estimate.variance);
+  }
+  return estimate.rate;
+}
+
+
+int BatteryDischargeEstimator::get_num_observations(const std::string& action_type) const
+{
+  std::map<std::string, DischargeRateEstimate>::const_iterator it = estimates_.find(action_type);
+  return (it == estimates_.end()) ? 0 : it->second.num_observations;
+}
+
+
+std::string BatteryDischargeEstimator::to_string() const
+{
+  std::stringstream ss;
+  ss << "Discharge rates: [action] [%/s] [std %/s] [observations]\n";
+  for(const auto& [action_type, estimate] : estimates_)
+  {
+    ss << action_type << "\t" << estimate.rate << "\t" << std::sqrt(estimate.variance) << "\t" << estimate.num_observations << "\n";
+  }
+  return ss.str();
+}
+
+
+void BatteryDischargeEstimator::start_segment_(double time_s, double battery_charge, const std::string& action_type)
+{
+  segment_active_ = true;
+  segment_action_type_ = action_type;
+  segment_start_time_s_ = time_s;
+  segment_start_charge_ = battery_charge;
+}
+
+
+bool BatteryDischargeEstimator::close_segment_(double time_s, double battery_charge)
+{
+  double segment_duration = time_s - segment_start_time_s_;
+  if(segment_action_type_.empty() || segment_duration < min_segment_duration_)
+  {
+    return false;
+  }
+
+  std::map<std::string, DischargeRateEstimate>::iterator it = estimates_.find(segment_action_type_);
+  if(it == estimates_.end())
+  {
+    set_prior(segment_action_type_, default_rate_);
+    it = estimates_.find(segment_action_type_);
+  }
+  DischargeRateEstimate& estimate = it->second;
+
+  // Scalar recursive least squares with forgetting factor. The observation variance is
+  // scaled with the segment duration, as the quantization error is constant
+  double observed_rate = (segment_start_charge_ - battery_charge) / segment_duration;
+  double scaled_observation_variance = observation_variance_ * std::pow(min_segment_duration_ / segment_duration, 2);
+
+  double predicted_variance = estimate.variance / forgetting_factor_;
+  double gain = predicted_variance / (predicted_variance + scaled_observation_variance);
+
+  estimate.rate = std::max(0.0, estimate.rate + gain * (observed_rate - estimate.rate));
+  estimate.variance = (1.0 - gain) * predicted_variance;
+  estimate.num_observations++;
+
+  return true;
+}
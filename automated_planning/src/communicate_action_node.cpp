@@ -9,23 +9,35 @@
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
 
 #include "std_msgs/msg/string.hpp"
-#include "anafi_uav_interfaces/srv/set_finished_action.hpp"
+
+#include "automated_planning/action_activation_monitor.hpp"
+#include "automated_planning/action_completion_publisher.hpp"
+#include "automated_planning/adaptive_action_executor_client.hpp"
 
 using namespace std::chrono_literals;
 
 class CommunicateActionNode 
-  : public plansys2::ActionExecutorClient
+  : public AdaptiveActionExecutorClient
 {
 public:
   CommunicateActionNode()
-  : plansys2::ActionExecutorClient("communicate_action_node", 500ms)
+  : AdaptiveActionExecutorClient("communicate_action_node", 500ms, false)
   {
-    set_finished_action_client_ = this->create_client<anafi_uav_interfaces::srv::SetFinishedAction>("/mission_controller/finished_action");
+    activation_monitor_ = std::make_unique<ActionActivationMonitor>(this);
+    completion_pub_ = std::make_unique<ActionCompletionPublisher>(this);
   }
 
 // Lifecycle-events
+LifecycleNodeInterface::CallbackReturn on_configure(const rclcpp_lifecycle::State & previous_state)
+{
+  activation_monitor_->start();
+  completion_pub_->start();
+  return AdaptiveActionExecutorClient::on_configure(previous_state);
+}
+
 LifecycleNodeInterface::CallbackReturn on_activate(const rclcpp_lifecycle::State & previous_state)
 {
+  ActionActivationMonitor::ActivationScope activation(*activation_monitor_);
   RCLCPP_INFO(this->get_logger(), "Trying to activate communicate");
 
   const std::string location = get_arguments()[1];
@@ -36,56 +48,21 @@ LifecycleNodeInterface::CallbackReturn on_activate(const rclcpp_lifecycle::State
 
   set_communicate_action_finished_();
 
-  return ActionExecutorClient::on_activate(previous_state);
+  return activation.succeeded(AdaptiveActionExecutorClient::on_activate(previous_state));
 }
 
 private:  
-  rclcpp::Client<anafi_uav_interfaces::srv::SetFinishedAction>::SharedPtr set_finished_action_client_;
+  std::unique_ptr<ActionActivationMonitor> activation_monitor_;
+  std::unique_ptr<ActionCompletionPublisher> completion_pub_;
 
   void do_work()
   {
   }
 
-  bool set_communicate_action_finished_(const std::string& argument="")
+  void set_communicate_action_finished_()
   {
-    auto request = std::make_shared<anafi_uav_interfaces::srv::SetFinishedAction::Request>();
-    
-    std_msgs::msg::String action_name_msg = std_msgs::msg::String();
-    action_name_msg.data = "communicate";
-
-    std_msgs::msg::String location_msg = std_msgs::msg::String();
-    location_msg.data = get_arguments()[1]; // get_arguments returns { drone, location, person }
-
-    constexpr int num_args = 2; // Hardcoded for now
-    
-    std::vector<std_msgs::msg::String> argument_msg; 
-    
-    std_msgs::msg::String arg;
-    arg.data = get_arguments()[2];
-    argument_msg.push_back(arg);
-
-    arg.data = argument;
-    argument_msg.push_back(arg);
-
-    request->finished_action_name = action_name_msg;
-    request->location = location_msg;
-    request->arguments = argument_msg;
-    request->num_arguments = num_args;
-
-    if (! set_finished_action_client_->wait_for_service(1s)) 
-    {
-      RCLCPP_ERROR(this->get_logger(), "Service not available");
-      return false;
-    }
-
-    auto result = set_finished_action_client_->async_send_request(request);
-    if (rclcpp::spin_until_future_complete(this->get_node_base_interface(), result) != rclcpp::FutureReturnCode::SUCCESS)
-    {
-      RCLCPP_ERROR(this->get_logger(), "Unable to set action as finished!");
-      return false;
-    }
-
-    return true;
+    // get_arguments returns { drone, location, person }
+    completion_pub_->publish(CompletedAction::COMMUNICATE, get_arguments()[1], get_arguments()[2]);
   }
 };
 
@@ -37,10 +37,44 @@ bool DropMarkerActionNode::check_drop_preconditions()
 }
 
 
+bool DropMarkerActionNode::set_detected_person_from_arguments_()
+{
+  // get_arguments returns { drone, location, person, marker }. The person is named after the ID of the track
+  std::string person = get_arguments()[2];
+  std::string str_id = std::regex_replace(person, std::regex(R"([^0-9])"), "");
+  if(str_id.empty())
+  {
+    return false;
+  }
+
+  std::map<int, std::tuple<geometry_msgs::msg::Point, Severity>>::iterator it = person_tracks_.find(std::stoi(str_id));
+  if(it == person_tracks_.end())
+  {
+    return false;
+  }
+  detected_person_ = it->second;
+  return true;
+}
+
+
+LifecycleNodeInterface::CallbackReturn DropMarkerActionNode::on_configure(const rclcpp_lifecycle::State & previous_state)
+{
+  activation_monitor_->start();
+  completion_pub_->start();
+  return AdaptiveActionExecutorClient::on_configure(previous_state);
+}
+
+
 LifecycleNodeInterface::CallbackReturn DropMarkerActionNode::on_activate(const rclcpp_lifecycle::State & previous_state)
 {
+  ActionActivationMonitor::ActivationScope activation(*activation_monitor_);
   RCLCPP_INFO(this->get_logger(), "Trying to activate drop marker");
 
+  if(! set_detected_person_from_arguments_())
+  {
+    RCLCPP_WARN(this->get_logger(), "Person " + get_arguments()[2] + " is not tracked. Using the previous detection");
+  }
+
   bool preconditions_satisfied = check_drop_preconditions();
   if(! preconditions_satisfied)
   {
@@ -51,7 +85,7 @@ LifecycleNodeInterface::CallbackReturn DropMarkerActionNode::on_activate(const r
   send_feedback(0.0, "Prechecks finished. Cleared to drop marker!");
   RCLCPP_INFO(this->get_logger(), "Dropping marker activated");
   
-  return ActionExecutorClient::on_activate(previous_state);
+  return activation.succeeded(AdaptiveActionExecutorClient::on_activate(previous_state));
 }
 
 
@@ -118,60 +152,25 @@ void DropMarkerActionNode::update_controller_of_marker_status_()
   auto request = std::make_shared<anafi_uav_interfaces::srv::SetEquipmentNumbers::Request>();
   request->num_equipment = num_markers_;
 
-  if (! set_num_markers_client_->wait_for_service(1s)) 
-  {
-    RCLCPP_ERROR(this->get_logger(), "Service for updating number of markers not available!");
-    return;
-  }
+  AsyncCallOptions options;
+  options.max_retries = 2;
 
-  auto result = set_num_markers_client_->async_send_request(request);
-  if (rclcpp::spin_until_future_complete(this->get_node_base_interface(), result) != rclcpp::FutureReturnCode::SUCCESS)
-  {
-    RCLCPP_ERROR(this->get_logger(), "Failed to call service");
-  } 
+  set_num_markers_client_->call(request,
+    [this](anafi_uav_interfaces::srv::SetEquipmentNumbers::Response::SharedPtr response)
+    {
+      if(! response)
+      {
+        RCLCPP_ERROR(this->get_logger(), "Unable to update the number of markers in the mission controller!");
+      }
+    },
+    options);
 }
 
 
-bool DropMarkerActionNode::set_drop_action_finished_(const std::string& argument)
+void DropMarkerActionNode::set_drop_action_finished_()
 {
-  auto request = std::make_shared<anafi_uav_interfaces::srv::SetFinishedAction::Request>();
-  
-  std_msgs::msg::String action_name_msg = std_msgs::msg::String();
-  action_name_msg.data = "mark";
-
-  std_msgs::msg::String location_msg = std_msgs::msg::String();
-  location_msg.data = get_arguments()[1]; // get_arguments returns { drone, location, person, marker }
-
-  constexpr int num_args = 2; // Hardcoded for now
-  
-  std::vector<std_msgs::msg::String> argument_msg; 
-  
-  std_msgs::msg::String arg;
-  arg.data = get_arguments()[2];
-  argument_msg.push_back(arg);
-
-  arg.data = argument;
-  argument_msg.push_back(arg);
-
-  request->finished_action_name = action_name_msg;
-  request->location = location_msg;
-  request->arguments = argument_msg;
-  request->num_arguments = num_args;
-
-  if (! set_finished_action_client_->wait_for_service(1s)) 
-  {
-    RCLCPP_ERROR(this->get_logger(), "Service not available");
-    return false;
-  }
-
-  auto result = set_finished_action_client_->async_send_request(request);
-  if (rclcpp::spin_until_future_complete(this->get_node_base_interface(), result) != rclcpp::FutureReturnCode::SUCCESS)
-  {
-    RCLCPP_ERROR(this->get_logger(), "Unable to set action as finished!");
-    return false;
-  }
-
-  return true;
+  // get_arguments returns { drone, location, person, marker }
+  completion_pub_->publish(CompletedAction::MARK, get_arguments()[1], get_arguments()[2]);
 }
 
 
@@ -196,52 +195,15 @@ void DropMarkerActionNode::ned_pos_cb_(geometry_msgs::msg::PointStamped::ConstSh
 }
 
 
-void DropMarkerActionNode::detected_person_cb_(anafi_uav_interfaces::msg::DetectedPerson::ConstSharedPtr detected_person_msg)
+void DropMarkerActionNode::person_tracks_cb_(anafi_uav_interfaces::msg::PersonTrackArray::ConstSharedPtr person_tracks_msg)
 {
-  // Could be a bit problematic if there are multiple detections arriving at the same time,
-  // for example that there are two people in the image 
-
-  // This implementation assumes at most one person will be detected at a time
-
-  // Using a vector for now, to allow for lambda
-  std::vector<geometry_msgs::msg::Point> detected_people = { std::get<0>(detected_person_) };
-
-  geometry_msgs::msg::Point position = detected_person_msg->position;
-  Severity severity = Severity(detected_person_msg->severity);
-
-  const double allowed_distance = 2.0; // Discuss this with Simen
-  auto lambda = [&position, &allowed_distance](geometry_msgs::msg::Point pt)
-  { 
-    return (std::sqrt(std::pow((pt.x - position.x), 2) + std::pow((pt.y - position.y), 2)) <= allowed_distance); 
-  };
-
-  auto helped_it = std::find_if(
-    previously_helped_people_.begin(), 
-    previously_helped_people_.end(), 
-    lambda
-  );
-
-  auto detected_it = std::find_if(
-    detected_people.begin(), 
-    detected_people.end(), 
-    lambda
-  );
-
-  if(helped_it != previously_helped_people_.end() || detected_it != detected_people.end())
+  for(const anafi_uav_interfaces::msg::PersonTrack& track : person_tracks_msg->tracks)
   {
-    // Previously detected
-    RCLCPP_INFO_THROTTLE(this->get_logger(), *this->get_clock(), 5000, "Detected person previously...");
-    return;
-  } 
-
-  // TODO: This will currently cause information about previously detected people to be lost!
-  // Implement this in a better way, if one allows for multiple people within the frame
-  detected_person_ = std::make_tuple(position, severity);
+    person_tracks_[static_cast<int>(track.id)] = std::make_tuple(track.position, Severity(track.severity));
+  }
 }
 
 
-
-
 int main(int argc, char** argv)
 {
   rclcpp::init(argc, argv);
@@ -0,0 +1,251 @@
+#include "automated_planning/execution_feedback_aggregator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+
+namespace
+{
+  const char* status_to_string(ActionStatus status)
+  {
+    switch(status)
+    {
+      case ActionStatus::NOT_EXECUTED:
+        return "waiting";
+      case ActionStatus::EXECUTING:
+        return "executing";
+      case ActionStatus::FAILED:
+        return "failed";
+      case ActionStatus::SUCCEEDED:
+        return "succeeded";
+      case ActionStatus::CANCELLED:
+        return "cancelled";
+    }
+    return "unknown";
+  }
+
+
+  double mean(const std::deque<double>& values)
+  {
+    if(values.empty())
+    {
+      return 0.0;
+    }
+    return std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+  }
+
+
+  double percentile(const std::deque<double>& values, double p)
+  {
+    if(values.empty())
+    {
+      return 0.0;
+    }
+    std::vector<double> sorted_values(values.begin(), values.end());
+    std::sort(sorted_values.begin(), sorted_values.end());
+
+    // Nearest rank
+    size_t rank = static_cast<size_t>(std::ceil(p * sorted_values.size()));
+    return sorted_values[std::clamp<size_t>(rank, 1, sorted_values.size()) - 1];
+  }
+}
+
+
+ExecutionFeedbackAggregator::ExecutionFeedbackAggregator(size_t window_size)
+: window_size_(std::max<size_t>(window_size, 1))
+, is_plan_started_(false)
+, plan_start_time_s_(0.0)
+{}
+
+
+void ExecutionFeedbackAggregator::start_plan(const std::vector<PlannedAction>& plan, double start_time_s)
+{
+  for(ActionTiming& timing : actions_)
+  {
+    if(timing.actual_start_s >= 0 && ! timing.is_finished)
+    {
+      timing.status = ActionStatus::CANCELLED;
+      timing.actual_duration_s = std::max(0.0, start_time_s - plan_start_time_s_ - timing.actual_start_s);
+      finish_action_(timing);
+    }
+  }
+
+  actions_.clear();
+  assigned_actions_.clear();
+  for(const PlannedAction& planned_action : plan)
+  {
+    ActionTiming timing;
+    timing.action = planned_action.action;
+    // The plan item is on the form (action arg_0 arg_1 ...)
+    timing.action_type = planned_action.action.substr(1, planned_action.action.find_first_of(" )") - 1);
+    timing.planned_start_s = planned_action.start_s;
+    timing.planned_duration_s = planned_action.duration_s;
+    actions_.push_back(timing);
+  }
+  std::stable_sort(actions_.begin(), actions_.end(),
+    [](const ActionTiming& a, const ActionTiming& b){ return a.planned_start_s < b.planned_start_s; });
+
+  is_plan_started_ = true;
+  plan_start_time_s_ = start_time_s;
+}
+
+
+void ExecutionFeedbackAggregator::update(const std::vector<ActionFeedbackSample>& samples, double time_s)
+{
+  if(! is_plan_started_)
+  {
+    return;
+  }
+
+  for(const ActionFeedbackSample& sample : samples)
+  {
+    std::map<std::string, size_t>::iterator it = assigned_actions_.find(sample.action_full_name);
+    if(it == assigned_actions_.end())
+    {
+      std::string action_str = "(" + sample.action_type;
+      for(const std::string& argument : sample.arguments)
+      {
+        action_str += " " + argument;
+      }
+      action_str += ")";
+
+      size_t idx = 0;
+      for(; idx < actions_.size(); idx++)
+      {
+        bool is_assigned = std::any_of(assigned_actions_.begin(), assigned_actions_.end(),
+          [idx](const std::pair<const std::string, size_t>& assigned){ return assigned.second == idx; });
+        if(actions_[idx].action == action_str && ! is_assigned)
+        {
+          break;
+        }
+      }
+      if(idx == actions_.size())
+      {
+        // Not part of the current plan, for example feedback remaining from the previous plan
+        continue;
+      }
+      it = assigned_actions_.emplace(sample.action_full_name, idx).first;
+    }
+
+    ActionTiming& timing = actions_[it->second];
+    if(timing.is_finished)
+    {
+      continue;
+    }
+
+    timing.status = sample.status;
+    timing.completion = std::clamp(sample.completion, 0.0, 1.0);
+    if(sample.status == ActionStatus::NOT_EXECUTED)
+    {
+      continue;
+    }
+
+    if(timing.actual_start_s < 0)
+    {
+      timing.actual_start_s = std::max(0.0, sample.start_time_s - plan_start_time_s_);
+    }
+
+    if(sample.status == ActionStatus::EXECUTING)
+    {
+      timing.actual_duration_s = std::max(0.0, time_s - plan_start_time_s_ - timing.actual_start_s);
+    }
+    else
+    {
+      timing.actual_duration_s = std::max(0.0, sample.status_time_s - plan_start_time_s_ - timing.actual_start_s);
+      finish_action_(timing);
+    }
+  }
+}
+
+
+double ExecutionFeedbackAggregator::get_plan_elapsed_s(double time_s) const
+{
+  return is_plan_started_ ? time_s - plan_start_time_s_ : 0.0;
+}
+
+
+std::vector<ActionTypeStatistics> ExecutionFeedbackAggregator::get_statistics() const
+{
+  std::vector<ActionTypeStatistics> statistics;
+  for(const std::pair<const std::string, TypeHistory>& history : histories_)
+  {
+    ActionTypeStatistics type_statistics;
+    type_statistics.action_type = history.first;
+    type_statistics.num_succeeded = history.second.num_succeeded;
+    type_statistics.num_failed = history.second.num_failed;
+    type_statistics.total_actual_s = history.second.total_actual_s;
+    type_statistics.total_planned_s = history.second.total_planned_s;
+    type_statistics.mean_duration_error_s = mean(history.second.duration_errors_s);
+    type_statistics.p95_duration_error_s = percentile(history.second.duration_errors_s, 0.95);
+    type_statistics.mean_start_delay_s = mean(history.second.start_delays_s);
+    statistics.push_back(type_statistics);
+  }
+  return statistics;
+}
+
+
+std::string ExecutionFeedbackAggregator::to_string() const
+{
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(1);
+  ss << "Plan actions [planned start + duration | actual start + duration]:\n";
+  for(const ActionTiming& timing : actions_)
+  {
+    ss << "  " << timing.action << " " << status_to_string(timing.status)
+      << " " << 100.0 * timing.completion << " %"
+      << " [" << timing.planned_start_s << " + " << timing.planned_duration_s << " s | ";
+    if(timing.actual_start_s < 0)
+    {
+      ss << "-";
+    }
+    else
+    {
+      ss << timing.actual_start_s << " + " << timing.actual_duration_s << " s";
+    }
+    ss << "]\n";
+  }
+
+  ss << "Action types [succeeded/failed, total actual/planned, mean and p95 duration error, mean start delay]:\n";
+  for(const ActionTypeStatistics& statistics : get_statistics())
+  {
+    ss << "  " << statistics.action_type << ": "
+      << statistics.num_succeeded << "/" << statistics.num_failed << ", "
+      << statistics.total_actual_s << "/" << statistics.total_planned_s << " s, "
+      << statistics.mean_duration_error_s << " s, " << statistics.p95_duration_error_s << " s, "
+      << statistics.mean_start_delay_s << " s\n";
+  }
+  return ss.str();
+}
+
+
+void ExecutionFeedbackAggregator::finish_action_(ActionTiming& timing)
+{
+  timing.is_finished = true;
+
+  TypeHistory& history = histories_[timing.action_type];
+  history.total_actual_s += timing.actual_duration_s;
+  if(timing.status != ActionStatus::SUCCEEDED)
+  {
+    // Interrupted actions say nothing about the accuracy of the planned duration
+    history.num_failed++;
+    return;
+  }
+
+  history.num_succeeded++;
+  history.total_planned_s += timing.planned_duration_s;
+  push_to_window_(history.duration_errors_s, timing.actual_duration_s - timing.planned_duration_s);
+  push_to_window_(history.start_delays_s, timing.actual_start_s - timing.planned_start_s);
+}
+
+
+void ExecutionFeedbackAggregator::push_to_window_(std::deque<double>& window, double value) const
+{
+  window.push_back(value);
+  while(window.size() > window_size_)
+  {
+    window.pop_front();
+  }
+}
@@ -0,0 +1,362 @@
+#include "automated_planning/goal_analysis.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "automated_planning/numeric_program.hpp"
+
+
+namespace
+{
+  const double INF = std::numeric_limits<double>::infinity();
+
+
+  /**
+   * @brief The values a function can take. Only the upper bound becomes +inf, and only the lower
+   * bound becomes -inf
+   */
+  struct Interval
+  {
+    double lo;
+    double hi;
+  };
+
+
+  /**
+   * @brief Product of two bounds, where 0 * inf is 0 as every finite value times 0 is
+   */
+  double multiply_bounds(double a, double b)
+  {
+    double product = a * b;
+    return std::isnan(product) ? 0.0 : product;
+  }
+
+
+  Interval get_hull(std::initializer_list<double> bounds)
+  {
+    return Interval{ std::min(bounds), std::max(bounds) };
+  }
+
+
+  /**
+   * @brief The interval of the values of the expression, or std::nullopt if a function is undefined
+   */
+  std::optional<Interval> evaluate(const NumericExpression& expression, const std::unordered_map<std::string, Interval>& intervals)
+  {
+    switch(expression.type)
+    {
+      case NumericExpression::Type::NUMBER:
+        return Interval{ expression.value, expression.value };
+      case NumericExpression::Type::DURATION:
+        return Interval{ 0.0, INF };
+      case NumericExpression::Type::FUNCTION:
+      {
+        std::unordered_map<std::string, Interval>::const_iterator it = intervals.find(expression.function.to_string());
+        if(it == intervals.end())
+        {
+          return std::nullopt;
+        }
+        return it->second;
+      }
+      default:
+        break;
+    }
+
+    std::optional<Interval> lhs = evaluate(expression.operands[0], intervals);
+    std::optional<Interval> rhs = evaluate(expression.operands[1], intervals);
+    if(! lhs.has_value() || ! rhs.has_value())
+    {
+      return std::nullopt;
+    }
+    const Interval& a = lhs.value();
+    const Interval& b = rhs.value();
+    switch(expression.type)
+    {
+      case NumericExpression::Type::ADD:
+        return Interval{ a.lo + b.lo, a.hi + b.hi };
+      case NumericExpression::Type::SUBTRACT:
+        return Interval{ a.lo - b.hi, a.hi - b.lo };
+      case NumericExpression::Type::MULTIPLY:
+        return get_hull({ multiply_bounds(a.lo, b.lo), multiply_bounds(a.lo, b.hi), multiply_bounds(a.hi, b.lo), multiply_bounds(a.hi, b.hi) });
+      default:
+        break;
+    }
+    if(b.lo <= 0.0 && b.hi >= 0.0)
+    {
+      return Interval{ -INF, INF };
+    }
+    return get_hull({ multiply_bounds(a.lo, 1.0 / b.lo), multiply_bounds(a.lo, 1.0 / b.hi), multiply_bounds(a.hi, 1.0 / b.lo), multiply_bounds(a.hi, 1.0 / b.hi) });
+  }
+
+
+  /**
+   * @brief Whether the comparison holds for any values in the intervals
+   */
+  bool can_compare(Comparator comparator, const Interval& lhs, const Interval& rhs)
+  {
+    switch(comparator)
+    {
+      case Comparator::LESS:
+        return lhs.lo < rhs.hi;
+      case Comparator::LESS_OR_EQUAL:
+        return lhs.lo <= rhs.hi;
+      case Comparator::EQUAL:
+        return lhs.lo <= rhs.hi + 1e-9 && rhs.lo <= lhs.hi + 1e-9;
+      case Comparator::GREATER_OR_EQUAL:
+        return lhs.hi >= rhs.lo;
+      case Comparator::GREATER:
+        return lhs.hi > rhs.lo;
+    }
+    return false;
+  }
+
+
+  /**
+   * @brief Extends the interval to include the values. A bound which changes after the exact
+   * passes is widened to infinity, such that the analysis reaches its fixpoint
+   *
+   * @return Whether the interval changed
+   */
+  bool extend(Interval& interval, const Interval& values, bool is_exact)
+  {
+    bool is_changed = false;
+    if(values.lo < interval.lo)
+    {
+      interval.lo = is_exact ? values.lo : -INF;
+      is_changed = true;
+    }
+    if(values.hi > interval.hi)
+    {
+      interval.hi = is_exact ? values.hi : INF;
+      is_changed = true;
+    }
+    return is_changed;
+  }
+}
+
+
+std::string GoalAnalysisStatistics::to_string() const
+{
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(1);
+  ss << "Goal analysis in " << 1e3 * duration_s << " ms: "
+    << num_reachable_actions << "/" << num_ground_actions << " ground actions reachable. "
+    << num_satisfied << " satisfied and " << num_unreachable << " unreachable of " << num_analyses << " goals";
+  return ss.str();
+}
+
+
+GoalAnalysis::GoalAnalysis(std::shared_ptr<const PddlDomain> domain)
+: domain_(domain)
+{
+}
+
+
+bool GoalAnalysis::is_satisfied(const PddlProblem& problem)
+{
+  std::unordered_set<std::string> facts;
+  for(const PddlAtom& predicate : problem.predicates)
+  {
+    facts.insert(predicate.to_string());
+  }
+  std::unordered_map<std::string, double> values;
+  for(const std::pair<PddlAtom, double>& function : problem.functions)
+  {
+    values[function.first.to_string()] = function.second;
+  }
+  auto function_value = [&values](const PddlAtom& function) -> std::optional<double>
+  {
+    std::unordered_map<std::string, double>::const_iterator it = values.find(function.to_string());
+    if(it == values.end())
+    {
+      return std::nullopt;
+    }
+    return it->second;
+  };
+
+  for(const PddlCondition& goal : problem.goals)
+  {
+    switch(goal.type)
+    {
+      case PddlCondition::Type::PREDICATE:
+        if(! facts.count(goal.predicate.to_string()))
+        {
+          return false;
+        }
+        break;
+      case PddlCondition::Type::NEGATED_PREDICATE:
+        if(facts.count(goal.predicate.to_string()))
+        {
+          return false;
+        }
+        break;
+      case PddlCondition::Type::COMPARISON:
+      {
+        std::optional<double> lhs = goal.lhs.evaluate(function_value);
+        std::optional<double> rhs = goal.rhs.evaluate(function_value);
+        if(! lhs.has_value() || ! rhs.has_value() || ! compare(goal.comparator, lhs.value(), rhs.value()))
+        {
+          return false;
+        }
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+
+GoalStatus GoalAnalysis::analyze(const PddlProblem& problem, std::vector<PddlCondition>& unreachable_goals)
+{
+  std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+  statistics_.num_analyses++;
+  statistics_.num_ground_actions = 0;
+  statistics_.num_reachable_actions = 0;
+  unreachable_goals.clear();
+  auto get_duration_s = [&start_time]()
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+  };
+
+  if(is_satisfied(problem))
+  {
+    statistics_.num_satisfied++;
+    statistics_.duration_s = get_duration_s();
+    return GoalStatus::SATISFIED;
+  }
+
+  std::vector<DurativeAction> actions;
+  domain_->ground_actions(problem, [&actions](DurativeAction&& action){ actions.push_back(std::move(action)); });
+  statistics_.num_ground_actions = actions.size();
+
+  // A fact can be false if it is not true initially, or is deleted by a reachable action
+  std::unordered_set<std::string> initial_facts;
+  for(const PddlAtom& predicate : problem.predicates)
+  {
+    initial_facts.insert(predicate.to_string());
+  }
+  std::unordered_set<std::string> true_facts = initial_facts;
+  std::unordered_set<std::string> deleted_facts;
+  std::unordered_map<std::string, Interval> intervals;
+  for(const std::pair<PddlAtom, double>& function : problem.functions)
+  {
+    intervals[function.first.to_string()] = Interval{ function.second, function.second };
+  }
+
+  auto can_hold = [&](const PddlCondition& condition)
+  {
+    switch(condition.type)
+    {
+      case PddlCondition::Type::PREDICATE:
+        return true_facts.count(condition.predicate.to_string()) > 0;
+      case PddlCondition::Type::NEGATED_PREDICATE:
+      {
+        const std::string key = condition.predicate.to_string();
+        return ! initial_facts.count(key) || deleted_facts.count(key);
+      }
+      case PddlCondition::Type::COMPARISON:
+        break;
+    }
+    std::optional<Interval> lhs = evaluate(condition.lhs, intervals);
+    std::optional<Interval> rhs = evaluate(condition.rhs, intervals);
+    return lhs.has_value() && rhs.has_value() && can_compare(condition.comparator, lhs.value(), rhs.value());
+  };
+
+  // The effects of the reachable actions are applied on every pass, as the intervals of their
+  // values may have grown since the last pass
+  const size_t num_exact_passes = 8;
+  std::vector<bool> is_reachable(actions.size(), false);
+  bool is_changed = true;
+  for(size_t pass = 0; is_changed; pass++)
+  {
+    is_changed = false;
+    const bool is_exact = (pass < num_exact_passes);
+    for(size_t action_idx = 0; action_idx < actions.size(); action_idx++)
+    {
+      const DurativeAction& action = actions[action_idx];
+      if(! is_reachable[action_idx])
+      {
+        const bool is_applicable = std::all_of(action.at_start_conditions.begin(), action.at_start_conditions.end(), can_hold)
+          && std::all_of(action.over_all_conditions.begin(), action.over_all_conditions.end(), can_hold)
+          && std::all_of(action.at_end_conditions.begin(), action.at_end_conditions.end(), can_hold);
+        if(! is_applicable)
+        {
+          continue;
+        }
+        is_reachable[action_idx] = true;
+        statistics_.num_reachable_actions++;
+        is_changed = true;
+      }
+
+      for(const std::vector<PddlEffect>* effects : { &action.at_start_effects, &action.at_end_effects })
+      {
+        for(const PddlEffect& effect : *effects)
+        {
+          const std::string key = effect.atom.to_string();
+          if(effect.type == PddlEffect::Type::ADD)
+          {
+            is_changed = true_facts.insert(key).second || is_changed;
+            continue;
+          }
+          if(effect.type == PddlEffect::Type::DELETE)
+          {
+            is_changed = deleted_facts.insert(key).second || is_changed;
+            continue;
+          }
+
+          // The planner does not apply an effect with an undefined value
+          std::optional<Interval> value = evaluate(effect.value, intervals);
+          if(! value.has_value())
+          {
+            continue;
+          }
+          std::unordered_map<std::string, Interval>::iterator it = intervals.find(key);
+          if(effect.type == PddlEffect::Type::ASSIGN)
+          {
+            if(it == intervals.end())
+            {
+              intervals[key] = value.value();
+              is_changed = true;
+            }
+            else
+            {
+              is_changed = extend(it->second, value.value(), is_exact) || is_changed;
+            }
+            continue;
+          }
+          if(it == intervals.end())
+          {
+            continue;
+          }
+
+          // Repeating the action changes the function without bound
+          const Interval change = (effect.type == PddlEffect::Type::INCREASE) ? value.value() : Interval{ -value->hi, -value->lo };
+          const Interval reachable_values{ (change.lo < 0.0) ? -INF : it->second.lo, (change.hi > 0.0) ? INF : it->second.hi };
+          is_changed = extend(it->second, reachable_values, true) || is_changed;
+        }
+      }
+    }
+  }
+
+  for(const PddlCondition& goal : problem.goals)
+  {
+    if(! can_hold(goal))
+    {
+      unreachable_goals.push_back(goal);
+    }
+  }
+  statistics_.duration_s = get_duration_s();
+  if(! unreachable_goals.empty())
+  {
+    statistics_.num_unreachable++;
+    return GoalStatus::UNREACHABLE;
+  }
+  return GoalStatus::OPEN;
+}
@@ -0,0 +1,395 @@
+#include "automated_planning/knowledge_mirror.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+
+
+namespace
+{
+  /**
+   * @brief Splits a PDDL expression into parentheses and lowercase symbols
+   */
+  std::vector<std::string> tokenize(const std::string& str)
+  {
+    std::vector<std::string> tokens;
+    std::string token;
+    for(char c : str)
+    {
+      if(c == '(' || c == ')' || std::isspace(static_cast<unsigned char>(c)))
+      {
+        if(! token.empty())
+        {
+          tokens.push_back(token);
+          token.clear();
+        }
+        if(c == '(' || c == ')')
+        {
+          tokens.push_back(std::string(1, c));
+        }
+        continue;
+      }
+      token.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+    if(! token.empty())
+    {
+      tokens.push_back(token);
+    }
+    return tokens;
+  }
+
+
+  /**
+   * @brief Parses "name arg0 ..." from tokens[idx] until the closing parenthesis
+   */
+  std::optional<PddlAtom> parse_atom_tokens(const std::vector<std::string>& tokens, size_t& idx)
+  {
+    PddlAtom atom;
+    while(idx < tokens.size() && tokens[idx] != ")")
+    {
+      if(tokens[idx] == "(")
+      {
+        return std::nullopt;
+      }
+      if(atom.name.empty())
+      {
+        atom.name = tokens[idx];
+      }
+      else
+      {
+        atom.arguments.push_back(tokens[idx]);
+      }
+      idx++;
+    }
+    if(idx >= tokens.size() || atom.name.empty())
+    {
+      return std::nullopt;
+    }
+    idx++; // Closing parenthesis
+    return atom;
+  }
+}
+
+
+std::optional<PddlAtom> PddlAtom::parse(const std::string& str)
+{
+  std::vector<std::string> tokens = tokenize(str);
+  if(tokens.size() < 3 || tokens.front() != "(")
+  {
+    return std::nullopt;
+  }
+  size_t idx = 1;
+  std::optional<PddlAtom> atom = parse_atom_tokens(tokens, idx);
+  if(! atom.has_value() || idx != tokens.size())
+  {
+    return std::nullopt;
+  }
+  return atom;
+}
+
+
+std::string PddlAtom::to_string() const
+{
+  std::string str = "(" + name;
+  for(const std::string& argument : arguments)
+  {
+    str += " " + argument;
+  }
+  return str + ")";
+}
+
+
+KnowledgeMirror::KnowledgeMirror()
+: num_local_queries_(0)
+, num_remote_queries_(0)
+, num_synchronizations_(0)
+, version_(0)
+{}
+
+
+void KnowledgeMirror::add_instance(const std::string& name, const std::string& type)
+{
+  std::string lowercase_name = name;
+  std::transform(lowercase_name.begin(), lowercase_name.end(), lowercase_name.begin(), ::tolower);
+  instances_[lowercase_name] = type;
+  version_++;
+}
+
+
+void KnowledgeMirror::add_predicate(const std::string& predicate)
+{
+  std::optional<PddlAtom> atom = PddlAtom::parse(predicate);
+  if(! atom.has_value())
+  {
+    return;
+  }
+  std::string key = atom->to_string();
+  predicates_.insert(key);
+  predicates_by_name_[atom->name].insert(key);
+  version_++;
+}
+
+
+void KnowledgeMirror::remove_predicate(const std::string& predicate)
+{
+  std::optional<PddlAtom> atom = PddlAtom::parse(predicate);
+  if(! atom.has_value())
+  {
+    return;
+  }
+  std::string key = atom->to_string();
+  predicates_.erase(key);
+
+  auto it = predicates_by_name_.find(atom->name);
+  if(it != predicates_by_name_.end())
+  {
+    it->second.erase(key);
+    if(it->second.empty())
+    {
+      predicates_by_name_.erase(it);
+    }
+  }
+  version_++;
+}
+
+
+void KnowledgeMirror::set_function(const std::string& function)
+{
+  // "(= (name args) value)", "(= name value)" or "(name args) value"
+  std::vector<std::string> tokens = tokenize(function);
+  if(tokens.size() < 4 || tokens[0] != "(")
+  {
+    return;
+  }
+
+  size_t idx = (tokens[1] == "=") ? 2 : 0;
+  PddlAtom atom;
+  if(tokens[idx] == "(")
+  {
+    idx++;
+    std::optional<PddlAtom> parsed_atom = parse_atom_tokens(tokens, idx);
+    if(! parsed_atom.has_value())
+    {
+      return;
+    }
+    atom = parsed_atom.value();
+  }
+  else
+  {
+    atom.name = tokens[idx++];
+  }
+
+  if(idx >= tokens.size())
+  {
+    return;
+  }
+  char* end = nullptr;
+  double value = std::strtod(tokens[idx].c_str(), &end);
+  if(end == tokens[idx].c_str())
+  {
+    return;
+  }
+  functions_[atom.to_string()] = value;
+  version_++;
+}
+
+
+void KnowledgeMirror::set_goal(const std::string& goal)
+{
+  goal_ = goal;
+  version_++;
+}
+
+
+void KnowledgeMirror::clear_goal()
+{
+  goal_.clear();
+  version_++;
+}
+
+
+void KnowledgeMirror::clear()
+{
+  instances_.clear();
+  predicates_.clear();
+  predicates_by_name_.clear();
+  functions_.clear();
+  goal_.clear();
+  version_++;
+}
+
+
+void KnowledgeMirror::synchronize(
+  const std::vector<std::string>& instances,
+  const std::vector<std::string>& predicates,
+  const std::vector<std::string>& functions,
+  const std::string& goal)
+{
+  // The types of known instances are kept, as the notification only contains the names
+  std::map<std::string, std::string> previous_instances;
+  previous_instances.swap(instances_);
+  clear();
+
+  for(const std::string& instance : instances)
+  {
+    std::string name = instance;
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    auto it = previous_instances.find(name);
+    instances_[name] = (it != previous_instances.end()) ? it->second : std::string();
+  }
+  for(const std::string& predicate : predicates)
+  {
+    add_predicate(predicate);
+  }
+  for(const std::string& function : functions)
+  {
+    set_function(function);
+  }
+  goal_ = goal;
+  num_synchronizations_++;
+  version_++;
+}
+
+
+bool KnowledgeMirror::has_predicate(const std::string& name, const std::vector<std::string>& arguments) const
+{
+  PddlAtom atom{ name, arguments };
+  std::optional<PddlAtom> normalized_atom = PddlAtom::parse(atom.to_string());
+  num_local_queries_++;
+  return normalized_atom.has_value() && predicates_.count(normalized_atom->to_string()) > 0;
+}
+
+
+bool KnowledgeMirror::has_predicate(const std::string& predicate) const
+{
+  std::optional<PddlAtom> atom = PddlAtom::parse(predicate);
+  num_local_queries_++;
+  return atom.has_value() && predicates_.count(atom->to_string()) > 0;
+}
+
+
+std::vector<PddlAtom> KnowledgeMirror::get_predicates(const std::string& name) const
+{
+  num_local_queries_++;
+
+  std::vector<PddlAtom> atoms;
+  std::string lowercase_name = name;
+  std::transform(lowercase_name.begin(), lowercase_name.end(), lowercase_name.begin(), ::tolower);
+  auto it = predicates_by_name_.find(lowercase_name);
+  if(it == predicates_by_name_.end())
+  {
+    return atoms;
+  }
+  for(const std::string& key : it->second)
+  {
+    atoms.push_back(PddlAtom::parse(key).value());
+  }
+  // Sorted, such that the result does not depend on the hashing
+  std::sort(atoms.begin(), atoms.end(),
+    [](const PddlAtom& a, const PddlAtom& b){ return a.arguments < b.arguments; });
+  return atoms;
+}
+
+
+std::optional<double> KnowledgeMirror::get_function(const std::string& name, const std::vector<std::string>& arguments) const
+{
+  num_local_queries_++;
+
+  std::optional<PddlAtom> atom = PddlAtom::parse(PddlAtom{ name, arguments }.to_string());
+  if(! atom.has_value())
+  {
+    return std::nullopt;
+  }
+  auto it = functions_.find(atom->to_string());
+  if(it == functions_.end())
+  {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+
+const std::string& KnowledgeMirror::get_goal() const
+{
+  num_local_queries_++;
+  return goal_;
+}
+
+
+std::vector<std::pair<std::string, std::string>> KnowledgeMirror::get_instances() const
+{
+  num_local_queries_++;
+  return std::vector<std::pair<std::string, std::string>>(instances_.begin(), instances_.end());
+}
+
+
+std::vector<PddlAtom> KnowledgeMirror::get_all_predicates() const
+{
+  num_local_queries_++;
+
+  std::vector<std::string> keys(predicates_.begin(), predicates_.end());
+  std::sort(keys.begin(), keys.end());
+  std::vector<PddlAtom> atoms;
+  for(const std::string& key : keys)
+  {
+    atoms.push_back(PddlAtom::parse(key).value());
+  }
+  return atoms;
+}
+
+
+std::vector<std::pair<PddlAtom, double>> KnowledgeMirror::get_all_functions() const
+{
+  num_local_queries_++;
+
+  std::map<std::string, double> sorted_functions(functions_.begin(), functions_.end());
+  std::vector<std::pair<PddlAtom, double>> functions;
+  for(const std::pair<const std::string, double>& function : sorted_functions)
+  {
+    functions.emplace_back(PddlAtom::parse(function.first).value(), function.second);
+  }
+  return functions;
+}
+
+
+std::string KnowledgeMirror::to_string() const
+{
+  num_local_queries_++;
+
+  std::stringstream ss;
+  ss << "Instances:\n";
+  for(const std::pair<const std::string, std::string>& instance : instances_)
+  {
+    ss << "  " << instance.first << (instance.second.empty() ? "" : " - " + instance.second) << "\n";
+  }
+
+  // Sorted for readability
+  std::vector<std::string> predicates(predicates_.begin(), predicates_.end());
+  std::sort(predicates.begin(), predicates.end());
+  ss << "Predicates:\n";
+  for(const std::string& predicate : predicates)
+  {
+    ss << "  " << predicate << "\n";
+  }
+
+  std::map<std::string, double> functions(functions_.begin(), functions_.end());
+  ss << "Functions:\n";
+  for(const std::pair<const std::string, double>& function : functions)
+  {
+    ss << "  (= " << function.first << " " << function.second << ")\n";
+  }
+
+  ss << "Goal:\n  " << goal_ << "\n";
+  return ss.str();
+}
+
+
+std::string KnowledgeMirror::get_statistics_string() const
+{
+  std::stringstream ss;
+  ss << "Knowledge mirror: " << predicates_.size() << " predicates, " << functions_.size() << " functions. "
+    << num_local_queries_ << " queries answered locally, " << num_remote_queries_ << " remote queries, "
+    << num_synchronizations_ << " synchronizations";
+  return ss.str();
+}
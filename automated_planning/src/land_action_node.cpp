@@ -26,8 +26,8 @@ bool LandActionNode::check_land_preconditions()
     return false;
   }
 
-  // Check that the velocity controller is available, and disable it
-  if(! enable_velocity_control_client_->wait_for_service(2s))
+  // Check that the velocity controller is available, and enable it
+  if(! activation_monitor_->wait_until_ready(enable_velocity_control_client_->get_client()))
   {
     RCLCPP_ERROR(this->get_logger(), "Velocity controller not found!");
     return false;
@@ -39,8 +39,16 @@ bool LandActionNode::check_land_preconditions()
 }
 
 
+LifecycleNodeInterface::CallbackReturn LandActionNode::on_configure(const rclcpp_lifecycle::State & previous_state)
+{
+  activation_monitor_->start();
+  return AdaptiveActionExecutorClient::on_configure(previous_state);
+}
+
+
 LifecycleNodeInterface::CallbackReturn LandActionNode::on_activate(const rclcpp_lifecycle::State & previous_state)
 {
+  ActionActivationMonitor::ActivationScope activation(*activation_monitor_);
   RCLCPP_INFO(this->get_logger(), "Trying to activate land");
 
   bool preconditions_satisfied = check_land_preconditions();
@@ -57,7 +65,7 @@ LifecycleNodeInterface::CallbackReturn LandActionNode::on_activate(const rclcpp_
   cmd_land_pub_->on_activate();
   desired_position_pub_->on_activate();
   
-  return ActionExecutorClient::on_activate(previous_state);
+  return activation.succeeded(AdaptiveActionExecutorClient::on_activate(previous_state));
 }
 
 
@@ -66,7 +74,7 @@ LifecycleNodeInterface::CallbackReturn LandActionNode::on_deactivate(const rclcp
   cmd_land_pub_->on_deactivate();
   desired_position_pub_->on_deactivate();
 
-  return ActionExecutorClient::on_deactivate(state);
+  return AdaptiveActionExecutorClient::on_deactivate(state);
 }
 
 
@@ -188,7 +196,7 @@ void LandActionNode::do_work()
     }
   }
 
-  RCLCPP_INFO(this->get_logger(), "Current state idx (INIT = 0, HOVER_DIRECTLY_ABOVE = 1, LAND = 2): " + std::to_string(int(landing_state_)));
+  RCLCPP_INFO_THROTTLE(this->get_logger(), *this->get_clock(), 1000, "Current state idx (INIT = 0, HOVER_DIRECTLY_ABOVE = 1, LAND = 2): " + std::to_string(int(landing_state_)));
 
   desired_position_ = landing_points_[landing_state_];
   publish_desired_position_();
@@ -208,7 +216,7 @@ bool LandActionNode::check_inside_no_go_zone()
 
   std::stringstream ss;
   ss << "Altitudal bounds: (" << altitudal_bounds.first << ", " << altitudal_bounds.second << ") [(m, m)]" << "m\n";
-  RCLCPP_INFO(this->get_logger(), ss.str());
+  RCLCPP_INFO_THROTTLE(this->get_logger(), *this->get_clock(), 1000, ss.str());
   return (point.z < altitudal_bounds.first || point.z > altitudal_bounds.second);
 }
 
@@ -229,7 +237,7 @@ bool LandActionNode::check_target_position_achieved()
 
   std::stringstream ss;
   ss << "Horizontal distance = " << horizontal_distance << " m, and vertical distance = " << vertical_distance << "m\n";
-  RCLCPP_INFO(this->get_logger(), ss.str());
+  RCLCPP_INFO_THROTTLE(this->get_logger(), *this->get_clock(), 1000, ss.str());
 
   return (horizontal_distance <= horizontal_radius_of_acceptance) && (vertical_distance <= vertical_radius_of_acceptance); 
 }
@@ -293,11 +301,27 @@ std::pair<double, double> LandActionNode::get_altitude_bounds_(const LandingStat
 void LandActionNode::set_controller_state_(bool enable_controller, const std::string& log_str)
 {
   RCLCPP_WARN(this->get_logger(), log_str);
-  enable_velocity_control_client_->wait_for_service(1s);
   auto request = std::make_shared<std_srvs::srv::SetBool::Request>();
   request->data = enable_controller;
-  auto result = enable_velocity_control_client_->async_send_request(request);
   is_gnc_activated_ = enable_controller; 
+
+  AsyncCallOptions options;
+  options.timeout_s = 1.0;
+  options.max_retries = 1;
+
+  enable_velocity_control_client_->call(request,
+    [this, enable_controller](std_srvs::srv::SetBool::Response::SharedPtr response)
+    {
+      if(! response || ! response->success)
+      {
+        RCLCPP_ERROR(this->get_logger(), "GNC did not confirm the request");
+        if(is_gnc_activated_ == enable_controller)
+        {
+          is_gnc_activated_ = ! enable_controller;
+        }
+      }
+    },
+    options);
 }
 
 
@@ -311,6 +335,7 @@ void LandActionNode::anafi_state_cb_(std_msgs::msg::String::ConstSharedPtr state
     return;
   }
   anafi_state_ = state;
+  wake_();
 }
 
 
@@ -318,6 +343,7 @@ void LandActionNode::ekf_cb_(geometry_msgs::msg::PoseWithCovarianceStamped::Cons
 {
   ekf_output_.header = ekf_msg->header;
   ekf_output_.pose = ekf_msg->pose;
+  wake_();
 }
 
 
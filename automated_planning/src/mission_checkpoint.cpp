@@ -0,0 +1,367 @@
+#include "automated_planning/mission_checkpoint.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+
+namespace
+{
+  const uint32_t MAGIC = 0x4b43524d;        // "MRCK" in little-endian
+  const uint32_t VERSION = 3;
+
+
+  double get_wall_time_s()
+  {
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+  }
+
+
+  uint64_t get_checksum(const char* data, size_t size)
+  {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for(size_t i = 0; i < size; i++)
+    {
+      hash ^= static_cast<uint8_t>(data[i]);
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+
+  class Encoder
+  {
+  public:
+    template<typename T>
+    void put(const T& value)
+    {
+      data_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void put_string(const std::string& str)
+    {
+      put(static_cast<uint32_t>(str.size()));
+      data_ += str;
+    }
+
+    void put_strings(const std::vector<std::string>& strings)
+    {
+      put(static_cast<uint32_t>(strings.size()));
+      for(const std::string& str : strings)
+      {
+        put_string(str);
+      }
+    }
+
+    std::string& get_data() { return data_; }
+
+  private:
+    std::string data_;
+  };
+
+
+  /**
+   * @brief Reads the fields in the order they were encoded. A read past the end fails, and all
+   * reads after a failed read fail
+   */
+  class Decoder
+  {
+  public:
+    Decoder(const std::string& data, size_t size)
+    : data_(data)
+    , size_(size)
+    , pos_(0)
+    , is_ok_(true)
+    {}
+
+    template<typename T>
+    bool get(T& value)
+    {
+      if(! is_ok_ || size_ - pos_ < sizeof(T))
+      {
+        is_ok_ = false;
+        return false;
+      }
+      std::memcpy(&value, data_.data() + pos_, sizeof(T));
+      pos_ += sizeof(T);
+      return true;
+    }
+
+    bool get_string(std::string& str)
+    {
+      uint32_t size;
+      if(! get(size) || size_ - pos_ < size)
+      {
+        is_ok_ = false;
+        return false;
+      }
+      str.assign(data_, pos_, size);
+      pos_ += size;
+      return true;
+    }
+
+    bool get_strings(std::vector<std::string>& strings)
+    {
+      uint32_t num_strings;
+      if(! get(num_strings))
+      {
+        return false;
+      }
+      strings.clear();
+      for(uint32_t i = 0; i < num_strings; i++)
+      {
+        std::string str;
+        if(! get_string(str))
+        {
+          return false;
+        }
+        strings.push_back(str);
+      }
+      return true;
+    }
+
+    bool is_ok() const { return is_ok_; }
+    bool is_at_end() const { return pos_ == size_; }
+
+  private:
+    const std::string& data_;
+    size_t size_;
+    size_t pos_;
+    bool is_ok_;
+  };
+}
+
+
+std::string MissionCheckpoint::serialize() const
+{
+  Encoder encoder;
+  encoder.put(MAGIC);
+  encoder.put(VERSION);
+  encoder.put(wall_time_s);
+  encoder.put(node_time_s);
+  encoder.put(mission_hash);
+  encoder.put(static_cast<int32_t>(controller_state));
+  encoder.put(static_cast<int32_t>(num_markers));
+  encoder.put(static_cast<int32_t>(num_lifevests));
+
+  encoder.put_string(landed_goal);
+  encoder.put_string(preferred_landing_goal);
+  encoder.put_strings(possible_landing_goals);
+  encoder.put_strings(search_goals);
+  encoder.put_strings(communicate_location_goals);
+  encoder.put_strings(mark_location_goals);
+  encoder.put_strings(rescue_location_goals);
+
+  encoder.put(static_cast<uint32_t>(detected_people.size()));
+  for(const DetectedPersonCheckpoint& person : detected_people)
+  {
+    encoder.put(static_cast<int32_t>(person.id));
+    encoder.put(person.x);
+    encoder.put(person.y);
+    encoder.put(person.z);
+    encoder.put(static_cast<int32_t>(person.severity));
+    encoder.put(static_cast<uint8_t>(person.is_helped));
+  }
+  encoder.put(static_cast<uint32_t>(plan.size()));
+  for(const PlannedAction& planned_action : plan)
+  {
+    encoder.put_string(planned_action.action);
+    encoder.put(planned_action.start_s);
+    encoder.put(planned_action.duration_s);
+  }
+
+  encoder.put(static_cast<uint32_t>(instances.size()));
+  for(const std::pair<std::string, std::string>& instance : instances)
+  {
+    encoder.put_string(instance.first);
+    encoder.put_string(instance.second);
+  }
+  encoder.put_strings(predicates);
+  encoder.put(static_cast<uint32_t>(functions.size()));
+  for(const std::pair<std::string, double>& function : functions)
+  {
+    encoder.put_string(function.first);
+    encoder.put(function.second);
+  }
+
+  std::string& data = encoder.get_data();
+  encoder.put(get_checksum(data.data(), data.size()));
+  return data;
+}
+
+
+uint64_t MissionCheckpoint::get_hash(const std::string& data)
+{
+  return get_checksum(data.data(), data.size());
+}
+
+
+double MissionCheckpoint::get_age_s() const
+{
+  return get_wall_time_s() - wall_time_s;
+}
+
+
+std::optional<MissionCheckpoint> MissionCheckpoint::deserialize(const std::string& data)
+{
+  uint64_t checksum;
+  if(data.size() < sizeof(checksum))
+  {
+    return std::nullopt;
+  }
+  const size_t size = data.size() - sizeof(checksum);
+  std::memcpy(&checksum, data.data() + size, sizeof(checksum));
+  if(checksum != get_checksum(data.data(), size))
+  {
+    return std::nullopt;
+  }
+
+  Decoder decoder(data, size);
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  if(! decoder.get(magic) || ! decoder.get(version) || magic != MAGIC || version != VERSION)
+  {
+    return std::nullopt;
+  }
+
+  MissionCheckpoint checkpoint;
+  int32_t controller_state = 0;
+  int32_t num_markers = 0;
+  int32_t num_lifevests = 0;
+  decoder.get(checkpoint.wall_time_s);
+  decoder.get(checkpoint.node_time_s);
+  decoder.get(checkpoint.mission_hash);
+  decoder.get(controller_state);
+  decoder.get(num_markers);
+  decoder.get(num_lifevests);
+  checkpoint.controller_state = controller_state;
+  checkpoint.num_markers = num_markers;
+  checkpoint.num_lifevests = num_lifevests;
+
+  decoder.get_string(checkpoint.landed_goal);
+  decoder.get_string(checkpoint.preferred_landing_goal);
+  decoder.get_strings(checkpoint.possible_landing_goals);
+  decoder.get_strings(checkpoint.search_goals);
+  decoder.get_strings(checkpoint.communicate_location_goals);
+  decoder.get_strings(checkpoint.mark_location_goals);
+  decoder.get_strings(checkpoint.rescue_location_goals);
+
+  uint32_t num_people = 0;
+  decoder.get(num_people);
+  for(uint32_t i = 0; i < num_people && decoder.is_ok(); i++)
+  {
+    int32_t id = 0;
+    int32_t severity = 0;
+    uint8_t is_helped = 0;
+    DetectedPersonCheckpoint person{};
+    decoder.get(id);
+    decoder.get(person.x);
+    decoder.get(person.y);
+    decoder.get(person.z);
+    decoder.get(severity);
+    decoder.get(is_helped);
+    person.id = id;
+    person.severity = severity;
+    person.is_helped = (is_helped != 0);
+    checkpoint.detected_people.push_back(person);
+  }
+  uint32_t num_plan_items = 0;
+  decoder.get(num_plan_items);
+  for(uint32_t i = 0; i < num_plan_items && decoder.is_ok(); i++)
+  {
+    PlannedAction planned_action;
+    decoder.get_string(planned_action.action);
+    decoder.get(planned_action.start_s);
+    decoder.get(planned_action.duration_s);
+    checkpoint.plan.push_back(planned_action);
+  }
+
+  uint32_t num_instances = 0;
+  decoder.get(num_instances);
+  for(uint32_t i = 0; i < num_instances && decoder.is_ok(); i++)
+  {
+    std::pair<std::string, std::string> instance;
+    decoder.get_string(instance.first);
+    decoder.get_string(instance.second);
+    checkpoint.instances.push_back(instance);
+  }
+  decoder.get_strings(checkpoint.predicates);
+  uint32_t num_functions = 0;
+  decoder.get(num_functions);
+  for(uint32_t i = 0; i < num_functions && decoder.is_ok(); i++)
+  {
+    std::pair<std::string, double> function;
+    decoder.get_string(function.first);
+    decoder.get(function.second);
+    checkpoint.functions.push_back(function);
+  }
+
+  if(! decoder.is_ok() || ! decoder.is_at_end())
+  {
+    return std::nullopt;
+  }
+  return checkpoint;
+}
+
+
+MissionCheckpointFile::MissionCheckpointFile(const std::string& path)
+: path_(path)
+, num_writes_(0)
+{
+}
+
+
+bool MissionCheckpointFile::write(const MissionCheckpoint& checkpoint)
+{
+  MissionCheckpoint stamped_checkpoint = checkpoint;
+  stamped_checkpoint.wall_time_s = 0.0;
+  stamped_checkpoint.node_time_s = 0.0;
+  std::string untimed_data = stamped_checkpoint.serialize();
+  if(untimed_data == last_data_)
+  {
+    return true;
+  }
+
+  const std::string temporary_path = path_ + ".tmp";
+  {
+    std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+    stamped_checkpoint.wall_time_s = get_wall_time_s();
+    stamped_checkpoint.node_time_s = checkpoint.node_time_s;
+    const std::string data = stamped_checkpoint.serialize();
+    if(! file.write(data.data(), data.size()))
+    {
+      return false;
+    }
+  }
+  if(std::rename(temporary_path.c_str(), path_.c_str()) != 0)
+  {
+    std::remove(temporary_path.c_str());
+    return false;
+  }
+  last_data_ = std::move(untimed_data);
+  num_writes_++;
+  return true;
+}
+
+
+std::optional<MissionCheckpoint> MissionCheckpointFile::read() const
+{
+  std::ifstream file(path_, std::ios::binary);
+  if(! file)
+  {
+    return std::nullopt;
+  }
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return MissionCheckpoint::deserialize(ss.str());
+}
+
+
+void MissionCheckpointFile::remove()
+{
+  std::remove(path_.c_str());
+  last_data_.clear();
+}
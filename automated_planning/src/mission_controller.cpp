@@ -3,20 +3,344 @@
 
 void MissionControllerNode::init()
 {
+  startup_timeline_.mark("constructed");
+
+  startup_timeline_.begin("plansys2_clients");
+  init_plansys2_clients_();
+  startup_timeline_.end("plansys2_clients");
+
+  // The checkpoint is only resumed for the same domain, which requires the domain expert
+  startup_timeline_.begin("checkpoint");
+  std::optional<MissionCheckpoint> checkpoint = init_checkpoint_();
+  startup_timeline_.end("checkpoint");
+
+  // The static knowledge only depends on the parameters, and is pushed while waiting for the
+  // telemetry. A resumed mission loads its knowledge from the checkpoint instead
+  std::optional<StaticKnowledge> static_knowledge;
+  std::future<bool> is_static_knowledge_pushed;
+  double static_knowledge_start_s = 0.0;
+  double static_knowledge_end_s = 0.0;
+  if(! checkpoint.has_value())
+  {
+    static_knowledge = get_static_knowledge_();
+    is_static_knowledge_pushed = std::async(std::launch::async, 
+      [this, &static_knowledge, &static_knowledge_start_s, &static_knowledge_end_s]()
+      {
+        static_knowledge_start_s = StartupTimeline::get_wall_time_s();
+        bool is_pushed = push_static_knowledge_(static_knowledge.value());
+        static_knowledge_end_s = StartupTimeline::get_wall_time_s();
+        return is_pushed;
+      });
+  }
+
   // Verify that the system is set correctly
-  check_controller_preconditions_();
+  startup_timeline_.begin("preconditions");
+  check_controller_preconditions_(checkpoint.has_value());
+  startup_timeline_.end("preconditions");
+
+  if(is_static_knowledge_pushed.valid())
+  {
+    if(! is_static_knowledge_pushed.get())
+    {
+      RCLCPP_WARN(this->get_logger(), "The problem expert rejected some of the static knowledge. Pushing all knowledge again");
+      static_knowledge.reset();
+    }
+    startup_timeline_.add("static_knowledge", static_knowledge_start_s, static_knowledge_end_s);
+  }
+
+  startup_timeline_.begin("init_planning");
+  init_planning_(checkpoint, static_knowledge);
+  startup_timeline_.end("init_planning");
+
+  startup_timeline_.begin("first_plan");
+  publish_startup_timeline_();
+}
+
+
+void MissionControllerNode::start()
+{
+  // On the node clock, such that the mission runs at the rate of the simulation with use_sim_time
+  step_timer_ = rclcpp::create_timer(this, this->get_clock(), 
+    rclcpp::Duration(std::chrono::milliseconds(100)), std::bind(&MissionControllerNode::step_timer_cb_, this), planning_callback_group_);
+}
+
+
+void MissionControllerNode::step_timer_cb_()
+{
+  try
+  {
+    apply_pending_inputs_(MissionControllerChannel::STEP);
+    step();
+  }
+  catch(const std::exception& e)
+  {
+    // An exception would terminate the executor thread
+    RCLCPP_FATAL(this->get_logger(), "Mission controller stopped: %s", e.what());
+    step_timer_->cancel();
+    rclcpp::shutdown();
+  }
+}
+
+
+void MissionControllerNode::defer_input_(std::function<void()> input)
+{
+  std::lock_guard<std::mutex> lock(pending_inputs_mutex_);
+  pending_inputs_.push_back(std::move(input));
+}
+
 
+void MissionControllerNode::apply_pending_inputs_(MissionControllerChannel channel)
+{
+  // The inputs are applied without holding the lock, such that the callback groups are never 
+  // blocked by the controller
+  std::deque<std::function<void()>> inputs;
+  {
+    std::lock_guard<std::mutex> lock(pending_inputs_mutex_);
+    record_telemetry_(channel);
+    inputs.swap(pending_inputs_);
+  }
+  for(std::function<void()>& input : inputs)
+  {
+    input();
+  }
+}
+
+
+void MissionControllerNode::init_planning_(
+  const std::optional<MissionCheckpoint>& checkpoint, 
+  const std::optional<StaticKnowledge>& pushed_static_knowledge)
+{
+  if(! problem_expert_)
+  {
+    init_plansys2_clients_();
+  }
+  init_plan_validity_monitor_();
+
+  if(checkpoint.has_value())
+  {
+    restore_checkpoint_(checkpoint.value());
+  }
+  else
+  {
+    init_knowledge_(pushed_static_knowledge); 
+    init_mission_goals_();
+  }
+  update_plansys2_functions_();
+
+  publish_plan_status_str_(checkpoint.has_value() ? "Resuming" : "Starting");
+}
+
+
+void MissionControllerNode::init_plansys2_clients_()
+{
   // Sometimes these fail to initialize
   domain_expert_ = std::make_shared<plansys2::DomainExpertClient>();
   planner_client_ = std::make_shared<plansys2::PlannerClient>();
   problem_expert_ = std::make_shared<plansys2::ProblemExpertClient>();
   executor_client_ = std::make_shared<plansys2::ExecutorClient>();
+}
 
-  init_knowledge_(); 
-  init_mission_goals_();
-  update_plansys2_functions_();
 
-  publish_plan_status_str_("Starting");
+void MissionControllerNode::publish_startup_timeline_()
+{
+  startup_timeline_pub_->publish(to_startup_timeline_msg(startup_timeline_));
+}
+
+
+std::optional<MissionCheckpoint> MissionControllerNode::init_checkpoint_()
+{
+  std::string checkpoint_prefix = "checkpoint.";
+  if(! this->get_parameter(checkpoint_prefix + "enabled").as_bool())
+  {
+    return std::nullopt;
+  }
+  checkpoint_file_ = std::make_unique<MissionCheckpointFile>(this->get_parameter(checkpoint_prefix + "path").as_string());
+  mission_hash_ = get_mission_hash_();
+
+  std::optional<MissionCheckpoint> checkpoint = checkpoint_file_->read();
+  if(! checkpoint.has_value())
+  {
+    return std::nullopt;
+  }
+  if(checkpoint->mission_hash != mission_hash_)
+  {
+    RCLCPP_WARN(this->get_logger(), "Ignoring the checkpoint %s, as it belongs to another namespace, domain or mission", checkpoint_file_->get_path().c_str());
+    return std::nullopt;
+  }
+  const double max_age_s = this->get_parameter(checkpoint_prefix + "max_age").as_double();
+  if(checkpoint->get_age_s() > max_age_s)
+  {
+    RCLCPP_WARN(this->get_logger(), "Ignoring the checkpoint %s, as it is %.0f s old", checkpoint_file_->get_path().c_str(), checkpoint->get_age_s());
+    return std::nullopt;
+  }
+  RCLCPP_INFO(this->get_logger(), "Resuming the mission from the checkpoint %s, written %.1f s ago", checkpoint_file_->get_path().c_str(), checkpoint->get_age_s());
+  return checkpoint;
+}
+
+
+uint64_t MissionControllerNode::get_mission_hash_()
+{
+  // The tuning parameters of the controller may change between restarts
+  std::vector<std::string> names = this->list_parameters({ "drone", "locations", "mission_init", "mission_goals" }, 0).names;
+  std::sort(names.begin(), names.end());
+
+  std::string mission = std::string(this->get_fully_qualified_name()) + "\n" + domain_expert_->getDomain() + "\n";
+  for(const rclcpp::Parameter& parameter : this->get_parameters(names))
+  {
+    mission += parameter.get_name() + "=" + parameter.value_to_string() + "\n";
+  }
+  return MissionCheckpoint::get_hash(mission);
+}
+
+
+void MissionControllerNode::restore_checkpoint_(const MissionCheckpoint& checkpoint)
+{
+  std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+  clear_knowledge_();
+  pushed_duration_functions_.clear();
+
+  // The state of the drone is taken from its telemetry, as the executor may have been interrupted
+  // in the middle of an action, after its at-start effects
+  const std::string drone_name = this->get_parameter("drone.name").as_string();
+  const std::set<std::string> drone_state_predicates = {
+    "drone_at", "landed", "not_landed", "not_moving", "not_searching", "not_tracking", "not_rescuing", "not_marking"
+  };
+
+  for(const std::pair<std::string, std::string>& instance : checkpoint.instances)
+  {
+    add_instance_(instance.first, instance.second);
+  }
+  for(const std::string& predicate_str : checkpoint.predicates)
+  {
+    std::optional<PddlAtom> predicate = PddlAtom::parse(predicate_str);
+    if(predicate.has_value() && drone_state_predicates.count(predicate->name))
+    {
+      continue;
+    }
+    add_predicate_(predicate_str);
+  }
+  for(const std::pair<std::string, double>& function : checkpoint.functions)
+  {
+    add_function_("(= " + function.first + " " + std::to_string(function.second) + ")");
+  }
+
+  add_predicate_("(drone_at " + drone_name + " " + get_location_(position_ned_.point) + ")");
+  add_predicate_((anafi_state_.compare("FS_LANDED") == 0) ? "(landed " + drone_name + ")" : "(not_landed " + drone_name + ")");
+  if(anafi_state_.compare("FS_FLYING") != 0)
+  {
+    add_predicate_("(not_moving " + drone_name + ")");
+  }
+  for(const std::string& name : { "not_searching", "not_tracking", "not_rescuing", "not_marking" })
+  {
+    add_predicate_("(" + std::string(name) + " " + drone_name + ")");
+  }
+
+  mission_goals_.landed_goal_str_ = checkpoint.landed_goal;
+  mission_goals_.preferred_landing_goal_str_ = checkpoint.preferred_landing_goal;
+  mission_goals_.possible_landing_goal_strings_ = checkpoint.possible_landing_goals;
+  mission_goals_.search_goal_strings_ = checkpoint.search_goals;
+  mission_goals_.communicate_location_goal_strings_ = checkpoint.communicate_location_goals;
+  mission_goals_.mark_location_goal_strings_ = checkpoint.mark_location_goals;
+  mission_goals_.rescue_location_goal_strings_ = checkpoint.rescue_location_goals;
+
+  detected_people_.clear();
+  for(const DetectedPersonCheckpoint& person : checkpoint.detected_people)
+  {
+    geometry_msgs::msg::Point position;
+    position.x = person.x;
+    position.y = person.y;
+    position.z = person.z;
+    detected_people_[person.id] = std::make_tuple(position, static_cast<Severity>(person.severity), person.is_helped);
+  }
+  num_markers_ = checkpoint.num_markers;
+  num_lifevests_ = checkpoint.num_lifevests;
+  current_plan_ = to_plan_msg(checkpoint.plan);
+
+  // The action nodes replay their last completions to the restarted controller, which are 
+  // already in the checkpoint if they were applied at all. The completions are stamped
+  // with the clock of the action nodes, which is the node clock of the controller
+  min_action_completion_time_s_ = checkpoint.node_time_s;
+
+  // The interrupted plan is not resumed by the executor, as its progress is unknown. The restored
+  // controller idles without a plan, and replans for the remaining goals from where the drone is.
+  // An idle controller searches while goals remain, while a rescue must be requested
+  const double now_s = this->get_clock()->now().seconds();
+  const ControllerState state = static_cast<ControllerState>(checkpoint.controller_state);
+  switch(state)
+  {
+    case ControllerState::EMERGENCY:
+      controller_state_ = ControllerState::IDLE;
+      replan_scheduler_.request(ReplanTrigger::EMERGENCY, now_s);
+      break;
+    case ControllerState::SEARCH:
+      controller_state_ = ControllerState::IDLE;
+      break;
+    case ControllerState::RESCUE:
+      controller_state_ = ControllerState::IDLE;
+      replan_scheduler_.request(ReplanTrigger::RESCUE, now_s);
+      break;
+    case ControllerState::INIT:
+    case ControllerState::AREA_UNAVAILABLE:
+    case ControllerState::IDLE:
+      controller_state_ = state;
+      break;
+    default:
+      controller_state_ = ControllerState::INIT;
+      break;
+  }
+
+  const double duration_ms = 1e3 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+  RCLCPP_INFO(
+    this->get_logger(), "Restored %zu instances, %zu predicates, %zu functions and %zu detected people in %.1f ms", 
+    checkpoint.instances.size(), checkpoint.predicates.size(), checkpoint.functions.size(), checkpoint.detected_people.size(), duration_ms);
+}
+
+
+void MissionControllerNode::write_checkpoint_()
+{
+  if(! checkpoint_file_ || is_mission_completed_reported_)
+  {
+    return;
+  }
+
+  MissionCheckpoint checkpoint;
+  checkpoint.mission_hash = mission_hash_;
+  checkpoint.node_time_s = this->get_clock()->now().seconds();
+  checkpoint.controller_state = static_cast<int>(controller_state_);
+  checkpoint.num_markers = num_markers_;
+  checkpoint.num_lifevests = num_lifevests_;
+
+  checkpoint.landed_goal = mission_goals_.landed_goal_str_;
+  checkpoint.preferred_landing_goal = mission_goals_.preferred_landing_goal_str_;
+  checkpoint.possible_landing_goals = mission_goals_.possible_landing_goal_strings_;
+  checkpoint.search_goals = mission_goals_.search_goal_strings_;
+  checkpoint.communicate_location_goals = mission_goals_.communicate_location_goal_strings_;
+  checkpoint.mark_location_goals = mission_goals_.mark_location_goal_strings_;
+  checkpoint.rescue_location_goals = mission_goals_.rescue_location_goal_strings_;
+
+  for(const std::pair<const int, std::tuple<geometry_msgs::msg::Point, Severity, bool>>& person : detected_people_)
+  {
+    const geometry_msgs::msg::Point& position = std::get<0>(person.second);
+    checkpoint.detected_people.push_back(DetectedPersonCheckpoint{ 
+      person.first, position.x, position.y, position.z, static_cast<int>(std::get<1>(person.second)), std::get<2>(person.second) 
+    });
+  }
+  checkpoint.plan = to_planned_actions(current_plan_);
+
+  checkpoint.instances = knowledge_mirror_.get_instances();
+  for(const PddlAtom& predicate : knowledge_mirror_.get_all_predicates())
+  {
+    checkpoint.predicates.push_back(predicate.to_string());
+  }
+  for(const std::pair<PddlAtom, double>& function : knowledge_mirror_.get_all_functions())
+  {
+    checkpoint.functions.push_back(std::make_pair(function.first.to_string(), function.second));
+  }
+
+  if(! checkpoint_file_->write(checkpoint))
+  {
+    RCLCPP_WARN_ONCE(this->get_logger(), "Could not write the checkpoint %s", checkpoint_file_->get_path().c_str());
+  }
 }
 
 
@@ -35,8 +359,28 @@ void MissionControllerNode::step()
   *   - goals for communicating, marking or rescuing once done
   * It would require some form of maintaining the current goals 
   */
+  apply_action_completions_();
+
+  std::optional<plansys2_msgs::action::ExecutePlan::Feedback> feedback = sample_execution_feedback_();
+  if(feedback.has_value())
+  {
+    update_duration_model_(feedback.value());
+    check_remaining_plan_battery_(feedback.value());
+    update_execution_feedback_(feedback.value());
+  }
+
   if(check_plan_completed_() && controller_state_ != ControllerState::INIT) 
   {
+    if(makespan_tracker_.is_plan_running())
+    {
+      double makespan_error_s = makespan_tracker_.end_plan(this->get_clock()->now().seconds());
+      log_makespan_(makespan_error_s);
+    }
+    if(plan_validity_monitor_)
+    {
+      plan_validity_monitor_->stop_plan();
+    }
+
     // if(get_num_remaining_mission_goals_() == 0)
     // {
     //   // Entire mission completed!
@@ -61,6 +405,9 @@ void MissionControllerNode::step()
     }
   }
 
+  // Checked after the completion of the plan, such that a finished plan is not reported as invalid
+  check_plan_validity_();
+
   const std::tuple<ControllerState, bool> recommendation = recommend_replan_();
   ControllerState recommended_next_state = std::get<0>(recommendation);
   bool recommended_to_replan = std::get<1>(recommendation);
@@ -68,9 +415,15 @@ void MissionControllerNode::step()
   // This shit should be rewritten to have a clearer path towards planning
   if(recommended_to_replan)
   {
+    // The current plan is cancelled during replanning, such that the drone hovers until the new
+    // plan is started
+    rclcpp::Time replan_start_time = this->get_clock()->now();
+    last_planner_duration_s_ = 0.0;
+    is_mission_completed_reported_ = false;
+
     // Important to save active goals before clearing!
     // save_remaining_mission_goals_(); // Note that this does not work atm! Need to find a method for detecting goals
-    problem_expert_->clearGoal(); // Clears all goals!
+    clear_goal_(); // Clears all goals!
 
     std::vector<std::string> goals;
     load_mission_goals_(recommended_next_state, goals);
@@ -82,20 +435,15 @@ void MissionControllerNode::step()
     // This is terrible code though, as the problem is caused by PDDL, and a hardcoded solution is
     // partially implemented in C++ (a real language). The problem should in reality be solved in 
     // the PDDL-file, but I cannot be bothered to be honest. PDDL is hell, while C++ is <3 
-    std::vector<plansys2::Predicate> predicates = problem_expert_->getPredicates();
-    for(const plansys2::Predicate& predicate : predicates)
+    for(const PddlAtom& drone_at : knowledge_mirror_.get_predicates("drone_at"))
     {
-      if(predicate.name.compare("drone_at") == 0)
-      {
-        problem_expert_->removePredicate(predicate);
-        break;
-      }
+      remove_predicate_(drone_at.to_string());
     }
     const std::string drone_name = this->get_parameter("drone.name").as_string();
     const std::string drone_pos = get_location_(position_ned_.point); 
     std::string predicate_str = "(drone_at " + drone_name + " " + drone_pos + ")";
     RCLCPP_INFO(this->get_logger(), "Adding position predicate: " + predicate_str);
-    problem_expert_->addPredicate(plansys2::Predicate(predicate_str));
+    add_predicate_(predicate_str);
 
     if(! update_plansys2_goals_(goals) || ! update_plansys2_functions_())
     {
@@ -107,14 +455,27 @@ void MissionControllerNode::step()
     // Log state after new goals have been set! 
     log_planning_state_();
 
-    // Check whether or not the state of the drone satisfies the current goals
-
-    // Note that the planner will fail if the original state is equal to the current
-    // state. As such, one might require a method for identifying that this is the 
-    // case in this situation
+    // The planner fails if the current state already satisfies the goals, and searches its entire
+    // state space before failing on goals which no plan can reach. Neither is given to the planner
+    std::vector<std::string> unreachable_goals;
+    GoalStatus goal_status = check_current_goals_(goals, unreachable_goals);
     std::optional<plansys2_msgs::msg::Plan> plan;
-    bool replan_success = replan_mission_(plan);
-    if(! replan_success)
+    bool replan_success = false;
+    if(goal_status == GoalStatus::OPEN)
+    {
+      replan_success = replan_mission_(plan);
+    }
+    else if(goal_status == GoalStatus::UNREACHABLE)
+    {
+      RCLCPP_WARN(this->get_logger(), "Cancelling plan execution, as no plan can achieve the goals:");
+      executor_client_->cancel_plan_execution();
+      for(const std::string& unreachable_goal : unreachable_goals)
+      {
+        RCLCPP_WARN(this->get_logger(), "\t%s", unreachable_goal.c_str());
+      }
+    }
+
+    if(goal_status != GoalStatus::SATISFIED && ! replan_success)
     {
       RCLCPP_INFO(this->get_logger(), "Attempting to relax goals");
 
@@ -127,93 +488,203 @@ void MissionControllerNode::step()
       load_constant_mission_goals_(recommended_next_state, constant_subgoals);
       load_relaxable_mission_goals_(recommended_next_state, relaxable_subgoals);
 
-      if(! relax_mission_goals_(constant_subgoals, relaxable_subgoals, valid_subgoals, plan))
+      // A single search with soft goals replaces the search for every relaxable subgoal
+      const bool is_relaxed_with_soft_goals = this->get_parameter("planner.soft_goals.enabled").as_bool()
+        && relax_mission_goals_with_soft_goals_(constant_subgoals, relaxable_subgoals, valid_subgoals, plan);
+      if(! is_relaxed_with_soft_goals && ! relax_mission_goals_(constant_subgoals, relaxable_subgoals, valid_subgoals, plan))
       {
         // Unable to find relaxable subgoals
         RCLCPP_FATAL(this->get_logger(), "Unable to determine a valid plan. Shutting down!");
+        publish_plan_status_str_("Mission failed");
         throw std::runtime_error("Could not find a suitable plan");
       }
 
       log_relaxed_goals_(constant_subgoals, relaxable_subgoals, valid_subgoals);
 
-      // Plan with the current subgoals
-      std::optional<plansys2_msgs::msg::Plan> relaxed_plan;
+      // Plan with the current subgoals, which the plan with soft goals already achieves
       valid_subgoals.insert(valid_subgoals.end(), constant_subgoals.begin(), constant_subgoals.end());
       update_plansys2_goals_(valid_subgoals);
-      if(replan_mission_(relaxed_plan))
+      goal_status = check_current_goals_(valid_subgoals, unreachable_goals);
+      if(! is_relaxed_with_soft_goals && goal_status != GoalStatus::SATISFIED)
       {
-        plan = relaxed_plan; 
+        std::optional<plansys2_msgs::msg::Plan> relaxed_plan;
+        if(replan_mission_(relaxed_plan))
+        {
+          plan = relaxed_plan; 
+        }
+        else 
+        {
+          RCLCPP_ERROR(this->get_logger(), "Failed to find a suitable plan including all relaxable goals! Using the last valid subplan...");
+        }
       }
-      else 
+    }
+
+    // A running plan is interrupted by the replan, and is therefore not used for the makespan error
+    double now_s = this->get_clock()->now().seconds();
+    makespan_tracker_.end_plan(now_s, false);
+    observed_actions_.clear();
+    if(goal_status == GoalStatus::SATISFIED)
+    {
+      // The executor never reports an empty plan as completed, so the goals are completed here as
+      // if their plan had finished. The mission goals which hold are no longer remaining, such that
+      // the controller does not replan for them when idling
+      RCLCPP_INFO(this->get_logger(), "The current state satisfies the goals, skipping the planner");
+      executor_client_->cancel_plan_execution();
+      remove_satisfied_mission_goals_();
+      is_idle_goals_satisfied_ = (get_num_remaining_mission_goals_() == 0);
+
+      current_plan_ = plansys2_msgs::msg::Plan();
+      execution_feedback_aggregator_.start_plan({}, now_s);
+      if(plan_validity_monitor_)
       {
-        RCLCPP_ERROR(this->get_logger(), "Failed to find a suitable plan including all relaxable goals! Using the last valid subplan...");
+        plan_validity_monitor_->stop_plan();
       }
+      controller_state_ = (recommended_next_state == ControllerState::EMERGENCY) ? ControllerState::EMERGENCY : ControllerState::IDLE;
     }
+    else
+    {
+      log_plan_(plan);
 
-    log_plan_(plan);
+      // Start execution
+      executor_client_->start_plan_execution(plan.value());
+      controller_state_ = recommended_next_state;
+      is_idle_goals_satisfied_ = false;
 
-    // Start execution
-    executor_client_->start_plan_execution(plan.value());
-    controller_state_ = recommended_next_state;
+      makespan_tracker_.start_plan(get_plan_makespan_(plan.value()), now_s);
+      current_plan_ = plan.value();
+      if(! is_first_plan_reported_)
+      {
+        startup_timeline_.end("first_plan");
+        startup_timeline_.mark("executing");
+        publish_startup_timeline_();
+        is_first_plan_reported_ = true;
+      }
+
+      execution_feedback_aggregator_.start_plan(to_planned_actions(current_plan_), now_s);
+      if(plan_validity_monitor_)
+      {
+        plan_validity_monitor_->start_plan(execution_feedback_aggregator_.get_actions());
+        for(const std::string& action : plan_validity_monitor_->get_unmonitored_actions())
+        {
+          RCLCPP_WARN(this->get_logger(), "Action %s is not in the parsed domain, and is not monitored", action.c_str());
+        }
+      }
+    }
+    is_plan_violation_reported_ = false;
+
+    double hover_time_lost_s = (this->get_clock()->now() - replan_start_time).seconds();
+    replan_scheduler_.record_replan(hover_time_lost_s);
+    publish_replan_statistics_(hover_time_lost_s);
+  }
+  else if(controller_state_ == ControllerState::IDLE && ! is_mission_completed_reported_)
+  {
+    // Idling without a replan means that all mission goals and the final state are achieved
+    RCLCPP_INFO(this->get_logger(), "Mission completed!");
+    publish_plan_status_str_("Mission completed");
+    is_mission_completed_reported_ = true;
+    if(checkpoint_file_)
+    {
+      checkpoint_file_->remove();
+    }
   }
 
-  // Update the user about action performance
-  // print_action_feedback_(); // This is spamming!
+  speculate_next_events_();
+  write_checkpoint_();
 }
 
 
-void MissionControllerNode::check_controller_preconditions_()
+void MissionControllerNode::check_controller_preconditions_(bool is_resuming)
 {
-  rclcpp::Rate rate(1);
+  // The executor returns as soon as an input arrives. The node is spun by the executor of main()
+  // after init()
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(this->get_node_base_interface());
+  const std::chrono::milliseconds max_input_wait(100);
 
+  while (rclcpp::ok()) 
+  {
+    apply_pending_inputs_(MissionControllerChannel::PRECONDITIONS_CHECK);
+    if(are_controller_preconditions_satisfied_(is_resuming))
+    {
+      RCLCPP_INFO(this->get_logger(), "Preconditions checked!");
+      break;
+    }
+
+    executor.spin_once(max_input_wait);
+  }
+  executor.remove_node(this->get_node_base_interface());
+}
+
+
+bool MissionControllerNode::are_controller_preconditions_satisfied_(bool is_resuming)
+{
   bool valid_anafi_state = false;
   bool valid_battery = false;
   bool valid_ned_pos = false;
 
-  while (rclcpp::ok()) 
+  if(! anafi_state_.empty())
   {
-    if(! anafi_state_.empty())
-    {
-      valid_anafi_state = true;
-    }
-    else 
-    {
-      RCLCPP_ERROR(this->get_logger(), "No state update received");
-    }
+    valid_anafi_state = true;
+  }
+  else 
+  {
+    RCLCPP_ERROR_THROTTLE(this->get_logger(), *this->get_clock(), 1000, "No state update received");
+  }
 
-    if(battery_charge_ > 0 && battery_charge_ <= 100)
-    {
-      // Assumes the battery charge must be positive to start executing
-      valid_battery = true;
-    }
-    else
-    {
-      RCLCPP_ERROR(this->get_logger(), "Invalid battery: %f ", battery_charge_);
-    }
+  if(battery_charge_ > 0 && battery_charge_ <= 100)
+  {
+    // Assumes the battery charge must be positive to start executing
+    valid_battery = true;
+  }
+  else
+  {
+    RCLCPP_ERROR_THROTTLE(this->get_logger(), *this->get_clock(), 1000, "Invalid battery: %f ", battery_charge_);
+  }
 
-    double position_ned_norm = std::sqrt(
-      std::pow(position_ned_.point.x, 2) + std::pow(position_ned_.point.y, 2) + std::pow(position_ned_.point.z, 2)
-    ); 
-    const double max_initial_ned_norm = 5;
+  double position_ned_norm = std::sqrt(
+    std::pow(position_ned_.point.x, 2) + std::pow(position_ned_.point.y, 2) + std::pow(position_ned_.point.z, 2)
+  ); 
+  const double max_initial_ned_norm = 5;
 
-    // Should also check that it is roughly zero in all states 
-    if(position_ned_norm <= max_initial_ned_norm)
-    {
-      valid_ned_pos = true;
-    }
-    else 
-    {
-      RCLCPP_ERROR(this->get_logger(), "NED-position likely incorrect. Restart Olympe-bridge...");
-    }
+  // Should also check that it is roughly zero in all states. A resumed mission starts anywhere
+  if(is_resuming || position_ned_norm <= max_initial_ned_norm)
+  {
+    valid_ned_pos = true;
+  }
+  else 
+  {
+    RCLCPP_ERROR_THROTTLE(this->get_logger(), *this->get_clock(), 1000, "NED-position likely incorrect. Restart Olympe-bridge...");
+  }
 
-    if(valid_anafi_state && valid_battery && valid_ned_pos)
-    {
-      RCLCPP_INFO(this->get_logger(), "Preconditions checked!");
-      break;
-    }
+  return valid_anafi_state && valid_battery && valid_ned_pos;
+}
+
+
+void MissionControllerNode::init_telemetry_log_()
+{
+  std::string telemetry_prefix = "telemetry.";
+  if(! this->get_parameter(telemetry_prefix + "record").as_bool())
+  {
+    return;
+  }
 
-    rate.sleep();
-    rclcpp::spin_some(this->get_node_base_interface());
+  // One log per run, named after the wall time at startup
+  std::time_t now = std::time(nullptr);
+  char time_str[32];
+  std::strftime(time_str, sizeof(time_str), "%Y%m%d_%H%M%S", std::localtime(&now));
+  std::string path = this->get_parameter(telemetry_prefix + "directory").as_string() 
+    + "/mission_controller_" + time_str + ".tlog";
+
+  telemetry_log_ = std::make_unique<TelemetryLogWriter>(path);
+  RCLCPP_INFO(this->get_logger(), "Recording telemetry to " + path);
+}
+
+
+void MissionControllerNode::record_telemetry_(MissionControllerChannel channel)
+{
+  if(telemetry_log_)
+  {
+    telemetry_log_->append(this->get_clock()->now().nanoseconds(), static_cast<uint32_t>(channel), nullptr, 0);
   }
 }
 
@@ -282,6 +753,11 @@ void MissionControllerNode::declare_parameters_()
   this->declare_parameter(battery_usage_prefix + "track");    // Fail if not declared in config
   this->declare_parameter(battery_usage_prefix + "move");     // Fail if not declared in config
 
+  std::string battery_estimator_prefix = drone_prefix + "battery_estimator.";
+  this->declare_parameter(battery_estimator_prefix + "forgetting_factor", 0.98);
+  this->declare_parameter(battery_estimator_prefix + "min_segment_duration", 10.0);
+  this->declare_parameter(battery_estimator_prefix + "max_segment_duration", 30.0);
+
   std::string velocity_limits_prefix = drone_prefix + "velocity_limits.";
   this->declare_parameter(velocity_limits_prefix + "track");  // Fail if not declared in config
   this->declare_parameter(velocity_limits_prefix + "move");   // Fail if not declared in config
@@ -335,6 +811,55 @@ void MissionControllerNode::declare_parameters_()
    */
   std::string search_prefix = "search.";
   this->declare_parameter(search_prefix + "distance"); // Fail if declared in config
+
+  std::string duration_model_prefix = "duration_model.";
+  this->declare_parameter(duration_model_prefix + "forgetting_factor", 0.95);
+
+  std::string replan_scheduler_prefix = "replan_scheduler.";
+  ReplanSchedulerParameters replan_scheduler_defaults;
+  this->declare_parameter(replan_scheduler_prefix + "coalescing_window", replan_scheduler_defaults.coalescing_window_s);
+  this->declare_parameter(replan_scheduler_prefix + "max_coalescing_delay", replan_scheduler_defaults.max_coalescing_delay_s);
+  this->declare_parameter(replan_scheduler_prefix + "max_deferral", replan_scheduler_defaults.max_deferral_s);
+
+  std::string telemetry_prefix = "telemetry.";
+  this->declare_parameter(telemetry_prefix + "record", false);
+  this->declare_parameter(telemetry_prefix + "directory", std::string("."));
+
+  std::string checkpoint_prefix = "checkpoint.";
+  this->declare_parameter(checkpoint_prefix + "enabled", false);
+  this->declare_parameter(checkpoint_prefix + "path", std::string("/tmp/mission_controller_checkpoint.bin"));
+  this->declare_parameter(checkpoint_prefix + "max_age", 600.0);
+
+  std::string execution_feedback_prefix = "execution_feedback.";
+  this->declare_parameter(execution_feedback_prefix + "sample_rate", 2.0);
+  this->declare_parameter(execution_feedback_prefix + "statistics_window", 20);
+
+  std::string plan_monitor_prefix = "plan_monitor.";
+  this->declare_parameter(plan_monitor_prefix + "enabled", true);
+  this->declare_parameter(plan_monitor_prefix + "position_margin", 5.0);
+  this->declare_parameter(plan_monitor_prefix + "min_replan_interval", 2.0);
+
+  std::string planner_prefix = "planner.";
+  this->declare_parameter(planner_prefix + "backend", std::string("plansys2"));
+  this->declare_parameter(planner_prefix + "max_expansions", 200000);
+  this->declare_parameter(planner_prefix + "timeout", 10.0);
+  this->declare_parameter(planner_prefix + "fallback_to_plansys2", true);
+  this->declare_parameter(planner_prefix + "relevance_pruning", false);
+  this->declare_parameter(planner_prefix + "route_pruning", true);
+  this->declare_parameter(planner_prefix + "goal_check", true);
+  std::string soft_goals_prefix = planner_prefix + "soft_goals.";
+  this->declare_parameter(soft_goals_prefix + "enabled", false);
+  this->declare_parameter(soft_goals_prefix + "search_utility", 1.0);
+  this->declare_parameter(soft_goals_prefix + "landing_utility", 1.0);
+  this->declare_parameter(soft_goals_prefix + "communicate_utility", 2.0);
+  this->declare_parameter(soft_goals_prefix + "mark_utility", 4.0);
+  this->declare_parameter(soft_goals_prefix + "rescue_utility", 8.0);
+  this->declare_parameter(soft_goals_prefix + "severity_factors", std::vector<double>({ 1.0, 2.0, 4.0 }));
+  std::string speculation_prefix = planner_prefix + "speculation.";
+  this->declare_parameter(speculation_prefix + "enabled", false);
+  this->declare_parameter(speculation_prefix + "capacity", 6);
+  this->declare_parameter(speculation_prefix + "max_expansions", 50000);
+  this->declare_parameter(speculation_prefix + "timeout", 2.0);
 }
 
 
@@ -348,14 +873,100 @@ void MissionControllerNode::init_parameters_()
   std::string payload_prefix = "mission_init.payload.";
   num_markers_ = this->get_parameter(payload_prefix + "num_markers").as_int();
   num_lifevests_ = this->get_parameter(payload_prefix + "num_lifevests").as_int();
+
+  location_names_ = this->get_parameter("locations.names").as_string_array();
+
+  // The search distance is only a prior, until the search action node reports the length of 
+  // the search pattern 
+  std::string velocity_prefix = drone_prefix + "velocity_limits.";
+  double move_velocity_limit = this->get_parameter(velocity_prefix + "move").as_double();
+  double track_velocity_limit = this->get_parameter(velocity_prefix + "track").as_double();
+  double search_distance = this->get_parameter("search.distance").as_double();
+  double forgetting_factor = this->get_parameter("duration_model.forgetting_factor").as_double();
+
+  duration_model_ = std::make_shared<ActionDurationModel>(
+    move_velocity_limit, track_velocity_limit, search_distance, forgetting_factor
+  );
+
+  // The battery usage from the config file is only used as a prior. All actions except move
+  // are performed at tracking-velocity or hovering, and use the track battery usage as prior
+  std::string battery_usage_prefix = drone_prefix + "battery_usage_per_time_unit.";
+  double track_battery_usage = this->get_parameter(battery_usage_prefix + "track").as_double();
+  double move_battery_usage = this->get_parameter(battery_usage_prefix + "move").as_double();
+
+  std::string battery_estimator_prefix = drone_prefix + "battery_estimator.";
+  battery_estimator_ = std::make_shared<BatteryDischargeEstimator>(
+    track_battery_usage,
+    this->get_parameter(battery_estimator_prefix + "forgetting_factor").as_double(),
+    this->get_parameter(battery_estimator_prefix + "min_segment_duration").as_double(),
+    this->get_parameter(battery_estimator_prefix + "max_segment_duration").as_double()
+  );
+  battery_estimator_->set_prior("move", move_battery_usage);
+  battery_estimator_->set_prior("search", track_battery_usage);
+
+  std::string replan_scheduler_prefix = "replan_scheduler.";
+  ReplanSchedulerParameters replan_scheduler_params;
+  replan_scheduler_params.coalescing_window_s = this->get_parameter(replan_scheduler_prefix + "coalescing_window").as_double();
+  replan_scheduler_params.max_coalescing_delay_s = this->get_parameter(replan_scheduler_prefix + "max_coalescing_delay").as_double();
+  replan_scheduler_params.max_deferral_s = this->get_parameter(replan_scheduler_prefix + "max_deferral").as_double();
+  replan_scheduler_ = ReplanScheduler(replan_scheduler_params);
+
+  std::string execution_feedback_prefix = "execution_feedback.";
+  execution_feedback_period_s_ = 1.0 / this->get_parameter(execution_feedback_prefix + "sample_rate").as_double();
+  execution_feedback_aggregator_ = ExecutionFeedbackAggregator(
+    this->get_parameter(execution_feedback_prefix + "statistics_window").as_int()
+  );
+
+  std::string plan_monitor_prefix = "plan_monitor.";
+  plan_monitor_position_margin_m_ = this->get_parameter(plan_monitor_prefix + "position_margin").as_double();
+  plan_monitor_min_replan_interval_s_ = this->get_parameter(plan_monitor_prefix + "min_replan_interval").as_double();
+
+  is_planner_fallback_enabled_ = this->get_parameter("planner.fallback_to_plansys2").as_bool();
+  is_native_backend_ = (this->get_parameter("planner.backend").as_string() == "native");
+  is_goal_check_enabled_ = this->get_parameter("planner.goal_check").as_bool();
 }
 
 
-void MissionControllerNode::init_knowledge_()
+void MissionControllerNode::init_knowledge_(const std::optional<StaticKnowledge>& pushed_static_knowledge)
 {
-  // Clearing all data simplest for a small problem
-  // For a larger problem, one might consider storing predicates and only removing the ones necessary 
-  problem_expert_->clearKnowledge();
+  pushed_duration_functions_.clear();
+  if(pushed_static_knowledge.has_value())
+  {
+    // Already in the problem expert
+    knowledge_mirror_.clear();
+    for(const std::pair<std::string, std::string>& instance : pushed_static_knowledge->instances)
+    {
+      knowledge_mirror_.add_instance(instance.first, instance.second);
+    }
+    for(const std::string& predicate_str : pushed_static_knowledge->predicates)
+    {
+      knowledge_mirror_.add_predicate(predicate_str);
+    }
+    for(const std::string& function_str : pushed_static_knowledge->functions)
+    {
+      knowledge_mirror_.set_function(function_str);
+    }
+  }
+  else
+  {
+    // Clearing all data simplest for a small problem
+    // For a larger problem, one might consider storing predicates and only removing the ones necessary 
+    clear_knowledge_();
+
+    const StaticKnowledge static_knowledge = get_static_knowledge_();
+    for(const std::pair<std::string, std::string>& instance : static_knowledge.instances)
+    {
+      add_instance_(instance.first, instance.second);
+    }
+    for(const std::string& predicate_str : static_knowledge.predicates)
+    {
+      add_predicate_(predicate_str);
+    }
+    for(const std::string& function_str : static_knowledge.functions)
+    {
+      add_function_(function_str);
+    }
+  }
 
   // Assuming the node is run in its own terminal, such that cout << "\n" does not fuck
   // with other data
@@ -363,172 +974,584 @@ void MissionControllerNode::init_knowledge_()
   const std::string drone_name = this->get_parameter("drone.name").as_string();
   const std::vector<std::string> locations = this->get_parameter("locations.names").as_string_array();
 
+  for(std::string loc_str : locations)
+  {
+    // Set search-distance for each location (currently assumed fixed...). Reported by the search
+    // action node, such that it is not part of the static knowledge
+    double search_distance = duration_model_->get_search_distance();
+    std::string search_distance_str = "(= (search_distance " + loc_str + ")" + std::to_string(search_distance) + ")";
+    RCLCPP_INFO(this->get_logger(), "Adding distance function: " + search_distance_str);
+    add_function_(search_distance_str);
+  }
+
+  const std::string drone_pos = get_location_(position_ned_.point); 
+  std::string predicate_str = "(drone_at " + drone_name + " " + drone_pos + ")";
+  RCLCPP_INFO(this->get_logger(), "Adding position predicate: " + predicate_str);
+  add_predicate_(predicate_str);
+
+  std::string landed_str;
+  if(anafi_state_.compare("FS_LANDED") == 0) // Preconditions already checked that string not empty
+  {
+    landed_str = "(landed " + drone_name + ")";
+  }
+  else 
+  {
+    landed_str = "(not_landed " + drone_name + ")";
+  }
+  RCLCPP_INFO(this->get_logger(), "Adding landed predicate: " + landed_str);
+  add_predicate_(landed_str);
+
+  if(anafi_state_.compare("FS_FLYING") != 0) // Preconditions already checked that string not empty
+  {
+    // Assuminhg that movement requires the drone state to be FS_FLYING
+    std::string moving_str = "(not_moving " + drone_name + ")";
+    RCLCPP_INFO(this->get_logger(), "Adding moving predicate: " + moving_str);
+    add_predicate_(moving_str);
+  }
+
+  std::cout << "\n\n";
+}
+
+
+StaticKnowledge MissionControllerNode::get_static_knowledge_()
+{
+  StaticKnowledge knowledge;
+
+  std::cout << "\n\n";
+  const std::string drone_name = this->get_parameter("drone.name").as_string();
+  const std::vector<std::string> locations = this->get_parameter("locations.names").as_string_array();
+
   RCLCPP_INFO(this->get_logger(), "Drone: " + drone_name);
-  problem_expert_->addInstance(plansys2::Instance{drone_name, "drone"});
+  knowledge.instances.push_back(std::make_pair(drone_name, "drone"));
+
+  // Locations must be added separately from the paths
+  // Not possible to combine into one for-loop
+  for(std::string loc_str : locations)
+  {
+    RCLCPP_INFO(this->get_logger(), "Location: " + loc_str);
+    knowledge.instances.push_back(std::make_pair(loc_str, "location"));
+  }
+  for(std::string loc_str : locations)
+  {
+    // Set predicates for paths and distances
+    const std::vector<std::string> paths_from_loc = this->get_parameter("locations.paths." + loc_str).as_string_array();
+
+    for(std::string next_loc : paths_from_loc)
+    { 
+      // Initialize paths
+      std::string predicate_str = "(path " + loc_str + " " + next_loc + ")";
+      RCLCPP_INFO(this->get_logger(), "Adding path predicate: " + predicate_str);
+      knowledge.predicates.push_back(predicate_str);
+
+      // Initialize distances on said paths
+      double distance = get_distance_(loc_str, next_loc);
+      
+      std::string distance_str = "(= (distance " + loc_str + " " + next_loc + ") " + std::to_string(distance) + ")";
+      RCLCPP_INFO(this->get_logger(), "Adding distance function: " + distance_str);
+      knowledge.functions.push_back(distance_str);
+    }
+
+    // Set all locations as not searched, as the drone might have to search a location before landing
+    std::string not_searched_loc_str = "(not_searched " + loc_str + ")";
+    RCLCPP_INFO(this->get_logger(), "Adding search predicate: " + not_searched_loc_str);
+    knowledge.predicates.push_back(not_searched_loc_str);
+
+    // Set all locations as available for now
+    std::string available_location_str = "(available " + loc_str + ")";
+    RCLCPP_INFO(this->get_logger(), "Adding available location predicate: " + available_location_str);
+    knowledge.predicates.push_back(available_location_str);
+  }
+  std::cout << "\n";
+
+  std::vector<std::string> landable_locations = this->get_parameter("locations.landing_available").as_string_array();
+  for(std::string land_loc : landable_locations)
+  {
+    std::string landable_loc_str = "(can_land " + land_loc + ")";
+    RCLCPP_INFO(this->get_logger(), "Adding landable location predicate: " + landable_loc_str);
+    knowledge.predicates.push_back(landable_loc_str);
+
+    // std::string not_tracked_landing_location_str = "(not_tracked " + land_loc + ")";
+    // RCLCPP_INFO(this->get_logger(), "Adding location tracking predicate: " + not_tracked_landing_location_str);
+    // add_predicate_(not_tracked_landing_location_str);
+  }
+  std::vector<std::string> recharge_locations = this->get_parameter("locations.recharge_available").as_string_array();
+  for(std::string recharge_loc : recharge_locations)
+  {
+    std::string recharge_loc_str = "(can_recharge " + recharge_loc + ")";
+    RCLCPP_INFO(this->get_logger(), "Adding recharge location predicate: " + recharge_loc_str);
+    knowledge.predicates.push_back(recharge_loc_str);
+  }
+
+  std::vector<std::string> resupply_locations = this->get_parameter("locations.resupply_available").as_string_array();
+  for(std::string resupply_loc : resupply_locations)
+  {
+    std::string resupply_loc_str = "(can_resupply " + resupply_loc + ")";
+    RCLCPP_INFO(this->get_logger(), "Adding resupply location predicate: " + resupply_loc_str);
+    knowledge.predicates.push_back(resupply_loc_str);
+  }
+
+  // The drone is assumed to not search, drop, track, rescue nor mark at the start of the mission
+  // All of these are required to be false to be able to move the drone
+  // See the PDDL-file
+  std::string searching_str = "(not_searching " + drone_name + ")";
+  RCLCPP_INFO(this->get_logger(), "Adding searching predicate: " + searching_str);
+  knowledge.predicates.push_back(searching_str);
+
+  std::string tracking_str = "(not_tracking " + drone_name + ")";
+  RCLCPP_INFO(this->get_logger(), "Adding tracking predicate: " + tracking_str);
+  knowledge.predicates.push_back(tracking_str);
+
+  std::string rescuing_str = "(not_rescuing " + drone_name + ")";
+  RCLCPP_INFO(this->get_logger(), "Adding rescuing predicate: " + rescuing_str);
+  knowledge.predicates.push_back(rescuing_str);
+
+  std::string marking_str = "(not_marking " + drone_name + ")";
+  RCLCPP_INFO(this->get_logger(), "Adding marking predicate: " + marking_str);
+  knowledge.predicates.push_back(marking_str);
+
+  // Fixed functional values
+  std::string battery_usage_prefix = "drone.battery_usage_per_time_unit.";
+  double track_battery_usage = this->get_parameter(battery_usage_prefix + "track").as_double();
+  double move_battery_usage = this->get_parameter(battery_usage_prefix + "move").as_double();
+
+  std::string velocity_prefix = "drone.velocity_limits.";
+  double track_velocity_limit = this->get_parameter(velocity_prefix + "track").as_double();
+  double move_velocity_limit = this->get_parameter(velocity_prefix + "move").as_double();
+
+  std::string track_battery_usage_str = "(= (track_battery_usage " + drone_name + ") " + std::to_string(track_battery_usage) + ")";
+  RCLCPP_INFO(this->get_logger(), "Adding battery usage function: " + track_battery_usage_str);
+  knowledge.functions.push_back(track_battery_usage_str);
+
+  std::string move_battery_usage_str = "(= (move_battery_usage " + drone_name + ") " + std::to_string(move_battery_usage) + ")";
+  RCLCPP_INFO(this->get_logger(), "Adding battery usage function: " + move_battery_usage_str);
+  knowledge.functions.push_back(move_battery_usage_str);
+
+  std::string track_velocity_str = "(= (track_velocity " + drone_name + ") " + std::to_string(track_velocity_limit) + ")";
+  RCLCPP_INFO(this->get_logger(), "Adding velocity function: " + track_velocity_str);
+  knowledge.functions.push_back(track_velocity_str);
+
+  std::string move_velocity_str = "(= (move_velocity " + drone_name + ") " + std::to_string(move_velocity_limit) + ")";
+  RCLCPP_INFO(this->get_logger(), "Adding velocity function: " + move_velocity_str);
+  knowledge.functions.push_back(move_velocity_str);
+
+  return knowledge;
+}
+
+
+bool MissionControllerNode::push_static_knowledge_(const StaticKnowledge& knowledge)
+{
+  bool is_pushed = problem_expert_->clearKnowledge();
+  for(const std::pair<std::string, std::string>& instance : knowledge.instances)
+  {
+    is_pushed = problem_expert_->addInstance(plansys2::Instance{instance.first, instance.second}) && is_pushed;
+  }
+  for(const std::string& predicate_str : knowledge.predicates)
+  {
+    is_pushed = problem_expert_->addPredicate(plansys2::Predicate(predicate_str)) && is_pushed;
+  }
+  for(const std::string& function_str : knowledge.functions)
+  {
+    is_pushed = problem_expert_->addFunction(plansys2::Function(function_str)) && is_pushed;
+  }
+  return is_pushed;
+}
+
+
+bool MissionControllerNode::update_plansys2_functions_()
+{
+  // Update values and insert new functions
+  for(const std::pair<PddlAtom, double>& function : get_drone_functions_())
+  {
+    add_function_("(= " + function.first.to_string() + " " + std::to_string(function.second) + ")");
+  }
+
+  return update_plansys2_duration_functions_();
+}
+
+
+std::vector<std::pair<PddlAtom, double>> MissionControllerNode::get_drone_functions_()
+{
+  std::string drone_name = this->get_parameter("drone.name").as_string();
+
+  // The discharge rates are conservative once the battery is low, as an underestimate is 
+  // more costly than an overestimate at that point
+  double move_battery_usage = battery_estimator_->get_rate("move", is_low_battery_);
+  double track_battery_usage = battery_estimator_->get_rate("search", is_low_battery_);
+
+  return {
+    { PddlAtom{ "num_markers", { drone_name } }, static_cast<double>(num_markers_) },
+    { PddlAtom{ "num_lifevests", { drone_name } }, static_cast<double>(num_lifevests_) },
+    { PddlAtom{ "battery_charge", { drone_name } }, battery_charge_ },
+    { PddlAtom{ "move_battery_usage", { drone_name } }, move_battery_usage },
+    { PddlAtom{ "track_battery_usage", { drone_name } }, track_battery_usage }
+  };
+}
+
+
+bool MissionControllerNode::update_plansys2_duration_functions_()
+{
+  const std::vector<std::string> locations = this->get_parameter("locations.names").as_string_array();
+
+  // Changes smaller than this are not worth a call to the problem expert
+  const double min_duration_change_s = 0.5;
+
+  auto push_function = [this, min_duration_change_s](const std::string& function_name, double value) -> bool
+  {
+    std::map<std::string, double>::iterator it = pushed_duration_functions_.find(function_name);
+    if(it != pushed_duration_functions_.end() && std::abs(it->second - value) < min_duration_change_s)
+    {
+      return true;
+    }
+
+    std::string function_str = "(= " + function_name + " " + std::to_string(value) + ")";
+    if(! add_function_(function_str))
+    {
+      RCLCPP_ERROR(this->get_logger(), "Failed to update duration function: " + function_str);
+      return false;
+    }
+    pushed_duration_functions_[function_name] = value;
+    return true;
+  };
+
+  bool success = true;
+  for(const std::string& loc_str : locations)
+  {
+    const std::vector<std::string> paths_from_loc = this->get_parameter("locations.paths." + loc_str).as_string_array();
+    for(const std::string& next_loc : paths_from_loc)
+    {
+      double move_duration = duration_model_->predict_move(get_distance_(loc_str, next_loc));
+      success = push_function("(move_duration " + loc_str + " " + next_loc + ")", move_duration) && success;
+    }
+    success = push_function("(search_duration " + loc_str + ")", duration_model_->predict_search()) && success;
+  }
+  return success;
+}
+
+
+std::optional<plansys2_msgs::action::ExecutePlan::Feedback> MissionControllerNode::sample_execution_feedback_()
+{
+  double now_s = this->get_clock()->now().seconds();
+  if(now_s - last_execution_feedback_time_s_ < execution_feedback_period_s_)
+  {
+    return std::nullopt;
+  }
+  last_execution_feedback_time_s_ = now_s;
+  return executor_client_->getFeedBack();
+}
+
+
+void MissionControllerNode::update_duration_model_(const plansys2_msgs::action::ExecutePlan::Feedback& feedback)
+{
+  for(const auto & action_feedback : feedback.action_execution_status)
+  {
+    if(action_feedback.status != plansys2_msgs::msg::ActionExecutionInfo::SUCCEEDED
+      || observed_actions_.find(action_feedback.action_full_name) != observed_actions_.end())
+    {
+      continue;
+    }
+    observed_actions_.insert(action_feedback.action_full_name);
+
+    double duration_s = (rclcpp::Time(action_feedback.status_stamp) - rclcpp::Time(action_feedback.start_stamp)).seconds();
+
+    // get_arguments returns { drone, location_from, location_to } for move
+    double distance = 0.0;
+    if(action_feedback.action.compare("move") == 0 && action_feedback.arguments.size() >= 3)
+    {
+      distance = get_distance_(action_feedback.arguments[1], action_feedback.arguments[2]);
+    }
+    else if(action_feedback.action.compare("search") == 0)
+    {
+      distance = duration_model_->get_search_distance();
+    }
+
+    double predicted_duration_s = duration_model_->predict(action_feedback.action, distance);
+    if(duration_model_->add_observation(action_feedback.action, distance, duration_s))
+    {
+      RCLCPP_INFO(
+        this->get_logger(), 
+        "Action [%s] finished after %f s. Predicted duration: %f s", 
+        action_feedback.action_full_name.c_str(), duration_s, predicted_duration_s
+      );
+    }
+  }
+}
+
+
+void MissionControllerNode::check_remaining_plan_battery_(const plansys2_msgs::action::ExecutePlan::Feedback& feedback)
+{
+  // Executor feedback for each action, identified by the same string as the plan items
+  std::map<std::string, std::vector<plansys2_msgs::msg::ActionExecutionInfo>> action_feedbacks;
+
+  executing_action_type_ = "";
+  for(const auto & action_feedback : feedback.action_execution_status)
+  {
+    if(action_feedback.status == plansys2_msgs::msg::ActionExecutionInfo::EXECUTING)
+    {
+      executing_action_type_ = action_feedback.action;
+    }
+
+    std::string action_str = "(" + action_feedback.action;
+    for(const std::string& argument : action_feedback.arguments)
+    {
+      action_str += " " + argument;
+    }
+    action_str += ")";
+    action_feedbacks[action_str].push_back(action_feedback);
+  }
 
-  // Locations must be added separately from the paths
-  // Not possible to combine into one for-loop
-  for(std::string loc_str : locations)
+  // Only check plans which are executing. The emergency-plan is not replanned due to battery 
+  if(
+    ! makespan_tracker_.is_plan_running() 
+    || (controller_state_ != ControllerState::SEARCH && controller_state_ != ControllerState::RESCUE) 
+    || battery_charge_ <= 0
+  )
   {
-    RCLCPP_INFO(this->get_logger(), "Location: " + loc_str);
-    problem_expert_->addInstance(plansys2::Instance{loc_str, "location"});
+    return;
   }
-  for(std::string loc_str : locations)
+
+  // Predict the discharge until the plan is finished, or until the battery is recharged.
+  // The plan items are sorted by their start time
+  double predicted_discharge = 0.0;
+  for(const plansys2_msgs::msg::PlanItem& plan_item : current_plan_.items)
   {
-    // Set predicates for paths and distances
-    const std::vector<std::string> paths_from_loc = this->get_parameter("locations.paths." + loc_str).as_string_array();
-    const std::vector<double> from_location_ne_position = this->get_parameter("locations.pos_ne." + loc_str).as_double_array();
+    double remaining_fraction = 1.0;
+    std::map<std::string, std::vector<plansys2_msgs::msg::ActionExecutionInfo>>::iterator it = action_feedbacks.find(plan_item.action);
+    if(it != action_feedbacks.end() && ! it->second.empty())
+    {
+      plansys2_msgs::msg::ActionExecutionInfo action_feedback = it->second.front();
+      it->second.erase(it->second.begin());
 
-    for(std::string next_loc : paths_from_loc)
-    { 
-      // Initialize paths
-      std::string predicate_str = "(path " + loc_str + " " + next_loc + ")";
-      RCLCPP_INFO(this->get_logger(), "Adding path predicate: " + predicate_str);
-      problem_expert_->addPredicate(plansys2::Predicate(predicate_str));
+      if(action_feedback.status == plansys2_msgs::msg::ActionExecutionInfo::EXECUTING)
+      {
+        remaining_fraction = 1.0 - std::clamp(static_cast<double>(action_feedback.completion), 0.0, 1.0);
+      }
+      else if(action_feedback.status != plansys2_msgs::msg::ActionExecutionInfo::NOT_EXECUTED)
+      {
+        continue;
+      }
+    }
 
-      // Initialize distances on said paths
-      const std::vector<double> to_location_ne_position = this->get_parameter("locations.pos_ne." + next_loc).as_double_array();
-      double north_diff = from_location_ne_position[0] - to_location_ne_position[0];
-      double east_diff = from_location_ne_position[1] - to_location_ne_position[1]; 
-      double distance = std::sqrt(std::pow(north_diff, 2) + std::pow(east_diff, 2));
-      
-      std::string distance_str = "(= (distance " + loc_str + " " + next_loc + ") " + std::to_string(distance) + ")";
-      RCLCPP_INFO(this->get_logger(), "Adding distance function: " + distance_str);
-      problem_expert_->addFunction(plansys2::Function(distance_str));
+    // The plan item is on the form (action arg_0 arg_1 ...)
+    std::string action_type = plan_item.action.substr(1, plan_item.action.find(' ') - 1);
+    if(action_type.compare("recharge") == 0)
+    {
+      break;
     }
+    predicted_discharge += remaining_fraction * plan_item.duration * battery_estimator_->get_rate(action_type, is_low_battery_);
+  }
 
-    // Set search-distance for each location (currently assumed fixed...)
-    double search_distance = this->get_parameter("search.distance").as_double();
-    std::string search_distance_str = "(= (search_distance " + loc_str + ")" + std::to_string(search_distance) + ")";
-    RCLCPP_INFO(this->get_logger(), "Adding distance function: " + search_distance_str);
-    problem_expert_->addFunction(plansys2::Function(search_distance_str));
+  double predicted_final_charge = battery_charge_ - predicted_discharge;
 
-    // Set all locations as not searched, as the drone might have to search a location before landing
-    std::string not_searched_loc_str = "(not_searched " + loc_str + ")";
-    RCLCPP_INFO(this->get_logger(), "Adding search predicate: " + not_searched_loc_str);
-    problem_expert_->addPredicate(plansys2::Predicate(not_searched_loc_str));
+  std_msgs::msg::Float64 predicted_final_charge_msg;
+  predicted_final_charge_msg.data = predicted_final_charge;
+  predicted_final_battery_pub_->publish(predicted_final_charge_msg);
 
-    // Set all locations as available for now
-    std::string available_location_str = "(available " + loc_str + ")";
-    RCLCPP_INFO(this->get_logger(), "Adding available location predicate: " + available_location_str);
-    problem_expert_->addPredicate(plansys2::Predicate(available_location_str));
+  // Prevents replanning continously if the new plan is also predicted to be infeasible. The 
+  // planner will not find a better plan before the battery has changed
+  const double min_charge_change_between_replans = 5.0;
+  bool battery_changed_since_replan = (battery_charge_ <= battery_charge_at_battery_replan_ - min_charge_change_between_replans);
+
+  if(predicted_final_charge < critical_battery_limit_ && battery_changed_since_replan)
+  {
+    RCLCPP_WARN(
+      this->get_logger(), 
+      "Remaining plan predicted to finish with %f %% battery, below the critical limit of %f %%. Current battery: %f %%\n%s",
+      predicted_final_charge, critical_battery_limit_, battery_charge_, battery_estimator_->to_string().c_str()
+    );
+    replan_scheduler_.request(ReplanTrigger::CURRENT_GOALS, this->get_clock()->now().seconds());
+    battery_charge_at_battery_replan_ = battery_charge_;
   }
-  std::cout << "\n";
+}
 
-  const std::string drone_pos = get_location_(position_ned_.point); 
-  std::string predicate_str = "(drone_at " + drone_name + " " + drone_pos + ")";
-  RCLCPP_INFO(this->get_logger(), "Adding position predicate: " + predicate_str);
-  problem_expert_->addPredicate(plansys2::Predicate(predicate_str));
 
-  std::string landed_str;
-  if(anafi_state_.compare("FS_LANDED") == 0) // Preconditions already checked that string not empty
+void MissionControllerNode::update_execution_feedback_(const plansys2_msgs::action::ExecutePlan::Feedback& feedback)
+{
+  std::vector<ActionFeedbackSample> samples;
+  for(const plansys2_msgs::msg::ActionExecutionInfo& action_feedback : feedback.action_execution_status)
   {
-    landed_str = "(landed " + drone_name + ")";
+    ActionFeedbackSample sample;
+    sample.action_full_name = action_feedback.action_full_name;
+    sample.action_type = action_feedback.action;
+    sample.arguments = action_feedback.arguments;
+    sample.status = static_cast<ActionStatus>(action_feedback.status);
+    sample.start_time_s = rclcpp::Time(action_feedback.start_stamp).seconds();
+    sample.status_time_s = rclcpp::Time(action_feedback.status_stamp).seconds();
+    sample.completion = action_feedback.completion;
+    samples.push_back(sample);
   }
-  else 
+
+  execution_feedback_aggregator_.update(samples, this->get_clock()->now().seconds());
+  publish_execution_feedback_();
+
+  if(plan_validity_monitor_ && plan_validity_monitor_->is_plan_started())
   {
-    landed_str = "(not_landed " + drone_name + ")";
+    plan_validity_monitor_->update_progress(execution_feedback_aggregator_.get_actions());
   }
-  RCLCPP_INFO(this->get_logger(), "Adding landed predicate: " + landed_str);
-  problem_expert_->addPredicate(plansys2::Predicate(landed_str));
+}
 
-  if(anafi_state_.compare("FS_FLYING") != 0) // Preconditions already checked that string not empty
+
+void MissionControllerNode::init_plan_validity_monitor_()
+{
+  const bool is_monitor_enabled = this->get_parameter("plan_monitor.enabled").as_bool();
+  const bool is_relevance_pruning_enabled = this->get_parameter("planner.relevance_pruning").as_bool();
+  const bool is_soft_goals_enabled = this->get_parameter("planner.soft_goals.enabled").as_bool();
+  const bool is_speculation_enabled = this->get_parameter("planner.speculation.enabled").as_bool();
+  const std::string planner_backend = this->get_parameter("planner.backend").as_string();
+  if(planner_backend != "native" && planner_backend != "plansys2")
   {
-    // Assuminhg that movement requires the drone state to be FS_FLYING
-    std::string moving_str = "(not_moving " + drone_name + ")";
-    RCLCPP_INFO(this->get_logger(), "Adding moving predicate: " + moving_str);
-    problem_expert_->addPredicate(plansys2::Predicate(moving_str));
+    RCLCPP_WARN(this->get_logger(), "Unknown planner backend %s, using the PlanSys2 planner", planner_backend.c_str());
   }
-
-  std::vector<std::string> landable_locations = this->get_parameter("locations.landing_available").as_string_array();
-  for(std::string land_loc : landable_locations)
+  if(! is_monitor_enabled && ! is_relevance_pruning_enabled && ! is_soft_goals_enabled && ! is_speculation_enabled
+    && ! is_goal_check_enabled_ && planner_backend != "native")
   {
-    std::string landable_loc_str = "(can_land " + land_loc + ")";
-    RCLCPP_INFO(this->get_logger(), "Adding landable location predicate: " + landable_loc_str);
-    problem_expert_->addPredicate(plansys2::Predicate(landable_loc_str));
+    return;
+  }
 
-    // std::string not_tracked_landing_location_str = "(not_tracked " + land_loc + ")";
-    // RCLCPP_INFO(this->get_logger(), "Adding location tracking predicate: " + not_tracked_landing_location_str);
-    // problem_expert_->addPredicate(plansys2::Predicate(not_tracked_landing_location_str));
+  std::shared_ptr<const PddlDomain> domain;
+  try
+  {
+    domain = std::make_shared<const PddlDomain>(PddlDomain::parse(domain_expert_->getDomain()));
   }
-  std::vector<std::string> recharge_locations = this->get_parameter("locations.recharge_available").as_string_array();
-  for(std::string recharge_loc : recharge_locations)
+  catch(const std::runtime_error& e)
   {
-    std::string recharge_loc_str = "(can_recharge " + recharge_loc + ")";
-    RCLCPP_INFO(this->get_logger(), "Adding recharge location predicate: " + recharge_loc_str);
-    problem_expert_->addPredicate(plansys2::Predicate(recharge_loc_str));
+    RCLCPP_WARN(this->get_logger(), "Could not parse the domain, the plans are not monitored, and the PlanSys2 planner is used: %s", e.what());
+    return;
   }
 
-  std::vector<std::string> resupply_locations = this->get_parameter("locations.resupply_available").as_string_array();
-  for(std::string resupply_loc : resupply_locations)
+  if(is_monitor_enabled)
   {
-    std::string resupply_loc_str = "(can_resupply " + resupply_loc + ")";
-    RCLCPP_INFO(this->get_logger(), "Adding resupply location predicate: " + resupply_loc_str);
-    problem_expert_->addPredicate(plansys2::Predicate(resupply_loc_str));
+    plan_validity_monitor_ = std::make_unique<PlanValidityMonitor>(domain);
+    RCLCPP_INFO(this->get_logger(), "Monitoring the plans with %ld actions from the domain %s", 
+      domain->get_actions().size(), domain->get_name().c_str());
   }
+  if(planner_backend == "native" || is_soft_goals_enabled)
+  {
+    native_planner_ = std::make_unique<NativePlanner>(
+      domain,
+      this->get_parameter("planner.max_expansions").as_int(),
+      this->get_parameter("planner.timeout").as_double()
+    );
+    RCLCPP_INFO(this->get_logger(), is_native_backend_ ? "Planning with the native planner" : "Relaxing the goals with the native planner");
+  }
+  if(is_relevance_pruning_enabled)
+  {
+    relevance_analysis_ = std::make_unique<RelevanceAnalysis>(
+      domain,
+      this->get_parameter("planner.route_pruning").as_bool()
+    );
+  }
+  if(is_speculation_enabled)
+  {
+    speculative_planner_ = std::make_unique<SpeculativePlanner>(
+      domain,
+      this->get_parameter("planner.speculation.capacity").as_int(),
+      this->get_parameter("planner.speculation.max_expansions").as_int(),
+      this->get_parameter("planner.speculation.timeout").as_double(),
+      is_relevance_pruning_enabled
+    );
+    RCLCPP_INFO(this->get_logger(), "Planning for the likely next events in the background");
+  }
+  if(is_goal_check_enabled_)
+  {
+    goal_analysis_ = std::make_unique<GoalAnalysis>(domain);
+  }
+}
 
-  // The drone is assumed to not search, drop, track, rescue nor mark at the start of the mission
-  // All of these are required to be false to be able to move the drone
-  // See the PDDL-file
-  std::string searching_str = "(not_searching " + drone_name + ")";
-  RCLCPP_INFO(this->get_logger(), "Adding searching predicate: " + searching_str);
-  problem_expert_->addPredicate(plansys2::Predicate(searching_str));
-
-  std::string tracking_str = "(not_tracking " + drone_name + ")";
-  RCLCPP_INFO(this->get_logger(), "Adding tracking predicate: " + tracking_str);
-  problem_expert_->addPredicate(plansys2::Predicate(tracking_str));
-
-  std::string rescuing_str = "(not_rescuing " + drone_name + ")";
-  RCLCPP_INFO(this->get_logger(), "Adding rescuing predicate: " + rescuing_str);
-  problem_expert_->addPredicate(plansys2::Predicate(rescuing_str));
 
-  std::string marking_str = "(not_marking " + drone_name + ")";
-  RCLCPP_INFO(this->get_logger(), "Adding marking predicate: " + marking_str);
-  problem_expert_->addPredicate(plansys2::Predicate(marking_str));
+void MissionControllerNode::check_plan_validity_()
+{
+  if(! plan_validity_monitor_ || ! plan_validity_monitor_->is_plan_started())
+  {
+    return;
+  }
 
-  // Fixed functional values
-  std::string battery_usage_prefix = "drone.battery_usage_per_time_unit.";
-  double track_battery_usage = this->get_parameter(battery_usage_prefix + "track").as_double();
-  double move_battery_usage = this->get_parameter(battery_usage_prefix + "move").as_double();
+  // The battery telemetry is more recent than the function in the problem expert
+  const std::string drone_name = this->get_parameter("drone.name").as_string();
+  if(battery_charge_ >= 0)
+  {
+    plan_validity_monitor_->set_function_override("(battery_charge " + drone_name + ")", battery_charge_);
+  }
 
-  std::string velocity_prefix = "drone.velocity_limits.";
-  double track_velocity_limit = this->get_parameter(velocity_prefix + "track").as_double();
-  double move_velocity_limit = this->get_parameter(velocity_prefix + "move").as_double();
+  // A drone which has drifted away from its location is no longer at the location
+  std::vector<std::string> retracted_predicates;
+  double max_distance = this->get_parameter("locations.location_radius_m").as_double() + plan_monitor_position_margin_m_;
+  for(const PddlAtom& drone_at : knowledge_mirror_.get_predicates("drone_at"))
+  {
+    if(drone_at.arguments.size() != 2 || ! this->has_parameter("locations.pos_ne." + drone_at.arguments[1]))
+    {
+      continue;
+    }
+    std::vector<double> location_position = this->get_parameter("locations.pos_ne." + drone_at.arguments[1]).as_double_array();
+    double distance = std::sqrt(
+      std::pow(location_position[0] - position_ned_.point.x, 2) + std::pow(location_position[1] - position_ned_.point.y, 2));
+    if(distance > max_distance)
+    {
+      retracted_predicates.push_back(drone_at.to_string());
+    }
+  }
+  plan_validity_monitor_->set_retracted_predicates(retracted_predicates);
 
-  std::string track_battery_usage_str = "(= (track_battery_usage " + drone_name + ") " + std::to_string(track_battery_usage) + ")";
-  RCLCPP_INFO(this->get_logger(), "Adding battery usage function: " + track_battery_usage_str);
-  problem_expert_->addFunction(plansys2::Function(track_battery_usage_str));
+  const std::vector<PlanViolation>& violations = plan_validity_monitor_->check(knowledge_mirror_);
+  if(violations.empty() || is_plan_violation_reported_)
+  {
+    return;
+  }
 
-  std::string move_battery_usage_str = "(= (move_battery_usage " + drone_name + ") " + std::to_string(move_battery_usage) + ")";
-  RCLCPP_INFO(this->get_logger(), "Adding battery usage function: " + move_battery_usage_str);
-  problem_expert_->addFunction(plansys2::Function(move_battery_usage_str));
+  // A violation found as the plan finishes has no plan left to replan, and would replan for the
+  // empty goals of the idle state
+  if(! makespan_tracker_.is_plan_running() || controller_state_ == ControllerState::IDLE)
+  {
+    return;
+  }
 
-  std::string track_velocity_str = "(= (track_velocity " + drone_name + ") " + std::to_string(track_velocity_limit) + ")";
-  RCLCPP_INFO(this->get_logger(), "Adding velocity function: " + track_velocity_str);
-  problem_expert_->addFunction(plansys2::Function(track_velocity_str));
+  // A replan from an unchanged problem may give a plan with the same violation, for example
+  // while the drone is still outside of its location. The violation is reported when allowed
+  double now_s = this->get_clock()->now().seconds();
+  if(now_s - last_plan_violation_replan_time_s_ < plan_monitor_min_replan_interval_s_)
+  {
+    return;
+  }
 
-  std::string move_velocity_str = "(= (move_velocity " + drone_name + ") " + std::to_string(move_velocity_limit) + ")";
-  RCLCPP_INFO(this->get_logger(), "Adding velocity function: " + move_velocity_str);
-  problem_expert_->addFunction(plansys2::Function(move_velocity_str));
+  std::stringstream ss;
+  ss << "Remaining plan is invalid:\n";
+  for(const PlanViolation& violation : violations)
+  {
+    ss << "  " << violation.to_string() << "\n";
+  }
+  ss << plan_validity_monitor_->get_statistics_string();
+  RCLCPP_WARN(this->get_logger(), ss.str());
+  publish_plan_status_str_("Plan invalid");
 
-  std::cout << "\n\n";
+  replan_scheduler_.request(ReplanTrigger::PLAN_INVALID, now_s);
+  is_plan_violation_reported_ = true;
+  last_plan_violation_replan_time_s_ = now_s;
 }
 
 
-bool MissionControllerNode::update_plansys2_functions_()
+double MissionControllerNode::get_distance_(const std::string& loc_from, const std::string& loc_to)
 {
-  // Update values and insert new functions
-  std::string drone_name = this->get_parameter("drone.name").as_string();
+  std::string pos_ne_prefix = "locations.pos_ne.";
+  if(! this->has_parameter(pos_ne_prefix + loc_from) || ! this->has_parameter(pos_ne_prefix + loc_to))
+  {
+    return 0.0;
+  }
 
-  plansys2::Function markers_function = plansys2::Function("(= (num_markers " + drone_name + ") " + std::to_string(num_markers_) +")");
-  plansys2::Function lifevests_function = plansys2::Function("(= (num_lifevests " + drone_name + ")" + std::to_string(num_lifevests_) + ")");
-  plansys2::Function battery_charge_function = plansys2::Function("(= (battery_charge " + drone_name + ")" + std::to_string(battery_charge_) + ")");
+  const std::vector<double> from_location_ne_position = this->get_parameter(pos_ne_prefix + loc_from).as_double_array();
+  const std::vector<double> to_location_ne_position = this->get_parameter(pos_ne_prefix + loc_to).as_double_array();
+  double north_diff = from_location_ne_position[0] - to_location_ne_position[0];
+  double east_diff = from_location_ne_position[1] - to_location_ne_position[1]; 
+  return std::sqrt(std::pow(north_diff, 2) + std::pow(east_diff, 2));
+}
 
-  problem_expert_->addFunction(markers_function);
-  problem_expert_->addFunction(lifevests_function);
-  problem_expert_->addFunction(battery_charge_function);
 
-  return true;
+double MissionControllerNode::get_plan_makespan_(const plansys2_msgs::msg::Plan& plan)
+{
+  double makespan = 0.0;
+  for(const plansys2_msgs::msg::PlanItem& plan_item : plan.items)
+  {
+    makespan = std::max(makespan, static_cast<double>(plan_item.time + plan_item.duration));
+  }
+  return makespan;
 }
 
 
@@ -584,8 +1607,56 @@ bool MissionControllerNode::update_plansys2_goals_(const std::vector<std::string
   total_goal_string += ")";
   RCLCPP_INFO(this->get_logger(), "Setting goal-string as: " + total_goal_string);
 
-  problem_expert_->setGoal(plansys2::Goal(total_goal_string));
-  return true;
+  return set_goal_(total_goal_string);
+}
+
+
+bool MissionControllerNode::add_instance_(const std::string& name, const std::string& type)
+{
+  knowledge_mirror_.add_instance(name, type);
+  return problem_expert_->addInstance(plansys2::Instance{name, type});
+}
+
+
+bool MissionControllerNode::add_predicate_(const std::string& predicate_str)
+{
+  knowledge_mirror_.add_predicate(predicate_str);
+  return problem_expert_->addPredicate(plansys2::Predicate(predicate_str));
+}
+
+
+bool MissionControllerNode::remove_predicate_(const std::string& predicate_str)
+{
+  knowledge_mirror_.remove_predicate(predicate_str);
+  return problem_expert_->removePredicate(plansys2::Predicate(predicate_str));
+}
+
+
+bool MissionControllerNode::add_function_(const std::string& function_str)
+{
+  knowledge_mirror_.set_function(function_str);
+  return problem_expert_->addFunction(plansys2::Function(function_str));
+}
+
+
+bool MissionControllerNode::set_goal_(const std::string& goal_str)
+{
+  knowledge_mirror_.set_goal(goal_str);
+  return problem_expert_->setGoal(plansys2::Goal(goal_str));
+}
+
+
+void MissionControllerNode::clear_goal_()
+{
+  knowledge_mirror_.clear_goal();
+  problem_expert_->clearGoal();
+}
+
+
+void MissionControllerNode::clear_knowledge_()
+{
+  knowledge_mirror_.clear();
+  problem_expert_->clearKnowledge();
 }
 
 
@@ -780,6 +1851,32 @@ size_t MissionControllerNode::get_num_remaining_mission_goals_()
 }
 
 
+size_t MissionControllerNode::remove_satisfied_mission_goals_()
+{
+  // The search goals are the predicates themselves, while the other goals are the predicates 
+  // negated by the actions: (not_<predicate> ...) is achieved by (<predicate> ...)
+  auto is_satisfied = [this](const std::string& goal)
+  {
+    const std::string negated_prefix = "(not_";
+    if(goal.compare(0, negated_prefix.size(), negated_prefix) == 0)
+    {
+      return knowledge_mirror_.has_predicate("(" + goal.substr(negated_prefix.size()));
+    }
+    return knowledge_mirror_.has_predicate(goal);
+  };
+
+  size_t num_removed_goals = 0;
+  for(std::vector<std::string>* goals : { &mission_goals_.search_goal_strings_, &mission_goals_.communicate_location_goal_strings_, 
+    &mission_goals_.mark_location_goal_strings_, &mission_goals_.rescue_location_goal_strings_ })
+  {
+    std::vector<std::string>::iterator removed_begin = std::remove_if(goals->begin(), goals->end(), is_satisfied);
+    num_removed_goals += goals->end() - removed_begin;
+    goals->erase(removed_begin, goals->end());
+  }
+  return num_removed_goals;
+}
+
+
 bool MissionControllerNode::check_desired_final_state_achieved_()
 {
   std::string mission_goal_prefix = "mission_goals.";
@@ -804,25 +1901,30 @@ bool MissionControllerNode::check_desired_final_state_achieved_()
 const std::tuple<ControllerState, bool> MissionControllerNode::recommend_replan_()
 {
   bool recommend_replan = false;
+  bool replan_in_same_state = false;
 
   ControllerState desired_controller_state;
   std::string reason_to_replan;
 
-  // Obs! Race condition: A replanning will be triggered even if the state is in emergency,
-  // if a new message is received before the ifs is checked. Desirable to only replan once to a certain 
-  // condition
-  // It assumes that the original emergency is capable of planning for whatever the next emergency 
-  // is being triggered by
-  // For rescue, one would like to force replanning! This is due to new information about someone detected
-
-  if(is_person_detected_)
+  // The triggers are coalesced by the scheduler, such that a burst of detections results in a 
+  // single replan. Emergencies are prioritized over rescues, which are prioritized over replanning
+  // the current goals. While in emergency, only a new emergency is allowed to trigger a replan
+  double time_s = this->get_clock()->now().seconds();
+  ReplanTrigger min_trigger = (controller_state_ == ControllerState::EMERGENCY) ? ReplanTrigger::EMERGENCY : ReplanTrigger::NONE;
+  ReplanTrigger trigger = replan_scheduler_.poll(
+    time_s, makespan_tracker_.is_plan_running(), makespan_tracker_.get_predicted_remaining_s(time_s), min_trigger);
+
+  // Replanning in the same state requires a running plan with goals to replan for. A trigger which
+  // is polled after the plan finished would replan for the empty goals of the idle state
+  bool is_same_state_trigger = (trigger == ReplanTrigger::PLAN_INVALID || trigger == ReplanTrigger::CURRENT_GOALS);
+  bool is_replanning_state = (controller_state_ != ControllerState::IDLE && controller_state_ != ControllerState::INIT);
+  if(is_same_state_trigger && ! (is_replanning_state && makespan_tracker_.is_plan_running()))
   {
-    recommend_replan = true;
-    desired_controller_state = ControllerState::RESCUE;
-    reason_to_replan = "Person detected!";
-    is_person_detected_ = false; // Only trigger replan once
+    RCLCPP_INFO(this->get_logger(), "Ignoring a replan of the current goals, as no plan is running");
+    trigger = ReplanTrigger::NONE;
   }
-  else if(is_emergency_) // && controller_state != ControllerState::Emergency // latter might be useful to only trigger emergency replanning once
+
+  if(trigger == ReplanTrigger::EMERGENCY)
   {
     // For future work, this should take the rescue situation and the severity of the emergency into 
     // account. Currently, even if there is an ongoing rescue-operation, a minor emergency will force 
@@ -830,7 +1932,28 @@ const std::tuple<ControllerState, bool> MissionControllerNode::recommend_replan_
     recommend_replan = true;
     desired_controller_state = ControllerState::EMERGENCY;
     reason_to_replan = "Emergency occured!";
-    is_emergency_ = false; // Only trigger replan once
+  }
+  else if(trigger == ReplanTrigger::RESCUE)
+  {
+    recommend_replan = true;
+    desired_controller_state = ControllerState::RESCUE;
+    reason_to_replan = "Person detected!";
+  }
+  else if(trigger == ReplanTrigger::PLAN_INVALID)
+  {
+    recommend_replan = true;
+    replan_in_same_state = true;
+    desired_controller_state = controller_state_;
+    reason_to_replan = "Remaining plan violated by the current knowledge or telemetry!";
+  }
+  else if(trigger == ReplanTrigger::CURRENT_GOALS)
+  {
+    // Replan for the same goals using the recalibrated discharge rates, such that the planner 
+    // can add a recharge or relax the goals before the critical limit forces an emergency
+    recommend_replan = true;
+    replan_in_same_state = true;
+    desired_controller_state = controller_state_;
+    reason_to_replan = "Remaining plan predicted infeasible with the current battery!";
   }
   else
   {
@@ -846,10 +1969,12 @@ const std::tuple<ControllerState, bool> MissionControllerNode::recommend_replan_
       }
       case ControllerState::IDLE:
       {
-        // Check that there are remaining mission goals or whether there are goals
+        // Check that there are remaining mission goals or whether there are goals. A final state 
+        // which is not achieved is not replanned for again, if the previous replan found that the
+        // current state already satisfies the goals of the search
         bool remaining_mission_goals = (get_num_remaining_mission_goals_() > 0);
         bool final_state_achieved = check_desired_final_state_achieved_();
-        if(remaining_mission_goals || ! final_state_achieved)
+        if(remaining_mission_goals || (! final_state_achieved && ! is_idle_goals_satisfied_))
         {
           desired_controller_state = ControllerState::SEARCH;
           recommend_replan = true;
@@ -873,7 +1998,7 @@ const std::tuple<ControllerState, bool> MissionControllerNode::recommend_replan_
   if(recommend_replan)
   {
     // Ugly code, but hopefully prevents the race conditions triggering replanning
-    if(controller_state_ == desired_controller_state)
+    if(controller_state_ == desired_controller_state && ! replan_in_same_state)
     {
       switch (controller_state_)
       {
@@ -910,22 +2035,118 @@ bool MissionControllerNode::replan_mission_(std::optional<plansys2_msgs::msg::Pl
   // Compute the plan
   RCLCPP_WARN(this->get_logger(), "Replanning");
   std::string domain = domain_expert_->getDomain();
+  // The planner requires the exact problem of the problem expert
   std::string problem = problem_expert_->getProblem();
+  knowledge_mirror_.record_remote_query();
   rclcpp::Time start_time = this->get_clock()->now();
-  plan = planner_client_->getPlan(domain, problem); 
+  std::chrono::steady_clock::time_point wall_start_time = std::chrono::steady_clock::now();
+  plan = compute_plan_(domain, problem);
   rclcpp::Time end_time = this->get_clock()->now();
   rclcpp::Duration duration = end_time - start_time;
 
-  if(! plan.has_value()) 
+  double planner_duration_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start_time).count();
+  last_planner_duration_s_ += planner_duration_s;
+  total_planner_duration_s_ += planner_duration_s;
+
+  if(! plan.has_value()) 
+  {
+    std::string error_str = "Could not find plan to reach goal: " +
+      knowledge_mirror_.get_goal() + 
+      "\n\nSolver-duration: " + std::to_string(duration.seconds()) + "s\n";
+    RCLCPP_ERROR(this->get_logger(), error_str);
+    return false;
+  }
+  RCLCPP_INFO(this->get_logger(), "New plan found! Solver-duration: %f s", duration.seconds());
+  return true;
+}
+
+
+std::optional<plansys2_msgs::msg::Plan> MissionControllerNode::compute_plan_(const std::string& domain, const std::string& problem)
+{
+  std::optional<PddlProblem> pddl_problem;
+  if(is_native_backend_ || relevance_analysis_ || speculative_planner_)
+  {
+    try
+    {
+      pddl_problem = PddlProblem::parse(problem);
+    }
+    catch(const std::runtime_error& e)
+    {
+      RCLCPP_WARN(this->get_logger(), "Could not parse the problem, planning with the PlanSys2 planner: %s", e.what());
+    }
+  }
+
+  // A plan computed in the background for this event is adopted if it is valid for the problem
+  if(speculative_planner_ && pddl_problem.has_value())
+  {
+    std::string event;
+    std::optional<std::vector<PlannedAction>> planned_actions = speculative_planner_->lookup(pddl_problem.value(), event);
+    if(planned_actions.has_value())
+    {
+      RCLCPP_INFO(this->get_logger(), "Adopting the plan speculated for %s", event.c_str());
+      return to_plan_msg(planned_actions.value());
+    }
+  }
+
+  auto solve = [&](const std::optional<PddlProblem>& problem_to_solve, const std::string& problem_str)
+  {
+    std::optional<plansys2_msgs::msg::Plan> plan;
+    const bool is_native = is_native_backend_ && native_planner_;
+    if(is_native && problem_to_solve.has_value())
+    {
+      plan = plan_natively_(problem_to_solve.value());
+    }
+    if(! plan.has_value() && (! is_native || ! problem_to_solve.has_value() || is_planner_fallback_enabled_))
+    {
+      plan = planner_client_->getPlan(domain, problem_str);
+    }
+    return plan;
+  };
+
+  // A plan for the reduced problem is a plan for the full problem, as the objects keep their names
+  if(relevance_analysis_ && pddl_problem.has_value())
+  {
+    std::optional<PddlProblem> reduced_problem;
+    try
+    {
+      reduced_problem = relevance_analysis_->reduce(pddl_problem.value());
+      RCLCPP_INFO(this->get_logger(), "%s", relevance_analysis_->get_statistics().to_string().c_str());
+    }
+    catch(const std::runtime_error& e)
+    {
+      RCLCPP_WARN(this->get_logger(), "Could not reduce the problem: %s", e.what());
+    }
+    if(reduced_problem.has_value())
+    {
+      std::optional<plansys2_msgs::msg::Plan> plan = solve(reduced_problem, reduced_problem->to_string());
+      if(plan.has_value())
+      {
+        return plan;
+      }
+      RCLCPP_WARN(this->get_logger(), "No plan for the reduced problem, planning for the full problem");
+    }
+  }
+  return solve(pddl_problem, problem);
+}
+
+
+std::optional<plansys2_msgs::msg::Plan> MissionControllerNode::plan_natively_(const PddlProblem& problem)
+{
+  try
   {
-    std::string error_str = "Could not find plan to reach goal: " +
-      parser::pddl::toString(problem_expert_->getGoal()) + 
-      "\n\nSolver-duration: " + std::to_string(duration.seconds()) + "s\n";
-    RCLCPP_ERROR(this->get_logger(), error_str);
-    return false;
+    std::optional<std::vector<PlannedAction>> planned_actions = native_planner_->solve(problem);
+    RCLCPP_INFO(this->get_logger(), "Native planner: %s", native_planner_->get_statistics().to_string().c_str());
+    if(planned_actions.has_value())
+    {
+      return to_plan_msg(planned_actions.value());
+    }
+    RCLCPP_WARN(this->get_logger(), "The native planner found no plan");
   }
-  RCLCPP_INFO(this->get_logger(), "New plan found! Solver-duration: %f s", duration.seconds());
-  return true;
+  catch(const std::runtime_error& e)
+  {
+    RCLCPP_WARN(this->get_logger(), "The native planner could not plan for the problem: %s", e.what());
+  }
+  return std::nullopt;
 }
 
 
@@ -965,8 +2186,12 @@ bool MissionControllerNode::relax_mission_goals_(
   {
     goals.back() = subgoal;
 
+    // A subgoal which already holds is valid without a plan, and one which no plan can reach is not
+    // given to the planner
     update_plansys2_goals_(goals);
-    if(replan_mission_(valid_plan))
+    std::vector<std::string> unreachable_goals;
+    const GoalStatus goal_status = check_current_goals_(goals, unreachable_goals);
+    if(goal_status == GoalStatus::SATISFIED || (goal_status == GoalStatus::OPEN && replan_mission_(valid_plan)))
     {
       valid_subgoals.push_back(subgoal);
       goals_relaxed = true;
@@ -977,6 +2202,270 @@ bool MissionControllerNode::relax_mission_goals_(
 }
 
 
+bool MissionControllerNode::relax_mission_goals_with_soft_goals_(
+  const std::vector<std::string>& constant_subgoals,
+  const std::vector<std::string>& relaxable_subgoals, 
+  std::vector<std::string>& valid_subgoals,
+  std::optional<plansys2_msgs::msg::Plan>& valid_plan
+)
+{
+  if(! native_planner_ || relaxable_subgoals.empty() || relaxable_subgoals[0].empty())
+  {
+    return false;
+  }
+
+  std::chrono::steady_clock::time_point wall_start_time = std::chrono::steady_clock::now();
+  std::optional<PddlProblem> problem;
+  try
+  {
+    problem = PddlProblem::parse(problem_expert_->getProblem());
+    knowledge_mirror_.record_remote_query();
+  }
+  catch(const std::runtime_error& e)
+  {
+    RCLCPP_WARN(this->get_logger(), "Could not parse the problem, relaxing the goals one at a time: %s", e.what());
+    return false;
+  }
+
+  // The relevance analysis is not used, as a plan for the reduced problem may achieve fewer soft
+  // goals than one for the full problem
+  problem->goals.clear();
+  for(const std::string& goal_str : constant_subgoals)
+  {
+    std::optional<PddlAtom> goal = PddlAtom::parse(goal_str);
+    if(! goal.has_value())
+    {
+      RCLCPP_WARN(this->get_logger(), "Could not parse the goal %s", goal_str.c_str());
+      return false;
+    }
+    PddlCondition condition;
+    condition.predicate = goal.value();
+    problem->goals.push_back(condition);
+  }
+  std::vector<SoftGoal> soft_goals;
+  for(const std::string& goal_str : relaxable_subgoals)
+  {
+    std::optional<PddlAtom> goal = PddlAtom::parse(goal_str);
+    if(! goal.has_value())
+    {
+      RCLCPP_WARN(this->get_logger(), "Could not parse the goal %s", goal_str.c_str());
+      return false;
+    }
+    soft_goals.push_back({ goal.value(), get_soft_goal_utility_(goal.value()) });
+  }
+
+  std::optional<std::vector<PlannedAction>> planned_actions;
+  try
+  {
+    planned_actions = native_planner_->solve(problem.value(), soft_goals);
+    RCLCPP_INFO(this->get_logger(), "Native planner: %s", native_planner_->get_statistics().to_string().c_str());
+  }
+  catch(const std::runtime_error& e)
+  {
+    RCLCPP_WARN(this->get_logger(), "The native planner could not plan for the problem: %s", e.what());
+  }
+
+  double planner_duration_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start_time).count();
+  last_planner_duration_s_ += planner_duration_s;
+  total_planner_duration_s_ += planner_duration_s;
+  if(! planned_actions.has_value())
+  {
+    RCLCPP_WARN(this->get_logger(), "No plan with soft goals, relaxing the goals one at a time");
+    return false;
+  }
+
+  valid_subgoals.clear();
+  const std::vector<bool>& achieved_soft_goals = native_planner_->get_achieved_soft_goals();
+  for(size_t i = 0; i < relaxable_subgoals.size(); i++)
+  {
+    if(achieved_soft_goals[i])
+    {
+      valid_subgoals.push_back(relaxable_subgoals[i]);
+    }
+  }
+  // As when relaxing one goal at a time, the relaxation fails if no relaxable subgoal is valid
+  if(valid_subgoals.empty())
+  {
+    return false;
+  }
+  valid_plan = to_plan_msg(planned_actions.value());
+  RCLCPP_INFO(this->get_logger(), "Relaxed the goals with soft goals in %f s", planner_duration_s);
+  return true;
+}
+
+
+double MissionControllerNode::get_soft_goal_utility_(const PddlAtom& goal)
+{
+  std::string soft_goals_prefix = "planner.soft_goals.";
+  if(goal.name == "searched")
+  {
+    return this->get_parameter(soft_goals_prefix + "search_utility").as_double();
+  }
+  if(goal.name == "drone_at")
+  {
+    return this->get_parameter(soft_goals_prefix + "landing_utility").as_double();
+  }
+
+  double utility = 1.0;
+  if(goal.name == "communicated")
+  {
+    utility = this->get_parameter(soft_goals_prefix + "communicate_utility").as_double();
+  }
+  else if(goal.name == "marked")
+  {
+    utility = this->get_parameter(soft_goals_prefix + "mark_utility").as_double();
+  }
+  else if(goal.name == "rescued")
+  {
+    utility = this->get_parameter(soft_goals_prefix + "rescue_utility").as_double();
+  }
+
+  // The people are named p<idx>, and their utilities are scaled by the severity
+  if(! goal.arguments.empty() && goal.arguments[0].size() > 1 && goal.arguments[0][0] == 'p')
+  {
+    std::map<int, std::tuple<geometry_msgs::msg::Point, Severity, bool>>::iterator it = 
+      detected_people_.find(std::atoi(goal.arguments[0].c_str() + 1));
+    std::vector<double> severity_factors = this->get_parameter(soft_goals_prefix + "severity_factors").as_double_array();
+    if(it != detected_people_.end() && static_cast<size_t>(std::get<1>(it->second)) < severity_factors.size())
+    {
+      utility *= severity_factors[static_cast<size_t>(std::get<1>(it->second))];
+    }
+  }
+  return utility;
+}
+
+
+void MissionControllerNode::speculate_next_events_()
+{
+  if(! speculative_planner_ || ! makespan_tracker_.is_plan_running())
+  {
+    return;
+  }
+  // The replan places the drone at its current location, which is unknown between the locations
+  const std::string location = get_location_(position_ned_.point);
+  if(location.empty())
+  {
+    return;
+  }
+  const std::string state_key = std::to_string(static_cast<int>(controller_state_)) + " " + location + " " 
+    + std::to_string(knowledge_mirror_.get_version());
+  if(state_key == speculation_state_key_)
+  {
+    return;
+  }
+  speculation_state_key_ = state_key;
+
+  // The current knowledge as the replan will update it
+  const std::string drone_name = this->get_parameter("drone.name").as_string();
+  PddlProblem problem;
+  problem.name = "speculation";
+  problem.objects = knowledge_mirror_.get_instances();
+  for(const PddlAtom& predicate : knowledge_mirror_.get_all_predicates())
+  {
+    if(predicate.name != "drone_at")
+    {
+      problem.predicates.push_back(predicate);
+    }
+  }
+  problem.predicates.push_back(PddlAtom{ "drone_at", { drone_name, location } });
+  problem.functions = knowledge_mirror_.get_all_functions();
+  for(const std::pair<PddlAtom, double>& drone_function : get_drone_functions_())
+  {
+    std::vector<std::pair<PddlAtom, double>>::iterator it = std::find_if(problem.functions.begin(), problem.functions.end(), 
+      [&drone_function](const std::pair<PddlAtom, double>& function) { return function.first.to_string() == drone_function.first.to_string(); });
+    if(it != problem.functions.end())
+    {
+      it->second = drone_function.second;
+    }
+    else
+    {
+      problem.functions.push_back(drone_function);
+    }
+  }
+
+  std::vector<SpeculativeEvent> events;
+  auto add_event = [this, &events](const std::string& label, PddlProblem event_problem, const std::vector<std::string>& goals)
+  {
+    for(const std::string& goal_str : goals)
+    {
+      std::optional<PddlAtom> goal = PddlAtom::parse(goal_str);
+      if(! goal.has_value())
+      {
+        RCLCPP_WARN(this->get_logger(), "Could not parse the goal %s, not speculating on %s", goal_str.c_str(), label.c_str());
+        return;
+      }
+      PddlCondition condition;
+      condition.predicate = goal.value();
+      event_problem.goals.push_back(condition);
+    }
+    events.push_back({ label, std::move(event_problem) });
+  };
+
+  std::vector<std::string> goals;
+  if(controller_state_ != ControllerState::EMERGENCY)
+  {
+    goals.clear();
+    load_emergency_mission_goals_(goals);
+    add_event("an emergency", problem, goals);
+
+    // The person is renamed to the ID given by the tracker when the plan is adopted
+    const std::string person_id = "p_speculated";
+    const std::vector<std::string> severity_names = { "minor", "moderate", "high" };
+    for(Severity severity : { Severity::MINOR, Severity::MODERATE, Severity::HIGH })
+    {
+      PddlProblem person_problem = problem;
+      person_problem.objects.push_back({ person_id, "person" });
+      person_problem.predicates.push_back(PddlAtom{ "person_at", { person_id, location } });
+      person_problem.predicates.push_back(PddlAtom{ "not_tracked", { person_id } });
+      goals.clear();
+      load_rescue_mission_goals_(goals);
+      switch (severity)
+      {
+        case Severity::HIGH:
+        {
+          person_problem.predicates.push_back(PddlAtom{ "not_rescued", { person_id, location } });
+          goals.push_back("(rescued " + person_id + " " + location + ")");
+          [[fallthrough]];
+        }
+        case Severity::MODERATE:
+        {
+          person_problem.predicates.push_back(PddlAtom{ "not_marked", { person_id, location } });
+          goals.push_back("(marked " + person_id + " " + location + ")");
+          [[fallthrough]];
+        }
+        case Severity::MINOR:
+        {
+          person_problem.predicates.push_back(PddlAtom{ "not_communicated", { person_id, location } });
+          goals.push_back("(communicated " + person_id + " " + location + ")");
+          break;
+        }
+      }
+      add_event("a person with " + severity_names[static_cast<size_t>(severity)] + " severity at " + location, person_problem, goals);
+    }
+  }
+
+  // The next location of the plan becomes unavailable, which invalidates the remaining plan
+  for(const ActionTiming& timing : execution_feedback_aggregator_.get_actions())
+  {
+    std::optional<PddlAtom> action = PddlAtom::parse(timing.action);
+    if(timing.is_finished || ! action.has_value() || action->name != "move" || action->arguments.empty())
+    {
+      continue;
+    }
+    const std::string unavailable_predicate = "(available " + action->arguments.back() + ")";
+    PddlProblem unavailable_problem = problem;
+    unavailable_problem.predicates.erase(std::remove_if(unavailable_problem.predicates.begin(), unavailable_problem.predicates.end(), 
+      [&unavailable_predicate](const PddlAtom& predicate) { return predicate.to_string() == unavailable_predicate; }), 
+      unavailable_problem.predicates.end());
+    load_mission_goals_(controller_state_, goals);
+    add_event(action->arguments.back() + " becoming unavailable", unavailable_problem, goals);
+    break;
+  }
+
+  speculative_planner_->speculate(events);
+}
+
+
 bool MissionControllerNode::check_plan_completed_()
 {
   if (! executor_client_->execute_and_check_plan() && executor_client_->getResult()) 
@@ -996,6 +2485,62 @@ bool MissionControllerNode::check_plan_completed_()
 }
 
 
+GoalStatus MissionControllerNode::check_current_goals_(const std::vector<std::string>& goals, std::vector<std::string>& unreachable_goals)
+{
+  unreachable_goals.clear();
+  if(! is_goal_check_enabled_)
+  {
+    return GoalStatus::OPEN;
+  }
+
+  // The mirror holds the knowledge written for the replan, such that the problem expert is not queried
+  PddlProblem problem;
+  problem.objects = knowledge_mirror_.get_instances();
+  problem.predicates = knowledge_mirror_.get_all_predicates();
+  problem.functions = knowledge_mirror_.get_all_functions();
+  for(const std::string& goal_str : goals)
+  {
+    std::optional<PddlAtom> goal = PddlAtom::parse(goal_str);
+    if(! goal.has_value())
+    {
+      RCLCPP_WARN(this->get_logger(), "Could not parse the goal %s, the goals are not checked before planning", goal_str.c_str());
+      return GoalStatus::OPEN;
+    }
+    PddlCondition condition;
+    condition.predicate = goal.value();
+    problem.goals.push_back(condition);
+  }
+
+  // Without the parsed domain, only the satisfied goals are found
+  if(! goal_analysis_)
+  {
+    return GoalAnalysis::is_satisfied(problem) ? GoalStatus::SATISFIED : GoalStatus::OPEN;
+  }
+  std::vector<PddlCondition> unreachable_conditions;
+  GoalStatus status = GoalStatus::OPEN;
+  try
+  {
+    status = goal_analysis_->analyze(problem, unreachable_conditions);
+    RCLCPP_INFO(this->get_logger(), "%s", goal_analysis_->get_statistics().to_string().c_str());
+  }
+  catch(const std::runtime_error& e)
+  {
+    RCLCPP_WARN(this->get_logger(), "Could not analyze the goals: %s", e.what());
+    return GoalAnalysis::is_satisfied(problem) ? GoalStatus::SATISFIED : GoalStatus::OPEN;
+  }
+  for(size_t i = 0; i < goals.size(); i++)
+  {
+    const std::string goal_str = problem.goals[i].predicate.to_string();
+    if(std::any_of(unreachable_conditions.begin(), unreachable_conditions.end(), 
+      [&goal_str](const PddlCondition& condition) { return condition.predicate.to_string() == goal_str; }))
+    {
+      unreachable_goals.push_back(goals[i]);
+    }
+  }
+  return status;
+}
+
+
 std::string MissionControllerNode::get_location_(const geometry_msgs::msg::Point& point)
 {
   std::string locations_prefix = "locations.";
@@ -1065,8 +2610,7 @@ void MissionControllerNode::log_planning_state_()
 
   ss << "\n\n";
   ss << "Current system state:\n";
-  ss << "Person detected: " << is_person_detected_ << "\n";
-  ss << "Emergency occured: "  << is_emergency_ << "\n";
+  ss << "Pending replan triggers: " << replan_scheduler_.has_pending() << "\n";
   ss << "Low battery: " << is_low_battery_ << "\n";
   
   ss << "\n";
@@ -1109,7 +2653,8 @@ void MissionControllerNode::log_planning_state_()
   ss << "\n";
 
   ss << "\n";
-  ss << "Planning problem: \n" << problem_expert_->getProblem() + "\n";
+  ss << "Planning problem (mirrored): \n" << knowledge_mirror_.to_string() + "\n";
+  ss << knowledge_mirror_.get_statistics_string() << "\n";
 
   // ss << "\n";
   // ss << "Previous plan: \n\n" << previous_plan_str_ << "\n\n";
@@ -1205,14 +2750,21 @@ void MissionControllerNode::log_relaxed_goals_(
 }
 
 
-void MissionControllerNode::print_action_feedback_()
+void MissionControllerNode::log_makespan_(double makespan_error_s)
 {
-  auto feedback = executor_client_->getFeedBack();
-  for (const auto & action_feedback : feedback.action_execution_status) 
-  {
-    // std::cout faster than RCLCPP_INFO
-    std::cout << "[" << action_feedback.action << " " << action_feedback.completion * 100.0 << "%]" << std::endl;
-  }
+  std::stringstream ss;
+  ss << "\n\nPlan completed with makespan error (actual - predicted): " << makespan_error_s << " s\n";
+  ss << "Mission makespan over " << makespan_tracker_.get_num_completed_plans() << " completed plans: "
+    << "predicted " << makespan_tracker_.get_mission_predicted_s() << " s, "
+    << "actual " << makespan_tracker_.get_mission_actual_s() << " s, "
+    << "relative error " << 100.0 * makespan_tracker_.get_mission_relative_error() << " %\n";
+  ss << duration_model_->to_string();
+  ss << execution_feedback_aggregator_.to_string();
+  RCLCPP_INFO(this->get_logger(), ss.str());
+
+  std_msgs::msg::Float64 msg;
+  msg.data = makespan_error_s;
+  makespan_error_pub_->publish(msg);
 }
 
 
@@ -1226,6 +2778,69 @@ void MissionControllerNode::publish_plan_status_str_(const std::string& str)
 }
 
 
+void MissionControllerNode::publish_replan_statistics_(double hover_time_lost_s)
+{
+  RCLCPP_INFO(this->get_logger(), replan_scheduler_.to_string());
+
+  anafi_uav_interfaces::msg::ReplanStatistics msg;
+  msg.header.stamp = this->get_clock()->now();
+  msg.num_replans = replan_scheduler_.get_num_replans();
+  msg.num_triggers = replan_scheduler_.get_num_requests();
+  msg.num_coalesced_triggers = replan_scheduler_.get_num_coalesced();
+  msg.num_deferred_triggers = replan_scheduler_.get_num_deferred();
+  msg.last_hover_time_lost = hover_time_lost_s;
+  msg.total_hover_time_lost = replan_scheduler_.get_hover_time_lost_s();
+  msg.last_planner_duration = last_planner_duration_s_;
+  msg.total_planner_duration = total_planner_duration_s_;
+  if(speculative_planner_)
+  {
+    SpeculationStatistics statistics = speculative_planner_->get_statistics();
+    RCLCPP_INFO(this->get_logger(), "%s", statistics.to_string().c_str());
+    msg.num_speculative_plans = statistics.num_speculations;
+    msg.num_speculation_lookups = statistics.num_lookups;
+    msg.num_speculation_hits = statistics.num_hits;
+    msg.total_speculation_saved = statistics.saved_duration_s;
+  }
+  replan_statistics_pub_->publish(msg);
+}
+
+
+void MissionControllerNode::publish_execution_feedback_()
+{
+  rclcpp::Time now = this->get_clock()->now();
+
+  anafi_uav_interfaces::msg::ExecutionFeedback msg;
+  msg.header.stamp = now;
+  msg.plan_elapsed = execution_feedback_aggregator_.get_plan_elapsed_s(now.seconds());
+  for(const ActionTiming& timing : execution_feedback_aggregator_.get_actions())
+  {
+    anafi_uav_interfaces::msg::ActionTiming timing_msg;
+    timing_msg.action = timing.action;
+    timing_msg.status = static_cast<uint8_t>(timing.status);
+    timing_msg.completion = timing.completion;
+    timing_msg.planned_start = timing.planned_start_s;
+    timing_msg.planned_duration = timing.planned_duration_s;
+    timing_msg.actual_start = timing.actual_start_s;
+    timing_msg.actual_duration = timing.actual_duration_s;
+    msg.actions.push_back(timing_msg);
+  }
+  for(const ActionTypeStatistics& statistics : execution_feedback_aggregator_.get_statistics())
+  {
+    anafi_uav_interfaces::msg::ActionTypeStatistics statistics_msg;
+    statistics_msg.action_type = statistics.action_type;
+    statistics_msg.num_succeeded = statistics.num_succeeded;
+    statistics_msg.num_failed = statistics.num_failed;
+    statistics_msg.total_actual_duration = statistics.total_actual_s;
+    statistics_msg.total_planned_duration = statistics.total_planned_s;
+    statistics_msg.mean_duration_error = statistics.mean_duration_error_s;
+    statistics_msg.p95_duration_error = statistics.p95_duration_error_s;
+    statistics_msg.mean_start_delay = statistics.mean_start_delay_s;
+    msg.statistics.push_back(statistics_msg);
+  }
+  execution_feedback_pub_->publish(msg);
+}
+
+
 void MissionControllerNode::publish_plansys2_plan_(const std::optional<plansys2_msgs::msg::Plan>& plan)
 {
   plansys2_msgs::msg::Plan plan_msg = plan.value();
@@ -1235,6 +2850,7 @@ void MissionControllerNode::publish_plansys2_plan_(const std::optional<plansys2_
 
 void MissionControllerNode::anafi_state_cb_(std_msgs::msg::String::SharedPtr state_msg)
 {
+
   std::string state = state_msg->data;
   if(std::find_if(possible_anafi_states_.begin(), possible_anafi_states_.end(), [state](std::string str){ return state.compare(str) == 0; }) == possible_anafi_states_.end())
   {
@@ -1248,6 +2864,7 @@ void MissionControllerNode::anafi_state_cb_(std_msgs::msg::String::SharedPtr sta
 
 void MissionControllerNode::ned_pos_cb_(geometry_msgs::msg::PointStamped::ConstSharedPtr ned_pos_msg)
 {
+
   // Assume that the message is more recent for now... (bad assumption)
   position_ned_.header.stamp = ned_pos_msg->header.stamp;
   position_ned_.point = ned_pos_msg->point;
@@ -1256,12 +2873,14 @@ void MissionControllerNode::ned_pos_cb_(geometry_msgs::msg::PointStamped::ConstS
 
 void MissionControllerNode::gnss_data_cb_(sensor_msgs::msg::NavSatFix::ConstSharedPtr gnss_data_msg)
 {
+
   (void) gnss_data_msg;
 }
 
 
 void MissionControllerNode::attitude_cb_(geometry_msgs::msg::QuaternionStamped::ConstSharedPtr attitude_msg)
 {
+
   attitude_.header.stamp = attitude_msg->header.stamp;
   attitude_.quaternion = attitude_msg->quaternion;
 }
@@ -1269,6 +2888,7 @@ void MissionControllerNode::attitude_cb_(geometry_msgs::msg::QuaternionStamped::
 
 void MissionControllerNode::polled_vel_cb_(geometry_msgs::msg::TwistStamped::ConstSharedPtr vel_msg)
 {
+
   // Assume that the message is more recent for now... (bad assumption)
   polled_vel_.header.stamp = vel_msg->header.stamp;
   polled_vel_.twist = vel_msg->twist;
@@ -1277,8 +2897,15 @@ void MissionControllerNode::polled_vel_cb_(geometry_msgs::msg::TwistStamped::Con
 
 void MissionControllerNode::battery_charge_cb_(std_msgs::msg::Float64::ConstSharedPtr battery_msg)
 {
+
   battery_charge_ = battery_msg->data;
 
+  // The executing action is updated by the controller at each step
+  if(battery_estimator_->add_sample(this->get_clock()->now().seconds(), battery_charge_, executing_action_type_))
+  {
+    RCLCPP_DEBUG(this->get_logger(), battery_estimator_->to_string());
+  }
+
   if(battery_charge_ <= low_battery_limit_)
   {
     RCLCPP_WARN_ONCE(this->get_logger(), "Low battery");
@@ -1292,31 +2919,34 @@ void MissionControllerNode::battery_charge_cb_(std_msgs::msg::Float64::ConstShar
     {
       // Only force a replan when the system is not in emergency-state
       // Bad code here - the input data should be filtered in another function and not in this 
-      is_emergency_ = true;
+      replan_scheduler_.request(ReplanTrigger::EMERGENCY, this->get_clock()->now().seconds());
     }
   }
 }
 
 
-void MissionControllerNode::detected_person_cb_(anafi_uav_interfaces::msg::DetectedPerson::ConstSharedPtr detected_person_msg)
+void MissionControllerNode::person_tracks_cb_(anafi_uav_interfaces::msg::PersonTrackArray::ConstSharedPtr person_tracks_msg)
 {
-  geometry_msgs::msg::Point position = detected_person_msg->position;
-  Severity severity = Severity(detected_person_msg->severity);
-  int idx = static_cast<int>(detected_person_msg->id);
 
-  // Maximum distance between detections to separate them as different peoople
-  // Based on the discussion with Simen, the error will be roughly 0.5 meters. 
-  const double radius = 2.5;
-  std::vector<int> people_vec = get_people_within_radius_of_(position, radius);
-  auto it = std::find(people_vec.begin(), people_vec.end(), idx);
-  if(it != people_vec.end())
+  // The person tracker associates the detections and keeps the IDs stable. Previously detected 
+  // people only get their position updated. A restarted tracker starts a new range of IDs, such
+  // that the people restored from a checkpoint are never confused with the tracks of another run
+  for(const anafi_uav_interfaces::msg::PersonTrack& track : person_tracks_msg->tracks)
   {
-    // Person previously detected
-    // Could easily support a change in severity
-    RCLCPP_INFO_THROTTLE(this->get_logger(), *this->get_clock(), 2000, "Person {%i} at position {%f, %f, %f} previously detected", idx, position.x, position.y, position.z);
-    return;
+    int idx = static_cast<int>(track.id);
+    std::map<int, std::tuple<geometry_msgs::msg::Point, Severity, bool>>::iterator it = detected_people_.find(idx);
+    if(it != detected_people_.end())
+    {
+      std::get<0>(it->second) = track.position;
+      continue;
+    }
+    add_detected_person_(idx, track.position, Severity(track.severity));
   }
+}
+
 
+void MissionControllerNode::add_detected_person_(int idx, const geometry_msgs::msg::Point& position, Severity severity)
+{
   std::string location = get_location_(position);
   if(location.empty())
   {
@@ -1324,17 +2954,20 @@ void MissionControllerNode::detected_person_cb_(anafi_uav_interfaces::msg::Detec
     return; // for now
   }
 
-  is_person_detected_ = true;
+  // People with minor severity only need to be communicated about, which can wait until the
+  // current plan is finished
+  bool deferrable = (severity == Severity::MINOR);
+  replan_scheduler_.request(ReplanTrigger::RESCUE, this->get_clock()->now().seconds(), deferrable);
   detected_people_[idx] = std::make_tuple(position, severity, false);
   
   std::string person_id = "p" + std::to_string(idx);
   
   RCLCPP_INFO(this->get_logger(), "Adding instance: " + person_id);
-  problem_expert_->addInstance(plansys2::Instance{person_id, "person"});
+  add_instance_(person_id, "person");
 
   std::string person_predicative_str = "(person_at " + person_id + " " +  location + ")";
   RCLCPP_INFO(this->get_logger(), "Adding predicative: " + person_predicative_str);
-  problem_expert_->addPredicate(plansys2::Predicate(person_predicative_str));
+  add_predicate_(person_predicative_str);
 
   // Predicatives that the person is not rescued, not marked and not communicated about
   // Using a switch to ensure that the predicates are set correctly. Notice the lack of breaks, 
@@ -1345,7 +2978,7 @@ void MissionControllerNode::detected_person_cb_(anafi_uav_interfaces::msg::Detec
     {
       std::string not_rescued_predicative_str = "(not_rescued " + person_id + + " " + location + ")";
       RCLCPP_INFO(this->get_logger(), "Adding predicative: " + not_rescued_predicative_str);
-      problem_expert_->addPredicate(plansys2::Predicate(not_rescued_predicative_str));
+      add_predicate_(not_rescued_predicative_str);
       mission_goals_.rescue_location_goal_strings_.push_back(not_rescued_predicative_str);
       [[fallthrough]];
     }
@@ -1353,7 +2986,7 @@ void MissionControllerNode::detected_person_cb_(anafi_uav_interfaces::msg::Detec
     {
       std::string not_marked_predicative_str = "(not_marked " + person_id + + " " + location + ")";
       RCLCPP_INFO(this->get_logger(), "Adding predicative: " + not_marked_predicative_str);
-      problem_expert_->addPredicate(plansys2::Predicate(not_marked_predicative_str));
+      add_predicate_(not_marked_predicative_str);
       mission_goals_.mark_location_goal_strings_.push_back(not_marked_predicative_str);
       [[fallthrough]];
     }
@@ -1361,12 +2994,12 @@ void MissionControllerNode::detected_person_cb_(anafi_uav_interfaces::msg::Detec
     {
       std::string not_communicated_predicative_str = "(not_communicated " + person_id + + " " + location + ")";
       RCLCPP_INFO(this->get_logger(), "Adding predicative: " + not_communicated_predicative_str);
-      problem_expert_->addPredicate(plansys2::Predicate(not_communicated_predicative_str));
+      add_predicate_(not_communicated_predicative_str);
       mission_goals_.communicate_location_goal_strings_.push_back(not_communicated_predicative_str);
 
       std::string not_tracked_predicate_str = "(not_tracked " + person_id + ")";
       RCLCPP_INFO(this->get_logger(), "Adding predicative: " + not_tracked_predicate_str);
-      problem_expert_->addPredicate(plansys2::Predicate(not_tracked_predicate_str));
+      add_predicate_(not_tracked_predicate_str);
       break;
     }
     default: 
@@ -1377,9 +3010,42 @@ void MissionControllerNode::detected_person_cb_(anafi_uav_interfaces::msg::Detec
 }
 
 
-void MissionControllerNode::emergency_occured_cb_(std_msgs::msg::Empty::ConstSharedPtr)
+void MissionControllerNode::emergency_occured_cb_(std_msgs::msg::Empty::ConstSharedPtr emergency_msg)
+{
+
+  replan_scheduler_.request(ReplanTrigger::EMERGENCY, this->get_clock()->now().seconds());
+}
+
+
+void MissionControllerNode::search_distance_cb_(std_msgs::msg::Float64::ConstSharedPtr search_distance_msg)
+{
+
+  RCLCPP_INFO(this->get_logger(), "Length of search pattern reported as %f m", search_distance_msg->data);
+  duration_model_->set_search_distance(search_distance_msg->data);
+
+  // The search durations already pushed depend on the distance, and would otherwise be used by
+  // the plans until the next replan rewrites them. Before init_planning_(), which is possible in
+  // the replay, the functions are pushed with the rest of the knowledge
+  if(! problem_expert_)
+  {
+    return;
+  }
+  for(const std::string& loc_str : this->get_parameter("locations.names").as_string_array())
+  {
+    add_function_("(= (search_distance " + loc_str + ") " + std::to_string(search_distance_msg->data) + ")");
+  }
+  if(! update_plansys2_duration_functions_())
+  {
+    RCLCPP_WARN(this->get_logger(), "Failed to update the search durations after the new search distance");
+  }
+}
+
+
+void MissionControllerNode::knowledge_cb_(plansys2_msgs::msg::Knowledge::ConstSharedPtr knowledge_msg)
 {
-  is_emergency_ = true;
+
+  // Also contains the effects applied by the executor, which are not written by the controller
+  knowledge_mirror_.synchronize(knowledge_msg->instances, knowledge_msg->predicates, knowledge_msg->functions, knowledge_msg->goal);
 }
 
 
@@ -1387,9 +3053,17 @@ void MissionControllerNode::set_num_markers_srv_cb_(
     const std::shared_ptr<anafi_uav_interfaces::srv::SetEquipmentNumbers::Request> request,
     std::shared_ptr<anafi_uav_interfaces::srv::SetEquipmentNumbers::Response> response)
 {
+  // The caller was already answered when the request was queued
+  if(request->num_equipment < 0)
+  {
+    RCLCPP_ERROR(this->get_logger(), "Ignoring the acknowledged request of %i markers", request->num_equipment);
+    response->success = false;
+    return;
+  }
+
   num_markers_ = request->num_equipment;
 
-  RCLCPP_INFO(this->get_logger(), "Current equipment:\nMarkers: %f \nLifevests: %f", num_markers_, num_lifevests_);
+  RCLCPP_INFO(this->get_logger(), "Current equipment:\nMarkers: %i \nLifevests: %i", num_markers_, num_lifevests_);
 
   response->success = true;
 } 
@@ -1399,9 +3073,17 @@ void MissionControllerNode::set_num_lifevests_srv_cb_(
     const std::shared_ptr<anafi_uav_interfaces::srv::SetEquipmentNumbers::Request> request,
     std::shared_ptr<anafi_uav_interfaces::srv::SetEquipmentNumbers::Response> response)
 {
+  // The caller was already answered when the request was queued
+  if(request->num_equipment < 0)
+  {
+    RCLCPP_ERROR(this->get_logger(), "Ignoring the acknowledged request of %i lifevests", request->num_equipment);
+    response->success = false;
+    return;
+  }
+
   num_lifevests_ = request->num_equipment;
 
-  RCLCPP_INFO(this->get_logger(), "Current equipment:\nMarkers: %f \nLifevests: %f", num_markers_, num_lifevests_);
+  RCLCPP_INFO(this->get_logger(), "Current equipment:\nMarkers: %i \nLifevests: %i", num_markers_, num_lifevests_);
 
   response->success = true;
 } 
@@ -1411,104 +3093,51 @@ void MissionControllerNode::set_finished_action_srv_cb_(
   const std::shared_ptr<anafi_uav_interfaces::srv::SetFinishedAction::Request> request,
   std::shared_ptr<anafi_uav_interfaces::srv::SetFinishedAction::Response>)
 {
-  std_msgs::msg::String action_name_msg = request->finished_action_name;
-  std_msgs::msg::String location_msg = request->location;
+
+  const std::string& action_name = request->finished_action_name.data;
+  const std::string& location = request->location.data;
   int num_arguments = request->num_arguments;
-  auto arguments = request->arguments;
+  std::string person = (num_arguments >= 1 && ! request->arguments.empty()) ? request->arguments[0].data : "";
 
-  std::string action_name = action_name_msg.data;
-  auto it = std::find(key_action_names_.begin(), key_action_names_.end(), action_name);
-  if(it == key_action_names_.end())
+  std::optional<ActionCompletion> completion = to_action_completion(action_name, location, person, location_names_);
+  if(! completion.has_value())
   {
-    RCLCPP_ERROR(this->get_logger(), "Current action-name not found {" + action_name + "} at location {" + location_msg.data + "} with number of arguments " + std::to_string(num_arguments));
+    RCLCPP_ERROR(this->get_logger(), "Ignoring the acknowledged finished action: Current action-name not found {" + action_name + "} at location {" + location + "} with number of arguments " + std::to_string(num_arguments));
     return;
   }
+  pending_action_completions_.push_back(completion.value());
 
-  std::string location = location_msg.data;  
-  std::string remove_str;
-
-  // Preferable with a (lambda-)function
-  // std::vector<std::string> vec;
-
-  // auto lambda_remove_str_from_vec = [&vec, &remove_str](auto) -> std::vector<std::string>
-  // { 
-  //   auto it = std::find(vec.begin(), vec.end(), remove_str);
-  //   if(it != vec.end())
-  //   {
-  //     vec.erase(it);
-  //   }
-  //   return vec;
-  // };
-
-  if(action_name.compare("search") == 0)
-  {
-    remove_str = "(searched " + location + ")";
+  // Empty response for SetFinishedAction
+}
 
-    auto it = std::find(mission_goals_.search_goal_strings_.begin(), mission_goals_.search_goal_strings_.end(), remove_str);
-    if(it != mission_goals_.search_goal_strings_.end())
-    {
-      mission_goals_.search_goal_strings_.erase(it);
-    }
-  }
-  else if(action_name.compare("communicate") == 0 && num_arguments >= 1)
-  {
-    std::string person = arguments[0].data;
-    remove_str = "(not_communicated " + person + + " " + location + ")";
 
-    auto it = std::find(mission_goals_.communicate_location_goal_strings_.begin(), mission_goals_.communicate_location_goal_strings_.end(), remove_str);
-    if(it != mission_goals_.communicate_location_goal_strings_.end())
-    {
-      mission_goals_.communicate_location_goal_strings_.erase(it);
-    }
-  }
-  else if(action_name.compare("mark") == 0 && num_arguments >= 1)
-  {
-    std::string person = arguments[0].data;
-    remove_str = "(not_marked " + person + + " " + location + ")";
+void MissionControllerNode::action_completion_cb_(anafi_uav_interfaces::msg::ActionCompletion::ConstSharedPtr completion_msg)
+{
 
-    auto it = std::find(mission_goals_.mark_location_goal_strings_.begin(), mission_goals_.mark_location_goal_strings_.end(), remove_str);
-    if(it != mission_goals_.mark_location_goal_strings_.end())
-    {
-      mission_goals_.mark_location_goal_strings_.erase(it);
-    }
-  }
-  else if(action_name.compare("rescue") == 0 && num_arguments >= 1)
+  // A completion of an interrupted run is already in the checkpoint, if it was applied at all
+  if(rclcpp::Time(completion_msg->stamp).seconds() < min_action_completion_time_s_)
   {
-    std::string person = arguments[0].data;
-    remove_str = "(not_rescued " + person + + " " + location + ")";
-
-    auto it = std::find(mission_goals_.rescue_location_goal_strings_.begin(), mission_goals_.rescue_location_goal_strings_.end(), remove_str);
-    if(it != mission_goals_.rescue_location_goal_strings_.end())
-    {
-      mission_goals_.rescue_location_goal_strings_.erase(it);
-    }
+    RCLCPP_INFO(this->get_logger(), "Ignoring a completed action from before the checkpoint");
+    return;
   }
-  RCLCPP_INFO(this->get_logger(), "Received string to remove: " + remove_str);
-
-  // Empty response for SetFinishedAction
+  pending_action_completions_.push_back(to_action_completion(*completion_msg));
 }
 
 
-int main(int argc, char ** argv)
+void MissionControllerNode::apply_action_completions_()
 {
-  rclcpp::init(argc, argv);
-  auto node = std::make_shared<MissionControllerNode>();
-
-  node->init();
-
-  rclcpp::Rate rate(10);
-  try
+  if(pending_action_completions_.empty())
   {
-    while (rclcpp::ok()) 
-    {
-      node->step();
-      rclcpp::spin_some(node->get_node_base_interface());
-      rate.sleep();
-    }
+    return;
   }
-  catch(...){}
 
-  rclcpp::shutdown();
+  size_t num_removed_goals = 0;
+  num_removed_goals += remove_completed_goals(pending_action_completions_, location_names_, mission_goals_.search_goal_strings_);
+  num_removed_goals += remove_completed_goals(pending_action_completions_, location_names_, mission_goals_.communicate_location_goal_strings_);
+  num_removed_goals += remove_completed_goals(pending_action_completions_, location_names_, mission_goals_.mark_location_goal_strings_);
+  num_removed_goals += remove_completed_goals(pending_action_completions_, location_names_, mission_goals_.rescue_location_goal_strings_);
+
+  RCLCPP_INFO(this->get_logger(), "Applied %zu completed actions, removing %zu goals", pending_action_completions_.size(), num_removed_goals);
 
-  return 0;
+  pending_action_completions_.clear();
 }
@@ -0,0 +1,20 @@
+#include "automated_planning/mission_controller.hpp"
+
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  auto node = std::make_shared<MissionControllerNode>();
+
+  node->init();
+  node->start();
+
+  // One thread for each callback group, and one for the reentrant telemetry
+  rclcpp::executors::MultiThreadedExecutor executor(rclcpp::ExecutorOptions(), 4);
+  executor.add_node(node);
+  executor.spin();
+
+  rclcpp::shutdown();
+
+  return 0;
+}
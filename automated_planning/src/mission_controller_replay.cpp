@@ -0,0 +1,196 @@
+#include "automated_planning/mission_controller_replay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+
+void MissionControllerReplay::run(bool real_time)
+{
+  TelemetryRecord record;
+  bool is_first_record = true;
+  int64_t first_stamp_ns = 0;
+  std::chrono::steady_clock::time_point wall_start_time = std::chrono::steady_clock::now();
+
+  while(rclcpp::ok() && reader_.next(record))
+  {
+    if(is_first_record)
+    {
+      first_stamp_ns = record.stamp_ns;
+      is_first_record = false;
+    }
+    if(real_time)
+    {
+      std::this_thread::sleep_until(wall_start_time + std::chrono::nanoseconds(record.stamp_ns - first_stamp_ns));
+    }
+
+    rcl_set_ros_time_override(node_->get_clock()->get_clock_handle(), record.stamp_ns);
+    dispatch_(record);
+    num_records_++;
+  }
+}
+
+
+std::string MissionControllerReplay::get_summary() const
+{
+  std::vector<double> durations = step_durations_s_;
+  std::sort(durations.begin(), durations.end());
+
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  ss << "Replayed " << num_records_ << " records with " << durations.size() << " steps";
+  if(! durations.empty())
+  {
+    double sum = 0;
+    for(double duration : durations)
+    {
+      sum += duration;
+    }
+    auto percentile = [&durations](double p)
+    {
+      return durations[std::min(durations.size() - 1, static_cast<size_t>(p * durations.size()))];
+    };
+    ss << "\nStep duration [ms]: mean " << 1e3 * sum / durations.size()
+      << ", p50 " << 1e3 * percentile(0.5)
+      << ", p95 " << 1e3 * percentile(0.95)
+      << ", max " << 1e3 * durations.back();
+  }
+  return ss.str();
+}
+
+
+void MissionControllerReplay::dispatch_(const TelemetryRecord& record)
+{
+  using SetEquipmentNumbers = anafi_uav_interfaces::srv::SetEquipmentNumbers;
+  using SetFinishedAction = anafi_uav_interfaces::srv::SetFinishedAction;
+
+  switch(static_cast<MissionControllerChannel>(record.channel))
+  {
+    case MissionControllerChannel::PRECONDITIONS_CHECK:
+    {
+      // The recorded controller kept checking until the preconditions were satisfied
+      node_->apply_pending_inputs_(MissionControllerChannel::PRECONDITIONS_CHECK);
+      if(! is_initialized_ && node_->are_controller_preconditions_satisfied_())
+      {
+        RCLCPP_INFO(node_->get_logger(), "Preconditions checked!");
+        node_->init_planning_();
+        is_initialized_ = true;
+      }
+      break;
+    }
+    case MissionControllerChannel::STEP:
+    {
+      if(! is_initialized_)
+      {
+        RCLCPP_WARN(node_->get_logger(), "Step recorded before the preconditions were satisfied. Skipping");
+        break;
+      }
+      std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+      node_->apply_pending_inputs_(MissionControllerChannel::STEP);
+      node_->step();
+      step_durations_s_.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count());
+      break;
+    }
+    case MissionControllerChannel::ANAFI_STATE:
+      defer_<std_msgs::msg::String>(record, &MissionControllerNode::anafi_state_cb_);
+      break;
+    case MissionControllerChannel::BATTERY:
+      defer_<std_msgs::msg::Float64>(record, &MissionControllerNode::battery_charge_cb_);
+      break;
+    case MissionControllerChannel::GNSS:
+      defer_<sensor_msgs::msg::NavSatFix>(record, &MissionControllerNode::gnss_data_cb_);
+      break;
+    case MissionControllerChannel::ATTITUDE:
+      defer_<geometry_msgs::msg::QuaternionStamped>(record, &MissionControllerNode::attitude_cb_);
+      break;
+    case MissionControllerChannel::POLLED_VELOCITY:
+      defer_<geometry_msgs::msg::TwistStamped>(record, &MissionControllerNode::polled_vel_cb_);
+      break;
+    case MissionControllerChannel::NED_POSITION:
+      defer_<geometry_msgs::msg::PointStamped>(record, &MissionControllerNode::ned_pos_cb_);
+      break;
+    case MissionControllerChannel::PERSON_TRACKS:
+      defer_<anafi_uav_interfaces::msg::PersonTrackArray>(record, &MissionControllerNode::person_tracks_cb_);
+      break;
+    case MissionControllerChannel::EMERGENCY:
+      defer_<std_msgs::msg::Empty>(record, &MissionControllerNode::emergency_occured_cb_);
+      break;
+    case MissionControllerChannel::SEARCH_DISTANCE:
+      defer_<std_msgs::msg::Float64>(record, &MissionControllerNode::search_distance_cb_);
+      break;
+    case MissionControllerChannel::KNOWLEDGE:
+      defer_<plansys2_msgs::msg::Knowledge>(record, &MissionControllerNode::knowledge_cb_);
+      break;
+    case MissionControllerChannel::ACTION_COMPLETION:
+      defer_<anafi_uav_interfaces::msg::ActionCompletion>(record, &MissionControllerNode::action_completion_cb_);
+      break;
+    case MissionControllerChannel::NUM_MARKERS:
+    {
+      std::shared_ptr<SetEquipmentNumbers::Request> request = deserialize_<SetEquipmentNumbers::Request>(record);
+      node_->defer_input_([this, request]() { node_->set_num_markers_srv_cb_(request, std::make_shared<SetEquipmentNumbers::Response>()); });
+      break;
+    }
+    case MissionControllerChannel::NUM_LIFEVESTS:
+    {
+      std::shared_ptr<SetEquipmentNumbers::Request> request = deserialize_<SetEquipmentNumbers::Request>(record);
+      node_->defer_input_([this, request]() { node_->set_num_lifevests_srv_cb_(request, std::make_shared<SetEquipmentNumbers::Response>()); });
+      break;
+    }
+    case MissionControllerChannel::FINISHED_ACTION:
+    {
+      std::shared_ptr<SetFinishedAction::Request> request = deserialize_<SetFinishedAction::Request>(record);
+      node_->defer_input_([this, request]() { node_->set_finished_action_srv_cb_(request, std::make_shared<SetFinishedAction::Response>()); });
+      break;
+    }
+    default:
+      RCLCPP_WARN(node_->get_logger(), "Unknown telemetry channel %u. Skipping", record.channel);
+      break;
+  }
+}
+
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+
+  // Usage: mission_controller_replay <log> [--real-time] --ros-args --params-file ...
+  std::vector<std::string> args = rclcpp::remove_ros_arguments(argc, argv);
+  std::string log_path;
+  bool real_time = false;
+  for(size_t i = 1; i < args.size(); i++)
+  {
+    if(args[i] == "--real-time")
+    {
+      real_time = true;
+    }
+    else
+    {
+      log_path = args[i];
+    }
+  }
+  if(log_path.empty())
+  {
+    std::cerr << "Usage: mission_controller_replay <log> [--real-time] --ros-args --params-file <mission_parameters> --params-file <config>" << std::endl;
+    rclcpp::shutdown();
+    return 1;
+  }
+
+  auto node = std::make_shared<MissionControllerNode>();
+  MissionControllerReplay replay(node, log_path);
+  try
+  {
+    replay.run(real_time);
+  }
+  catch(const std::exception& e)
+  {
+    RCLCPP_ERROR(node->get_logger(), "Replay stopped: %s", e.what());
+  }
+  RCLCPP_INFO(node->get_logger(), replay.get_summary());
+
+  rclcpp::shutdown();
+
+  return 0;
+}
@@ -1,8 +1,17 @@
 #include "automated_planning/move_action_node.hpp"
 
+LifecycleNodeInterface::CallbackReturn
+MoveActionNode::on_configure(const rclcpp_lifecycle::State & previous_state)
+{
+  activation_monitor_->start();
+  return AdaptiveActionExecutorClient::on_configure(previous_state);
+}
+
+
 LifecycleNodeInterface::CallbackReturn
 MoveActionNode::on_activate(const rclcpp_lifecycle::State & previous_state)
 {
+  ActionActivationMonitor::ActivationScope activation(*activation_monitor_);
   RCLCPP_INFO(this->get_logger(), "Trying to activate move");
 
   // Get the goal
@@ -30,8 +39,9 @@ MoveActionNode::on_activate(const rclcpp_lifecycle::State & previous_state)
 
   // Stupid variable to get things to work
   RCLCPP_INFO(this->get_logger(), "Activating move-action");
+  activation_.emplace();
   
-  return ActionExecutorClient::on_activate(previous_state);
+  return activation.succeeded(AdaptiveActionExecutorClient::on_activate(previous_state));
 }
 
 
@@ -40,13 +50,14 @@ MoveActionNode::on_deactivate(const rclcpp_lifecycle::State & state)
 {
   RCLCPP_INFO(this->get_logger(), "Deactivating move-action");
   hover_();
+  activation_.reset();
 
   // Deactivate publishers
   cmd_move_by_pub_->on_deactivate();
   cmd_move_to_pub_->on_deactivate();
   desired_ned_pos_pub_->on_deactivate();
 
-  return ActionExecutorClient::on_deactivate(state);
+  return AdaptiveActionExecutorClient::on_deactivate(state);
 }
 
 
@@ -55,37 +66,39 @@ void MoveActionNode::do_work()
 {
   // This is where the fun begins...
   // Good luck!
-
-  // Checking the preconditions to prevent race-conditions during activation 
-  static bool preconditions_success = false;
-  static int num_preconditions_failed = 0;
-  const int max_preconditions_failed = 5;
-
-  if(! preconditions_success)
+  if(! activation_.has_value())
   {
-    // Checking inside of the if-loop to prevent checking the preconditions
-    // for every iteration after it has first passed
-    preconditions_success = check_move_preconditions_(); 
-    num_preconditions_failed++;
-    if(num_preconditions_failed >= max_preconditions_failed)
-    {
-      num_preconditions_failed = 0;
-      preconditions_success = false;
-
-      RCLCPP_ERROR(this->get_logger(), "Preconditions for move failed!");
-      finish(false, 0.0, "Preconditions for move failed!");
-    }
     return;
   }
-  num_preconditions_failed = 0;
+
+  // Note that finish() deactivates the node, which destroys the activation. Return immediately
+  // after finishing
+  MoveActivation& activation = activation_.value();
 
   // The drone will transition using hovering, to ensure that the move-commands are 
   // valid. Problems were encountered if the move-commands were assigned when the 
   // drone was flying, as move commands were entered with respect to a non-zero 
   // roll / pitch
   // Difficult to get this in a readable format
-  switch (move_state_)
+  switch (activation.state)
   {
+    case MoveState::PRECONDITIONS:
+    {
+      // Checking the preconditions to prevent race-conditions during activation 
+      AwaitStatus preconditions = activation.preconditions.await(check_move_preconditions_(), get_tick_interval_s_());
+      if(preconditions == AwaitStatus::TIMED_OUT)
+      {
+        RCLCPP_ERROR(this->get_logger(), "Preconditions for move failed!");
+        finish(false, 0.0, "Preconditions for move failed!");
+        return;
+      }
+      if(preconditions == AwaitStatus::READY)
+      {
+        activation.state = MoveState::HOVER;
+      }
+      break;
+    }
+
     case MoveState::HOVER:
     {
       if(! check_hovering_())
@@ -99,7 +112,7 @@ void MoveActionNode::do_work()
       {
         // Target not achieved
         RCLCPP_WARN(this->get_logger(), "Hovering while not achieved goal position...");
-        move_state_ = MoveState::MOVE;
+        activation.state = MoveState::MOVE;
         return;
       }
 
@@ -123,7 +136,7 @@ void MoveActionNode::do_work()
       if(goal_achieved)
       {
         RCLCPP_INFO(this->get_logger(), "Goal achieved during move");
-        move_state_ = MoveState::HOVER;
+        activation.state = MoveState::HOVER;
       }
       else if(hovering)
       {
@@ -137,13 +150,8 @@ void MoveActionNode::do_work()
           return;
         }
 
-        // Using a counter to ensure that commands are not sent frequenctly
-        // and to ensure that the drone must be hovering for some time before 
-        // a new move-command is transmitted
-        static int start_move_counter = 0;
-        const int max_start_move_counter = 10;
-        
-        if(start_move_counter >= max_start_move_counter)
+        // Measuring the time spent hovering to ensure that commands are not sent frequenctly
+        if(activation.move_command.await(get_tick_interval_s_()))
         {
           float dx = -static_cast<float>(pos_error_body.x());
           float dy = -static_cast<float>(pos_error_body.y());
@@ -152,11 +160,6 @@ void MoveActionNode::do_work()
           RCLCPP_WARN(this->get_logger(), "Move ordered: x = %f, y = %f, z = %f", dx, dy, dz);
 
           pub_moveby_cmd(dx, dy, dz);
-          start_move_counter = 0;
-        }
-        else 
-        {
-          start_move_counter++;
         }
       }
       send_feedback(1.0 - distance / start_distance_, "Moving");
@@ -276,6 +279,7 @@ void MoveActionNode::anafi_state_cb_(std_msgs::msg::String::ConstSharedPtr state
     return;
   }
   anafi_state_ = state;
+  wake_();
 }
 
 
@@ -291,6 +295,7 @@ void MoveActionNode::ned_pos_cb_(geometry_msgs::msg::PointStamped::ConstSharedPt
   // Assume that the message is more recent for now... (bad assumption)
   position_ned_.header.stamp = ned_pos_msg->header.stamp;
   position_ned_.point = ned_pos_msg->point;
+  wake_();
 }
 
 
@@ -0,0 +1,863 @@
+#include "automated_planning/native_planner.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+
+
+namespace
+{
+  // Separation between dependent actions, as in the plans of POPF
+  const double ACTION_SEPARATION_S = 0.001;
+  const size_t MAX_NUMERIC_EFFECTS = 8;
+
+
+  bool has_fact(const std::vector<uint64_t>& facts, uint32_t fact)
+  {
+    return (facts[fact >> 6] >> (fact & 63)) & 1;
+  }
+
+
+  void set_fact(std::vector<uint64_t>& facts, uint32_t fact)
+  {
+    facts[fact >> 6] |= uint64_t(1) << (fact & 63);
+  }
+
+
+  void clear_fact(std::vector<uint64_t>& facts, uint32_t fact)
+  {
+    facts[fact >> 6] &= ~(uint64_t(1) << (fact & 63));
+  }
+
+
+  bool holds_all(const std::vector<uint64_t>& facts, const std::vector<uint32_t>& positive)
+  {
+    return std::all_of(positive.begin(), positive.end(), [&facts](uint32_t fact){ return has_fact(facts, fact); });
+  }
+
+
+  bool holds_any(const std::vector<uint64_t>& facts, const std::vector<uint32_t>& negative)
+  {
+    return std::any_of(negative.begin(), negative.end(), [&facts](uint32_t fact){ return has_fact(facts, fact); });
+  }
+
+
+  // The values of the search states are NaN when undefined
+  struct DefinedValues
+  {
+    const std::vector<double>& values;
+    bool operator[](size_t slot) const { return ! std::isnan(values[slot]); }
+  };
+
+
+  void append_unique(std::vector<uint32_t>& facts, const std::vector<uint32_t>& new_facts)
+  {
+    for(uint32_t fact : new_facts)
+    {
+      if(std::find(facts.begin(), facts.end(), fact) == facts.end())
+      {
+        facts.push_back(fact);
+      }
+    }
+  }
+
+
+  double elapsed_s(std::chrono::steady_clock::time_point start_time)
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+  }
+}
+
+
+std::string NativePlannerStatistics::to_string() const
+{
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(1);
+  ss << "Grounding " << (is_grounding_reused ? "reused" : "computed") << " in " << 1e3 * grounding_duration_s << " ms: "
+    << num_ground_actions << " ground actions (" << num_reachable_actions << " reachable), " << num_facts << " facts. "
+    << "Search in " << 1e3 * search_duration_s << " ms: "
+    << num_expanded << " expanded, " << num_generated << " generated, initial heuristic "
+    << (initial_heuristic ? std::to_string(initial_heuristic.value()) : "unreachable")
+    << (is_solved_by_hill_climbing ? ", solved by hill-climbing" : "");
+  if(num_soft_goals > 0)
+  {
+    ss << ". Soft goals: " << num_achieved_soft_goals << "/" << num_soft_goals << " achieved ("
+      << num_reachable_soft_goals << " reachable), utility " << achieved_utility;
+  }
+  return ss.str();
+}
+
+
+NativePlanner::NativePlanner(std::shared_ptr<const PddlDomain> domain, size_t max_expansions, double timeout_s)
+: domain_(domain)
+, max_expansions_(max_expansions)
+, timeout_s_(timeout_s)
+{
+  for(const DurativeAction& action : domain_->get_actions())
+  {
+    for(const std::vector<PddlEffect>* effects : { &action.at_start_effects, &action.at_end_effects })
+    {
+      for(const PddlEffect& effect : *effects)
+      {
+        fluent_names_.insert(effect.atom.name);
+      }
+    }
+  }
+}
+
+
+std::optional<std::vector<PlannedAction>> NativePlanner::solve(const PddlProblem& problem)
+{
+  return solve(problem, {});
+}
+
+
+std::optional<std::vector<PlannedAction>> NativePlanner::solve(const PddlProblem& problem, const std::vector<SoftGoal>& soft_goals)
+{
+  statistics_ = NativePlannerStatistics();
+  statistics_.num_soft_goals = soft_goals.size();
+  achieved_soft_goals_.assign(soft_goals.size(), false);
+  std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+  // The grounding depends on the objects and the static predicates only
+  std::vector<std::string> key_parts;
+  for(const std::pair<std::string, std::string>& object : problem.objects)
+  {
+    key_parts.push_back(object.first + " - " + object.second);
+  }
+  for(const PddlAtom& predicate : problem.predicates)
+  {
+    if(! fluent_names_.count(predicate.name))
+    {
+      key_parts.push_back(predicate.to_string());
+    }
+  }
+  std::sort(key_parts.begin(), key_parts.end());
+  std::string grounding_key;
+  for(const std::string& key_part : key_parts)
+  {
+    grounding_key += key_part + "\n";
+  }
+
+  statistics_.is_grounding_reused = (grounding_key == grounding_key_ && ! ground_actions_.empty());
+  if(! statistics_.is_grounding_reused)
+  {
+    grounding_key_.clear();
+    ground_(problem);
+    grounding_key_ = grounding_key;
+  }
+  bool is_goal_defined = compile_problem_(problem, soft_goals);
+  statistics_.grounding_duration_s = elapsed_s(start_time);
+  statistics_.num_ground_actions = ground_actions_.size();
+  statistics_.num_facts = fact_indices_.size();
+  if(! is_goal_defined)
+  {
+    return std::nullopt;
+  }
+
+  // Initial state
+  search_start_time_ = std::chrono::steady_clock::now();
+  std::vector<SearchNode> nodes;
+  nodes.push_back(SearchNode());
+  SearchNode& initial_node = nodes.back();
+  initial_node.facts.assign((fact_indices_.size() + 63) / 64, 0);
+  initial_node.values.assign(function_slots_.size(), std::numeric_limits<double>::quiet_NaN());
+  initial_node.parent = 0;
+  initial_node.action = 0;
+  initial_node.duration_s = 0.0;
+  initial_node.time_s = 0.0;
+  for(const PddlAtom& predicate : problem.predicates)
+  {
+    std::unordered_map<std::string, uint32_t>::const_iterator it = fact_indices_.find(predicate.to_string());
+    if(it != fact_indices_.end())
+    {
+      set_fact(initial_node.facts, it->second);
+    }
+  }
+  for(const std::pair<PddlAtom, double>& function : problem.functions)
+  {
+    std::unordered_map<std::string, uint32_t>::const_iterator it = function_slots_.find(function.first.to_string());
+    if(it != function_slots_.end())
+    {
+      initial_node.values[it->second] = function.second;
+    }
+  }
+
+  uint32_t initial_heuristic = compute_heuristic_(initial_node.facts);
+  if(initial_heuristic != UNREACHED)
+  {
+    statistics_.initial_heuristic = initial_heuristic;
+  }
+  statistics_.num_reachable_actions = std::count_if(remaining_preconditions_.begin(), remaining_preconditions_.end(),
+    [](uint32_t remaining){ return remaining == 0; });
+  statistics_.num_reachable_soft_goals = std::count_if(soft_goal_facts_.begin(), soft_goal_facts_.end(),
+    [this](uint32_t fact){ return fact_layers_[fact] != UNREACHED; });
+  if(initial_heuristic == UNREACHED)
+  {
+    statistics_.search_duration_s = elapsed_s(search_start_time_);
+    return std::nullopt;
+  }
+
+  std::optional<size_t> goal_idx;
+  if(! soft_goal_facts_.empty())
+  {
+    goal_idx = enforced_hill_climbing_with_soft_goals_(nodes);
+  }
+  else if(is_goal_(nodes.front()))
+  {
+    goal_idx = 0;
+  }
+  else
+  {
+    // As FF: enforced hill-climbing, and best-first search if it gets stuck on a plateau or in a
+    // dead end, such as running out of battery
+    goal_idx = enforced_hill_climbing_(nodes, initial_heuristic);
+    statistics_.is_solved_by_hill_climbing = goal_idx.has_value();
+    if(! goal_idx.has_value() && ! is_limit_reached_())
+    {
+      goal_idx = greedy_best_first_search_(nodes, initial_heuristic);
+    }
+  }
+  statistics_.search_duration_s = elapsed_s(search_start_time_);
+  if(! goal_idx.has_value())
+  {
+    return std::nullopt;
+  }
+
+  for(size_t i = 0; i < soft_goal_facts_.size(); i++)
+  {
+    achieved_soft_goals_[i] = has_fact(nodes[goal_idx.value()].facts, soft_goal_facts_[i]);
+    statistics_.achieved_utility += achieved_soft_goals_[i] ? soft_goal_utilities_[i] : 0.0;
+  }
+  statistics_.num_achieved_soft_goals = std::count(achieved_soft_goals_.begin(), achieved_soft_goals_.end(), true);
+  return extract_plan_(nodes, goal_idx.value());
+}
+
+
+size_t NativePlanner::NodeHash::operator()(size_t idx) const
+{
+  const SearchNode& node = (*nodes)[idx];
+  size_t hash = 0;
+  for(uint64_t word : node.facts)
+  {
+    hash ^= std::hash<uint64_t>()(word) + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+  }
+  for(size_t i = 0; i < node.values.size() && ! is_values_ignored; i++)
+  {
+    const double value = node.values[i];
+    // Rounded, such that the numeric noise of different orders of the same actions is ignored
+    int64_t rounded_value = std::isnan(value) ? INT64_MIN : static_cast<int64_t>(std::llround(value * 1e6));
+    hash ^= std::hash<int64_t>()(rounded_value) + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+
+bool NativePlanner::NodeEqual::operator()(size_t a, size_t b) const
+{
+  const SearchNode& node_a = (*nodes)[a];
+  const SearchNode& node_b = (*nodes)[b];
+  if(node_a.facts != node_b.facts)
+  {
+    return false;
+  }
+  for(size_t i = 0; i < node_a.values.size() && ! is_values_ignored; i++)
+  {
+    const double value_a = node_a.values[i];
+    const double value_b = node_b.values[i];
+    if(std::isnan(value_a) != std::isnan(value_b)
+      || (! std::isnan(value_a) && std::llround(value_a * 1e6) != std::llround(value_b * 1e6)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+void NativePlanner::ground_(const PddlProblem& problem)
+{
+  ground_actions_.clear();
+  fact_indices_.clear();
+  function_slots_.clear();
+
+  domain_->ground_actions(problem, [this](DurativeAction&& action)
+  {
+    GroundAction ground_action;
+    auto add_conditions = [this](const std::vector<PddlCondition>& conditions, std::vector<uint32_t>& positive, std::vector<uint32_t>& negative)
+    {
+      for(const PddlCondition& condition : conditions)
+      {
+        if(condition.type == PddlCondition::Type::COMPARISON || ! fluent_names_.count(condition.predicate.name))
+        {
+          continue;
+        }
+        std::vector<uint32_t>& facts = (condition.type == PddlCondition::Type::PREDICATE) ? positive : negative;
+        append_unique(facts, { get_fact_(condition.predicate) });
+      }
+    };
+    auto add_effects = [this](const std::vector<PddlEffect>& effects, std::vector<uint32_t>& add, std::vector<uint32_t>& del)
+    {
+      for(const PddlEffect& effect : effects)
+      {
+        if(effect.type == PddlEffect::Type::ADD)
+        {
+          append_unique(add, { get_fact_(effect.atom) });
+        }
+        else if(effect.type == PddlEffect::Type::DELETE)
+        {
+          append_unique(del, { get_fact_(effect.atom) });
+        }
+      }
+    };
+    add_conditions(action.at_start_conditions, ground_action.start_positive, ground_action.start_negative);
+    add_conditions(action.over_all_conditions, ground_action.later_positive, ground_action.later_negative);
+    add_conditions(action.at_end_conditions, ground_action.later_positive, ground_action.later_negative);
+    add_effects(action.at_start_effects, ground_action.start_add, ground_action.start_delete);
+    add_effects(action.at_end_effects, ground_action.end_add, ground_action.end_delete);
+
+    // The later conditions achieved by the start effects are not preconditions in the relaxed problem
+    ground_action.relaxed_preconditions = ground_action.start_positive;
+    for(uint32_t fact : ground_action.later_positive)
+    {
+      if(std::find(ground_action.start_add.begin(), ground_action.start_add.end(), fact) == ground_action.start_add.end())
+      {
+        append_unique(ground_action.relaxed_preconditions, { fact });
+      }
+    }
+    ground_action.relaxed_effects = ground_action.start_add;
+    append_unique(ground_action.relaxed_effects, ground_action.end_add);
+
+    ground_action.action = std::move(action);
+    ground_actions_.push_back(std::move(ground_action));
+  });
+}
+
+
+bool NativePlanner::compile_problem_(const PddlProblem& problem, const std::vector<SoftGoal>& soft_goals)
+{
+  std::unordered_map<std::string, double> static_values;
+  for(const std::pair<PddlAtom, double>& function : problem.functions)
+  {
+    if(! fluent_names_.count(function.first.name))
+    {
+      static_values[function.first.to_string()] = function.second;
+    }
+  }
+
+  bool is_defined = true;
+  auto resolve_function = [&](const PddlAtom& function)
+  {
+    const std::string function_str = function.to_string();
+    if(fluent_names_.count(function.name))
+    {
+      std::unordered_map<std::string, uint32_t>::const_iterator it = function_slots_.find(function_str);
+      if(it == function_slots_.end())
+      {
+        it = function_slots_.emplace(function_str, function_slots_.size()).first;
+      }
+      return NumericProgram::Instruction{ NumericProgram::OpCode::PUSH_FUNCTION, it->second, 0.0 };
+    }
+    std::unordered_map<std::string, double>::const_iterator it = static_values.find(function_str);
+    if(it == static_values.end())
+    {
+      is_defined = false;
+      return NumericProgram::Instruction{ NumericProgram::OpCode::PUSH_NUMBER, 0, 0.0 };
+    }
+    return NumericProgram::Instruction{ NumericProgram::OpCode::PUSH_NUMBER, 0, it->second };
+  };
+  auto compile_comparisons = [&](const std::vector<PddlCondition>& conditions, std::vector<Comparison>& comparisons)
+  {
+    for(const PddlCondition& condition : conditions)
+    {
+      if(condition.type == PddlCondition::Type::COMPARISON)
+      {
+        comparisons.push_back({ condition.comparator,
+          NumericProgram::compile(condition.lhs, resolve_function), NumericProgram::compile(condition.rhs, resolve_function) });
+      }
+    }
+  };
+  auto compile_effects = [&](const std::vector<PddlEffect>& effects, std::vector<NumericEffect>& numeric_effects)
+  {
+    for(const PddlEffect& effect : effects)
+    {
+      if(effect.type != PddlEffect::Type::ADD && effect.type != PddlEffect::Type::DELETE)
+      {
+        numeric_effects.push_back({ effect.type, resolve_function(effect.atom).slot, NumericProgram::compile(effect.value, resolve_function) });
+      }
+    }
+    if(numeric_effects.size() > MAX_NUMERIC_EFFECTS)
+    {
+      throw std::runtime_error("More than " + std::to_string(MAX_NUMERIC_EFFECTS) + " numeric effects at one point of an action");
+    }
+  };
+
+  for(GroundAction& ground_action : ground_actions_)
+  {
+    is_defined = true;
+    ground_action.start_comparisons.clear();
+    ground_action.later_comparisons.clear();
+    ground_action.start_effects.clear();
+    ground_action.end_effects.clear();
+
+    const DurativeAction& action = ground_action.action;
+    ground_action.duration = NumericProgram::compile(action.duration, resolve_function);
+    compile_comparisons(action.at_start_conditions, ground_action.start_comparisons);
+    compile_comparisons(action.over_all_conditions, ground_action.later_comparisons);
+    compile_comparisons(action.at_end_conditions, ground_action.later_comparisons);
+    compile_effects(action.at_start_effects, ground_action.start_effects);
+    compile_effects(action.at_end_effects, ground_action.end_effects);
+    ground_action.is_defined = is_defined;
+  }
+
+  // The goal may use facts which no action changes, which are then only given by the initial state
+  is_defined = true;
+  goal_positive_.clear();
+  goal_negative_.clear();
+  goal_comparisons_.clear();
+  for(const PddlCondition& goal : problem.goals)
+  {
+    if(goal.type == PddlCondition::Type::PREDICATE)
+    {
+      append_unique(goal_positive_, { get_fact_(goal.predicate) });
+    }
+    else if(goal.type == PddlCondition::Type::NEGATED_PREDICATE)
+    {
+      append_unique(goal_negative_, { get_fact_(goal.predicate) });
+    }
+  }
+  compile_comparisons(problem.goals, goal_comparisons_);
+  soft_goal_facts_.clear();
+  soft_goal_utilities_.clear();
+  for(const SoftGoal& soft_goal : soft_goals)
+  {
+    soft_goal_facts_.push_back(get_fact_(soft_goal.predicate));
+    soft_goal_utilities_.push_back(soft_goal.utility);
+  }
+
+  // Index of the relaxed problem
+  const size_t num_facts = fact_indices_.size();
+  precondition_of_.assign(num_facts, {});
+  actions_without_preconditions_.clear();
+  for(uint32_t action_idx = 0; action_idx < ground_actions_.size(); action_idx++)
+  {
+    const GroundAction& ground_action = ground_actions_[action_idx];
+    if(! ground_action.is_defined)
+    {
+      continue;
+    }
+    for(uint32_t fact : ground_action.relaxed_preconditions)
+    {
+      precondition_of_[fact].push_back(action_idx);
+    }
+    if(ground_action.relaxed_preconditions.empty())
+    {
+      actions_without_preconditions_.push_back(action_idx);
+    }
+  }
+  fact_layers_.resize(num_facts);
+  fact_supporters_.resize(num_facts);
+  remaining_preconditions_.resize(ground_actions_.size());
+  is_in_relaxed_plan_.resize(ground_actions_.size());
+  return is_defined;
+}
+
+
+std::optional<size_t> NativePlanner::enforced_hill_climbing_(std::vector<SearchNode>& nodes, uint32_t initial_heuristic)
+{
+  size_t current_idx = 0;
+  uint32_t current_heuristic = initial_heuristic;
+  while(true)
+  {
+    // Breadth-first from the current state, until a state with a lower heuristic is found
+    VisitedSet visited(1024, NodeHash{ &nodes, true }, NodeEqual{ &nodes, true });
+    visited.insert(current_idx);
+    std::deque<size_t> queue = { current_idx };
+    std::optional<size_t> better_idx;
+    bool is_goal = false;
+    while(! queue.empty() && ! better_idx.has_value())
+    {
+      if(is_limit_reached_())
+      {
+        return std::nullopt;
+      }
+      const size_t node_idx = queue.front();
+      queue.pop_front();
+      expand_(node_idx, nodes, visited, [&](size_t successor_idx)
+      {
+        if(is_goal_(nodes[successor_idx]))
+        {
+          better_idx = successor_idx;
+          is_goal = true;
+          return false;
+        }
+        uint32_t heuristic = compute_heuristic_(nodes[successor_idx].facts);
+        if(heuristic < current_heuristic)
+        {
+          better_idx = successor_idx;
+          current_heuristic = heuristic;
+          return false;
+        }
+        if(heuristic != UNREACHED)
+        {
+          queue.push_back(successor_idx);
+        }
+        return true;
+      });
+    }
+    if(! better_idx.has_value() || is_goal)
+    {
+      return better_idx;
+    }
+    current_idx = better_idx.value();
+  }
+}
+
+
+std::optional<size_t> NativePlanner::greedy_best_first_search_(std::vector<SearchNode>& nodes, uint32_t initial_heuristic)
+{
+  // Ordered by the heuristic and then by the makespan
+  using OpenEntry = std::tuple<uint32_t, double, size_t>;
+  std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open;
+  VisitedSet visited(1024, NodeHash{ &nodes, false }, NodeEqual{ &nodes, false });
+  visited.insert(0);
+  open.emplace(initial_heuristic, 0.0, 0);
+
+  std::optional<size_t> goal_idx;
+  while(! open.empty() && ! goal_idx.has_value() && ! is_limit_reached_())
+  {
+    const size_t node_idx = std::get<2>(open.top());
+    open.pop();
+    expand_(node_idx, nodes, visited, [&](size_t successor_idx)
+    {
+      if(is_goal_(nodes[successor_idx]))
+      {
+        goal_idx = successor_idx;
+        return false;
+      }
+      uint32_t heuristic = compute_heuristic_(nodes[successor_idx].facts);
+      if(heuristic != UNREACHED)
+      {
+        open.emplace(heuristic, nodes[successor_idx].time_s, successor_idx);
+      }
+      return true;
+    });
+  }
+  return goal_idx;
+}
+
+
+std::optional<size_t> NativePlanner::enforced_hill_climbing_with_soft_goals_(std::vector<SearchNode>& nodes)
+{
+  // Pursued in the order of their utility, such that the least valuable is dropped first
+  const std::vector<uint32_t> hard_goal_positive = goal_positive_;
+  std::vector<size_t> pursued_soft_goals;
+  for(size_t i = 0; i < soft_goal_facts_.size(); i++)
+  {
+    if(fact_layers_[soft_goal_facts_[i]] != UNREACHED)
+    {
+      pursued_soft_goals.push_back(i);
+    }
+  }
+  std::stable_sort(pursued_soft_goals.begin(), pursued_soft_goals.end(),
+    [this](size_t a, size_t b){ return soft_goal_utilities_[a] > soft_goal_utilities_[b]; });
+
+  std::optional<size_t> goal_idx;
+  while(! goal_idx.has_value() && ! is_limit_reached_())
+  {
+    goal_positive_ = hard_goal_positive;
+    for(size_t soft_goal : pursued_soft_goals)
+    {
+      append_unique(goal_positive_, { soft_goal_facts_[soft_goal] });
+    }
+    const uint32_t initial_heuristic = compute_heuristic_(nodes.front().facts);
+    goal_idx = is_goal_(nodes.front()) ? std::optional<size_t>(0) : enforced_hill_climbing_(nodes, initial_heuristic);
+    if(pursued_soft_goals.empty())
+    {
+      break;
+    }
+    pursued_soft_goals.pop_back();
+  }
+
+  // As without soft goals, best-first search if hill-climbing gets stuck for the hard goals only
+  goal_positive_ = hard_goal_positive;
+  statistics_.is_solved_by_hill_climbing = goal_idx.has_value();
+  if(! goal_idx.has_value() && ! is_limit_reached_())
+  {
+    goal_idx = greedy_best_first_search_(nodes, compute_heuristic_(nodes.front().facts));
+  }
+  return goal_idx;
+}
+
+
+void NativePlanner::expand_(size_t node_idx, std::vector<SearchNode>& nodes, VisitedSet& visited, const std::function<bool(size_t)>& on_successor)
+{
+  statistics_.num_expanded++;
+  for(uint32_t action_idx = 0; action_idx < ground_actions_.size(); action_idx++)
+  {
+    SearchNode successor;
+    if(! apply_(ground_actions_[action_idx], nodes[node_idx], successor))
+    {
+      continue;
+    }
+    successor.parent = node_idx;
+    successor.action = action_idx;
+    nodes.push_back(std::move(successor));
+    const size_t successor_idx = nodes.size() - 1;
+    if(! visited.insert(successor_idx).second)
+    {
+      nodes.pop_back();
+      continue;
+    }
+    statistics_.num_generated++;
+    if(! on_successor(successor_idx))
+    {
+      return;
+    }
+  }
+}
+
+
+bool NativePlanner::is_limit_reached_() const
+{
+  return statistics_.num_expanded >= max_expansions_ || elapsed_s(search_start_time_) > timeout_s_;
+}
+
+
+std::vector<PlannedAction> NativePlanner::extract_plan_(const std::vector<SearchNode>& nodes, size_t node_idx) const
+{
+  std::vector<size_t> path;
+  for(size_t idx = node_idx; idx != 0; idx = nodes[idx].parent)
+  {
+    path.push_back(idx);
+  }
+  std::reverse(path.begin(), path.end());
+
+  std::vector<PlannedAction> plan;
+  double time_s = 0.0;
+  for(size_t idx : path)
+  {
+    plan.push_back({ ground_actions_[nodes[idx].action].action.to_string(), time_s, nodes[idx].duration_s });
+    time_s += nodes[idx].duration_s + ACTION_SEPARATION_S;
+  }
+  return plan;
+}
+
+
+uint32_t NativePlanner::get_fact_(const PddlAtom& predicate)
+{
+  const std::string predicate_str = predicate.to_string();
+  std::unordered_map<std::string, uint32_t>::const_iterator it = fact_indices_.find(predicate_str);
+  if(it == fact_indices_.end())
+  {
+    it = fact_indices_.emplace(predicate_str, fact_indices_.size()).first;
+  }
+  return it->second;
+}
+
+
+bool NativePlanner::is_goal_(const SearchNode& node) const
+{
+  if(! holds_all(node.facts, goal_positive_) || holds_any(node.facts, goal_negative_))
+  {
+    return false;
+  }
+  DefinedValues is_defined{ node.values };
+  for(const Comparison& comparison : goal_comparisons_)
+  {
+    double lhs;
+    double rhs;
+    if(! comparison.lhs.evaluate(node.values, is_defined, 0.0, lhs) || ! comparison.rhs.evaluate(node.values, is_defined, 0.0, rhs)
+      || ! compare(comparison.comparator, lhs, rhs))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+bool NativePlanner::apply_(const GroundAction& action, const SearchNode& node, SearchNode& successor) const
+{
+  if(! action.is_defined || ! holds_all(node.facts, action.start_positive) || holds_any(node.facts, action.start_negative))
+  {
+    return false;
+  }
+
+  double duration_s;
+  if(! action.duration.evaluate(node.values, DefinedValues{ node.values }, 0.0, duration_s) || ! (duration_s >= 0.0))
+  {
+    return false;
+  }
+
+  auto is_satisfied = [duration_s](const std::vector<Comparison>& comparisons, const std::vector<double>& values)
+  {
+    DefinedValues is_defined{ values };
+    for(const Comparison& comparison : comparisons)
+    {
+      double lhs;
+      double rhs;
+      if(! comparison.lhs.evaluate(values, is_defined, duration_s, lhs) || ! comparison.rhs.evaluate(values, is_defined, duration_s, rhs)
+        || ! compare(comparison.comparator, lhs, rhs))
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+  // The numeric effects are evaluated in the state before the event
+  auto apply_effects = [duration_s](const std::vector<NumericEffect>& effects, std::vector<double>& values)
+  {
+    std::array<double, MAX_NUMERIC_EFFECTS> new_values;
+    DefinedValues is_defined{ values };
+    for(size_t i = 0; i < effects.size(); i++)
+    {
+      double value;
+      if(! effects[i].value.evaluate(values, is_defined, duration_s, value))
+      {
+        value = std::numeric_limits<double>::quiet_NaN();
+      }
+      if(effects[i].type == PddlEffect::Type::INCREASE)
+      {
+        value = values[effects[i].slot] + value;
+      }
+      else if(effects[i].type == PddlEffect::Type::DECREASE)
+      {
+        value = values[effects[i].slot] - value;
+      }
+      new_values[i] = value;
+    }
+    for(size_t i = 0; i < effects.size(); i++)
+    {
+      values[effects[i].slot] = new_values[i];
+    }
+  };
+
+  if(! is_satisfied(action.start_comparisons, node.values))
+  {
+    return false;
+  }
+
+  successor.facts = node.facts;
+  successor.values = node.values;
+  apply_effects(action.start_effects, successor.values);
+  for(uint32_t fact : action.start_delete)
+  {
+    clear_fact(successor.facts, fact);
+  }
+  for(uint32_t fact : action.start_add)
+  {
+    set_fact(successor.facts, fact);
+  }
+
+  if(! holds_all(successor.facts, action.later_positive) || holds_any(successor.facts, action.later_negative)
+    || ! is_satisfied(action.later_comparisons, successor.values))
+  {
+    return false;
+  }
+
+  apply_effects(action.end_effects, successor.values);
+  for(uint32_t fact : action.end_delete)
+  {
+    clear_fact(successor.facts, fact);
+  }
+  for(uint32_t fact : action.end_add)
+  {
+    set_fact(successor.facts, fact);
+  }
+
+  successor.duration_s = duration_s;
+  successor.time_s = node.time_s + duration_s;
+  return true;
+}
+
+
+uint32_t NativePlanner::compute_heuristic_(const std::vector<uint64_t>& facts)
+{
+  std::fill(fact_layers_.begin(), fact_layers_.end(), UNREACHED);
+  fact_queue_.clear();
+  for(uint32_t fact = 0; fact < fact_layers_.size(); fact++)
+  {
+    if(has_fact(facts, fact))
+    {
+      fact_layers_[fact] = 0;
+      fact_queue_.push_back(fact);
+    }
+  }
+  for(uint32_t action_idx = 0; action_idx < ground_actions_.size(); action_idx++)
+  {
+    // Actions with undefined functions are never counted down to zero
+    remaining_preconditions_[action_idx] = ground_actions_[action_idx].is_defined ? ground_actions_[action_idx].relaxed_preconditions.size() : UNREACHED;
+  }
+
+  // Breadth-first, such that the facts are reached in the order of their layers
+  auto apply_relaxed = [this](uint32_t action_idx, uint32_t layer)
+  {
+    for(uint32_t fact : ground_actions_[action_idx].relaxed_effects)
+    {
+      if(fact_layers_[fact] == UNREACHED)
+      {
+        fact_layers_[fact] = layer + 1;
+        fact_supporters_[fact] = action_idx;
+        fact_queue_.push_back(fact);
+      }
+    }
+  };
+  for(uint32_t action_idx : actions_without_preconditions_)
+  {
+    apply_relaxed(action_idx, 0);
+  }
+  for(size_t head = 0; head < fact_queue_.size(); head++)
+  {
+    const uint32_t fact = fact_queue_[head];
+    for(uint32_t action_idx : precondition_of_[fact])
+    {
+      if(--remaining_preconditions_[action_idx] == 0)
+      {
+        apply_relaxed(action_idx, fact_layers_[fact]);
+      }
+    }
+  }
+
+  for(uint32_t fact : goal_positive_)
+  {
+    if(fact_layers_[fact] == UNREACHED)
+    {
+      return UNREACHED;
+    }
+  }
+
+  // Relaxed plan, from the supporters of the goals. The layers of the handled facts are cleared
+  std::fill(is_in_relaxed_plan_.begin(), is_in_relaxed_plan_.end(), false);
+  std::vector<uint32_t> open_facts = goal_positive_;
+  uint32_t num_actions = 0;
+  while(! open_facts.empty())
+  {
+    const uint32_t fact = open_facts.back();
+    open_facts.pop_back();
+    if(fact_layers_[fact] == 0)
+    {
+      continue;
+    }
+    fact_layers_[fact] = 0;
+    const uint32_t action_idx = fact_supporters_[fact];
+    if(is_in_relaxed_plan_[action_idx])
+    {
+      continue;
+    }
+    is_in_relaxed_plan_[action_idx] = true;
+    num_actions++;
+    open_facts.insert(open_facts.end(),
+      ground_actions_[action_idx].relaxed_preconditions.begin(), ground_actions_[action_idx].relaxed_preconditions.end());
+  }
+  return num_actions;
+}
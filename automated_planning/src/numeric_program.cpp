@@ -0,0 +1,98 @@
+#include "automated_planning/numeric_program.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace
+{
+  double fold(NumericProgram::OpCode op, double lhs, double rhs)
+  {
+    switch(op)
+    {
+      case NumericProgram::OpCode::ADD:
+        return lhs + rhs;
+      case NumericProgram::OpCode::SUBTRACT:
+        return lhs - rhs;
+      case NumericProgram::OpCode::MULTIPLY:
+        return lhs * rhs;
+      default:
+        return lhs / rhs;
+    }
+  }
+
+
+  void append(
+    const NumericExpression& expression,
+    const std::function<NumericProgram::Instruction(const PddlAtom&)>& resolve_function,
+    NumericProgram& program,
+    size_t& stack_size,
+    size_t& max_stack_size)
+  {
+    using OpCode = NumericProgram::OpCode;
+    switch(expression.type)
+    {
+      case NumericExpression::Type::NUMBER:
+        program.instructions.push_back({ OpCode::PUSH_NUMBER, 0, expression.value });
+        break;
+      case NumericExpression::Type::FUNCTION:
+        program.instructions.push_back(resolve_function(expression.function));
+        break;
+      case NumericExpression::Type::DURATION:
+        program.instructions.push_back({ OpCode::PUSH_DURATION, 0, 0.0 });
+        break;
+      default:
+      {
+        append(expression.operands[0], resolve_function, program, stack_size, max_stack_size);
+        append(expression.operands[1], resolve_function, program, stack_size, max_stack_size);
+        // Two operands are replaced by the result
+        stack_size -= 2;
+
+        OpCode op = OpCode::ADD;
+        if(expression.type == NumericExpression::Type::SUBTRACT)
+        {
+          op = OpCode::SUBTRACT;
+        }
+        else if(expression.type == NumericExpression::Type::MULTIPLY)
+        {
+          op = OpCode::MULTIPLY;
+        }
+        else if(expression.type == NumericExpression::Type::DIVIDE)
+        {
+          op = OpCode::DIVIDE;
+        }
+
+        std::vector<NumericProgram::Instruction>& instructions = program.instructions;
+        const size_t size = instructions.size();
+        if(size >= 2 && instructions[size - 2].op == OpCode::PUSH_NUMBER && instructions[size - 1].op == OpCode::PUSH_NUMBER)
+        {
+          instructions[size - 2].value = fold(op, instructions[size - 2].value, instructions[size - 1].value);
+          instructions.pop_back();
+        }
+        else
+        {
+          instructions.push_back({ op, 0, 0.0 });
+        }
+        break;
+      }
+    }
+    stack_size++;
+    max_stack_size = std::max(max_stack_size, stack_size);
+  }
+}
+
+
+NumericProgram NumericProgram::compile(
+  const NumericExpression& expression,
+  const std::function<Instruction(const PddlAtom&)>& resolve_function)
+{
+  NumericProgram program;
+  size_t stack_size = 0;
+  size_t max_stack_size = 0;
+  append(expression, resolve_function, program, stack_size, max_stack_size);
+  if(max_stack_size > MAX_STACK_SIZE)
+  {
+    throw std::runtime_error("The expression " + expression.to_string() + " is too deeply nested");
+  }
+  return program;
+}
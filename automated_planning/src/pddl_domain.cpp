@@ -0,0 +1,934 @@
+#include "automated_planning/pddl_domain.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+
+namespace
+{
+  /**
+   * @brief A symbol, or a parenthesized list of s-expressions
+   */
+  struct SExpression
+  {
+    std::string symbol;
+    std::vector<SExpression> children;
+    bool is_list{ false };
+
+    bool is_symbol(const std::string& str) const { return ! is_list && symbol == str; }
+    std::string head() const { return (is_list && ! children.empty() && ! children[0].is_list) ? children[0].symbol : ""; }
+  };
+
+
+  /**
+   * @brief Splits the PDDL into parentheses and lowercase symbols, skipping comments
+   */
+  std::vector<std::string> tokenize(const std::string& str)
+  {
+    std::vector<std::string> tokens;
+    std::string token;
+    bool is_comment = false;
+    for(char c : str)
+    {
+      if(is_comment)
+      {
+        is_comment = (c != '\n');
+        continue;
+      }
+      if(c == ';' || c == '(' || c == ')' || std::isspace(static_cast<unsigned char>(c)))
+      {
+        if(! token.empty())
+        {
+          tokens.push_back(token);
+          token.clear();
+        }
+        if(c == '(' || c == ')')
+        {
+          tokens.push_back(std::string(1, c));
+        }
+        is_comment = (c == ';');
+        continue;
+      }
+      token.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+    if(! token.empty())
+    {
+      tokens.push_back(token);
+    }
+    return tokens;
+  }
+
+
+  SExpression parse_sexpression(const std::vector<std::string>& tokens, size_t& idx)
+  {
+    if(idx >= tokens.size())
+    {
+      throw std::runtime_error("Unexpected end of PDDL");
+    }
+    SExpression expression;
+    if(tokens[idx] == ")")
+    {
+      throw std::runtime_error("Unexpected ')' in PDDL");
+    }
+    if(tokens[idx] != "(")
+    {
+      expression.symbol = tokens[idx++];
+      return expression;
+    }
+
+    expression.is_list = true;
+    idx++;
+    while(idx < tokens.size() && tokens[idx] != ")")
+    {
+      expression.children.push_back(parse_sexpression(tokens, idx));
+    }
+    if(idx >= tokens.size())
+    {
+      throw std::runtime_error("Missing ')' in PDDL");
+    }
+    idx++;
+    return expression;
+  }
+
+
+  PddlAtom parse_atom(const SExpression& expression)
+  {
+    if(! expression.is_list || expression.head().empty())
+    {
+      throw std::runtime_error("Expected an atom in PDDL");
+    }
+    PddlAtom atom;
+    atom.name = expression.head();
+    for(size_t i = 1; i < expression.children.size(); i++)
+    {
+      if(expression.children[i].is_list)
+      {
+        throw std::runtime_error("Nested expression in the atom (" + atom.name + " ...)");
+      }
+      atom.arguments.push_back(expression.children[i].symbol);
+    }
+    return atom;
+  }
+
+
+  NumericExpression parse_numeric_expression(const SExpression& expression)
+  {
+    NumericExpression numeric_expression;
+    if(! expression.is_list)
+    {
+      if(expression.symbol == "?duration")
+      {
+        numeric_expression.type = NumericExpression::Type::DURATION;
+        return numeric_expression;
+      }
+      char* end = nullptr;
+      numeric_expression.value = std::strtod(expression.symbol.c_str(), &end);
+      if(end != expression.symbol.c_str() && *end == '\0')
+      {
+        numeric_expression.type = NumericExpression::Type::NUMBER;
+        return numeric_expression;
+      }
+      if(expression.symbol[0] == '?')
+      {
+        throw std::runtime_error("Parameter " + expression.symbol + " used as a number");
+      }
+      // Function without parameters
+      numeric_expression.type = NumericExpression::Type::FUNCTION;
+      numeric_expression.function.name = expression.symbol;
+      return numeric_expression;
+    }
+
+    const std::string head = expression.head();
+    if(head == "+" || head == "-" || head == "*" || head == "/")
+    {
+      if(expression.children.size() < 2 || expression.children.size() > 3)
+      {
+        throw std::runtime_error("Operator " + head + " requires one or two operands");
+      }
+      for(size_t i = 1; i < expression.children.size(); i++)
+      {
+        numeric_expression.operands.push_back(parse_numeric_expression(expression.children[i]));
+      }
+      if(head == "+")
+      {
+        numeric_expression.type = NumericExpression::Type::ADD;
+      }
+      else if(head == "-")
+      {
+        numeric_expression.type = NumericExpression::Type::SUBTRACT;
+        if(numeric_expression.operands.size() == 1)
+        {
+          // Unary minus, as 0 - x
+          numeric_expression.operands.insert(numeric_expression.operands.begin(), NumericExpression());
+        }
+      }
+      else if(head == "*")
+      {
+        numeric_expression.type = NumericExpression::Type::MULTIPLY;
+      }
+      else
+      {
+        numeric_expression.type = NumericExpression::Type::DIVIDE;
+      }
+      if(numeric_expression.operands.size() != 2)
+      {
+        throw std::runtime_error("Operator " + head + " requires two operands");
+      }
+      return numeric_expression;
+    }
+
+    numeric_expression.type = NumericExpression::Type::FUNCTION;
+    numeric_expression.function = parse_atom(expression);
+    return numeric_expression;
+  }
+
+
+  PddlCondition parse_condition(const SExpression& expression)
+  {
+    PddlCondition condition;
+    const std::string head = expression.head();
+    if(head == "not")
+    {
+      if(expression.children.size() != 2)
+      {
+        throw std::runtime_error("Malformed negated condition");
+      }
+      condition.type = PddlCondition::Type::NEGATED_PREDICATE;
+      condition.predicate = parse_atom(expression.children[1]);
+      return condition;
+    }
+
+    const std::vector<std::pair<std::string, Comparator>> comparators = {
+      { "<", Comparator::LESS }, { "<=", Comparator::LESS_OR_EQUAL }, { "=", Comparator::EQUAL },
+      { ">=", Comparator::GREATER_OR_EQUAL }, { ">", Comparator::GREATER }
+    };
+    for(const std::pair<std::string, Comparator>& comparator : comparators)
+    {
+      if(head == comparator.first)
+      {
+        if(expression.children.size() != 3)
+        {
+          throw std::runtime_error("Comparison " + head + " requires two operands");
+        }
+        condition.type = PddlCondition::Type::COMPARISON;
+        condition.comparator = comparator.second;
+        condition.lhs = parse_numeric_expression(expression.children[1]);
+        condition.rhs = parse_numeric_expression(expression.children[2]);
+        return condition;
+      }
+    }
+
+    if(head == "and" || head == "or" || head == "forall" || head == "exists" || head == "imply" || head == "when")
+    {
+      throw std::runtime_error("Unsupported condition (" + head + " ...)");
+    }
+    condition.type = PddlCondition::Type::PREDICATE;
+    condition.predicate = parse_atom(expression);
+    return condition;
+  }
+
+
+  PddlEffect parse_effect(const SExpression& expression)
+  {
+    PddlEffect effect;
+    const std::string head = expression.head();
+    if(head == "not")
+    {
+      if(expression.children.size() != 2)
+      {
+        throw std::runtime_error("Malformed delete effect");
+      }
+      effect.type = PddlEffect::Type::DELETE;
+      effect.atom = parse_atom(expression.children[1]);
+      return effect;
+    }
+    if(head == "increase" || head == "decrease" || head == "assign")
+    {
+      if(expression.children.size() != 3)
+      {
+        throw std::runtime_error("Effect " + head + " requires a function and a value");
+      }
+      effect.type = (head == "increase") ? PddlEffect::Type::INCREASE
+        : (head == "decrease") ? PddlEffect::Type::DECREASE : PddlEffect::Type::ASSIGN;
+      NumericExpression function = parse_numeric_expression(expression.children[1]);
+      if(function.type != NumericExpression::Type::FUNCTION)
+      {
+        throw std::runtime_error("Effect " + head + " must modify a function");
+      }
+      effect.atom = function.function;
+      effect.value = parse_numeric_expression(expression.children[2]);
+      return effect;
+    }
+    if(head == "and" || head == "forall" || head == "when")
+    {
+      throw std::runtime_error("Unsupported effect (" + head + " ...)");
+    }
+    effect.type = PddlEffect::Type::ADD;
+    effect.atom = parse_atom(expression);
+    return effect;
+  }
+
+
+  /**
+   * @brief The timed elements of (and (at start X) (over all Y) ...), or of a single timed element
+   */
+  std::vector<std::pair<std::string, const SExpression*>> get_timed_elements(const SExpression& expression)
+  {
+    std::vector<const SExpression*> elements;
+    if(expression.head() == "and")
+    {
+      for(size_t i = 1; i < expression.children.size(); i++)
+      {
+        elements.push_back(&expression.children[i]);
+      }
+    }
+    else if(expression.is_list && ! expression.children.empty())
+    {
+      elements.push_back(&expression);
+    }
+
+    std::vector<std::pair<std::string, const SExpression*>> timed_elements;
+    for(const SExpression* element : elements)
+    {
+      if(! element->is_list || element->children.size() != 3 || element->children[1].is_list)
+      {
+        throw std::runtime_error("Expected (at start ...), (over all ...) or (at end ...) in a durative action");
+      }
+      std::string time_specifier = element->children[0].symbol + " " + element->children[1].symbol;
+      if(time_specifier != "at start" && time_specifier != "over all" && time_specifier != "at end")
+      {
+        throw std::runtime_error("Unknown time specifier " + time_specifier);
+      }
+      timed_elements.emplace_back(time_specifier, &element->children[2]);
+    }
+    return timed_elements;
+  }
+
+
+  DurativeAction parse_durative_action(const SExpression& expression)
+  {
+    if(expression.children.size() < 2 || expression.children[1].is_list)
+    {
+      throw std::runtime_error("Durative action without a name");
+    }
+    DurativeAction action;
+    action.name = expression.children[1].symbol;
+
+    for(size_t i = 2; i + 1 < expression.children.size(); i += 2)
+    {
+      const std::string& key = expression.children[i].symbol;
+      const SExpression& value = expression.children[i + 1];
+      if(key == ":parameters")
+      {
+        // (?a ?b - type_0 ?c - type_1)
+        size_t num_untyped = 0;
+        for(size_t j = 0; j < value.children.size(); j++)
+        {
+          const std::string& symbol = value.children[j].symbol;
+          if(symbol == "-" && j + 1 < value.children.size())
+          {
+            action.parameter_types.insert(action.parameter_types.end(), num_untyped, value.children[j + 1].symbol);
+            num_untyped = 0;
+            j++;
+          }
+          else
+          {
+            action.parameters.push_back(symbol);
+            num_untyped++;
+          }
+        }
+        action.parameter_types.insert(action.parameter_types.end(), num_untyped, "object");
+      }
+      else if(key == ":duration")
+      {
+        // (= ?duration expression)
+        if(value.head() != "=" || value.children.size() != 3 || ! value.children[1].is_symbol("?duration"))
+        {
+          throw std::runtime_error("Unsupported duration constraint in " + action.name);
+        }
+        action.duration = parse_numeric_expression(value.children[2]);
+      }
+      else if(key == ":condition")
+      {
+        for(const std::pair<std::string, const SExpression*>& element : get_timed_elements(value))
+        {
+          PddlCondition condition = parse_condition(*element.second);
+          if(element.first == "at start")
+          {
+            action.at_start_conditions.push_back(condition);
+          }
+          else if(element.first == "over all")
+          {
+            action.over_all_conditions.push_back(condition);
+          }
+          else
+          {
+            action.at_end_conditions.push_back(condition);
+          }
+        }
+      }
+      else if(key == ":effect")
+      {
+        for(const std::pair<std::string, const SExpression*>& element : get_timed_elements(value))
+        {
+          if(element.first == "over all")
+          {
+            throw std::runtime_error("Continuous effects are not supported in " + action.name);
+          }
+          PddlEffect effect = parse_effect(*element.second);
+          (element.first == "at start" ? action.at_start_effects : action.at_end_effects).push_back(effect);
+        }
+      }
+    }
+    return action;
+  }
+
+
+  std::string ground_argument(const std::string& argument, const std::vector<std::string>& parameters, const std::vector<std::string>& objects)
+  {
+    std::vector<std::string>::const_iterator it = std::find(parameters.begin(), parameters.end(), argument);
+    return (it == parameters.end()) ? argument : objects[it - parameters.begin()];
+  }
+
+
+  PddlAtom ground_atom(const PddlAtom& atom, const std::vector<std::string>& parameters, const std::vector<std::string>& objects)
+  {
+    PddlAtom grounded_atom{ atom.name, {} };
+    for(const std::string& argument : atom.arguments)
+    {
+      grounded_atom.arguments.push_back(ground_argument(argument, parameters, objects));
+    }
+    return grounded_atom;
+  }
+
+
+  NumericExpression ground_expression(const NumericExpression& expression, const std::vector<std::string>& parameters, const std::vector<std::string>& objects)
+  {
+    NumericExpression grounded_expression = expression;
+    grounded_expression.function = ground_atom(expression.function, parameters, objects);
+    for(NumericExpression& operand : grounded_expression.operands)
+    {
+      operand = ground_expression(operand, parameters, objects);
+    }
+    return grounded_expression;
+  }
+
+
+  std::vector<PddlCondition> ground_conditions(const std::vector<PddlCondition>& conditions, const std::vector<std::string>& parameters, const std::vector<std::string>& objects)
+  {
+    std::vector<PddlCondition> grounded_conditions;
+    for(const PddlCondition& condition : conditions)
+    {
+      PddlCondition grounded_condition = condition;
+      grounded_condition.predicate = ground_atom(condition.predicate, parameters, objects);
+      grounded_condition.lhs = ground_expression(condition.lhs, parameters, objects);
+      grounded_condition.rhs = ground_expression(condition.rhs, parameters, objects);
+      grounded_conditions.push_back(grounded_condition);
+    }
+    return grounded_conditions;
+  }
+
+
+  std::vector<PddlEffect> ground_effects(const std::vector<PddlEffect>& effects, const std::vector<std::string>& parameters, const std::vector<std::string>& objects)
+  {
+    std::vector<PddlEffect> grounded_effects;
+    for(const PddlEffect& effect : effects)
+    {
+      PddlEffect grounded_effect = effect;
+      grounded_effect.atom = ground_atom(effect.atom, parameters, objects);
+      grounded_effect.value = ground_expression(effect.value, parameters, objects);
+      grounded_effects.push_back(grounded_effect);
+    }
+    return grounded_effects;
+  }
+}
+
+
+std::optional<double> NumericExpression::evaluate(
+  const std::function<std::optional<double>(const PddlAtom&)>& function_value,
+  double duration) const
+{
+  switch(type)
+  {
+    case Type::NUMBER:
+      return value;
+    case Type::DURATION:
+      return duration;
+    case Type::FUNCTION:
+      return function_value(function);
+    default:
+      break;
+  }
+
+  std::optional<double> lhs = operands[0].evaluate(function_value, duration);
+  std::optional<double> rhs = operands[1].evaluate(function_value, duration);
+  if(! lhs.has_value() || ! rhs.has_value())
+  {
+    return std::nullopt;
+  }
+  switch(type)
+  {
+    case Type::ADD:
+      return lhs.value() + rhs.value();
+    case Type::SUBTRACT:
+      return lhs.value() - rhs.value();
+    case Type::MULTIPLY:
+      return lhs.value() * rhs.value();
+    default:
+      return (rhs.value() == 0.0) ? std::nullopt : std::optional<double>(lhs.value() / rhs.value());
+  }
+}
+
+
+void NumericExpression::collect_functions(std::vector<PddlAtom>& functions) const
+{
+  if(type == Type::FUNCTION)
+  {
+    functions.push_back(function);
+  }
+  for(const NumericExpression& operand : operands)
+  {
+    operand.collect_functions(functions);
+  }
+}
+
+
+std::string NumericExpression::to_string() const
+{
+  switch(type)
+  {
+    case Type::NUMBER:
+    {
+      std::stringstream ss;
+      ss << value;
+      return ss.str();
+    }
+    case Type::DURATION:
+      return "?duration";
+    case Type::FUNCTION:
+      return function.to_string();
+    case Type::ADD:
+      return "(+ " + operands[0].to_string() + " " + operands[1].to_string() + ")";
+    case Type::SUBTRACT:
+      return "(- " + operands[0].to_string() + " " + operands[1].to_string() + ")";
+    case Type::MULTIPLY:
+      return "(* " + operands[0].to_string() + " " + operands[1].to_string() + ")";
+    case Type::DIVIDE:
+      return "(/ " + operands[0].to_string() + " " + operands[1].to_string() + ")";
+  }
+  return "";
+}
+
+
+std::string PddlCondition::to_string() const
+{
+  switch(type)
+  {
+    case Type::PREDICATE:
+      return predicate.to_string();
+    case Type::NEGATED_PREDICATE:
+      return "(not " + predicate.to_string() + ")";
+    case Type::COMPARISON:
+      break;
+  }
+  const char* comparator_str[] = { "<", "<=", "=", ">=", ">" };
+  return std::string("(") + comparator_str[static_cast<int>(comparator)] + " " + lhs.to_string() + " " + rhs.to_string() + ")";
+}
+
+
+std::string PddlEffect::to_string() const
+{
+  switch(type)
+  {
+    case Type::ADD:
+      return atom.to_string();
+    case Type::DELETE:
+      return "(not " + atom.to_string() + ")";
+    case Type::INCREASE:
+      return "(increase " + atom.to_string() + " " + value.to_string() + ")";
+    case Type::DECREASE:
+      return "(decrease " + atom.to_string() + " " + value.to_string() + ")";
+    case Type::ASSIGN:
+      return "(assign " + atom.to_string() + " " + value.to_string() + ")";
+  }
+  return "";
+}
+
+
+std::string DurativeAction::to_string() const
+{
+  return PddlAtom{ name, parameters }.to_string();
+}
+
+
+PddlDomain PddlDomain::parse(const std::string& domain_str)
+{
+  std::vector<std::string> tokens = tokenize(domain_str);
+  size_t idx = 0;
+  SExpression define = parse_sexpression(tokens, idx);
+  if(define.head() != "define")
+  {
+    throw std::runtime_error("The domain does not start with (define ...)");
+  }
+
+  PddlDomain domain;
+  for(size_t i = 1; i < define.children.size(); i++)
+  {
+    const SExpression& section = define.children[i];
+    const std::string head = section.head();
+    if(head == "domain" && section.children.size() == 2)
+    {
+      domain.name_ = section.children[1].symbol;
+    }
+    else if(head == ":types")
+    {
+      // (:types a b - supertype_0 c - supertype_1)
+      std::vector<std::string> subtypes;
+      for(size_t j = 1; j < section.children.size(); j++)
+      {
+        const std::string& symbol = section.children[j].symbol;
+        if(symbol == "-" && j + 1 < section.children.size())
+        {
+          for(const std::string& subtype : subtypes)
+          {
+            domain.supertypes_[subtype] = section.children[j + 1].symbol;
+          }
+          subtypes.clear();
+          j++;
+        }
+        else
+        {
+          subtypes.push_back(symbol);
+        }
+      }
+    }
+    else if(head == ":durative-action")
+    {
+      domain.actions_.push_back(parse_durative_action(section));
+    }
+    else if(head == ":action")
+    {
+      throw std::runtime_error("Instantaneous actions are not supported");
+    }
+  }
+  return domain;
+}
+
+
+const DurativeAction* PddlDomain::find_action(const std::string& name) const
+{
+  for(const DurativeAction& action : actions_)
+  {
+    if(action.name == name)
+    {
+      return &action;
+    }
+  }
+  return nullptr;
+}
+
+
+std::optional<DurativeAction> PddlDomain::ground(const std::string& action_str) const
+{
+  std::optional<PddlAtom> atom = PddlAtom::parse(action_str);
+  if(! atom.has_value())
+  {
+    return std::nullopt;
+  }
+  const DurativeAction* lifted_action = find_action(atom->name);
+  if(lifted_action == nullptr || lifted_action->parameters.size() != atom->arguments.size())
+  {
+    return std::nullopt;
+  }
+
+  const std::vector<std::string>& parameters = lifted_action->parameters;
+  const std::vector<std::string>& objects = atom->arguments;
+
+  DurativeAction action;
+  action.name = lifted_action->name;
+  action.parameters = objects;
+  action.parameter_types = lifted_action->parameter_types;
+  action.duration = ground_expression(lifted_action->duration, parameters, objects);
+  action.at_start_conditions = ground_conditions(lifted_action->at_start_conditions, parameters, objects);
+  action.over_all_conditions = ground_conditions(lifted_action->over_all_conditions, parameters, objects);
+  action.at_end_conditions = ground_conditions(lifted_action->at_end_conditions, parameters, objects);
+  action.at_start_effects = ground_effects(lifted_action->at_start_effects, parameters, objects);
+  action.at_end_effects = ground_effects(lifted_action->at_end_effects, parameters, objects);
+  return action;
+}
+
+
+bool PddlDomain::is_modified_by_actions(const std::string& name) const
+{
+  for(const DurativeAction& action : actions_)
+  {
+    for(const std::vector<PddlEffect>* effects : { &action.at_start_effects, &action.at_end_effects })
+    {
+      for(const PddlEffect& effect : *effects)
+      {
+        if(effect.atom.name == name)
+        {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+
+bool PddlDomain::is_of_type(const std::string& type, const std::string& parameter_type) const
+{
+  std::string current_type = type;
+  // Bounded by the number of types, in case the hierarchy has a cycle
+  for(size_t i = 0; i <= supertypes_.size(); i++)
+  {
+    if(current_type == parameter_type || parameter_type == "object")
+    {
+      return true;
+    }
+    std::map<std::string, std::string>::const_iterator it = supertypes_.find(current_type);
+    if(it == supertypes_.end())
+    {
+      return false;
+    }
+    current_type = it->second;
+  }
+  return false;
+}
+
+
+void PddlDomain::ground_actions(const PddlProblem& problem, const std::function<void(DurativeAction&&)>& on_action) const
+{
+  std::unordered_set<std::string> fluent_names;
+  for(const DurativeAction& action : actions_)
+  {
+    for(const std::vector<PddlEffect>* effects : { &action.at_start_effects, &action.at_end_effects })
+    {
+      for(const PddlEffect& effect : *effects)
+      {
+        fluent_names.insert(effect.atom.name);
+      }
+    }
+  }
+  std::unordered_set<std::string> static_predicates;
+  for(const PddlAtom& predicate : problem.predicates)
+  {
+    if(! fluent_names.count(predicate.name))
+    {
+      static_predicates.insert(predicate.to_string());
+    }
+  }
+
+  for(const DurativeAction& lifted_action : actions_)
+  {
+    const std::vector<std::string>& parameters = lifted_action.parameters;
+    std::vector<std::vector<std::string>> candidates(parameters.size());
+    for(size_t i = 0; i < parameters.size(); i++)
+    {
+      for(const std::pair<std::string, std::string>& object : problem.objects)
+      {
+        if(is_of_type(object.second, lifted_action.parameter_types[i]))
+        {
+          candidates[i].push_back(object.first);
+        }
+      }
+    }
+
+    // The static conditions are checked as soon as their parameters are assigned
+    std::vector<std::vector<const PddlCondition*>> static_conditions(parameters.size() + 1);
+    for(const std::vector<PddlCondition>* conditions :
+      { &lifted_action.at_start_conditions, &lifted_action.over_all_conditions, &lifted_action.at_end_conditions })
+    {
+      for(const PddlCondition& condition : *conditions)
+      {
+        if(condition.type == PddlCondition::Type::COMPARISON || fluent_names.count(condition.predicate.name))
+        {
+          continue;
+        }
+        size_t num_assigned = 0;
+        for(const std::string& argument : condition.predicate.arguments)
+        {
+          std::vector<std::string>::const_iterator it = std::find(parameters.begin(), parameters.end(), argument);
+          if(it != parameters.end())
+          {
+            num_assigned = std::max<size_t>(num_assigned, it - parameters.begin() + 1);
+          }
+        }
+        static_conditions[num_assigned].push_back(&condition);
+      }
+    }
+
+    std::vector<std::string> objects(parameters.size());
+    auto is_static_satisfied = [&](size_t num_assigned)
+    {
+      for(const PddlCondition* condition : static_conditions[num_assigned])
+      {
+        PddlAtom predicate = condition->predicate;
+        for(std::string& argument : predicate.arguments)
+        {
+          std::vector<std::string>::const_iterator it = std::find(parameters.begin(), parameters.end(), argument);
+          if(it != parameters.end())
+          {
+            argument = objects[it - parameters.begin()];
+          }
+        }
+        const bool is_true = static_predicates.count(predicate.to_string()) > 0;
+        if(is_true != (condition->type == PddlCondition::Type::PREDICATE))
+        {
+          return false;
+        }
+      }
+      return true;
+    };
+
+    std::function<void(size_t)> assign = [&](size_t num_assigned)
+    {
+      if(num_assigned == parameters.size())
+      {
+        std::optional<DurativeAction> action = ground(PddlAtom{ lifted_action.name, objects }.to_string());
+        if(action.has_value())
+        {
+          on_action(std::move(action.value()));
+        }
+        return;
+      }
+
+      for(const std::string& candidate : candidates[num_assigned])
+      {
+        objects[num_assigned] = candidate;
+        if(is_static_satisfied(num_assigned + 1))
+        {
+          assign(num_assigned + 1);
+        }
+      }
+    };
+    if(is_static_satisfied(0))
+    {
+      assign(0);
+    }
+  }
+}
+
+
+PddlProblem PddlProblem::parse(const std::string& problem_str)
+{
+  std::vector<std::string> tokens = tokenize(problem_str);
+  size_t idx = 0;
+  SExpression define = parse_sexpression(tokens, idx);
+  if(define.head() != "define")
+  {
+    throw std::runtime_error("The problem does not start with (define ...)");
+  }
+
+  PddlProblem problem;
+  for(size_t i = 1; i < define.children.size(); i++)
+  {
+    const SExpression& section = define.children[i];
+    const std::string head = section.head();
+    if(head == "problem" && section.children.size() == 2)
+    {
+      problem.name = section.children[1].symbol;
+    }
+    else if(head == ":domain" && section.children.size() == 2)
+    {
+      problem.domain_name = section.children[1].symbol;
+    }
+    else if(head == ":objects")
+    {
+      // (:objects a b - type_0 c - type_1)
+      std::vector<std::string> untyped_objects;
+      for(size_t j = 1; j < section.children.size(); j++)
+      {
+        const std::string& symbol = section.children[j].symbol;
+        if(symbol == "-" && j + 1 < section.children.size())
+        {
+          for(const std::string& object : untyped_objects)
+          {
+            problem.objects.emplace_back(object, section.children[j + 1].symbol);
+          }
+          untyped_objects.clear();
+          j++;
+        }
+        else
+        {
+          untyped_objects.push_back(symbol);
+        }
+      }
+      for(const std::string& object : untyped_objects)
+      {
+        problem.objects.emplace_back(object, "object");
+      }
+    }
+    else if(head == ":init")
+    {
+      for(size_t j = 1; j < section.children.size(); j++)
+      {
+        const SExpression& element = section.children[j];
+        if(element.head() == "=")
+        {
+          NumericExpression function = (element.children.size() == 3) ? parse_numeric_expression(element.children[1]) : NumericExpression();
+          NumericExpression value = (element.children.size() == 3) ? parse_numeric_expression(element.children[2]) : NumericExpression();
+          if(function.type != NumericExpression::Type::FUNCTION || value.type != NumericExpression::Type::NUMBER)
+          {
+            throw std::runtime_error("Expected (= (function args) number) in the initial state");
+          }
+          problem.functions.emplace_back(function.function, value.value);
+        }
+        else
+        {
+          problem.predicates.push_back(parse_atom(element));
+        }
+      }
+    }
+    else if(head == ":goal" && section.children.size() == 2)
+    {
+      const SExpression& goal = section.children[1];
+      if(goal.head() == "and")
+      {
+        for(size_t j = 1; j < goal.children.size(); j++)
+        {
+          problem.goals.push_back(parse_condition(goal.children[j]));
+        }
+      }
+      else
+      {
+        problem.goals.push_back(parse_condition(goal));
+      }
+    }
+  }
+  return problem;
+}
+
+
+std::string PddlProblem::to_string() const
+{
+  std::stringstream ss;
+  ss << std::setprecision(10);
+  ss << "( define ( problem " << name << " )\n( :domain " << domain_name << " )\n( :objects\n";
+  for(const std::pair<std::string, std::string>& object : objects)
+  {
+    ss << "\t" << object.first << " - " << object.second << "\n";
+  }
+  ss << ")\n( :init\n";
+  for(const PddlAtom& predicate : predicates)
+  {
+    ss << "\t" << predicate.to_string() << "\n";
+  }
+  for(const std::pair<PddlAtom, double>& function : functions)
+  {
+    ss << "\t( = " << function.first.to_string() << " " << function.second << " )\n";
+  }
+  ss << ")\n( :goal\n\t( and\n";
+  for(const PddlCondition& goal : goals)
+  {
+    ss << "\t\t" << goal.to_string() << "\n";
+  }
+  ss << "\t)\n)\n)\n";
+  return ss.str();
+}
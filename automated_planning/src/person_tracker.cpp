@@ -0,0 +1,284 @@
+#include "automated_planning/person_tracker.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+PersonTracker::PersonTracker(const PersonTrackerParameters& params)
+: params_(params)
+, next_id_(params.first_id)
+{
+  cell_size_ = std::max(0.1, params_.max_association_distance);
+}
+
+
+uint32_t PersonTracker::add_detection(double time_s, const Eigen::Vector3d& position_ned, uint8_t severity)
+{
+  const Eigen::Vector2d z = position_ned.head<2>();
+  const double r = std::pow(params_.measurement_std, 2);
+
+  // Search the cells a track may have drifted from for the track with the smallest Mahalanobis
+  // distance
+  const int64_t north_idx = static_cast<int64_t>(std::floor(z(0) / cell_size_));
+  const int64_t east_idx = static_cast<int64_t>(std::floor(z(1) / cell_size_));
+  const double search_radius = params_.max_association_distance + get_max_drift_(time_s);
+  const int64_t num_search_cells = static_cast<int64_t>(std::ceil(search_radius / cell_size_));
+
+  PersonTrack* best_track = nullptr;
+  PersonTrack best_predicted_track;
+  double best_distance = std::numeric_limits<double>::infinity();
+
+  auto associate_with_cell = [&](const std::vector<uint32_t>& ids)
+  {
+    for(uint32_t id : ids)
+    {
+      // The predicted position is checked against the hard limit before predicting the covariance
+      PersonTrack& track = tracks_.at(id);
+      const double dt = get_coast_duration_(track, time_s);
+      const double max_distance = params_.max_association_distance + 3.0 * get_position_std_growth_(track, dt);
+      const Eigen::Vector2d innovation = z - (track.x.head<2>() + dt * track.x.tail<2>());
+      if(innovation.squaredNorm() > max_distance * max_distance)
+      {
+        continue;
+      }
+
+      PersonTrack predicted_track = track;
+      predict_(predicted_track, time_s);
+
+      const Eigen::Matrix2d S = predicted_track.P.topLeftCorner<2, 2>() + r * Eigen::Matrix2d::Identity();
+      const double mahalanobis_distance = innovation.dot(S.ldlt().solve(innovation));
+      if(mahalanobis_distance <= params_.gate_threshold && mahalanobis_distance < best_distance)
+      {
+        best_distance = mahalanobis_distance;
+        best_track = &track;
+        best_predicted_track = predicted_track;
+      }
+    }
+  };
+
+  const double num_neighbour_cells = std::pow(2.0 * num_search_cells + 1.0, 2);
+  if(num_neighbour_cells > static_cast<double>(cells_.size()))
+  {
+    for(const auto& [cell_key, ids] : cells_)
+    {
+      associate_with_cell(ids);
+    }
+  }
+  else
+  {
+    for(int64_t d_north = -num_search_cells; d_north <= num_search_cells; d_north++)
+    {
+      for(int64_t d_east = -num_search_cells; d_east <= num_search_cells; d_east++)
+      {
+        std::unordered_map<int64_t, std::vector<uint32_t>>::const_iterator cell_it = cells_.find(get_cell_key_(north_idx + d_north, east_idx + d_east));
+        if(cell_it != cells_.end())
+        {
+          associate_with_cell(cell_it->second);
+        }
+      }
+    }
+  }
+
+  if(best_track == nullptr)
+  {
+    // Start a new tentative track
+    PersonTrack track;
+    track.id = next_id_++;
+    track.severity = severity;
+    track.x << z(0), z(1), 0.0, 0.0;
+    track.P.setZero();
+    track.P.topLeftCorner<2, 2>() = r * Eigen::Matrix2d::Identity();
+    track.P.bottomRightCorner<2, 2>() = std::pow(params_.initial_velocity_std, 2) * Eigen::Matrix2d::Identity();
+    track.down = position_ned(2);
+    track.num_detections = 1;
+    track.confirmed = (params_.confirmation_hits <= 1);
+    track.last_detection_s = time_s;
+    track.state_time_s = time_s;
+
+    tracks_[track.id] = track;
+    insert_in_cell_(track.id, get_cell_key_(track.x));
+    update_drift_bounds_(track);
+    return track.id;
+  }
+
+  // Kalman update of the associated track
+  const int64_t previous_cell_key = get_cell_key_(best_track->x);
+  PersonTrack& track = *best_track;
+  track = best_predicted_track;
+
+  Eigen::Matrix<double, 2, 4> H = Eigen::Matrix<double, 2, 4>::Zero();
+  H(0, 0) = 1.0;
+  H(1, 1) = 1.0;
+
+  const Eigen::Matrix2d S = H * track.P * H.transpose() + r * Eigen::Matrix2d::Identity();
+  const Eigen::Matrix<double, 4, 2> K = track.P * H.transpose() * S.inverse();
+  track.x += K * (z - H * track.x);
+  track.P = (Eigen::Matrix4d::Identity() - K * H) * track.P;
+
+  track.down = position_ned(2);
+  track.severity = std::max(track.severity, severity); // Safest to assume the most severe
+  track.num_detections++;
+  track.confirmed = track.confirmed || (track.num_detections >= params_.confirmation_hits);
+  track.last_detection_s = std::max(track.last_detection_s, time_s);
+
+  const int64_t cell_key = get_cell_key_(track.x);
+  if(cell_key != previous_cell_key)
+  {
+    remove_from_cell_(track.id, previous_cell_key);
+    insert_in_cell_(track.id, cell_key);
+  }
+  update_drift_bounds_(track);
+
+  return track.id;
+}
+
+
+size_t PersonTracker::remove_stale_tracks(double time_s)
+{
+  size_t num_removed = 0;
+  max_drift_speed_ = 0.0;
+  min_state_time_s_ = std::numeric_limits<double>::infinity();
+  for(std::unordered_map<uint32_t, PersonTrack>::iterator it = tracks_.begin(); it != tracks_.end();)
+  {
+    const PersonTrack& track = it->second;
+    if(! track.confirmed && time_s - track.last_detection_s > params_.tentative_timeout)
+    {
+      remove_from_cell_(track.id, get_cell_key_(track.x));
+      it = tracks_.erase(it);
+      num_removed++;
+    }
+    else
+    {
+      update_drift_bounds_(track);
+      it++;
+    }
+  }
+  return num_removed;
+}
+
+
+std::vector<PersonTrack> PersonTracker::get_confirmed_tracks(double time_s) const
+{
+  std::vector<PersonTrack> confirmed_tracks;
+  for(const auto& [id, track] : tracks_)
+  {
+    if(track.confirmed)
+    {
+      PersonTrack predicted_track = track;
+      predict_(predicted_track, time_s);
+      confirmed_tracks.push_back(predicted_track);
+    }
+  }
+
+  std::sort(
+    confirmed_tracks.begin(),
+    confirmed_tracks.end(),
+    [](const PersonTrack& lhs, const PersonTrack& rhs){ return lhs.id < rhs.id; }
+  );
+  return confirmed_tracks;
+}
+
+
+int64_t PersonTracker::get_cell_key_(int64_t north_idx, int64_t east_idx) const
+{
+  // Interleaving two 32-bit indices. Sufficient for any area the drone is capable of covering
+  return (north_idx << 32) ^ (east_idx & 0xFFFFFFFF);
+}
+
+
+int64_t PersonTracker::get_cell_key_(const Eigen::Vector4d& x) const
+{
+  return get_cell_key_(
+    static_cast<int64_t>(std::floor(x(0) / cell_size_)),
+    static_cast<int64_t>(std::floor(x(1) / cell_size_))
+  );
+}
+
+
+void PersonTracker::insert_in_cell_(uint32_t id, int64_t cell_key)
+{
+  cells_[cell_key].push_back(id);
+}
+
+
+void PersonTracker::remove_from_cell_(uint32_t id, int64_t cell_key)
+{
+  std::unordered_map<int64_t, std::vector<uint32_t>>::iterator cell_it = cells_.find(cell_key);
+  if(cell_it == cells_.end())
+  {
+    return;
+  }
+
+  std::vector<uint32_t>& ids = cell_it->second;
+  ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+  if(ids.empty())
+  {
+    cells_.erase(cell_it);
+  }
+}
+
+
+void PersonTracker::update_drift_bounds_(const PersonTrack& track)
+{
+  const double velocity_std = std::sqrt(std::max(track.P(2, 2), track.P(3, 3)));
+  max_drift_speed_ = std::max(max_drift_speed_, track.x.tail<2>().norm() + 3.0 * velocity_std);
+  min_state_time_s_ = std::min(min_state_time_s_, track.state_time_s);
+}
+
+
+double PersonTracker::get_max_drift_(double time_s) const
+{
+  if(tracks_.empty())
+  {
+    return 0.0;
+  }
+  // No track is predicted further than max_coast_time from its state
+  const double dt = std::min(std::max(0.0, time_s - min_state_time_s_), params_.max_coast_time);
+  return max_drift_speed_ * dt + 3.0 * params_.acceleration_std * dt * dt / 2.0;
+}
+
+
+double PersonTracker::get_position_std_growth_(const PersonTrack& track, double dt) const
+{
+  // The predicted standard deviation is at most that of the state, plus the velocity standard
+  // deviation over dt, plus the process noise
+  const double velocity_std = std::sqrt(std::max(track.P(2, 2), track.P(3, 3)));
+  return velocity_std * dt + params_.acceleration_std * dt * dt / 2.0;
+}
+
+
+double PersonTracker::get_coast_duration_(const PersonTrack& track, double time_s) const
+{
+  const double coast_end_s = std::max(track.state_time_s, track.last_detection_s + params_.max_coast_time);
+  return std::max(0.0, std::min(time_s, coast_end_s) - track.state_time_s);
+}
+
+
+void PersonTracker::predict_(PersonTrack& track, double time_s) const
+{
+  const double dt = get_coast_duration_(track, time_s);
+  if(dt <= 0.0)
+  {
+    track.state_time_s = std::max(track.state_time_s, time_s);
+    return;
+  }
+
+  Eigen::Matrix4d F = Eigen::Matrix4d::Identity();
+  F(0, 2) = dt;
+  F(1, 3) = dt;
+
+  // Discrete white noise acceleration
+  const double q = std::pow(params_.acceleration_std, 2);
+  const double dt_2 = dt * dt;
+  const double dt_3 = dt_2 * dt;
+  const double dt_4 = dt_3 * dt;
+  Eigen::Matrix4d Q = Eigen::Matrix4d::Zero();
+  Q(0, 0) = Q(1, 1) = q * dt_4 / 4.0;
+  Q(0, 2) = Q(2, 0) = Q(1, 3) = Q(3, 1) = q * dt_3 / 2.0;
+  Q(2, 2) = Q(3, 3) = q * dt_2;
+
+  track.x = F * track.x;
+  track.P = F * track.P * F.transpose() + Q;
+  track.state_time_s = time_s;
+}
@@ -0,0 +1,64 @@
+#include "automated_planning/person_tracker_node.hpp"
+
+
+void PersonTrackerNode::detected_person_cb_(anafi_uav_interfaces::msg::DetectedPerson::ConstSharedPtr detected_person_msg)
+{
+  // Detections without a timestamp are assumed to be recent
+  rclcpp::Time stamp = detected_person_msg->header.stamp;
+  double time_s = (stamp.nanoseconds() > 0) ? stamp.seconds() : this->get_clock()->now().seconds();
+
+  const geometry_msgs::msg::Point& position = detected_person_msg->position;
+  uint32_t id = tracker_->add_detection(
+    time_s, Eigen::Vector3d(position.x, position.y, position.z), detected_person_msg->severity);
+
+  RCLCPP_DEBUG(this->get_logger(), "Detection at {%f, %f, %f} associated with track %u", position.x, position.y, position.z, id);
+  tracks_changed_ = true;
+}
+
+
+void PersonTrackerNode::publish_timer_cb_()
+{
+  double time_s = this->get_clock()->now().seconds();
+  if(tracker_->remove_stale_tracks(time_s) > 0)
+  {
+    tracks_changed_ = true;
+  }
+
+  if(! tracks_changed_)
+  {
+    return;
+  }
+  tracks_changed_ = false;
+
+  anafi_uav_interfaces::msg::PersonTrackArray tracks_msg;
+  tracks_msg.header.stamp = this->get_clock()->now();
+  tracks_msg.header.frame_id = "ned";
+
+  for(const PersonTrack& track : tracker_->get_confirmed_tracks(time_s))
+  {
+    anafi_uav_interfaces::msg::PersonTrack track_msg;
+    track_msg.id = track.id;
+    track_msg.severity = track.severity;
+    track_msg.position.x = track.x(0);
+    track_msg.position.y = track.x(1);
+    track_msg.position.z = track.down;
+    track_msg.velocity.x = track.x(2);
+    track_msg.velocity.y = track.x(3);
+    track_msg.position_std = std::sqrt(std::max(track.P(0, 0), track.P(1, 1)));
+    track_msg.num_detections = track.num_detections;
+    track_msg.last_detection = rclcpp::Time(static_cast<int64_t>(track.last_detection_s * 1e9), this->get_clock()->get_clock_type());
+    tracks_msg.tracks.push_back(track_msg);
+  }
+
+  person_tracks_pub_->publish(tracks_msg);
+}
+
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  rclcpp::spin(std::make_shared<PersonTrackerNode>());
+  rclcpp::shutdown();
+
+  return 0;
+}
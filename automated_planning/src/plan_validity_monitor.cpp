@@ -0,0 +1,465 @@
+#include "automated_planning/plan_validity_monitor.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+
+namespace
+{
+  /**
+   * @brief Normalized key of an atom given as a string, or the string itself if it is malformed
+   */
+  std::string normalize(const std::string& atom_str)
+  {
+    std::optional<PddlAtom> atom = PddlAtom::parse(atom_str);
+    return atom.has_value() ? atom->to_string() : atom_str;
+  }
+
+
+  std::string get_violation_key(size_t action_idx, const std::string& condition)
+  {
+    return std::to_string(action_idx) + " " + condition;
+  }
+
+
+  bool is_numeric_effect(const PddlEffect& effect)
+  {
+    return effect.type == PddlEffect::Type::INCREASE
+      || effect.type == PddlEffect::Type::DECREASE
+      || effect.type == PddlEffect::Type::ASSIGN;
+  }
+
+
+  std::vector<PddlAtom> get_functions(const PddlCondition& condition)
+  {
+    std::vector<PddlAtom> functions;
+    condition.lhs.collect_functions(functions);
+    condition.rhs.collect_functions(functions);
+    return functions;
+  }
+
+
+  /**
+   * @brief Whether one of the @p effects makes the @p condition false, or changes a function it uses
+   */
+  bool is_affected_by(const PddlCondition& condition, const std::vector<PddlEffect>& effects)
+  {
+    std::vector<PddlAtom> functions = get_functions(condition);
+    for(const PddlEffect& effect : effects)
+    {
+      std::string key = effect.atom.to_string();
+      switch(condition.type)
+      {
+        case PddlCondition::Type::PREDICATE:
+          if(effect.type == PddlEffect::Type::DELETE && key == condition.predicate.to_string())
+          {
+            return true;
+          }
+          break;
+        case PddlCondition::Type::NEGATED_PREDICATE:
+          if(effect.type == PddlEffect::Type::ADD && key == condition.predicate.to_string())
+          {
+            return true;
+          }
+          break;
+        case PddlCondition::Type::COMPARISON:
+          if(is_numeric_effect(effect) && std::any_of(functions.begin(), functions.end(),
+            [&key](const PddlAtom& function){ return function.to_string() == key; }))
+          {
+            return true;
+          }
+          break;
+      }
+    }
+    return false;
+  }
+}
+
+
+std::string PlanViolation::to_string() const
+{
+  return action + " requires " + condition + (is_telemetry ? ", which is contradicted by the telemetry" : "");
+}
+
+
+PlanValidityMonitor::PlanValidityMonitor(std::shared_ptr<const PddlDomain> domain)
+: domain_(domain)
+, is_plan_started_(false)
+, is_dirty_(true)
+, knowledge_version_(0)
+, progress_version_(0)
+, is_baseline_set_(false)
+, num_checks_(0)
+, num_projections_(0)
+{}
+
+
+void PlanValidityMonitor::start_plan(const std::vector<ActionTiming>& actions)
+{
+  actions_.clear();
+  unmonitored_actions_.clear();
+  for(const ActionTiming& timing : actions)
+  {
+    MonitoredAction monitored_action;
+    monitored_action.action = domain_->ground(timing.action);
+    monitored_action.action_str = timing.action;
+    monitored_action.planned_duration_s = timing.planned_duration_s;
+    monitored_action.status = timing.status;
+    monitored_action.completion = timing.completion;
+    if(! monitored_action.action.has_value())
+    {
+      unmonitored_actions_.push_back(timing.action);
+    }
+    actions_.push_back(monitored_action);
+  }
+
+  is_plan_started_ = true;
+  is_dirty_ = true;
+  violations_.clear();
+  suspected_violations_.clear();
+  is_baseline_set_ = false;
+  baseline_violations_.clear();
+  baseline_keys_.clear();
+}
+
+
+void PlanValidityMonitor::stop_plan()
+{
+  is_plan_started_ = false;
+  actions_.clear();
+  unmonitored_actions_.clear();
+  violations_.clear();
+  suspected_violations_.clear();
+  baseline_violations_.clear();
+  baseline_keys_.clear();
+}
+
+
+void PlanValidityMonitor::update_progress(const std::vector<ActionTiming>& actions)
+{
+  for(size_t i = 0; i < std::min(actions.size(), actions_.size()); i++)
+  {
+    actions_[i].status = actions[i].status;
+    actions_[i].completion = actions[i].completion;
+  }
+  progress_version_++;
+  is_dirty_ = true;
+}
+
+
+void PlanValidityMonitor::set_function_override(const std::string& function, double value)
+{
+  std::string key = normalize(function);
+  std::map<std::string, double>::iterator it = function_overrides_.find(key);
+  if(it == function_overrides_.end() || it->second != value)
+  {
+    function_overrides_[key] = value;
+    is_dirty_ = true;
+  }
+}
+
+
+void PlanValidityMonitor::set_retracted_predicates(const std::vector<std::string>& predicates)
+{
+  std::set<std::string> retracted_predicates;
+  for(const std::string& predicate : predicates)
+  {
+    retracted_predicates.insert(normalize(predicate));
+  }
+  if(retracted_predicates != retracted_predicates_)
+  {
+    retracted_predicates_.swap(retracted_predicates);
+    is_dirty_ = true;
+  }
+}
+
+
+const std::vector<PlanViolation>& PlanValidityMonitor::check(const KnowledgeMirror& knowledge)
+{
+  num_checks_++;
+  if(! is_plan_started_)
+  {
+    return violations_;
+  }
+  if(is_dirty_ || knowledge.get_version() != knowledge_version_)
+  {
+    project_(knowledge);
+    knowledge_version_ = knowledge.get_version();
+    is_dirty_ = false;
+  }
+  return violations_;
+}
+
+
+std::string PlanValidityMonitor::get_statistics_string() const
+{
+  std::stringstream ss;
+  ss << "Plan validity monitor: " << actions_.size() - unmonitored_actions_.size() << " monitored actions, "
+    << unmonitored_actions_.size() << " unmonitored. "
+    << num_projections_ << " projections in " << num_checks_ << " checks";
+  return ss.str();
+}
+
+
+void PlanValidityMonitor::project_(const KnowledgeMirror& knowledge)
+{
+  num_projections_++;
+
+  ProjectedState state;
+  std::vector<PlanViolation> violations;
+  std::map<std::string, size_t> suspected_violations;
+
+  auto check_conditions = [&](size_t action_idx, const std::vector<PddlCondition>& conditions, bool is_start_condition)
+  {
+    const MonitoredAction& monitored_action = actions_[action_idx];
+    for(const PddlCondition& condition : conditions)
+    {
+      ConditionResult result = evaluate_(state, knowledge, condition, monitored_action.planned_duration_s);
+      if(result == ConditionResult::SATISFIED || result == ConditionResult::UNKNOWN)
+      {
+        continue;
+      }
+
+      // Numeric conditions on overridden functions are violated by the telemetry
+      bool is_telemetry = (result == ConditionResult::RETRACTED);
+      if(condition.type == PddlCondition::Type::COMPARISON)
+      {
+        std::vector<PddlAtom> functions = get_functions(condition);
+        is_telemetry = std::any_of(functions.begin(), functions.end(),
+          [this](const PddlAtom& function){ return function_overrides_.count(function.to_string()) > 0; });
+      }
+      PlanViolation violation{ action_idx, monitored_action.action_str, condition.to_string(), is_telemetry };
+      std::string key = get_violation_key(action_idx, violation.condition);
+
+      // The telemetry is not known to the planner, such that its violations are always reported,
+      // for example a battery which is already too low when the plan starts
+      if(! is_telemetry && ! is_baseline_set_)
+      {
+        baseline_violations_.push_back(violation);
+        baseline_keys_.insert(key);
+        continue;
+      }
+      if(! is_telemetry && baseline_keys_.count(key) > 0)
+      {
+        continue;
+      }
+
+      if(! is_telemetry && is_suspected_lag_(action_idx, condition, is_start_condition))
+      {
+        std::map<std::string, size_t>::const_iterator it = suspected_violations_.find(key);
+        size_t first_seen_version = (it != suspected_violations_.end()) ? it->second : progress_version_;
+        suspected_violations[key] = first_seen_version;
+        if(first_seen_version == progress_version_)
+        {
+          continue;
+        }
+      }
+      violations.push_back(violation);
+    }
+  };
+
+  // The executing actions must keep their over all-conditions. Their start effects are already in
+  // the knowledge, except for the part of the overridden functions which is not yet executed
+  for(size_t i = 0; i < actions_.size(); i++)
+  {
+    if(actions_[i].action.has_value() && actions_[i].status == ActionStatus::EXECUTING)
+    {
+      check_conditions(i, actions_[i].action->over_all_conditions, false);
+    }
+  }
+  for(size_t i = 0; i < actions_.size(); i++)
+  {
+    const MonitoredAction& monitored_action = actions_[i];
+    if(! monitored_action.action.has_value() || monitored_action.status != ActionStatus::EXECUTING)
+    {
+      continue;
+    }
+    std::vector<PddlEffect> overridden_start_effects;
+    for(const PddlEffect& effect : monitored_action.action->at_start_effects)
+    {
+      if(is_numeric_effect(effect) && function_overrides_.count(effect.atom.to_string()) > 0)
+      {
+        overridden_start_effects.push_back(effect);
+      }
+    }
+    apply_(state, knowledge, overridden_start_effects, monitored_action.planned_duration_s, 1.0 - monitored_action.completion);
+    apply_(state, knowledge, monitored_action.action->at_end_effects, monitored_action.planned_duration_s, 1.0);
+  }
+
+  // The remaining actions in the order of the planned start
+  for(size_t i = 0; i < actions_.size(); i++)
+  {
+    const MonitoredAction& monitored_action = actions_[i];
+    if(! monitored_action.action.has_value() || monitored_action.status != ActionStatus::NOT_EXECUTED)
+    {
+      continue;
+    }
+    const DurativeAction& action = monitored_action.action.value();
+    check_conditions(i, action.at_start_conditions, true);
+    check_conditions(i, action.over_all_conditions, true);
+    apply_(state, knowledge, action.at_start_effects, monitored_action.planned_duration_s, 1.0);
+    check_conditions(i, action.at_end_conditions, true);
+    apply_(state, knowledge, action.at_end_effects, monitored_action.planned_duration_s, 1.0);
+  }
+
+  violations_.swap(violations);
+  suspected_violations_.swap(suspected_violations);
+  is_baseline_set_ = true;
+}
+
+
+bool PlanValidityMonitor::holds_(const ProjectedState& state, const KnowledgeMirror& knowledge, const PddlAtom& predicate) const
+{
+  std::string key = predicate.to_string();
+  std::unordered_map<std::string, bool>::const_iterator it = state.predicates.find(key);
+  if(it != state.predicates.end())
+  {
+    return it->second;
+  }
+  return retracted_predicates_.count(key) == 0 && knowledge.has_predicate(predicate.name, predicate.arguments);
+}
+
+
+std::optional<double> PlanValidityMonitor::get_function_(const ProjectedState& state, const KnowledgeMirror& knowledge, const PddlAtom& function) const
+{
+  std::string key = function.to_string();
+  std::unordered_map<std::string, double>::const_iterator it = state.functions.find(key);
+  if(it != state.functions.end())
+  {
+    return it->second;
+  }
+  std::map<std::string, double>::const_iterator override_it = function_overrides_.find(key);
+  if(override_it != function_overrides_.end())
+  {
+    return override_it->second;
+  }
+  return knowledge.get_function(function.name, function.arguments);
+}
+
+
+PlanValidityMonitor::ConditionResult PlanValidityMonitor::evaluate_(
+  const ProjectedState& state, const KnowledgeMirror& knowledge, const PddlCondition& condition, double duration_s) const
+{
+  switch(condition.type)
+  {
+    case PddlCondition::Type::PREDICATE:
+    {
+      if(holds_(state, knowledge, condition.predicate))
+      {
+        return ConditionResult::SATISFIED;
+      }
+      std::string key = condition.predicate.to_string();
+      bool is_retracted = state.predicates.count(key) == 0 && retracted_predicates_.count(key) > 0
+        && knowledge.has_predicate(condition.predicate.name, condition.predicate.arguments);
+      return is_retracted ? ConditionResult::RETRACTED : ConditionResult::VIOLATED;
+    }
+    case PddlCondition::Type::NEGATED_PREDICATE:
+      return holds_(state, knowledge, condition.predicate) ? ConditionResult::VIOLATED : ConditionResult::SATISFIED;
+    case PddlCondition::Type::COMPARISON:
+      break;
+  }
+
+  auto function_value = [this, &state, &knowledge](const PddlAtom& function) { return get_function_(state, knowledge, function); };
+  std::optional<double> lhs = condition.lhs.evaluate(function_value, duration_s);
+  std::optional<double> rhs = condition.rhs.evaluate(function_value, duration_s);
+  if(! lhs.has_value() || ! rhs.has_value())
+  {
+    return ConditionResult::UNKNOWN;
+  }
+
+  bool is_satisfied = false;
+  switch(condition.comparator)
+  {
+    case Comparator::LESS:
+      is_satisfied = lhs.value() < rhs.value();
+      break;
+    case Comparator::LESS_OR_EQUAL:
+      is_satisfied = lhs.value() <= rhs.value();
+      break;
+    case Comparator::EQUAL:
+      is_satisfied = lhs.value() == rhs.value();
+      break;
+    case Comparator::GREATER_OR_EQUAL:
+      is_satisfied = lhs.value() >= rhs.value();
+      break;
+    case Comparator::GREATER:
+      is_satisfied = lhs.value() > rhs.value();
+      break;
+  }
+  return is_satisfied ? ConditionResult::SATISFIED : ConditionResult::VIOLATED;
+}
+
+
+void PlanValidityMonitor::apply_(
+  ProjectedState& state, const KnowledgeMirror& knowledge, const std::vector<PddlEffect>& effects, double duration_s, double remaining_fraction) const
+{
+  // The values are evaluated before any of the effects are applied
+  std::vector<std::pair<std::string, double>> function_updates;
+  auto function_value = [this, &state, &knowledge](const PddlAtom& function) { return get_function_(state, knowledge, function); };
+
+  for(const PddlEffect& effect : effects)
+  {
+    switch(effect.type)
+    {
+      case PddlEffect::Type::ADD:
+        state.predicates[effect.atom.to_string()] = true;
+        break;
+      case PddlEffect::Type::DELETE:
+        state.predicates[effect.atom.to_string()] = false;
+        break;
+      default:
+      {
+        std::optional<double> current_value = get_function_(state, knowledge, effect.atom);
+        std::optional<double> value = effect.value.evaluate(function_value, duration_s);
+        if(! current_value.has_value() || ! value.has_value())
+        {
+          break;
+        }
+        double new_value = value.value();
+        if(effect.type == PddlEffect::Type::INCREASE)
+        {
+          new_value = current_value.value() + remaining_fraction * value.value();
+        }
+        else if(effect.type == PddlEffect::Type::DECREASE)
+        {
+          new_value = current_value.value() - remaining_fraction * value.value();
+        }
+        function_updates.emplace_back(effect.atom.to_string(), new_value);
+        break;
+      }
+    }
+  }
+
+  for(const std::pair<std::string, double>& function_update : function_updates)
+  {
+    state.functions[function_update.first] = function_update.second;
+  }
+}
+
+
+bool PlanValidityMonitor::is_suspected_lag_(size_t action_idx, const PddlCondition& condition, bool is_start_condition) const
+{
+  // An action which has just started has applied its start effects, and an action which has just
+  // finished has applied its end effects, before the progress shows it
+  const DurativeAction& action = actions_[action_idx].action.value();
+  if(is_affected_by(condition, is_start_condition ? action.at_start_effects : action.at_end_effects))
+  {
+    return true;
+  }
+  if(condition.type != PddlCondition::Type::COMPARISON)
+  {
+    return false;
+  }
+
+  // The end effects of the executing actions are applied by the projection, and may have been
+  // applied to the knowledge as well
+  for(const MonitoredAction& monitored_action : actions_)
+  {
+    if(monitored_action.action.has_value() && monitored_action.status == ActionStatus::EXECUTING
+      && is_affected_by(condition, monitored_action.action->at_end_effects))
+    {
+      return true;
+    }
+  }
+  return false;
+}
@@ -10,21 +10,33 @@
 
 #include "std_msgs/msg/string.hpp"
 
+#include "automated_planning/action_activation_monitor.hpp"
+#include "automated_planning/adaptive_action_executor_client.hpp"
+
 using namespace std::chrono_literals;
 
 class RechargeActionNode 
-  : public plansys2::ActionExecutorClient
+  : public AdaptiveActionExecutorClient
 {
 public:
   RechargeActionNode()
-  : plansys2::ActionExecutorClient("recharge_action_node", 500ms)
+  : AdaptiveActionExecutorClient("recharge_action_node", 500ms, false)
   {
     this->declare_parameter("locations.recharge_available", std::vector<std::string>());
+
+    activation_monitor_ = std::make_unique<ActionActivationMonitor>(this);
   }
 
 // Lifecycle-events
+LifecycleNodeInterface::CallbackReturn on_configure(const rclcpp_lifecycle::State & previous_state)
+{
+  activation_monitor_->start();
+  return AdaptiveActionExecutorClient::on_configure(previous_state);
+}
+
 LifecycleNodeInterface::CallbackReturn on_activate(const rclcpp_lifecycle::State &)
 {
+  ActionActivationMonitor::ActivationScope activation(*activation_monitor_);
   RCLCPP_INFO(this->get_logger(), "Trying to activate recharge");
 
   const std::string location = get_arguments()[1];
@@ -48,6 +60,8 @@ LifecycleNodeInterface::CallbackReturn on_activate(const rclcpp_lifecycle::State
 }
 
 private:  
+  std::unique_ptr<ActionActivationMonitor> activation_monitor_;
+
   void do_work()
   {
   }
@@ -0,0 +1,676 @@
+#include "automated_planning/relevance_analysis.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <sstream>
+#include <tuple>
+
+
+namespace
+{
+  std::optional<double> evaluate_static(const NumericExpression& expression, const std::unordered_map<std::string, double>& static_values)
+  {
+    return expression.evaluate([&static_values](const PddlAtom& function) -> std::optional<double>
+    {
+      std::unordered_map<std::string, double>::const_iterator it = static_values.find(function.to_string());
+      if(it == static_values.end())
+      {
+        return std::nullopt;
+      }
+      return it->second;
+    });
+  }
+
+
+  /**
+   * @brief Sign of the expression if it only depends on static functions, otherwise 0
+   */
+  int get_static_sign(const NumericExpression& expression, const std::unordered_map<std::string, double>& static_values)
+  {
+    std::optional<double> value = evaluate_static(expression, static_values);
+    if(! value.has_value() || value.value() == 0.0)
+    {
+      return 0;
+    }
+    return (value.value() > 0.0) ? 1 : -1;
+  }
+
+
+  /**
+   * @brief Shortest route durations from @p start, following @p edges
+   *
+   * @param previous  The previous node on the shortest route to each node, or the number of nodes
+   *                  for @p start and the unreachable nodes
+   */
+  std::vector<double> find_durations(const std::vector<std::vector<std::pair<size_t, double>>>& edges, size_t start, std::vector<size_t>& previous)
+  {
+    std::vector<double> durations(edges.size(), std::numeric_limits<double>::infinity());
+    previous.assign(edges.size(), edges.size());
+    using QueueItem = std::pair<double, size_t>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+    durations[start] = 0.0;
+    queue.push({ 0.0, start });
+    while(! queue.empty())
+    {
+      QueueItem item = queue.top();
+      queue.pop();
+      if(item.first > durations[item.second])
+      {
+        continue;
+      }
+      for(const std::pair<size_t, double>& edge : edges[item.second])
+      {
+        double duration = item.first + edge.second;
+        if(duration < durations[edge.first])
+        {
+          durations[edge.first] = duration;
+          previous[edge.first] = item.second;
+          queue.push({ duration, edge.first });
+        }
+      }
+    }
+    return durations;
+  }
+}
+
+
+std::string RelevanceStatistics::to_string() const
+{
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(1);
+  ss << "Relevance analysis in " << 1e3 * duration_s << " ms: "
+    << num_relevant_objects << "/" << num_objects << " objects, "
+    << num_relevant_predicates << "/" << num_predicates << " predicates, "
+    << num_relevant_functions << "/" << num_functions << " functions, "
+    << num_relevant_actions << "/" << num_ground_actions << " ground actions relevant. "
+    << num_off_route_objects << " objects off the routes between " << num_route_anchors << " anchors";
+  return ss.str();
+}
+
+
+RelevanceAnalysis::RelevanceAnalysis(std::shared_ptr<const PddlDomain> domain, bool is_route_pruning_enabled)
+: domain_(domain)
+, is_route_pruning_enabled_(is_route_pruning_enabled)
+{
+  for(const DurativeAction& action : domain_->get_actions())
+  {
+    for(const std::vector<PddlEffect>* effects : { &action.at_start_effects, &action.at_end_effects })
+    {
+      for(const PddlEffect& effect : *effects)
+      {
+        fluent_names_.insert(effect.atom.name);
+      }
+    }
+  }
+
+  for(const DurativeAction& action : domain_->get_actions())
+  {
+    std::vector<PddlEffect> effects = action.at_start_effects;
+    effects.insert(effects.end(), action.at_end_effects.begin(), action.at_end_effects.end());
+    auto find_parameter = [&action](const std::string& argument)
+    {
+      return static_cast<size_t>(std::find(action.parameters.begin(), action.parameters.end(), argument) - action.parameters.begin());
+    };
+
+    for(const std::vector<PddlCondition>* conditions : { &action.at_start_conditions, &action.over_all_conditions })
+    {
+      for(const PddlCondition& condition : *conditions)
+      {
+        const std::vector<std::string>& arguments = condition.predicate.arguments;
+        if(condition.type != PddlCondition::Type::PREDICATE || fluent_names_.count(condition.predicate.name)
+          || arguments.size() != 2 || arguments[0] == arguments[1])
+        {
+          continue;
+        }
+        const size_t from_parameter = find_parameter(arguments[0]);
+        const size_t to_parameter = find_parameter(arguments[1]);
+        if(from_parameter == action.parameters.size() || to_parameter == action.parameters.size())
+        {
+          continue;
+        }
+
+        // A fluent predicate which is deleted for ?from and added for ?to, with the same other arguments
+        for(const PddlEffect& deleted : effects)
+        {
+          for(const PddlEffect& added : effects)
+          {
+            if(deleted.type != PddlEffect::Type::DELETE || added.type != PddlEffect::Type::ADD
+              || deleted.atom.name != added.atom.name || deleted.atom.arguments.size() != added.atom.arguments.size())
+            {
+              continue;
+            }
+            for(size_t i = 0; i < deleted.atom.arguments.size(); i++)
+            {
+              PddlAtom moved = deleted.atom;
+              moved.arguments[i] = arguments[1];
+              if(deleted.atom.arguments[i] == arguments[0] && moved.to_string() == added.atom.to_string())
+              {
+                transitions_.push_back({ action.name, from_parameter, to_parameter, deleted.atom.name, i });
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+
+PddlProblem RelevanceAnalysis::reduce(const PddlProblem& problem)
+{
+  std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+  statistics_ = RelevanceStatistics();
+  statistics_.num_objects = problem.objects.size();
+  statistics_.num_predicates = problem.predicates.size();
+  statistics_.num_functions = problem.functions.size();
+
+  std::vector<DurativeAction> actions;
+  domain_->ground_actions(problem, [&actions](DurativeAction&& action){ actions.push_back(std::move(action)); });
+  statistics_.num_ground_actions = actions.size();
+
+  std::unordered_map<std::string, double> static_values;
+  for(const std::pair<PddlAtom, double>& function : problem.functions)
+  {
+    if(! fluent_names_.count(function.first.name))
+    {
+      static_values[function.first.to_string()] = function.second;
+    }
+  }
+
+  // Initial facts which are added back by every action deleting them, such as not_tracking, are
+  // true between the actions of a sequential plan
+  std::unordered_set<std::string> invariant_facts;
+  for(const PddlAtom& predicate : problem.predicates)
+  {
+    invariant_facts.insert(predicate.to_string());
+  }
+  for(const DurativeAction& action : actions)
+  {
+    for(const std::vector<PddlEffect>* effects : { &action.at_start_effects, &action.at_end_effects })
+    {
+      for(const PddlEffect& effect : *effects)
+      {
+        if(effect.type != PddlEffect::Type::DELETE)
+        {
+          continue;
+        }
+        const bool is_restored = std::any_of(action.at_end_effects.begin(), action.at_end_effects.end(), [&effect](const PddlEffect& end_effect)
+        {
+          return end_effect.type == PddlEffect::Type::ADD && end_effect.atom.to_string() == effect.atom.to_string();
+        });
+        if(! is_restored)
+        {
+          invariant_facts.erase(effect.atom.to_string());
+        }
+      }
+    }
+  }
+
+  // The actions which can make each fact true or false, or change each function in a direction
+  std::unordered_map<std::string, std::vector<size_t>> achievers;
+  std::unordered_map<std::string, std::vector<size_t>> deleters;
+  std::unordered_map<std::string, std::vector<std::pair<size_t, int>>> changers;
+  for(size_t action_idx = 0; action_idx < actions.size(); action_idx++)
+  {
+    const DurativeAction& action = actions[action_idx];
+    std::unordered_set<std::string> start_facts;
+    for(const PddlCondition& condition : action.at_start_conditions)
+    {
+      if(condition.type == PddlCondition::Type::PREDICATE)
+      {
+        start_facts.insert(condition.predicate.to_string());
+      }
+    }
+    for(const std::vector<PddlEffect>* effects : { &action.at_start_effects, &action.at_end_effects })
+    {
+      for(const PddlEffect& effect : *effects)
+      {
+        const std::string key = effect.atom.to_string();
+        switch(effect.type)
+        {
+          case PddlEffect::Type::ADD:
+            // Restoring a fact required at start does not achieve it
+            if(! invariant_facts.count(key) && ! start_facts.count(key))
+            {
+              achievers[key].push_back(action_idx);
+            }
+            break;
+          case PddlEffect::Type::DELETE:
+            deleters[key].push_back(action_idx);
+            break;
+          case PddlEffect::Type::INCREASE:
+          case PddlEffect::Type::DECREASE:
+          {
+            int sign = get_static_sign(effect.value, static_values) * ((effect.type == PddlEffect::Type::INCREASE) ? 1 : -1);
+            changers[key].push_back({ action_idx, (sign > 0) ? INCREASE : (sign < 0) ? DECREASE : INCREASE | DECREASE });
+            break;
+          }
+          case PddlEffect::Type::ASSIGN:
+            changers[key].push_back({ action_idx, INCREASE | DECREASE });
+            break;
+        }
+      }
+    }
+  }
+
+  // Backward from the goal
+  std::unordered_set<std::string> relevant_facts;
+  std::unordered_set<std::string> relevant_negated_facts;
+  std::unordered_map<std::string, int> function_directions;
+  std::vector<bool> is_relevant(actions.size(), false);
+  std::deque<size_t> queue;
+
+  auto mark_action = [&](size_t action_idx)
+  {
+    if(! is_relevant[action_idx])
+    {
+      is_relevant[action_idx] = true;
+      queue.push_back(action_idx);
+    }
+  };
+  auto add_fact = [&](const PddlAtom& predicate, bool is_negated)
+  {
+    const std::string key = predicate.to_string();
+    if(! (is_negated ? relevant_negated_facts : relevant_facts).insert(key).second)
+    {
+      return;
+    }
+    const std::unordered_map<std::string, std::vector<size_t>>& supporters = is_negated ? deleters : achievers;
+    std::unordered_map<std::string, std::vector<size_t>>::const_iterator it = supporters.find(key);
+    if(it != supporters.end())
+    {
+      std::for_each(it->second.begin(), it->second.end(), mark_action);
+    }
+  };
+  auto add_function = [&](const PddlAtom& function, int directions)
+  {
+    const std::string key = function.to_string();
+    int& current_directions = function_directions[key];
+    const int new_directions = directions & ~current_directions;
+    current_directions |= directions;
+    std::unordered_map<std::string, std::vector<std::pair<size_t, int>>>::const_iterator it = changers.find(key);
+    if(new_directions == 0 || it == changers.end())
+    {
+      return;
+    }
+    for(const std::pair<size_t, int>& changer : it->second)
+    {
+      if(changer.second & new_directions)
+      {
+        mark_action(changer.first);
+      }
+    }
+  };
+  // sign is 1 if a larger value of the expression helps, -1 if a smaller helps and 0 if unknown
+  std::function<void(const NumericExpression&, int)> add_expression = [&](const NumericExpression& expression, int sign)
+  {
+    switch(expression.type)
+    {
+      case NumericExpression::Type::NUMBER:
+      case NumericExpression::Type::DURATION:
+        break;
+      case NumericExpression::Type::FUNCTION:
+        add_function(expression.function, (sign > 0) ? INCREASE : (sign < 0) ? DECREASE : INCREASE | DECREASE);
+        break;
+      case NumericExpression::Type::ADD:
+        add_expression(expression.operands[0], sign);
+        add_expression(expression.operands[1], sign);
+        break;
+      case NumericExpression::Type::SUBTRACT:
+        add_expression(expression.operands[0], sign);
+        add_expression(expression.operands[1], -sign);
+        break;
+      case NumericExpression::Type::MULTIPLY:
+        add_expression(expression.operands[0], sign * get_static_sign(expression.operands[1], static_values));
+        add_expression(expression.operands[1], sign * get_static_sign(expression.operands[0], static_values));
+        break;
+      case NumericExpression::Type::DIVIDE:
+        add_expression(expression.operands[0], sign * get_static_sign(expression.operands[1], static_values));
+        add_expression(expression.operands[1], 0);
+        break;
+    }
+  };
+  auto add_condition = [&](const PddlCondition& condition)
+  {
+    switch(condition.type)
+    {
+      case PddlCondition::Type::PREDICATE:
+        add_fact(condition.predicate, false);
+        break;
+      case PddlCondition::Type::NEGATED_PREDICATE:
+        add_fact(condition.predicate, true);
+        break;
+      case PddlCondition::Type::COMPARISON:
+      {
+        const bool is_greater = (condition.comparator == Comparator::GREATER || condition.comparator == Comparator::GREATER_OR_EQUAL);
+        const bool is_less = (condition.comparator == Comparator::LESS || condition.comparator == Comparator::LESS_OR_EQUAL);
+        const int sign = is_greater ? 1 : is_less ? -1 : 0;
+        add_expression(condition.lhs, sign);
+        add_expression(condition.rhs, -sign);
+        break;
+      }
+    }
+  };
+
+  for(const PddlCondition& goal : problem.goals)
+  {
+    add_condition(goal);
+  }
+  while(! queue.empty())
+  {
+    const DurativeAction& action = actions[queue.front()];
+    queue.pop_front();
+
+    // A comparison on a function the action assigns, such as (< (battery_charge ?d) 100) of
+    // recharge, only prevents a needless assignment. Otherwise every action using battery would
+    // be relevant, as it enables recharging
+    std::unordered_set<std::string> assigned_functions;
+    for(const std::vector<PddlEffect>* effects : { &action.at_start_effects, &action.at_end_effects })
+    {
+      for(const PddlEffect& effect : *effects)
+      {
+        if(effect.type == PddlEffect::Type::ASSIGN)
+        {
+          assigned_functions.insert(effect.atom.to_string());
+        }
+      }
+    }
+    for(const std::vector<PddlCondition>* conditions : { &action.at_start_conditions, &action.over_all_conditions, &action.at_end_conditions })
+    {
+      for(const PddlCondition& condition : *conditions)
+      {
+        std::vector<PddlAtom> functions;
+        condition.lhs.collect_functions(functions);
+        condition.rhs.collect_functions(functions);
+        const bool is_assigned = std::any_of(functions.begin(), functions.end(),
+          [&assigned_functions](const PddlAtom& function){ return assigned_functions.count(function.to_string()) > 0; });
+        if(condition.type != PddlCondition::Type::COMPARISON || ! is_assigned)
+        {
+          add_condition(condition);
+        }
+      }
+    }
+    // The new value of a relevant function depends on the functions of the effect
+    for(const std::vector<PddlEffect>* effects : { &action.at_start_effects, &action.at_end_effects })
+    {
+      for(const PddlEffect& effect : *effects)
+      {
+        if(effect.type != PddlEffect::Type::ADD && effect.type != PddlEffect::Type::DELETE && function_directions.count(effect.atom.to_string()))
+        {
+          add_expression(effect.value, 0);
+        }
+      }
+    }
+  }
+
+  // The objects, facts and functions used by the relevant actions and the goal
+  std::vector<const DurativeAction*> relevant_actions;
+  std::unordered_set<std::string> relevant_objects;
+  std::unordered_set<std::string> used_functions;
+  auto add_functions = [&](const NumericExpression& expression)
+  {
+    std::vector<PddlAtom> functions;
+    expression.collect_functions(functions);
+    for(const PddlAtom& function : functions)
+    {
+      used_functions.insert(function.to_string());
+      relevant_objects.insert(function.arguments.begin(), function.arguments.end());
+    }
+  };
+  auto add_condition_objects = [&](const PddlCondition& condition)
+  {
+    if(condition.type == PddlCondition::Type::COMPARISON)
+    {
+      add_functions(condition.lhs);
+      add_functions(condition.rhs);
+    }
+    else
+    {
+      relevant_objects.insert(condition.predicate.arguments.begin(), condition.predicate.arguments.end());
+    }
+  };
+  for(const PddlCondition& goal : problem.goals)
+  {
+    add_condition_objects(goal);
+  }
+  for(size_t action_idx = 0; action_idx < actions.size(); action_idx++)
+  {
+    if(! is_relevant[action_idx])
+    {
+      continue;
+    }
+    const DurativeAction& action = actions[action_idx];
+    relevant_actions.push_back(&action);
+    relevant_objects.insert(action.parameters.begin(), action.parameters.end());
+    add_functions(action.duration);
+    for(const std::vector<PddlCondition>* conditions : { &action.at_start_conditions, &action.over_all_conditions, &action.at_end_conditions })
+    {
+      std::for_each(conditions->begin(), conditions->end(), add_condition_objects);
+    }
+    for(const std::vector<PddlEffect>* effects : { &action.at_start_effects, &action.at_end_effects })
+    {
+      for(const PddlEffect& effect : *effects)
+      {
+        if(effect.type != PddlEffect::Type::ADD && effect.type != PddlEffect::Type::DELETE)
+        {
+          used_functions.insert(effect.atom.to_string());
+          add_functions(effect.value);
+        }
+      }
+    }
+  }
+  statistics_.num_relevant_actions = relevant_actions.size();
+
+  if(is_route_pruning_enabled_)
+  {
+    std::unordered_set<std::string> graph_objects;
+    std::unordered_set<std::string> route_objects = find_route_objects_(problem, relevant_actions, static_values, graph_objects);
+    for(const std::string& object : graph_objects)
+    {
+      if(! route_objects.count(object))
+      {
+        statistics_.num_off_route_objects += relevant_objects.erase(object);
+      }
+    }
+  }
+
+  auto has_relevant_arguments = [&relevant_objects](const PddlAtom& atom)
+  {
+    return std::all_of(atom.arguments.begin(), atom.arguments.end(),
+      [&relevant_objects](const std::string& argument){ return relevant_objects.count(argument) > 0; });
+  };
+
+  PddlProblem reduced_problem;
+  reduced_problem.name = problem.name;
+  reduced_problem.domain_name = problem.domain_name;
+  reduced_problem.goals = problem.goals;
+  for(const std::pair<std::string, std::string>& object : problem.objects)
+  {
+    if(relevant_objects.count(object.first))
+    {
+      reduced_problem.objects.push_back(object);
+    }
+  }
+  for(const PddlAtom& predicate : problem.predicates)
+  {
+    const std::string key = predicate.to_string();
+    if((relevant_facts.count(key) || relevant_negated_facts.count(key)) && has_relevant_arguments(predicate))
+    {
+      reduced_problem.predicates.push_back(predicate);
+    }
+  }
+  for(const std::pair<PddlAtom, double>& function : problem.functions)
+  {
+    if(used_functions.count(function.first.to_string()) && has_relevant_arguments(function.first))
+    {
+      reduced_problem.functions.push_back(function);
+    }
+  }
+
+  statistics_.num_relevant_objects = reduced_problem.objects.size();
+  statistics_.num_relevant_predicates = reduced_problem.predicates.size();
+  statistics_.num_relevant_functions = reduced_problem.functions.size();
+  statistics_.duration_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+  return reduced_problem;
+}
+
+
+std::unordered_set<std::string> RelevanceAnalysis::find_route_objects_(
+  const PddlProblem& problem,
+  const std::vector<const DurativeAction*>& relevant_actions,
+  const std::unordered_map<std::string, double>& static_values,
+  std::unordered_set<std::string>& graph_objects)
+{
+  std::unordered_map<std::string, size_t> node_indices;
+  std::vector<std::string> nodes;
+  auto get_node = [&](const std::string& object)
+  {
+    std::unordered_map<std::string, size_t>::const_iterator it = node_indices.find(object);
+    if(it == node_indices.end())
+    {
+      it = node_indices.emplace(object, nodes.size()).first;
+      nodes.push_back(object);
+    }
+    return it->second;
+  };
+
+  // The transitions as edges, with the duration as cost when it is known
+  std::vector<std::tuple<size_t, size_t, double>> edges;
+  std::vector<const DurativeAction*> other_actions;
+  for(const DurativeAction* action : relevant_actions)
+  {
+    bool is_transition = false;
+    for(const Transition& transition : transitions_)
+    {
+      if(action->name == transition.action_name)
+      {
+        is_transition = true;
+        std::optional<double> duration_s = evaluate_static(action->duration, static_values);
+        edges.emplace_back(get_node(action->parameters[transition.from_parameter]), get_node(action->parameters[transition.to_parameter]),
+          duration_s.has_value() ? std::max(duration_s.value(), 0.0) : 1.0);
+      }
+    }
+    if(! is_transition)
+    {
+      other_actions.push_back(action);
+    }
+  }
+  graph_objects.insert(nodes.begin(), nodes.end());
+  std::vector<std::vector<std::pair<size_t, double>>> forward_edges(nodes.size());
+  for(const std::tuple<size_t, size_t, double>& edge : edges)
+  {
+    forward_edges[std::get<0>(edge)].emplace_back(std::get<1>(edge), std::get<2>(edge));
+  }
+
+  // Anchors: the nodes where the other relevant actions require a static fact, such as can_land
+  // and person_at, the nodes of the goal, and the current positions. Actions without static
+  // conditions on the node, such as takeoff, can be executed anywhere and do not anchor the routes
+  std::vector<bool> is_anchor(nodes.size(), false);
+  auto add_anchors = [&](const std::vector<std::string>& arguments)
+  {
+    for(const std::string& argument : arguments)
+    {
+      std::unordered_map<std::string, size_t>::const_iterator it = node_indices.find(argument);
+      if(it != node_indices.end())
+      {
+        is_anchor[it->second] = true;
+      }
+    }
+  };
+  for(const DurativeAction* action : other_actions)
+  {
+    for(const std::vector<PddlCondition>* conditions : { &action->at_start_conditions, &action->over_all_conditions, &action->at_end_conditions })
+    {
+      for(const PddlCondition& condition : *conditions)
+      {
+        if(condition.type == PddlCondition::Type::PREDICATE && ! fluent_names_.count(condition.predicate.name))
+        {
+          add_anchors(condition.predicate.arguments);
+        }
+      }
+    }
+  }
+  for(const PddlCondition& goal : problem.goals)
+  {
+    std::vector<PddlAtom> functions;
+    goal.lhs.collect_functions(functions);
+    goal.rhs.collect_functions(functions);
+    functions.push_back(goal.predicate);
+    for(const PddlAtom& atom : functions)
+    {
+      add_anchors(atom.arguments);
+    }
+  }
+  for(const PddlAtom& predicate : problem.predicates)
+  {
+    for(const Transition& transition : transitions_)
+    {
+      if(predicate.name == transition.position_predicate && transition.position_argument < predicate.arguments.size())
+      {
+        add_anchors({ predicate.arguments[transition.position_argument] });
+      }
+    }
+  }
+
+  std::vector<size_t> anchors;
+  for(size_t node = 0; node < nodes.size(); node++)
+  {
+    if(is_anchor[node])
+    {
+      anchors.push_back(node);
+    }
+  }
+  statistics_.num_route_anchors = anchors.size();
+
+  // The anchors are connected by the shortest routes along a minimum spanning tree over the
+  // route durations between them, as an approximate Steiner tree. Connecting every pair of anchors
+  // would keep most of a grid, where every location between two anchors is on a shortest route
+  std::vector<std::vector<double>> durations(anchors.size());
+  std::vector<std::vector<size_t>> previous(anchors.size());
+  for(size_t i = 0; i < anchors.size(); i++)
+  {
+    durations[i] = find_durations(forward_edges, anchors[i], previous[i]);
+  }
+
+  std::unordered_set<std::string> route_objects;
+  std::vector<bool> is_connected(anchors.size(), false);
+  for(size_t num_connected = 0; num_connected < anchors.size(); num_connected++)
+  {
+    // The closest anchor to the tree, or any unconnected anchor to start a new tree
+    size_t best_from = anchors.size();
+    size_t best_to = anchors.size();
+    double best_duration = std::numeric_limits<double>::infinity();
+    for(size_t i = 0; i < anchors.size(); i++)
+    {
+      for(size_t j = 0; j < anchors.size() && is_connected[i]; j++)
+      {
+        if(! is_connected[j] && durations[i][anchors[j]] < best_duration)
+        {
+          best_from = i;
+          best_to = j;
+          best_duration = durations[i][anchors[j]];
+        }
+      }
+    }
+    if(best_to == anchors.size())
+    {
+      best_to = std::find(is_connected.begin(), is_connected.end(), false) - is_connected.begin();
+    }
+    is_connected[best_to] = true;
+    route_objects.insert(nodes[anchors[best_to]]);
+    if(best_from == anchors.size())
+    {
+      continue;
+    }
+    for(size_t node = anchors[best_to]; node != anchors[best_from]; node = previous[best_from][node])
+    {
+      route_objects.insert(nodes[node]);
+    }
+  }
+  return route_objects;
+}
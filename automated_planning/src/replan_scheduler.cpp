@@ -0,0 +1,93 @@
+#include "automated_planning/replan_scheduler.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+
+void ReplanScheduler::request(ReplanTrigger trigger, double time_s, bool deferrable)
+{
+  if(trigger == ReplanTrigger::NONE)
+  {
+    return;
+  }
+  num_requests_++;
+
+  if(deferrable)
+  {
+    num_deferred_++;
+    deferred_trigger_ = std::max(deferred_trigger_, trigger);
+    return;
+  }
+
+  if(pending_trigger_ == ReplanTrigger::NONE)
+  {
+    first_request_s_ = time_s;
+  }
+  pending_trigger_ = std::max(pending_trigger_, trigger);
+  is_immediate_pending_ = is_immediate_pending_ || trigger == ReplanTrigger::EMERGENCY || trigger == ReplanTrigger::PLAN_INVALID;
+  last_request_s_ = time_s;
+  num_pending_requests_++;
+}
+
+
+ReplanTrigger ReplanScheduler::poll(double time_s, bool plan_running, double remaining_plan_s, ReplanTrigger min_trigger)
+{
+  if(pending_trigger_ != ReplanTrigger::NONE && pending_trigger_ >= min_trigger)
+  {
+    bool window_passed = (time_s - last_request_s_ >= params_.coalescing_window_s);
+    bool max_delay_passed = (time_s - first_request_s_ >= params_.max_coalescing_delay_s);
+
+    if(is_immediate_pending_ || window_passed || max_delay_passed)
+    {
+      ReplanTrigger trigger = pending_trigger_;
+      num_coalesced_ += num_pending_requests_ - 1;
+
+      // A replan for the same or a higher priority includes the goals of the deferred trigger,
+      // except for emergencies, which only consider landing safely
+      if(trigger != ReplanTrigger::EMERGENCY && trigger >= deferred_trigger_)
+      {
+        deferred_trigger_ = ReplanTrigger::NONE;
+      }
+
+      pending_trigger_ = ReplanTrigger::NONE;
+      is_immediate_pending_ = false;
+      num_pending_requests_ = 0;
+      return trigger;
+    }
+    return ReplanTrigger::NONE;
+  }
+
+  if(deferred_trigger_ != ReplanTrigger::NONE && deferred_trigger_ >= min_trigger)
+  {
+    // Replanning costs roughly the mean replan duration in hovering. Admit the trigger if the
+    // wait until the natural plan boundary is larger than both this cost and the acceptable deferral
+    double admission_threshold_s = std::max(params_.max_deferral_s, get_mean_replan_duration_s());
+    if(! plan_running || remaining_plan_s > admission_threshold_s)
+    {
+      ReplanTrigger trigger = deferred_trigger_;
+      deferred_trigger_ = ReplanTrigger::NONE;
+      return trigger;
+    }
+  }
+
+  return ReplanTrigger::NONE;
+}
+
+
+void ReplanScheduler::record_replan(double hover_time_lost_s)
+{
+  num_replans_++;
+  hover_time_lost_s_ += std::max(0.0, hover_time_lost_s);
+}
+
+
+std::string ReplanScheduler::to_string() const
+{
+  std::stringstream ss;
+  ss << "Replans: " << num_replans_
+    << " from " << num_requests_ << " triggers ("
+    << num_coalesced_ << " coalesced, "
+    << num_deferred_ << " deferred). "
+    << "Hover time lost to replanning: " << hover_time_lost_s_ << " s\n";
+  return ss.str();
+}
@@ -10,21 +10,33 @@
 
 #include "std_msgs/msg/string.hpp"
 
+#include "automated_planning/action_activation_monitor.hpp"
+#include "automated_planning/adaptive_action_executor_client.hpp"
+
 using namespace std::chrono_literals;
 
 class ResupplyActionNode 
-  : public plansys2::ActionExecutorClient
+  : public AdaptiveActionExecutorClient
 {
 public:
   ResupplyActionNode()
-  : plansys2::ActionExecutorClient("resupply_action_node", 500ms)
+  : AdaptiveActionExecutorClient("resupply_action_node", 500ms, false)
   {
     this->declare_parameter("locations.resupply_available", std::vector<std::string>());
+
+    activation_monitor_ = std::make_unique<ActionActivationMonitor>(this);
   }
 
 // Lifecycle-events
+LifecycleNodeInterface::CallbackReturn on_configure(const rclcpp_lifecycle::State & previous_state)
+{
+  activation_monitor_->start();
+  return AdaptiveActionExecutorClient::on_configure(previous_state);
+}
+
 LifecycleNodeInterface::CallbackReturn on_activate(const rclcpp_lifecycle::State &)
 {
+  ActionActivationMonitor::ActivationScope activation(*activation_monitor_);
   RCLCPP_INFO(this->get_logger(), "Trying to activate resupply");
 
   const std::string location = get_arguments()[1];
@@ -44,11 +56,13 @@ LifecycleNodeInterface::CallbackReturn on_activate(const rclcpp_lifecycle::State
   RCLCPP_WARN(this->get_logger(), "The resupply-action is not coordinated with other modules, and set to fail!"); 
   finish(false, 1.0, "Not properly implemented");
 
-  return LifecycleNode::CallbackReturn::SUCCESS;
+  return activation.succeeded(LifecycleNode::CallbackReturn::SUCCESS);
   //return ActionExecutorClient::on_activate(previous_state);
 }
 
 private:  
+  std::unique_ptr<ActionActivationMonitor> activation_monitor_;
+
   void do_work()
   {
   }
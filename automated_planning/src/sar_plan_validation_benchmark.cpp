@@ -0,0 +1,355 @@
+#include "automated_planning/compiled_domain_model.hpp"
+#include "automated_planning/pddl_domain.hpp"
+#include "automated_planning/plan_conversion.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <set>
+#include <sstream>
+
+
+namespace
+{
+  std::string read_file(const std::string& path)
+  {
+    std::ifstream file(path);
+    if(! file)
+    {
+      throw std::runtime_error("Could not open " + path);
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+  }
+
+
+  /**
+   * @brief Reads a plan as printed by PlanSys2 and POPF, with one item per line:
+   *    0.000: (move d0 h0 a0)  [10.000]
+   */
+  plansys2_msgs::msg::Plan read_plan(const std::string& path)
+  {
+    std::stringstream ss(read_file(path));
+    plansys2_msgs::msg::Plan plan;
+    std::string line;
+    while(std::getline(ss, line))
+    {
+      size_t colon = line.find(':');
+      size_t action_start = line.find('(');
+      size_t action_end = line.find(')', action_start);
+      size_t duration_start = line.find('[', action_end);
+      if(colon == std::string::npos || action_start == std::string::npos || action_end == std::string::npos || duration_start == std::string::npos)
+      {
+        continue;
+      }
+      plansys2_msgs::msg::PlanItem plan_item;
+      plan_item.time = std::stof(line.substr(0, colon));
+      plan_item.action = line.substr(action_start, action_end - action_start + 1);
+      plan_item.duration = std::stof(line.substr(duration_start + 1));
+      plan.items.push_back(plan_item);
+    }
+    return plan;
+  }
+
+
+  /**
+   * @brief Shortest paths by the move duration, as the previous location of each location
+   */
+  std::map<std::string, std::string> find_shortest_paths(
+    const std::map<std::string, std::vector<std::pair<std::string, double>>>& paths,
+    const std::string& start,
+    std::map<std::string, double>& durations_s)
+  {
+    std::map<std::string, std::string> previous;
+    std::set<std::pair<double, std::string>> queue = { { 0.0, start } };
+    durations_s = { { start, 0.0 } };
+    while(! queue.empty())
+    {
+      std::pair<double, std::string> current = *queue.begin();
+      queue.erase(queue.begin());
+      std::map<std::string, std::vector<std::pair<std::string, double>>>::const_iterator it = paths.find(current.second);
+      if(it == paths.end())
+      {
+        continue;
+      }
+      for(const std::pair<std::string, double>& path : it->second)
+      {
+        double duration_s = current.first + path.second;
+        std::map<std::string, double>::iterator duration_it = durations_s.find(path.first);
+        if(duration_it == durations_s.end() || duration_s < duration_it->second)
+        {
+          if(duration_it != durations_s.end())
+          {
+            queue.erase({ duration_it->second, path.first });
+          }
+          durations_s[path.first] = duration_s;
+          previous[path.first] = current.second;
+          queue.insert({ duration_s, path.first });
+        }
+      }
+    }
+    return previous;
+  }
+
+
+  /**
+   * @brief Makes a search plan for the problem, as a benchmark when no plan is given. The drone
+   * searches the closest unsearched location for as long as it can return and land with the
+   * battery required by the domain, which is checked by validating each extension of the plan
+   */
+  plansys2_msgs::msg::Plan make_search_plan(SarDomainModel& model, const PddlProblem& problem)
+  {
+    std::string drone;
+    std::string start_location;
+    bool is_landed = false;
+    std::set<std::string> landing_locations;
+    std::map<std::string, std::vector<std::pair<std::string, double>>> paths;
+    std::map<std::string, double> functions;
+
+    for(const std::pair<PddlAtom, double>& function : problem.functions)
+    {
+      functions[function.first.to_string()] = function.second;
+    }
+    for(const PddlAtom& predicate : problem.predicates)
+    {
+      if(predicate.name == "drone_at" && predicate.arguments.size() == 2 && drone.empty())
+      {
+        drone = predicate.arguments[0];
+        start_location = predicate.arguments[1];
+      }
+      else if(predicate.name == "landed")
+      {
+        is_landed = true;
+      }
+      else if(predicate.name == "can_land" && predicate.arguments.size() == 1)
+      {
+        landing_locations.insert(predicate.arguments[0]);
+      }
+      else if(predicate.name == "path" && predicate.arguments.size() == 2)
+      {
+        std::string move_duration = "(move_duration " + predicate.arguments[0] + " " + predicate.arguments[1] + ")";
+        paths[predicate.arguments[0]].emplace_back(predicate.arguments[1], functions.count(move_duration) ? functions[move_duration] : 1.0);
+      }
+    }
+    if(drone.empty())
+    {
+      throw std::runtime_error("The problem has no drone_at");
+    }
+
+    // Lands where the goal requires the drone to be, if possible
+    std::string goal_location;
+    for(const PddlCondition& goal : problem.goals)
+    {
+      if(goal.type == PddlCondition::Type::PREDICATE && goal.predicate.name == "drone_at" && goal.predicate.arguments.size() == 2
+        && goal.predicate.arguments[0] == drone && landing_locations.count(goal.predicate.arguments[1]))
+      {
+        goal_location = goal.predicate.arguments[1];
+      }
+    }
+
+    std::vector<PlannedAction> plan;
+    double time_s = 0.0;
+    auto append = [&time_s](std::vector<PlannedAction>& items, const std::string& action, double duration_s)
+    {
+      items.push_back({ action, time_s, duration_s });
+      // Same separation as POPF
+      time_s += duration_s + 0.001;
+    };
+    auto append_moves = [&](std::vector<PlannedAction>& items, const std::string& from, const std::string& to)
+    {
+      std::map<std::string, double> durations_s;
+      std::map<std::string, std::string> previous = find_shortest_paths(paths, from, durations_s);
+      std::vector<std::string> route = { to };
+      while(route.back() != from)
+      {
+        route.push_back(previous.at(route.back()));
+      }
+      for(size_t i = route.size() - 1; i > 0; i--)
+      {
+        append(items, "(move " + drone + " " + route[i] + " " + route[i - 1] + ")", functions.at("(move_duration " + route[i] + " " + route[i - 1] + ")"));
+      }
+    };
+    auto append_search = [&](std::vector<PlannedAction>& items, const std::string& location)
+    {
+      append(items, "(search " + drone + " " + location + ")", functions.at("(search_duration " + location + ")"));
+    };
+    auto append_return = [&](std::vector<PlannedAction>& items, const std::string& from, const std::set<std::string>& searched)
+    {
+      std::map<std::string, double> durations_s;
+      find_shortest_paths(paths, from, durations_s);
+      std::string landing_location;
+      double min_duration_s = std::numeric_limits<double>::infinity();
+      for(const std::string& location : landing_locations)
+      {
+        if(durations_s.count(location) && durations_s[location] < min_duration_s)
+        {
+          min_duration_s = durations_s[location];
+          landing_location = location;
+        }
+      }
+      if(durations_s.count(goal_location))
+      {
+        landing_location = goal_location;
+      }
+      if(landing_location.empty())
+      {
+        return false;
+      }
+      append_moves(items, from, landing_location);
+      if(! searched.count(landing_location))
+      {
+        append_search(items, landing_location);
+      }
+      append(items, "(land " + drone + " " + landing_location + ")", 10.0);
+      return true;
+    };
+
+    if(is_landed)
+    {
+      append(plan, "(takeoff " + drone + " " + start_location + ")", 5.0);
+    }
+
+    std::string location = start_location;
+    std::set<std::string> searched;
+    while(true)
+    {
+      std::map<std::string, double> durations_s;
+      find_shortest_paths(paths, location, durations_s);
+      std::string target;
+      double min_duration_s = std::numeric_limits<double>::infinity();
+      for(const std::pair<const std::string, double>& duration_s : durations_s)
+      {
+        if(! searched.count(duration_s.first) && duration_s.second < min_duration_s)
+        {
+          min_duration_s = duration_s.second;
+          target = duration_s.first;
+        }
+      }
+      if(target.empty())
+      {
+        break;
+      }
+
+      const double start_time_s = time_s;
+      std::vector<PlannedAction> extended_plan = plan;
+      append_moves(extended_plan, location, target);
+      append_search(extended_plan, target);
+      const double search_end_time_s = time_s;
+      std::set<std::string> extended_searched = searched;
+      extended_searched.insert(target);
+
+      std::vector<PlannedAction> returning_plan = extended_plan;
+      bool can_return = append_return(returning_plan, target, extended_searched);
+      SarDomainModel::CompiledPlan compiled_plan = model.compile_plan(returning_plan);
+      SarDomainModel::State initial_state = model.make_state(problem.predicates, problem.functions);
+      if(! can_return || ! model.validate(compiled_plan, initial_state).is_valid)
+      {
+        time_s = start_time_s;
+        break;
+      }
+      plan = extended_plan;
+      searched = extended_searched;
+      location = target;
+      time_s = search_end_time_s;
+    }
+    append_return(plan, location, searched);
+
+    return to_plan_msg(plan);
+  }
+
+
+  template<typename Function>
+  double measure_rate(size_t num_iterations, Function function)
+  {
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < num_iterations; i++)
+    {
+      function();
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start_time;
+    return num_iterations / duration.count();
+  }
+}
+
+
+int main(int argc, char ** argv)
+{
+  // Usage: sar_plan_validation_benchmark <domain> <problem> [plan] [--iterations N]
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::vector<std::string> paths;
+  size_t num_iterations = 100000;
+  for(size_t i = 0; i < args.size(); i++)
+  {
+    if(args[i] == "--iterations" && i + 1 < args.size())
+    {
+      num_iterations = std::stoul(args[++i]);
+    }
+    else
+    {
+      paths.push_back(args[i]);
+    }
+  }
+  if(paths.size() < 2 || paths.size() > 3)
+  {
+    std::cerr << "Usage: sar_plan_validation_benchmark <domain> <problem> [plan] [--iterations N]" << std::endl;
+    return 1;
+  }
+
+  try
+  {
+    std::shared_ptr<const PddlDomain> domain = std::make_shared<const PddlDomain>(PddlDomain::parse(read_file(paths[0])));
+    PddlProblem problem = PddlProblem::parse(read_file(paths[1]));
+    SarDomainModel model(domain);
+
+    plansys2_msgs::msg::Plan plan_msg = (paths.size() == 3) ? read_plan(paths[2]) : make_search_plan(model, problem);
+    std::vector<PlannedAction> plan = to_planned_actions(plan_msg);
+    SarDomainModel::CompiledPlan compiled_plan = model.compile_plan(plan);
+    SarDomainModel::CompiledGoal goal = model.compile_goal(problem.goals);
+    SarDomainModel::State initial_state = model.make_state(problem.predicates, problem.functions);
+
+    SarDomainModel::ValidationResult result = model.validate(compiled_plan, initial_state, 1e-2);
+    std::cout << "Plan:\n";
+    for(const PlannedAction& planned_action : plan)
+    {
+      std::cout << "  " << std::fixed << std::setprecision(3) << planned_action.start_s << ": " << planned_action.action << " [" << planned_action.duration_s << "]\n";
+    }
+    std::cout << model.describe(result, compiled_plan) << "\n";
+    std::cout << "Goal " << (model.is_satisfied(goal, result.final_state) ? "satisfied" : "not satisfied") << "\n";
+    std::optional<double> battery_charge = model.get_function(result.final_state, "(battery_charge d0)");
+    if(battery_charge)
+    {
+      std::cout << "Final battery charge " << battery_charge.value() << "\n";
+    }
+    std::cout << plan.size() << " plan items, " << model.get_num_ground_actions() << " ground actions, "
+      << model.get_num_facts() << " facts, " << model.get_num_functions() << " functions\n";
+
+    size_t num_valid = 0;
+    double validation_rate = measure_rate(num_iterations, [&]()
+    {
+      num_valid += model.validate(compiled_plan, initial_state, 1e-2).is_valid;
+    });
+    double simulation_rate = measure_rate(num_iterations, [&]()
+    {
+      num_valid += model.is_satisfied(goal, model.simulate(compiled_plan, initial_state));
+    });
+    double compilation_rate = measure_rate(std::max<size_t>(num_iterations / 10, 1), [&]()
+    {
+      num_valid += model.compile_plan(to_planned_actions(plan_msg)).events.size() > 0;
+    });
+    std::cout << std::setprecision(0)
+      << "Validations: " << validation_rate << " plans/s\n"
+      << "Simulations with goal check: " << simulation_rate << " plans/s\n"
+      << "Compilations of known actions: " << compilation_rate << " plans/s\n"
+      << "(" << num_valid << " valid)" << std::endl;
+  }
+  catch(const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,518 @@
+#include "automated_planning/compiled_domain_model.hpp"
+#include "automated_planning/native_planner.hpp"
+#include "automated_planning/pddl_domain.hpp"
+#include "automated_planning/relevance_analysis.hpp"
+#include "automated_planning/warm_planner_pool.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+
+namespace
+{
+  // The synthetic maps have more facts than the SAR-problems of the controller
+  using BenchmarkDomainModel = CompiledDomainModel<4096, 512>;
+
+
+  struct BenchmarkOptions
+  {
+    size_t num_repetitions{ 20 };
+    bool is_relevance_enabled{ false };
+    bool is_route_pruning_enabled{ true };
+    bool is_soft_goals_enabled{ false };
+    bool is_plan_printed{ true };
+  };
+
+
+  std::string read_file(const std::string& path)
+  {
+    std::ifstream file(path);
+    if(! file)
+    {
+      throw std::runtime_error("Could not open " + path);
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+  }
+
+
+  double get_elapsed_s(std::chrono::steady_clock::time_point start_time)
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+  }
+
+
+  /**
+   * @brief Replaces every {domain} and {problem} in the command with the paths
+   */
+  std::string format_command(std::string command, const std::string& domain_path, const std::string& problem_path)
+  {
+    const std::vector<std::pair<std::string, std::string>> replacements = {
+      { "{domain}", domain_path }, { "{problem}", problem_path }
+    };
+    for(const std::pair<std::string, std::string>& replacement : replacements)
+    {
+      for(size_t pos = command.find(replacement.first); pos != std::string::npos; pos = command.find(replacement.first, pos))
+      {
+        command.replace(pos, replacement.first.size(), replacement.second);
+        pos += replacement.second.size();
+      }
+    }
+    return command;
+  }
+
+
+  /**
+   * @brief Square grid of about @p num_locations locations with paths to the four neighbours, as
+   * written by the mission controller. The drone is landed at the helipad h0 in one corner, and a
+   * second helipad h1 is in the opposite corner. Five persons are placed on the map
+   *
+   * @param goal  "land": take off and land at h1. "search": search three areas far from h0 and
+   *              return. "rescue": rescue one of the persons and return
+   */
+  PddlProblem make_synthetic_problem(size_t num_locations, const std::string& goal)
+  {
+    const size_t side = std::max<size_t>(static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(num_locations)))), 2);
+    auto name = [side](size_t row, size_t column)
+    {
+      if(row == 0 && column == 0)
+      {
+        return std::string("h0");
+      }
+      if(row == side - 1 && column == side - 1)
+      {
+        return std::string("h1");
+      }
+      return "a" + std::to_string(row * side + column);
+    };
+    auto atom = [](const std::string& predicate, const std::vector<std::string>& arguments){ return PddlAtom{ predicate, arguments }; };
+
+    PddlProblem problem;
+    problem.name = "synthetic_" + goal + "_" + std::to_string(side * side);
+    problem.domain_name = "search_and_rescue";
+    problem.objects.emplace_back("d0", "drone");
+    for(size_t i = 0; i < 5; i++)
+    {
+      problem.objects.emplace_back("p" + std::to_string(i), "person");
+    }
+    for(size_t row = 0; row < side; row++)
+    {
+      for(size_t column = 0; column < side; column++)
+      {
+        const std::string location = name(row, column);
+        problem.objects.emplace_back(location, "location");
+        problem.predicates.push_back(atom("not_searched", { location }));
+        problem.functions.emplace_back(atom("search_distance", { location }), 19.0);
+        problem.functions.emplace_back(atom("search_duration", { location }), 95.0);
+        if(location != "h0")
+        {
+          problem.predicates.push_back(atom("available", { location }));
+        }
+        const std::vector<std::pair<int, int>> offsets = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+        for(const std::pair<int, int>& offset : offsets)
+        {
+          const int neighbour_row = static_cast<int>(row) + offset.first;
+          const int neighbour_column = static_cast<int>(column) + offset.second;
+          if(neighbour_row < 0 || neighbour_column < 0 || neighbour_row >= static_cast<int>(side) || neighbour_column >= static_cast<int>(side))
+          {
+            continue;
+          }
+          const std::string neighbour = name(neighbour_row, neighbour_column);
+          problem.predicates.push_back(atom("path", { location, neighbour }));
+          problem.functions.emplace_back(atom("distance", { location, neighbour }), 20.0);
+          problem.functions.emplace_back(atom("move_duration", { location, neighbour }), 10.0);
+        }
+      }
+    }
+    for(const char* helipad : { "h0", "h1" })
+    {
+      for(const char* predicate : { "can_land", "can_recharge", "can_resupply" })
+      {
+        problem.predicates.push_back(atom(predicate, { helipad }));
+      }
+    }
+    for(const char* predicate : { "landed", "not_moving", "not_searching", "not_tracking", "not_rescuing", "not_marking" })
+    {
+      problem.predicates.push_back(atom(predicate, { "d0" }));
+    }
+    problem.predicates.push_back(atom("drone_at", { "d0", "h0" }));
+
+    std::vector<std::string> person_locations;
+    for(size_t i = 0; i < 5; i++)
+    {
+      const std::string person = "p" + std::to_string(i);
+      person_locations.push_back(name((i + 1) * side / 7, side - 1 - (i * side) / 6));
+      problem.predicates.push_back(atom("person_at", { person, person_locations.back() }));
+      problem.predicates.push_back(atom("not_tracked", { person }));
+      for(const char* predicate : { "not_communicated", "not_marked", "not_rescued" })
+      {
+        problem.predicates.push_back(atom(predicate, { person, person_locations.back() }));
+      }
+    }
+
+    const std::vector<std::pair<std::string, double>> drone_functions = {
+      { "track_battery_usage", 0.05896 }, { "move_battery_usage", 0.06201 }, { "track_velocity", 0.2 }, { "move_velocity", 2.0 },
+      { "num_markers", 2.0 }, { "num_lifevests", 1.0 }, { "battery_charge", 100.0 }
+    };
+    for(const std::pair<std::string, double>& function : drone_functions)
+    {
+      problem.functions.emplace_back(atom(function.first, { "d0" }), function.second);
+    }
+
+    auto add_goal = [&problem](const PddlAtom& predicate)
+    {
+      PddlCondition condition;
+      condition.predicate = predicate;
+      problem.goals.push_back(condition);
+    };
+    std::string landing_location = "h0";
+    if(goal == "land")
+    {
+      landing_location = "h1";
+    }
+    else if(goal == "search")
+    {
+      for(const std::string& location : { name(side / 2, side - 1), name(side - 1, side / 2), name(side / 2, side / 2) })
+      {
+        add_goal(atom("searched", { location }));
+      }
+    }
+    else if(goal == "rescue")
+    {
+      for(const char* predicate : { "communicated", "marked", "rescued" })
+      {
+        add_goal(atom(predicate, { "p2", person_locations[2] }));
+      }
+    }
+    else
+    {
+      throw std::runtime_error("Unknown synthetic goal " + goal);
+    }
+    add_goal(atom("landed", { "d0" }));
+    add_goal(atom("drone_at", { "d0", landing_location }));
+    return problem;
+  }
+
+
+  /**
+   * @brief Compares planning with a warm worker, which keeps the parsed domain and the grounding,
+   * with starting a worker for each call, which like the PlanSys2 planner plugins starts a process
+   * and parses the domain every time. The overhead is the time of a call outside of the handling
+   * of the problem in the worker
+   */
+  bool benchmark_warm_pool(const std::vector<std::string>& worker_command, const std::string& domain_str, const PddlProblem& problem, size_t num_repetitions)
+  {
+    const std::string problem_str = problem.to_string();
+    std::string message;
+
+    WarmPlannerPoolStatistics cold_statistics;
+    for(size_t i = 0; i < num_repetitions; i++)
+    {
+      WarmPlannerPool pool(worker_command, 1, 60.0);
+      if(! pool.plan(domain_str, problem_str, message).has_value())
+      {
+        // Only a failed worker fails the benchmark, as the problem may have no plan
+        std::cout << "  Cold worker: no plan: " << message << "\n";
+        return pool.get_statistics().num_failed_workers == 0;
+      }
+      WarmPlannerPoolStatistics statistics = pool.get_statistics();
+      cold_statistics.num_calls += statistics.num_calls;
+      cold_statistics.call_duration_s += statistics.call_duration_s;
+      cold_statistics.worker_duration_s += statistics.worker_duration_s;
+    }
+
+    // The first call sends the domain, and is not measured
+    WarmPlannerPool pool(worker_command, 1, 60.0);
+    pool.start();
+    if(! pool.plan(domain_str, problem_str, message).has_value())
+    {
+      std::cout << "  Warm pool: no plan: " << message << "\n";
+      return pool.get_statistics().num_failed_workers == 0;
+    }
+    WarmPlannerPoolStatistics first_statistics = pool.get_statistics();
+    for(size_t i = 0; i < num_repetitions; i++)
+    {
+      pool.plan(domain_str, problem_str, message);
+    }
+    WarmPlannerPoolStatistics warm_statistics = pool.get_statistics();
+    warm_statistics.num_calls -= first_statistics.num_calls;
+    warm_statistics.call_duration_s -= first_statistics.call_duration_s;
+    warm_statistics.worker_duration_s -= first_statistics.worker_duration_s;
+
+    std::cout << "  Cold worker: " << 1e3 * cold_statistics.call_duration_s / num_repetitions << " ms per call, "
+      << 1e3 * cold_statistics.get_overhead_per_call_s() << " ms outside the problem\n";
+    std::cout << "  Warm pool:   " << 1e3 * warm_statistics.call_duration_s / num_repetitions << " ms per call, "
+      << 1e3 * warm_statistics.get_overhead_per_call_s() << " ms outside the problem\n";
+    return true;
+  }
+
+
+  /**
+   * @brief Plans with a new planner, as after a change of the objects, and with repetitions which
+   * reuse the grounding as the controller does between replans
+   *
+   * @return Whether the plan is valid and reaches the goal of @p full_problem, or std::nullopt if
+   * no plan was found
+   */
+  std::optional<bool> benchmark_native_planner(
+    const std::string& label,
+    std::shared_ptr<const PddlDomain> domain,
+    const PddlProblem& problem,
+    const PddlProblem& full_problem,
+    BenchmarkDomainModel& model,
+    const BenchmarkOptions& options,
+    double preprocessing_duration_s=0.0)
+  {
+    NativePlanner planner(domain);
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    std::optional<std::vector<PlannedAction>> plan = planner.solve(problem);
+    const double cold_duration_s = get_elapsed_s(start_time) + preprocessing_duration_s;
+    std::cout << "  " << label << ": " << planner.get_statistics().to_string() << "\n";
+
+    double warm_duration_s = 0.0;
+    for(size_t repetition = 0; repetition < options.num_repetitions; repetition++)
+    {
+      start_time = std::chrono::steady_clock::now();
+      planner.solve(problem);
+      warm_duration_s += get_elapsed_s(start_time);
+    }
+    warm_duration_s = warm_duration_s / options.num_repetitions + preprocessing_duration_s;
+
+    std::cout << std::fixed << std::setprecision(3)
+      << "  " << label << ": " << 1e3 * cold_duration_s << " ms cold, " << 1e3 * warm_duration_s << " ms warm\n";
+    if(! plan)
+    {
+      std::cout << "  No plan found\n";
+      return std::nullopt;
+    }
+
+    // The plan of a reduced problem is validated against the full problem
+    BenchmarkDomainModel::CompiledPlan compiled_plan = model.compile_plan(plan.value());
+    BenchmarkDomainModel::ValidationResult result = model.validate(compiled_plan, model.make_state(full_problem.predicates, full_problem.functions));
+    const bool is_goal_satisfied = model.is_satisfied(model.compile_goal(full_problem.goals), result.final_state);
+    std::cout << "  " << plan->size() << " actions, makespan " << compiled_plan.makespan_s << " s, "
+      << (result.is_valid ? "valid" : "invalid") << ", goal " << (is_goal_satisfied ? "satisfied" : "not satisfied") << "\n";
+    if(options.is_plan_printed)
+    {
+      for(const PlannedAction& planned_action : plan.value())
+      {
+        std::cout << "    " << planned_action.start_s << ": " << planned_action.action << " [" << planned_action.duration_s << "]\n";
+      }
+    }
+    if(! result.is_valid || ! is_goal_satisfied)
+    {
+      std::cout << "  " << model.describe(result, compiled_plan) << "\n";
+      return false;
+    }
+    return true;
+  }
+
+
+  /**
+   * @brief Relaxes the goals as the mission controller does. The landed-goals are hard, and the
+   * other goals are soft with unit utility. Compares the relaxation with one search for each soft
+   * goal and one for the valid subset, with a single search with soft goals
+   *
+   * @return Whether the plan with soft goals was invalid, or achieved fewer goals than the relaxation
+   */
+  bool benchmark_soft_goals(std::shared_ptr<const PddlDomain> domain, const PddlProblem& problem, BenchmarkDomainModel& model)
+  {
+    PddlProblem hard_problem = problem;
+    hard_problem.goals.clear();
+    std::vector<SoftGoal> soft_goals;
+    for(const PddlCondition& goal : problem.goals)
+    {
+      if(goal.type == PddlCondition::Type::PREDICATE && goal.predicate.name != "landed" && goal.predicate.name != "not_landed")
+      {
+        soft_goals.push_back({ goal.predicate, 1.0 });
+      }
+      else
+      {
+        hard_problem.goals.push_back(goal);
+      }
+    }
+
+    // One planner for each relaxation, such that the grounding is shared as between replans
+    NativePlanner planner(domain);
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    PddlProblem relaxed_problem = hard_problem;
+    std::vector<PddlCondition> valid_goals;
+    for(const SoftGoal& soft_goal : soft_goals)
+    {
+      PddlCondition condition;
+      condition.predicate = soft_goal.predicate;
+      relaxed_problem.goals = hard_problem.goals;
+      relaxed_problem.goals.push_back(condition);
+      if(planner.solve(relaxed_problem))
+      {
+        valid_goals.push_back(condition);
+      }
+    }
+    relaxed_problem.goals = hard_problem.goals;
+    relaxed_problem.goals.insert(relaxed_problem.goals.end(), valid_goals.begin(), valid_goals.end());
+    const bool is_relaxed_solved = ! valid_goals.empty() && planner.solve(relaxed_problem).has_value();
+    std::cout << std::fixed << std::setprecision(3) << "  Relaxation: " << 1e3 * get_elapsed_s(start_time) << " ms, "
+      << soft_goals.size() + 1 << " searches, " << valid_goals.size() << "/" << soft_goals.size() << " goals valid, "
+      << (is_relaxed_solved ? "solved" : "not solved") << "\n";
+
+    NativePlanner soft_goal_planner(domain);
+    start_time = std::chrono::steady_clock::now();
+    std::optional<std::vector<PlannedAction>> plan = soft_goal_planner.solve(hard_problem, soft_goals);
+    std::cout << "  Soft goals: " << 1e3 * get_elapsed_s(start_time) << " ms, " << soft_goal_planner.get_statistics().to_string() << "\n";
+    if(! plan)
+    {
+      std::cout << "  No plan found\n";
+      return is_relaxed_solved;
+    }
+
+    BenchmarkDomainModel::CompiledPlan compiled_plan = model.compile_plan(plan.value());
+    BenchmarkDomainModel::ValidationResult result = model.validate(compiled_plan, model.make_state(problem.predicates, problem.functions));
+    const bool is_goal_satisfied = model.is_satisfied(model.compile_goal(hard_problem.goals), result.final_state);
+    std::cout << "  " << plan->size() << " actions, makespan " << compiled_plan.makespan_s << " s, "
+      << (result.is_valid ? "valid" : "invalid") << ", hard goals " << (is_goal_satisfied ? "satisfied" : "not satisfied") << "\n";
+    return ! result.is_valid || ! is_goal_satisfied
+      || (is_relaxed_solved && soft_goal_planner.get_statistics().num_achieved_soft_goals < valid_goals.size());
+  }
+
+
+  /**
+   * @return Whether a plan was invalid, or the reduced problem had no plan while the full problem had
+   */
+  bool benchmark_problem(std::shared_ptr<const PddlDomain> domain, const PddlProblem& problem, const BenchmarkOptions& options)
+  {
+    BenchmarkDomainModel model(domain);
+    if(options.is_soft_goals_enabled)
+    {
+      return benchmark_soft_goals(domain, problem, model);
+    }
+    const std::optional<bool> is_valid = benchmark_native_planner("Full", domain, problem, problem, model, options);
+    if(! options.is_relevance_enabled)
+    {
+      return is_valid == false;
+    }
+
+    RelevanceAnalysis relevance_analysis(domain, options.is_route_pruning_enabled);
+    PddlProblem reduced_problem = relevance_analysis.reduce(problem);
+    std::cout << "  " << relevance_analysis.get_statistics().to_string() << "\n";
+    const std::optional<bool> is_reduced_valid = benchmark_native_planner(
+      "Reduced", domain, reduced_problem, problem, model, options, relevance_analysis.get_statistics().duration_s);
+    return is_valid == false || is_reduced_valid == false || (is_valid.has_value() && ! is_reduced_valid.has_value());
+  }
+}
+
+
+int main(int argc, char ** argv)
+{
+  // Usage: sar_planner_benchmark <domain> [problem]... [--synthetic N]... [--relevance] [--no-route-pruning]
+  //    [--soft-goals] [--repetitions N] [--external "<command>"] [--warm-pool "<worker command>"]
+  // --synthetic adds grid maps with N locations and land, search and rescue goals. --relevance
+  // compares with the problem reduced by the relevance analysis. --soft-goals compares relaxing the
+  // goals one search at a time, as the controller did, with a single search with soft goals. The external command is run
+  // through the shell for each problem file, with {domain} and {problem} replaced by the paths,
+  // for example --external "ros2 run popf popf {domain} {problem}". --warm-pool compares the
+  // overhead of a call to a warm sar_planner_worker with starting the worker for each call
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::vector<std::string> paths;
+  std::vector<size_t> synthetic_sizes;
+  BenchmarkOptions options;
+  std::string external_command;
+  std::vector<std::string> worker_command;
+  for(size_t i = 0; i < args.size(); i++)
+  {
+    if(args[i] == "--repetitions" && i + 1 < args.size())
+    {
+      options.num_repetitions = std::max<size_t>(std::stoul(args[++i]), 1);
+    }
+    else if(args[i] == "--external" && i + 1 < args.size())
+    {
+      external_command = args[++i];
+    }
+    else if(args[i] == "--warm-pool" && i + 1 < args.size())
+    {
+      std::stringstream ss(args[++i]);
+      std::string argument;
+      while(ss >> argument)
+      {
+        worker_command.push_back(argument);
+      }
+    }
+    else if(args[i] == "--synthetic" && i + 1 < args.size())
+    {
+      synthetic_sizes.push_back(std::stoul(args[++i]));
+    }
+    else if(args[i] == "--relevance")
+    {
+      options.is_relevance_enabled = true;
+    }
+    else if(args[i] == "--no-route-pruning")
+    {
+      options.is_route_pruning_enabled = false;
+    }
+    else if(args[i] == "--soft-goals")
+    {
+      options.is_soft_goals_enabled = true;
+    }
+    else
+    {
+      paths.push_back(args[i]);
+    }
+  }
+  if(paths.empty() || (paths.size() < 2 && synthetic_sizes.empty()))
+  {
+    std::cerr << "Usage: sar_planner_benchmark <domain> [problem]... [--synthetic N]... [--relevance] [--no-route-pruning] "
+      << "[--soft-goals] [--repetitions N] [--external \"<command>\"] [--warm-pool \"<worker command>\"]" << std::endl;
+    return 1;
+  }
+
+  int exit_code = 0;
+  try
+  {
+    const std::string domain_str = read_file(paths[0]);
+    std::shared_ptr<const PddlDomain> domain = std::make_shared<const PddlDomain>(PddlDomain::parse(domain_str));
+
+    for(size_t i = 1; i < paths.size(); i++)
+    {
+      std::cout << paths[i] << "\n";
+      PddlProblem problem = PddlProblem::parse(read_file(paths[i]));
+      exit_code |= benchmark_problem(domain, problem, options);
+
+      if(! worker_command.empty() && ! benchmark_warm_pool(worker_command, domain_str, problem, options.num_repetitions))
+      {
+        exit_code = 1;
+      }
+      if(! external_command.empty())
+      {
+        const std::string command = format_command(external_command, paths[0], paths[i]) + " > /dev/null";
+        std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+        const int status = std::system(command.c_str());
+        std::cout << "  External: " << 1e3 * get_elapsed_s(start_time) << " ms, exit status " << status << "\n";
+      }
+    }
+
+    BenchmarkOptions synthetic_options = options;
+    synthetic_options.is_plan_printed = false;
+    for(size_t num_locations : synthetic_sizes)
+    {
+      for(const char* goal : { "land", "search", "rescue" })
+      {
+        PddlProblem problem = make_synthetic_problem(num_locations, goal);
+        std::cout << problem.name << "\n";
+        exit_code |= benchmark_problem(domain, problem, synthetic_options);
+      }
+    }
+    std::cout << std::flush;
+  }
+  catch(const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return exit_code;
+}
@@ -0,0 +1,165 @@
+#include "automated_planning/native_planner.hpp"
+#include "automated_planning/pddl_domain.hpp"
+#include "automated_planning/relevance_analysis.hpp"
+#include "automated_planning/warm_planner_pool.hpp"
+
+#include <unistd.h>
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+
+namespace
+{
+  struct WorkerOptions
+  {
+    size_t max_expansions{ 200000 };
+    double timeout_s{ 10.0 };
+    bool is_relevance_enabled{ true };
+    bool is_route_pruning_enabled{ true };
+  };
+
+
+  bool respond(const std::string& type, const std::string& payload, double duration_s)
+  {
+    std::stringstream ss;
+    ss << std::setprecision(9) << type << " " << payload.size() << " " << duration_s << "\n" << payload;
+    return write_all(STDOUT_FILENO, ss.str());
+  }
+
+
+  std::string to_payload(const std::vector<PlannedAction>& plan)
+  {
+    std::stringstream ss;
+    ss << std::setprecision(9);
+    for(const PlannedAction& planned_action : plan)
+    {
+      ss << planned_action.start_s << " " << planned_action.duration_s << " " << planned_action.action << "\n";
+    }
+    return ss.str();
+  }
+}
+
+
+int main(int argc, char ** argv)
+{
+  // Usage: sar_planner_worker [--max-expansions N] [--timeout S] [--no-relevance] [--no-route-pruning]
+  // Started by WarmPlannerPool, which sends the domain and the problems on stdin, and receives
+  // the plans on stdout. The worker exits at the end of stdin. Diagnostics are written to stderr
+  std::vector<std::string> args(argv + 1, argv + argc);
+  WorkerOptions options;
+  for(size_t i = 0; i < args.size(); i++)
+  {
+    if(args[i] == "--max-expansions" && i + 1 < args.size())
+    {
+      options.max_expansions = std::stoul(args[++i]);
+    }
+    else if(args[i] == "--timeout" && i + 1 < args.size())
+    {
+      options.timeout_s = std::stod(args[++i]);
+    }
+    else if(args[i] == "--no-relevance")
+    {
+      options.is_relevance_enabled = false;
+    }
+    else if(args[i] == "--no-route-pruning")
+    {
+      options.is_route_pruning_enabled = false;
+    }
+    else
+    {
+      std::cerr << "Usage: sar_planner_worker [--max-expansions N] [--timeout S] [--no-relevance] [--no-route-pruning]" << std::endl;
+      return 1;
+    }
+  }
+
+  // Kept between the problems, such that the domain is only parsed when it changes, and the
+  // grounding of the planner is reused while the objects are unchanged
+  std::shared_ptr<const PddlDomain> domain;
+  std::unique_ptr<NativePlanner> planner;
+  std::unique_ptr<RelevanceAnalysis> relevance_analysis;
+  std::string domain_error;
+
+  std::string header;
+  std::string payload;
+  while(read_message_part(STDIN_FILENO, 0, header))
+  {
+    std::stringstream header_ss(header);
+    std::string type;
+    size_t size;
+    if(! (header_ss >> type >> size) || ! read_message_part(STDIN_FILENO, size, payload))
+    {
+      std::cerr << "sar_planner_worker: invalid request " << header << std::endl;
+      return 1;
+    }
+
+    const double start_time_s = get_steady_time_s();
+    if(type == "DOMAIN")
+    {
+      // Answered together with the next problem
+      planner.reset();
+      relevance_analysis.reset();
+      try
+      {
+        domain = std::make_shared<const PddlDomain>(PddlDomain::parse(payload));
+        planner = std::make_unique<NativePlanner>(domain, options.max_expansions, options.timeout_s);
+        if(options.is_relevance_enabled)
+        {
+          relevance_analysis = std::make_unique<RelevanceAnalysis>(domain, options.is_route_pruning_enabled);
+        }
+        domain_error.clear();
+      }
+      catch(const std::runtime_error& e)
+      {
+        domain_error = std::string("Could not parse the domain: ") + e.what();
+      }
+      continue;
+    }
+    if(type != "PROBLEM")
+    {
+      std::cerr << "sar_planner_worker: unknown request " << type << std::endl;
+      return 1;
+    }
+
+    std::optional<std::vector<PlannedAction>> plan;
+    std::string error;
+    if(! planner)
+    {
+      error = domain_error.empty() ? "No domain has been sent" : domain_error;
+    }
+    else
+    {
+      try
+      {
+        PddlProblem problem = PddlProblem::parse(payload);
+        // A plan for the reduced problem is a plan for the full problem, as the objects keep their names
+        if(relevance_analysis)
+        {
+          plan = planner->solve(relevance_analysis->reduce(problem));
+        }
+        if(! plan.has_value())
+        {
+          plan = planner->solve(problem);
+        }
+        if(! plan.has_value())
+        {
+          error = "No plan found: " + planner->get_statistics().to_string();
+        }
+      }
+      catch(const std::runtime_error& e)
+      {
+        error = e.what();
+      }
+    }
+
+    const double duration_s = get_steady_time_s() - start_time_s;
+    const bool is_sent = plan.has_value() ? respond("PLAN", to_payload(plan.value()), duration_s) : respond("NONE", error, duration_s);
+    if(! is_sent)
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -4,12 +4,21 @@
 void SearchActionNode::init()
 {
   init_locations_();
-  get_search_positions_();
+  request_search_positions_();
+}
+
+
+LifecycleNodeInterface::CallbackReturn SearchActionNode::on_configure(const rclcpp_lifecycle::State & previous_state)
+{
+  activation_monitor_->start();
+  completion_pub_->start();
+  return AdaptiveActionExecutorClient::on_configure(previous_state);
 }
 
 
 LifecycleNodeInterface::CallbackReturn SearchActionNode::on_activate(const rclcpp_lifecycle::State & previous_state)
 {
+  ActionActivationMonitor::ActivationScope activation(*activation_monitor_);
   RCLCPP_INFO(this->get_logger(), "Trying to activate search");
 
   // Race-conditions though
@@ -31,18 +40,7 @@ LifecycleNodeInterface::CallbackReturn SearchActionNode::on_activate(const rclcp
     return LifecycleNodeInterface::CallbackReturn::FAILURE;
   }
 
-  double search_distance = 0.0;
-  for(size_t next_pt_idx = 1; next_pt_idx < search_points_.size(); next_pt_idx++)
-  {
-    geometry_msgs::msg::Point pt = search_points_[next_pt_idx - 1];
-    geometry_msgs::msg::Point next_pt = search_points_[next_pt_idx];
-
-    double distance = std::sqrt(
-      std::pow(next_pt.x - pt.x, 2) + 
-      std::pow(next_pt.y - pt.y, 2) + 
-      std::pow(next_pt.z - pt.z, 2));
-    search_distance += distance;  
-  }
+  double search_distance = get_search_distance_();
   RCLCPP_INFO(this->get_logger(), "Total search distance " + std::to_string(search_distance) + " m");
 
   search_center_point_ = std::get<1>(*it_search_pos);
@@ -65,8 +63,7 @@ LifecycleNodeInterface::CallbackReturn SearchActionNode::on_activate(const rclcp
        * WARNING: If a multithreaded executor is used, this could cause a race condition!
        * Should not be a problem for a single-threaded executor! 
        */
-      std::string argument = std::get<1>(detections_[search_location_]);
-      set_search_action_finished_(argument);  // Not possible. Causes an error due to the 
+      set_search_action_finished_(std::get<1>(detections_[search_location_]));
 
       RCLCPP_INFO(this->get_logger(), "Action finished");
       action_running_ = false;
@@ -104,7 +101,7 @@ LifecycleNodeInterface::CallbackReturn SearchActionNode::on_activate(const rclcp
     finish(false, 0.0, "Error");
   }
   
-  return ActionExecutorClient::on_activate(previous_state);
+  return activation.succeeded(AdaptiveActionExecutorClient::on_activate(previous_state));
 }
 
 
@@ -115,7 +112,7 @@ LifecycleNodeInterface::CallbackReturn SearchActionNode::on_deactivate(const rcl
   auto response = move_action_client_->async_cancel_all_goals(); // Had a theory that this caused all actions - including the search node itself to cancel, but it was not the case
   action_running_ = false;
 
-  return ActionExecutorClient::on_deactivate(state);
+  return AdaptiveActionExecutorClient::on_deactivate(state);
 }
 
 
@@ -205,17 +202,12 @@ void SearchActionNode::do_work()
 
 bool SearchActionNode::check_search_preconditions_()
 {
-  bool is_action_server_ready = false;
-  int num_waits = 0;
-  const int max_waits = 3;
-
-  while(! is_action_server_ready && num_waits <= max_waits)
+  if(search_points_.empty())
   {
-    RCLCPP_INFO(this->get_logger(), "Waiting for move action server...");
-    is_action_server_ready = move_action_client_->wait_for_action_server(std::chrono::seconds(2));
-    num_waits++;
-  } 
-  return is_action_server_ready && num_waits <= max_waits;
+    RCLCPP_ERROR(this->get_logger(), "No search positions received from the waypoint-generator");
+    return false;
+  }
+  return activation_monitor_->wait_until_ready("/action_servers/track");
 }
 
 
@@ -238,25 +230,47 @@ void SearchActionNode::init_locations_()
 }
 
 
-bool SearchActionNode::get_search_positions_()
+void SearchActionNode::request_search_positions_()
 {
   auto request = std::make_shared<anafi_uav_interfaces::srv::GetSearchPositions::Request>();
   request->preferred_search_technique = request->EXPANDING_SQUARE_SEARCH; 
 
-  if(! search_positions_client_->wait_for_service(2s)) 
-  {
-    RCLCPP_ERROR(this->get_logger(), "Unable to acquire search-position service.");
-    return false;
-  }
+  // The waypoint-generator is launched together with this node, and may take a few seconds to start
+  AsyncCallOptions options;
+  options.timeout_s = 5.0;
+  options.max_retries = 5;
+
+  activation_monitor_->get_startup_timeline().begin("search_positions");
+  search_positions_client_->call(request, 
+    [this](anafi_uav_interfaces::srv::GetSearchPositions::Response::SharedPtr response)
+    {
+      activation_monitor_->get_startup_timeline().end("search_positions");
+      activation_monitor_->publish_startup_timeline();
+      if(! response)
+      {
+        RCLCPP_ERROR(this->get_logger(), "Unable to acquire search-position service.");
+        return;
+      }
+      if(! set_search_positions_(*response))
+      {
+        return;
+      }
+
+      // The publisher is latched, such that the mission controller receives the length of the 
+      // search pattern independent of the startup-order
+      search_distance_pub_->on_activate();
+
+      std_msgs::msg::Float64 search_distance_msg;
+      search_distance_msg.data = get_search_distance_();
+      search_distance_pub_->publish(search_distance_msg);
+    }, 
+    options);
+}
 
-  auto result = search_positions_client_->async_send_request(request);
-  if (rclcpp::spin_until_future_complete(this->get_node_base_interface(), result) != rclcpp::FutureReturnCode::SUCCESS)
-  {
-    RCLCPP_ERROR(this->get_logger(), "Failed to call search-position service");
-    return false;
-  }
 
-  if(! result.get()->success)
+bool SearchActionNode::set_search_positions_(const anafi_uav_interfaces::srv::GetSearchPositions::Response& response)
+{
+  if(! response.success)
   {
     RCLCPP_ERROR(this->get_logger(), "Failed to call search-position service");
     return false;
@@ -265,7 +279,7 @@ bool SearchActionNode::get_search_positions_()
   search_points_.clear();
 
   // Acquire the positions
-  std_msgs::msg::Float64MultiArray multiarray = result.get()->positions;
+  std_msgs::msg::Float64MultiArray multiarray = response.positions;
   auto dim_0 = multiarray.layout.dim[0];
   auto dim_1 = multiarray.layout.dim[1];
 
@@ -300,9 +314,27 @@ bool SearchActionNode::get_search_positions_()
 }
 
 
+double SearchActionNode::get_search_distance_()
+{
+  double search_distance = 0.0;
+  for(size_t next_pt_idx = 1; next_pt_idx < search_points_.size(); next_pt_idx++)
+  {
+    geometry_msgs::msg::Point pt = search_points_[next_pt_idx - 1];
+    geometry_msgs::msg::Point next_pt = search_points_[next_pt_idx];
+
+    double distance = std::sqrt(
+      std::pow(next_pt.x - pt.x, 2) + 
+      std::pow(next_pt.y - pt.y, 2) + 
+      std::pow(next_pt.z - pt.z, 2));
+    search_distance += distance;  
+  }
+  return search_distance;
+}
+
+
 bool SearchActionNode::check_recent_detection()
 {
-  std::map<std::string, std::tuple<rclcpp::Time, std::string>>::iterator it = detections_.find(search_location_);
+  std::map<std::string, std::tuple<rclcpp::Time, SearchDetection>>::iterator it = detections_.find(search_location_);
   if(it == detections_.end())
   {
     // No detection at this location
@@ -316,60 +348,34 @@ bool SearchActionNode::check_recent_detection()
 }
 
 
-bool SearchActionNode::set_search_action_finished_(const std::string& argument)
+void SearchActionNode::set_search_action_finished_(SearchDetection detection)
 {
-  auto request = std::make_shared<anafi_uav_interfaces::srv::SetFinishedAction::Request>();
-  
-  std_msgs::msg::String action_name_msg = std_msgs::msg::String();
-  action_name_msg.data = "search";
-
-  std_msgs::msg::String location_msg = std_msgs::msg::String();
-  location_msg.data = search_location_;
-
-  constexpr int num_args = 1; // Hardcoded for now
-  
-  std::vector<std_msgs::msg::String> argument_msg; 
-  
-  std_msgs::msg::String arg;
-  arg.data = argument;
-
-  argument_msg.push_back(arg);
-
-  request->finished_action_name = action_name_msg;
-  request->location = location_msg;
-  request->arguments = argument_msg;
-  request->num_arguments = num_args;
-
-  if (! finished_action_client_->wait_for_service(1s)) 
-  {
-    RCLCPP_ERROR(this->get_logger(), "Service not available");
-    return false;
-  }
-
   RCLCPP_WARN(this->get_logger(), "Logging that search complete");
-  auto result = finished_action_client_->async_send_request(request);
-  // // Wait for the result.
-  // if (rclcpp::spin_until_future_complete(this->get_node_base_interface(), result) != rclcpp::FutureReturnCode::SUCCESS)
-  // {
-  //   RCLCPP_ERROR(this->get_logger(), "Unable to set action as finished!");
-  //   return false;
-  // }
-
-  return true;
+  completion_pub_->publish(CompletedAction::SEARCH, search_location_, "", detection);
 }
 
 
-void SearchActionNode::detected_person_cb_(anafi_uav_interfaces::msg::DetectedPerson::ConstSharedPtr)
+void SearchActionNode::person_tracks_cb_(anafi_uav_interfaces::msg::PersonTrackArray::ConstSharedPtr person_tracks_msg)
 {
+  // Only confirmed tracks with a recent detection count as a detection. Old tracks are 
+  // republished when other tracks change
+  const double max_detection_age_s = 1.0;
   rclcpp::Time time = this->get_clock()->now();
-  detections_[search_location_] = std::make_tuple(time, "person"); 
+  for(const anafi_uav_interfaces::msg::PersonTrack& track : person_tracks_msg->tracks)
+  {
+    if((time - rclcpp::Time(track.last_detection, time.get_clock_type())).seconds() <= max_detection_age_s)
+    {
+      detections_[search_location_] = std::make_tuple(time, SearchDetection::PERSON); 
+      return;
+    }
+  }
 }
 
 
 void SearchActionNode::apriltags_detected_cb_(anafi_uav_interfaces::msg::Float32Stamped::ConstSharedPtr)
 {
   rclcpp::Time time = this->get_clock()->now();
-  detections_[search_location_] = std::make_tuple(time, "helipad"); 
+  detections_[search_location_] = std::make_tuple(time, SearchDetection::HELIPAD); 
 }
 
 
@@ -0,0 +1,386 @@
+#include "automated_planning/speculative_planner.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "automated_planning/compiled_domain_model.hpp"
+
+
+namespace
+{
+  const std::string& rename(const std::string& name, const std::map<std::string, std::string>& names)
+  {
+    std::map<std::string, std::string>::const_iterator it = names.find(name);
+    return (it == names.end()) ? name : it->second;
+  }
+
+
+  PddlAtom rename(const PddlAtom& atom, const std::map<std::string, std::string>& names)
+  {
+    PddlAtom renamed = atom;
+    for(std::string& argument : renamed.arguments)
+    {
+      argument = rename(argument, names);
+    }
+    return renamed;
+  }
+
+
+  NumericExpression rename(const NumericExpression& expression, const std::map<std::string, std::string>& names)
+  {
+    NumericExpression renamed = expression;
+    renamed.function = rename(expression.function, names);
+    for(NumericExpression& operand : renamed.operands)
+    {
+      operand = rename(operand, names);
+    }
+    return renamed;
+  }
+
+
+  std::vector<std::string> get_sorted_goals(const std::vector<PddlCondition>& goals, const std::map<std::string, std::string>& names)
+  {
+    std::vector<std::string> goal_strs;
+    for(const PddlCondition& goal : goals)
+    {
+      PddlCondition renamed = goal;
+      renamed.predicate = rename(goal.predicate, names);
+      renamed.lhs = rename(goal.lhs, names);
+      renamed.rhs = rename(goal.rhs, names);
+      goal_strs.push_back(renamed.to_string());
+    }
+    std::sort(goal_strs.begin(), goal_strs.end());
+    return goal_strs;
+  }
+}
+
+
+std::string SpeculationStatistics::to_string() const
+{
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(1);
+  ss << "Speculation: " << num_speculations << " plans (" << num_failed_speculations << " failed, "
+    << num_invalidated << " invalidated) in " << 1e3 * speculation_duration_s << " ms. "
+    << num_hits << "/" << num_lookups << " lookups adopted a plan, saving " << 1e3 * saved_duration_s << " ms";
+  return ss.str();
+}
+
+
+SpeculativePlanner::SpeculativePlanner(
+  std::shared_ptr<const PddlDomain> domain,
+  size_t capacity,
+  size_t max_expansions,
+  double timeout_s,
+  bool is_relevance_enabled)
+: domain_(domain)
+, capacity_(capacity)
+, planner_(domain, max_expansions, timeout_s)
+, is_stopped_(false)
+{
+  if(is_relevance_enabled)
+  {
+    relevance_analysis_ = std::make_unique<RelevanceAnalysis>(domain);
+  }
+  worker_ = std::thread(&SpeculativePlanner::run_worker_, this);
+}
+
+
+SpeculativePlanner::~SpeculativePlanner()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopped_ = true;
+  }
+  condition_.notify_all();
+  worker_.join();
+}
+
+
+void SpeculativePlanner::speculate(const std::vector<SpeculativeEvent>& events)
+{
+  std::vector<std::string> keys;
+  for(const SpeculativeEvent& event : events)
+  {
+    keys.push_back(get_key_(event.problem));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  projected_keys_ = keys;
+  auto is_projected = [this](const std::string& key)
+  {
+    return std::find(projected_keys_.begin(), projected_keys_.end(), key) != projected_keys_.end();
+  };
+
+  std::vector<Entry>::iterator entries_end = std::remove_if(entries_.begin(), entries_.end(), [&is_projected](const Entry& entry)
+  {
+    return ! is_projected(entry.key);
+  });
+  statistics_.num_invalidated += std::distance(entries_end, entries_.end());
+  entries_.erase(entries_end, entries_.end());
+
+  std::deque<SpeculativeEvent> pending_events;
+  std::vector<std::string> pending_keys;
+  for(size_t i = 0; i < pending_keys_.size(); i++)
+  {
+    if(is_projected(pending_keys_[i]))
+    {
+      pending_events.push_back(std::move(pending_events_[i]));
+      pending_keys.push_back(pending_keys_[i]);
+    }
+  }
+  pending_events_ = std::move(pending_events);
+  pending_keys_ = std::move(pending_keys);
+  failed_keys_.erase(std::remove_if(failed_keys_.begin(), failed_keys_.end(), [&is_projected](const std::string& key)
+  {
+    return ! is_projected(key);
+  }), failed_keys_.end());
+
+  for(size_t i = 0; i < events.size(); i++)
+  {
+    const std::string& key = keys[i];
+    const bool is_known = (key == planning_key_)
+      || std::find(pending_keys_.begin(), pending_keys_.end(), key) != pending_keys_.end()
+      || std::find(failed_keys_.begin(), failed_keys_.end(), key) != failed_keys_.end()
+      || std::find_if(entries_.begin(), entries_.end(), [&key](const Entry& entry) { return entry.key == key; }) != entries_.end();
+    if(! is_known)
+    {
+      pending_events_.push_back(events[i]);
+      pending_keys_.push_back(key);
+    }
+  }
+  condition_.notify_one();
+}
+
+
+std::optional<std::vector<PlannedAction>> SpeculativePlanner::lookup(const PddlProblem& problem, std::string& label)
+{
+  std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+  std::vector<Entry> entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics_.num_lookups++;
+    entries = entries_;
+  }
+
+  // Validated without the lock, such that the background thread is not blocked
+  for(const Entry& entry : entries)
+  {
+    std::optional<std::map<std::string, std::string>> names = match_(entry.problem, problem);
+    if(! names.has_value())
+    {
+      continue;
+    }
+
+    std::vector<PlannedAction> plan = entry.plan;
+    for(PlannedAction& planned_action : plan)
+    {
+      std::optional<PddlAtom> action = PddlAtom::parse(planned_action.action);
+      if(action.has_value())
+      {
+        planned_action.action = rename(action.value(), names.value()).to_string();
+      }
+    }
+
+    bool is_valid = false;
+    try
+    {
+      SarDomainModel model(domain_);
+      SarDomainModel::CompiledPlan compiled_plan = model.compile_plan(plan);
+      SarDomainModel::CompiledGoal compiled_goal = model.compile_goal(problem.goals);
+      SarDomainModel::State state = model.make_state(problem.predicates, problem.functions);
+      SarDomainModel::ValidationResult result = model.validate(compiled_plan, state);
+      is_valid = result.is_valid && model.is_satisfied(compiled_goal, result.final_state);
+    }
+    catch(const std::runtime_error& e)
+    {
+      // The plan or the problem does not fit the compiled model, and is planned for as usual
+    }
+    if(! is_valid)
+    {
+      continue;
+    }
+
+    label = entry.label;
+    double lookup_duration_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics_.num_hits++;
+    statistics_.saved_duration_s += std::max(0.0, entry.planning_duration_s - lookup_duration_s);
+    return plan;
+  }
+  return std::nullopt;
+}
+
+
+void SpeculativePlanner::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  statistics_.num_invalidated += entries_.size();
+  entries_.clear();
+  pending_events_.clear();
+  pending_keys_.clear();
+  projected_keys_.clear();
+  failed_keys_.clear();
+}
+
+
+SpeculationStatistics SpeculativePlanner::get_statistics() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
+}
+
+
+void SpeculativePlanner::run_worker_()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while(true)
+  {
+    condition_.wait(lock, [this]() { return is_stopped_ || ! pending_events_.empty(); });
+    if(is_stopped_)
+    {
+      return;
+    }
+    SpeculativeEvent event = std::move(pending_events_.front());
+    pending_events_.pop_front();
+    planning_key_ = pending_keys_.front();
+    pending_keys_.erase(pending_keys_.begin());
+    lock.unlock();
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    std::optional<std::vector<PlannedAction>> plan;
+    try
+    {
+      plan = plan_(event.problem);
+    }
+    catch(const std::runtime_error& e)
+    {
+      plan.reset();
+    }
+    double duration_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    lock.lock();
+    std::string key = std::move(planning_key_);
+    planning_key_.clear();
+    statistics_.speculation_duration_s += duration_s;
+    const bool is_projected = std::find(projected_keys_.begin(), projected_keys_.end(), key) != projected_keys_.end();
+    if(! plan.has_value())
+    {
+      statistics_.num_failed_speculations++;
+      if(is_projected)
+      {
+        failed_keys_.push_back(key);
+      }
+      continue;
+    }
+    statistics_.num_speculations++;
+    if(! is_projected)
+    {
+      // The state changed while planning
+      statistics_.num_invalidated++;
+      continue;
+    }
+    entries_.insert(entries_.begin(), Entry{ event.label, key, std::move(event.problem), std::move(plan.value()), duration_s });
+    if(entries_.size() > capacity_)
+    {
+      statistics_.num_invalidated += entries_.size() - capacity_;
+      entries_.resize(capacity_);
+    }
+  }
+}
+
+
+std::optional<std::vector<PlannedAction>> SpeculativePlanner::plan_(const PddlProblem& problem)
+{
+  // A plan for the reduced problem is a plan for the full problem, as the objects keep their names
+  if(relevance_analysis_)
+  {
+    std::optional<std::vector<PlannedAction>> plan = planner_.solve(relevance_analysis_->reduce(problem));
+    if(plan.has_value())
+    {
+      return plan;
+    }
+  }
+  return planner_.solve(problem);
+}
+
+
+std::optional<std::map<std::string, std::string>> SpeculativePlanner::match_(const PddlProblem& entry_problem, const PddlProblem& problem)
+{
+  std::map<std::string, std::vector<std::string>> entry_objects;
+  std::map<std::string, std::vector<std::string>> objects;
+  for(const std::pair<std::string, std::string>& object : entry_problem.objects)
+  {
+    entry_objects[object.second].push_back(object.first);
+  }
+  for(const std::pair<std::string, std::string>& object : problem.objects)
+  {
+    objects[object.second].push_back(object.first);
+  }
+  if(entry_objects.size() != objects.size())
+  {
+    return std::nullopt;
+  }
+
+  std::map<std::string, std::string> names;
+  for(std::pair<const std::string, std::vector<std::string>>& type_objects : entry_objects)
+  {
+    std::map<std::string, std::vector<std::string>>::iterator it = objects.find(type_objects.first);
+    if(it == objects.end() || it->second.size() != type_objects.second.size())
+    {
+      return std::nullopt;
+    }
+    std::sort(type_objects.second.begin(), type_objects.second.end());
+    std::sort(it->second.begin(), it->second.end());
+    std::vector<std::string> missing;
+    std::vector<std::string> added;
+    std::set_difference(type_objects.second.begin(), type_objects.second.end(), it->second.begin(), it->second.end(), std::back_inserter(missing));
+    std::set_difference(it->second.begin(), it->second.end(), type_objects.second.begin(), type_objects.second.end(), std::back_inserter(added));
+    if(missing.size() > 1)
+    {
+      return std::nullopt;
+    }
+    if(missing.size() == 1)
+    {
+      names.emplace(missing.front(), added.front());
+    }
+  }
+
+  if(get_sorted_goals(entry_problem.goals, names) != get_sorted_goals(problem.goals, {}))
+  {
+    return std::nullopt;
+  }
+  return names;
+}
+
+
+std::string SpeculativePlanner::get_key_(const PddlProblem& problem)
+{
+  // The functions are left out, and are checked by the validation on lookup
+  std::vector<std::string> objects;
+  for(const std::pair<std::string, std::string>& object : problem.objects)
+  {
+    objects.push_back(object.first + " - " + object.second);
+  }
+  std::vector<std::string> predicates;
+  for(const PddlAtom& predicate : problem.predicates)
+  {
+    predicates.push_back(predicate.to_string());
+  }
+  std::sort(objects.begin(), objects.end());
+  std::sort(predicates.begin(), predicates.end());
+
+  std::string key;
+  for(const std::vector<std::string>& strs : { objects, predicates, get_sorted_goals(problem.goals, {}) })
+  {
+    for(const std::string& str : strs)
+    {
+      key += str + " ";
+    }
+    key += "|";
+  }
+  return key;
+}
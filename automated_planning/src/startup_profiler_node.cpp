@@ -0,0 +1,107 @@
+#include "automated_planning/startup_profiler_node.hpp"
+
+#include <fstream>
+
+
+void StartupProfilerNode::timeline_cb_(anafi_uav_interfaces::msg::StartupTimeline::ConstSharedPtr timeline_msg)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  profile_.update(timeline_msg->node_name, to_startup_phases(*timeline_msg));
+  is_changed_ = true;
+  last_change_time_ = std::chrono::steady_clock::now();
+}
+
+
+void StartupProfilerNode::watch_graph_()
+{
+  rclcpp::Event::SharedPtr graph_event = this->get_graph_event();
+  bool is_first_check = true;
+  while(rclcpp::ok() && ! is_stopping_)
+  {
+    // Bounded, such that the thread is stopped with the node
+    this->wait_for_graph_change(graph_event, 100ms);
+    if(! graph_event->check_and_clear() && ! is_first_check)
+    {
+      continue;
+    }
+    is_first_check = false;
+
+    const double time_s = StartupTimeline::get_wall_time_s();
+    std::vector<std::string> node_names = this->get_node_names();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for(const std::string& node_name : node_names)
+    {
+      if(discovery_times_s_.count(node_name) || (! expected_nodes_.count(node_name) && ! profile_.has_node(node_name)))
+      {
+        continue;
+      }
+      discovery_times_s_[node_name] = time_s;
+      is_changed_ = true;
+      last_change_time_ = std::chrono::steady_clock::now();
+    }
+  }
+}
+
+
+void StartupProfilerNode::report_timer_cb_()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::chrono::duration<double> time_since_change = std::chrono::steady_clock::now() - last_change_time_;
+    if(! is_changed_ || time_since_change.count() < settle_time_s_)
+    {
+      return;
+    }
+    is_changed_ = false;
+  }
+  report_();
+}
+
+
+void StartupProfilerNode::report_()
+{
+  StartupProfile profile;
+  std::vector<std::string> missing_nodes;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    profile = profile_;
+    for(const std::pair<const std::string, double>& discovery_time : discovery_times_s_)
+    {
+      profile.mark(discovery_time.first, "discovered", discovery_time.second);
+    }
+    for(const std::string& node_name : expected_nodes_)
+    {
+      if(! discovery_times_s_.count(node_name) && ! profile_.has_node(node_name))
+      {
+        missing_nodes.push_back(node_name);
+      }
+    }
+  }
+
+  RCLCPP_INFO(this->get_logger(), "%s", profile.to_string().c_str());
+  for(const std::string& node_name : missing_nodes)
+  {
+    RCLCPP_WARN(this->get_logger(), "Node %s has not started", node_name.c_str());
+  }
+
+  if(! trace_file_.empty())
+  {
+    std::ofstream trace_file(trace_file_, std::ios::trunc);
+    trace_file << profile.to_chrome_trace();
+    if(! trace_file)
+    {
+      RCLCPP_WARN(this->get_logger(), "Could not write the startup trace to %s", trace_file_.c_str());
+    }
+  }
+}
+
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  rclcpp::spin(std::make_shared<StartupProfilerNode>());
+  rclcpp::shutdown();
+
+  return 0;
+}
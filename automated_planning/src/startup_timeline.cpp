@@ -0,0 +1,261 @@
+#include "automated_planning/startup_timeline.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+
+namespace
+{
+  /**
+   * @brief The end of the phase, or the start if it is still running
+   */
+  double get_end_s(const StartupPhase& phase)
+  {
+    return (phase.end_s >= phase.start_s) ? phase.end_s : phase.start_s;
+  }
+
+
+  std::string escape_json(const std::string& str)
+  {
+    std::string escaped;
+    for(char c : str)
+    {
+      if(c == '"' || c == '\\')
+      {
+        escaped += '\\';
+      }
+      escaped += c;
+    }
+    return escaped;
+  }
+}
+
+
+StartupTimeline::StartupTimeline(const std::string& node_name)
+: node_name_(node_name)
+{
+  std::optional<double> process_start_time_s = get_process_start_time_s();
+  if(process_start_time_s.has_value())
+  {
+    // The start is only known to a clock tick, and may come out after now for a process which has
+    // just started, which would be taken for a running phase
+    const double time_s = get_wall_time_s();
+    phases_.push_back(StartupPhase{ "process", std::min(process_start_time_s.value(), time_s), time_s });
+  }
+}
+
+
+void StartupTimeline::begin(const std::string& name)
+{
+  phases_.push_back(StartupPhase{ name, get_wall_time_s(), -1.0 });
+}
+
+
+void StartupTimeline::end(const std::string& name)
+{
+  for(std::vector<StartupPhase>::reverse_iterator it = phases_.rbegin(); it != phases_.rend(); ++it)
+  {
+    if(it->name == name && it->end_s < it->start_s)
+    {
+      it->end_s = get_wall_time_s();
+      return;
+    }
+  }
+}
+
+
+void StartupTimeline::mark(const std::string& name)
+{
+  const double time_s = get_wall_time_s();
+  phases_.push_back(StartupPhase{ name, time_s, time_s });
+}
+
+
+void StartupTimeline::add(const std::string& name, double start_s, double end_s)
+{
+  phases_.push_back(StartupPhase{ name, start_s, end_s });
+}
+
+
+double StartupTimeline::get_wall_time_s()
+{
+  return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+
+std::optional<double> StartupTimeline::get_process_start_time_s()
+{
+  // The start of the process is given in clock ticks since boot, and the time since boot in seconds
+  std::ifstream stat_file("/proc/self/stat");
+  std::ifstream uptime_file("/proc/uptime");
+  std::string stat;
+  double uptime_s;
+  if(! std::getline(stat_file, stat) || ! (uptime_file >> uptime_s))
+  {
+    return std::nullopt;
+  }
+
+  // The command name may contain spaces, so the fields are counted from its closing parenthesis.
+  // The start time is field 22, and the state following the parenthesis is field 3
+  const size_t name_end = stat.rfind(')');
+  if(name_end == std::string::npos)
+  {
+    return std::nullopt;
+  }
+  std::stringstream ss(stat.substr(name_end + 1));
+  std::string field;
+  for(int field_idx = 3; field_idx < 22; field_idx++)
+  {
+    ss >> field;
+  }
+  unsigned long long start_ticks;
+  const long ticks_per_s = ::sysconf(_SC_CLK_TCK);
+  if(! (ss >> start_ticks) || ticks_per_s <= 0)
+  {
+    return std::nullopt;
+  }
+  return get_wall_time_s() - (uptime_s - static_cast<double>(start_ticks) / ticks_per_s);
+}
+
+
+void StartupProfile::update(const std::string& node_name, const std::vector<StartupPhase>& phases)
+{
+  timelines_[node_name] = phases;
+}
+
+
+void StartupProfile::mark(const std::string& node_name, const std::string& name, double time_s)
+{
+  std::vector<StartupPhase>& phases = timelines_[node_name];
+  if(std::none_of(phases.begin(), phases.end(), [&name](const StartupPhase& phase){ return phase.name == name; }))
+  {
+    phases.push_back(StartupPhase{ name, time_s, time_s });
+  }
+}
+
+
+std::string StartupProfile::to_string() const
+{
+  const double origin_s = get_origin_s_();
+  const double span_s = std::max(get_end_s_() - origin_s, 1e-3);
+  const int bar_width = 40;
+  auto to_column = [&](double time_s)
+  {
+    return std::min(bar_width - 1, static_cast<int>(bar_width * (time_s - origin_s) / span_s));
+  };
+
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(0);
+  ss << "Startup of " << timelines_.size() << " nodes in " << 1e3 * span_s << " ms\n";
+  for(const std::string& node_name : get_nodes_by_start_())
+  {
+    const std::vector<StartupPhase>& phases = timelines_.at(node_name);
+    ss << node_name << "\n";
+    for(const StartupPhase& phase : phases)
+    {
+      const bool is_running = (phase.end_s < phase.start_s);
+      const double end_s = is_running ? get_end_s_() : phase.end_s;
+      std::string bar(bar_width, ' ');
+      const int first_column = to_column(phase.start_s);
+      const int last_column = std::max(first_column, to_column(end_s));
+      std::fill(bar.begin() + first_column, bar.begin() + last_column + 1, (phase.end_s == phase.start_s) ? '|' : '#');
+
+      ss << "  " << std::left << std::setw(24) << phase.name << std::right
+        << std::setw(8) << 1e3 * (phase.start_s - origin_s) << " ms "
+        << std::setw(8) << 1e3 * (end_s - phase.start_s) << " ms " << (is_running ? "+" : " ")
+        << " [" << bar << "]\n";
+    }
+  }
+  return ss.str();
+}
+
+
+std::string StartupProfile::to_chrome_trace() const
+{
+  const double origin_s = get_origin_s_();
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(0);
+  ss << "{\"traceEvents\":[";
+  bool is_first = true;
+  int node_idx = 0;
+  for(const std::string& node_name : get_nodes_by_start_())
+  {
+    ss << (is_first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << node_idx
+      << ",\"args\":{\"name\":\"" << escape_json(node_name) << "\"}}";
+    is_first = false;
+    for(const StartupPhase& phase : timelines_.at(node_name))
+    {
+      ss << ",\n{\"name\":\"" << escape_json(phase.name) << "\",\"pid\":1,\"tid\":" << node_idx
+        << ",\"ts\":" << 1e6 * (phase.start_s - origin_s);
+      if(phase.end_s == phase.start_s)
+      {
+        ss << ",\"ph\":\"i\",\"s\":\"t\"}";
+      }
+      else
+      {
+        ss << ",\"ph\":\"X\",\"dur\":" << 1e6 * (get_end_s(phase) - phase.start_s) << "}";
+      }
+    }
+    node_idx++;
+  }
+  ss << "\n]}\n";
+  return ss.str();
+}
+
+
+double StartupProfile::get_origin_s_() const
+{
+  double origin_s = std::numeric_limits<double>::infinity();
+  for(const std::pair<const std::string, std::vector<StartupPhase>>& timeline : timelines_)
+  {
+    for(const StartupPhase& phase : timeline.second)
+    {
+      origin_s = std::min(origin_s, phase.start_s);
+    }
+  }
+  return std::isfinite(origin_s) ? origin_s : 0.0;
+}
+
+
+double StartupProfile::get_end_s_() const
+{
+  double end_s = get_origin_s_();
+  for(const std::pair<const std::string, std::vector<StartupPhase>>& timeline : timelines_)
+  {
+    for(const StartupPhase& phase : timeline.second)
+    {
+      end_s = std::max(end_s, get_end_s(phase));
+    }
+  }
+  return end_s;
+}
+
+
+std::vector<std::string> StartupProfile::get_nodes_by_start_() const
+{
+  std::vector<std::pair<double, std::string>> starts;
+  for(const std::pair<const std::string, std::vector<StartupPhase>>& timeline : timelines_)
+  {
+    double start_s = std::numeric_limits<double>::infinity();
+    for(const StartupPhase& phase : timeline.second)
+    {
+      start_s = std::min(start_s, phase.start_s);
+    }
+    starts.push_back(std::make_pair(start_s, timeline.first));
+  }
+  std::sort(starts.begin(), starts.end());
+
+  std::vector<std::string> node_names;
+  for(const std::pair<double, std::string>& start : starts)
+  {
+    node_names.push_back(start.second);
+  }
+  return node_names;
+}
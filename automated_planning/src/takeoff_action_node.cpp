@@ -8,8 +8,16 @@ bool TakeoffActionNode::check_takeoff_preconditions_()
 }
 
 
+LifecycleNodeInterface::CallbackReturn TakeoffActionNode::on_configure(const rclcpp_lifecycle::State & previous_state)
+{
+  activation_monitor_->start();
+  return AdaptiveActionExecutorClient::on_configure(previous_state);
+}
+
+
 LifecycleNodeInterface::CallbackReturn TakeoffActionNode::on_activate(const rclcpp_lifecycle::State & previous_state)
 {
+  ActionActivationMonitor::ActivationScope activation(*activation_monitor_);
   RCLCPP_INFO(this->get_logger(), "Trying to activate takeoff");
 
   bool preconditions_satisfied = check_takeoff_preconditions_();
@@ -25,8 +33,9 @@ LifecycleNodeInterface::CallbackReturn TakeoffActionNode::on_activate(const rclc
   RCLCPP_INFO(this->get_logger(), "Activating takeoff");
   cmd_takeoff_pub_->on_activate();
   cmd_takeoff_pub_->publish(std_msgs::msg::Empty());
+  activation_.emplace();
   
-  return ActionExecutorClient::on_activate(previous_state);
+  return activation.succeeded(AdaptiveActionExecutorClient::on_activate(previous_state));
 }
 
 
@@ -34,44 +43,36 @@ LifecycleNodeInterface::CallbackReturn TakeoffActionNode::on_deactivate(const rc
 {
   RCLCPP_INFO(this->get_logger(), "Deactivating takeoff");
   cmd_takeoff_pub_->on_deactivate();
+  activation_.reset();
 
-  return ActionExecutorClient::on_deactivate(state);
+  return AdaptiveActionExecutorClient::on_deactivate(state);
 }
 
 
 void TakeoffActionNode::do_work()
 {
-  // Check that the drone is hovering
-  static int num_hovering_attempts = 0;
-  static int max_hovering_attempts = 10; // 2.5 seconds at 250ms rate
+  if(! activation_.has_value())
+  {
+    return;
+  }
 
-  static int num_takeoffs_ordered = 0;
-  static int max_takeoffs_ordered = 3;
+  // Note that finish() deactivates the node, which destroys the activation
+  TakeoffActivation& activation = activation_.value();
 
+  // Check that the drone is hovering
   if(anafi_state_.compare("FS_HOVERING") == 0)
   {
     RCLCPP_INFO(this->get_logger(), "Takeoff finished: Drone hovering!");
     finish(true, 1.0, "Hovering");
-    
-    // Reset variables before finishing
-    num_hovering_attempts = 0;
-    num_takeoffs_ordered = 0;
     return;
   }
 
-  num_hovering_attempts++;
-  if(num_hovering_attempts >= max_hovering_attempts)
+  if(activation.takeoff_retry.await(get_tick_interval_s_()))
   {
-    num_hovering_attempts = 0;
-    num_takeoffs_ordered++;
-    if(num_takeoffs_ordered >= max_takeoffs_ordered)
+    if(activation.takeoff_retry.get_num_periods() >= activation.max_takeoffs_ordered)
     {
       finish(false, 0.0, "Takeoff failed");
       RCLCPP_ERROR(this->get_logger(), "Takeoff failed. Maximum attempts exceeded! Check the drone!");
-      
-      // Reset variables before finishing
-      num_hovering_attempts = 0;
-      num_takeoffs_ordered = 0;
       return;
     }
 
@@ -90,6 +91,7 @@ void TakeoffActionNode::anafi_state_cb_(std_msgs::msg::String::ConstSharedPtr st
     return;
   }
   anafi_state_ = state;
+  wake_();
 }
 
 
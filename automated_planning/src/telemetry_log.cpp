@@ -0,0 +1,232 @@
+#include "automated_planning/telemetry_log.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace
+{
+  constexpr char MAGIC[8] = { 'A', 'N', 'A', 'F', 'I', 'T', 'L', 'G' };
+  constexpr uint32_t VERSION = 1;
+  constexpr size_t FILE_HEADER_SIZE = 16;   // Magic, version, reserved
+  constexpr size_t RECORD_HEADER_SIZE = 16; // Stamp, channel, size
+  constexpr size_t ALIGNMENT = 8;
+
+  size_t padded_size(size_t size)
+  {
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+  }
+
+  std::runtime_error system_error(const std::string& what, const std::string& path)
+  {
+    return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+  }
+}
+
+
+TelemetryLogWriter::TelemetryLogWriter(const std::string& path, size_t initial_capacity)
+: path_(path)
+, fd_(-1)
+, map_(nullptr)
+, capacity_(0)
+, size_(FILE_HEADER_SIZE)
+, num_records_(0)
+{
+  fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if(fd_ < 0)
+  {
+    throw system_error("Could not open telemetry log", path);
+  }
+  map_file_(std::max(initial_capacity, FILE_HEADER_SIZE + RECORD_HEADER_SIZE));
+
+  uint32_t version = VERSION;
+  std::memcpy(map_, MAGIC, sizeof(MAGIC));
+  std::memcpy(map_ + sizeof(MAGIC), &version, sizeof(version));
+}
+
+
+TelemetryLogWriter::~TelemetryLogWriter()
+{
+  close();
+}
+
+
+void TelemetryLogWriter::append(int64_t stamp_ns, uint32_t channel, const void* data, size_t size)
+{
+  if(map_ == nullptr)
+  {
+    throw std::logic_error("Appending to a closed telemetry log");
+  }
+  if(channel == 0 || size > UINT32_MAX)
+  {
+    throw std::invalid_argument("Invalid telemetry record");
+  }
+
+  size_t record_size = RECORD_HEADER_SIZE + padded_size(size);
+  if(size_ + record_size > capacity_)
+  {
+    size_t capacity = capacity_;
+    while(size_ + record_size > capacity)
+    {
+      capacity *= 2;
+    }
+    unmap_file_();
+    map_file_(capacity);
+  }
+
+  // The channel is written last, such that a partially written record is never read
+  uint8_t* record = map_ + size_;
+  uint32_t size_u32 = static_cast<uint32_t>(size);
+  std::memcpy(record, &stamp_ns, sizeof(stamp_ns));
+  std::memcpy(record + 12, &size_u32, sizeof(size_u32));
+  if(size > 0)
+  {
+    std::memcpy(record + RECORD_HEADER_SIZE, data, size);
+  }
+  std::memcpy(record + 8, &channel, sizeof(channel));
+
+  size_ += record_size;
+  num_records_++;
+}
+
+
+void TelemetryLogWriter::flush()
+{
+  if(map_ != nullptr)
+  {
+    ::msync(map_, size_, MS_ASYNC);
+  }
+}
+
+
+void TelemetryLogWriter::close()
+{
+  if(fd_ < 0)
+  {
+    return;
+  }
+  unmap_file_();
+
+  // A failed truncation only leaves a zero-filled tail, which the reader skips
+  int result = ::ftruncate(fd_, static_cast<off_t>(size_));
+  (void) result;
+  ::close(fd_);
+  fd_ = -1;
+}
+
+
+void TelemetryLogWriter::map_file_(size_t capacity)
+{
+  if(::ftruncate(fd_, static_cast<off_t>(capacity)) != 0)
+  {
+    throw system_error("Could not grow telemetry log", path_);
+  }
+  void* map = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if(map == MAP_FAILED)
+  {
+    throw system_error("Could not map telemetry log", path_);
+  }
+  map_ = static_cast<uint8_t*>(map);
+  capacity_ = capacity;
+}
+
+
+void TelemetryLogWriter::unmap_file_()
+{
+  if(map_ != nullptr)
+  {
+    ::msync(map_, size_, MS_SYNC);
+    ::munmap(map_, capacity_);
+    map_ = nullptr;
+  }
+}
+
+
+TelemetryLogReader::TelemetryLogReader(const std::string& path)
+: fd_(-1)
+, map_(nullptr)
+, size_(0)
+, offset_(FILE_HEADER_SIZE)
+{
+  fd_ = ::open(path.c_str(), O_RDONLY);
+  if(fd_ < 0)
+  {
+    throw system_error("Could not open telemetry log", path);
+  }
+
+  struct stat file_stat;
+  if(::fstat(fd_, &file_stat) != 0)
+  {
+    ::close(fd_);
+    throw system_error("Could not read telemetry log", path);
+  }
+  size_ = static_cast<size_t>(file_stat.st_size);
+
+  if(size_ < FILE_HEADER_SIZE)
+  {
+    ::close(fd_);
+    throw std::runtime_error("Telemetry log '" + path + "' is truncated");
+  }
+
+  void* map = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+  if(map == MAP_FAILED)
+  {
+    ::close(fd_);
+    throw system_error("Could not map telemetry log", path);
+  }
+  map_ = static_cast<const uint8_t*>(map);
+
+  uint32_t version;
+  std::memcpy(&version, map_ + sizeof(MAGIC), sizeof(version));
+  if(std::memcmp(map_, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION)
+  {
+    ::munmap(const_cast<uint8_t*>(map_), size_);
+    ::close(fd_);
+    throw std::runtime_error("'" + path + "' is not a telemetry log of version " + std::to_string(VERSION));
+  }
+}
+
+
+TelemetryLogReader::~TelemetryLogReader()
+{
+  ::munmap(const_cast<uint8_t*>(map_), size_);
+  ::close(fd_);
+}
+
+
+bool TelemetryLogReader::next(TelemetryRecord& record)
+{
+  if(offset_ + RECORD_HEADER_SIZE > size_)
+  {
+    return false;
+  }
+
+  const uint8_t* header = map_ + offset_;
+  std::memcpy(&record.stamp_ns, header, sizeof(record.stamp_ns));
+  std::memcpy(&record.channel, header + 8, sizeof(record.channel));
+  std::memcpy(&record.size, header + 12, sizeof(record.size));
+
+  size_t record_size = RECORD_HEADER_SIZE + padded_size(record.size);
+  if(record.channel == 0 || offset_ + record_size > size_)
+  {
+    // End of a log which was not closed properly
+    return false;
+  }
+
+  record.data = header + RECORD_HEADER_SIZE;
+  offset_ += record_size;
+  return true;
+}
+
+
+void TelemetryLogReader::rewind()
+{
+  offset_ = FILE_HEADER_SIZE;
+}
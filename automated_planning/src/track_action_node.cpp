@@ -1,8 +1,16 @@
 #include "automated_planning/track_action_node.hpp"
 
 
+LifecycleNodeInterface::CallbackReturn TrackActionNode::on_configure(const rclcpp_lifecycle::State & previous_state)
+{
+  activation_monitor_->start();
+  return AdaptiveActionExecutorClient::on_configure(previous_state);
+}
+
+
 LifecycleNodeInterface::CallbackReturn TrackActionNode::on_activate(const rclcpp_lifecycle::State & previous_state)
 {
+  ActionActivationMonitor::ActivationScope activation(*activation_monitor_);
   RCLCPP_INFO(this->get_logger(), "Trying to activate track");
 
   // Tracking (as it is currently implemented) will only be used to track a person
@@ -29,6 +37,12 @@ LifecycleNodeInterface::CallbackReturn TrackActionNode::on_activate(const rclcpp
     goal_position_ned_.z -= 2.0; // Small safety margin
   }
 
+  if(! activation_monitor_->wait_until_ready("/action_servers/track"))
+  {
+    finish(false, 0.0, "Unable to track: Move action server not ready!");
+    return LifecycleNodeInterface::CallbackReturn::FAILURE;
+  }
+
   send_feedback(0.0, "Prechecks finished!");
 
   // Start movement to desired position
@@ -44,7 +58,7 @@ LifecycleNodeInterface::CallbackReturn TrackActionNode::on_activate(const rclcpp
 
   future_move_goal_handle_ = move_action_client_->async_send_goal(move_goal_, send_goal_options);
   
-  return ActionExecutorClient::on_activate(previous_state);
+  return activation.succeeded(AdaptiveActionExecutorClient::on_activate(previous_state));
 }
 
 
@@ -54,7 +68,7 @@ LifecycleNodeInterface::CallbackReturn TrackActionNode::on_deactivate(const rclc
   RCLCPP_INFO(this->get_logger(), "Deactivate requested. Cancelling any action execution");
   auto response = move_action_client_->async_cancel_all_goals();
 
-  return ActionExecutorClient::on_deactivate(state);
+  return AdaptiveActionExecutorClient::on_deactivate(state);
 }
 
 
@@ -69,10 +83,12 @@ void TrackActionNode::ned_pos_cb_(geometry_msgs::msg::PointStamped::ConstSharedP
 }
 
 
-void TrackActionNode::detected_person_cb_(anafi_uav_interfaces::msg::DetectedPerson::ConstSharedPtr detected_person_msg)
+void TrackActionNode::person_tracks_cb_(anafi_uav_interfaces::msg::PersonTrackArray::ConstSharedPtr person_tracks_msg)
 {
-  int id = detected_person_msg->id;
-  detected_people_[id] = detected_person_msg->position; 
+  for(const anafi_uav_interfaces::msg::PersonTrack& track : person_tracks_msg->tracks)
+  {
+    detected_people_[static_cast<int>(track.id)] = track.position; 
+  }
 }
 
 
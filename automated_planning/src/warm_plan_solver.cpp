@@ -0,0 +1,278 @@
+#include "automated_planning/warm_plan_solver.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+#include "ament_index_cpp/get_package_prefix.hpp"
+#include "pluginlib/class_list_macros.hpp"
+
+#include "automated_planning/plan_conversion.hpp"
+
+
+namespace
+{
+  /**
+   * @brief Writes the contents to a new file in tmpfs, or in /tmp if tmpfs is unavailable
+   *
+   * @return The path, or an empty string on failure
+   */
+  std::string write_temporary_file(const std::string& contents, const std::string& name)
+  {
+    for(const char* directory : { "/dev/shm", "/tmp" })
+    {
+      std::string path = std::string(directory) + "/warm_plan_solver_" + name + "_XXXXXX";
+      std::vector<char> path_buffer(path.begin(), path.end());
+      path_buffer.push_back('\0');
+      const int fd = ::mkstemp(path_buffer.data());
+      if(fd < 0)
+      {
+        continue;
+      }
+      const bool is_written = write_all(fd, contents);
+      ::close(fd);
+      if(is_written)
+      {
+        return std::string(path_buffer.data());
+      }
+      ::unlink(path_buffer.data());
+    }
+    return "";
+  }
+
+
+  /**
+   * @brief Runs the command through the shell and collects its standard output, killing it if it
+   * has not finished by the timeout. The command runs in its own process group, such that the
+   * planner started by a wrapper like ros2 run is killed as well
+   *
+   * @return false if the command could not be started or was killed
+   */
+  bool run_command(const std::string& command, double timeout_s, std::string& output)
+  {
+    output.clear();
+    int pipe_fds[2];
+    if(::pipe2(pipe_fds, O_CLOEXEC) != 0)
+    {
+      return false;
+    }
+    const pid_t pid = ::fork();
+    if(pid < 0)
+    {
+      ::close(pipe_fds[0]);
+      ::close(pipe_fds[1]);
+      return false;
+    }
+    if(pid == 0)
+    {
+      // Only async-signal-safe calls until exec. dup2 clears close-on-exec for the copy
+      ::setpgid(0, 0);
+      ::dup2(pipe_fds[1], STDOUT_FILENO);
+      ::execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+      ::_exit(127);
+    }
+    ::close(pipe_fds[1]);
+
+    const double deadline_s = get_steady_time_s() + timeout_s;
+    bool is_finished = false;
+    char buffer[4096];
+    while(true)
+    {
+      const double remaining_s = deadline_s - get_steady_time_s();
+      if(remaining_s <= 0.0)
+      {
+        break;
+      }
+      struct pollfd poll_fd = { pipe_fds[0], POLLIN, 0 };
+      const int result = ::poll(&poll_fd, 1, static_cast<int>(std::ceil(1e3 * remaining_s)));
+      if(result < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      if(result <= 0)
+      {
+        break;
+      }
+      const ssize_t num_read = ::read(pipe_fds[0], buffer, sizeof(buffer));
+      if(num_read < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      if(num_read <= 0)
+      {
+        is_finished = (num_read == 0);
+        break;
+      }
+      output.append(buffer, static_cast<size_t>(num_read));
+    }
+    ::close(pipe_fds[0]);
+
+    // The group is killed in any case, as the shell may exit before the processes it started
+    ::kill(-pid, SIGKILL);
+    ::waitpid(pid, nullptr, 0);
+    return is_finished;
+  }
+
+
+  /**
+   * @brief Reads a plan as printed by POPF, with one item per line:
+   *    0.000: (move d0 h0 a0)  [10.000]
+   */
+  plansys2_msgs::msg::Plan parse_popf_plan(const std::string& output)
+  {
+    std::stringstream ss(output);
+    plansys2_msgs::msg::Plan plan;
+    std::string line;
+    while(std::getline(ss, line))
+    {
+      size_t colon = line.find(':');
+      size_t action_start = line.find('(');
+      size_t action_end = line.find(')', action_start);
+      size_t duration_start = line.find('[', action_end);
+      if(colon == std::string::npos || action_start == std::string::npos || action_end == std::string::npos || duration_start == std::string::npos)
+      {
+        continue;
+      }
+      plansys2_msgs::msg::PlanItem plan_item;
+      plan_item.time = std::stof(line.substr(0, colon));
+      plan_item.action = line.substr(action_start, action_end - action_start + 1);
+      plan_item.duration = std::stof(line.substr(duration_start + 1));
+      plan.items.push_back(plan_item);
+    }
+    return plan;
+  }
+}
+
+
+WarmPlanSolver::WarmPlanSolver()
+: logger_(rclcpp::get_logger("warm_plan_solver"))
+{
+}
+
+
+WarmPlanSolver::~WarmPlanSolver()
+{
+  if(pool_)
+  {
+    RCLCPP_INFO(logger_, "%s", pool_->get_statistics().to_string().c_str());
+  }
+}
+
+
+void WarmPlanSolver::configure(rclcpp_lifecycle::LifecycleNode::SharedPtr& node, const std::string& plugin_name)
+{
+  logger_ = node->get_logger();
+  const std::string prefix = plugin_name + ".";
+  std::string worker_executable = node->declare_parameter<std::string>(prefix + "worker_executable", "");
+  const int num_workers = node->declare_parameter<int>(prefix + "num_workers", 2);
+  const int max_expansions = node->declare_parameter<int>(prefix + "max_expansions", 200000);
+  const double timeout_s = node->declare_parameter<double>(prefix + "timeout", 10.0);
+  const bool is_relevance_pruning_enabled = node->declare_parameter<bool>(prefix + "relevance_pruning", false);
+  fallback_command_ = node->declare_parameter<std::string>(prefix + "fallback_command", "ros2 run popf popf {domain} {problem}");
+  fallback_timeout_s_ = node->declare_parameter<double>(prefix + "fallback_timeout", 30.0);
+
+  if(worker_executable.empty())
+  {
+    worker_executable = ament_index_cpp::get_package_prefix("automated_planning") + "/lib/automated_planning/sar_planner_worker";
+  }
+  std::vector<std::string> worker_command = {
+    worker_executable, "--max-expansions", std::to_string(max_expansions), "--timeout", std::to_string(timeout_s)
+  };
+  if(! is_relevance_pruning_enabled)
+  {
+    worker_command.push_back("--no-relevance");
+  }
+
+  // The call may also parse the domain and ground the problem, on top of the search
+  const double call_margin_s = 5.0;
+  pool_ = std::make_unique<WarmPlannerPool>(worker_command, std::max(num_workers, 1), timeout_s + call_margin_s);
+  if(! pool_->start())
+  {
+    RCLCPP_ERROR(logger_, "Could not start the planner workers %s", worker_executable.c_str());
+  }
+  RCLCPP_INFO(logger_, "Planning with %d warm workers %s", num_workers, worker_executable.c_str());
+}
+
+
+std::optional<plansys2_msgs::msg::Plan> WarmPlanSolver::getPlan(
+  const std::string& domain,
+  const std::string& problem,
+  const std::string& /*node_namespace*/)
+{
+  if(pool_)
+  {
+    std::string message;
+    std::optional<std::vector<PlannedAction>> planned_actions = pool_->plan(domain, problem, message);
+    RCLCPP_INFO(logger_, "%s", pool_->get_statistics().to_string().c_str());
+    if(planned_actions.has_value())
+    {
+      return to_plan_msg(planned_actions.value());
+    }
+    RCLCPP_WARN(logger_, "The planner workers found no plan: %s", message.c_str());
+  }
+  else
+  {
+    RCLCPP_ERROR(logger_, "The plugin is not configured");
+  }
+
+  if(fallback_command_.empty())
+  {
+    return std::nullopt;
+  }
+  return get_fallback_plan_(domain, problem);
+}
+
+
+std::optional<plansys2_msgs::msg::Plan> WarmPlanSolver::get_fallback_plan_(const std::string& domain, const std::string& problem)
+{
+  const std::string domain_path = write_temporary_file(domain, "domain");
+  const std::string problem_path = write_temporary_file(problem, "problem");
+  std::optional<plansys2_msgs::msg::Plan> plan;
+  if(! domain_path.empty() && ! problem_path.empty())
+  {
+    std::string command = fallback_command_;
+    for(const std::pair<std::string, std::string>& replacement : { std::make_pair(std::string("{domain}"), domain_path), std::make_pair(std::string("{problem}"), problem_path) })
+    {
+      for(size_t pos = command.find(replacement.first); pos != std::string::npos; pos = command.find(replacement.first, pos))
+      {
+        command.replace(pos, replacement.first.size(), replacement.second);
+        pos += replacement.second.size();
+      }
+    }
+
+    RCLCPP_INFO(logger_, "Planning with the fallback command: %s", command.c_str());
+    std::string output;
+    if(! run_command(command, fallback_timeout_s_, output))
+    {
+      RCLCPP_WARN(logger_, "The fallback command did not finish within %.1f s, and was killed", fallback_timeout_s_);
+    }
+
+    // POPF prints the plan after this line
+    const size_t solution_pos = output.find("Solution Found");
+    if(solution_pos != std::string::npos)
+    {
+      plan = parse_popf_plan(output.substr(solution_pos));
+    }
+  }
+  if(! domain_path.empty())
+  {
+    ::unlink(domain_path.c_str());
+  }
+  if(! problem_path.empty())
+  {
+    ::unlink(problem_path.c_str());
+  }
+  return plan;
+}
+
+
+PLUGINLIB_EXPORT_CLASS(WarmPlanSolver, plansys2::PlanSolverBase);
@@ -0,0 +1,382 @@
+#include "automated_planning/warm_planner_pool.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+
+
+namespace
+{
+  /**
+   * @brief Parses the header line "<type> <size> [worker_duration_s]"
+   */
+  bool parse_header(const std::string& line, std::string& type, size_t& size, double& worker_duration_s)
+  {
+    std::stringstream ss(line);
+    worker_duration_s = 0.0;
+    if(! (ss >> type >> size))
+    {
+      return false;
+    }
+    ss >> worker_duration_s;
+    return true;
+  }
+
+
+  /**
+   * @brief Parses the lines "<start_s> <duration_s> <action>" of a PLAN-payload
+   */
+  bool parse_plan(const std::string& payload, std::vector<PlannedAction>& plan)
+  {
+    std::stringstream ss(payload);
+    std::string line;
+    while(std::getline(ss, line))
+    {
+      if(line.empty())
+      {
+        continue;
+      }
+      std::stringstream line_ss(line);
+      PlannedAction planned_action;
+      if(! (line_ss >> planned_action.start_s >> planned_action.duration_s))
+      {
+        return false;
+      }
+      std::getline(line_ss >> std::ws, planned_action.action);
+      if(planned_action.action.empty())
+      {
+        return false;
+      }
+      plan.push_back(planned_action);
+    }
+    return true;
+  }
+}
+
+
+bool write_all(int fd, const std::string& data)
+{
+  size_t num_written = 0;
+  while(num_written < data.size())
+  {
+    // Sockets do not raise SIGPIPE when the worker has exited, while pipes like stdout of the
+    // worker do
+    ssize_t result = ::send(fd, data.data() + num_written, data.size() - num_written, MSG_NOSIGNAL);
+    if(result < 0 && errno == ENOTSOCK)
+    {
+      result = ::write(fd, data.data() + num_written, data.size() - num_written);
+    }
+    if(result < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if(result <= 0)
+    {
+      return false;
+    }
+    num_written += static_cast<size_t>(result);
+  }
+  return true;
+}
+
+
+bool read_message_part(int fd, size_t size, std::string& data, double deadline_s)
+{
+  data.clear();
+  const bool is_line = (size == 0);
+  char buffer[4096];
+  while(is_line || data.size() < size)
+  {
+    if(deadline_s >= 0.0)
+    {
+      const double remaining_s = deadline_s - get_steady_time_s();
+      if(remaining_s <= 0.0)
+      {
+        return false;
+      }
+      struct pollfd poll_fd = { fd, POLLIN, 0 };
+      const int result = ::poll(&poll_fd, 1, static_cast<int>(std::ceil(1e3 * remaining_s)));
+      if(result < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      if(result <= 0)
+      {
+        return false;
+      }
+    }
+
+    // Lines are read one byte at a time, such that the payload after the header is not consumed
+    const size_t num_requested = is_line ? 1 : std::min(sizeof(buffer), size - data.size());
+    const ssize_t num_read = ::read(fd, buffer, num_requested);
+    if(num_read < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if(num_read <= 0)
+    {
+      return false;
+    }
+    if(is_line && buffer[0] == '\n')
+    {
+      return true;
+    }
+    data.append(buffer, static_cast<size_t>(num_read));
+  }
+  return true;
+}
+
+
+double get_steady_time_s()
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+double WarmPlannerPoolStatistics::get_overhead_per_call_s() const
+{
+  return (num_calls > 0) ? (call_duration_s - worker_duration_s) / num_calls : 0.0;
+}
+
+
+std::string WarmPlannerPoolStatistics::to_string() const
+{
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(2);
+  ss << "Warm planner pool: " << num_plans << "/" << num_calls << " calls planned, "
+    << num_spawned_workers << " workers started (" << num_failed_workers << " failed), "
+    << num_domain_transfers << " domain transfers. "
+    << 1e3 * call_duration_s << " ms in the calls, " << 1e3 * worker_duration_s << " ms in the workers, "
+    << 1e3 * get_overhead_per_call_s() << " ms overhead per call";
+  return ss.str();
+}
+
+
+WarmPlannerPool::WarmPlannerPool(const std::vector<std::string>& worker_command, size_t num_workers, double timeout_s)
+: worker_command_(worker_command)
+, timeout_s_(timeout_s)
+, workers_(std::max<size_t>(num_workers, 1))
+{
+}
+
+
+WarmPlannerPool::~WarmPlannerPool()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait(lock, [this]()
+  {
+    return std::none_of(workers_.begin(), workers_.end(), [](const Worker& worker) { return worker.is_busy; });
+  });
+  for(Worker& worker : workers_)
+  {
+    terminate_(worker);
+  }
+}
+
+
+bool WarmPlannerPool::start()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  bool is_started = true;
+  for(Worker& worker : workers_)
+  {
+    if(worker.pid < 0 && ! worker.is_busy)
+    {
+      is_started = spawn_(worker) && is_started;
+    }
+  }
+  return is_started;
+}
+
+
+std::optional<std::vector<PlannedAction>> WarmPlannerPool::plan(const std::string& domain, const std::string& problem, std::string& message)
+{
+  const double start_time_s = get_steady_time_s();
+  const size_t domain_hash = std::hash<std::string>{}(domain);
+
+  // Prefers a running worker which already has the domain, and then any running worker
+  auto get_rank = [domain_hash](const Worker& worker)
+  {
+    if(worker.pid < 0)
+    {
+      return 0;
+    }
+    return (worker.domain_hash == domain_hash) ? 2 : 1;
+  };
+  std::unique_lock<std::mutex> lock(mutex_);
+  std::vector<Worker>::iterator worker_it;
+  condition_.wait(lock, [this, &worker_it, &get_rank]()
+  {
+    worker_it = workers_.end();
+    for(std::vector<Worker>::iterator it = workers_.begin(); it != workers_.end(); ++it)
+    {
+      if(! it->is_busy && (worker_it == workers_.end() || get_rank(*it) > get_rank(*worker_it)))
+      {
+        worker_it = it;
+      }
+    }
+    return worker_it != workers_.end();
+  });
+  Worker& worker = *worker_it;
+  statistics_.num_calls++;
+  if(worker.pid < 0 && ! spawn_(worker))
+  {
+    message = "Could not start the planner worker " + (worker_command_.empty() ? std::string() : worker_command_[0]);
+    return std::nullopt;
+  }
+  worker.is_busy = true;
+  lock.unlock();
+
+  std::optional<std::vector<PlannedAction>> plan;
+  bool is_domain_sent = false;
+  double worker_duration_s = 0.0;
+  const bool is_worker_ok = call_(worker, domain_hash, domain, problem, plan, message, is_domain_sent, worker_duration_s);
+
+  lock.lock();
+  if(! is_worker_ok)
+  {
+    terminate_(worker);
+    statistics_.num_failed_workers++;
+  }
+  worker.is_busy = false;
+  statistics_.num_domain_transfers += is_domain_sent ? 1 : 0;
+  statistics_.num_plans += plan.has_value() ? 1 : 0;
+  statistics_.worker_duration_s += worker_duration_s;
+  statistics_.call_duration_s += get_steady_time_s() - start_time_s;
+  lock.unlock();
+  condition_.notify_all();
+  return plan;
+}
+
+
+WarmPlannerPoolStatistics WarmPlannerPool::get_statistics() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
+}
+
+
+bool WarmPlannerPool::spawn_(Worker& worker)
+{
+  if(worker_command_.empty())
+  {
+    return false;
+  }
+  int sockets[2];
+  if(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0)
+  {
+    return false;
+  }
+
+  std::vector<char*> argv;
+  for(const std::string& argument : worker_command_)
+  {
+    argv.push_back(const_cast<char*>(argument.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  const pid_t pid = ::fork();
+  if(pid < 0)
+  {
+    ::close(sockets[0]);
+    ::close(sockets[1]);
+    return false;
+  }
+  if(pid == 0)
+  {
+    // Only async-signal-safe calls until exec. dup2 clears close-on-exec for the copies
+    ::dup2(sockets[1], STDIN_FILENO);
+    ::dup2(sockets[1], STDOUT_FILENO);
+    ::execvp(argv[0], argv.data());
+    ::_exit(127);
+  }
+  ::close(sockets[1]);
+  worker.pid = pid;
+  worker.socket = sockets[0];
+  worker.domain_hash.reset();
+  statistics_.num_spawned_workers++;
+  return true;
+}
+
+
+void WarmPlannerPool::terminate_(Worker& worker)
+{
+  if(worker.socket >= 0)
+  {
+    // The worker exits at the end of its input
+    ::close(worker.socket);
+    worker.socket = -1;
+  }
+  if(worker.pid > 0)
+  {
+    ::kill(worker.pid, SIGKILL);
+    ::waitpid(worker.pid, nullptr, 0);
+    worker.pid = -1;
+  }
+  worker.domain_hash.reset();
+}
+
+
+bool WarmPlannerPool::call_(
+  Worker& worker,
+  size_t domain_hash,
+  const std::string& domain,
+  const std::string& problem,
+  std::optional<std::vector<PlannedAction>>& plan,
+  std::string& message,
+  bool& is_domain_sent,
+  double& worker_duration_s) const
+{
+  const double deadline_s = get_steady_time_s() + timeout_s_;
+  std::string request;
+  if(worker.domain_hash != domain_hash)
+  {
+    request += "DOMAIN " + std::to_string(domain.size()) + "\n" + domain;
+    is_domain_sent = true;
+  }
+  request += "PROBLEM " + std::to_string(problem.size()) + "\n" + problem;
+  if(! write_all(worker.socket, request))
+  {
+    message = "The planner worker has exited";
+    return false;
+  }
+  // The worker keeps the domain even if the problem could not be planned for
+  worker.domain_hash = domain_hash;
+
+  std::string header;
+  std::string type;
+  size_t size;
+  std::string payload;
+  if(! read_message_part(worker.socket, 0, header, deadline_s)
+    || ! parse_header(header, type, size, worker_duration_s)
+    || ! read_message_part(worker.socket, size, payload, deadline_s))
+  {
+    message = "No response from the planner worker within " + std::to_string(timeout_s_) + " s";
+    return false;
+  }
+
+  if(type == "NONE")
+  {
+    message = payload;
+    return true;
+  }
+  std::vector<PlannedAction> planned_actions;
+  if(type != "PLAN" || ! parse_plan(payload, planned_actions))
+  {
+    message = "Invalid response from the planner worker: " + header;
+    return false;
+  }
+  plan = planned_actions;
+  return true;
+}
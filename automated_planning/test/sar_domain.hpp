@@ -0,0 +1,32 @@
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "automated_planning/pddl_domain.hpp"
+
+
+/**
+ * @brief The domain flown by the missions, pddl/sar_testing.pddl. The path is given by the build
+ * as SAR_DOMAIN_PATH, such that the tests follow the domain as it changes
+ */
+inline std::string read_sar_domain_str()
+{
+  std::ifstream file(SAR_DOMAIN_PATH);
+  if(! file)
+  {
+    throw std::runtime_error("Unable to open " + std::string(SAR_DOMAIN_PATH));
+  }
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+
+inline std::shared_ptr<const PddlDomain> load_sar_domain()
+{
+  return std::make_shared<const PddlDomain>(PddlDomain::parse(read_sar_domain_str()));
+}
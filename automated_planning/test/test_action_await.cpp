@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include "automated_planning/action_await.hpp"
+
+
+TEST(ConditionAwaiter, TimesOutAfterTheWaitedTime)
+{
+  ConditionAwaiter awaiter(1.0);
+  EXPECT_EQ(awaiter.await(false, 0.25), AwaitStatus::WAITING);
+  EXPECT_EQ(awaiter.await(false, 0.5), AwaitStatus::WAITING);
+  EXPECT_EQ(awaiter.await(true, 0.25), AwaitStatus::READY);
+  EXPECT_DOUBLE_EQ(awaiter.get_waited_s(), 0.75);
+
+  // Stays timed out, even when the condition holds later
+  EXPECT_EQ(awaiter.await(false, 0.25), AwaitStatus::TIMED_OUT);
+  EXPECT_EQ(awaiter.await(true, 0.25), AwaitStatus::TIMED_OUT);
+  EXPECT_DOUBLE_EQ(awaiter.get_waited_s(), 1.0);
+
+  awaiter.reset();
+  EXPECT_DOUBLE_EQ(awaiter.get_waited_s(), 0.0);
+  EXPECT_EQ(awaiter.await(true, 0.25), AwaitStatus::READY);
+}
+
+
+TEST(ConditionAwaiter, WaitsIndependentOfTheTickRate)
+{
+  ConditionAwaiter slow_awaiter(2.0);
+  ConditionAwaiter fast_awaiter(2.0);
+  int num_slow_ticks = 0;
+  int num_fast_ticks = 0;
+  while(slow_awaiter.await(false, 0.5) == AwaitStatus::WAITING)
+  {
+    num_slow_ticks++;
+  }
+  while(fast_awaiter.await(false, 0.125) == AwaitStatus::WAITING)
+  {
+    num_fast_ticks++;
+  }
+  EXPECT_EQ(num_slow_ticks, 3);
+  EXPECT_EQ(num_fast_ticks, 15);
+
+  // Without a timeout it waits for the condition
+  ConditionAwaiter awaiter;
+  for(int i = 0; i < 1000; i++)
+  {
+    ASSERT_EQ(awaiter.await(false, 10.0), AwaitStatus::WAITING);
+  }
+}
+
+
+TEST(PeriodAwaiter, ElapsesOncePerPeriod)
+{
+  PeriodAwaiter awaiter(1.0);
+  EXPECT_FALSE(awaiter.await(0.5));
+  EXPECT_TRUE(awaiter.await(0.5));
+  EXPECT_FALSE(awaiter.await(0.75));
+  EXPECT_TRUE(awaiter.await(0.25));
+  EXPECT_EQ(awaiter.get_num_periods(), 2);
+
+  // A long tick is a single period, and the next period starts after it
+  EXPECT_TRUE(awaiter.await(3.5));
+  EXPECT_FALSE(awaiter.await(0.5));
+  EXPECT_EQ(awaiter.get_num_periods(), 3);
+
+  awaiter.reset();
+  EXPECT_EQ(awaiter.get_num_periods(), 0);
+  EXPECT_FALSE(awaiter.await(0.75));
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include "automated_planning/action_completion.hpp"
+
+
+namespace
+{
+  const std::vector<std::string> location_names = { "h0", "a", "b", "a1" };
+}
+
+
+TEST(ActionCompletion, PersonIdIsParsedFromItsExactName)
+{
+  EXPECT_EQ(get_person_id("p0"), 0);
+  EXPECT_EQ(get_person_id("p12"), 12);
+
+  EXPECT_EQ(get_person_id("p1_2"), -1);
+  EXPECT_EQ(get_person_id("person12"), -1);
+  EXPECT_EQ(get_person_id("p012"), -1);
+  EXPECT_EQ(get_person_id("p"), -1);
+  EXPECT_EQ(get_person_id("12"), -1);
+  EXPECT_EQ(get_person_id("p_speculated"), -1);
+  EXPECT_EQ(get_person_id("p99999999999"), -1);
+}
+
+
+TEST(ActionCompletion, ServiceRequestIsConverted)
+{
+  std::optional<ActionCompletion> completion = to_action_completion("mark", "b", "p3", location_names);
+  ASSERT_TRUE(completion.has_value());
+  EXPECT_EQ(completion->action, CompletedAction::MARK);
+  EXPECT_EQ(completion->location_idx, 2);
+  EXPECT_EQ(completion->person_id, 3);
+
+  completion = to_action_completion("search", "a", "helipad", location_names);
+  ASSERT_TRUE(completion.has_value());
+  EXPECT_EQ(completion->detection, SearchDetection::HELIPAD);
+  EXPECT_LT(completion->person_id, 0);
+
+  EXPECT_FALSE(to_action_completion("move", "a", "", location_names).has_value());
+  EXPECT_FALSE(to_action_completion("search", "c", "", location_names).has_value());
+}
+
+
+TEST(ActionCompletion, GoalIsMatchedExactly)
+{
+  const ActionCompletion mark{ CompletedAction::MARK, 1, 12, SearchDetection::NONE };
+  EXPECT_TRUE(is_completed_goal(mark, "(not_marked p12 a)", location_names));
+  EXPECT_FALSE(is_completed_goal(mark, "(not_marked p1_2 a)", location_names));
+  EXPECT_FALSE(is_completed_goal(mark, "(not_marked person12 a)", location_names));
+  EXPECT_FALSE(is_completed_goal(mark, "(not_marked p12 a1)", location_names));
+  EXPECT_FALSE(is_completed_goal(mark, "(not_rescued p12 a)", location_names));
+
+  // A person without an ID matches no goal, not even another person without an ID
+  const ActionCompletion unknown_mark{ CompletedAction::MARK, 1, -1, SearchDetection::NONE };
+  EXPECT_FALSE(is_completed_goal(unknown_mark, "(not_marked p_speculated a)", location_names));
+  EXPECT_FALSE(is_completed_goal(unknown_mark, "(not_marked person12 a)", location_names));
+
+  const ActionCompletion search{ CompletedAction::SEARCH, 1, -1, SearchDetection::NONE };
+  EXPECT_TRUE(is_completed_goal(search, "(searched a)", location_names));
+  EXPECT_FALSE(is_completed_goal(search, "(searched a1)", location_names));
+}
+
+
+TEST(ActionCompletion, CompletedGoalsAreRemoved)
+{
+  std::vector<std::string> goals = {
+    "(searched a)", "(searched b)", "(not_rescued p1 a)", "(not_rescued p2 a)", "(not_marked p1 a)"
+  };
+  const std::vector<ActionCompletion> completions = {
+    ActionCompletion{ CompletedAction::SEARCH, 2, -1, SearchDetection::PERSON },
+    ActionCompletion{ CompletedAction::RESCUE, 1, 2, SearchDetection::NONE },
+    ActionCompletion{ CompletedAction::RESCUE, 1, 2, SearchDetection::NONE },   // Repeated event
+    ActionCompletion{ CompletedAction::COMMUNICATE, 1, 1, SearchDetection::NONE } // Without a goal
+  };
+
+  EXPECT_EQ(remove_completed_goals(completions, location_names, goals), 2u);
+  const std::vector<std::string> remaining_goals = { "(searched a)", "(not_rescued p1 a)", "(not_marked p1 a)" };
+  EXPECT_EQ(goals, remaining_goals);
+  EXPECT_EQ(remove_completed_goals(completions, location_names, goals), 0u);
+}
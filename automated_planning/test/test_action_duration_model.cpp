@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+
+#include "automated_planning/action_duration_model.hpp"
+
+
+class ActionDurationModelTest : public ::testing::Test
+{
+protected:
+  // 2 m/s when moving, 1 m/s when searching a 50 m pattern
+  ActionDurationModel model_{ 2.0, 1.0, 50.0 };
+};
+
+
+TEST_F(ActionDurationModelTest, PriorsFollowTheVelocitiesAndThePddlDurations)
+{
+  EXPECT_NEAR(model_.predict_move(20.0), 10.0, 1e-9);
+  EXPECT_NEAR(model_.predict_search(), 50.0, 1e-9);
+  EXPECT_NEAR(model_.predict("land"), 10.0, 1e-9);
+  EXPECT_NEAR(model_.predict("takeoff"), 5.0, 1e-9);
+
+  // Actions which are not modelled get the default duration
+  EXPECT_NEAR(model_.predict("recharge"), 1.0, 1e-9);
+  EXPECT_EQ(model_.get_num_observations("recharge"), 0);
+
+  // The planner requires strictly positive durations, also when moving to the current location
+  EXPECT_GT(model_.predict_move(0.0), 0.0);
+}
+
+
+TEST_F(ActionDurationModelTest, SearchIgnoresTheGivenDistance)
+{
+  EXPECT_NEAR(model_.predict("search", 1000.0), 50.0, 1e-9);
+
+  model_.set_search_distance(80.0);
+  EXPECT_NEAR(model_.predict_search(), 80.0, 1e-9);
+
+  model_.set_search_distance(-1.0);
+  model_.set_search_distance(std::numeric_limits<double>::quiet_NaN());
+  EXPECT_NEAR(model_.get_search_distance(), 80.0, 1e-9);
+}
+
+
+TEST_F(ActionDurationModelTest, MoveConvergesToTheObservedOverheadAndVelocity)
+{
+  // The drone flies at 2.5 m/s, and spends 3 s accelerating and settling
+  const double distances[] = { 10.0, 40.0, 25.0, 60.0, 15.0 };
+  for(int i = 0; i < 20; i++)
+  {
+    for(double distance : distances)
+    {
+      EXPECT_TRUE(model_.add_observation("move", distance, 3.0 + 0.4 * distance));
+    }
+  }
+
+  EXPECT_EQ(model_.get_num_observations("move"), 100);
+  EXPECT_NEAR(model_.predict_move(0.0), 3.0, 0.1);
+  EXPECT_NEAR(model_.predict_move(100.0), 43.0, 0.5);
+
+  // The other action types are not affected
+  EXPECT_NEAR(model_.predict("land"), 10.0, 1e-9);
+}
+
+
+TEST_F(ActionDurationModelTest, FixedActionsFollowASlowChange)
+{
+  for(int i = 0; i < 50; i++)
+  {
+    model_.add_observation("land", 0.0, 14.0);
+  }
+  EXPECT_NEAR(model_.predict("land"), 14.0, 0.1);
+}
+
+
+TEST_F(ActionDurationModelTest, InvalidObservationsAreRejected)
+{
+  // Instant completions, outliers, unknown actions and non-finite values
+  EXPECT_FALSE(model_.add_observation("move", 20.0, 0.0));
+  EXPECT_FALSE(model_.add_observation("move", 20.0, 10.0 * 10.0 + 61.0));
+  EXPECT_FALSE(model_.add_observation("recharge", 0.0, 5.0));
+  EXPECT_FALSE(model_.add_observation("move", std::numeric_limits<double>::infinity(), 5.0));
+  EXPECT_FALSE(model_.add_observation("move", 20.0, std::numeric_limits<double>::quiet_NaN()));
+
+  EXPECT_EQ(model_.get_num_observations("move"), 0);
+  EXPECT_NEAR(model_.predict_move(20.0), 10.0, 1e-9);
+}
+
+
+TEST(MakespanTracker, InterruptedPlansAreNotCounted)
+{
+  MakespanTracker tracker;
+  EXPECT_DOUBLE_EQ(tracker.end_plan(1.0), 0.0);
+
+  tracker.start_plan(100.0, 0.0);
+  EXPECT_TRUE(tracker.is_plan_running());
+  EXPECT_NEAR(tracker.get_predicted_remaining_s(40.0), 60.0, 1e-9);
+  EXPECT_NEAR(tracker.get_predicted_remaining_s(150.0), 0.0, 1e-9);
+  EXPECT_DOUBLE_EQ(tracker.end_plan(30.0, false), 0.0);
+  EXPECT_FALSE(tracker.is_plan_running());
+
+  tracker.start_plan(50.0, 30.0);
+  EXPECT_NEAR(tracker.end_plan(90.0), 10.0, 1e-9);
+
+  EXPECT_EQ(tracker.get_num_completed_plans(), 1);
+  EXPECT_NEAR(tracker.get_mission_predicted_s(), 50.0, 1e-9);
+  EXPECT_NEAR(tracker.get_mission_actual_s(), 60.0, 1e-9);
+  EXPECT_NEAR(tracker.get_mission_relative_error(), 0.2, 1e-9);
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "automated_planning/action_readiness.hpp"
+
+
+class ConnectionReadinessCacheTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    cache_.add_connection("set_equipment_numbers", [this](){ num_checks_++; return service_ready_.load(); });
+    cache_.add_connection("move_to_ned", [this](){ num_checks_++; return action_server_ready_.load(); });
+  }
+
+  ConnectionReadinessCache cache_;
+  std::atomic<bool> service_ready_{ false };
+  std::atomic<bool> action_server_ready_{ true };
+  std::atomic<int> num_checks_{ 0 };
+};
+
+
+TEST_F(ConnectionReadinessCacheTest, NothingIsReadyBeforeTheFirstUpdate)
+{
+  EXPECT_EQ(cache_.get_num_connections(), 2u);
+  EXPECT_FALSE(cache_.is_all_ready());
+  EXPECT_FALSE(cache_.is_ready("move_to_ned"));
+  EXPECT_LT(cache_.get_last_ready_s("move_to_ned"), 0.0);
+  EXPECT_EQ(num_checks_, 0);
+}
+
+
+TEST_F(ConnectionReadinessCacheTest, UpdateCachesTheState)
+{
+  EXPECT_FALSE(cache_.update(1.0));
+  EXPECT_TRUE(cache_.is_ready("move_to_ned"));
+  EXPECT_FALSE(cache_.is_ready("set_equipment_numbers"));
+  EXPECT_EQ(cache_.get_unready_connections(), std::vector<std::string>{ "set_equipment_numbers" });
+  EXPECT_DOUBLE_EQ(cache_.get_last_ready_s("move_to_ned"), 1.0);
+
+  service_ready_ = true;
+  EXPECT_TRUE(cache_.update("set_equipment_numbers", 2.0));
+  EXPECT_TRUE(cache_.is_all_ready());
+  EXPECT_TRUE(cache_.get_unready_connections().empty());
+
+  // A server which disappears keeps the time it was last seen
+  action_server_ready_ = false;
+  EXPECT_FALSE(cache_.update(3.0));
+  EXPECT_DOUBLE_EQ(cache_.get_last_ready_s("move_to_ned"), 1.0);
+  EXPECT_DOUBLE_EQ(cache_.get_last_ready_s("set_equipment_numbers"), 3.0);
+
+  EXPECT_FALSE(cache_.update("unknown", 4.0));
+  EXPECT_FALSE(cache_.is_ready("unknown"));
+}
+
+
+TEST_F(ConnectionReadinessCacheTest, CachedConnectionsDoNotWait)
+{
+  cache_.update(0.0);
+  int num_checks = num_checks_;
+
+  EXPECT_TRUE(cache_.wait_until_ready("move_to_ned", 10.0));
+  EXPECT_EQ(num_checks_, num_checks);
+}
+
+
+TEST_F(ConnectionReadinessCacheTest, WaitPollsUntilTheServerAppears)
+{
+  std::thread server([this]()
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    service_ready_ = true;
+  });
+
+  EXPECT_TRUE(cache_.wait_until_ready("set_equipment_numbers", 5.0));
+  EXPECT_TRUE(cache_.is_ready("set_equipment_numbers"));
+  server.join();
+}
+
+
+TEST_F(ConnectionReadinessCacheTest, WaitGivesUpAtTheTimeout)
+{
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(cache_.wait_until_ready("set_equipment_numbers", 0.1));
+  const double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  EXPECT_GE(elapsed_s, 0.1);
+  EXPECT_LT(elapsed_s, 2.0);
+  EXPECT_FALSE(cache_.wait_until_ready("unknown", 0.1));
+}
+
+
+TEST(ActivationLatencyStatistics, PercentilesAreTakenOverTheWindow)
+{
+  ActivationLatencyStatistics statistics(10);
+  for(int i = 1; i <= 10; i++)
+  {
+    statistics.add_sample(0.01 * i, i != 3);
+  }
+
+  const ActivationLatencySummary& summary = statistics.get_summary();
+  EXPECT_EQ(summary.num_activations, 10);
+  EXPECT_EQ(summary.num_failed_activations, 1);
+  EXPECT_DOUBLE_EQ(summary.last_s, 0.10);
+  EXPECT_NEAR(summary.mean_s, 0.055, 1e-9);
+  EXPECT_DOUBLE_EQ(summary.p50_s, 0.05);
+  EXPECT_DOUBLE_EQ(summary.p95_s, 0.10);
+  EXPECT_DOUBLE_EQ(summary.max_s, 0.10);
+
+  // Slow activations leave the window, while the counters cover the whole run
+  for(int i = 0; i < 10; i++)
+  {
+    statistics.add_sample(0.002, true);
+  }
+  EXPECT_EQ(statistics.get_summary().num_activations, 20);
+  EXPECT_DOUBLE_EQ(statistics.get_summary().max_s, 0.002);
+}
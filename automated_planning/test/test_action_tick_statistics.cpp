@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "automated_planning/action_tick_statistics.hpp"
+
+
+class ActionTickStatisticsTest : public ::testing::Test
+{
+protected:
+  /**
+   * @brief Telemetry at each of @p latencies_s, each handled by a tick after the latency
+   */
+  void react_(const std::vector<double>& latencies_s)
+  {
+    for(double latency_s : latencies_s)
+    {
+      statistics_.add_event(time_s_);
+      time_s_ += latency_s;
+      statistics_.add_tick(time_s_, true);
+      time_s_ += 1.0;
+    }
+  }
+
+  ActionTickStatistics statistics_{ 4 };
+  double time_s_{ 10.0 };
+};
+
+
+TEST_F(ActionTickStatisticsTest, ActivationIsSummarized)
+{
+  EXPECT_FALSE(statistics_.is_active());
+  statistics_.begin_activation(10.0, 2.0);
+  EXPECT_TRUE(statistics_.is_active());
+
+  statistics_.add_tick(10.1, false);
+  statistics_.add_event(10.15);
+  statistics_.add_tick(10.2, true);
+  statistics_.end_activation(12.0, 2.5);
+  EXPECT_FALSE(statistics_.is_active());
+
+  const ActionTickSummary& summary = statistics_.get_summary();
+  EXPECT_EQ(summary.num_activations, 1);
+  EXPECT_EQ(summary.num_ticks, 2);
+  EXPECT_EQ(summary.num_event_ticks, 1);
+  EXPECT_EQ(summary.num_events, 1);
+  EXPECT_DOUBLE_EQ(summary.active_duration_s, 2.0);
+  EXPECT_DOUBLE_EQ(summary.active_cpu_usage, 25.0);
+
+  // Not known before the node has been idle
+  EXPECT_DOUBLE_EQ(summary.idle_cpu_usage, 0.0);
+}
+
+
+TEST_F(ActionTickStatisticsTest, IdleUsageIsTakenBetweenTheActivations)
+{
+  statistics_.begin_activation(0.0, 0.0);
+  statistics_.add_tick(0.1, false);
+  statistics_.end_activation(1.0, 0.5);
+
+  statistics_.begin_activation(11.0, 0.6);
+  const ActionTickSummary& summary = statistics_.get_summary();
+  EXPECT_EQ(summary.num_activations, 2);
+  EXPECT_DOUBLE_EQ(summary.idle_cpu_usage, 1.0);
+
+  // The latest activation starts from zero
+  EXPECT_EQ(summary.num_ticks, 0);
+  EXPECT_DOUBLE_EQ(summary.active_duration_s, 0.0);
+
+  // A second end is ignored
+  statistics_.end_activation(12.0, 0.7);
+  statistics_.end_activation(20.0, 0.7);
+  EXPECT_DOUBLE_EQ(summary.active_duration_s, 1.0);
+}
+
+
+TEST_F(ActionTickStatisticsTest, OnlyTheOldestWaitingEventGivesALatency)
+{
+  statistics_.begin_activation(0.0, 0.0);
+  statistics_.add_event(1.0);
+  statistics_.add_event(1.3);
+  statistics_.add_event(1.4);
+  statistics_.add_tick(1.5, true);
+
+  // Ticks without a waiting event have no latency
+  statistics_.add_tick(2.0, false);
+
+  const ActionTickSummary& summary = statistics_.get_summary();
+  EXPECT_EQ(summary.num_events, 3);
+  EXPECT_DOUBLE_EQ(summary.mean_reaction_s, 0.5);
+  EXPECT_DOUBLE_EQ(summary.max_reaction_s, 0.5);
+
+  // Events before the first tick of the activation are handled by it
+  statistics_.end_activation(3.0, 0.0);
+  statistics_.add_event(3.5);
+  statistics_.begin_activation(4.0, 0.0);
+  statistics_.add_tick(4.1, false);
+  EXPECT_EQ(summary.num_events, 0);
+  EXPECT_DOUBLE_EQ(summary.max_reaction_s, 0.5);
+}
+
+
+TEST_F(ActionTickStatisticsTest, LatenciesAreTakenOverTheWindow)
+{
+  statistics_.begin_activation(time_s_, 0.0);
+  react_({ 0.4, 0.1, 0.3, 0.2 });
+
+  const ActionTickSummary& summary = statistics_.get_summary();
+  EXPECT_NEAR(summary.mean_reaction_s, 0.25, 1e-9);
+  EXPECT_NEAR(summary.p50_reaction_s, 0.2, 1e-9);
+  EXPECT_NEAR(summary.p95_reaction_s, 0.4, 1e-9);
+  EXPECT_NEAR(summary.max_reaction_s, 0.4, 1e-9);
+
+  // The slowest reaction leaves the window of 4
+  react_({ 0.05 });
+  EXPECT_NEAR(summary.mean_reaction_s, 0.1625, 1e-9);
+  EXPECT_NEAR(summary.p50_reaction_s, 0.1, 1e-9);
+  EXPECT_NEAR(summary.max_reaction_s, 0.3, 1e-9);
+}
+
+
+TEST(ActionTickStatistics, ProcessCpuTimeIncreases)
+{
+  const double cpu_time_s = ActionTickStatistics::get_process_cpu_time_s();
+  volatile double sum = 0.0;
+  for(int i = 0; i < 10000000; i++)
+  {
+    sum = sum + std::sqrt(static_cast<double>(i));
+  }
+  EXPECT_GT(ActionTickStatistics::get_process_cpu_time_s(), cpu_time_s);
+}
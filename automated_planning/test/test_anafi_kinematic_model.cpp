@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "automated_planning/anafi_kinematic_model.hpp"
+
+
+class AnafiKinematicModelTest : public ::testing::Test
+{
+protected:
+  void run_(double duration_s)
+  {
+    const double dt = 0.02;
+    for(double time_s = 0.0; time_s < duration_s; time_s += dt)
+    {
+      model_.step(dt);
+    }
+  }
+
+  void takeoff_()
+  {
+    model_.takeoff();
+    run_(params_.motor_ramping_duration + 2.0 * params_.takeoff_altitude / params_.takeoff_speed + 2.0);
+    ASSERT_EQ(model_.get_flying_state(), AnafiFlyingState::HOVERING);
+  }
+
+  AnafiKinematicParameters params_;
+  AnafiKinematicModel model_{ params_ };
+};
+
+
+TEST_F(AnafiKinematicModelTest, TakeoffPassesThroughTheOlympeStates)
+{
+  EXPECT_EQ(model_.get_flying_state_string(), "FS_LANDED");
+  run_(5.0);
+  EXPECT_EQ(model_.get_flying_state(), AnafiFlyingState::LANDED);
+  EXPECT_DOUBLE_EQ(model_.get_battery(), params_.initial_battery);
+
+  model_.takeoff();
+  EXPECT_EQ(model_.get_flying_state_string(), "FS_MOTOR_RAMPING");
+  run_(params_.motor_ramping_duration + 0.1);
+  EXPECT_EQ(model_.get_flying_state_string(), "FS_TAKINGOFF");
+
+  takeoff_();
+  EXPECT_NEAR(-model_.get_position_ned().z(), params_.takeoff_altitude, 0.2);
+  EXPECT_LT(model_.get_battery(), params_.initial_battery);
+}
+
+
+TEST_F(AnafiKinematicModelTest, CommandsAreIgnoredOnTheGround)
+{
+  model_.move_to(Eigen::Vector3d(10.0, 0.0, -2.0));
+  model_.move_by(1.0, 0.0, 0.0, 0.0);
+  model_.land();
+  run_(5.0);
+
+  EXPECT_EQ(model_.get_flying_state(), AnafiFlyingState::LANDED);
+  EXPECT_TRUE(model_.get_position_ned().isZero());
+}
+
+
+TEST_F(AnafiKinematicModelTest, MoveToRespectsTheSpeedLimitAndHovers)
+{
+  takeoff_();
+  model_.move_to(Eigen::Vector3d(30.0, 40.0, -5.0));
+  run_(0.1);
+
+  double max_horizontal_speed = 0.0;
+  double max_vertical_speed = 0.0;
+  for(int i = 0; i < 2000 && model_.get_flying_state() != AnafiFlyingState::HOVERING; i++)
+  {
+    run_(0.1);
+    max_horizontal_speed = std::max(max_horizontal_speed, model_.get_velocity_ned().head<2>().norm());
+    max_vertical_speed = std::max(max_vertical_speed, std::abs(model_.get_velocity_ned().z()));
+    if(i == 20)
+    {
+      EXPECT_EQ(model_.get_flying_state_string(), "FS_FLYING");
+    }
+  }
+
+  EXPECT_EQ(model_.get_flying_state(), AnafiFlyingState::HOVERING);
+  EXPECT_NEAR((model_.get_position_ned() - Eigen::Vector3d(30.0, 40.0, -5.0)).norm(), 0.0, params_.hover_position_tolerance);
+  EXPECT_LE(max_horizontal_speed, params_.max_horizontal_speed + 1e-6);
+  EXPECT_LE(max_vertical_speed, params_.max_vertical_speed + 1e-6);
+}
+
+
+TEST_F(AnafiKinematicModelTest, MoveByIsGivenInTheBodyFrame)
+{
+  takeoff_();
+
+  // Turn to east, then move forward
+  model_.move_by(0.0, 0.0, 0.0, M_PI / 2);
+  run_(5.0);
+  EXPECT_NEAR(model_.get_yaw(), M_PI / 2, 0.05);
+
+  const Eigen::Vector3d start_position_ned = model_.get_position_ned();
+  model_.move_by(5.0, 0.0, 0.0, 0.0);
+  run_(1.0);
+  EXPECT_GT(model_.get_velocity_body().x(), 0.5);
+  EXPECT_NEAR(model_.get_velocity_body().y(), 0.0, 1e-3);
+
+  run_(20.0);
+  const Eigen::Vector3d displacement_ned = model_.get_position_ned() - start_position_ned;
+  EXPECT_NEAR(displacement_ned.x(), 0.0, 0.1);
+  EXPECT_NEAR(displacement_ned.y(), 5.0, 0.1);
+}
+
+
+TEST_F(AnafiKinematicModelTest, LandingStopsOnTheGround)
+{
+  takeoff_();
+  model_.land();
+  EXPECT_EQ(model_.get_flying_state_string(), "FS_LANDING");
+  run_(2.0 * params_.takeoff_altitude / params_.landing_speed + 2.0);
+
+  EXPECT_EQ(model_.get_flying_state(), AnafiFlyingState::LANDED);
+  EXPECT_DOUBLE_EQ(model_.get_position_ned().z(), 0.0);
+  EXPECT_TRUE(model_.get_velocity_ned().isZero());
+}
+
+
+TEST(AnafiKinematicModel, EmptyBatteryForcesALanding)
+{
+  AnafiKinematicParameters params;
+  params.battery_forced_landing = 10.0;
+  AnafiKinematicModel model(params);
+
+  model.takeoff();
+  for(int i = 0; i < 500; i++)
+  {
+    model.step(0.02);
+  }
+  ASSERT_EQ(model.get_flying_state(), AnafiFlyingState::HOVERING);
+
+  model.drain_battery(95.0);
+  model.step(0.02);
+  EXPECT_EQ(model.get_flying_state(), AnafiFlyingState::LANDING);
+
+  for(int i = 0; i < 500; i++)
+  {
+    model.step(0.02);
+  }
+  EXPECT_EQ(model.get_flying_state(), AnafiFlyingState::LANDED);
+
+  // Too little battery to take off again
+  model.takeoff();
+  EXPECT_EQ(model.get_flying_state(), AnafiFlyingState::LANDED);
+}
@@ -0,0 +1,110 @@
+"""
+Tests of the parts of the batch runner which do not need ROS: the seeded injection schedule,
+the scenario files and the summary of the results
+"""
+import argparse
+import math
+import os
+import sys
+
+import pytest
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'bash_scripts'))
+import batch_runner  # noqa: E402
+
+MISSION_PARAMS_FILE = os.path.join(
+  os.path.dirname(os.path.abspath(__file__)), '..', 'config', 'mission_parameters.yaml')
+
+
+def scenario_args(*argv):
+  parser = argparse.ArgumentParser()
+  batch_runner.add_scenario_arguments(parser)
+  return parser.parse_args(list(argv))
+
+
+def result(seed, success, makespan=None, num_replans=0, outcome=None):
+  return {
+    'seed': seed, 'success': success, 'makespan': makespan, 'num_replans': num_replans,
+    'planner_time': 0.5, 'wall_time': 60.0, 'outcome': outcome or ('completed' if success else 'failed')
+  }
+
+
+def test_schedule_is_given_by_the_seed():
+  args = scenario_args('--max-detections', '3', '--battery-drop-probability', '0.5', '--emergency-probability', '0.5')
+  locations = {'l1': (10.0, 0.0), 'l2': (0.0, 20.0)}
+
+  assert batch_runner.create_injection_schedule(7, locations, args) == \
+    batch_runner.create_injection_schedule(7, locations, args)
+  assert any(batch_runner.create_injection_schedule(7, locations, args) !=
+             batch_runner.create_injection_schedule(seed, locations, args) for seed in range(8, 20))
+
+
+def test_schedule_is_sorted_and_within_the_injection_window():
+  args = scenario_args('--max-detections', '4', '--detection-hits', '3', '--detection-period', '0.5',
+                       '--battery-drop-probability', '1.0', '--emergency-probability', '1.0')
+  locations = {'l1': (10.0, 0.0)}
+
+  for seed in range(50):
+    schedule = batch_runner.create_injection_schedule(seed, locations, args)
+    times = [t for t, _, _ in schedule]
+    assert times == sorted(times)
+
+    kinds = [kind for _, kind, _ in schedule]
+    assert kinds.count('battery_drop') == 1
+    assert kinds.count('emergency') == 1
+    assert kinds.count('detection') % args.detection_hits == 0
+
+    for t, kind, data in schedule:
+      max_time = args.max_injection_time + (args.detection_hits - 1) * args.detection_period
+      assert args.min_injection_time <= t <= max_time
+      if kind == 'battery_drop':
+        assert args.min_battery_drop <= data <= args.max_battery_drop
+      elif kind == 'detection':
+        north, east, severity = data
+        assert abs(north - 10.0) < 10.0 and abs(east) < 10.0
+        assert severity in (0, 1, 2)
+
+
+def test_search_locations_are_read_from_the_mission_parameters():
+  locations = batch_runner.load_search_locations(MISSION_PARAMS_FILE)
+  assert locations
+  for north_east in locations.values():
+    assert len(north_east) == 2
+
+
+def test_observer_gets_the_scenario_arguments():
+  args = scenario_args('--max-detections', '5', '--emergency-probability', '0.25')
+  observer_args = batch_runner.observer_arguments(args, 3, 'mission.yaml')
+
+  assert observer_args[2:7] == ['observe', '--seed', '3', '--mission-params-file', 'mission.yaml']
+  assert observer_args[observer_args.index('--max-detections') + 1] == '5'
+  assert observer_args[observer_args.index('--emergency-probability') + 1] == '0.25'
+
+
+def test_percentile_uses_the_nearest_rank():
+  values = [float(v) for v in range(1, 21)]
+  assert batch_runner.percentile(values, 50) == 10.0
+  assert batch_runner.percentile(values, 95) == 19.0
+  assert batch_runner.percentile(values, 100) == 20.0
+  assert batch_runner.percentile([3.0], 95) == 3.0
+  assert math.isnan(batch_runner.percentile([], 50))
+  assert math.isnan(batch_runner.mean([]))
+
+
+def test_summary_only_includes_makespans_of_successful_missions():
+  results = [
+    result(0, True, 100.0, 1),
+    result(1, True, 300.0, 3),
+    result(2, False, 5000.0, 2),
+    result(3, False, outcome='crashed'),
+  ]
+  summary = batch_runner.summarize(results)
+
+  assert 'Missions:      4 (completed: 2, crashed: 1, failed: 1)' in summary
+  assert 'Success rate:  50.0 %' in summary
+  assert 'max 300.0 s' in summary
+  assert 'Replans:       mean 1.50, max 3' in summary
+
+
+if __name__ == '__main__':
+  sys.exit(pytest.main([__file__]))
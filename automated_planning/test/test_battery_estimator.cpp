@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+
+#include "automated_planning/battery_estimator.hpp"
+
+
+namespace
+{
+
+/**
+ * @brief Samples the charge at 1 Hz while discharging at @p rate, quantized to whole
+ * percentages as reported by the Anafi
+ *
+ * @return Number of segments used by the estimator
+ */
+int fly(
+  BatteryDischargeEstimator& estimator,
+  const std::string& action_type,
+  double rate,
+  double& time_s,
+  double& charge,
+  double duration_s
+)
+{
+  int num_updates = 0;
+  for(double end_time_s = time_s + duration_s; time_s < end_time_s; time_s += 1.0)
+  {
+    num_updates += estimator.add_sample(time_s, std::floor(charge), action_type);
+    charge -= rate;
+  }
+  return num_updates;
+}
+
+} // namespace
+
+
+TEST(BatteryDischargeEstimator, UnknownActionsUseTheDefaultRate)
+{
+  BatteryDischargeEstimator estimator(0.05);
+  estimator.set_prior("move", 0.1);
+
+  EXPECT_DOUBLE_EQ(estimator.get_rate("move"), 0.1);
+  EXPECT_DOUBLE_EQ(estimator.get_rate("search"), 0.05);
+  EXPECT_GT(estimator.get_rate("move", true), estimator.get_rate("move"));
+  EXPECT_EQ(estimator.get_num_observations("move"), 0);
+}
+
+
+TEST(BatteryDischargeEstimator, QuantizedSamplesConvergeToTheDischargeRate)
+{
+  BatteryDischargeEstimator estimator(0.05);
+  estimator.set_prior("move", 0.05);
+
+  double time_s = 0.0;
+  double charge = 100.0;
+  int num_updates = fly(estimator, "move", 0.08, time_s, charge, 900.0);
+
+  EXPECT_GE(num_updates, 25);
+  EXPECT_EQ(estimator.get_num_observations("move"), num_updates);
+  EXPECT_NEAR(estimator.get_rate("move"), 0.08, 0.015);
+  EXPECT_GT(estimator.get_rate("move", true), estimator.get_rate("move"));
+}
+
+
+TEST(BatteryDischargeEstimator, SegmentsFollowTheActionType)
+{
+  BatteryDischargeEstimator estimator(0.05);
+
+  double time_s = 0.0;
+  double charge = 100.0;
+  for(int i = 0; i < 10; i++)
+  {
+    fly(estimator, "search", 0.12, time_s, charge, 60.0);
+    fly(estimator, "land", 0.02, time_s, charge, 60.0);
+  }
+
+  EXPECT_NEAR(estimator.get_rate("search"), 0.12, 0.03);
+  EXPECT_NEAR(estimator.get_rate("land"), 0.02, 0.03);
+  EXPECT_LT(estimator.get_rate("land"), estimator.get_rate("search"));
+}
+
+
+TEST(BatteryDischargeEstimator, ShortSegmentsAndIdleTimeAreIgnored)
+{
+  BatteryDischargeEstimator estimator(0.05, 0.98, 10.0, 30.0);
+
+  double time_s = 0.0;
+  double charge = 100.0;
+  for(int i = 0; i < 20; i++)
+  {
+    // Too short to be seen through the quantization
+    fly(estimator, "drop_marker", 0.5, time_s, charge, 5.0);
+    fly(estimator, "", 0.01, time_s, charge, 40.0);
+  }
+
+  EXPECT_EQ(estimator.get_num_observations("drop_marker"), 0);
+  EXPECT_EQ(estimator.get_num_observations(""), 0);
+  EXPECT_DOUBLE_EQ(estimator.get_rate("drop_marker"), 0.05);
+}
+
+
+TEST(BatteryDischargeEstimator, RechargeRestartsTheSegment)
+{
+  BatteryDischargeEstimator estimator(0.05);
+  estimator.set_prior("move", 0.05);
+
+  EXPECT_FALSE(estimator.add_sample(0.0, 20.0, "move"));
+  EXPECT_FALSE(estimator.add_sample(20.0, 90.0, "move"));
+
+  // The segment is measured from the new battery
+  EXPECT_TRUE(estimator.add_sample(50.0, 87.0, "move"));
+  EXPECT_GT(estimator.get_rate("move"), 0.05);
+  EXPECT_LT(estimator.get_rate("move"), 0.1 + 1e-9);
+
+  // Invalid samples are dropped
+  EXPECT_FALSE(estimator.add_sample(80.0, std::nan(""), "move"));
+  EXPECT_FALSE(estimator.add_sample(80.0, -1.0, "move"));
+  EXPECT_EQ(estimator.get_num_observations("move"), 1);
+}
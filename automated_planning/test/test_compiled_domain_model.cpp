@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "automated_planning/compiled_domain_model.hpp"
+#include "sar_domain.hpp"
+
+
+namespace
+{
+  /**
+   * @brief The drone hovering at a, with b left to search
+   */
+  const char* const PROBLEM = R"(
+(define (problem test_compiled_domain_model)
+  (:domain sar)
+  (:objects
+    d - drone
+    a b - location
+  )
+  (:init
+    (drone_at d a) (path a b) (available b) (not_searched a) (not_searched b)
+    (not_landed d) (not_moving d) (not_searching d) (not_rescuing d) (not_marking d) (not_tracking d)
+    (= (battery_charge d) 80) (= (move_battery_usage d) 0.1) (= (track_battery_usage d) 0.1)
+    (= (move_duration a b) 10) (= (search_duration a) 30) (= (search_duration b) 60)
+  )
+  (:goal (and (searched b)))
+)
+)";
+}
+
+
+class CompiledDomainModelTest : public testing::Test
+{
+protected:
+  CompiledDomainModelTest()
+  : problem_(PddlProblem::parse(PROBLEM))
+  , model_(load_sar_domain())
+  {}
+
+  SarDomainModel::State make_state_() const
+  {
+    return model_.make_state(problem_.predicates, problem_.functions);
+  }
+
+  PddlProblem problem_;
+  SarDomainModel model_;
+};
+
+
+TEST_F(CompiledDomainModelTest, ValidPlanReachesTheGoal)
+{
+  SarDomainModel::CompiledPlan plan = model_.compile_plan({ { "(move d a b)", 0.0, 10.0 }, { "(search d b)", 10.0, 60.0 } });
+  SarDomainModel::CompiledGoal goal = model_.compile_goal(problem_.goals);
+  SarDomainModel::State state = make_state_();
+
+  EXPECT_FALSE(model_.is_satisfied(goal, state));
+
+  SarDomainModel::ValidationResult result = model_.validate(plan, state, 1e-3);
+  EXPECT_TRUE(result.is_valid) << model_.describe(result, plan);
+  EXPECT_DOUBLE_EQ(result.makespan_s, 70.0);
+  EXPECT_TRUE(model_.is_satisfied(goal, result.final_state));
+  EXPECT_TRUE(model_.holds(result.final_state, "(drone_at d b)"));
+  EXPECT_FALSE(model_.holds(result.final_state, "(drone_at d a)"));
+  EXPECT_DOUBLE_EQ(model_.get_function(result.final_state, "(battery_charge d)").value(), 73.0);
+
+  // Simulation applies the same effects
+  SarDomainModel::State final_state = model_.simulate(plan, state);
+  EXPECT_EQ(final_state.facts, result.final_state.facts);
+  EXPECT_DOUBLE_EQ(model_.get_function(final_state, "(battery_charge d)").value(), 73.0);
+}
+
+
+TEST_F(CompiledDomainModelTest, GroundActionsAreShared)
+{
+  model_.compile_plan({ { "(move d a b)", 0.0, 10.0 } });
+  model_.compile_plan({ { "(move d a b)", 0.0, 10.0 }, { "(search d b)", 10.0, 60.0 } });
+  EXPECT_EQ(model_.get_num_ground_actions(), 2u);
+  EXPECT_EQ(model_.get_action(1), "(search d b)");
+
+  size_t num_facts = model_.get_num_facts();
+  model_.compile_plan({ { "(search d b)", 0.0, 60.0 }, { "(move d a b)", 60.0, 10.0 } });
+  EXPECT_EQ(model_.get_num_ground_actions(), 2u);
+  EXPECT_EQ(model_.get_num_facts(), num_facts);
+}
+
+
+TEST_F(CompiledDomainModelTest, OverlappingActionsViolateTheStartCondition)
+{
+  SarDomainModel::CompiledPlan plan = model_.compile_plan({ { "(move d a b)", 0.0, 10.0 }, { "(search d b)", 5.0, 60.0 } });
+  SarDomainModel::ValidationResult result = model_.validate(plan, make_state_());
+
+  EXPECT_FALSE(result.is_valid);
+  EXPECT_EQ(result.failure, SarDomainModel::Failure::START_CONDITION);
+  EXPECT_EQ(result.item_idx, 1u);
+  EXPECT_DOUBLE_EQ(result.time_s, 5.0);
+  EXPECT_NE(model_.describe(result, plan).find("(drone_at d b) does not hold"), std::string::npos);
+}
+
+
+TEST_F(CompiledDomainModelTest, MovingDuringASearchViolatesTheOverAllCondition)
+{
+  SarDomainModel::CompiledPlan plan = model_.compile_plan({ { "(search d a)", 0.0, 30.0 }, { "(move d a b)", 0.0, 10.0 } });
+  SarDomainModel::ValidationResult result = model_.validate(plan, make_state_());
+
+  EXPECT_EQ(result.failure, SarDomainModel::Failure::OVER_ALL_CONDITION);
+  EXPECT_EQ(result.item_idx, 0u);
+  EXPECT_NE(model_.describe(result, plan).find("over all (not_moving d) does not hold"), std::string::npos);
+}
+
+
+TEST_F(CompiledDomainModelTest, LowBatteryIsNamedInTheDescription)
+{
+  SarDomainModel::CompiledPlan plan = model_.compile_plan({ { "(move d a b)", 0.0, 10.0 }, { "(search d b)", 10.0, 60.0 } });
+  std::vector<std::pair<PddlAtom, double>> functions = problem_.functions;
+  for(std::pair<PddlAtom, double>& function : functions)
+  {
+    if(function.first.name == "battery_charge")
+    {
+      function.second = 5.0;
+    }
+  }
+  SarDomainModel::State state = model_.make_state(problem_.predicates, functions);
+
+  SarDomainModel::ValidationResult result = model_.validate(plan, state);
+  EXPECT_EQ(result.failure, SarDomainModel::Failure::START_CONDITION);
+  EXPECT_EQ(result.item_idx, 1u);
+  EXPECT_NE(model_.describe(result, plan).find("battery_charge d"), std::string::npos);
+}
+
+
+TEST_F(CompiledDomainModelTest, DurationIsCheckedAgainstTheDomain)
+{
+  SarDomainModel::CompiledPlan plan = model_.compile_plan({ { "(move d a b)", 0.0, 20.0 } });
+
+  EXPECT_TRUE(model_.validate(plan, make_state_()).is_valid);
+
+  SarDomainModel::ValidationResult result = model_.validate(plan, make_state_(), 1.0);
+  EXPECT_EQ(result.failure, SarDomainModel::Failure::DURATION);
+}
+
+
+TEST_F(CompiledDomainModelTest, UndefinedFunctionsAreReported)
+{
+  SarDomainModel::CompiledPlan plan = model_.compile_plan({ { "(move d a b)", 0.0, 10.0 } });
+  SarDomainModel::State state = model_.make_state(problem_.predicates, {});
+
+  SarDomainModel::ValidationResult result = model_.validate(plan, state);
+  EXPECT_EQ(result.failure, SarDomainModel::Failure::UNDEFINED_FUNCTION);
+  EXPECT_FALSE(model_.get_function(model_.simulate(plan, state), "(battery_charge d)").has_value());
+}
+
+
+TEST_F(CompiledDomainModelTest, StateMustBeMadeAfterThePlanIsCompiled)
+{
+  SarDomainModel::State state = make_state_();
+  SarDomainModel::CompiledPlan plan = model_.compile_plan({ { "(move d a b)", 0.0, 10.0 } });
+
+  SarDomainModel::ValidationResult result = model_.validate(plan, state);
+  EXPECT_EQ(result.failure, SarDomainModel::Failure::STALE_STATE);
+  EXPECT_TRUE(model_.validate(plan, make_state_()).is_valid);
+}
+
+
+TEST(CompiledDomainModel, UnknownActionsAndFullCapacitiesThrow)
+{
+  SarDomainModel model(load_sar_domain());
+  EXPECT_THROW(model.compile_plan({ { "(fly d a b)", 0.0, 10.0 } }), std::runtime_error);
+  EXPECT_THROW(model.compile_plan({ { "(move d a)", 0.0, 10.0 } }), std::runtime_error);
+
+  CompiledDomainModel<4, 16> small_model(load_sar_domain());
+  EXPECT_THROW(small_model.compile_plan({ { "(move d a b)", 0.0, 10.0 } }), std::runtime_error);
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "automated_planning/execution_feedback_aggregator.hpp"
+
+
+namespace
+{
+  ActionFeedbackSample sample(
+    const std::string& action_full_name,
+    const std::string& action_type,
+    const std::vector<std::string>& arguments,
+    ActionStatus status,
+    double start_time_s,
+    double status_time_s,
+    double completion=0.0)
+  {
+    return ActionFeedbackSample{ action_full_name, action_type, arguments, status, start_time_s, status_time_s, completion };
+  }
+}
+
+
+class ExecutionFeedbackAggregatorTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // Started at 100 s. The drone searches l1 twice, as the first search found nobody
+    aggregator_.start_plan({
+      { "(move d0 h0 l1)", 0.0, 10.0 },
+      { "(search d0 l1)", 10.0, 30.0 },
+      { "(search d0 l1)", 40.0, 30.0 },
+    }, 100.0);
+  }
+
+  ExecutionFeedbackAggregator aggregator_{ 20 };
+};
+
+
+TEST_F(ExecutionFeedbackAggregatorTest, ActionsAreSortedByThePlannedStart)
+{
+  aggregator_.start_plan({
+    { "(land d0 h0)", 50.0, 10.0 },
+    { "(move d0 l1 h0)", 0.0, 50.0 },
+  }, 0.0);
+
+  const std::vector<ActionTiming>& actions = aggregator_.get_actions();
+  ASSERT_EQ(actions.size(), 2u);
+  EXPECT_EQ(actions[0].action, "(move d0 l1 h0)");
+  EXPECT_EQ(actions[0].action_type, "move");
+  EXPECT_EQ(actions[1].action_type, "land");
+  EXPECT_LT(actions[1].actual_start_s, 0.0);
+}
+
+
+TEST_F(ExecutionFeedbackAggregatorTest, TimingFollowsTheFeedback)
+{
+  aggregator_.update({ sample("move_d0_h0_l1_1", "move", { "d0", "h0", "l1" }, ActionStatus::EXECUTING, 101.0, 105.0, 0.4) }, 105.0);
+
+  const ActionTiming& move = aggregator_.get_actions()[0];
+  EXPECT_EQ(move.status, ActionStatus::EXECUTING);
+  EXPECT_DOUBLE_EQ(move.completion, 0.4);
+  EXPECT_DOUBLE_EQ(move.actual_start_s, 1.0);
+  EXPECT_DOUBLE_EQ(move.actual_duration_s, 4.0);
+  EXPECT_FALSE(move.is_finished);
+
+  aggregator_.update({ sample("move_d0_h0_l1_1", "move", { "d0", "h0", "l1" }, ActionStatus::SUCCEEDED, 101.0, 113.0, 1.0) }, 114.0);
+  EXPECT_TRUE(move.is_finished);
+  EXPECT_DOUBLE_EQ(move.actual_duration_s, 12.0);
+
+  // Repeated feedback of a finished action is ignored
+  aggregator_.update({ sample("move_d0_h0_l1_1", "move", { "d0", "h0", "l1" }, ActionStatus::SUCCEEDED, 101.0, 120.0, 1.0) }, 120.0);
+  EXPECT_DOUBLE_EQ(move.actual_duration_s, 12.0);
+
+  std::vector<ActionTypeStatistics> statistics = aggregator_.get_statistics();
+  ASSERT_EQ(statistics.size(), 1u);
+  EXPECT_EQ(statistics[0].num_succeeded, 1u);
+  EXPECT_DOUBLE_EQ(statistics[0].mean_duration_error_s, 2.0);
+  EXPECT_DOUBLE_EQ(statistics[0].mean_start_delay_s, 1.0);
+}
+
+
+TEST_F(ExecutionFeedbackAggregatorTest, RepeatedActionsKeepTheirPlanItem)
+{
+  // The second search is seen first, and is still given the first free plan item
+  aggregator_.update({ sample("search_d0_l1_2", "search", { "d0", "l1" }, ActionStatus::NOT_EXECUTED, 0.0, 100.0) }, 100.0);
+  aggregator_.update({
+    sample("search_d0_l1_1", "search", { "d0", "l1" }, ActionStatus::EXECUTING, 110.0, 115.0),
+    sample("search_d0_l1_2", "search", { "d0", "l1" }, ActionStatus::NOT_EXECUTED, 0.0, 115.0),
+  }, 115.0);
+
+  const std::vector<ActionTiming>& actions = aggregator_.get_actions();
+  EXPECT_EQ(actions[1].status, ActionStatus::NOT_EXECUTED);
+  EXPECT_EQ(actions[2].status, ActionStatus::EXECUTING);
+  EXPECT_DOUBLE_EQ(actions[2].actual_start_s, 10.0);
+
+  // Feedback of actions outside the plan is dropped
+  aggregator_.update({ sample("land_d0_h0_1", "land", { "d0", "h0" }, ActionStatus::EXECUTING, 110.0, 115.0) }, 115.0);
+  EXPECT_TRUE(aggregator_.get_statistics().empty());
+}
+
+
+TEST_F(ExecutionFeedbackAggregatorTest, NewPlanCancelsTheExecutingActions)
+{
+  aggregator_.update({ sample("move_d0_h0_l1_1", "move", { "d0", "h0", "l1" }, ActionStatus::EXECUTING, 100.0, 104.0) }, 104.0);
+  aggregator_.start_plan({ { "(land d0 h0)", 0.0, 10.0 } }, 106.0);
+
+  std::vector<ActionTypeStatistics> statistics = aggregator_.get_statistics();
+  ASSERT_EQ(statistics.size(), 1u);
+  EXPECT_EQ(statistics[0].action_type, "move");
+  EXPECT_EQ(statistics[0].num_failed, 1u);
+  EXPECT_DOUBLE_EQ(statistics[0].total_actual_s, 6.0);
+
+  // Cancelled actions do not count towards the duration error
+  EXPECT_DOUBLE_EQ(statistics[0].total_planned_s, 0.0);
+  EXPECT_DOUBLE_EQ(statistics[0].mean_duration_error_s, 0.0);
+  EXPECT_DOUBLE_EQ(aggregator_.get_plan_elapsed_s(110.0), 4.0);
+}
+
+
+TEST(ExecutionFeedbackAggregator, ErrorsAreTakenOverTheLatestExecutions)
+{
+  ExecutionFeedbackAggregator aggregator(20);
+  EXPECT_FALSE(aggregator.is_plan_started());
+
+  // 20 executions 1 s late to 20 s late, followed by 20 executions on time
+  for(int i = 0; i < 40; i++)
+  {
+    double start_time_s = 100.0 * i;
+    double error_s = (i < 20) ? i + 1.0 : 0.0;
+    aggregator.start_plan({ { "(takeoff d0 h0)", 0.0, 5.0 } }, start_time_s);
+    aggregator.update({ sample("takeoff_d0_h0_1", "takeoff", { "d0", "h0" }, ActionStatus::SUCCEEDED,
+      start_time_s, start_time_s + 5.0 + error_s, 1.0) }, start_time_s + 5.0 + error_s);
+
+    if(i == 19)
+    {
+      ActionTypeStatistics statistics = aggregator.get_statistics().front();
+      EXPECT_DOUBLE_EQ(statistics.mean_duration_error_s, 10.5);
+      EXPECT_DOUBLE_EQ(statistics.p95_duration_error_s, 19.0);
+    }
+  }
+
+  ActionTypeStatistics statistics = aggregator.get_statistics().front();
+  EXPECT_EQ(statistics.num_succeeded, 40u);
+  EXPECT_DOUBLE_EQ(statistics.total_planned_s, 200.0);
+  EXPECT_DOUBLE_EQ(statistics.mean_duration_error_s, 0.0);
+  EXPECT_DOUBLE_EQ(statistics.p95_duration_error_s, 0.0);
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "automated_planning/goal_analysis.hpp"
+
+
+namespace
+{
+  // A reduced SAR-domain, where the drone moves between locations and searches them
+  const char* domain_str = R"(
+(define (domain test_search)
+  (:requirements :strips :typing :fluents :durative-actions)
+  (:types drone location)
+  (:predicates
+    (drone_at ?d - drone ?loc - location)
+    (path ?loc_from - location ?loc_to - location)
+    (searched ?loc - location)
+    (not_searched ?loc - location)
+  )
+  (:functions
+    (move_duration ?loc_from - location ?loc_to - location)
+    (battery_charge ?d - drone)
+  )
+  (:durative-action move
+    :parameters (?d - drone ?loc_from - location ?loc_to - location)
+    :duration (= ?duration (move_duration ?loc_from ?loc_to))
+    :condition (and
+      (at start (path ?loc_from ?loc_to))
+      (at start (drone_at ?d ?loc_from))
+      (at start (>= (battery_charge ?d) 10))
+    )
+    :effect (and
+      (at start (not (drone_at ?d ?loc_from)))
+      (at end (drone_at ?d ?loc_to))
+      (at end (decrease (battery_charge ?d) 10))
+    )
+  )
+  (:durative-action search
+    :parameters (?d - drone ?loc - location)
+    :duration (= ?duration 20)
+    :condition (and
+      (at start (drone_at ?d ?loc))
+      (at start (not_searched ?loc))
+    )
+    :effect (and
+      (at start (not (not_searched ?loc)))
+      (at end (searched ?loc))
+    )
+  )
+))";
+
+
+
+  PddlProblem make_problem(double battery_charge)
+  {
+    PddlProblem problem;
+    problem.name = "test";
+    problem.domain_name = "test_search";
+    problem.objects = { { "d", "drone" }, { "h0", "location" }, { "a", "location" }, { "b", "location" } };
+    problem.predicates = {
+      PddlAtom{ "drone_at", { "d", "h0" } },
+      PddlAtom{ "path", { "h0", "a" } },
+      PddlAtom{ "path", { "a", "h0" } },
+      PddlAtom{ "not_searched", { "a" } },
+      PddlAtom{ "not_searched", { "b" } },
+      PddlAtom{ "searched", { "h0" } }
+    };
+    problem.functions = {
+      { PddlAtom{ "move_duration", { "h0", "a" } }, 5.0 },
+      { PddlAtom{ "move_duration", { "a", "h0" } }, 5.0 },
+      { PddlAtom{ "battery_charge", { "d" } }, battery_charge }
+    };
+    return problem;
+  }
+
+
+  PddlCondition make_goal(const std::string& name, const std::vector<std::string>& arguments)
+  {
+    PddlCondition condition;
+    condition.predicate = PddlAtom{ name, arguments };
+    return condition;
+  }
+
+
+  std::shared_ptr<const PddlDomain> make_domain()
+  {
+    return std::make_shared<const PddlDomain>(PddlDomain::parse(domain_str));
+  }
+}
+
+
+TEST(GoalAnalysis, GoalOfTheInitialStateIsSatisfied)
+{
+  GoalAnalysis analysis(make_domain());
+  PddlProblem problem = make_problem(100.0);
+  problem.goals = { make_goal("searched", { "h0" }), make_goal("drone_at", { "d", "h0" }) };
+
+  std::vector<PddlCondition> unreachable_goals;
+  EXPECT_TRUE(GoalAnalysis::is_satisfied(problem));
+  EXPECT_EQ(analysis.analyze(problem, unreachable_goals), GoalStatus::SATISFIED);
+  EXPECT_TRUE(unreachable_goals.empty());
+}
+
+
+TEST(GoalAnalysis, ReachableGoalIsOpen)
+{
+  GoalAnalysis analysis(make_domain());
+  PddlProblem problem = make_problem(100.0);
+  problem.goals = { make_goal("searched", { "h0" }), make_goal("searched", { "a" }) };
+
+  std::vector<PddlCondition> unreachable_goals;
+  EXPECT_FALSE(GoalAnalysis::is_satisfied(problem));
+  EXPECT_EQ(analysis.analyze(problem, unreachable_goals), GoalStatus::OPEN);
+  EXPECT_TRUE(unreachable_goals.empty());
+}
+
+
+TEST(GoalAnalysis, GoalWithoutRouteIsUnreachable)
+{
+  GoalAnalysis analysis(make_domain());
+  PddlProblem problem = make_problem(100.0);
+  problem.goals = { make_goal("searched", { "a" }), make_goal("searched", { "b" }) };
+
+  std::vector<PddlCondition> unreachable_goals;
+  EXPECT_EQ(analysis.analyze(problem, unreachable_goals), GoalStatus::UNREACHABLE);
+  ASSERT_EQ(unreachable_goals.size(), 1u);
+  EXPECT_EQ(unreachable_goals[0].predicate.to_string(), "(searched b)");
+  EXPECT_EQ(analysis.get_statistics().num_unreachable, 1u);
+}
+
+
+TEST(GoalAnalysis, GoalBeyondTheBatteryIsUnreachable)
+{
+  // The battery is only decreased, such that it never reaches the 10 required to move
+  GoalAnalysis analysis(make_domain());
+  PddlProblem problem = make_problem(5.0);
+  problem.goals = { make_goal("searched", { "a" }) };
+
+  std::vector<PddlCondition> unreachable_goals;
+  EXPECT_EQ(analysis.analyze(problem, unreachable_goals), GoalStatus::UNREACHABLE);
+  ASSERT_EQ(unreachable_goals.size(), 1u);
+  EXPECT_EQ(unreachable_goals[0].predicate.to_string(), "(searched a)");
+}
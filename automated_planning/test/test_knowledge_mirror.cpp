@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "automated_planning/knowledge_mirror.hpp"
+
+
+TEST(PddlAtom, ParsingNormalizesCaseAndWhitespace)
+{
+  std::optional<PddlAtom> atom = PddlAtom::parse("  ( Drone_At   D0\tH0 )");
+  ASSERT_TRUE(atom.has_value());
+  EXPECT_EQ(atom->name, "drone_at");
+  EXPECT_EQ(atom->arguments, (std::vector<std::string>{ "d0", "h0" }));
+  EXPECT_EQ(atom->to_string(), "(drone_at d0 h0)");
+
+  EXPECT_EQ(PddlAtom::parse("(landed d0)")->to_string(), "(landed d0)");
+  EXPECT_FALSE(PddlAtom::parse("drone_at d0 h0").has_value());
+  EXPECT_FALSE(PddlAtom::parse("(drone_at d0 h0").has_value());
+  EXPECT_FALSE(PddlAtom::parse("(not (landed d0))").has_value());
+  EXPECT_FALSE(PddlAtom::parse("()").has_value());
+}
+
+
+class KnowledgeMirrorTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    mirror_.add_instance("d0", "drone");
+    mirror_.add_instance("H0", "location");
+    mirror_.add_instance("l1", "location");
+    mirror_.add_predicate("(drone_at d0 h0)");
+    mirror_.add_predicate("(landed d0)");
+    mirror_.add_predicate("(not_searched l1)");
+    mirror_.set_function("(= (num_markers d0) 3)");
+    mirror_.set_function("(battery_charge d0) 87.5");
+    mirror_.set_goal("(and (searched l1))");
+  }
+
+  KnowledgeMirror mirror_;
+};
+
+
+TEST_F(KnowledgeMirrorTest, WritesAreVisibleToTheQueries)
+{
+  EXPECT_TRUE(mirror_.has_predicate("drone_at", { "d0", "h0" }));
+  EXPECT_TRUE(mirror_.has_predicate("(LANDED D0)"));
+  EXPECT_FALSE(mirror_.has_predicate("drone_at", { "d0", "l1" }));
+
+  EXPECT_EQ(mirror_.get_function("num_markers", { "d0" }), 3.0);
+  EXPECT_EQ(mirror_.get_function("battery_charge", { "d0" }), 87.5);
+  EXPECT_FALSE(mirror_.get_function("num_lifevests", { "d0" }).has_value());
+  EXPECT_EQ(mirror_.get_goal(), "(and (searched l1))");
+
+  std::vector<std::pair<std::string, std::string>> instances = mirror_.get_instances();
+  ASSERT_EQ(instances.size(), 3u);
+  EXPECT_EQ(instances[1], (std::pair<std::string, std::string>{ "h0", "location" }));
+}
+
+
+TEST_F(KnowledgeMirrorTest, RemovedPredicatesAreNoLongerIndexed)
+{
+  mirror_.add_predicate("(drone_at d0 l1)");
+  mirror_.remove_predicate("(drone_at d0 h0)");
+
+  std::vector<PddlAtom> drone_at = mirror_.get_predicates("DRONE_AT");
+  ASSERT_EQ(drone_at.size(), 1u);
+  EXPECT_EQ(drone_at.front().to_string(), "(drone_at d0 l1)");
+
+  mirror_.remove_predicate("(drone_at d0 l1)");
+  EXPECT_TRUE(mirror_.get_predicates("drone_at").empty());
+
+  // Removing an unknown predicate is harmless
+  mirror_.remove_predicate("(drone_at d0 l1)");
+  EXPECT_TRUE(mirror_.has_predicate("(landed d0)"));
+}
+
+
+TEST_F(KnowledgeMirrorTest, SnapshotsAreSorted)
+{
+  mirror_.add_predicate("(not_searched h0)");
+
+  std::vector<PddlAtom> predicates = mirror_.get_all_predicates();
+  ASSERT_EQ(predicates.size(), 4u);
+  for(size_t i = 1; i < predicates.size(); i++)
+  {
+    EXPECT_LT(predicates[i - 1].to_string(), predicates[i].to_string());
+  }
+
+  std::vector<PddlAtom> unsearched_locations = mirror_.get_predicates("not_searched");
+  ASSERT_EQ(unsearched_locations.size(), 2u);
+  EXPECT_EQ(unsearched_locations[0].arguments.front(), "h0");
+  EXPECT_EQ(unsearched_locations[1].arguments.front(), "l1");
+
+  std::vector<std::pair<PddlAtom, double>> functions = mirror_.get_all_functions();
+  ASSERT_EQ(functions.size(), 2u);
+  EXPECT_EQ(functions[0].first.name, "battery_charge");
+  EXPECT_EQ(functions[1].first.name, "num_markers");
+}
+
+
+TEST_F(KnowledgeMirrorTest, SynchronizationReplacesTheStateAndKeepsTheTypes)
+{
+  // The executor has moved the drone and used a marker
+  mirror_.synchronize(
+    { "d0", "h0", "l1", "l2" },
+    { "(drone_at d0 l1)", "(not_searched l1)" },
+    { "(= (num_markers d0) 2)" },
+    "(and (searched l1) (searched l2))");
+
+  EXPECT_FALSE(mirror_.has_predicate("(drone_at d0 h0)"));
+  EXPECT_FALSE(mirror_.has_predicate("(landed d0)"));
+  EXPECT_TRUE(mirror_.has_predicate("(drone_at d0 l1)"));
+  EXPECT_EQ(mirror_.get_function("num_markers", { "d0" }), 2.0);
+  EXPECT_FALSE(mirror_.get_function("battery_charge", { "d0" }).has_value());
+  EXPECT_EQ(mirror_.get_goal(), "(and (searched l1) (searched l2))");
+
+  std::vector<std::pair<std::string, std::string>> instances = mirror_.get_instances();
+  ASSERT_EQ(instances.size(), 4u);
+  EXPECT_EQ(instances[0].second, "drone");
+  EXPECT_EQ(instances[3], (std::pair<std::string, std::string>{ "l2", "" }));
+  EXPECT_EQ(mirror_.get_num_synchronizations(), 1u);
+}
+
+
+TEST_F(KnowledgeMirrorTest, VersionOnlyChangesWithTheState)
+{
+  size_t version = mirror_.get_version();
+  mirror_.has_predicate("(landed d0)");
+  mirror_.get_predicates("drone_at");
+  mirror_.to_string();
+  EXPECT_EQ(mirror_.get_version(), version);
+
+  // Malformed writes are ignored
+  mirror_.add_predicate("landed d0");
+  mirror_.set_function("(= (num_markers d0) many)");
+  EXPECT_EQ(mirror_.get_version(), version);
+  EXPECT_EQ(mirror_.get_function("num_markers", { "d0" }), 3.0);
+
+  mirror_.clear_goal();
+  EXPECT_GT(mirror_.get_version(), version);
+  EXPECT_TRUE(mirror_.get_goal().empty());
+}
+
+
+TEST_F(KnowledgeMirrorTest, QueriesAreCounted)
+{
+  size_t num_local_queries = mirror_.get_num_local_queries();
+  mirror_.has_predicate("(landed d0)");
+  mirror_.get_function("num_markers", { "d0" });
+  mirror_.get_goal();
+  mirror_.record_remote_query();
+
+  EXPECT_EQ(mirror_.get_num_local_queries(), num_local_queries + 3);
+  EXPECT_EQ(mirror_.get_num_remote_queries(), 1u);
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+#include "automated_planning/mission_checkpoint.hpp"
+
+
+namespace
+{
+  MissionCheckpoint make_checkpoint()
+  {
+    MissionCheckpoint checkpoint;
+    checkpoint.wall_time_s = 1.7e9;
+    checkpoint.mission_hash = MissionCheckpoint::get_hash("/mission_controller_node");
+    checkpoint.node_time_s = 42.5;
+    checkpoint.controller_state = 3;
+    checkpoint.num_markers = 2;
+    checkpoint.num_lifevests = 1;
+    checkpoint.landed_goal = "(landed d)";
+    checkpoint.preferred_landing_goal = "(drone_at d h0)";
+    checkpoint.possible_landing_goals = { "(drone_at d h0)", "(drone_at d h1)" };
+    checkpoint.search_goals = { "(searched a)" };
+    checkpoint.communicate_location_goals = { "(not_communicated p0 a)" };
+    checkpoint.rescue_location_goals = { "(not_rescued p1 b)" };
+    checkpoint.detected_people = { DetectedPersonCheckpoint{ 0, 1.0, -2.0, 0.5, 2, false },
+      DetectedPersonCheckpoint{ 1, 10.0, 20.0, 0.0, 3, true } };
+    checkpoint.plan = { PlannedAction{ "(move d h0 a)", 0.0, 5.0 }, PlannedAction{ "(search d a)", 5.001, 20.0 } };
+    checkpoint.instances = { { "d", "drone" }, { "a", "location" } };
+    checkpoint.predicates = { "(drone_at d h0)", "(not_searched a)" };
+    checkpoint.functions = { { "(battery_charge d)", 87.5 } };
+    return checkpoint;
+  }
+}
+
+
+TEST(MissionCheckpoint, RoundTripKeepsEveryField)
+{
+  const MissionCheckpoint checkpoint = make_checkpoint();
+  std::optional<MissionCheckpoint> restored = MissionCheckpoint::deserialize(checkpoint.serialize());
+  ASSERT_TRUE(restored.has_value());
+
+  EXPECT_DOUBLE_EQ(restored->wall_time_s, checkpoint.wall_time_s);
+  EXPECT_EQ(restored->mission_hash, checkpoint.mission_hash);
+  EXPECT_DOUBLE_EQ(restored->node_time_s, checkpoint.node_time_s);
+  EXPECT_EQ(restored->controller_state, checkpoint.controller_state);
+  EXPECT_EQ(restored->num_markers, checkpoint.num_markers);
+  EXPECT_EQ(restored->num_lifevests, checkpoint.num_lifevests);
+  EXPECT_EQ(restored->landed_goal, checkpoint.landed_goal);
+  EXPECT_EQ(restored->preferred_landing_goal, checkpoint.preferred_landing_goal);
+  EXPECT_EQ(restored->possible_landing_goals, checkpoint.possible_landing_goals);
+  EXPECT_EQ(restored->search_goals, checkpoint.search_goals);
+  EXPECT_EQ(restored->communicate_location_goals, checkpoint.communicate_location_goals);
+  EXPECT_TRUE(restored->mark_location_goals.empty());
+  EXPECT_EQ(restored->rescue_location_goals, checkpoint.rescue_location_goals);
+
+  ASSERT_EQ(restored->detected_people.size(), 2u);
+  EXPECT_EQ(restored->detected_people[1].id, 1);
+  EXPECT_DOUBLE_EQ(restored->detected_people[0].y, -2.0);
+  EXPECT_EQ(restored->detected_people[1].severity, 3);
+  EXPECT_TRUE(restored->detected_people[1].is_helped);
+
+  ASSERT_EQ(restored->plan.size(), 2u);
+  EXPECT_EQ(restored->plan[1].action, "(search d a)");
+  EXPECT_DOUBLE_EQ(restored->plan[1].start_s, 5.001);
+  EXPECT_DOUBLE_EQ(restored->plan[1].duration_s, 20.0);
+
+  EXPECT_EQ(restored->instances, checkpoint.instances);
+  EXPECT_EQ(restored->predicates, checkpoint.predicates);
+  EXPECT_EQ(restored->functions, checkpoint.functions);
+}
+
+
+TEST(MissionCheckpoint, TruncatedDataIsRejected)
+{
+  const std::string data = make_checkpoint().serialize();
+  for(size_t size = 0; size < data.size(); size++)
+  {
+    EXPECT_FALSE(MissionCheckpoint::deserialize(data.substr(0, size)).has_value()) << "size " << size;
+  }
+}
+
+
+TEST(MissionCheckpoint, CorruptDataIsRejected)
+{
+  std::string data = make_checkpoint().serialize();
+  data[data.size() / 2] ^= 0x01;
+  EXPECT_FALSE(MissionCheckpoint::deserialize(data).has_value());
+  EXPECT_FALSE(MissionCheckpoint::deserialize("not a checkpoint").has_value());
+}
+
+
+TEST(MissionCheckpoint, HashSeparatesMissions)
+{
+  EXPECT_EQ(MissionCheckpoint::get_hash("/uav1/mission_controller_node"), MissionCheckpoint::get_hash("/uav1/mission_controller_node"));
+  EXPECT_NE(MissionCheckpoint::get_hash("/uav1/mission_controller_node"), MissionCheckpoint::get_hash("/uav2/mission_controller_node"));
+  EXPECT_NE(MissionCheckpoint::get_hash("locations.names=[a, b]"), MissionCheckpoint::get_hash("locations.names=[a, c]"));
+}
+
+
+TEST(MissionCheckpointFile, WritesOnlyChangedCheckpoints)
+{
+  const std::string path = testing::TempDir() + "test_mission_checkpoint.bin";
+  std::remove(path.c_str());
+  MissionCheckpointFile file(path);
+  EXPECT_FALSE(file.read().has_value());
+
+  MissionCheckpoint checkpoint = make_checkpoint();
+  ASSERT_TRUE(file.write(checkpoint));
+  ASSERT_TRUE(file.write(checkpoint));
+  EXPECT_EQ(file.get_num_writes(), 1u);
+
+  // Only the time has changed
+  checkpoint.node_time_s += 10.0;
+  ASSERT_TRUE(file.write(checkpoint));
+  EXPECT_EQ(file.get_num_writes(), 1u);
+
+  checkpoint.num_markers = 1;
+  ASSERT_TRUE(file.write(checkpoint));
+  EXPECT_EQ(file.get_num_writes(), 2u);
+
+  std::optional<MissionCheckpoint> restored = file.read();
+  ASSERT_TRUE(restored.has_value());
+  EXPECT_EQ(restored->num_markers, 1);
+  EXPECT_DOUBLE_EQ(restored->node_time_s, checkpoint.node_time_s);
+  EXPECT_GE(restored->get_age_s(), 0.0);
+
+  file.remove();
+  EXPECT_FALSE(file.read().has_value());
+}
@@ -0,0 +1,278 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "automated_planning/native_planner.hpp"
+#include "sar_domain.hpp"
+
+
+namespace
+{
+  // A reduced SAR-domain, where the drone moves between locations and searches them
+  const char* domain_str = R"(
+(define (domain test_search)
+  (:requirements :strips :typing :fluents :durative-actions)
+  (:types drone location)
+  (:predicates
+    (drone_at ?d - drone ?loc - location)
+    (path ?loc_from - location ?loc_to - location)
+    (searched ?loc - location)
+    (not_searched ?loc - location)
+  )
+  (:functions
+    (move_duration ?loc_from - location ?loc_to - location)
+    (battery_charge ?d - drone)
+  )
+  (:durative-action move
+    :parameters (?d - drone ?loc_from - location ?loc_to - location)
+    :duration (= ?duration (move_duration ?loc_from ?loc_to))
+    :condition (and
+      (at start (path ?loc_from ?loc_to))
+      (at start (drone_at ?d ?loc_from))
+      (at start (>= (battery_charge ?d) 10))
+    )
+    :effect (and
+      (at start (not (drone_at ?d ?loc_from)))
+      (at end (drone_at ?d ?loc_to))
+      (at end (decrease (battery_charge ?d) 10))
+    )
+  )
+  (:durative-action search
+    :parameters (?d - drone ?loc - location)
+    :duration (= ?duration 20)
+    :condition (and
+      (at start (drone_at ?d ?loc))
+      (at start (not_searched ?loc))
+    )
+    :effect (and
+      (at start (not (not_searched ?loc)))
+      (at end (searched ?loc))
+    )
+  )
+))";
+
+
+  PddlProblem make_problem(double battery_charge)
+  {
+    PddlProblem problem;
+    problem.name = "test";
+    problem.domain_name = "test_search";
+    problem.objects = { { "d", "drone" }, { "h0", "location" }, { "a", "location" }, { "b", "location" } };
+    problem.predicates = {
+      PddlAtom{ "drone_at", { "d", "h0" } },
+      PddlAtom{ "path", { "h0", "a" } },
+      PddlAtom{ "path", { "a", "h0" } },
+      PddlAtom{ "path", { "h0", "b" } },
+      PddlAtom{ "path", { "b", "h0" } },
+      PddlAtom{ "not_searched", { "a" } },
+      PddlAtom{ "not_searched", { "b" } }
+    };
+    problem.functions = {
+      { PddlAtom{ "move_duration", { "h0", "a" } }, 5.0 },
+      { PddlAtom{ "move_duration", { "a", "h0" } }, 5.0 },
+      { PddlAtom{ "move_duration", { "h0", "b" } }, 7.0 },
+      { PddlAtom{ "move_duration", { "b", "h0" } }, 7.0 },
+      { PddlAtom{ "battery_charge", { "d" } }, battery_charge }
+    };
+    return problem;
+  }
+
+
+  PddlCondition make_goal(const std::string& name, const std::vector<std::string>& arguments)
+  {
+    PddlCondition condition;
+    condition.predicate = PddlAtom{ name, arguments };
+    return condition;
+  }
+
+
+  std::shared_ptr<const PddlDomain> make_domain()
+  {
+    return std::make_shared<const PddlDomain>(PddlDomain::parse(domain_str));
+  }
+}
+
+
+TEST(NativePlanner, SolvesTheHardGoals)
+{
+  NativePlanner planner(make_domain());
+  PddlProblem problem = make_problem(100.0);
+  problem.goals = { make_goal("searched", { "a" }), make_goal("searched", { "b" }) };
+
+  std::optional<std::vector<PlannedAction>> plan = planner.solve(problem);
+  ASSERT_TRUE(plan.has_value());
+  ASSERT_EQ(plan->size(), 5u);  // move, search, move, move, search
+
+  // The plan is sequential
+  for(size_t i = 1; i < plan->size(); i++)
+  {
+    EXPECT_GT((*plan)[i].start_s, (*plan)[i - 1].start_s + (*plan)[i - 1].duration_s - 1e-9);
+  }
+  EXPECT_EQ((*plan)[0].action.rfind("(move d h0", 0), 0u);
+}
+
+
+TEST(NativePlanner, ReturnsNulloptForUnreachableGoals)
+{
+  NativePlanner planner(make_domain());
+
+  // Too little battery to move at all. The relaxed problem ignores the battery, such that only
+  // the search finds the goal unreachable
+  PddlProblem problem = make_problem(5.0);
+  problem.goals = { make_goal("searched", { "a" }) };
+  EXPECT_FALSE(planner.solve(problem).has_value());
+  EXPECT_TRUE(planner.get_statistics().initial_heuristic.has_value());
+
+  // No path to the location
+  problem = make_problem(100.0);
+  problem.objects.push_back({ "c", "location" });
+  problem.predicates.push_back(PddlAtom{ "not_searched", { "c" } });
+  problem.goals = { make_goal("searched", { "c" }) };
+  EXPECT_FALSE(planner.solve(problem).has_value());
+  EXPECT_FALSE(planner.get_statistics().initial_heuristic.has_value());
+}
+
+
+TEST(NativePlanner, ReusesTheGroundingWhenOnlyFunctionsChange)
+{
+  NativePlanner planner(make_domain());
+  PddlProblem problem = make_problem(100.0);
+  problem.goals = { make_goal("searched", { "a" }) };
+
+  ASSERT_TRUE(planner.solve(problem).has_value());
+  EXPECT_FALSE(planner.get_statistics().is_grounding_reused);
+
+  problem.functions.back().second = 80.0;
+  ASSERT_TRUE(planner.solve(problem).has_value());
+  EXPECT_TRUE(planner.get_statistics().is_grounding_reused);
+}
+
+
+TEST(NativePlanner, SoftGoalsWithTheHighestUtilityAreAchieved)
+{
+  NativePlanner planner(make_domain());
+
+  // Battery for two moves only: one of the locations can be searched before returning
+  PddlProblem problem = make_problem(20.0);
+  problem.goals = { make_goal("drone_at", { "d", "h0" }) };
+  std::vector<SoftGoal> soft_goals = {
+    SoftGoal{ PddlAtom{ "searched", { "a" } }, 1.0 },
+    SoftGoal{ PddlAtom{ "searched", { "b" } }, 5.0 }
+  };
+
+  std::optional<std::vector<PlannedAction>> plan = planner.solve(problem, soft_goals);
+  ASSERT_TRUE(plan.has_value());
+  ASSERT_EQ(planner.get_achieved_soft_goals().size(), 2u);
+  EXPECT_FALSE(planner.get_achieved_soft_goals()[0]);
+  EXPECT_TRUE(planner.get_achieved_soft_goals()[1]);
+  EXPECT_DOUBLE_EQ(planner.get_statistics().achieved_utility, 5.0);
+}
+
+
+/**
+ * @brief Soft goals in the SAR-domain flown by the missions. The drone hovers at h0, and each
+ * search needs 6 % battery. There is no path to c
+ */
+class NativePlannerSoftGoalsTest : public testing::Test
+{
+protected:
+  NativePlannerSoftGoalsTest()
+  : planner_(load_sar_domain())
+  {}
+
+  static PddlProblem make_problem_(double battery_charge)
+  {
+    return PddlProblem::parse(R"(
+(define (problem test_soft_goals)
+  (:domain sar)
+  (:objects
+    d - drone
+    h0 a b c - location
+  )
+  (:init
+    (drone_at d h0) (available a) (available b) (available c)
+    (path h0 a) (path a h0) (path h0 b) (path b h0) (path a b) (path b a)
+    (not_searched a) (not_searched b) (not_searched c)
+    (not_landed d) (not_moving d) (not_searching d) (not_rescuing d) (not_marking d) (not_tracking d)
+    (= (battery_charge d) )" + std::to_string(battery_charge) + R"()
+    (= (move_battery_usage d) 0.01) (= (track_battery_usage d) 0.1)
+    (= (move_duration h0 a) 10) (= (move_duration a h0) 10) (= (move_duration h0 b) 10)
+    (= (move_duration b h0) 10) (= (move_duration a b) 10) (= (move_duration b a) 10)
+    (= (search_duration a) 60) (= (search_duration b) 60) (= (search_duration c) 60)
+  )
+  (:goal (and (drone_at d h0)))
+)
+)");
+  }
+
+  const std::vector<SoftGoal> soft_goals_ = {
+    SoftGoal{ PddlAtom{ "searched", { "a" } }, 1.0 },
+    SoftGoal{ PddlAtom{ "searched", { "b" } }, 3.0 },
+    SoftGoal{ PddlAtom{ "searched", { "c" } }, 10.0 },
+  };
+
+  NativePlanner planner_;
+};
+
+
+TEST_F(NativePlannerSoftGoalsTest, UnreachableSoftGoalsAreDropped)
+{
+  std::optional<std::vector<PlannedAction>> plan = planner_.solve(make_problem_(100.0), soft_goals_);
+  ASSERT_TRUE(plan.has_value());
+
+  const NativePlannerStatistics& statistics = planner_.get_statistics();
+  EXPECT_EQ(statistics.num_soft_goals, 3u);
+  EXPECT_EQ(statistics.num_reachable_soft_goals, 2u);
+  EXPECT_EQ(statistics.num_achieved_soft_goals, 2u);
+  EXPECT_DOUBLE_EQ(statistics.achieved_utility, 4.0);
+  EXPECT_EQ(planner_.get_achieved_soft_goals(), (std::vector<bool>{ true, true, false }));
+
+  // The hard goal is still achieved last
+  EXPECT_EQ(plan->back().action.rfind("(move d ", 0), 0u);
+  EXPECT_NE(plan->back().action.find(" h0)"), std::string::npos);
+}
+
+
+TEST_F(NativePlannerSoftGoalsTest, BatteryForOneSearchPicksTheHighestUtility)
+{
+  std::optional<std::vector<PlannedAction>> plan = planner_.solve(make_problem_(10.0), soft_goals_);
+  ASSERT_TRUE(plan.has_value());
+
+  EXPECT_EQ(planner_.get_achieved_soft_goals(), (std::vector<bool>{ false, true, false }));
+  EXPECT_DOUBLE_EQ(planner_.get_statistics().achieved_utility, 3.0);
+
+  size_t num_searches = 0;
+  for(const PlannedAction& action : plan.value())
+  {
+    num_searches += (action.action.rfind("(search ", 0) == 0);
+  }
+  EXPECT_EQ(num_searches, 1u);
+}
+
+
+TEST_F(NativePlannerSoftGoalsTest, NoBatteryForSearchingStillSolvesTheHardGoal)
+{
+  PddlProblem problem = make_problem_(1.0);
+  problem.predicates.erase(problem.predicates.begin());
+  problem.predicates.push_back(PddlAtom{ "drone_at", { "d", "a" } });
+  problem.predicates.push_back(PddlAtom{ "available", { "h0" } });
+
+  std::optional<std::vector<PlannedAction>> plan = planner_.solve(problem, soft_goals_);
+  ASSERT_TRUE(plan.has_value());
+  ASSERT_EQ(plan->size(), 1u);
+  EXPECT_EQ(plan->front().action, "(move d a h0)");
+  EXPECT_EQ(planner_.get_statistics().num_achieved_soft_goals, 0u);
+}
+
+
+TEST_F(NativePlannerSoftGoalsTest, UnreachableHardGoalFailsDespiteTheSoftGoals)
+{
+  PddlProblem problem = make_problem_(100.0);
+  problem.goals.front().predicate = PddlAtom{ "drone_at", { "d", "c" } };
+
+  EXPECT_FALSE(planner_.solve(problem, soft_goals_).has_value());
+  EXPECT_EQ(planner_.get_statistics().num_achieved_soft_goals, 0u);
+  EXPECT_EQ(planner_.get_achieved_soft_goals(), (std::vector<bool>{ false, false, false }));
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "automated_planning/person_tracker.hpp"
+
+
+namespace
+{
+  /**
+   * @brief [s] Mean duration of redetecting the people in the middle of a square grid of 
+   * @p num_people people found long ago, 10 m apart. The fastest of several runs, against noise
+   */
+  double get_redetection_duration_s(int num_people)
+  {
+    PersonTrackerParameters params;
+    params.confirmation_hits = 1;
+    const int side = static_cast<int>(std::ceil(std::sqrt(num_people)));
+    const double center = 10.0 * (side / 2);
+    const int num_redetections = 100;
+
+    double min_duration_s = std::numeric_limits<double>::infinity();
+    for(int run = 0; run < 3; run++)
+    {
+      PersonTracker tracker(params);
+      for(int i = 0; i < num_people; i++)
+      {
+        tracker.add_detection(0.0, Eigen::Vector3d(10.0 * (i / side), 10.0 * (i % side), 0.0), 1);
+      }
+
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      for(int i = 0; i < num_redetections; i++)
+      {
+        tracker.add_detection(600.0 + 0.1 * i, Eigen::Vector3d(center + 10.0 * (i % 3 - 1), center, 0.0), 1);
+      }
+      min_duration_s = std::min(min_duration_s, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+      EXPECT_EQ(tracker.get_num_tracks(), static_cast<size_t>(side * side > num_people ? num_people : side * side));
+    }
+    return min_duration_s / num_redetections;
+  }
+}
+
+
+TEST(PersonTracker, BurstOfDetectionsGivesOneConfirmedTrack)
+{
+  PersonTracker tracker;
+  uint32_t first_id = tracker.add_detection(0.0, Eigen::Vector3d(10.0, 10.0, 0.0), 1);
+  EXPECT_TRUE(tracker.get_confirmed_tracks(0.0).empty());
+
+  EXPECT_EQ(tracker.add_detection(0.5, Eigen::Vector3d(10.0, 10.2, 0.0), 1), first_id);
+  EXPECT_EQ(tracker.add_detection(1.0, Eigen::Vector3d(10.1, 10.1, 0.0), 2), first_id);
+
+  std::vector<PersonTrack> confirmed_tracks = tracker.get_confirmed_tracks(1.0);
+  ASSERT_EQ(confirmed_tracks.size(), 1u);
+  EXPECT_EQ(confirmed_tracks[0].id, first_id);
+  EXPECT_EQ(confirmed_tracks[0].severity, 2);
+  EXPECT_NEAR(confirmed_tracks[0].x(0), 10.05, 0.2);
+  EXPECT_NEAR(confirmed_tracks[0].x(1), 10.1, 0.2);
+}
+
+
+TEST(PersonTracker, ClosePeopleStaySeparate)
+{
+  PersonTracker tracker;
+  std::vector<uint32_t> first_ids;
+  std::vector<uint32_t> second_ids;
+  for(int i = 0; i < 3; i++)
+  {
+    first_ids.push_back(tracker.add_detection(0.5 * i, Eigen::Vector3d(0.0, 0.0, 0.0), 1));
+    second_ids.push_back(tracker.add_detection(0.5 * i, Eigen::Vector3d(0.0, 3.0, 0.0), 1));
+  }
+
+  EXPECT_NE(first_ids[0], second_ids[0]);
+  for(int i = 1; i < 3; i++)
+  {
+    EXPECT_EQ(first_ids[i], first_ids[0]);
+    EXPECT_EQ(second_ids[i], second_ids[0]);
+  }
+  EXPECT_EQ(tracker.get_confirmed_tracks(1.0).size(), 2u);
+}
+
+
+TEST(PersonTracker, DriftingPersonKeepsItsId)
+{
+  // Drifting at 0.1 m/s, and found again after a minute several cells away
+  PersonTracker tracker;
+  uint32_t id = 0;
+  for(int i = 0; i < 3; i++)
+  {
+    id = tracker.add_detection(0.5 * i, Eigen::Vector3d(0.0, 0.05 * i, 0.0), 1);
+  }
+
+  EXPECT_EQ(tracker.add_detection(60.0, Eigen::Vector3d(0.0, 6.0, 0.0), 1), id);
+  EXPECT_EQ(tracker.add_detection(61.0, Eigen::Vector3d(0.0, 6.1, 0.0), 1), id);
+  EXPECT_EQ(tracker.get_num_tracks(), 1u);
+}
+
+
+TEST(PersonTracker, StaleTentativeTracksAreRemoved)
+{
+  PersonTracker tracker;
+  for(int i = 0; i < 3; i++)
+  {
+    tracker.add_detection(0.5 * i, Eigen::Vector3d(0.0, 0.0, 0.0), 1);
+  }
+  tracker.add_detection(1.0, Eigen::Vector3d(50.0, 50.0, 0.0), 1);
+  ASSERT_EQ(tracker.get_num_tracks(), 2u);
+
+  EXPECT_EQ(tracker.remove_stale_tracks(10.0), 1u);
+  EXPECT_EQ(tracker.get_num_tracks(), 1u);
+  EXPECT_EQ(tracker.get_confirmed_tracks(10.0).size(), 1u);
+}
+
+
+TEST(PersonTracker, IdsStartAtTheFirstId)
+{
+  PersonTrackerParameters params;
+  params.first_id = 50001;
+  PersonTracker tracker(params);
+  EXPECT_EQ(tracker.add_detection(0.0, Eigen::Vector3d(0.0, 0.0, 0.0), 1), 50001u);
+  EXPECT_EQ(tracker.add_detection(0.0, Eigen::Vector3d(20.0, 0.0, 0.0), 1), 50002u);
+}
+
+
+TEST(PersonTracker, OldTracksDoNotSlowDownTheAssociation)
+{
+  // Without a bound on the coasting of the tracks, every track would be a candidate after ten
+  // minutes, and the cost would grow with the number of people
+  const double few_people_s = get_redetection_duration_s(256);
+  const double many_people_s = get_redetection_duration_s(4096);
+  EXPECT_LT(many_people_s, 4.0 * few_people_s) << few_people_s << " s with 256 people, " << many_people_s << " s with 4096";
+}
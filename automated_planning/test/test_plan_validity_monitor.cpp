@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include "automated_planning/plan_validity_monitor.hpp"
+#include "sar_domain.hpp"
+
+
+namespace
+{
+  /**
+   * @brief The drone hovering at a, about to search b
+   */
+  void init_knowledge(KnowledgeMirror& knowledge)
+  {
+    for(const char* predicate : {
+      "(drone_at d a)", "(path a b)", "(available b)", "(not_searched b)", "(not_landed d)", "(not_moving d)",
+      "(not_searching d)", "(not_rescuing d)", "(not_marking d)", "(not_tracking d)" })
+    {
+      knowledge.add_predicate(predicate);
+    }
+    for(const char* function : {
+      "(= (battery_charge d) 80)", "(= (move_battery_usage d) 0.1)", "(= (track_battery_usage d) 0.1)",
+      "(= (move_duration a b) 10)", "(= (search_duration b) 60)" })
+    {
+      knowledge.set_function(function);
+    }
+  }
+
+
+  std::vector<ActionTiming> get_plan()
+  {
+    ActionTiming move;
+    move.action = "(move d a b)";
+    move.action_type = "move";
+    move.planned_duration_s = 10.0;
+
+    ActionTiming search;
+    search.action = "(search d b)";
+    search.action_type = "search";
+    search.planned_start_s = 10.0;
+    search.planned_duration_s = 60.0;
+    return { move, search };
+  }
+}
+
+
+class PlanValidityMonitorTest : public testing::Test
+{
+protected:
+  PlanValidityMonitorTest()
+  : monitor_(load_sar_domain())
+  {
+    init_knowledge(knowledge_);
+    monitor_.start_plan(get_plan());
+  }
+
+  KnowledgeMirror knowledge_;
+  PlanValidityMonitor monitor_;
+};
+
+
+TEST_F(PlanValidityMonitorTest, ValidPlanHasNoViolations)
+{
+  EXPECT_TRUE(monitor_.get_unmonitored_actions().empty());
+  EXPECT_TRUE(monitor_.check(knowledge_).empty());
+  EXPECT_TRUE(monitor_.get_baseline_violations().empty());
+}
+
+
+TEST_F(PlanValidityMonitorTest, LowBatteryAtTheFirstCheckIsReported)
+{
+  // The search needs 6 % after the move has used 1 %
+  monitor_.set_function_override("(battery_charge d)", 5.0);
+
+  const std::vector<PlanViolation>& violations = monitor_.check(knowledge_);
+  ASSERT_EQ(violations.size(), 1u);
+  EXPECT_EQ(violations[0].action, "(search d b)");
+  EXPECT_TRUE(violations[0].is_telemetry);
+  EXPECT_TRUE(monitor_.get_baseline_violations().empty());
+}
+
+
+TEST_F(PlanValidityMonitorTest, DriftAtTheFirstCheckIsReported)
+{
+  monitor_.set_retracted_predicates({ "(drone_at d a)" });
+
+  const std::vector<PlanViolation>& violations = monitor_.check(knowledge_);
+  ASSERT_FALSE(violations.empty());
+  EXPECT_EQ(violations[0].action, "(move d a b)");
+  EXPECT_TRUE(violations[0].is_telemetry);
+}
+
+
+TEST_F(PlanValidityMonitorTest, KnowledgeViolationsAtTheFirstCheckAreTheBaseline)
+{
+  knowledge_.remove_predicate("(available b)");
+  EXPECT_TRUE(monitor_.check(knowledge_).empty());
+  ASSERT_EQ(monitor_.get_baseline_violations().size(), 1u);
+  EXPECT_FALSE(monitor_.get_baseline_violations()[0].is_telemetry);
+
+  // The baseline does not hide the telemetry, which is checked again on every change
+  monitor_.set_function_override("(battery_charge d)", 5.0);
+  EXPECT_EQ(monitor_.check(knowledge_).size(), 1u);
+}
+
+
+TEST_F(PlanValidityMonitorTest, LaterBatteryDropIsReported)
+{
+  monitor_.set_function_override("(battery_charge d)", 80.0);
+  EXPECT_TRUE(monitor_.check(knowledge_).empty());
+
+  monitor_.set_function_override("(battery_charge d)", 5.0);
+  EXPECT_EQ(monitor_.check(knowledge_).size(), 1u);
+
+  monitor_.set_function_override("(battery_charge d)", 50.0);
+  EXPECT_TRUE(monitor_.check(knowledge_).empty());
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "automated_planning/relevance_analysis.hpp"
+
+
+namespace
+{
+  // A reduced SAR-domain, where the drone moves between locations and searches them
+  const char* domain_str = R"(
+(define (domain test_search)
+  (:requirements :strips :typing :fluents :durative-actions)
+  (:types drone location)
+  (:predicates
+    (drone_at ?d - drone ?loc - location)
+    (path ?loc_from - location ?loc_to - location)
+    (searched ?loc - location)
+    (not_searched ?loc - location)
+  )
+  (:functions
+    (move_duration ?loc_from - location ?loc_to - location)
+    (battery_charge ?d - drone)
+  )
+  (:durative-action move
+    :parameters (?d - drone ?loc_from - location ?loc_to - location)
+    :duration (= ?duration (move_duration ?loc_from ?loc_to))
+    :condition (and
+      (at start (path ?loc_from ?loc_to))
+      (at start (drone_at ?d ?loc_from))
+      (at start (>= (battery_charge ?d) 10))
+    )
+    :effect (and
+      (at start (not (drone_at ?d ?loc_from)))
+      (at end (drone_at ?d ?loc_to))
+      (at end (decrease (battery_charge ?d) 10))
+    )
+  )
+  (:durative-action search
+    :parameters (?d - drone ?loc - location)
+    :duration (= ?duration 20)
+    :condition (and
+      (at start (drone_at ?d ?loc))
+      (at start (not_searched ?loc))
+    )
+    :effect (and
+      (at start (not (not_searched ?loc)))
+      (at end (searched ?loc))
+    )
+  )
+))";
+
+
+  /**
+   * @brief The locations h0 - a - b - c along a line, with the drone at h0
+   */
+  PddlProblem make_problem()
+  {
+    PddlProblem problem;
+    problem.name = "test";
+    problem.domain_name = "test_search";
+    problem.objects = { { "d", "drone" }, { "h0", "location" }, { "a", "location" }, { "b", "location" }, { "c", "location" } };
+    problem.predicates = { PddlAtom{ "drone_at", { "d", "h0" } } };
+    problem.functions = { { PddlAtom{ "battery_charge", { "d" } }, 100.0 } };
+    const std::vector<std::string> locations = { "h0", "a", "b", "c" };
+    for(size_t i = 1; i < locations.size(); i++)
+    {
+      problem.predicates.push_back(PddlAtom{ "path", { locations[i - 1], locations[i] } });
+      problem.predicates.push_back(PddlAtom{ "path", { locations[i], locations[i - 1] } });
+      problem.predicates.push_back(PddlAtom{ "not_searched", { locations[i] } });
+      problem.functions.push_back({ PddlAtom{ "move_duration", { locations[i - 1], locations[i] } }, 5.0 });
+      problem.functions.push_back({ PddlAtom{ "move_duration", { locations[i], locations[i - 1] } }, 5.0 });
+    }
+
+    PddlCondition goal;
+    goal.predicate = PddlAtom{ "searched", { "b" } };
+    problem.goals = { goal };
+    return problem;
+  }
+
+
+  bool has_object(const PddlProblem& problem, const std::string& name)
+  {
+    return std::any_of(problem.objects.begin(), problem.objects.end(),
+      [&name](const std::pair<std::string, std::string>& object){ return object.first == name; });
+  }
+
+
+  bool has_predicate(const PddlProblem& problem, const std::string& predicate)
+  {
+    return std::any_of(problem.predicates.begin(), problem.predicates.end(),
+      [&predicate](const PddlAtom& atom){ return atom.to_string() == predicate; });
+  }
+
+
+  std::shared_ptr<const PddlDomain> make_domain()
+  {
+    return std::make_shared<const PddlDomain>(PddlDomain::parse(domain_str));
+  }
+}
+
+
+TEST(RelevanceAnalysis, IrrelevantFactsAreRemoved)
+{
+  RelevanceAnalysis analysis(make_domain(), false);
+  PddlProblem problem = make_problem();
+  PddlProblem reduced_problem = analysis.reduce(problem);
+
+  // Every location can be moved through, but only b has to be searched
+  EXPECT_EQ(reduced_problem.objects.size(), problem.objects.size());
+  EXPECT_TRUE(has_predicate(reduced_problem, "(not_searched b)"));
+  EXPECT_FALSE(has_predicate(reduced_problem, "(not_searched a)"));
+  EXPECT_FALSE(has_predicate(reduced_problem, "(not_searched c)"));
+  EXPECT_TRUE(has_predicate(reduced_problem, "(drone_at d h0)"));
+  EXPECT_EQ(reduced_problem.goals.size(), 1u);
+  EXPECT_EQ(analysis.get_statistics().num_off_route_objects, 0u);
+}
+
+
+TEST(RelevanceAnalysis, LocationsOffTheRoutesArePruned)
+{
+  RelevanceAnalysis analysis(make_domain());
+  PddlProblem reduced_problem = analysis.reduce(make_problem());
+
+  // The route from the drone at h0 to the goal at b passes a, but not c
+  EXPECT_TRUE(has_object(reduced_problem, "h0"));
+  EXPECT_TRUE(has_object(reduced_problem, "a"));
+  EXPECT_TRUE(has_object(reduced_problem, "b"));
+  EXPECT_FALSE(has_object(reduced_problem, "c"));
+  EXPECT_FALSE(has_predicate(reduced_problem, "(path b c)"));
+  EXPECT_TRUE(has_predicate(reduced_problem, "(path a b)"));
+  EXPECT_EQ(analysis.get_statistics().num_route_anchors, 2u);
+  EXPECT_EQ(analysis.get_statistics().num_off_route_objects, 1u);
+}
+
+
+TEST(RelevanceAnalysis, RequiredFunctionsAreKept)
+{
+  RelevanceAnalysis analysis(make_domain());
+  PddlProblem reduced_problem = analysis.reduce(make_problem());
+
+  // The battery is compared by move, and the durations of the kept moves are needed
+  std::vector<std::string> functions;
+  for(const std::pair<PddlAtom, double>& function : reduced_problem.functions)
+  {
+    functions.push_back(function.first.to_string());
+  }
+  EXPECT_NE(std::find(functions.begin(), functions.end(), "(battery_charge d)"), functions.end());
+  EXPECT_NE(std::find(functions.begin(), functions.end(), "(move_duration h0 a)"), functions.end());
+  EXPECT_EQ(std::find(functions.begin(), functions.end(), "(move_duration b c)"), functions.end());
+}
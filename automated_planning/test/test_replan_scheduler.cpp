@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include "automated_planning/replan_scheduler.hpp"
+
+
+TEST(ReplanScheduler, BurstOfRescuesIsCoalesced)
+{
+  ReplanScheduler scheduler;
+  scheduler.request(ReplanTrigger::RESCUE, 0.0);
+  scheduler.request(ReplanTrigger::RESCUE, 0.5);
+  scheduler.request(ReplanTrigger::CURRENT_GOALS, 1.0);
+
+  EXPECT_EQ(scheduler.poll(1.5, true, 100.0), ReplanTrigger::NONE);
+  EXPECT_EQ(scheduler.poll(2.5, true, 100.0), ReplanTrigger::RESCUE);
+  EXPECT_EQ(scheduler.poll(5.0, true, 100.0), ReplanTrigger::NONE);
+  EXPECT_EQ(scheduler.get_num_coalesced(), 2);
+}
+
+
+TEST(ReplanScheduler, CoalescingIsLimitedByTheMaximumDelay)
+{
+  ReplanScheduler scheduler;
+  for(double time_s = 0.0; time_s < 4.0; time_s += 1.0)
+  {
+    scheduler.request(ReplanTrigger::RESCUE, time_s);
+    EXPECT_EQ(scheduler.poll(time_s, true, 100.0), ReplanTrigger::NONE);
+  }
+  scheduler.request(ReplanTrigger::RESCUE, 4.0);
+  EXPECT_EQ(scheduler.poll(4.0, true, 100.0), ReplanTrigger::RESCUE);
+}
+
+
+TEST(ReplanScheduler, EmergencyAndInvalidPlanAreImmediate)
+{
+  ReplanScheduler scheduler;
+  scheduler.request(ReplanTrigger::PLAN_INVALID, 0.0);
+  EXPECT_EQ(scheduler.poll(0.0, true, 100.0), ReplanTrigger::PLAN_INVALID);
+
+  scheduler.request(ReplanTrigger::RESCUE, 1.0);
+  scheduler.request(ReplanTrigger::EMERGENCY, 1.1);
+  EXPECT_EQ(scheduler.poll(1.1, true, 100.0), ReplanTrigger::EMERGENCY);
+  EXPECT_FALSE(scheduler.has_pending());
+}
+
+
+TEST(ReplanScheduler, MinimumTriggerKeepsLowerTriggersPending)
+{
+  ReplanScheduler scheduler;
+  scheduler.request(ReplanTrigger::RESCUE, 0.0);
+  EXPECT_EQ(scheduler.poll(10.0, true, 100.0, ReplanTrigger::EMERGENCY), ReplanTrigger::NONE);
+  EXPECT_TRUE(scheduler.has_pending());
+  EXPECT_EQ(scheduler.poll(10.0, true, 100.0), ReplanTrigger::RESCUE);
+}
+
+
+TEST(ReplanScheduler, DeferredTriggerWaitsForThePlanBoundary)
+{
+  ReplanScheduler scheduler;
+  scheduler.request(ReplanTrigger::RESCUE, 0.0, true);
+
+  // A short remaining plan is finished before the deferred rescue is planned for
+  EXPECT_EQ(scheduler.poll(10.0, true, 30.0), ReplanTrigger::NONE);
+  EXPECT_EQ(scheduler.poll(40.0, false, 0.0), ReplanTrigger::RESCUE);
+
+  // A long remaining plan admits the deferred rescue at once
+  scheduler.request(ReplanTrigger::RESCUE, 50.0, true);
+  EXPECT_EQ(scheduler.poll(50.0, true, 120.0), ReplanTrigger::RESCUE);
+  EXPECT_EQ(scheduler.get_num_deferred(), 2);
+}
+
+
+TEST(ReplanScheduler, ReplanIncludesTheDeferredTrigger)
+{
+  ReplanScheduler scheduler;
+  scheduler.request(ReplanTrigger::RESCUE, 0.0, true);
+  scheduler.request(ReplanTrigger::RESCUE, 1.0);
+  EXPECT_EQ(scheduler.poll(3.0, true, 30.0), ReplanTrigger::RESCUE);
+  EXPECT_FALSE(scheduler.has_pending());
+}
+
+
+TEST(ReplanScheduler, HoverTimeIsAccumulated)
+{
+  ReplanScheduler scheduler;
+  scheduler.record_replan(2.0);
+  scheduler.record_replan(4.0);
+  scheduler.record_replan(-1.0);
+  EXPECT_EQ(scheduler.get_num_replans(), 3);
+  EXPECT_DOUBLE_EQ(scheduler.get_hover_time_lost_s(), 6.0);
+  EXPECT_DOUBLE_EQ(scheduler.get_mean_replan_duration_s(), 2.0);
+}
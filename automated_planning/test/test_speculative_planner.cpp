@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "automated_planning/speculative_planner.hpp"
+#include "sar_domain.hpp"
+
+
+namespace
+{
+  /**
+   * @brief The drone hovering at h0, with @p location added to the search area
+   */
+  PddlProblem make_problem(const std::string& location, double battery_charge=80.0)
+  {
+    return PddlProblem::parse(R"(
+(define (problem test_speculative_planner)
+  (:domain sar)
+  (:objects
+    d - drone
+    h0 a )" + location + R"( - location
+  )
+  (:init
+    (drone_at d h0) (available a) (available )" + location + R"()
+    (path h0 a) (path a h0) (path h0 )" + location + R"() (path )" + location + R"( h0)
+    (not_searched a) (not_searched )" + location + R"()
+    (not_landed d) (not_moving d) (not_searching d) (not_rescuing d) (not_marking d) (not_tracking d)
+    (= (battery_charge d) )" + std::to_string(battery_charge) + R"() (= (move_battery_usage d) 0.01) (= (track_battery_usage d) 0.1)
+    (= (move_duration h0 a) 10) (= (move_duration a h0) 10)
+    (= (move_duration h0 )" + location + R"() 20) (= (move_duration )" + location + R"( h0) 20)
+    (= (search_duration a) 30) (= (search_duration )" + location + R"() 60)
+  )
+  (:goal (and (searched )" + location + R"()))
+)
+)");
+  }
+}
+
+
+class SpeculativePlannerTest : public testing::Test
+{
+protected:
+  SpeculativePlannerTest()
+  : planner_(load_sar_domain(), 2)
+  {}
+
+  /**
+   * @brief Waits until the background thread has planned @p num_plans events
+   */
+  bool wait_for_plans_(size_t num_plans)
+  {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    while(std::chrono::steady_clock::now() < deadline)
+    {
+      SpeculationStatistics statistics = planner_.get_statistics();
+      if(statistics.num_speculations + statistics.num_failed_speculations >= num_plans)
+      {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+  }
+
+  SpeculativePlanner planner_;
+};
+
+
+TEST_F(SpeculativePlannerTest, SpeculatedPlanIsAdopted)
+{
+  planner_.speculate({ { "detection at b", make_problem("b") } });
+  ASSERT_TRUE(wait_for_plans_(1));
+
+  std::string label;
+  std::optional<std::vector<PlannedAction>> plan = planner_.lookup(make_problem("b"), label);
+  ASSERT_TRUE(plan.has_value());
+  EXPECT_EQ(label, "detection at b");
+  EXPECT_EQ(plan->back().action, "(search d b)");
+
+  SpeculationStatistics statistics = planner_.get_statistics();
+  EXPECT_EQ(statistics.num_lookups, 1u);
+  EXPECT_EQ(statistics.num_hits, 1u);
+}
+
+
+TEST_F(SpeculativePlannerTest, NewObjectIsRenamed)
+{
+  planner_.speculate({ { "new area", make_problem("x_1") } });
+  ASSERT_TRUE(wait_for_plans_(1));
+
+  std::string label;
+  std::optional<std::vector<PlannedAction>> plan = planner_.lookup(make_problem("x_7"), label);
+  ASSERT_TRUE(plan.has_value());
+  for(const PlannedAction& planned_action : plan.value())
+  {
+    EXPECT_EQ(planned_action.action.find("x_1"), std::string::npos) << planned_action.action;
+  }
+  EXPECT_EQ(plan->back().action, "(search d x_7)");
+}
+
+
+TEST_F(SpeculativePlannerTest, OnlyASingleObjectOfATypeMayBeRenamed)
+{
+  planner_.speculate({ { "new area", make_problem("x_1") } });
+  ASSERT_TRUE(wait_for_plans_(1));
+
+  // Both a and x_1 are missing, as the known location a is also renamed
+  PddlProblem problem = make_problem("x_7");
+  for(std::pair<std::string, std::string>& object : problem.objects)
+  {
+    if(object.first == "a")
+    {
+      object.first = "y_2";
+    }
+  }
+
+  std::string label;
+  EXPECT_FALSE(planner_.lookup(problem, label).has_value());
+
+  // Another goal
+  problem = make_problem("x_1");
+  problem.goals.front().predicate = PddlAtom{ "searched", { "a" } };
+  EXPECT_FALSE(planner_.lookup(problem, label).has_value());
+  EXPECT_EQ(planner_.get_statistics().num_hits, 0u);
+}
+
+
+TEST_F(SpeculativePlannerTest, StalePlanIsNotAdopted)
+{
+  planner_.speculate({ { "detection at b", make_problem("b") } });
+  ASSERT_TRUE(wait_for_plans_(1));
+
+  // The battery is left out of the key, but is checked by the validation
+  std::string label;
+  EXPECT_FALSE(planner_.lookup(make_problem("b", 2.0), label).has_value());
+  EXPECT_TRUE(planner_.lookup(make_problem("b", 50.0), label).has_value());
+}
+
+
+TEST_F(SpeculativePlannerTest, EventsWhichAreNoLongerProjectedAreInvalidated)
+{
+  planner_.speculate({ { "detection at b", make_problem("b") } });
+  ASSERT_TRUE(wait_for_plans_(1));
+
+  planner_.speculate({ { "detection at c", make_problem("c") } });
+  ASSERT_TRUE(wait_for_plans_(2));
+  EXPECT_EQ(planner_.get_statistics().num_invalidated, 1u);
+
+  // The plan for b is gone, while the plan for c is renamed to b
+  std::string label;
+  std::optional<std::vector<PlannedAction>> plan = planner_.lookup(make_problem("b"), label);
+  ASSERT_TRUE(plan.has_value());
+  EXPECT_EQ(label, "detection at c");
+
+  planner_.clear();
+  EXPECT_FALSE(planner_.lookup(make_problem("c"), label).has_value());
+  EXPECT_EQ(planner_.get_statistics().num_invalidated, 2u);
+}
+
+
+TEST_F(SpeculativePlannerTest, ProjectedEventsAreNotPlannedTwice)
+{
+  std::vector<SpeculativeEvent> events = { { "detection at b", make_problem("b") } };
+  planner_.speculate(events);
+  ASSERT_TRUE(wait_for_plans_(1));
+
+  planner_.speculate(events);
+  planner_.speculate(events);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(planner_.get_statistics().num_speculations, 1u);
+}
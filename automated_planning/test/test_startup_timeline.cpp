@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "automated_planning/startup_timeline.hpp"
+
+
+TEST(StartupTimeline, PhasesAreEndedInReverseOrder)
+{
+  StartupTimeline timeline("move_action_node");
+  const size_t num_initial_phases = timeline.get_phases().size();
+
+  timeline.begin("configure");
+  timeline.begin("configure");
+  timeline.end("configure");
+  timeline.end("activate");
+  timeline.mark("ready");
+
+  const std::vector<StartupPhase>& phases = timeline.get_phases();
+  ASSERT_EQ(phases.size(), num_initial_phases + 3);
+
+  // The latest of the two is ended, and the unknown phase is ignored
+  const StartupPhase& outer = phases[num_initial_phases];
+  const StartupPhase& inner = phases[num_initial_phases + 1];
+  EXPECT_LT(outer.end_s, outer.start_s);
+  EXPECT_GE(inner.end_s, inner.start_s);
+  EXPECT_GE(inner.start_s, outer.start_s);
+
+  EXPECT_EQ(phases.back().name, "ready");
+  EXPECT_EQ(phases.back().start_s, phases.back().end_s);
+}
+
+
+TEST(StartupTimeline, ProcessPhaseStartsBeforeTheTimeline)
+{
+  const double time_s = StartupTimeline::get_wall_time_s();
+  std::optional<double> process_start_time_s = StartupTimeline::get_process_start_time_s();
+  ASSERT_TRUE(process_start_time_s.has_value());
+  // Known to a clock tick
+  EXPECT_LE(process_start_time_s.value(), time_s + 0.1);
+  EXPECT_GT(process_start_time_s.value(), time_s - 3600.0);
+
+  StartupTimeline timeline("search_action_node");
+  ASSERT_FALSE(timeline.get_phases().empty());
+  const StartupPhase& process = timeline.get_phases().front();
+  EXPECT_EQ(process.name, "process");
+  EXPECT_LE(process.start_s, process.end_s);
+  EXPECT_GE(process.end_s, time_s);
+}
+
+
+class StartupProfileTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // The controller starts 1 s after the move action, and is still planning
+    profile_.update("mission_controller", {
+      { "process", 101.0, 101.5 },
+      { "plan", 101.5, -1.0 },
+    });
+    profile_.update("move_action_node", {
+      { "process", 100.0, 100.2 },
+      { "activate", 100.2, 100.4 },
+      { "ready", 100.4, 100.4 },
+    });
+  }
+
+  StartupProfile profile_;
+};
+
+
+TEST_F(StartupProfileTest, NodesAreListedInTheOrderTheyStarted)
+{
+  const std::string table = profile_.to_string();
+  EXPECT_EQ(table.find("Startup of 2 nodes in 1500 ms\n"), 0u) << table;
+  EXPECT_LT(table.find("move_action_node"), table.find("mission_controller"));
+
+  // Times are relative to the first node, and the running phase lasts until the end
+  EXPECT_NE(table.find("activate                     200 ms      200 ms "), std::string::npos) << table;
+  EXPECT_NE(table.find("plan                        1500 ms        0 ms +"), std::string::npos) << table;
+}
+
+
+TEST_F(StartupProfileTest, TimelinesAreReplacedAndEventsAddedOnce)
+{
+  profile_.update("move_action_node", { { "process", 100.5, 100.6 } });
+  profile_.mark("move_action_node", "process", 99.0);
+  profile_.mark("gazebo", "seen", 99.0);
+  profile_.mark("gazebo", "seen", 102.0);
+
+  EXPECT_EQ(profile_.get_num_nodes(), 3u);
+  EXPECT_TRUE(profile_.has_node("gazebo"));
+  EXPECT_FALSE(profile_.has_node("track_action_node"));
+
+  const std::string table = profile_.to_string();
+  EXPECT_EQ(table.find("Startup of 3 nodes in 2500 ms\ngazebo\n"), 0u) << table;
+  EXPECT_EQ(table.find("activate"), std::string::npos);
+}
+
+
+TEST_F(StartupProfileTest, ChromeTraceHasARowPerNode)
+{
+  // Starts together with the move action, and is ordered after it by name
+  profile_.update("node \"quoted\"", { { "configure", 100.0, 100.001 } });
+
+  const std::string trace = profile_.to_chrome_trace();
+  EXPECT_EQ(trace.find("{\"traceEvents\":["), 0u);
+  EXPECT_NE(trace.find("\"args\":{\"name\":\"node \\\"quoted\\\"\"}"), std::string::npos) << trace;
+  EXPECT_NE(trace.find("{\"name\":\"ready\",\"pid\":1,\"tid\":0,\"ts\":400000,\"ph\":\"i\",\"s\":\"t\"}"), std::string::npos) << trace;
+  EXPECT_NE(trace.find("{\"name\":\"configure\",\"pid\":1,\"tid\":1,\"ts\":0,\"ph\":\"X\",\"dur\":1000}"), std::string::npos) << trace;
+
+  // The running phase has no duration yet
+  EXPECT_NE(trace.find("{\"name\":\"plan\",\"pid\":1,\"tid\":2,\"ts\":1500000,\"ph\":\"X\",\"dur\":0}"), std::string::npos) << trace;
+}
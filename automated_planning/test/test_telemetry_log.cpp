@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "automated_planning/telemetry_log.hpp"
+
+
+class TelemetryLogTest : public ::testing::Test
+{
+protected:
+  void SetUp() override { std::remove(path_.c_str()); }
+  void TearDown() override { std::remove(path_.c_str()); }
+
+  static std::string to_string_(const TelemetryRecord& record)
+  {
+    return std::string(reinterpret_cast<const char*>(record.data), record.size);
+  }
+
+  const std::string path_ = testing::TempDir() + "test_telemetry_log.bin";
+};
+
+
+TEST_F(TelemetryLogTest, RecordsAreReadBackInOrder)
+{
+  const std::vector<std::string> payloads = { "takeoff", "", "move d0 l1", "a payload which is not aligned" };
+  {
+    TelemetryLogWriter writer(path_);
+    for(size_t i = 0; i < payloads.size(); i++)
+    {
+      writer.append(1000 * static_cast<int64_t>(i), 1 + static_cast<uint32_t>(i % 2), payloads[i].data(), payloads[i].size());
+    }
+    EXPECT_EQ(writer.get_num_records(), payloads.size());
+  }
+
+  TelemetryLogReader reader(path_);
+  TelemetryRecord record;
+  for(size_t i = 0; i < payloads.size(); i++)
+  {
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.stamp_ns, 1000 * static_cast<int64_t>(i));
+    EXPECT_EQ(record.channel, 1 + i % 2);
+    EXPECT_EQ(to_string_(record), payloads[i]);
+  }
+  EXPECT_FALSE(reader.next(record));
+
+  reader.rewind();
+  ASSERT_TRUE(reader.next(record));
+  EXPECT_EQ(to_string_(record), payloads.front());
+}
+
+
+TEST_F(TelemetryLogTest, FileGrowsBeyondTheInitialCapacity)
+{
+  const std::vector<uint8_t> payload(1000, 0xAB);
+  size_t size;
+  {
+    TelemetryLogWriter writer(path_, 64);
+    for(int i = 0; i < 500; i++)
+    {
+      writer.append(i, 3, payload.data(), payload.size());
+    }
+    size = writer.get_size();
+  }
+
+  // Truncated to the used size when closed
+  std::ifstream file(path_, std::ios::binary | std::ios::ate);
+  EXPECT_EQ(static_cast<size_t>(file.tellg()), size);
+
+  TelemetryLogReader reader(path_);
+  TelemetryRecord record;
+  int num_records = 0;
+  while(reader.next(record))
+  {
+    ASSERT_EQ(record.size, payload.size());
+    ASSERT_EQ(record.data[record.size - 1], 0xAB);
+    num_records++;
+  }
+  EXPECT_EQ(num_records, 500);
+}
+
+
+TEST_F(TelemetryLogTest, LogWhichWasNotClosedIsReadUpToTheLastRecord)
+{
+  TelemetryLogWriter writer(path_, 4096);
+  const std::string payload = "finished_action";
+  writer.append(1, 1, payload.data(), payload.size());
+  writer.append(2, 1, payload.data(), payload.size());
+  writer.flush();
+
+  // The file still has the zero-filled capacity, as after a crash
+  TelemetryLogReader reader(path_);
+  TelemetryRecord record;
+  EXPECT_TRUE(reader.next(record));
+  EXPECT_TRUE(reader.next(record));
+  EXPECT_EQ(record.stamp_ns, 2);
+  EXPECT_FALSE(reader.next(record));
+}
+
+
+TEST_F(TelemetryLogTest, InvalidUseIsRejected)
+{
+  TelemetryLogWriter writer(path_);
+  EXPECT_THROW(writer.append(0, 0, nullptr, 0), std::invalid_argument);
+
+  writer.close();
+  EXPECT_THROW(writer.append(0, 1, nullptr, 0), std::logic_error);
+
+  {
+    std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+    file << "not a telemetry log";
+  }
+  EXPECT_THROW(TelemetryLogReader reader(path_), std::runtime_error);
+  EXPECT_THROW(TelemetryLogReader reader(path_ + ".missing"), std::runtime_error);
+}
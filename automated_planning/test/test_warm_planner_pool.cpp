@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "automated_planning/warm_planner_pool.hpp"
+#include "sar_domain.hpp"
+
+
+namespace
+{
+  /**
+   * @brief The drone hovering at h0, with @p goal to achieve. There is no path to c
+   */
+  std::string make_problem(const std::string& goal)
+  {
+    return R"(
+(define (problem test_warm_planner_pool)
+  (:domain sar)
+  (:objects
+    d - drone
+    h0 a c - location
+  )
+  (:init
+    (drone_at d h0) (available a) (available c) (path h0 a) (path a h0)
+    (not_searched a) (not_searched c)
+    (not_landed d) (not_moving d) (not_searching d) (not_rescuing d) (not_marking d) (not_tracking d)
+    (= (battery_charge d) 80) (= (move_battery_usage d) 0.01) (= (track_battery_usage d) 0.1)
+    (= (move_duration h0 a) 10) (= (move_duration a h0) 10)
+    (= (search_duration a) 30) (= (search_duration c) 30)
+  )
+  (:goal (and )" + goal + R"())
+)
+)";
+  }
+}
+
+
+TEST(WarmPlannerPoolFraming, HeaderLineLeavesThePayloadUnread)
+{
+  int sockets[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+  ASSERT_TRUE(write_all(sockets[0], "NONE 5 0.25\nabortPLAN 0\n"));
+
+  std::string data;
+  ASSERT_TRUE(read_message_part(sockets[1], 0, data));
+  EXPECT_EQ(data, "NONE 5 0.25");
+  ASSERT_TRUE(read_message_part(sockets[1], 5, data, get_steady_time_s() + 1.0));
+  EXPECT_EQ(data, "abort");
+  ASSERT_TRUE(read_message_part(sockets[1], 0, data));
+  EXPECT_EQ(data, "PLAN 0");
+
+  // Nothing more is sent before the deadline, and then the other end is closed
+  EXPECT_FALSE(read_message_part(sockets[1], 0, data, get_steady_time_s() + 0.05));
+  ::close(sockets[0]);
+  EXPECT_FALSE(read_message_part(sockets[1], 4, data));
+  EXPECT_FALSE(write_all(sockets[1], "PROBLEM 0\n"));
+  ::close(sockets[1]);
+}
+
+
+class WarmPlannerPoolTest : public testing::Test
+{
+protected:
+  WarmPlannerPoolTest()
+  : domain_(read_sar_domain_str())
+  {}
+
+  /**
+   * @brief Calls a pool of a single worker running the shell script, which stands in for a
+   * worker that misbehaves
+   */
+  WarmPlannerPoolStatistics call_script_(const std::string& script, std::string& message)
+  {
+    WarmPlannerPool pool({ "sh", "-c", script }, 1, 0.5);
+    EXPECT_FALSE(pool.plan(domain_, make_problem("(searched a)"), message).has_value());
+    EXPECT_FALSE(pool.plan(domain_, make_problem("(searched a)"), message).has_value());
+    return pool.get_statistics();
+  }
+
+  const std::string domain_;
+};
+
+
+TEST_F(WarmPlannerPoolTest, DomainIsOnlySentOncePerWorker)
+{
+  WarmPlannerPool pool({ SAR_PLANNER_WORKER_PATH }, 1);
+  ASSERT_TRUE(pool.start());
+
+  std::string message;
+  std::optional<std::vector<PlannedAction>> plan = pool.plan(domain_, make_problem("(searched a)"), message);
+  ASSERT_TRUE(plan.has_value()) << message;
+  EXPECT_EQ(plan->back().action, "(search d a)");
+  EXPECT_GT(plan->back().duration_s, 0.0);
+
+  ASSERT_TRUE(pool.plan(domain_, make_problem("(searched a)"), message).has_value());
+
+  // Sent again when it changes
+  ASSERT_TRUE(pool.plan(domain_ + "\n; Changed\n", make_problem("(searched a)"), message).has_value());
+
+  WarmPlannerPoolStatistics statistics = pool.get_statistics();
+  EXPECT_EQ(statistics.num_calls, 3u);
+  EXPECT_EQ(statistics.num_plans, 3u);
+  EXPECT_EQ(statistics.num_spawned_workers, 1u);
+  EXPECT_EQ(statistics.num_domain_transfers, 2u);
+  EXPECT_GT(statistics.worker_duration_s, 0.0);
+  EXPECT_GE(statistics.call_duration_s, statistics.worker_duration_s);
+}
+
+
+TEST_F(WarmPlannerPoolTest, WorkerWithoutAPlanIsKept)
+{
+  WarmPlannerPool pool({ SAR_PLANNER_WORKER_PATH }, 1);
+
+  std::string message;
+  EXPECT_FALSE(pool.plan(domain_, make_problem("(searched c)"), message).has_value());
+  EXPECT_NE(message.find("No plan found"), std::string::npos) << message;
+
+  EXPECT_FALSE(pool.plan("(define (domain broken", make_problem("(searched a)"), message).has_value());
+  EXPECT_NE(message.find("Could not parse the domain"), std::string::npos) << message;
+
+  WarmPlannerPoolStatistics statistics = pool.get_statistics();
+  EXPECT_EQ(statistics.num_failed_workers, 0u);
+  EXPECT_EQ(statistics.num_spawned_workers, 1u);
+  EXPECT_EQ(statistics.num_plans, 0u);
+}
+
+
+TEST_F(WarmPlannerPoolTest, CrashedWorkerIsRestarted)
+{
+  std::string message;
+  WarmPlannerPoolStatistics statistics = call_script_("exit 1", message);
+  EXPECT_EQ(statistics.num_failed_workers, 2u);
+  EXPECT_EQ(statistics.num_spawned_workers, 2u);
+  EXPECT_FALSE(message.empty());
+}
+
+
+TEST_F(WarmPlannerPoolTest, InvalidResponseFailsTheWorker)
+{
+  std::string message;
+  WarmPlannerPoolStatistics statistics = call_script_("printf 'PLAN 6 0.1\\nsearch'; exec cat > /dev/null", message);
+  EXPECT_EQ(statistics.num_failed_workers, 2u);
+  EXPECT_EQ(message, "Invalid response from the planner worker: PLAN 6 0.1");
+}
+
+
+TEST_F(WarmPlannerPoolTest, SlowWorkerIsKilledAfterTheTimeout)
+{
+  const double start_time_s = get_steady_time_s();
+  std::string message;
+  WarmPlannerPoolStatistics statistics = call_script_("exec sleep 10", message);
+  EXPECT_EQ(statistics.num_failed_workers, 2u);
+  EXPECT_EQ(statistics.num_spawned_workers, 2u);
+  EXPECT_NE(message.find("No response"), std::string::npos) << message;
+  EXPECT_LT(get_steady_time_s() - start_time_s, 5.0);
+}